@@ -363,6 +363,20 @@ cuda_utils::ExternalMemory* Buffer::getCudaMemory() const
 }
 #endif
 
+/// Get the shape and dtype used when exposing the buffer contents as an ndarray.
+inline std::pair<std::vector<size_t>, pybind11::dlpack::dtype> getBufferNdarrayLayout(const Buffer& self)
+{
+    if (auto dtype = resourceFormatToDtype(self.getFormat()))
+    {
+        uint32_t channelCount = getFormatChannelCount(self.getFormat());
+        if (channelCount == 1)
+            return {{self.getElementCount()}, *dtype};
+        else
+            return {{self.getElementCount(), channelCount}, *dtype};
+    }
+    return {{self.getSize()}, pybind11::dtype<uint8_t>()};
+}
+
 inline pybind11::ndarray<pybind11::numpy> buffer_to_numpy(const Buffer& self)
 {
     size_t bufferSize = self.getSize();
@@ -371,27 +385,44 @@ inline pybind11::ndarray<pybind11::numpy> buffer_to_numpy(const Buffer& self)
 
     pybind11::capsule owner(cpuData, [](void* p) noexcept { delete[] reinterpret_cast<uint8_t*>(p); });
 
-    if (auto dtype = resourceFormatToDtype(self.getFormat()))
-    {
-        uint32_t channelCount = getFormatChannelCount(self.getFormat());
-        if (channelCount == 1)
-        {
-            pybind11::size_t shape[1] = {self.getElementCount()};
-            return pybind11::ndarray<pybind11::numpy>(cpuData, 1, shape, owner, nullptr, *dtype, pybind11::device::cpu::value);
-        }
-        else
-        {
-            pybind11::size_t shape[2] = {self.getElementCount(), channelCount};
-            return pybind11::ndarray<pybind11::numpy>(cpuData, 2, shape, owner, nullptr, *dtype, pybind11::device::cpu::value);
-        }
-    }
-    else
+    auto [shape, dtype] = getBufferNdarrayLayout(self);
+    return pybind11::ndarray<pybind11::numpy>(cpuData, shape.size(), shape.data(), owner, nullptr, dtype, pybind11::device::cpu::value);
+}
+
+/**
+ * Export the buffer memory as a DLPack tensor without copying.
+ * Host-visible (upload/readback) buffers are exported as CPU tensors of the mapped memory.
+ * Device-local buffers are exported as CUDA tensors when CUDA interop is available.
+ * The exported tensor holds a reference to the buffer, keeping it (and its mapping) alive.
+ */
+inline pybind11::ndarray<> buffer_to_dlpack(const ref<Buffer>& self)
+{
+    auto [shape, dtype] = getBufferNdarrayLayout(*self);
+    pybind11::object owner = pybind11::cast(self);
+
+    if (self->getMemoryType() == MemoryType::Upload || self->getMemoryType() == MemoryType::ReadBack)
     {
-        pybind11::size_t shape[1] = {bufferSize};
-        return pybind11::ndarray<pybind11::numpy>(
-            cpuData, 1, shape, owner, nullptr, pybind11::dtype<uint8_t>(), pybind11::device::cpu::value
-        );
+        return pybind11::ndarray<>(self->map(), shape.size(), shape.data(), owner, nullptr, dtype, pybind11::device::cpu::value);
     }
+#if FALCOR_HAS_CUDA
+    cuda_utils::ExternalMemory* cudaMemory = self->getCudaMemory();
+    return pybind11::ndarray<>(
+        cudaMemory->getMappedData(), shape.size(), shape.data(), owner, nullptr, dtype, pybind11::device::cuda::value
+    );
+#else
+    FALCOR_THROW("Buffer with MemoryType::DeviceLocal can only be exported via DLPack with CUDA interop. Use to_numpy() instead.");
+#endif
+}
+
+inline pybind11::tuple buffer_dlpack_device(const Buffer& self)
+{
+    if (self.getMemoryType() == MemoryType::Upload || self.getMemoryType() == MemoryType::ReadBack)
+        return pybind11::make_tuple(pybind11::device::cpu::value, 0);
+#if FALCOR_HAS_CUDA
+    return pybind11::make_tuple(pybind11::device::cuda::value, 0);
+#else
+    FALCOR_THROW("Buffer with MemoryType::DeviceLocal can only be exported via DLPack with CUDA interop.");
+#endif
 }
 
 inline void buffer_from_numpy(Buffer& self, pybind11::ndarray<pybind11::numpy> data)
@@ -461,6 +492,15 @@ FALCOR_SCRIPT_BINDING(Buffer)
 
     buffer.def("to_numpy", buffer_to_numpy);
     buffer.def("from_numpy", buffer_from_numpy, "data"_a);
+    // DLPack protocol (zero-copy export, e.g. numpy.from_dlpack(buffer) or torch.from_dlpack(buffer)).
+    // Additional keyword arguments of newer protocol versions (max_version, dl_device, copy) are ignored.
+    buffer.def(
+        "__dlpack__",
+        [](const ref<Buffer>& self, pybind11::object stream, pybind11::kwargs) { return buffer_to_dlpack(self); },
+        "stream"_a = pybind11::none(),
+        pybind11::return_value_policy::reference
+    );
+    buffer.def("__dlpack_device__", buffer_dlpack_device);
 #if FALCOR_HAS_CUDA
     buffer.def("to_torch", buffer_to_torch, "shape"_a, "dtype"_a = DataType::float32);
     buffer.def("from_torch", buffer_from_torch, "data"_a);
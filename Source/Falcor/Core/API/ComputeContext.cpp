@@ -26,15 +26,24 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "ComputeContext.h"
+#include "Device.h"
 #include "GFXAPI.h"
 #include "Core/State/ComputeState.h"
 #include "Core/Program/ProgramVars.h"
+#include "Core/Program/ProgramVersion.h"
+
+#include <BS_thread_pool.hpp>
+
+#include <algorithm>
 
 namespace Falcor
 {
 ComputeContext::ComputeContext(Device* pDevice, gfx::ICommandQueue* pQueue) : CopyContext(pDevice, pQueue)
 {
     bindDescriptorHeaps(); // TODO: Should this be done here?
+
+    if (pDevice->getType() == Device::Type::CPU)
+        mpCpuThreadPool = std::make_unique<BS::thread_pool>();
 }
 
 ComputeContext::~ComputeContext() {}
@@ -43,6 +52,12 @@ void ComputeContext::dispatch(ComputeState* pState, ProgramVars* pVars, const ui
 {
     pVars->prepareDescriptorSets(this);
 
+    if (mpCpuThreadPool)
+    {
+        dispatchCpu(pState->getCSO(pVars).get(), pVars, dispatchSize);
+        return;
+    }
+
     auto computeEncoder = mpLowLevelData->getComputeCommandEncoder();
     FALCOR_GFX_CALL(computeEncoder->bindPipelineWithRootObject(pState->getCSO(pVars)->getGfxPipelineState(), pVars->getShaderObject()));
     FALCOR_GFX_CALL(computeEncoder->dispatchCompute((int)dispatchSize.x, (int)dispatchSize.y, (int)dispatchSize.z));
@@ -52,6 +67,15 @@ void ComputeContext::dispatch(ComputeState* pState, ProgramVars* pVars, const ui
 void ComputeContext::dispatchIndirect(ComputeState* pState, ProgramVars* pVars, const Buffer* pArgBuffer, uint64_t argBufferOffset)
 {
     pVars->prepareDescriptorSets(this);
+
+    if (mpCpuThreadPool)
+    {
+        uint3 dispatchSize;
+        pArgBuffer->getBlob(&dispatchSize, argBufferOffset, sizeof(dispatchSize));
+        dispatchCpu(pState->getCSO(pVars).get(), pVars, dispatchSize);
+        return;
+    }
+
     resourceBarrier(pArgBuffer, Resource::State::IndirectArg);
 
     auto computeEncoder = mpLowLevelData->getComputeCommandEncoder();
@@ -60,6 +84,42 @@ void ComputeContext::dispatchIndirect(ComputeState* pState, ProgramVars* pVars,
     mCommandsPending = true;
 }
 
+void ComputeContext::dispatchCpu(const ComputeStateObject* pCso, ProgramVars* pVars, const uint3& dispatchSize)
+{
+    CpuComputeFunc func = pCso->getDesc().pProgramKernels->getCpuComputeFunc();
+    FALCOR_CHECK(func, "Program has no compute kernel for the CPU device.");
+    if (dispatchSize.x == 0 || dispatchSize.y == 0 || dispatchSize.z == 0)
+        return;
+
+    // The kernel is called directly instead of being recorded. Execute the commands recorded so far
+    // (e.g. buffer uploads) first. The CPU device executes them when they are submitted.
+    if (hasPendingCommands())
+        submit();
+
+    // The kernel reads its parameters from the data of the shader objects. Resources are referenced by pointer.
+    gfx::IShaderObject* pRootObject = pVars->getShaderObject();
+    Slang::ComPtr<gfx::IShaderObject> pEntryPointObject;
+    if (pRootObject->getEntryPointCount() > 0)
+        FALCOR_GFX_CALL(pRootObject->getEntryPoint(0, pEntryPointObject.writeRef()));
+    void* pGlobalParams = const_cast<void*>(pRootObject->getRawData());
+    void* pEntryPointParams = pEntryPointObject ? const_cast<void*>(pEntryPointObject->getRawData()) : nullptr;
+
+    // Split the groups along the dimension with the most groups. Use a few ranges per thread to balance the load.
+    const uint32_t axis = (dispatchSize.x >= dispatchSize.y && dispatchSize.x >= dispatchSize.z) ? 0 : (dispatchSize.y >= dispatchSize.z ? 1 : 2);
+    const uint32_t groupCount = dispatchSize[axis];
+    const uint32_t rangeCount = std::min<uint32_t>(groupCount, mpCpuThreadPool->get_thread_count() * 4);
+    for (uint32_t i = 0; i < rangeCount; ++i)
+    {
+        CpuComputeVaryingInput varyingInput = {};
+        for (uint32_t j = 0; j < 3; ++j)
+            varyingInput.endGroupID[j] = dispatchSize[j];
+        varyingInput.startGroupID[axis] = (uint32_t)((uint64_t)groupCount * i / rangeCount);
+        varyingInput.endGroupID[axis] = (uint32_t)((uint64_t)groupCount * (i + 1) / rangeCount);
+        mpCpuThreadPool->push_task([=]() mutable { func(&varyingInput, pEntryPointParams, pGlobalParams); });
+    }
+    mpCpuThreadPool->wait_for_tasks();
+}
+
 void ComputeContext::clearUAV(const UnorderedAccessView* pUav, const float4& value)
 {
     resourceBarrier(pUav->getResource(), Resource::State::UnorderedAccess);
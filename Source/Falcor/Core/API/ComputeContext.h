@@ -32,12 +32,19 @@
 #include "LowLevelContextData.h"
 #include "Core/Macros.h"
 #include "Utils/Math/Vector.h"
+#include <memory>
+
+namespace BS
+{
+class thread_pool;
+}
 
 namespace Falcor
 {
 class ComputeState;
 class ProgramVars;
 class ProgramKernels;
+class ComputeStateObject;
 class UnorderedAccessView;
 
 class FALCOR_API ComputeContext : public CopyContext
@@ -54,6 +61,8 @@ public:
 
     /**
      * Dispatch a compute task
+     * On the CPU device, the thread groups are split into ranges that execute in parallel on a thread pool.
+     * The dispatch has finished when the call returns.
      * @param[in] dispatchSize 3D dispatch group size
      */
     void dispatch(ComputeState* pState, ProgramVars* pVars, const uint3& dispatchSize);
@@ -92,7 +101,11 @@ public:
 protected:
     ComputeContext(gfx::ICommandQueue* pQueue);
 
+    /// Execute a dispatch on the CPU device.
+    void dispatchCpu(const ComputeStateObject* pCso, ProgramVars* pVars, const uint3& dispatchSize);
+
     const ProgramVars* mpLastBoundComputeVars = nullptr;
+    std::unique_ptr<BS::thread_pool> mpCpuThreadPool; ///< Thread pool executing dispatches on the CPU device.
 };
 
 } // namespace Falcor
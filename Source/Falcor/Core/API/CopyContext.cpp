@@ -100,6 +100,9 @@ uint64_t CopyContext::signal(Fence* pFence, uint64_t value)
 void CopyContext::wait(Fence* pFence, uint64_t value)
 {
     FALCOR_CHECK(pFence, "'fence' must not be null");
+    // Fences on the CPU device are signaled on submission and command buffers execute in order. There is nothing to wait for.
+    if (!pFence->getGfxFence())
+        return;
     uint64_t waitValue = value == Fence::kAuto ? pFence->getSignaledValue() : value;
     gfx::IFence* fences[] = {pFence->getGfxFence()};
     uint64_t waitValues[] = {waitValue};
@@ -326,6 +326,8 @@ inline gfx::DeviceType getGfxDeviceType(Device::Type deviceType)
         return gfx::DeviceType::DirectX12;
     case Device::Type::Vulkan:
         return gfx::DeviceType::Vulkan;
+    case Device::Type::CPU:
+        return gfx::DeviceType::CPU;
     default:
         FALCOR_THROW("Unknown device type");
     }
@@ -499,16 +501,18 @@ Device::Device(const Desc& desc) : mDesc(desc)
     if (mDesc.enableDebugLayer)
         gfx::gfxEnableDebugLayer();
 
-    // Get list of available GPUs.
-    const auto gpus = getGPUs(mDesc.type);
+    // Get list of available GPUs. The CPU device has no adapters to choose from.
+    const auto gpus = mDesc.type == Type::CPU ? std::vector<AdapterInfo>() : getGPUs(mDesc.type);
 
     if (mDesc.gpu >= gpus.size())
     {
-        logWarning("GPU index {} is out of range, using first GPU instead.", mDesc.gpu);
+        if (!gpus.empty())
+            logWarning("GPU index {} is out of range, using first GPU instead.", mDesc.gpu);
         mDesc.gpu = 0;
     }
 
     // Try to create device on specific GPU.
+    if (!gpus.empty())
     {
         gfxDesc.adapterLUID = reinterpret_cast<const gfx::AdapterLUID*>(&gpus[mDesc.gpu].luid);
         if (SLANG_FAILED(gfxCreateDevice(&gfxDesc, mGfxDevice.writeRef())))
@@ -567,8 +571,13 @@ Device::Device(const Desc& desc) : mDesc(desc)
     }
 
     mSupportedShaderModel = querySupportedShaderModel(mGfxDevice);
+    // The CPU device does not report shader model features. Host code generation does not depend on the
+    // shader model, so we report the default to get the same Slang language features as on the GPU.
+    if (getType() == Type::CPU)
+        mSupportedShaderModel = kDefaultShaderModel;
     mDefaultShaderModel = std::min(kDefaultShaderModel, mSupportedShaderModel);
-    mGpuTimestampFrequency = 1000.0 / (double)mGfxDevice->getDeviceInfo().timestampFrequency;
+    const uint64_t timestampFrequency = mGfxDevice->getDeviceInfo().timestampFrequency;
+    mGpuTimestampFrequency = timestampFrequency > 0 ? 1000.0 / (double)timestampFrequency : 0.0;
 
 #if FALCOR_HAS_D3D12
     // Configure D3D12 validation layer.
@@ -593,16 +602,22 @@ Device::Device(const Desc& desc) : mDesc(desc)
     }
 #endif
 
-    for (uint32_t i = 0; i < kInFlightFrameCount; ++i)
+    // The CPU device executes command buffers when they are submitted and binds resources without descriptors.
+    // It uses a single transient resource heap without descriptor space, which is reused every frame.
+    const uint32_t transientResourceHeapCount = getType() == Type::CPU ? 1 : kInFlightFrameCount;
+    for (uint32_t i = 0; i < transientResourceHeapCount; ++i)
     {
         gfx::ITransientResourceHeap::Desc transientHeapDesc = {};
         transientHeapDesc.flags = gfx::ITransientResourceHeap::Flags::AllowResizing;
         transientHeapDesc.constantBufferSize = kTransientHeapConstantBufferSize;
-        transientHeapDesc.samplerDescriptorCount = 2048;
-        transientHeapDesc.uavDescriptorCount = 1000000;
-        transientHeapDesc.srvDescriptorCount = 1000000;
-        transientHeapDesc.constantBufferDescriptorCount = 1000000;
-        transientHeapDesc.accelerationStructureDescriptorCount = 1000000;
+        if (getType() != Type::CPU)
+        {
+            transientHeapDesc.samplerDescriptorCount = 2048;
+            transientHeapDesc.uavDescriptorCount = 1000000;
+            transientHeapDesc.srvDescriptorCount = 1000000;
+            transientHeapDesc.constantBufferDescriptorCount = 1000000;
+            transientHeapDesc.accelerationStructureDescriptorCount = 1000000;
+        }
         if (SLANG_FAILED(mGfxDevice->createTransientResourceHeap(transientHeapDesc, mpTransientResourceHeaps[i].writeRef())))
             FALCOR_THROW("Failed to create transient resource heap");
     }
@@ -625,6 +640,7 @@ Device::Device(const Desc& desc) : mDesc(desc)
     this->setEnableRefTracking(true);
 #endif
 
+    // On the CPU device, fences are tracked on the host (see Fence).
     mpFrameFence = createFence();
     mpFrameFence->breakStrongReferenceToDevice();
 
@@ -650,14 +666,19 @@ Device::Device(const Desc& desc) : mDesc(desc)
     mpDefaultSampler = createSampler(Sampler::Desc());
     mpDefaultSampler->breakStrongReferenceToDevice();
 
+    // On the CPU device, the upload and readback heaps are host memory. Their pages are recycled through the host-tracked frame fence.
     mpUploadHeap = GpuMemoryHeap::create(ref<Device>(this), MemoryType::Upload, 1024 * 1024 * 2, mpFrameFence);
     mpUploadHeap->breakStrongReferenceToDevice();
 
     mpReadBackHeap = GpuMemoryHeap::create(ref<Device>(this), MemoryType::ReadBack, 1024 * 1024 * 2, mpFrameFence);
     mpReadBackHeap->breakStrongReferenceToDevice();
 
-    mpTimestampQueryHeap = QueryHeap::create(ref<Device>(this), QueryHeap::Type::Timestamp, 1024 * 1024);
-    mpTimestampQueryHeap->breakStrongReferenceToDevice();
+    // The CPU device has no timestamp queries. GPU timers report zero time on it (see GpuTimer).
+    if (getType() != Type::CPU)
+    {
+        mpTimestampQueryHeap = QueryHeap::create(ref<Device>(this), QueryHeap::Type::Timestamp, 1024 * 1024);
+        mpTimestampQueryHeap->breakStrongReferenceToDevice();
+    }
 
     mpRenderContext = std::make_unique<RenderContext>(this, mGfxCommandQueue);
 
@@ -667,7 +688,8 @@ Device::Device(const Desc& desc) : mDesc(desc)
     this->decRef(false);
 
     logInfo(
-        "Created GPU device '{}' using '{}' API (SM{}.{}).",
+        "Created {} device '{}' using '{}' API (SM{}.{}).",
+        getType() == Type::CPU ? "CPU" : "GPU",
         mInfo.adapterName,
         mInfo.apiName,
         getShaderModelMajorVersion(mSupportedShaderModel),
@@ -1146,9 +1168,10 @@ void Device::endFrame()
     if (mpFrameFence->getSignaledValue() > kInFlightFrameCount)
         mpFrameFence->wait(mpFrameFence->getSignaledValue() - kInFlightFrameCount);
 
-    // Switch to next transient resource heap.
+    // Switch to next transient resource heap. The CPU device has a single one.
     getCurrentTransientResourceHeap()->finish();
-    mCurrentTransientResourceHeapIndex = (mCurrentTransientResourceHeapIndex + 1) % kInFlightFrameCount;
+    if (getType() != Type::CPU)
+        mCurrentTransientResourceHeapIndex = (mCurrentTransientResourceHeapIndex + 1) % kInFlightFrameCount;
     mpRenderContext->getLowLevelData()->closeCommandBuffer();
     getCurrentTransientResourceHeap()->synchronizeAndReset();
     mpRenderContext->getLowLevelData()->openCommandBuffer();
@@ -1204,6 +1227,7 @@ FALCOR_SCRIPT_BINDING(Device)
     deviceType.value("Default", Device::Type::Default);
     deviceType.value("D3D12", Device::Type::D3D12);
     deviceType.value("Vulkan", Device::Type::Vulkan);
+    deviceType.value("CPU", Device::Type::CPU);
 
     pybind11::class_<Device::Info> info(device, "Info");
     info.def_readonly("adapter_name", &Device::Info::adapterName);
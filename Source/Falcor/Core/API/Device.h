@@ -116,6 +116,7 @@ public:
         Default, ///< Default device type, favors D3D12 over Vulkan.
         D3D12,
         Vulkan,
+        CPU, ///< Host device. Slang kernels are compiled to host code and executed on the CPU. Supports compute only.
     };
     FALCOR_ENUM_INFO(
         Type,
@@ -123,13 +124,14 @@ public:
             {Type::Default, "Default"},
             {Type::D3D12, "D3D12"},
             {Type::Vulkan, "Vulkan"},
+            {Type::CPU, "CPU"},
         }
     );
 
     /// Device descriptor.
     struct Desc
     {
-        /// The device type (D3D12/Vulkan).
+        /// The device type (D3D12/Vulkan/CPU).
         Type type = Type::Default;
 
         /// GPU index (indexing into GPU list returned by getGPUList()).
@@ -568,6 +570,7 @@ public:
 
     const ref<GpuMemoryHeap>& getUploadHeap() const { return mpUploadHeap; }
     const ref<GpuMemoryHeap>& getReadBackHeap() const { return mpReadBackHeap; }
+    /// Get the timestamp query heap. Returns nullptr on the CPU device, which has no timestamp queries.
     const ref<QueryHeap>& getTimestampQueryHeap() const { return mpTimestampQueryHeap; }
     void releaseResource(ISlangUnknown* pResource);
 
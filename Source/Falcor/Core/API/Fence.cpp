@@ -39,6 +39,15 @@ Fence::Fence(ref<Device> pDevice, FenceDesc desc) : mpDevice(pDevice), mDesc(des
     gfx::IFence::Desc gfxDesc = {};
     mSignaledValue = mDesc.initialValue;
     gfxDesc.isShared = mDesc.shared;
+
+    // The CPU device has no device fences. It executes command buffers when they are submitted,
+    // so a fence has reached its signaled value as soon as the signal is issued. We track it on the host.
+    if (mpDevice->getType() == Device::Type::CPU)
+    {
+        FALCOR_CHECK(!mDesc.shared, "Shared fences are not supported on the CPU device.");
+        return;
+    }
+
     FALCOR_GFX_CALL(mpDevice->getGfxDevice()->createFence(gfxDesc, mGfxFence.writeRef()));
 }
 
@@ -47,7 +56,8 @@ Fence::~Fence() = default;
 uint64_t Fence::signal(uint64_t value)
 {
     uint64_t signalValue = updateSignaledValue(value);
-    FALCOR_GFX_CALL(mGfxFence->setCurrentValue(signalValue));
+    if (mGfxFence)
+        FALCOR_GFX_CALL(mGfxFence->setCurrentValue(signalValue));
     return signalValue;
 }
 
@@ -64,6 +74,8 @@ void Fence::wait(uint64_t value, uint64_t timeoutNs)
 
 uint64_t Fence::getCurrentValue()
 {
+    if (!mGfxFence)
+        return mSignaledValue;
     uint64_t value;
     FALCOR_GFX_CALL(mGfxFence->getCurrentValue(&value));
     return value;
@@ -77,6 +89,7 @@ uint64_t Fence::updateSignaledValue(uint64_t value)
 
 SharedResourceApiHandle Fence::getSharedApiHandle() const
 {
+    FALCOR_CHECK(mGfxFence, "Fence has no shared handle on the CPU device.");
     gfx::InteropHandle sharedHandle;
     FALCOR_GFX_CALL(mGfxFence->getSharedHandle(&sharedHandle));
     return (SharedResourceApiHandle)sharedHandle.handleValue;
@@ -84,6 +97,8 @@ SharedResourceApiHandle Fence::getSharedApiHandle() const
 
 NativeHandle Fence::getNativeHandle() const
 {
+    if (!mGfxFence)
+        return {};
     gfx::InteropHandle gfxNativeHandle = {};
     FALCOR_GFX_CALL(mGfxFence->getNativeHandle(&gfxNativeHandle));
 #if FALCOR_HAS_D3D12
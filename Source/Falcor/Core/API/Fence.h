@@ -110,7 +110,7 @@ public:
     uint64_t updateSignaledValue(uint64_t value = kAuto);
 
     /**
-     * Get the internal API handle
+     * Get the internal API handle. Returns nullptr on the CPU device, where fences are tracked on the host.
      */
     gfx::IFence* getGfxFence() const { return mGfxFence; }
 
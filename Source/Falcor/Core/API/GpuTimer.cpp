@@ -54,6 +54,10 @@ GpuTimer::GpuTimer(ref<Device> pDevice) : mpDevice(pDevice)
     mpResolveStagingBuffer = mpDevice->createBuffer(sizeof(uint64_t) * 2, ResourceBindFlags::None, MemoryType::ReadBack, nullptr);
     mpResolveStagingBuffer->breakStrongReferenceToDevice();
 
+    // The CPU device has no timestamp queries. The timer reports zero time on it.
+    if (!mpDevice->getTimestampQueryHeap())
+        return;
+
     // Create timestamp query heap upon first use.
     mStart = mpDevice->getTimestampQueryHeap()->allocate();
     mEnd = mpDevice->getTimestampQueryHeap()->allocate();
@@ -66,6 +70,8 @@ GpuTimer::GpuTimer(ref<Device> pDevice) : mpDevice(pDevice)
 
 GpuTimer::~GpuTimer()
 {
+    if (!mpDevice->getTimestampQueryHeap())
+        return;
     mpDevice->getTimestampQueryHeap()->release(mStart);
     mpDevice->getTimestampQueryHeap()->release(mEnd);
 }
@@ -88,9 +94,12 @@ void GpuTimer::begin()
         );
     }
 
-    mpDevice->getRenderContext()->getLowLevelData()->getResourceCommandEncoder()->writeTimestamp(
-        mpDevice->getTimestampQueryHeap()->getGfxQueryPool(), mStart
-    );
+    if (mpDevice->getTimestampQueryHeap())
+    {
+        mpDevice->getRenderContext()->getLowLevelData()->getResourceCommandEncoder()->writeTimestamp(
+            mpDevice->getTimestampQueryHeap()->getGfxQueryPool(), mStart
+        );
+    }
     mStatus = Status::Begin;
 }
 
@@ -102,9 +111,12 @@ void GpuTimer::end()
         return;
     }
 
-    mpDevice->getRenderContext()->getLowLevelData()->getResourceCommandEncoder()->writeTimestamp(
-        mpDevice->getTimestampQueryHeap()->getGfxQueryPool(), mEnd
-    );
+    if (mpDevice->getTimestampQueryHeap())
+    {
+        mpDevice->getRenderContext()->getLowLevelData()->getResourceCommandEncoder()->writeTimestamp(
+            mpDevice->getTimestampQueryHeap()->getGfxQueryPool(), mEnd
+        );
+    }
     mStatus = Status::End;
 }
 
@@ -122,6 +134,12 @@ void GpuTimer::resolve()
 
     FALCOR_ASSERT(mStatus == Status::End);
 
+    if (!mpDevice->getTimestampQueryHeap())
+    {
+        mStatus = Status::Idle;
+        return;
+    }
+
     // TODO: The code here is inefficient as it resolves each timer individually.
     // This should be batched across all active timers and results copied into a single staging buffer once per frame instead.
 
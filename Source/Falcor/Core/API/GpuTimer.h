@@ -37,6 +37,7 @@ namespace Falcor
 /**
  * Abstracts GPU timer queries.
  * This class provides mechanism to get elapsed time in milliseconds between a pair of begin()/end() calls.
+ * The CPU device has no timestamp queries, timers always report zero elapsed time on it.
  */
 class FALCOR_API GpuTimer : public Object
 {
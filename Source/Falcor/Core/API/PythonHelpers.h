@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 
+#include "Core/Error.h"
 #include "Core/API/Formats.h"
 #include "Core/Program/Program.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -75,6 +76,20 @@ size_t isNdarrayContiguous(const pybind11::ndarray<Args...>& array)
     return true;
 }
 
+/**
+ * Get a pointer to an element of an ndarray, taking the strides of the array into account.
+ * This allows reading non-contiguous arrays (e.g. slices or views of interleaved data) without copying them first.
+ */
+template<typename T, typename... Args, typename... Indices>
+const T* getNdarrayElement(const pybind11::ndarray<Args...>& array, Indices... indices)
+{
+    FALCOR_ASSERT(sizeof...(Indices) == array.ndim());
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(array.data());
+    size_t dim = 0;
+    ((ptr += int64_t(indices) * array.stride(dim++) * (int64_t)getDtypeByteSize(array.dtype())), ...);
+    return reinterpret_cast<const T*>(ptr);
+}
+
 pybind11::dlpack::dtype dataTypeToDtype(DataType type);
 std::optional<pybind11::dlpack::dtype> resourceFormatToDtype(ResourceFormat format);
 
@@ -0,0 +1,508 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AsyncFileReader.h"
+#include "Core/Error.h"
+#include "Utils/StringFormatters.h"
+
+#include <BS_thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if FALCOR_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif FALCOR_LINUX
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#error "Unknown OS"
+#endif
+
+namespace Falcor
+{
+namespace
+{
+#if FALCOR_WINDOWS
+using FileHandle = HANDLE;
+const FileHandle kInvalidFile = INVALID_HANDLE_VALUE;
+#elif FALCOR_LINUX
+using FileHandle = int;
+const FileHandle kInvalidFile = -1;
+#endif
+
+FileHandle openFile(const std::filesystem::path& path)
+{
+#if FALCOR_WINDOWS
+    return ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#elif FALCOR_LINUX
+    return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+}
+
+void closeFile(FileHandle file)
+{
+#if FALCOR_WINDOWS
+    ::CloseHandle(file);
+#elif FALCOR_LINUX
+    ::close(file);
+#endif
+}
+
+/// Blocking read at a file offset. Returns the number of bytes read (less than size at the end of the file) or -1 on failure.
+int64_t readAt(FileHandle file, uint64_t offset, uint8_t* pData, size_t size)
+{
+    size_t bytesRead = 0;
+    while (bytesRead < size)
+    {
+#if FALCOR_WINDOWS
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = DWORD((offset + bytesRead) & 0xFFFFFFFF);
+        overlapped.OffsetHigh = DWORD((offset + bytesRead) >> 32);
+        DWORD count = 0;
+        if (!::ReadFile(file, pData + bytesRead, DWORD(std::min<size_t>(size - bytesRead, 1u << 30)), &count, &overlapped))
+            return ::GetLastError() == ERROR_HANDLE_EOF ? int64_t(bytesRead) : -1;
+#elif FALCOR_LINUX
+        ssize_t count = ::pread64(file, pData + bytesRead, size - bytesRead, off64_t(offset + bytesRead));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+#endif
+        if (count == 0)
+            break;
+        bytesRead += count;
+    }
+    return int64_t(bytesRead);
+}
+} // namespace
+
+struct AsyncFileReader::Batch
+{
+    struct Chunk
+    {
+        uint32_t requestIndex;
+        uint64_t offset;
+        uint8_t* pData;
+        size_t size;
+        size_t bytesRead = 0;
+        bool failed = false;
+    };
+
+    std::vector<Request> requests;
+    std::vector<FileHandle> files;
+    std::vector<Chunk> chunks;
+    std::atomic<size_t> pendingChunks{0};
+    std::promise<std::vector<Result>> promise;
+
+    Batch(std::vector<Request> requests_) : requests(std::move(requests_))
+    {
+        // Open files and split requests into chunks.
+        files.resize(requests.size(), kInvalidFile);
+        for (uint32_t i = 0; i < requests.size(); ++i)
+        {
+            const Request& request = requests[i];
+            files[i] = openFile(request.path);
+            if (files[i] == kInvalidFile)
+                continue;
+            for (size_t offset = 0; offset < request.size; offset += kChunkSize)
+            {
+                size_t size = std::min(kChunkSize, request.size - offset);
+                chunks.push_back({i, request.offset + offset, static_cast<uint8_t*>(request.pData) + offset, size});
+            }
+        }
+        pendingChunks = chunks.size();
+    }
+};
+
+#if FALCOR_LINUX
+/**
+ * Minimal io_uring wrapper using the raw system calls.
+ * Only the submitting thread writes to the submission queue and reads the completion queue.
+ */
+struct AsyncFileReader::IoUring
+{
+    int fd = -1;
+    void* pSQRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void* pCQRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    io_uring_sqe* pSQEs = nullptr;
+    size_t sqesSize = 0;
+
+    uint32_t* pSQHead;
+    uint32_t* pSQTail;
+    uint32_t* pSQArray;
+    uint32_t sqMask;
+    uint32_t sqEntries;
+    uint32_t* pCQHead;
+    uint32_t* pCQTail;
+    io_uring_cqe* pCQEs;
+    uint32_t cqMask;
+
+    ~IoUring()
+    {
+        if (pSQEs)
+            ::munmap(pSQEs, sqesSize);
+        if (pCQRing != MAP_FAILED && pCQRing != pSQRing)
+            ::munmap(pCQRing, cqRingSize);
+        if (pSQRing != MAP_FAILED)
+            ::munmap(pSQRing, sqRingSize);
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    bool init(uint32_t entries)
+    {
+        io_uring_params params = {};
+        fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+            return false;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap)
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+        pSQRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (pSQRing == MAP_FAILED)
+            return false;
+        pCQRing = singleMap ? pSQRing
+                            : ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (pCQRing == MAP_FAILED)
+            return false;
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* pSQEMapping = ::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (pSQEMapping == MAP_FAILED)
+            return false;
+        pSQEs = static_cast<io_uring_sqe*>(pSQEMapping);
+
+        uint8_t* sq = static_cast<uint8_t*>(pSQRing);
+        pSQHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+        pSQTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+        pSQArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+        sqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+        sqEntries = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_entries);
+        uint8_t* cq = static_cast<uint8_t*>(pCQRing);
+        pCQHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+        pCQTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+        pCQEs = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        cqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+
+        // Make sure the ring is usable, system calls may be filtered (e.g. in containers).
+        io_uring_sqe* pSQE = getSQE();
+        pSQE->opcode = IORING_OP_NOP;
+        pSQE->user_data = 0;
+        if (enter(1, 1) != 1)
+            return false;
+        bool success = false;
+        reap([&](const io_uring_cqe& cqe) { success = cqe.res == 0; });
+        return success;
+    }
+
+    /// Get the next submission queue entry. The caller must make sure the queue is not full.
+    io_uring_sqe* getSQE()
+    {
+        uint32_t tail = *pSQTail;
+        FALCOR_ASSERT(tail - __atomic_load_n(pSQHead, __ATOMIC_ACQUIRE) < sqEntries);
+        uint32_t index = tail & sqMask;
+        io_uring_sqe* pSQE = &pSQEs[index];
+        std::memset(pSQE, 0, sizeof(io_uring_sqe));
+        pSQArray[index] = index;
+        __atomic_store_n(pSQTail, tail + 1, __ATOMIC_RELEASE);
+        return pSQE;
+    }
+
+    /// Submit entries and wait for completions. Returns the number of submitted entries or -1 on failure (see errno).
+    int enter(uint32_t submitCount, uint32_t waitCount)
+    {
+        return int(::syscall(__NR_io_uring_enter, fd, submitCount, waitCount, waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+    }
+
+    /**
+     * Discard the entries not yet consumed by the kernel and wait for all entries in flight.
+     * Must be called after a failed submission, so that the completions aren't reaped by a later batch.
+     * @return False if waiting failed and completions may still arrive.
+     */
+    template<typename Func>
+    bool drain(uint32_t inFlight, Func func)
+    {
+        __atomic_store_n(pSQTail, __atomic_load_n(pSQHead, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        while (inFlight > 0)
+        {
+            if (enter(0, 1) < 0 && errno != EINTR)
+                return false;
+            reap(
+                [&](const io_uring_cqe& cqe)
+                {
+                    inFlight--;
+                    func(cqe);
+                }
+            );
+        }
+        return true;
+    }
+
+    /// Call a function for all available completion queue entries and release them.
+    template<typename Func>
+    void reap(Func func)
+    {
+        uint32_t head = *pCQHead;
+        uint32_t tail = __atomic_load_n(pCQTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head)
+            func(pCQEs[head & cqMask]);
+        __atomic_store_n(pCQHead, head, __ATOMIC_RELEASE);
+    }
+};
+#else
+struct AsyncFileReader::IoUring
+{
+    bool init(uint32_t entries) { return false; }
+};
+#endif
+
+AsyncFileReader::AsyncFileReader(Backend preferredBackend, uint32_t queueDepth) : mBackend(preferredBackend), mQueueDepth(std::max(queueDepth, 1u))
+{
+    if (mBackend == Backend::IoUring)
+    {
+        mpRing = std::make_unique<IoUring>();
+        if (mpRing->init(mQueueDepth))
+        {
+#if FALCOR_LINUX
+            mQueueDepth = std::min(mQueueDepth, mpRing->sqEntries);
+#endif
+            mWorker = std::thread(&AsyncFileReader::processBatches, this);
+        }
+        else
+        {
+            mpRing.reset();
+            mBackend = Backend::ThreadPool;
+        }
+    }
+
+    if (mBackend == Backend::ThreadPool)
+        mpThreadPool = std::make_unique<BS::thread_pool>(mQueueDepth);
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    if (mWorker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+        }
+        mCondition.notify_one();
+        mWorker.join();
+    }
+
+    // Waits for all queued tasks to finish.
+    mpThreadPool.reset();
+}
+
+std::future<std::vector<AsyncFileReader::Result>> AsyncFileReader::submit(std::vector<Request> requests)
+{
+    for (const auto& request : requests)
+        FALCOR_CHECK(request.pData || request.size == 0, "Read request for '{}' has no destination buffer.", request.path);
+
+    auto pBatch = std::make_shared<Batch>(std::move(requests));
+    auto future = pBatch->promise.get_future();
+
+    if (pBatch->chunks.empty())
+    {
+        finishBatch(*pBatch);
+    }
+    else if (mBackend == Backend::IoUring)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQueue.push_back(std::move(pBatch));
+        }
+        mCondition.notify_one();
+    }
+    else
+    {
+        for (size_t i = 0; i < pBatch->chunks.size(); ++i)
+        {
+            mpThreadPool->push_task(
+                [pBatch, i]()
+                {
+                    auto& chunk = pBatch->chunks[i];
+                    int64_t bytesRead = readAt(pBatch->files[chunk.requestIndex], chunk.offset, chunk.pData, chunk.size);
+                    chunk.failed = bytesRead < 0;
+                    chunk.bytesRead = std::max<int64_t>(bytesRead, 0);
+                    if (--pBatch->pendingChunks == 0)
+                        finishBatch(*pBatch);
+                }
+            );
+        }
+    }
+
+    return future;
+}
+
+void AsyncFileReader::finishBatch(Batch& batch)
+{
+    std::vector<Result> results(batch.requests.size());
+    for (size_t i = 0; i < results.size(); ++i)
+        results[i].success = batch.files[i] != kInvalidFile;
+    for (const auto& chunk : batch.chunks)
+    {
+        results[chunk.requestIndex].bytesRead += chunk.bytesRead;
+        if (chunk.failed)
+            results[chunk.requestIndex].success = false;
+    }
+
+    for (auto file : batch.files)
+        if (file != kInvalidFile)
+            closeFile(file);
+    batch.files.clear();
+
+    batch.promise.set_value(std::move(results));
+}
+
+void AsyncFileReader::processBatches()
+{
+    while (true)
+    {
+        std::shared_ptr<Batch> pBatch;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mTerminate || !mQueue.empty(); });
+            // Queued batches are processed before terminating.
+            if (mQueue.empty())
+                return;
+            pBatch = std::move(mQueue.front());
+            mQueue.pop_front();
+        }
+
+        try
+        {
+            processBatch(*pBatch);
+        }
+        catch (...)
+        {
+            for (auto file : pBatch->files)
+                if (file != kInvalidFile)
+                    closeFile(file);
+            pBatch->promise.set_exception(std::current_exception());
+        }
+    }
+}
+
+void AsyncFileReader::processBatch(Batch& batch)
+{
+#if FALCOR_LINUX
+    FALCOR_CHECK(!mRingFailed, "io_uring is unusable after a previous error.");
+    IoUring& ring = *mpRing;
+
+    std::deque<uint32_t> pending;
+    for (uint32_t i = 0; i < batch.chunks.size(); ++i)
+        pending.push_back(i);
+    std::vector<iovec> iovecs(batch.chunks.size());
+
+    uint32_t inFlight = 0;
+    uint32_t unsubmitted = 0;
+    while (!pending.empty() || inFlight > 0 || unsubmitted > 0)
+    {
+        // Queue chunks until the queue depth is reached. Short reads are queued again for the remaining bytes.
+        while (!pending.empty() && inFlight + unsubmitted < mQueueDepth)
+        {
+            uint32_t index = pending.front();
+            pending.pop_front();
+            auto& chunk = batch.chunks[index];
+            iovecs[index].iov_base = chunk.pData + chunk.bytesRead;
+            iovecs[index].iov_len = chunk.size - chunk.bytesRead;
+
+            io_uring_sqe* pSQE = ring.getSQE();
+            pSQE->opcode = IORING_OP_READV;
+            pSQE->fd = batch.files[chunk.requestIndex];
+            pSQE->off = chunk.offset + chunk.bytesRead;
+            pSQE->addr = reinterpret_cast<uint64_t>(&iovecs[index]);
+            pSQE->len = 1;
+            pSQE->user_data = index;
+            unsubmitted++;
+        }
+
+        int submitted = ring.enter(unsubmitted, inFlight + unsubmitted > 0 ? 1 : 0);
+        if (submitted < 0)
+        {
+            // Only transient errors are expected once the ring is set up. Retry after reaping completions.
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            {
+                // Wait for the reads in flight, they write to the batch buffers and must not complete into a later batch.
+                const int error = errno;
+                if (!ring.drain(inFlight, [&](const io_uring_cqe& cqe) { batch.chunks[uint32_t(cqe.user_data)].failed = true; }))
+                    mRingFailed = true;
+                FALCOR_THROW("io_uring_enter() failed with error {}.", error);
+            }
+            submitted = 0;
+        }
+        unsubmitted -= submitted;
+        inFlight += submitted;
+
+        ring.reap(
+            [&](const io_uring_cqe& cqe)
+            {
+                uint32_t index = uint32_t(cqe.user_data);
+                auto& chunk = batch.chunks[index];
+                inFlight--;
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+                {
+                    pending.push_back(index);
+                }
+                else if (cqe.res < 0)
+                {
+                    chunk.failed = true;
+                }
+                else if (cqe.res > 0)
+                {
+                    chunk.bytesRead += cqe.res;
+                    if (chunk.bytesRead < chunk.size)
+                        pending.push_back(index);
+                }
+                // A result of zero indicates the end of the file.
+            }
+        );
+    }
+#endif
+    finishBatch(batch);
+}
+
+} // namespace Falcor
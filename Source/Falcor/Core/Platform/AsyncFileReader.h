@@ -0,0 +1,149 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "Core/Macros.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BS
+{
+class thread_pool;
+}
+
+namespace Falcor
+{
+
+/**
+ * Batched asynchronous reads of file ranges into memory.
+ *
+ * This is meant for bulk reads that don't benefit from memory mapping, e.g. reading many large
+ * files into staging memory. Requests are split into chunks that are read concurrently:
+ * - On Linux, chunks are submitted to an io_uring from a single worker thread, keeping many
+ *   reads in flight without blocking any threads.
+ * - Elsewhere, or if io_uring is not available (old kernels, restricted containers), chunks
+ *   are read with blocking reads on a pool of worker threads.
+ *
+ * The io_uring backend processes batches one after the other, in the order they are submitted.
+ * The thread pool backend reads the chunks of all submitted batches concurrently, so batches
+ * may complete in any order. All operations are thread-safe.
+ */
+class FALCOR_API AsyncFileReader
+{
+public:
+    enum class Backend
+    {
+        IoUring,    ///< Linux io_uring.
+        ThreadPool, ///< Blocking reads on a thread pool.
+    };
+
+    struct Request
+    {
+        std::filesystem::path path; ///< File to read from.
+        uint64_t offset = 0;        ///< Offset from the start of the file in bytes.
+        size_t size = 0;            ///< Number of bytes to read.
+        void* pData = nullptr;      ///< Destination buffer of at least 'size' bytes. Must stay valid until the batch has finished.
+    };
+
+    struct Result
+    {
+        bool success = false; ///< True if the file was opened and read without errors.
+        size_t bytesRead = 0; ///< Number of bytes read. Less than the requested size if the range extends past the end of the file.
+    };
+
+    /// Default maximum number of chunks in flight.
+    static constexpr uint32_t kDefaultQueueDepth = 32;
+    /// Size of the chunks requests are split into.
+    static constexpr size_t kChunkSize = 1 << 20;
+
+    /**
+     * Constructor.
+     * @param preferredBackend Preferred backend. Falls back to the thread pool if io_uring is not available.
+     * @param queueDepth Maximum number of chunks in flight (number of worker threads of the thread pool backend).
+     */
+    AsyncFileReader(Backend preferredBackend = Backend::IoUring, uint32_t queueDepth = kDefaultQueueDepth);
+
+    /// Destructor. Waits for all submitted batches to finish.
+    ~AsyncFileReader();
+
+    /// Get the backend in use.
+    Backend getBackend() const { return mBackend; }
+
+    /// Get the maximum number of chunks in flight.
+    uint32_t getQueueDepth() const { return mQueueDepth; }
+
+    /**
+     * Submit a batch of reads.
+     * @param requests Read requests.
+     * @return Future of the results, one per request.
+     */
+    std::future<std::vector<Result>> submit(std::vector<Request> requests);
+
+    /**
+     * Read a batch and wait for it to finish.
+     * @param requests Read requests.
+     * @return Results, one per request.
+     */
+    std::vector<Result> read(std::vector<Request> requests) { return submit(std::move(requests)).get(); }
+
+private:
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    struct Batch;
+    struct IoUring;
+
+    static void finishBatch(Batch& batch);
+    void processBatches();
+    void processBatch(Batch& batch);
+
+    Backend mBackend;
+    uint32_t mQueueDepth;
+
+    // io_uring backend.
+    std::unique_ptr<IoUring> mpRing;
+    std::thread mWorker;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<std::shared_ptr<Batch>> mQueue;
+    bool mTerminate = false;
+    bool mRingFailed = false; ///< True if the ring could not be drained after an error. Subsequent batches fail.
+
+    // Thread pool backend.
+    std::unique_ptr<BS::thread_pool> mpThreadPool;
+};
+
+} // namespace Falcor
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "MemoryMappedFile.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <cstdio>
 
@@ -48,9 +49,9 @@
 namespace Falcor
 {
 
-MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& path, size_t mappedSize, AccessHint accessHint)
+MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& path, size_t mappedSize, AccessHint accessHint, MapFlags mapFlags)
 {
-    open(path, mappedSize, accessHint);
+    open(path, mappedSize, accessHint, mapFlags);
 }
 
 MemoryMappedFile::~MemoryMappedFile()
@@ -58,13 +59,14 @@ MemoryMappedFile::~MemoryMappedFile()
     close();
 }
 
-bool MemoryMappedFile::open(const std::filesystem::path& path, size_t mappedSize, AccessHint accessHint)
+bool MemoryMappedFile::open(const std::filesystem::path& path, size_t mappedSize, AccessHint accessHint, MapFlags mapFlags)
 {
     if (isOpen())
         return false;
 
     mPath = path;
     mAccessHint = accessHint;
+    mMapFlags = mapFlags;
 
 #if FALCOR_WINDOWS
     // Handle access hint.
@@ -172,6 +174,31 @@ void MemoryMappedFile::close()
     mSize = 0;
 }
 
+bool MemoryMappedFile::prefetch(size_t offset, size_t size) const
+{
+    if (!mMappedData || offset >= mMappedSize)
+        return false;
+
+    // Clamp range and align the start to the page size.
+    size = std::min(size, mMappedSize - offset);
+    size_t alignedOffset = offset - offset % getPageSize();
+    size += offset - alignedOffset;
+    void* address = static_cast<uint8_t*>(mMappedData) + alignedOffset;
+
+#if FALCOR_WINDOWS
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = address;
+    range.NumberOfBytes = size;
+    return ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0) != 0;
+#elif FALCOR_LINUX
+    // Both start asynchronous readahead of the range into the page cache. Fall back to readahead() on the file
+    // if the advice is rejected for the mapping.
+    if (::madvise(address, size, MADV_WILLNEED) == 0)
+        return true;
+    return ::readahead(mFile, off64_t(mMappedOffset + alignedOffset), size) == 0;
+#endif
+}
+
 size_t MemoryMappedFile::getPageSize()
 {
 #if FALCOR_WINDOWS
@@ -215,15 +242,24 @@ bool MemoryMappedFile::remap(uint64_t offset, size_t mappedSize)
     if (!mMappedData)
         mMappedSize = 0;
     mMappedSize = mappedSize;
+    mMappedOffset = offset;
+
+    // Windows has no equivalent of MAP_POPULATE, read the mapping in the background instead.
+    if (mMappedData && is_set(mMapFlags, MapFlags::Populate))
+        prefetch();
 #else
     // Create new mapping.
-    mMappedData = ::mmap64(NULL, mappedSize, PROT_READ, MAP_SHARED, mFile, offset);
+    int flags = MAP_SHARED;
+    if (is_set(mMapFlags, MapFlags::Populate))
+        flags |= MAP_POPULATE;
+    mMappedData = ::mmap64(NULL, mappedSize, PROT_READ, flags, mFile, offset);
     if (mMappedData == MAP_FAILED)
     {
         mMappedData = nullptr;
         return false;
     }
     mMappedSize = mappedSize;
+    mMappedOffset = offset;
 
     // Handle access hint.
     int advice = 0;
@@ -242,6 +278,12 @@ bool MemoryMappedFile::remap(uint64_t offset, size_t mappedSize)
         break;
     }
     ::madvise(mMappedData, mMappedSize, advice);
+
+    // Huge pages for file mappings depend on kernel and file system support, so failures are ignored.
+#ifdef MADV_HUGEPAGE
+    if (is_set(mMapFlags, MapFlags::HugePages))
+        ::madvise(mMappedData, mMappedSize, MADV_HUGEPAGE);
+#endif
 #endif
 
     return true;
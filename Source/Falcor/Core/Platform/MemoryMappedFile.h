@@ -39,6 +39,10 @@ namespace Falcor
 
 /**
  * Utility class for reading memory-mapped files.
+ *
+ * Pages of a mapping are faulted in on first access by default. Consumers that know which
+ * ranges they are about to read can use prefetch() to start reading them in the background,
+ * or map the file with MapFlags::Populate to read the entire mapping up front.
  */
 class FALCOR_API MemoryMappedFile
 {
@@ -50,6 +54,13 @@ public:
         RandomAccess    ///< Good for random access.
     };
 
+    enum class MapFlags
+    {
+        None = 0x0,
+        Populate = 0x1,  ///< Read the entire mapping into memory when mapping the file (MAP_POPULATE on Linux).
+        HugePages = 0x2, ///< Hint to back the mapping with transparent huge pages (Linux only, ignored elsewhere).
+    };
+
     static constexpr size_t kWholeFile = std::numeric_limits<size_t>::max();
 
     /**
@@ -62,8 +73,14 @@ public:
      * @param path Path to open.
      * @param mappedSize Number of bytes to map into memory (automatically clamped to the file size).
      * @param accessHint Hint on how memory is accessed.
+     * @param mapFlags Mapping flags.
      */
-    MemoryMappedFile(const std::filesystem::path& path, size_t mappedSize = kWholeFile, AccessHint accessHint = AccessHint::Normal);
+    MemoryMappedFile(
+        const std::filesystem::path& path,
+        size_t mappedSize = kWholeFile,
+        AccessHint accessHint = AccessHint::Normal,
+        MapFlags mapFlags = MapFlags::None
+    );
 
     /// Destructor. Closes the file.
     ~MemoryMappedFile();
@@ -73,9 +90,15 @@ public:
      * @param path Path to open.
      * @param mappedSize Number of bytes to map into memory (automatically clamped to the file size).
      * @param accessHint Hint on how memory is accessed.
+     * @param mapFlags Mapping flags.
      * @return True if file was successfully opened.
      */
-    bool open(const std::filesystem::path& path, size_t mappedSize = kWholeFile, AccessHint accessHint = AccessHint::Normal);
+    bool open(
+        const std::filesystem::path& path,
+        size_t mappedSize = kWholeFile,
+        AccessHint accessHint = AccessHint::Normal,
+        MapFlags mapFlags = MapFlags::None
+    );
 
     /// Close the file.
     void close();
@@ -92,6 +115,16 @@ public:
     /// Get the mapped memory size in bytes.
     size_t getMappedSize() const { return mMappedSize; };
 
+    /**
+     * Start reading a range of the mapping into memory in the background.
+     * This is a hint only, the call returns immediately and the range may still be faulted
+     * in on first access if the read has not finished.
+     * @param offset Offset from the start of the mapping in bytes.
+     * @param size Size of the range in bytes (automatically clamped to the mapped size).
+     * @return True if the hint was issued.
+     */
+    bool prefetch(size_t offset = 0, size_t size = kWholeFile) const;
+
     /// Get the OS page size (for remap).
     static size_t getPageSize();
 
@@ -111,6 +144,7 @@ private:
 
     std::filesystem::path mPath;
     AccessHint mAccessHint = AccessHint::Normal;
+    MapFlags mMapFlags = MapFlags::None;
     size_t mSize = 0;
 
 #if FALCOR_WINDOWS
@@ -125,6 +159,9 @@ private:
     FileHandle mFile = 0;
     void* mMappedData = 0;
     size_t mMappedSize = 0;
+    uint64_t mMappedOffset = 0;
 };
 
+FALCOR_ENUM_CLASS_OPERATORS(MemoryMappedFile::MapFlags);
+
 } // namespace Falcor
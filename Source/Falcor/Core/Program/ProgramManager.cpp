@@ -694,6 +694,11 @@ SlangCompileRequest* ProgramManager::createSlangCompileRequest(const Program& pr
         targetDesc.format = SLANG_SPIRV;
         targetMacroName = "FALCOR_VULKAN";
         break;
+    case Device::Type::CPU:
+        // Kernels are compiled to host code that is loaded and executed in-process by the CPU device.
+        targetDesc.format = SLANG_SHADER_HOST_CALLABLE;
+        targetMacroName = "FALCOR_CPU";
+        break;
     default:
         FALCOR_UNREACHABLE();
     }
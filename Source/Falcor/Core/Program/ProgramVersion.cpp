@@ -150,6 +150,40 @@ ref<ProgramKernels> ProgramKernels::create(
         log = (const char*)diagnostics->getBufferPointer();
     }
 
+    // On the CPU device, compute kernels are linked to host code here instead of within GFX.
+    // This lets ComputeContext split dispatches into ranges of thread groups that execute in parallel.
+    if (pProgram && pDevice->getType() == Device::Type::CPU && pTypeConformanceSpecializedEntryPoints.size() == 1)
+    {
+        slang::IComponentType* pEntryPoint = pTypeConformanceSpecializedEntryPoints[0];
+        if (pEntryPoint->getLayout()->getEntryPointByIndex(0)->getStage() == SLANG_STAGE_COMPUTE)
+        {
+            slang::IComponentType* components[] = {pSpecializedSlangGlobalScope, pEntryPoint};
+            Slang::ComPtr<slang::IComponentType> pComposite;
+            Slang::ComPtr<slang::IComponentType> pLinked;
+            Slang::ComPtr<ISlangBlob> cpuDiagnostics;
+            if (SLANG_FAILED(pSpecializedSlangGlobalScope->getSession()->createCompositeComponentType(
+                    components, 2, pComposite.writeRef(), cpuDiagnostics.writeRef()
+                )) ||
+                SLANG_FAILED(pComposite->link(pLinked.writeRef(), cpuDiagnostics.writeRef())) ||
+                SLANG_FAILED(pLinked->getEntryPointHostCallable(0, 0, pProgram->mpCpuSharedLibrary.writeRef(), cpuDiagnostics.writeRef())))
+            {
+                pProgram = nullptr;
+            }
+            else
+            {
+                const char* name = pLinked->getLayout()->getEntryPointByIndex(0)->getNameOverride();
+                pProgram->mCpuComputeFunc = (CpuComputeFunc)pProgram->mpCpuSharedLibrary->findFuncByName(name);
+                if (!pProgram->mCpuComputeFunc)
+                {
+                    log += fmt::format("Can't find host function '{}' of the compute kernel.\n", name);
+                    pProgram = nullptr;
+                }
+            }
+            if (cpuDiagnostics)
+                log += (const char*)cpuDiagnostics->getBufferPointer();
+        }
+    }
+
     return pProgram;
 }
 
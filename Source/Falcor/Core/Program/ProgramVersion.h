@@ -164,6 +164,18 @@ protected:
     std::string mExportName;
 };
 
+/**
+ * Host-callable compute kernel generated by Slang for the CPU device.
+ * This mirrors `ComputeVaryingInput` and `ComputeFunc` of the Slang C++ prelude.
+ * A call executes the thread groups in the range [startGroupID, endGroupID).
+ */
+struct CpuComputeVaryingInput
+{
+    uint32_t startGroupID[3];
+    uint32_t endGroupID[3];
+};
+using CpuComputeFunc = void (*)(CpuComputeVaryingInput* pVaryingInput, void* pEntryPointParams, void* pGlobalParams);
+
 /**
  * Low-level program object
  * This class abstracts the API's program creation and management
@@ -222,6 +234,12 @@ public:
 
     gfx::IShaderProgram* getGfxProgram() const { return mGfxProgram; }
 
+    /**
+     * Get the host function of the compute kernel on the CPU device, or nullptr for other devices and program types.
+     * ComputeContext calls it directly to execute ranges of thread groups in parallel.
+     */
+    CpuComputeFunc getCpuComputeFunc() const { return mCpuComputeFunc; }
+
 protected:
     ProgramKernels(
         const ProgramVersion* pVersion,
@@ -231,6 +249,8 @@ protected:
     );
 
     Slang::ComPtr<gfx::IShaderProgram> mGfxProgram;
+    Slang::ComPtr<ISlangSharedLibrary> mpCpuSharedLibrary; ///< Host code of the compute kernel on the CPU device.
+    CpuComputeFunc mCpuComputeFunc = nullptr;
     const std::string mName;
 
     UniqueEntryPointGroups mUniqueEntryPointGroups;
@@ -100,7 +100,8 @@ void Testbed::frame()
     // Execute the render graph.
     if (mpRenderGraph)
     {
-        mpRenderGraph->getPassesDictionary()[kRenderPassRefreshFlags] = RenderPassRefreshFlags::None;
+        mpRenderGraph->getPassesDictionary().setValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
+        mpRenderGraph->getPassesDictionary().setValue(kRenderPassFrameTimeDeltaKey, (float)mClock.getDelta());
         mpRenderGraph->execute(pRenderContext);
 
         // Blit main graph output to frame buffer.
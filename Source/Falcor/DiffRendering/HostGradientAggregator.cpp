@@ -0,0 +1,129 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "HostGradientAggregator.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+
+#include <algorithm>
+
+namespace Falcor
+{
+HostGradientAggregator::HostGradientAggregator(uint32_t gradDim, uint32_t hashSize, GradientAggregateMode mode)
+    : mGradDim(gradDim), mHashSize(mode == GradientAggregateMode::Direct ? 1 : hashSize), mMode(mode)
+{
+    FALCOR_CHECK(mHashSize > 0, "Hash size must be greater than zero.");
+    mTmpGrads.resize(size_t(mGradDim) * mHashSize, 0.f);
+    mGrads.resize(mGradDim, 0.f);
+    if (mMode == GradientAggregateMode::Sparse)
+        mTouchedBlockMask.resize(getBlockMaskSize(mGradDim), 0);
+}
+
+void HostGradientAggregator::clear()
+{
+    std::fill(mGrads.begin(), mGrads.end(), 0.f);
+
+    if (mMode == GradientAggregateMode::Sparse)
+    {
+        // Only the slots of touched blocks can be non-zero. Reset them without reducing.
+        for (size_t word = 0; word < mTouchedBlockMask.size(); word++)
+        {
+            for (uint32_t bits = mTouchedBlockMask[word]; bits != 0; bits &= bits - 1)
+            {
+                uint32_t block = uint32_t(word * 32) + bitScanForward(bits);
+                for (uint32_t i = block * kGradientBlockSize; i < std::min((block + 1) * kGradientBlockSize, mGradDim); i++)
+                    for (uint32_t h = 0; h < mHashSize; h++)
+                        mTmpGrads[size_t(h) * mGradDim + i] = 0.f;
+            }
+            mTouchedBlockMask[word] = 0;
+        }
+    }
+    else
+    {
+        std::fill(mTmpGrads.begin(), mTmpGrads.end(), 0.f);
+    }
+}
+
+void HostGradientAggregator::atomicAddGrad(uint32_t gradIndex, uint32_t hashIndex, float value)
+{
+    if (gradIndex >= mGradDim)
+        return;
+    FALCOR_ASSERT(hashIndex < mHashSize);
+    mTmpGrads[size_t(hashIndex) * mGradDim + gradIndex] += value;
+
+    if (mMode == GradientAggregateMode::Sparse)
+    {
+        uint32_t block = gradIndex / kGradientBlockSize;
+        mTouchedBlockMask[block / 32] |= 1u << (block % 32);
+    }
+}
+
+void HostGradientAggregator::aggregate()
+{
+    mReducedEntryCount = 0;
+
+    if (mMode != GradientAggregateMode::Sparse)
+    {
+        // Dense reduction over all parameters and slots.
+        for (uint32_t i = 0; i < mGradDim; i++)
+        {
+            float sum = 0.f;
+            for (uint32_t h = 0; h < mHashSize; h++)
+                sum += mTmpGrads[size_t(h) * mGradDim + i];
+            mGrads[i] += sum;
+        }
+        mReducedEntryCount = uint64_t(mGradDim) * mHashSize;
+        return;
+    }
+
+    // Compact the touched block mask into a list of blocks.
+    mTouchedBlocks.clear();
+    for (size_t word = 0; word < mTouchedBlockMask.size(); word++)
+    {
+        for (uint32_t bits = mTouchedBlockMask[word]; bits != 0; bits &= bits - 1)
+            mTouchedBlocks.push_back(uint32_t(word * 32) + bitScanForward(bits));
+        mTouchedBlockMask[word] = 0;
+    }
+
+    // Segmented reduction: each touched parameter reduces its slots, consuming them.
+    for (uint32_t block : mTouchedBlocks)
+    {
+        for (uint32_t i = block * kGradientBlockSize; i < std::min((block + 1) * kGradientBlockSize, mGradDim); i++)
+        {
+            float sum = 0.f;
+            for (uint32_t h = 0; h < mHashSize; h++)
+            {
+                float& value = mTmpGrads[size_t(h) * mGradDim + i];
+                sum += value;
+                value = 0.f;
+            }
+            mGrads[i] += sum;
+            mReducedEntryCount += mHashSize;
+        }
+    }
+}
+} // namespace Falcor
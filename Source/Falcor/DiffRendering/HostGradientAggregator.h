@@ -0,0 +1,93 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "SharedTypes.slang"
+
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Host-side reference of the gradient aggregation in SceneGradients.
+ *
+ * The data layout mirrors the GPU implementation: gradients are accumulated into hashSize slots per
+ * parameter (slot-major), and aggregate() reduces the slots into a dense gradient vector.
+ *
+ * In GradientAggregateMode::Sparse, accumulating a gradient also sets the bit of its parameter block
+ * (kGradientBlockSize parameters) in the touched block mask. Aggregation compacts the mask into a
+ * list of touched blocks and only reduces those, consuming the slots (resetting them to zero) and
+ * clearing the mask. Clearing thus only needs to reset the dense gradient vector.
+ */
+class FALCOR_API HostGradientAggregator
+{
+public:
+    HostGradientAggregator(uint32_t gradDim, uint32_t hashSize, GradientAggregateMode mode);
+
+    uint32_t getGradDim() const { return mGradDim; }
+    uint32_t getHashSize() const { return mHashSize; }
+    GradientAggregateMode getMode() const { return mMode; }
+
+    /// Reset all gradients.
+    void clear();
+
+    /// Accumulate a gradient of a parameter into a hash slot. Out-of-range parameters are ignored.
+    void atomicAddGrad(uint32_t gradIndex, uint32_t hashIndex, float value);
+
+    /**
+     * Reduce the accumulated gradients into the gradient vector.
+     * The reduced values are added to the gradient vector, which is reset by clear().
+     */
+    void aggregate();
+
+    const std::vector<float>& getGrads() const { return mGrads; }
+    const std::vector<float>& getTmpGrads() const { return mTmpGrads; }
+    const std::vector<uint32_t>& getTouchedBlockMask() const { return mTouchedBlockMask; }
+
+    /// Return the touched blocks reduced by the last aggregate() call (sparse mode only), in ascending order.
+    const std::vector<uint32_t>& getTouchedBlocks() const { return mTouchedBlocks; }
+
+    /// Return the number of hash slot entries read by the last aggregate() call.
+    uint64_t getReducedEntryCount() const { return mReducedEntryCount; }
+
+    static uint32_t getBlockCount(uint32_t gradDim) { return (gradDim + kGradientBlockSize - 1) / kGradientBlockSize; }
+    static uint32_t getBlockMaskSize(uint32_t gradDim) { return (getBlockCount(gradDim) + 31) / 32; }
+
+private:
+    uint32_t mGradDim;
+    uint32_t mHashSize;
+    GradientAggregateMode mMode;
+
+    std::vector<float> mTmpGrads;
+    std::vector<float> mGrads;
+    std::vector<uint32_t> mTouchedBlockMask;
+    std::vector<uint32_t> mTouchedBlocks;
+    uint64_t mReducedEntryCount = 0;
+};
+} // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SceneGradients.h"
+#include "Utils/Math/Common.h"
 
 namespace Falcor
 {
@@ -37,6 +38,11 @@ const char kGradsBufferName[] = "grads";
 const char kTmpGradsBufferName[] = "tmpGrads";
 
 const char kAggregateShaderFilename[] = "DiffRendering/AggregateGradients.cs.slang";
+
+uint32_t getBlockMaskSize(uint32_t gradDim)
+{
+    return div_round_up(div_round_up(gradDim, kGradientBlockSize), 32u);
+}
 } // namespace
 
 SceneGradients::SceneGradients(ref<Device> pDevice, const std::vector<GradConfig>& gradConfigs, GradientAggregateMode mode)
@@ -54,13 +60,31 @@ SceneGradients::SceneGradients(ref<Device> pDevice, const std::vector<GradConfig
     createParameterBlock();
 
     // Create a pass for aggregating gradients.
-    ProgramDesc desc;
-    if (mAggregateMode == GradientAggregateMode::Direct)
-        desc.addShaderLibrary(kAggregateShaderFilename).csEntry("mainDirect");
+    if (mAggregateMode == GradientAggregateMode::Sparse)
+    {
+        mpCompactSparsePass = ComputePass::create(mpDevice, kAggregateShaderFilename, "compactSparse");
+        mpReduceSparsePass = ComputePass::create(mpDevice, kAggregateShaderFilename, "reduceSparse");
+
+        // The sparse mode only resets the touched slots, so all slots need to start out cleared.
+        RenderContext* pRenderContext = mpDevice->getRenderContext();
+        for (size_t i = 0; i < size_t(GradientType::Count); i++)
+        {
+            if (!mGradInfos[i].active)
+                continue;
+            pRenderContext->clearUAV(mpTmpGrads[i]->getUAV().get(), uint4(0));
+            pRenderContext->clearUAV(mpTouchedBlockMask[i]->getUAV().get(), uint4(0));
+        }
+    }
     else
-        desc.addShaderLibrary(kAggregateShaderFilename).csEntry("mainHashGrid");
+    {
+        ProgramDesc desc;
+        if (mAggregateMode == GradientAggregateMode::Direct)
+            desc.addShaderLibrary(kAggregateShaderFilename).csEntry("mainDirect");
+        else
+            desc.addShaderLibrary(kAggregateShaderFilename).csEntry("mainHashGrid");
 
-    mpAggregatePass = ComputePass::create(mpDevice, desc);
+        mpAggregatePass = ComputePass::create(mpDevice, desc);
+    }
 }
 
 void SceneGradients::createParameterBlock()
@@ -83,6 +107,12 @@ void SceneGradients::createParameterBlock()
             mpTmpGrads[i] = mpDevice->createBuffer(
                 mGradInfos[i].dim * mGradInfos[i].hashSize * sizeof(float), bindFlags, MemoryType::DeviceLocal, nullptr
             );
+            if (mAggregateMode == GradientAggregateMode::Sparse)
+            {
+                uint32_t maskSize = getBlockMaskSize(mGradInfos[i].dim);
+                mpTouchedBlockMask[i] = mpDevice->createBuffer(maskSize * sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal, nullptr);
+                mpTouchedBlocks[i] = mpDevice->createBuffer(maskSize * 32 * sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal, nullptr);
+            }
         }
         else
         {
@@ -90,14 +120,23 @@ void SceneGradients::createParameterBlock()
         }
     }
 
+    if (mAggregateMode == GradientAggregateMode::Sparse)
+    {
+        mpSparseDispatchArgs = mpDevice->createBuffer(
+            4 * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess | ResourceBindFlags::IndirectArg, MemoryType::DeviceLocal, nullptr
+        );
+    }
+
     // Bind resources to parameter block.
     mpSceneGradientsBlock = ParameterBlock::create(mpDevice, pReflector);
     auto var = mpSceneGradientsBlock->getRootVar();
+    var["aggregateMode"] = (uint32_t)mAggregateMode;
     for (size_t i = 0; i < size_t(GradientType::Count); i++)
     {
         var["gradDim"][i] = mGradInfos[i].dim;
         var["hashSize"][i] = mGradInfos[i].hashSize;
         var[kTmpGradsBufferName][i] = mpTmpGrads[i];
+        var["touchedBlockMask"][i] = mpTouchedBlockMask[i];
     }
 }
 
@@ -106,7 +145,16 @@ void SceneGradients::clearGrads(RenderContext* pRenderContext, GradientType _gra
     uint32_t gradType = uint32_t(_gradType);
     if (!mGradInfos[gradType].active)
         return;
-    pRenderContext->clearUAV(mpTmpGrads[gradType]->getUAV().get(), uint4(0));
+
+    if (mAggregateMode == GradientAggregateMode::Sparse)
+    {
+        // Only reset the slots of touched blocks instead of clearing all dim * hashSize slots.
+        executeSparse(pRenderContext, gradType, false);
+    }
+    else
+    {
+        pRenderContext->clearUAV(mpTmpGrads[gradType]->getUAV().get(), uint4(0));
+    }
     pRenderContext->clearUAV(mpGrads[gradType]->getUAV().get(), uint4(0));
 }
 
@@ -116,6 +164,12 @@ void SceneGradients::aggregateGrads(RenderContext* pRenderContext, GradientType
     if (!mGradInfos[gradType].active)
         return;
 
+    if (mAggregateMode == GradientAggregateMode::Sparse)
+    {
+        executeSparse(pRenderContext, gradType, true);
+        return;
+    }
+
     uint32_t hashSize = (mAggregateMode == GradientAggregateMode::Direct ? 1 : mGradInfos[gradType].hashSize);
 
     // Bind resources.
@@ -129,6 +183,35 @@ void SceneGradients::aggregateGrads(RenderContext* pRenderContext, GradientType
     mpAggregatePass->execute(pRenderContext, uint3(mGradInfos[gradType].dim, hashSize, 1));
 }
 
+void SceneGradients::executeSparse(RenderContext* pRenderContext, uint32_t gradType, bool writeGrads)
+{
+    // Reset the dispatch arguments of the reduce pass and the touched block count.
+    static const uint32_t kInitialArgs[4] = {0, 1, 1, 0};
+    pRenderContext->updateBuffer(mpSparseDispatchArgs.get(), kInitialArgs, 0, sizeof(kInitialArgs));
+
+    uint32_t maskSize = getBlockMaskSize(mGradInfos[gradType].dim);
+    auto bindVars = [&](const ShaderVar& var)
+    {
+        var["gradDim"] = mGradInfos[gradType].dim;
+        var["hashSize"] = mGradInfos[gradType].hashSize;
+        var["maskSize"] = maskSize;
+        var["writeGrads"] = writeGrads;
+        var[kTmpGradsBufferName] = mpTmpGrads[gradType];
+        var[kGradsBufferName] = mpGrads[gradType];
+        var["touchedBlockMask"] = mpTouchedBlockMask[gradType];
+        var["touchedBlocks"] = mpTouchedBlocks[gradType];
+        var["dispatchArgs"] = mpSparseDispatchArgs;
+    };
+
+    // Compact the touched block mask into a list of blocks.
+    bindVars(mpCompactSparsePass->getRootVar()["gSparseAggregator"]);
+    mpCompactSparsePass->execute(pRenderContext, uint3(maskSize, 1, 1));
+
+    // Reduce and reset the slots of the touched blocks.
+    bindVars(mpReduceSparsePass->getRootVar()["gSparseAggregator"]);
+    mpReduceSparsePass->executeIndirect(pRenderContext, mpSparseDispatchArgs.get());
+}
+
 void SceneGradients::clearAllGrads(RenderContext* pRenderContext)
 {
     for (size_t i = 0; i < size_t(GradientType::Count); i++)
@@ -150,7 +233,7 @@ std::vector<GradientType> SceneGradients::getActiveGradTypes() const
     return activeGradTypes;
 }
 
-inline static ref<SceneGradients> createPython(ref<Device> device, const pybind11::list& gradConfigList)
+inline static ref<SceneGradients> createPython(ref<Device> device, const pybind11::list& gradConfigList, GradientAggregateMode aggregateMode)
 {
     std::vector<SceneGradients::GradConfig> gradConfigs;
     for (const auto& gradConfig : gradConfigList)
@@ -158,7 +241,7 @@ inline static ref<SceneGradients> createPython(ref<Device> device, const pybind1
         auto config = gradConfig.cast<SceneGradients::GradConfig>();
         gradConfigs.push_back(config);
     }
-    return SceneGradients::create(device, gradConfigs);
+    return SceneGradients::create(device, gradConfigs, aggregateMode);
 }
 
 inline void aggregate(SceneGradients& self, RenderContext* pRenderContext, GradientType gradType)
@@ -190,13 +273,16 @@ FALCOR_SCRIPT_BINDING(SceneGradients)
     using namespace pybind11::literals;
 
     pybind11::falcor_enum<GradientType>(m, "GradientType");
+    pybind11::falcor_enum<GradientAggregateMode>(m, "GradientAggregateMode");
 
     pybind11::class_<SceneGradients::GradConfig> gc(m, "GradConfig");
     gc.def(pybind11::init<>());
     gc.def(pybind11::init<GradientType, uint32_t, uint32_t>(), "grad_type"_a, "dim"_a, "hash_size"_a);
 
     pybind11::class_<SceneGradients, ref<SceneGradients>> sg(m, "SceneGradients");
-    sg.def_static("create", createPython, "device"_a, "grad_config_list"_a);
+    sg.def_static(
+        "create", createPython, "device"_a, "grad_config_list"_a, "aggregate_mode"_a = GradientAggregateMode::HashGrid
+    );
     sg.def("clear_grads", &SceneGradients::clearGrads, "render_context"_a, "grad_type"_a);
     sg.def("aggregate_grads", aggregate, "render_context"_a, "grad_type"_a);
     sg.def("clear_all_grads", &SceneGradients::clearAllGrads, "render_context"_a);
@@ -53,9 +53,13 @@ public:
         GradientAggregateMode mode = GradientAggregateMode::HashGrid
     );
 
-    static ref<SceneGradients> create(ref<Device> pDevice, const std::vector<GradConfig>& gradConfigs)
+    static ref<SceneGradients> create(
+        ref<Device> pDevice,
+        const std::vector<GradConfig>& gradConfigs,
+        GradientAggregateMode mode = GradientAggregateMode::HashGrid
+    )
     {
-        return make_ref<SceneGradients>(pDevice, gradConfigs, GradientAggregateMode::HashGrid);
+        return make_ref<SceneGradients>(pDevice, gradConfigs, mode);
     }
 
     ~SceneGradients() = default;
@@ -70,6 +74,7 @@ public:
 
     uint32_t getGradDim(GradientType gradType) const { return mGradInfos[size_t(gradType)].dim; }
     uint32_t getHashSize(GradientType gradType) const { return mGradInfos[size_t(gradType)].hashSize; }
+    GradientAggregateMode getAggregateMode() const { return mAggregateMode; }
 
     const ref<Buffer>& getTmpGradsBuffer(GradientType gradType) const { return mpTmpGrads[size_t(gradType)]; }
     const ref<Buffer>& getGradsBuffer(GradientType gradType) const { return mpGrads[size_t(gradType)]; }
@@ -85,6 +90,7 @@ private:
     };
 
     void createParameterBlock();
+    void executeSparse(RenderContext* pRenderContext, uint32_t gradType, bool writeGrads);
 
     ref<Device> mpDevice;
     std::array<GradInfo, size_t(GradientType::Count)> mGradInfos;
@@ -95,6 +101,13 @@ private:
     ref<Buffer> mpGrads[size_t(GradientType::Count)];
     ref<Buffer> mpTmpGrads[size_t(GradientType::Count)];
 
+    // Sparse aggregate mode.
+    ref<Buffer> mpTouchedBlockMask[size_t(GradientType::Count)];
+    ref<Buffer> mpTouchedBlocks[size_t(GradientType::Count)];
+    ref<Buffer> mpSparseDispatchArgs;
+
     ref<ComputePass> mpAggregatePass;
+    ref<ComputePass> mpCompactSparsePass;
+    ref<ComputePass> mpReduceSparsePass;
 };
 } // namespace Falcor
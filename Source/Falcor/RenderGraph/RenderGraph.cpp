@@ -56,6 +56,10 @@ ref<RenderGraph> RenderGraph::createFromFile(ref<Device> pDevice, const std::fil
 {
     using namespace pybind11::literals;
 
+    // JSON graphs are loaded without the Python interpreter.
+    if (path.extension() == ".json")
+        return RenderGraphImporter::importJson(pDevice, path);
+
     ref<RenderGraph> pGraph;
 
     // Setup a temporary scripting context that defines a local variable 'm' that
@@ -68,9 +68,9 @@ public:
     static ref<RenderGraph> create(ref<Device> pDevice, const std::string& name = "");
 
     /**
-     * Create a render graph from loading a python render graph script.
+     * Create a render graph from loading a python render graph script or a JSON render graph file (`.json` extension).
      * @param[in] pDevice GPU device.
-     * @param[in] path Path to the script (absolute or relative to working directory).
+     * @param[in] path Path to the script or JSON file (absolute or relative to working directory).
      * @return New object, or throws an exception if creation failed.
      */
     static ref<RenderGraph> createFromFile(ref<Device> pDevice, const std::filesystem::path& path);
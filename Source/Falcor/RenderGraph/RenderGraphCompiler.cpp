@@ -69,12 +69,13 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
 
-    for (auto e : c.mExecutionList)
+    for (const auto& e : c.mExecutionList)
     {
-        pExe->insertPass(e.name, e.pPass);
+        pExe->insertPass(e.name, e.pPass, e.reflector);
     }
     c.restoreCompilationChanges();
     pExe->mpResourceCache = std::move(pResourcesCache);
+    pExe->resolveResourceSlots();
     return pExe;
 }
 
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "RenderGraphExe.h"
 #include "Utils/Timing/Profiler.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -38,7 +39,9 @@ void RenderGraphExe::execute(const Context& ctx)
     {
         FALCOR_PROFILE(ctx.pRenderContext, pass.name);
 
-        RenderData renderData(pass.name, *mpResourceCache, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
+        RenderData renderData(
+            pass.name, *mpResourceCache, pass.fields, pass.resourceSlots, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat
+        );
         pass.pPass->execute(ctx.pRenderContext, renderData);
     }
 }
@@ -93,9 +96,31 @@ void RenderGraphExe::onHotReload(HotReloadFlags reloaded)
     }
 }
 
-void RenderGraphExe::insertPass(const std::string& name, const ref<RenderPass>& pPass)
+void RenderGraphExe::insertPass(const std::string& name, const ref<RenderPass>& pPass, const RenderPassReflection& reflector)
 {
-    mExecutionList.push_back(Pass(name, pPass));
+    Pass pass(name, pPass);
+    pass.fields.reserve(reflector.getFieldCount());
+    for (size_t i = 0; i < reflector.getFieldCount(); i++)
+    {
+        const auto& field = *reflector.getField(i);
+        pass.fields.emplace_back(field.getID(), name + '.' + field.getName());
+    }
+    mExecutionList.push_back(std::move(pass));
+}
+
+void RenderGraphExe::resolveResourceSlots()
+{
+    FALCOR_ASSERT(mpResourceCache);
+    for (auto& pass : mExecutionList)
+    {
+        uint32_t maxID = 0;
+        for (const auto& [id, fullName] : pass.fields)
+            maxID = std::max(maxID, id.get() + 1);
+
+        pass.resourceSlots.assign(maxID, ResourceCache::kInvalidSlot);
+        for (const auto& [id, fullName] : pass.fields)
+            pass.resourceSlots[id.get()] = mpResourceCache->getResourceSlot(fullName);
+    }
 }
 
 ref<Resource> RenderGraphExe::getResource(const std::string& name) const
@@ -107,5 +132,6 @@ ref<Resource> RenderGraphExe::getResource(const std::string& name) const
 void RenderGraphExe::setInput(const std::string& name, const ref<Resource>& pResource)
 {
     mpResourceCache->registerExternalResource(name, pResource);
+    resolveResourceSlots();
 }
 } // namespace Falcor
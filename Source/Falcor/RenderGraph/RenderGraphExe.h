@@ -36,6 +36,7 @@
 #include "Utils/Dictionary.h"
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -97,12 +98,22 @@ public:
 private:
     friend class RenderGraphCompiler;
 
-    void insertPass(const std::string& name, const ref<RenderPass>& pPass);
+    void insertPass(const std::string& name, const ref<RenderPass>& pPass, const RenderPassReflection& reflector);
+
+    /**
+     * Resolve the resource slots of all pass fields in the resource cache.
+     * Must be called whenever the set of resources in the cache changes.
+     */
+    void resolveResourceSlots();
 
     struct Pass
     {
         std::string name;
         ref<RenderPass> pPass;
+        /// Interned IDs and full names (PassName.FieldName) of the pass fields.
+        std::vector<std::pair<RenderPassReflection::ResourceID, std::string>> fields;
+        /// Resource cache slots indexed by field ID. Unused IDs are set to ResourceCache::kInvalidSlot.
+        std::vector<uint32_t> resourceSlots;
 
     private:
         friend class RenderGraphExe; // Force RenderGraphCompiler to use insertPass() by hiding this Ctor from it
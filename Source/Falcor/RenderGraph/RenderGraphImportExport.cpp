@@ -28,13 +28,57 @@
 #include "RenderGraphImportExport.h"
 #include "RenderGraphIR.h"
 #include "Core/AssetResolver.h"
+#include "Core/Plugin.h"
 #include "Utils/Scripting/Scripting.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <map>
+#include <set>
 
 namespace Falcor
 {
 namespace
 {
+using json = Properties::json;
+
+/// Current version of the JSON graph format.
+const uint32_t kJsonVersion = 1;
+
+const char kJsonChannels[] = "RGBA";
+
+std::string maskToString(TextureChannelFlags mask)
+{
+    std::string str;
+    for (uint32_t i = 0; i < 4; i++)
+        if (is_set(mask, TextureChannelFlags(1u << i)))
+            str += kJsonChannels[i];
+    return str;
+}
+
+bool maskFromString(std::string_view str, TextureChannelFlags& mask)
+{
+    mask = TextureChannelFlags::None;
+    for (char c : str)
+    {
+        const char* pChannel = std::strchr(kJsonChannels, c);
+        if (c == 0 || pChannel == nullptr)
+            return false;
+        TextureChannelFlags flag = TextureChannelFlags(1u << (pChannel - kJsonChannels));
+        if (is_set(mask, flag))
+            return false;
+        mask |= flag;
+    }
+    return mask != TextureChannelFlags::None;
+}
+
+/// Return the pass name of an edge or output name in the format `passName[.fieldName]`.
+std::string_view getPassName(std::string_view name)
+{
+    return name.substr(0, name.find('.'));
+}
+
 void updateGraphStrings(std::string& graph, std::filesystem::path& path, std::string& func)
 {
     graph = graph.empty() ? "renderGraph" : graph;
@@ -120,6 +164,234 @@ std::vector<ref<RenderGraph>> RenderGraphImporter::importAllGraphs(const std::fi
     }
 }
 
+ref<RenderGraph> RenderGraphImporter::importJson(ref<Device> pDevice, const std::filesystem::path& path)
+{
+    std::filesystem::path resolvedPath = AssetResolver::getDefaultResolver().resolvePath(path);
+    if (resolvedPath.empty())
+        FALCOR_THROW("Can't find the file '{}'", path);
+
+    try
+    {
+        return importJsonString(pDevice, readFile(resolvedPath));
+    }
+    catch (const std::exception& e)
+    {
+        FALCOR_THROW("Error when importing graph from file '{}'\n{}", path, e.what());
+    }
+}
+
+ref<RenderGraph> RenderGraphImporter::importJsonString(ref<Device> pDevice, std::string_view str)
+{
+    json j = json::parse(str, nullptr, false);
+    if (j.is_discarded())
+        FALCOR_THROW("Failed to parse render graph JSON.");
+
+    validateJson(j);
+
+    // Resolve all pass types before creating any pass.
+    PluginManager& pm = PluginManager::instance();
+    std::string err;
+    for (const auto& pass : j["passes"])
+    {
+        const std::string& type = pass["type"].get_ref<const std::string&>();
+        if (!pm.hasClass<RenderPass>(type))
+            pm.loadPluginByName(type);
+        if (!pm.hasClass<RenderPass>(type))
+            err += fmt::format("Pass '{}' has unknown type '{}'.\n", pass["name"].get<std::string>(), type);
+    }
+    if (!err.empty())
+        FALCOR_THROW(err);
+
+    // Create the passes, which validates their properties. Passes throw on properties of the wrong type and
+    // ignore unknown properties, so properties a pass doesn't report back are unknown to its type.
+    ref<RenderGraph> pGraph = RenderGraph::create(pDevice, j["name"].get<std::string>());
+    for (const auto& pass : j["passes"])
+    {
+        const std::string& name = pass["name"].get_ref<const std::string&>();
+        const std::string& type = pass["type"].get_ref<const std::string&>();
+        Properties props = pass.contains("properties") ? Properties(pass["properties"]) : Properties();
+        ref<RenderPass> pPass;
+        try
+        {
+            pPass = pGraph->createPass(name, type, props);
+        }
+        catch (const std::exception& e)
+        {
+            err += fmt::format("Pass '{}' of type '{}' failed to create: {}\n", name, type, e.what());
+            continue;
+        }
+        if (!pPass)
+        {
+            err += fmt::format("Pass '{}' of type '{}' failed to create.\n", name, type);
+            continue;
+        }
+        const Properties passProps = pPass->getProperties();
+        for (const auto& [key, value] : props)
+            if (!passProps.has(key))
+                err += fmt::format("Pass '{}' has property '{}', which is unknown to type '{}'.\n", name, key, type);
+    }
+    if (!err.empty())
+        FALCOR_THROW("Invalid render graph:\n{}", err);
+    if (j.contains("edges"))
+    {
+        for (const auto& edge : j["edges"])
+            pGraph->addEdge(edge["src"].get<std::string>(), edge["dst"].get<std::string>());
+    }
+    if (j.contains("outputs"))
+    {
+        for (const auto& output : j["outputs"])
+        {
+            TextureChannelFlags mask = TextureChannelFlags::RGB;
+            if (output.contains("mask"))
+                maskFromString(output["mask"].get_ref<const std::string&>(), mask);
+            pGraph->markOutput(output["name"].get<std::string>(), mask);
+        }
+    }
+
+    return pGraph;
+}
+
+void RenderGraphImporter::validateJson(const json& j)
+{
+    std::string err;
+    auto checkKeys = [&err](const json& obj, std::string_view context, std::initializer_list<const char*> required, std::initializer_list<const char*> optional)
+    {
+        for (auto key : required)
+            if (!obj.contains(key))
+                err += fmt::format("{} is missing '{}'.\n", context, key);
+        for (const auto& [key, value] : obj.items())
+        {
+            auto isKey = [&key = key](const char* name) { return key == name; };
+            if (std::none_of(required.begin(), required.end(), isKey) && std::none_of(optional.begin(), optional.end(), isKey))
+                err += fmt::format("{} has unknown key '{}'.\n", context, key);
+        }
+    };
+    auto isString = [](const json& obj, const char* key) { return obj.contains(key) && obj[key].is_string(); };
+
+    if (!j.is_object())
+        FALCOR_THROW("Render graph JSON must be an object.");
+
+    checkKeys(j, "Render graph", {"version", "name", "passes"}, {"$schema", "edges", "outputs"});
+    if (j.contains("version") && !(j["version"].is_number_unsigned() && j["version"].get<uint32_t>() == kJsonVersion))
+        err += fmt::format("Render graph has unsupported version {} (expected {}).\n", j["version"].dump(), kJsonVersion);
+    if (j.contains("name") && !j["name"].is_string())
+        err += "Render graph 'name' must be a string.\n";
+
+    // Passes.
+    std::set<std::string, std::less<>> passNames;
+    if (j.contains("passes"))
+    {
+        if (!j["passes"].is_array())
+            err += "Render graph 'passes' must be an array.\n";
+        else
+        {
+            for (size_t i = 0; i < j["passes"].size(); i++)
+            {
+                const json& pass = j["passes"][i];
+                std::string context = fmt::format("Pass {}", i);
+                if (!pass.is_object())
+                {
+                    err += context + " must be an object.\n";
+                    continue;
+                }
+                checkKeys(pass, context, {"name", "type"}, {"properties"});
+                if (isString(pass, "name"))
+                {
+                    const std::string& name = pass["name"].get_ref<const std::string&>();
+                    context = fmt::format("Pass '{}'", name);
+                    if (name.empty() || name.find('.') != std::string::npos)
+                        err += context + " has an invalid name. Names must be non-empty and must not contain '.'.\n";
+                    else if (!passNames.insert(name).second)
+                        err += context + " is defined more than once.\n";
+                }
+                else if (pass.contains("name"))
+                    err += context + " 'name' must be a string.\n";
+                if (pass.contains("type") && !(isString(pass, "type") && !pass["type"].get_ref<const std::string&>().empty()))
+                    err += context + " 'type' must be a non-empty string.\n";
+                if (pass.contains("properties") && !pass["properties"].is_object())
+                    err += context + " 'properties' must be an object.\n";
+            }
+        }
+    }
+
+    // Edges.
+    if (j.contains("edges"))
+    {
+        if (!j["edges"].is_array())
+            err += "Render graph 'edges' must be an array.\n";
+        else
+        {
+            for (size_t i = 0; i < j["edges"].size(); i++)
+            {
+                const json& edge = j["edges"][i];
+                std::string context = fmt::format("Edge {}", i);
+                if (!edge.is_object())
+                {
+                    err += context + " must be an object.\n";
+                    continue;
+                }
+                checkKeys(edge, context, {"src", "dst"}, {});
+                for (const char* key : {"src", "dst"})
+                {
+                    if (!isString(edge, key))
+                    {
+                        if (edge.contains(key))
+                            err += fmt::format("{} '{}' must be a string.\n", context, key);
+                        continue;
+                    }
+                    const std::string& name = edge[key].get_ref<const std::string&>();
+                    if (passNames.count(getPassName(name)) == 0)
+                        err += fmt::format("{} '{}' references unknown pass '{}'.\n", context, key, getPassName(name));
+                }
+                if (isString(edge, "src") && isString(edge, "dst"))
+                {
+                    bool srcIsField = edge["src"].get_ref<const std::string&>().find('.') != std::string::npos;
+                    bool dstIsField = edge["dst"].get_ref<const std::string&>().find('.') != std::string::npos;
+                    if (srcIsField != dstIsField)
+                        err += context + " must connect two fields or two passes.\n";
+                }
+            }
+        }
+    }
+
+    // Outputs.
+    if (j.contains("outputs"))
+    {
+        if (!j["outputs"].is_array())
+            err += "Render graph 'outputs' must be an array.\n";
+        else
+        {
+            for (size_t i = 0; i < j["outputs"].size(); i++)
+            {
+                const json& output = j["outputs"][i];
+                std::string context = fmt::format("Output {}", i);
+                if (!output.is_object())
+                {
+                    err += context + " must be an object.\n";
+                    continue;
+                }
+                checkKeys(output, context, {"name"}, {"mask"});
+                if (isString(output, "name"))
+                {
+                    const std::string& name = output["name"].get_ref<const std::string&>();
+                    if (name.find('.') == std::string::npos)
+                        err += fmt::format("{} '{}' must be in the format 'passName.fieldName'.\n", context, name);
+                    else if (passNames.count(getPassName(name)) == 0)
+                        err += fmt::format("{} references unknown pass '{}'.\n", context, getPassName(name));
+                }
+                else if (output.contains("name"))
+                    err += context + " 'name' must be a string.\n";
+                TextureChannelFlags mask;
+                if (output.contains("mask") && !(output["mask"].is_string() && maskFromString(output["mask"].get_ref<const std::string&>(), mask)))
+                    err += context + " 'mask' must be a string of distinct channels from 'RGBA'.\n";
+            }
+        }
+    }
+
+    if (!err.empty())
+        FALCOR_THROW("Invalid render graph:\n{}", err);
+}
+
 std::string RenderGraphExporter::getFuncName(const std::string& graphName)
 {
     return RenderGraphIR::getFuncName(graphName);
@@ -160,8 +432,73 @@ std::string RenderGraphExporter::getIR(const ref<RenderGraph>& pGraph)
     return ir.getIR();
 }
 
+std::string RenderGraphExporter::getJson(const ref<RenderGraph>& pGraph)
+{
+    json j = json::object();
+    j["version"] = kJsonVersion;
+    j["name"] = pGraph->getName();
+
+    // Add the passes, ordered by node index (creation order)
+    std::map<uint32_t, const RenderGraph::NodeData*> nodes;
+    for (const auto& [index, nodeData] : pGraph->mNodeData)
+        nodes[index] = &nodeData;
+
+    json passes = json::array();
+    for (const auto& [index, pNodeData] : nodes)
+    {
+        json pass = json::object();
+        pass["name"] = pNodeData->name;
+        pass["type"] = pNodeData->pPass->getType();
+        pass["properties"] = pNodeData->pPass->getProperties().toJson();
+        passes.push_back(std::move(pass));
+    }
+    j["passes"] = std::move(passes);
+
+    // Add the edges, ordered by edge index
+    std::map<uint32_t, const RenderGraph::EdgeData*> edges;
+    for (const auto& [index, edgeData] : pGraph->mEdgeData)
+        edges[index] = &edgeData;
+
+    json edgesJson = json::array();
+    for (const auto& [index, pEdgeData] : edges)
+    {
+        const auto& srcPass = pGraph->mNodeData[pGraph->mpGraph->getEdge(index)->getSourceNode()].name;
+        const auto& dstPass = pGraph->mNodeData[pGraph->mpGraph->getEdge(index)->getDestNode()].name;
+        json edge = json::object();
+        edge["src"] = srcPass + (pEdgeData->srcField.size() ? '.' + pEdgeData->srcField : pEdgeData->srcField);
+        edge["dst"] = dstPass + (pEdgeData->dstField.size() ? '.' + pEdgeData->dstField : pEdgeData->dstField);
+        edgesJson.push_back(std::move(edge));
+    }
+    j["edges"] = std::move(edgesJson);
+
+    // Graph outputs, one entry per mask
+    json outputs = json::array();
+    for (const auto& out : pGraph->mOutputs)
+    {
+        std::vector<TextureChannelFlags> masks(out.masks.begin(), out.masks.end());
+        std::sort(masks.begin(), masks.end());
+        for (auto mask : masks)
+        {
+            json output = json::object();
+            output["name"] = pGraph->mNodeData[out.nodeId].name + '.' + out.field;
+            output["mask"] = maskToString(mask);
+            outputs.push_back(std::move(output));
+        }
+    }
+    j["outputs"] = std::move(outputs);
+
+    return j.dump(4);
+}
+
 bool RenderGraphExporter::save(const ref<RenderGraph>& pGraph, std::filesystem::path path)
 {
+    if (path.extension() == ".json")
+    {
+        std::ofstream f(path);
+        f << getJson(pGraph) << std::endl;
+        return f.good();
+    }
+
     std::string ir = getIR(pGraph);
     std::string funcName;
     std::string graphName = pGraph->getName();
@@ -30,6 +30,7 @@
 #include "Core/Macros.h"
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Falcor
@@ -51,6 +52,31 @@ public:
      * Import all the graphs found in the script's global namespace
      */
     static std::vector<ref<RenderGraph>> importAllGraphs(const std::filesystem::path& path);
+
+    /**
+     * Import a graph from a JSON file. This doesn't use the Python interpreter.
+     * The graph description is validated and all pass types are resolved before any pass is created.
+     * Pass properties are validated when the passes are created: properties of the wrong type and
+     * properties the pass doesn't report back in getProperties() are errors.
+     * See docs/usage/render-graph-format.md for a description of the format.
+     * Throws an exception if the file can't be read or the graph is invalid.
+     * @param[in] pDevice GPU device.
+     * @param[in] path The JSON file path.
+     * @return A new render-graph object.
+     */
+    static ref<RenderGraph> importJson(ref<Device> pDevice, const std::filesystem::path& path);
+
+    /**
+     * Import a graph from a JSON string. See importJson().
+     */
+    static ref<RenderGraph> importJsonString(ref<Device> pDevice, std::string_view str);
+
+    /**
+     * Validate the structure of a JSON graph description without creating the graph.
+     * Pass properties are only checked to be objects, their keys and types are validated by importJson().
+     * Throws an exception listing all errors found if the description is invalid.
+     */
+    static void validateJson(const Properties::json& json);
 };
 
 class FALCOR_API RenderGraphExporter
@@ -58,6 +84,15 @@ class FALCOR_API RenderGraphExporter
 public:
     static std::string getIR(const ref<RenderGraph>& pGraph);
     static std::string getFuncName(const std::string& graphName);
+    /**
+     * Get the JSON description of a graph. See docs/usage/render-graph-format.md for a description of the format.
+     * Passes and edges are written in creation order to produce stable, diffable output.
+     */
+    static std::string getJson(const ref<RenderGraph>& pGraph);
+
+    /**
+     * Save a graph to a file. Files with a `.json` extension are saved in the JSON format, all others as Python scripts.
+     */
     static bool save(const ref<RenderGraph>& pGraph, std::filesystem::path path = {});
 };
 } // namespace Falcor
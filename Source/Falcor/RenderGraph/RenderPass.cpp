@@ -32,24 +32,61 @@ namespace Falcor
 RenderData::RenderData(
     const std::string& passName,
     ResourceCache& resources,
+    const std::vector<std::pair<ResourceID, std::string>>& fields,
+    const std::vector<uint32_t>& resourceSlots,
     Dictionary& dictionary,
     const uint2& defaultTexDims,
     ResourceFormat defaultTexFormat
 )
-    : mName(passName), mResources(resources), mDictionary(dictionary), mDefaultTexDims(defaultTexDims), mDefaultTexFormat(defaultTexFormat)
+    : mName(passName)
+    , mResources(resources)
+    , mFields(fields)
+    , mResourceSlots(resourceSlots)
+    , mDictionary(dictionary)
+    , mDefaultTexDims(defaultTexDims)
+    , mDefaultTexFormat(defaultTexFormat)
 {}
 
 const ref<Resource>& RenderData::getResource(const std::string_view name) const
 {
+    // Use the pre-resolved slots of the pass fields if possible. Passes have few fields, so a linear search is cheap
+    // and, unlike ResourceID::find(), doesn't hash the name or lock the interned name table.
+    const size_t prefixSize = mName.size() + 1;
+    for (const auto& [id, fullName] : mFields)
+    {
+        if (fullName.size() == prefixSize + name.size() && std::string_view(fullName).substr(prefixSize) == name)
+        {
+            if (id.get() < mResourceSlots.size() && mResourceSlots[id.get()] != ResourceCache::kInvalidSlot)
+                return mResources.getResource(mResourceSlots[id.get()]);
+            break;
+        }
+    }
     return mResources.getResource(fmt::format("{}.{}", mName, name));
 }
 
+const ref<Resource>& RenderData::getResource(const ResourceID& id) const
+{
+    static const ref<Resource> pNull;
+    if (!id.isValid())
+        return pNull;
+    if (id.get() < mResourceSlots.size() && mResourceSlots[id.get()] != ResourceCache::kInvalidSlot)
+        return mResources.getResource(mResourceSlots[id.get()]);
+    // Fall back to a lookup by name for resources that are not fields of the pass.
+    return mResources.getResource(fmt::format("{}.{}", mName, id.getName()));
+}
+
 ref<Texture> RenderData::getTexture(const std::string_view name) const
 {
     auto pResource = getResource(name);
     return pResource ? pResource->asTexture() : nullptr;
 }
 
+ref<Texture> RenderData::getTexture(const ResourceID& id) const
+{
+    auto pResource = getResource(id);
+    return pResource ? pResource->asTexture() : nullptr;
+}
+
 ref<RenderPass> RenderPass::create(std::string_view type, ref<Device> pDevice, const Properties& props, PluginManager& pm)
 {
     // Try to load a plugin of the same name, if render pass class is not registered yet.
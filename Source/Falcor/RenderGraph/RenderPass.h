@@ -42,6 +42,7 @@
 #include <memory>
 #include <string_view>
 #include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -51,6 +52,8 @@ namespace Falcor
 class FALCOR_API RenderData
 {
 public:
+    using ResourceID = RenderPassReflection::ResourceID;
+
     /**
      * Get a resource
      * @param[in] name The name of the pass' resource (i.e. "outputColor"). No need to specify the pass' name
@@ -58,6 +61,13 @@ public:
      */
     const ref<Resource>& operator[](const std::string_view name) const { return getResource(name); }
 
+    /**
+     * Get a resource by interned ID. This is an O(1) lookup into the pre-resolved resources of the pass.
+     * @param[in] id The ID of the pass' resource (i.e. ResourceID("outputColor")).
+     * @return If the resource exists, a pointer to the resource. Otherwise, nullptr
+     */
+    const ref<Resource>& operator[](const ResourceID& id) const { return getResource(id); }
+
     /**
      * Get a resource
      * @param[in] name The name of the pass' resource (i.e. "outputColor"). No need to specify the pass' name
@@ -65,6 +75,13 @@ public:
      */
     const ref<Resource>& getResource(const std::string_view name) const;
 
+    /**
+     * Get a resource by interned ID. This is an O(1) lookup into the pre-resolved resources of the pass.
+     * @param[in] id The ID of the pass' resource (i.e. ResourceID("outputColor")).
+     * @return If the resource exists, a pointer to the resource. Otherwise, nullptr
+     */
+    const ref<Resource>& getResource(const ResourceID& id) const;
+
     /**
      * Get a texture
      * @param[in] name The name of the pass' texture (i.e. "outputColor"). No need to specify the pass' name
@@ -72,6 +89,13 @@ public:
      */
     ref<Texture> getTexture(const std::string_view name) const;
 
+    /**
+     * Get a texture by interned ID.
+     * @param[in] id The ID of the pass' texture (i.e. ResourceID("outputColor")).
+     * @return If the texture exists, a pointer to the texture. Otherwise, nullptr
+     */
+    ref<Texture> getTexture(const ResourceID& id) const;
+
     /**
      * Get the global dictionary. You can use it to pass data between different passes
      */
@@ -91,6 +115,8 @@ protected:
     RenderData(
         const std::string& passName,
         ResourceCache& resources,
+        const std::vector<std::pair<ResourceID, std::string>>& fields,
+        const std::vector<uint32_t>& resourceSlots,
         Dictionary& dictionary,
         const uint2& defaultTexDims,
         ResourceFormat defaultTexFormat
@@ -98,6 +124,8 @@ protected:
 
     const std::string& mName;
     ResourceCache& mResources;
+    const std::vector<std::pair<ResourceID, std::string>>& mFields; ///< Interned IDs and full names (PassName.FieldName) of the pass fields.
+    const std::vector<uint32_t>& mResourceSlots;                     ///< Resource cache slots of the pass fields, indexed by ResourceID.
     Dictionary& mDictionary;
     uint2 mDefaultTexDims;
     ResourceFormat mDefaultTexFormat;
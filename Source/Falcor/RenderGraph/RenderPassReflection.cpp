@@ -28,12 +28,72 @@
 #include "RenderPassReflection.h"
 #include "Core/Error.h"
 #include "Utils/Logger.h"
+#include <deque>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace Falcor
 {
+namespace
+{
+/// Process-wide table of interned field names. Names are stored in a deque to keep references stable.
+struct ResourceNameTable
+{
+    std::shared_mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::deque<std::string> names;
+
+    static ResourceNameTable& get()
+    {
+        static ResourceNameTable table;
+        return table;
+    }
+};
+} // namespace
+
+RenderPassReflection::ResourceID::ResourceID(std::string_view name)
+{
+    if (*this = find(name); isValid())
+        return;
+
+    auto& table = ResourceNameTable::get();
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.ids.find(name);
+    if (it != table.ids.end())
+    {
+        mID = it->second;
+        return;
+    }
+    mID = (uint32_t)table.names.size();
+    const std::string& storedName = table.names.emplace_back(name);
+    table.ids.emplace(storedName, mID);
+}
+
+RenderPassReflection::ResourceID RenderPassReflection::ResourceID::find(std::string_view name)
+{
+    auto& table = ResourceNameTable::get();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    ResourceID id;
+    auto it = table.ids.find(name);
+    if (it != table.ids.end())
+        id.mID = it->second;
+    return id;
+}
+
+const std::string& RenderPassReflection::ResourceID::getName() const
+{
+    static const std::string kEmpty;
+    if (!isValid())
+        return kEmpty;
+    auto& table = ResourceNameTable::get();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    return table.names[mID];
+}
+
 RenderPassReflection::Field::Field(const std::string& name, const std::string& desc, Visibility v)
-    : mName(name), mDesc(desc), mVisibility(v)
+    : mName(name), mID(name), mDesc(desc), mVisibility(v)
 {}
 
 RenderPassReflection::Field& RenderPassReflection::Field::rawBuffer(uint32_t size)
@@ -165,6 +225,7 @@ RenderPassReflection::Field& RenderPassReflection::Field::visibility(Visibility
 RenderPassReflection::Field& RenderPassReflection::Field::name(const std::string& name)
 {
     mName = name;
+    mID = ResourceID(name);
     return *this;
 }
 RenderPassReflection::Field& RenderPassReflection::Field::desc(const std::string& desc)
@@ -32,6 +32,7 @@
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Falcor
@@ -39,6 +40,39 @@ namespace Falcor
 class FALCOR_API RenderPassReflection
 {
 public:
+    /**
+     * Interned name of a render pass resource field.
+     * Field names are interned into a process-wide table, so an ID is created from a string once and then identifies the
+     * field with a single integer. The render graph resolves the IDs of all fields of a pass when compiling the graph,
+     * which allows RenderData to look up resources by ID with an O(1) indexed access.
+     * IDs are typically created once as constants next to the field names, or taken from the fields in the reflection.
+     */
+    class FALCOR_API ResourceID
+    {
+    public:
+        static constexpr uint32_t kInvalidID = uint32_t(-1);
+
+        ResourceID() = default;
+
+        /// Create an ID for a field name, interning the name if needed.
+        explicit ResourceID(std::string_view name);
+
+        /// Look up the ID of a field name without interning it. Returns an invalid ID if the name was never interned.
+        static ResourceID find(std::string_view name);
+
+        bool isValid() const { return mID != kInvalidID; }
+        uint32_t get() const { return mID; }
+
+        /// Get the interned field name.
+        const std::string& getName() const;
+
+        bool operator==(const ResourceID& other) const { return mID == other.mID; }
+        bool operator!=(const ResourceID& other) const { return mID != other.mID; }
+
+    private:
+        uint32_t mID = kInvalidID;
+    };
+
     class FALCOR_API Field
     {
     public:
@@ -112,6 +146,7 @@ public:
         Field& desc(const std::string& desc);
 
         const std::string& getName() const { return mName; }
+        const ResourceID& getID() const { return mID; }
         const std::string& getDesc() const { return mDesc; }
         uint32_t getWidth() const { return mWidth; }
         uint32_t getHeight() const { return mHeight; }
@@ -140,6 +175,7 @@ public:
 
         Type mType = Type::Texture2D;
         std::string mName;    ///< The field's name.
+        ResourceID mID;       ///< The field's interned name.
         std::string mDesc;    ///< A description of the field.
         uint32_t mWidth = 0;  ///< For texture, the width in texels. For buffers, the size in bytes. 0 means don't care - the pass will use
                               ///< whatever is bound (the RenderGraph will use the window size by default).
@@ -165,7 +201,7 @@ public:
     Field& addInternal(const std::string& name, const std::string& desc);
 
     size_t getFieldCount() const { return mFields.size(); }
-    const Field* getField(size_t f) const { return f <= mFields.size() ? &mFields[f] : nullptr; }
+    const Field* getField(size_t f) const { return f < mFields.size() ? &mFields[f] : nullptr; }
     const Field* getField(const std::string& name) const;
     Field* getField(const std::string& name);
     Field& addField(const Field& field);
@@ -27,6 +27,8 @@
  **************************************************************************/
 #pragma once
 #include "Core/Macros.h"
+#include "Utils/Dictionary.h"
+#include "Utils/Math/Vector.h"
 #include <cstdint>
 
 namespace Falcor
@@ -58,5 +60,54 @@ static const char kRenderPassPRNGDimension[] = "_prngDimension";
  */
 static const char kRenderPassGBufferAdjustShadingNormals[] = "_gbufferAdjustShadingNormals";
 
+/**
+ * Time in seconds between the previous and the current frame, taken from the application clock.
+ * Passes animating over time (e.g. exposure adaptation) use it instead of wall-clock time,
+ * so that renders with a fixed time step are reproducible.
+ */
+static const char kRenderPassFrameTimeDelta[] = "_frameTimeDelta";
+
+/**
+ * Index of the next frame in the pseudorandom sequence of the renderer.
+ * Passes that own such a sequence (e.g. the path tracer) publish it after every frame. Other passes may
+ * set it to a different value to make the renderer continue from there, e.g. when resuming accumulation
+ * from a checkpoint. The renderer picks up the new value at its next frame.
+ */
+static const char kRenderPassSampleIndex[] = "_sampleIndex";
+
+/**
+ * Region of the frame to render, used for tiled and region-of-interest rendering.
+ * Passes that support it only update the pixels inside the tile, other passes render the whole frame.
+ * A tile with zero extent covers the whole frame.
+ */
+struct RenderTile
+{
+    uint2 offset = uint2(0); ///< Top-left pixel of the tile.
+    uint2 extent = uint2(0); ///< Size of the tile in pixels.
+
+    uint2 getEnd() const { return offset + extent; }
+    uint32_t getPixelCount() const { return extent.x * extent.y; }
+    bool isEmpty() const { return extent.x == 0 || extent.y == 0; }
+
+    bool operator==(const RenderTile& other) const { return all(offset == other.offset) && all(extent == other.extent); }
+    bool operator!=(const RenderTile& other) const { return !(*this == other); }
+};
+
+/**
+ * The tile to render is passed to RenderPass::execute() via a field with this name in the dictionary.
+ */
+static const char kRenderPassTile[] = "_renderTile";
+
 FALCOR_ENUM_CLASS_OPERATORS(RenderPassRefreshFlags);
+
+/**
+ * Typed dictionary keys for the standard fields above.
+ * These refer to the same dictionary values as the string names, but avoid the string lookup on every access.
+ */
+inline const Dictionary::Key<RenderPassRefreshFlags> kRenderPassRefreshFlagsKey{kRenderPassRefreshFlags};
+inline const Dictionary::Key<uint32_t> kRenderPassPRNGDimensionKey{kRenderPassPRNGDimension};
+inline const Dictionary::Key<bool> kRenderPassGBufferAdjustShadingNormalsKey{kRenderPassGBufferAdjustShadingNormals};
+inline const Dictionary::Key<float> kRenderPassFrameTimeDeltaKey{kRenderPassFrameTimeDelta};
+inline const Dictionary::Key<uint32_t> kRenderPassSampleIndexKey{kRenderPassSampleIndex};
+inline const Dictionary::Key<RenderTile> kRenderPassTileKey{kRenderPassTile};
 } // namespace Falcor
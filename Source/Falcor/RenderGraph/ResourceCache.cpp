@@ -42,18 +42,21 @@ void ResourceCache::reset()
 const ref<Resource>& ResourceCache::getResource(const std::string& name) const
 {
     static const ref<Resource> pNull;
-    auto extIt = mExternalResources.find(name);
-
-    // Search external resources if not found in render graph resources
-    if (extIt == mExternalResources.end())
-    {
-        const auto& it = mNameToIndex.find(name);
-        if (it == mNameToIndex.end())
-            return pNull;
-        return mResourceData[it->second].pResource;
-    }
+    uint32_t slot = getResourceSlot(name);
+    return slot != kInvalidSlot ? getResource(slot) : pNull;
+}
 
-    return extIt->second;
+uint32_t ResourceCache::getResourceSlot(const std::string& name) const
+{
+    // Search external resources first, then render graph resources
+    auto extIt = mExternalNameToIndex.find(name);
+    if (extIt != mExternalNameToIndex.end() && mExternalResources[extIt->second])
+        return extIt->second | kExternalSlotBit;
+
+    auto it = mNameToIndex.find(name);
+    if (it == mNameToIndex.end())
+        return kInvalidSlot;
+    return it->second;
 }
 
 const RenderPassReflection::Field& ResourceCache::getResourceReflection(const std::string& name) const
@@ -64,18 +67,29 @@ const RenderPassReflection::Field& ResourceCache::getResourceReflection(const st
 
 void ResourceCache::registerExternalResource(const std::string& name, const ref<Resource>& pResource)
 {
+    auto it = mExternalNameToIndex.find(name);
     if (pResource)
-        mExternalResources[name] = pResource;
+    {
+        if (it == mExternalNameToIndex.end())
+        {
+            FALCOR_CHECK(mExternalResources.size() < kExternalSlotBit, "Too many external resources.");
+            mExternalNameToIndex[name] = (uint32_t)mExternalResources.size();
+            mExternalResources.push_back(pResource);
+        }
+        else
+        {
+            mExternalResources[it->second] = pResource;
+        }
+    }
     else
     {
-        auto it = mExternalResources.find(name);
-        if (it == mExternalResources.end())
+        if (it == mExternalNameToIndex.end() || !mExternalResources[it->second])
         {
             logWarning("ResourceCache::registerExternalResource: '{}' does not exist.", name);
             return;
         }
 
-        mExternalResources.erase(it);
+        mExternalResources[it->second] = nullptr;
     }
 }
 
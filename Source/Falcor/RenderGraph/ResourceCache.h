@@ -28,6 +28,7 @@
 #pragma once
 #include "RenderPassReflection.h"
 #include "Core/Macros.h"
+#include "Core/Error.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
 #include <string>
@@ -42,6 +43,9 @@ class FALCOR_API ResourceCache
 public:
     using ResourcesMap = std::unordered_map<std::string, ref<Resource>>;
 
+    /// Slot value returned by getResourceSlot() for unknown resources.
+    static constexpr uint32_t kInvalidSlot = uint32_t(-1);
+
     /**
      * Properties to use during resource creation when its property has not been fully specified.
      */
@@ -78,6 +82,26 @@ public:
      */
     const ref<Resource>& getResource(const std::string& name) const;
 
+    /**
+     * Resolve a resource name to a slot, which allows repeated lookups without hashing the name.
+     * External resources take precedence over resources owned by the cache, same as in getResource().
+     * Slots remain valid until the cache is reset or an external resource is registered/unregistered.
+     * @param[in] name String in the format of PassName.FieldName
+     * @return The resource slot, or kInvalidSlot if the resource doesn't exist.
+     */
+    uint32_t getResourceSlot(const std::string& name) const;
+
+    /**
+     * Get a resource by slot previously returned by getResourceSlot().
+     */
+    const ref<Resource>& getResource(uint32_t slot) const
+    {
+        FALCOR_ASSERT(slot != kInvalidSlot);
+        if (slot & kExternalSlotBit)
+            return mExternalResources[slot & ~kExternalSlotBit];
+        return mResourceData[slot].pResource;
+    }
+
     /**
      * Get the field-reflection of a resource
      */
@@ -95,6 +119,8 @@ public:
     void reset();
 
 private:
+    static constexpr uint32_t kExternalSlotBit = 0x80000000u;
+
     struct ResourceData
     {
         RenderPassReflection::Field field;      // Holds merged properties for aliased resources
@@ -108,8 +134,10 @@ private:
     std::unordered_map<std::string, uint32_t> mNameToIndex;
     std::vector<ResourceData> mResourceData;
 
-    // References to output resources not to be allocated by the render graph
-    ResourcesMap mExternalResources;
+    // References to output resources not to be allocated by the render graph.
+    // Unregistered resources are set to nullptr to keep the indices stable.
+    std::unordered_map<std::string, uint32_t> mExternalNameToIndex;
+    std::vector<ref<Resource>> mExternalResources;
 };
 
 } // namespace Falcor
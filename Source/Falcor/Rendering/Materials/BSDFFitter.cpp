@@ -0,0 +1,681 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BSDFFitter.h"
+#include "Core/Error.h"
+#include "Scene/Material/MERLFile.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Math/MathConstants.slangh"
+
+#include <BS_thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+// Constants mirroring StandardBSDF.slang and IBSDF.slang.
+const double kMinCosTheta = 1e-6;
+const double kMinGGXAlpha = 0.0064;
+const double kDiffuseEnergyFactor = 1.0 / 1.51;
+
+// Constants mirroring MERLCommon.slang.
+const uint32_t kMERLResThetaH = 90;
+const uint32_t kMERLResThetaD = 90;
+const uint32_t kMERLResPhiD = 360;
+
+// Optimizer parameters. The Adam parameters match the BSDFOptimizer render pass.
+const double kAdamBeta1 = 0.9;
+const double kAdamBeta2 = 0.999;
+const double kAdamEpsilon = 1e-6;
+const size_t kLBFGSHistorySize = 8;
+const uint32_t kMaxLineSearchSteps = 40;
+const double kArmijoFactor = 1e-4;
+const double kInitialStepSize = 0.1;
+
+// Optimized parameters are stored as (baseColor.rgb, roughness, metallic).
+const size_t kParamCount = 5;
+const size_t kRoughnessIndex = 3;
+const size_t kMetallicIndex = 4;
+using ParamVector = std::array<double, kParamCount>;
+
+const ParamVector kLowerBounds = {0.0, 0.0, 0.0, BSDFFitter::kMinRoughness, 0.0};
+const ParamVector kUpperBounds = {1.0, 1.0, 1.0, 1.0, 1.0};
+
+/// Terms of a slice sample that don't depend on the material parameters.
+struct SampleGeometry
+{
+    bool valid = false;
+    double cosThetaI = 0.0;
+    double cosThetaO = 0.0;
+    double cosThetaH = 0.0;
+    double cosThetaD = 0.0;
+    double tanThetaSqrI = 0.0;
+    double tanThetaSqrO = 0.0;
+    double schlickI = 0.0; ///< (1 - cosThetaI)^5
+    double schlickO = 0.0; ///< (1 - cosThetaO)^5
+    double schlickD = 0.0; ///< (1 - cosThetaD)^5
+};
+
+/**
+ * Scalar lobe terms. Per color channel, the BRDF is f = diffuse * kd + F * ks, where
+ * diffuse is the diffuse albedo and F the Schlick Fresnel term.
+ */
+struct LobeTerms
+{
+    double kd = 0.0;  ///< Diffuse lobe without albedo.
+    double ks = 0.0;  ///< Specular lobe without Fresnel.
+    double dkd = 0.0; ///< Derivative of kd with respect to roughness.
+    double dks = 0.0; ///< Derivative of ks with respect to roughness.
+};
+
+double schlickWeight(double cosTheta)
+{
+    double m = std::max(1.0 - cosTheta, 0.0);
+    return m * m * m * m * m;
+}
+
+double tanThetaSqr(double cosTheta)
+{
+    double cosThetaSqr = cosTheta * cosTheta;
+    return std::max(1.0 - cosThetaSqr, 0.0) / cosThetaSqr;
+}
+
+SampleGeometry computeGeometry(const float3& wi, const float3& wo)
+{
+    SampleGeometry g;
+    if (std::min(wi.z, wo.z) < kMinCosTheta)
+        return g;
+
+    float3 h = normalize(wi + wo);
+    g.valid = true;
+    g.cosThetaI = wi.z;
+    g.cosThetaO = wo.z;
+    g.cosThetaH = h.z;
+    g.cosThetaD = dot(wi, h);
+    g.tanThetaSqrI = tanThetaSqr(g.cosThetaI);
+    g.tanThetaSqrO = tanThetaSqr(g.cosThetaO);
+    g.schlickI = schlickWeight(g.cosThetaI);
+    g.schlickO = schlickWeight(g.cosThetaO);
+    g.schlickD = schlickWeight(g.cosThetaD);
+    return g;
+}
+
+LobeTerms evalLobes(const SampleGeometry& g, double roughness)
+{
+    LobeTerms t;
+
+    // Frostbite diffuse, see FrostbiteDiffuseBRDF.slang.
+    double fd90 = 0.5 * roughness + 2.0 * g.cosThetaD * g.cosThetaD * roughness;
+    double dfd90 = 0.5 + 2.0 * g.cosThetaD * g.cosThetaD;
+    double scatterI = 1.0 + (fd90 - 1.0) * g.schlickI;
+    double scatterO = 1.0 + (fd90 - 1.0) * g.schlickO;
+    double energyFactor = 1.0 + (kDiffuseEnergyFactor - 1.0) * roughness;
+    t.kd = scatterI * scatterO * energyFactor * M_1_PI;
+    t.dkd = (dfd90 * g.schlickI * scatterO * energyFactor + scatterI * dfd90 * g.schlickO * energyFactor +
+             scatterI * scatterO * (kDiffuseEnergyFactor - 1.0)) *
+            M_1_PI;
+
+    // GGX with height-correlated Smith masking, see SpecularMicrofacet.slang and IsotropicGGX.slang.
+    // The specular lobe is a delta lobe below the minimum alpha, which evaluates to zero.
+    double alpha = roughness * roughness;
+    if (alpha < kMinGGXAlpha)
+        return t;
+
+    double alphaSqr = alpha * alpha;
+    double cosThetaHSqr = g.cosThetaH * g.cosThetaH;
+    double d = cosThetaHSqr * (alphaSqr - 1.0) + 1.0;
+    double D = alphaSqr / (d * d * M_PI);
+    double dD = (1.0 - 2.0 * alphaSqr * cosThetaHSqr / d) / (d * d * M_PI);
+
+    double rootI = std::sqrt(1.0 + alphaSqr * g.tanThetaSqrI);
+    double rootO = std::sqrt(1.0 + alphaSqr * g.tanThetaSqrO);
+    double lambdaI = 0.5 * (rootI - 1.0);
+    double lambdaO = 0.5 * (rootO - 1.0);
+    double G = 1.0 / (1.0 + lambdaI + lambdaO);
+    double dG = -G * G * 0.25 * (g.tanThetaSqrI / rootI + g.tanThetaSqrO / rootO);
+
+    // Derivatives above are with respect to alpha^2 = roughness^4.
+    double norm = 0.25 / (g.cosThetaI * g.cosThetaO);
+    t.ks = D * G * norm;
+    t.dks = (dD * G + D * dG) * norm * 4.0 * alpha * roughness;
+    return t;
+}
+
+double getDielectricF0(double ior)
+{
+    double f = (ior - 1.0) / (ior + 1.0);
+    return f * f;
+}
+
+/// Fitting problem for a single target. All data is shared read-only between worker threads.
+struct Problem
+{
+    const std::vector<SampleGeometry>* pGeometry;
+    const std::vector<float3>* pValues;
+    double f0;
+
+    /**
+     * Evaluate the loss and optionally its gradient.
+     * The gradient is computed analytically using the lobe decomposition f = diffuse * kd + F * ks.
+     */
+    double eval(const ParamVector& x, ParamVector* pGrad) const
+    {
+        const auto& geometry = *pGeometry;
+        const auto& values = *pValues;
+        const double roughness = x[kRoughnessIndex];
+        const double metallic = x[kMetallicIndex];
+
+        double loss = 0.0;
+        ParamVector grad = {};
+
+        for (size_t i = 0; i < geometry.size(); i++)
+        {
+            const SampleGeometry& g = geometry[i];
+            const LobeTerms t = g.valid ? evalLobes(g, roughness) : LobeTerms();
+
+            for (size_t c = 0; c < 3; c++)
+            {
+                double baseColor = x[c];
+                double F0 = f0 * (1.0 - metallic) + baseColor * metallic;
+                double F = F0 + (1.0 - F0) * g.schlickD;
+                double f = baseColor * (1.0 - metallic) * t.kd + F * t.ks;
+                double r = f - values[i][c];
+                loss += 0.5 * r * r;
+
+                if (pGrad)
+                {
+                    grad[c] += r * ((1.0 - metallic) * t.kd + metallic * (1.0 - g.schlickD) * t.ks);
+                    grad[kRoughnessIndex] += r * (baseColor * (1.0 - metallic) * t.dkd + F * t.dks);
+                    grad[kMetallicIndex] += r * (-baseColor * t.kd + (baseColor - f0) * (1.0 - g.schlickD) * t.ks);
+                }
+            }
+        }
+
+        const double scale = 1.0 / (3.0 * geometry.size());
+        if (pGrad)
+        {
+            for (size_t j = 0; j < kParamCount; j++)
+                (*pGrad)[j] = grad[j] * scale;
+        }
+        return loss * scale;
+    }
+};
+
+struct StartResult
+{
+    ParamVector x = {};
+    double loss = std::numeric_limits<double>::infinity();
+    uint32_t iterations = 0;
+};
+
+ParamVector clampParams(ParamVector x)
+{
+    for (size_t j = 0; j < kParamCount; j++)
+        x[j] = std::clamp(x[j], kLowerBounds[j], kUpperBounds[j]);
+    return x;
+}
+
+double dot(const ParamVector& a, const ParamVector& b)
+{
+    double sum = 0.0;
+    for (size_t j = 0; j < kParamCount; j++)
+        sum += a[j] * b[j];
+    return sum;
+}
+
+/// Returns true if a parameter is at a bound and the gradient points outside the valid range.
+bool isActive(const ParamVector& x, const ParamVector& grad, size_t j)
+{
+    return (x[j] <= kLowerBounds[j] && grad[j] > 0.0) || (x[j] >= kUpperBounds[j] && grad[j] < 0.0);
+}
+
+StartResult runAdam(const Problem& problem, ParamVector x, const BSDFFitter::Options& options)
+{
+    ParamVector m = {};
+    ParamVector v = {};
+    ParamVector grad;
+
+    // Adam is not monotonic, so keep track of the best parameters seen.
+    StartResult result;
+    for (uint32_t i = 0; i < options.maxIterations; i++)
+    {
+        double loss = problem.eval(x, &grad);
+        if (loss < result.loss)
+        {
+            result.x = x;
+            result.loss = loss;
+            result.iterations = i;
+        }
+
+        double beta1Correction = 1.0 - std::pow(kAdamBeta1, i + 1);
+        double beta2Correction = 1.0 - std::pow(kAdamBeta2, i + 1);
+        for (size_t j = 0; j < kParamCount; j++)
+        {
+            m[j] = kAdamBeta1 * m[j] + (1.0 - kAdamBeta1) * grad[j];
+            v[j] = kAdamBeta2 * v[j] + (1.0 - kAdamBeta2) * grad[j] * grad[j];
+            double mHat = m[j] / beta1Correction;
+            double vHat = v[j] / beta2Correction;
+            x[j] -= options.learningRate * mHat / (std::sqrt(vHat) + kAdamEpsilon);
+        }
+        x = clampParams(x);
+    }
+
+    double loss = problem.eval(x, nullptr);
+    if (loss < result.loss)
+    {
+        result.x = x;
+        result.loss = loss;
+        result.iterations = options.maxIterations;
+    }
+    return result;
+}
+
+StartResult runLBFGS(const Problem& problem, ParamVector x, const BSDFFitter::Options& options)
+{
+    struct Correction
+    {
+        ParamVector s;
+        ParamVector y;
+        double rho;
+    };
+    std::deque<Correction> history;
+
+    ParamVector grad;
+    double loss = problem.eval(x, &grad);
+
+    StartResult result;
+    for (uint32_t i = 0; i < options.maxIterations; i++)
+    {
+        // Project the gradient onto the free parameters.
+        ParamVector projGrad = grad;
+        for (size_t j = 0; j < kParamCount; j++)
+            if (isActive(x, grad, j))
+                projGrad[j] = 0.0;
+        if (dot(projGrad, projGrad) == 0.0)
+            break;
+
+        // Two-loop recursion computing the search direction -H * projGrad.
+        ParamVector dir = projGrad;
+        std::array<double, kLBFGSHistorySize> alphas;
+        for (size_t k = history.size(); k-- > 0;)
+        {
+            alphas[k] = history[k].rho * dot(history[k].s, dir);
+            for (size_t j = 0; j < kParamCount; j++)
+                dir[j] -= alphas[k] * history[k].y[j];
+        }
+        if (!history.empty())
+        {
+            const auto& last = history.back();
+            double gamma = dot(last.s, last.y) / dot(last.y, last.y);
+            for (size_t j = 0; j < kParamCount; j++)
+                dir[j] *= gamma;
+        }
+        for (size_t k = 0; k < history.size(); k++)
+        {
+            double beta = history[k].rho * dot(history[k].y, dir);
+            for (size_t j = 0; j < kParamCount; j++)
+                dir[j] += history[k].s[j] * (alphas[k] - beta);
+        }
+        for (size_t j = 0; j < kParamCount; j++)
+            dir[j] = projGrad[j] == 0.0 ? 0.0 : -dir[j];
+
+        // Fall back to steepest descent if the quasi-Newton direction is not a descent direction.
+        if (history.empty() || dot(dir, grad) >= 0.0)
+        {
+            history.clear();
+            double maxGrad = 0.0;
+            for (size_t j = 0; j < kParamCount; j++)
+                maxGrad = std::max(maxGrad, std::abs(projGrad[j]));
+            for (size_t j = 0; j < kParamCount; j++)
+                dir[j] = -projGrad[j] * kInitialStepSize / maxGrad;
+        }
+
+        // Backtracking line search along the projected path.
+        double step = 1.0;
+        bool accepted = false;
+        ParamVector nextX;
+        ParamVector nextGrad;
+        double nextLoss = 0.0;
+        for (uint32_t k = 0; k < kMaxLineSearchSteps && !accepted; k++, step *= 0.5)
+        {
+            for (size_t j = 0; j < kParamCount; j++)
+                nextX[j] = x[j] + step * dir[j];
+            nextX = clampParams(nextX);
+
+            ParamVector delta;
+            for (size_t j = 0; j < kParamCount; j++)
+                delta[j] = nextX[j] - x[j];
+            double decrease = dot(grad, delta);
+            if (decrease >= 0.0)
+                continue;
+
+            nextLoss = problem.eval(nextX, &nextGrad);
+            accepted = nextLoss <= loss + kArmijoFactor * decrease;
+        }
+
+        if (!accepted)
+        {
+            // Retry once with steepest descent before giving up.
+            if (history.empty())
+                break;
+            history.clear();
+            continue;
+        }
+
+        Correction correction;
+        for (size_t j = 0; j < kParamCount; j++)
+        {
+            correction.s[j] = nextX[j] - x[j];
+            correction.y[j] = nextGrad[j] - grad[j];
+        }
+        double sy = dot(correction.s, correction.y);
+        if (sy > std::numeric_limits<double>::epsilon() * dot(correction.y, correction.y))
+        {
+            correction.rho = 1.0 / sy;
+            if (history.size() == kLBFGSHistorySize)
+                history.pop_front();
+            history.push_back(correction);
+        }
+
+        double improvement = loss - nextLoss;
+        x = nextX;
+        grad = nextGrad;
+        loss = nextLoss;
+        result.iterations = i + 1;
+
+        if (improvement <= options.tolerance * loss)
+            break;
+    }
+
+    result.x = x;
+    result.loss = loss;
+    return result;
+}
+
+/**
+ * Returns the start point for a given start index.
+ * Roughness is stratified over the start points since it is the main source of local minima.
+ * The other parameters are drawn randomly.
+ */
+ParamVector getStartPoint(uint32_t startIndex, uint32_t startCount, uint32_t seed)
+{
+    std::seed_seq seedSeq = {seed, startIndex};
+    std::mt19937 rng(seedSeq);
+    std::uniform_real_distribution<double> dist;
+
+    ParamVector x;
+    for (size_t c = 0; c < 3; c++)
+        x[c] = dist(rng);
+    double u = (startIndex + dist(rng)) / startCount;
+    x[kRoughnessIndex] = kLowerBounds[kRoughnessIndex] + u * (kUpperBounds[kRoughnessIndex] - kLowerBounds[kRoughnessIndex]);
+    x[kMetallicIndex] = dist(rng);
+    return x;
+}
+
+float2 getSliceCoord(uint32_t i, uint32_t j, uint32_t res)
+{
+    return float2((i + 0.5f) / res, (j + 0.5f) / res);
+}
+
+BSDFFitter::Params toParams(const ParamVector& x)
+{
+    BSDFFitter::Params params;
+    params.baseColor = float3(float(x[0]), float(x[1]), float(x[2]));
+    params.roughness = float(x[kRoughnessIndex]);
+    params.metallic = float(x[kMetallicIndex]);
+    return params;
+}
+
+ParamVector toParamVector(const BSDFFitter::Params& params)
+{
+    return {params.baseColor.x, params.baseColor.y, params.baseColor.z, params.roughness, params.metallic};
+}
+} // namespace
+
+BSDFFitter::BSDFFitter() : BSDFFitter(Options()) {}
+
+BSDFFitter::BSDFFitter(const Options& options) : mOptions(options)
+{
+    FALCOR_CHECK(mOptions.sliceResolution > 0, "'sliceResolution' must be larger than zero.");
+    FALCOR_CHECK(mOptions.startCount > 0, "'startCount' must be larger than zero.");
+    FALCOR_CHECK(mOptions.ior >= 1.f, "'ior' must be at least one.");
+}
+
+float3 BSDFFitter::evalBRDF(const Params& params, const float3& wi, const float3& wo, float ior)
+{
+    SampleGeometry g = computeGeometry(wi, wo);
+    if (!g.valid)
+        return float3(0.f);
+
+    // Note that parameters are not clamped to the fitted range, so low roughness evaluates the specular lobe as a delta lobe.
+    LobeTerms t = evalLobes(g, params.roughness);
+    double f0 = getDielectricF0(ior);
+    double metallic = params.metallic;
+
+    float3 result;
+    for (int c = 0; c < 3; c++)
+    {
+        double baseColor = params.baseColor[c];
+        double F0 = f0 * (1.0 - metallic) + baseColor * metallic;
+        double F = F0 + (1.0 - F0) * g.schlickD;
+        result[c] = float(baseColor * (1.0 - metallic) * t.kd + F * t.ks);
+    }
+    return result;
+}
+
+void BSDFFitter::getSliceDirections(float2 uv, float3& wi, float3& wo)
+{
+    float thetaH = uv.x * float(M_PI_2);
+    float thetaD = (1.f - uv.y) * float(M_PI_2);
+    float cosH = std::cos(thetaH);
+    float sinH = std::sin(thetaH);
+    float cosD = std::cos(thetaD);
+    float sinD = std::sin(thetaD);
+
+    // Directions mirrored about the yz-plane around h = (0,0,1), rotated about the x-axis by theta_h.
+    wo = normalize(float3(sinD, -sinH * cosD, cosH * cosD));
+    wi = float3(-sinD, -sinH * cosD, cosH * cosD);
+}
+
+BSDFFitter::Target BSDFFitter::createTarget(const Params& params, const std::string& name) const
+{
+    const uint32_t res = mOptions.sliceResolution;
+
+    Target target;
+    target.name = name;
+    target.values.resize(res * res);
+    for (uint32_t j = 0; j < res; j++)
+    {
+        for (uint32_t i = 0; i < res; i++)
+        {
+            float3 wi, wo;
+            getSliceDirections(getSliceCoord(i, j, res), wi, wo);
+            target.values[j * res + i] = evalBRDF(params, wi, wo, mOptions.ior);
+        }
+    }
+    return target;
+}
+
+BSDFFitter::Target BSDFFitter::createTarget(const MERLFile& merlFile) const
+{
+    const auto& data = merlFile.getData();
+    FALCOR_CHECK(
+        data.size() == kMERLResThetaH * kMERLResThetaD * kMERLResPhiD / 2, "MERL BRDF '{}' has unexpected size.", merlFile.getDesc().name
+    );
+
+    const uint32_t res = mOptions.sliceResolution;
+
+    // Look up the samples at phi_d = 90 deg, using the same (non-interpolated) mapping as MERLCommon.slang.
+    const uint32_t phiDIndex = kMERLResPhiD / 4;
+
+    Target target;
+    target.name = merlFile.getDesc().name;
+    target.values.resize(res * res);
+    for (uint32_t j = 0; j < res; j++)
+    {
+        for (uint32_t i = 0; i < res; i++)
+        {
+            float2 uv = getSliceCoord(i, j, res);
+            float thetaH = uv.x * float(M_PI_2);
+            float thetaD = (1.f - uv.y) * float(M_PI_2);
+            uint32_t thetaHIndex = std::min(uint32_t(std::sqrt(thetaH * float(M_2_PI)) * kMERLResThetaH), kMERLResThetaH - 1);
+            uint32_t thetaDIndex = std::min(uint32_t(thetaD * float(M_2_PI) * kMERLResThetaD), kMERLResThetaD - 1);
+            size_t index = (size_t(thetaDIndex) + size_t(thetaHIndex) * kMERLResThetaD) * (kMERLResPhiD / 2) + phiDIndex;
+            target.values[j * res + i] = data[index];
+        }
+    }
+    return target;
+}
+
+float BSDFFitter::evalLoss(const Target& target, const Params& params) const
+{
+    const uint32_t res = mOptions.sliceResolution;
+    FALCOR_CHECK(target.values.size() == res * res, "Target '{}' doesn't match the slice resolution.", target.name);
+
+    std::vector<SampleGeometry> geometry(res * res);
+    for (uint32_t j = 0; j < res; j++)
+    {
+        for (uint32_t i = 0; i < res; i++)
+        {
+            float3 wi, wo;
+            getSliceDirections(getSliceCoord(i, j, res), wi, wo);
+            geometry[j * res + i] = computeGeometry(wi, wo);
+        }
+    }
+
+    Problem problem = {&geometry, &target.values, getDielectricF0(mOptions.ior)};
+    return float(problem.eval(toParamVector(params), nullptr));
+}
+
+BSDFFitter::Result BSDFFitter::fit(const Target& target) const
+{
+    return fit(std::vector<Target>{target}).front();
+}
+
+std::vector<BSDFFitter::Result> BSDFFitter::fit(const std::vector<Target>& targets) const
+{
+    const uint32_t res = mOptions.sliceResolution;
+    const uint32_t startCount = mOptions.startCount;
+    for (const auto& target : targets)
+        FALCOR_CHECK(target.values.size() == res * res, "Target '{}' doesn't match the slice resolution.", target.name);
+
+    // The slice geometry is the same for all targets.
+    std::vector<SampleGeometry> geometry(res * res);
+    for (uint32_t j = 0; j < res; j++)
+    {
+        for (uint32_t i = 0; i < res; i++)
+        {
+            float3 wi, wo;
+            getSliceDirections(getSliceCoord(i, j, res), wi, wo);
+            geometry[j * res + i] = computeGeometry(wi, wo);
+        }
+    }
+
+    std::vector<ParamVector> startPoints(startCount);
+    for (uint32_t s = 0; s < startCount; s++)
+        startPoints[s] = getStartPoint(s, startCount, mOptions.seed);
+
+    // Fit all (target, start) pairs in parallel. The workers don't throw, all inputs are validated above.
+    std::vector<StartResult> startResults(targets.size() * startCount);
+    const double f0 = getDielectricF0(mOptions.ior);
+    {
+        BS::thread_pool threadPool(mOptions.threadCount);
+        for (size_t t = 0; t < targets.size(); t++)
+        {
+            for (uint32_t s = 0; s < startCount; s++)
+            {
+                threadPool.push_task(
+                    [&, t, s]
+                    {
+                        Problem problem = {&geometry, &targets[t].values, f0};
+                        startResults[t * startCount + s] = mOptions.optimizer == Optimizer::Adam
+                                                               ? runAdam(problem, startPoints[s], mOptions)
+                                                               : runLBFGS(problem, startPoints[s], mOptions);
+                    }
+                );
+            }
+        }
+        threadPool.wait_for_tasks();
+    }
+
+    // Keep the best start of each target.
+    std::vector<Result> results(targets.size());
+    for (size_t t = 0; t < targets.size(); t++)
+    {
+        uint32_t best = 0;
+        for (uint32_t s = 1; s < startCount; s++)
+            if (startResults[t * startCount + s].loss < startResults[t * startCount + best].loss)
+                best = s;
+
+        const StartResult& startResult = startResults[t * startCount + best];
+        Result& result = results[t];
+        result.name = targets[t].name;
+        result.params = toParams(startResult.x);
+        result.loss = float(startResult.loss);
+        result.startIndex = best;
+        result.iterations = startResult.iterations;
+    }
+    return results;
+}
+
+DiffuseSpecularData BSDFFitter::toDiffuseSpecularData(const Result& result) const
+{
+    // DiffuseSpecularBRDF computes the dielectric specular reflectance as 0.08 * specular.
+    DiffuseSpecularData data = {};
+    data.baseColor = result.params.baseColor;
+    data.roughness = result.params.roughness;
+    data.metallic = result.params.metallic;
+    data.specular = float(getDielectricF0(mOptions.ior) / 0.08);
+    data.lossValue = result.loss;
+    return data;
+}
+
+void BSDFFitter::exportMaterial(const Result& result, StandardMaterial& material) const
+{
+    FALCOR_CHECK(material.getShadingModel() == ShadingModel::MetalRough, "Material '{}' must use the MetalRough shading model.", material.getName());
+    material.setBaseColor3(result.params.baseColor);
+    material.setRoughness(result.params.roughness);
+    material.setMetallic(result.params.metallic);
+    material.setIndexOfRefraction(mOptions.ior);
+}
+
+ref<StandardMaterial> BSDFFitter::createMaterial(ref<Device> pDevice, const Result& result) const
+{
+    ref<StandardMaterial> pMaterial = StandardMaterial::create(pDevice, result.name, ShadingModel::MetalRough);
+    pMaterial->setBaseColor(float4(result.params.baseColor, 1.f));
+    exportMaterial(result, *pMaterial);
+    return pMaterial;
+}
+
+} // namespace Falcor
@@ -0,0 +1,159 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Utils/Math/Vector.h"
+#include "Scene/Material/DiffuseSpecularData.slang"
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+class Device;
+class MERLFile;
+class StandardMaterial;
+
+/**
+ * Host-side fitting of standard material parameters to a target BRDF.
+ *
+ * The fitted model is the opaque metal/rough standard material. Its BRDF is evaluated analytically
+ * on the CPU, mirroring StandardBSDF with the default configuration (Frostbite diffuse, GGX with
+ * height-correlated Smith masking, Schlick Fresnel).
+ *
+ * Targets are sampled on a 2D slice over (theta_h, theta_d) with phi_d = 90 deg, the same slice
+ * used by the BSDFOptimizer render pass [Burley 2012]. The loss is the mean of 0.5 * (f - fRef)^2
+ * over all slice samples and color channels, where f is the BRDF without the cosine term.
+ *
+ * Each target is fitted from several start points and the start with the lowest loss is kept.
+ * Roughness is stratified over the start points, the other parameters are drawn randomly from
+ * a generator seeded by the options, so fits are deterministic. All (target, start) pairs are
+ * distributed over a thread pool, which allows fitting entire material libraries in parallel.
+ */
+class FALCOR_API BSDFFitter
+{
+public:
+    enum class Optimizer
+    {
+        Adam,  ///< Adam with a fixed learning rate, parameters are clamped to their valid range after each step.
+        LBFGS, ///< L-BFGS with a projected backtracking line search.
+    };
+
+    /// Lowest fitted roughness. Below this, StandardBSDF switches to a delta lobe, which can't be fitted with gradients.
+    static constexpr float kMinRoughness = 0.08f;
+
+    /// Parameters of the fitted material model.
+    struct Params
+    {
+        float3 baseColor = float3(0.5f); ///< Base color in linear space.
+        float roughness = 0.5f;          ///< Linear perceptual roughness.
+        float metallic = 0.f;            ///< Metallic.
+    };
+
+    struct Options
+    {
+        Optimizer optimizer = Optimizer::LBFGS;
+        uint32_t sliceResolution = 32; ///< Number of slice samples along theta_h and theta_d.
+        uint32_t startCount = 8;       ///< Number of start points per target.
+        uint32_t maxIterations = 200;  ///< Maximum number of iterations per start.
+        float tolerance = 1e-9f;       ///< Stop when the relative loss improvement drops below this value (L-BFGS only).
+        float learningRate = 1e-2f;    ///< Learning rate (Adam only).
+        float ior = 1.5f;              ///< Index of refraction determining the specular reflectance of dielectrics.
+        uint32_t seed = 0;             ///< Seed for the start points.
+        uint32_t threadCount = 0;      ///< Number of worker threads (0 uses the hardware concurrency).
+    };
+
+    /// Target BRDF sampled on the slice.
+    struct Target
+    {
+        std::string name;
+        std::vector<float3> values; ///< BRDF values without the cosine term, stored as values[j * res + i] for theta_d row j and theta_h column i.
+    };
+
+    struct Result
+    {
+        std::string name;        ///< Name of the fitted target.
+        Params params;           ///< Best fit parameters.
+        float loss = 0.f;        ///< Loss of the best fit.
+        uint32_t startIndex = 0; ///< Index of the start point that produced the best fit.
+        uint32_t iterations = 0; ///< Number of iterations of the best start.
+    };
+
+    BSDFFitter();
+    BSDFFitter(const Options& options);
+
+    const Options& getOptions() const { return mOptions; }
+
+    /**
+     * Evaluate the BRDF of the fitted model.
+     * @param[in] params Material parameters.
+     * @param[in] wi Incident direction in the local frame.
+     * @param[in] wo Outgoing direction in the local frame.
+     * @param[in] ior Index of refraction.
+     * @return f(wi, wo), without the cosine term.
+     */
+    static float3 evalBRDF(const Params& params, const float3& wi, const float3& wo, float ior = 1.5f);
+
+    /**
+     * Compute the directions of a slice sample.
+     * This matches calculateSliceGeometry() of the BSDFOptimizer render pass.
+     * @param[in] uv Slice coordinate, x maps to theta_h in [0, pi/2] and y maps to theta_d in [pi/2, 0].
+     * @param[out] wi Incident (view) direction in the local frame.
+     * @param[out] wo Outgoing (light) direction in the local frame.
+     */
+    static void getSliceDirections(float2 uv, float3& wi, float3& wo);
+
+    /// Create a synthetic target from known material parameters.
+    Target createTarget(const Params& params, const std::string& name = "") const;
+
+    /// Create a target from a measured MERL BRDF.
+    Target createTarget(const MERLFile& merlFile) const;
+
+    /// Evaluate the loss of a set of parameters for a target.
+    float evalLoss(const Target& target, const Params& params) const;
+
+    /// Fit a single target. The start points are fitted in parallel.
+    Result fit(const Target& target) const;
+
+    /// Fit a list of targets in parallel. Results are returned in the order of the targets.
+    std::vector<Result> fit(const std::vector<Target>& targets) const;
+
+    /// Convert a fit to the best fit data stored alongside measured materials.
+    DiffuseSpecularData toDiffuseSpecularData(const Result& result) const;
+
+    /// Write a fit to an existing standard material using the metal/rough shading model.
+    void exportMaterial(const Result& result, StandardMaterial& material) const;
+
+    /// Create a standard material from a fit. The material is named after the fitted target.
+    ref<StandardMaterial> createMaterial(ref<Device> pDevice, const Result& result) const;
+
+private:
+    Options mOptions;
+};
+
+} // namespace Falcor
@@ -0,0 +1,286 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AccumulationCheckpoint.h"
+#include "Core/Error.h"
+#include "Core/API/RenderContext.h"
+#include "Core/API/Texture.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/StringFormatters.h"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const char kMagic[8] = {'F', 'A', 'L', 'C', 'C', 'K', 'P', 'T'};
+const uint32_t kVersion = 1;
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t bufferCount;
+    uint64_t metadataSize;
+};
+
+struct BufferHeader
+{
+    uint32_t nameSize;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint64_t dataSize;
+};
+
+/// Writes to a file stream while hashing the written data.
+class HashingWriter
+{
+public:
+    HashingWriter(std::ofstream& fs) : mStream(fs) {}
+
+    void write(const void* data, size_t size)
+    {
+        mStream.write(reinterpret_cast<const char*>(data), size);
+        mHash.update(data, size);
+    }
+
+    SHA1::MD finalize() { return mHash.finalize(); }
+
+private:
+    std::ofstream& mStream;
+    SHA1 mHash;
+};
+
+/// Reads from a file stream while hashing the read data.
+class HashingReader
+{
+public:
+    HashingReader(std::ifstream& fs, const std::filesystem::path& path) : mStream(fs), mPath(path) {}
+
+    void read(void* data, size_t size)
+    {
+        mStream.read(reinterpret_cast<char*>(data), size);
+        if (!mStream)
+            FALCOR_THROW("Checkpoint file '{}' is truncated.", mPath);
+        mHash.update(data, size);
+    }
+
+    SHA1::MD finalize() { return mHash.finalize(); }
+
+private:
+    std::ifstream& mStream;
+    const std::filesystem::path& mPath;
+    SHA1 mHash;
+};
+
+uint64_t getExpectedDataSize(ResourceFormat format, uint32_t width, uint32_t height)
+{
+    return (uint64_t)width * height * getFormatBytesPerBlock(format);
+}
+} // namespace
+
+void AccumulationCheckpoint::captureTexture(RenderContext* pRenderContext, const std::string& name, const Texture* pTexture)
+{
+    FALCOR_CHECK(pRenderContext && pTexture, "Invalid arguments.");
+    FALCOR_CHECK(!isCompressedFormat(pTexture->getFormat()), "Compressed formats are not supported.");
+
+    Buffer buffer;
+    buffer.format = pTexture->getFormat();
+    buffer.width = pTexture->getWidth();
+    buffer.height = pTexture->getHeight();
+    buffer.data = pRenderContext->readTextureSubresource(pTexture, 0);
+    FALCOR_CHECK(
+        buffer.data.size() == getExpectedDataSize(buffer.format, buffer.width, buffer.height),
+        "Unexpected texture data size when capturing '{}'.",
+        name
+    );
+    buffers[name] = std::move(buffer);
+}
+
+void AccumulationCheckpoint::restoreTexture(RenderContext* pRenderContext, const std::string& name, Texture* pTexture) const
+{
+    FALCOR_CHECK(pRenderContext && pTexture, "Invalid arguments.");
+
+    auto it = buffers.find(name);
+    if (it == buffers.end())
+        FALCOR_THROW("Checkpoint doesn't contain buffer '{}'.", name);
+    const Buffer& buffer = it->second;
+    if (buffer.format != pTexture->getFormat() || buffer.width != pTexture->getWidth() || buffer.height != pTexture->getHeight())
+    {
+        FALCOR_THROW(
+            "Checkpoint buffer '{}' ({}x{} {}) doesn't match the texture ({}x{} {}).",
+            name,
+            buffer.width,
+            buffer.height,
+            to_string(buffer.format),
+            pTexture->getWidth(),
+            pTexture->getHeight(),
+            to_string(pTexture->getFormat())
+        );
+    }
+    pRenderContext->updateSubresourceData(pTexture, 0, buffer.data.data());
+}
+
+void AccumulationCheckpoint::write(const std::filesystem::path& path) const
+{
+    nlohmann::ordered_json json;
+    json["frameCount"] = frameCount;
+    json["metadata"] = metadata.toJson();
+    const std::string metadataStr = json.dump();
+
+    // Write to a uniquely named temporary file next to the checkpoint.
+    std::random_device rd;
+    auto tempPath = path;
+    tempPath += fmt::format(".{:08x}{:08x}.tmp", rd(), rd());
+    try
+    {
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path());
+
+        std::ofstream fs(tempPath, std::ios_base::binary);
+        if (!fs)
+            FALCOR_THROW("Failed to create checkpoint file '{}'.", tempPath);
+
+        HashingWriter writer(fs);
+
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.bufferCount = (uint32_t)buffers.size();
+        header.metadataSize = metadataStr.size();
+        writer.write(&header, sizeof(header));
+        writer.write(metadataStr.data(), metadataStr.size());
+
+        for (const auto& [name, buffer] : buffers)
+        {
+            BufferHeader bufferHeader;
+            bufferHeader.nameSize = (uint32_t)name.size();
+            bufferHeader.format = (uint32_t)buffer.format;
+            bufferHeader.width = buffer.width;
+            bufferHeader.height = buffer.height;
+            bufferHeader.dataSize = buffer.data.size();
+            writer.write(&bufferHeader, sizeof(bufferHeader));
+            writer.write(name.data(), name.size());
+            writer.write(buffer.data.data(), buffer.data.size());
+        }
+
+        const SHA1::MD digest = writer.finalize();
+        fs.write(reinterpret_cast<const char*>(digest.data()), digest.size());
+        fs.close();
+        if (fs.fail())
+            FALCOR_THROW("Failed to write checkpoint file '{}'.", tempPath);
+    }
+    catch (...)
+    {
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        throw;
+    }
+
+    // Atomically replace the previous checkpoint.
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        FALCOR_THROW("Failed to move checkpoint file to '{}'.", path);
+    }
+}
+
+AccumulationCheckpoint AccumulationCheckpoint::read(const std::filesystem::path& path)
+{
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs)
+        FALCOR_THROW("Failed to open checkpoint file '{}'.", path);
+
+    HashingReader reader(fs, path);
+
+    Header header;
+    reader.read(&header, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        FALCOR_THROW("File '{}' is not a checkpoint file.", path);
+    if (header.version != kVersion)
+        FALCOR_THROW("Checkpoint file '{}' has unsupported version {} (expected {}).", path, header.version, kVersion);
+
+    const uint64_t fileSize = std::filesystem::file_size(path);
+    auto checkSize = [&](uint64_t size)
+    {
+        if (size > fileSize)
+            FALCOR_THROW("Checkpoint file '{}' is corrupt.", path);
+    };
+
+    AccumulationCheckpoint checkpoint;
+
+    checkSize(header.metadataSize);
+    std::string metadataStr(header.metadataSize, '\0');
+    reader.read(metadataStr.data(), metadataStr.size());
+
+    for (uint32_t i = 0; i < header.bufferCount; ++i)
+    {
+        BufferHeader bufferHeader;
+        reader.read(&bufferHeader, sizeof(bufferHeader));
+        checkSize(bufferHeader.nameSize);
+        checkSize(bufferHeader.dataSize);
+
+        std::string name(bufferHeader.nameSize, '\0');
+        reader.read(name.data(), name.size());
+
+        Buffer buffer;
+        buffer.format = (ResourceFormat)bufferHeader.format;
+        buffer.width = bufferHeader.width;
+        buffer.height = bufferHeader.height;
+        if (bufferHeader.format >= (uint32_t)ResourceFormat::Count ||
+            bufferHeader.dataSize != getExpectedDataSize(buffer.format, buffer.width, buffer.height))
+            FALCOR_THROW("Checkpoint file '{}' is corrupt.", path);
+        buffer.data.resize(bufferHeader.dataSize);
+        reader.read(buffer.data.data(), buffer.data.size());
+        checkpoint.buffers[name] = std::move(buffer);
+    }
+
+    SHA1::MD expected;
+    fs.read(reinterpret_cast<char*>(expected.data()), expected.size());
+    if (!fs || reader.finalize() != expected)
+        FALCOR_THROW("Checkpoint file '{}' failed checksum verification.", path);
+
+    // Parse the metadata only after the checksum has been verified.
+    const auto json = nlohmann::ordered_json::parse(metadataStr, nullptr, false);
+    if (json.is_discarded() || !json.contains("frameCount") || !json.contains("metadata"))
+        FALCOR_THROW("Checkpoint file '{}' has invalid metadata.", path);
+    checkpoint.frameCount = json["frameCount"].get<uint32_t>();
+    checkpoint.metadata = Properties(json["metadata"]);
+
+    return checkpoint;
+}
+
+} // namespace Falcor
@@ -0,0 +1,113 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include "Utils/Properties.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+class RenderContext;
+class Texture;
+
+/**
+ * Snapshot of the state of a progressive accumulation.
+ *
+ * A checkpoint holds the raw contents of the accumulation buffers (running sums, compensation
+ * terms, etc.) together with the number of accumulated frames and arbitrary metadata. Buffers
+ * are stored bit-exact, so resuming from a checkpoint continues the accumulation with results
+ * that are identical to an uninterrupted run, given the same input frames.
+ *
+ * The metadata is intended for state outside of the accumulation itself that is needed for an
+ * exact resume, such as the frame index or random seed of the renderer producing the frames.
+ *
+ * Checkpoint files are written to a temporary file first and atomically moved into place, so a
+ * crash while writing never destroys the previous checkpoint. A checksum of the contents is
+ * verified when reading.
+ */
+class FALCOR_API AccumulationCheckpoint
+{
+public:
+    struct Buffer
+    {
+        ResourceFormat format = ResourceFormat::Unknown;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> data; ///< Tightly packed texel data.
+    };
+
+    /// Number of accumulated frames.
+    uint32_t frameCount = 0;
+    /// Arbitrary metadata.
+    Properties metadata;
+    /// Accumulation buffers by name.
+    std::map<std::string, Buffer> buffers;
+
+    /**
+     * Read back the contents of a texture (mip 0, array slice 0) into a named buffer.
+     * This waits for the GPU to finish all pending work.
+     * @param pRenderContext Render context.
+     * @param name Buffer name.
+     * @param pTexture Texture to read.
+     */
+    void captureTexture(RenderContext* pRenderContext, const std::string& name, const Texture* pTexture);
+
+    /**
+     * Upload the contents of a named buffer to a texture.
+     * Throws if the buffer doesn't exist or doesn't match the texture dimensions and format.
+     * @param pRenderContext Render context.
+     * @param name Buffer name.
+     * @param pTexture Texture to write.
+     */
+    void restoreTexture(RenderContext* pRenderContext, const std::string& name, Texture* pTexture) const;
+
+    bool hasBuffer(const std::string& name) const { return buffers.find(name) != buffers.end(); }
+
+    /**
+     * Write the checkpoint to a file. The file is replaced atomically.
+     * Throws if writing fails.
+     * @param path File path.
+     */
+    void write(const std::filesystem::path& path) const;
+
+    /**
+     * Read a checkpoint from a file.
+     * Throws if the file cannot be read, is not a checkpoint file or fails checksum verification.
+     * @param path File path.
+     * @return The checkpoint.
+     */
+    static AccumulationCheckpoint read(const std::filesystem::path& path);
+};
+
+} // namespace Falcor
@@ -0,0 +1,345 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AdaptiveSampling.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Timing/Profiler.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFilename[] = "Rendering/Utils/AdaptiveSampling.cs.slang";
+
+        /** CPU version of jenkinsHash() in Utils/Math/HashUtils.slang.
+        */
+        uint32_t jenkinsHash(uint32_t a)
+        {
+            a = (a + 0x7ed55d16) + (a << 12);
+            a = (a ^ 0xc761c23c) ^ (a >> 19);
+            a = (a + 0x165667b1) + (a << 5);
+            a = (a + 0xd3a2646c) ^ (a << 9);
+            a = (a + 0xfd7046c5) + (a << 3);
+            a = (a ^ 0xb55a4f09) ^ (a >> 16);
+            return a;
+        }
+
+        pybind11::dict toPython(const AdaptiveSampling::Stats& stats)
+        {
+            pybind11::dict d;
+            d["frameCount"] = stats.frameCount;
+            d["convergedFraction"] = stats.convergedFraction;
+            d["avgRelativeError"] = stats.avgRelativeError;
+            d["avgSamplesPerPixel"] = stats.avgSamplesPerPixel;
+            return d;
+        }
+    }
+
+    AdaptiveSampling::AdaptiveSampling(ref<Device> pDevice)
+        : mpDevice(pDevice)
+    {
+    }
+
+    void AdaptiveSampling::setEnabled(bool enabled)
+    {
+        if (enabled == mEnabled) return;
+        mEnabled = enabled;
+        reset();
+
+        // Release resources when disabled.
+        if (!mEnabled)
+        {
+            mpMoments = nullptr;
+            mpDemand = nullptr;
+            mpSampleCount = nullptr;
+        }
+    }
+
+    void AdaptiveSampling::setParams(const AdaptiveSamplingParams& params)
+    {
+        FALCOR_CHECK(params.maxSamplesPerPixel >= 1 && params.maxSamplesPerPixel <= 255, "'maxSamplesPerPixel' must be in the range [1, 255].");
+        FALCOR_CHECK(params.sampleBudget > 0.f, "'sampleBudget' must be positive.");
+        FALCOR_CHECK(params.targetRelativeError > 0.f, "'targetRelativeError' must be positive.");
+        FALCOR_CHECK(params.relativeErrorEpsilon >= 0.f, "'relativeErrorEpsilon' must be non-negative.");
+
+        uint2 frameDim = mParams.frameDim;
+        mParams = params;
+        mParams.frameDim = frameDim;
+        reset();
+    }
+
+    void AdaptiveSampling::reset()
+    {
+        mParams.frameCount = 0;
+        mResetPending = true;
+        mStatsValid = false;
+    }
+
+    void AdaptiveSampling::beginFrame(RenderContext* pRenderContext, const uint2& frameDim)
+    {
+        if (!mEnabled) return;
+
+        if (!mpMoments || any(frameDim != mParams.frameDim))
+        {
+            mParams.frameDim = frameDim;
+            mpMoments = mpDevice->createTexture2D(frameDim.x, frameDim.y, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+            mpDemand = mpDevice->createTexture2D(frameDim.x, frameDim.y, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+            mpSampleCount = mpDevice->createTexture2D(frameDim.x, frameDim.y, ResourceFormat::R8Uint, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+            reset();
+        }
+
+        if (mResetPending)
+        {
+            mParams.frameCount = 0;
+            pRenderContext->clearUAV(mpMoments->getUAV().get(), float4(0.f));
+            pRenderContext->clearUAV(mpSampleCount->getUAV().get(), uint4(getUniformSampleCount(mParams)));
+            mResetPending = false;
+        }
+    }
+
+    void AdaptiveSampling::endFrame(RenderContext* pRenderContext, const ref<Texture>& pColor)
+    {
+        if (!mEnabled) return;
+
+        FALCOR_PROFILE(pRenderContext, "AdaptiveSampling");
+        FALCOR_ASSERT(mpMoments && !mResetPending);
+        FALCOR_CHECK(pColor && pColor->getWidth() == mParams.frameDim.x && pColor->getHeight() == mParams.frameDim.y, "Color texture doesn't match the frame dimension.");
+
+        if (!mpUpdatePass)
+        {
+            mpUpdatePass = ComputePass::create(mpDevice, ProgramDesc().addShaderLibrary(kShaderFilename).csEntry("updateMoments"));
+            mpAllocatePass = ComputePass::create(mpDevice, ProgramDesc().addShaderLibrary(kShaderFilename).csEntry("allocateSamples"));
+            mpParallelReduction = std::make_unique<ParallelReduction>(mpDevice);
+            mpTotals = mpDevice->createBuffer(sizeof(float4), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal);
+            mpReductionResult = mpDevice->createBuffer(sizeof(float4) + sizeof(uint4), ResourceBindFlags::None, MemoryType::ReadBack);
+            mpFence = mpDevice->createFence();
+        }
+
+        // Make sure the previous readback has completed before overwriting the results.
+        copyStatsToCPU();
+
+        // The frame count includes the current frame.
+        mParams.frameCount++;
+
+        // Update moments and compute the per-pixel demand.
+        {
+            auto var = mpUpdatePass->getRootVar();
+            var["CB"]["gParams"].setBlob(mParams);
+            var["gColor"] = pColor;
+            var["gSampleCount"] = mpSampleCount;
+            var["gMoments"] = mpMoments;
+            var["gDemand"] = mpDemand;
+            mpUpdatePass->execute(pRenderContext, mParams.frameDim.x, mParams.frameDim.y);
+        }
+
+        // Sum the demand over all pixels.
+        mpParallelReduction->execute<float4>(pRenderContext, mpDemand, ParallelReduction::Type::Sum, nullptr, mpTotals, 0);
+        pRenderContext->copyBufferRegion(mpReductionResult.get(), 0, mpTotals.get(), 0, sizeof(float4));
+
+        // Write the sample count map for the next frame.
+        {
+            auto var = mpAllocatePass->getRootVar();
+            var["CB"]["gParams"].setBlob(mParams);
+            var["gDemand"] = mpDemand;
+            var["gTotals"] = mpTotals;
+            var["gOutputSampleCount"] = mpSampleCount;
+            mpAllocatePass->execute(pRenderContext, mParams.frameDim.x, mParams.frameDim.y);
+        }
+
+        // Sum the allocated samples for the stats.
+        mpParallelReduction->execute<uint4>(pRenderContext, mpSampleCount, ParallelReduction::Type::Sum, nullptr, mpReductionResult, sizeof(float4));
+
+        pRenderContext->submit(false);
+        pRenderContext->signal(mpFence.get());
+        mWaitingForData = true;
+    }
+
+    bool AdaptiveSampling::getStats(Stats& stats)
+    {
+        copyStatsToCPU();
+        if (!mStatsValid) return false;
+        stats = mStats;
+        return true;
+    }
+
+    void AdaptiveSampling::renderUI(Gui::Widgets& widget)
+    {
+        AdaptiveSamplingParams params = mParams;
+        bool dirty = false;
+        dirty |= widget.var("Sample budget", params.sampleBudget, 0.1f, 255.f, 0.1f);
+        widget.tooltip("Average number of samples per pixel.");
+        dirty |= widget.var("Max samples/pixel", params.maxSamplesPerPixel, 1u, 255u);
+        dirty |= widget.var("Target relative error", params.targetRelativeError, 1e-4f, 1.f, 1e-3f);
+        dirty |= widget.var("Relative error epsilon", params.relativeErrorEpsilon, 0.f, 1.f, 1e-3f);
+        dirty |= widget.var("Warmup frames", params.minFrameCount, 2u, 1024u);
+        widget.tooltip("Number of frames rendered with uniform sampling before adapting.");
+        if (dirty) setParams(params);
+
+        if (widget.button("Reset")) reset();
+
+        Stats stats;
+        if (getStats(stats))
+        {
+            widget.text(fmt::format(
+                "Frames: {}\nConverged: {:.1f}%\nRelative error (avg): {:.4f}\nSamples/pixel (avg): {:.3f}",
+                stats.frameCount, 100.f * stats.convergedFraction, stats.avgRelativeError, stats.avgSamplesPerPixel
+            ));
+        }
+    }
+
+    void AdaptiveSampling::copyStatsToCPU()
+    {
+        if (mWaitingForData)
+        {
+            mpFence->wait();
+            mWaitingForData = false;
+
+            // The buffer holds the demand totals (float4) followed by the allocated sample totals (uint4).
+            const uint8_t* pResult = static_cast<const uint8_t*>(mpReductionResult->map());
+            FALCOR_ASSERT(pResult);
+            float4 totals;
+            uint4 sampleTotals;
+            std::memcpy(&totals, pResult, sizeof(float4));
+            std::memcpy(&sampleTotals, pResult + sizeof(float4), sizeof(uint4));
+            mpReductionResult->unmap();
+
+            const float pixelCount = (float)mParams.frameDim.x * mParams.frameDim.y;
+            mStats.frameCount = mParams.frameCount;
+            mStats.convergedFraction = pixelCount > 0.f ? 1.f - totals.y / pixelCount : 0.f;
+            mStats.avgRelativeError = totals.w > 0.f ? totals.z / totals.w : 0.f;
+            mStats.avgSamplesPerPixel = pixelCount > 0.f ? sampleTotals.x / pixelCount : 0.f;
+            mStatsValid = true;
+        }
+    }
+
+    float AdaptiveSampling::computeRelativeError(const float4& moments, float epsilon)
+    {
+        if (moments.w < 2.f || moments.z <= 0.f) return kUnknownError;
+        float mean = moments.x / moments.z;
+        float variance = std::max(moments.y - moments.x * mean, 0.f) / (moments.w - 1.f);
+        return std::sqrt(variance / moments.z) / (std::abs(mean) + epsilon);
+    }
+
+    float AdaptiveSampling::computeDemand(const AdaptiveSamplingParams& params, const float4& moments)
+    {
+        const float maxDemand = (float)(params.maxSamplesPerPixel - 1);
+        float relativeError = computeRelativeError(moments, params.relativeErrorEpsilon);
+        if (moments.w < (float)params.minFrameCount || relativeError >= kUnknownError) return maxDemand;
+        if (relativeError <= params.targetRelativeError) return 0.f;
+        float ratio = relativeError / params.targetRelativeError;
+        return std::min(maxDemand, moments.z * (ratio * ratio - 1.f));
+    }
+
+    uint32_t AdaptiveSampling::getUniformSampleCount(const AdaptiveSamplingParams& params)
+    {
+        return std::clamp((uint32_t)(params.sampleBudget + 0.5f), 1u, params.maxSamplesPerPixel);
+    }
+
+    AdaptiveSampling::Stats AdaptiveSampling::updateReference(const AdaptiveSamplingParams& params, const std::vector<float4>& color, std::vector<float4>& moments, std::vector<uint8_t>& sampleCount)
+    {
+        const size_t pixelCount = (size_t)params.frameDim.x * params.frameDim.y;
+        FALCOR_CHECK(color.size() == pixelCount && moments.size() == pixelCount && sampleCount.size() == pixelCount, "Buffer sizes don't match the frame dimension.");
+
+        // Update moments and compute the per-pixel demand.
+        std::vector<float4> demand(pixelCount);
+        float4 totals(0.f);
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            const uint32_t n = sampleCount[i];
+            const float L = luminance(float3(color[i].x, color[i].y, color[i].z));
+            if (n > 0 && std::isfinite(L))
+                moments[i] += float4(n * L, n * L * L, (float)n, 1.f);
+
+            const float relativeError = computeRelativeError(moments[i], params.relativeErrorEpsilon);
+            const bool converged = moments[i].w >= (float)params.minFrameCount && relativeError <= params.targetRelativeError;
+            const bool hasEstimate = relativeError < kUnknownError;
+
+            demand[i] = float4(
+                converged ? 0.f : computeDemand(params, moments[i]),
+                converged ? 0.f : 1.f,
+                hasEstimate ? relativeError : 0.f,
+                hasEstimate ? 1.f : 0.f
+            );
+            totals += demand[i];
+        }
+
+        // Write the sample count map for the next frame.
+        uint64_t totalSamples = 0;
+        const float budget = params.sampleBudget * (float)pixelCount;
+        const float scale = totals.x > 0.f ? std::min(1.f, std::max(budget - (float)pixelCount, 0.f) / totals.x) : 0.f;
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            uint32_t n = 1;
+            if (params.frameCount < params.minFrameCount)
+            {
+                n = getUniformSampleCount(params);
+            }
+            else if (demand[i].y > 0.f)
+            {
+                const float dither = (float)(jenkinsHash((uint32_t)i ^ jenkinsHash(params.frameCount)) >> 8) * (1.f / 16777216.f);
+                n = std::min(params.maxSamplesPerPixel, 1 + (uint32_t)std::floor(demand[i].x * scale + dither));
+            }
+            sampleCount[i] = (uint8_t)n;
+            totalSamples += n;
+        }
+
+        Stats stats;
+        stats.frameCount = params.frameCount;
+        stats.convergedFraction = pixelCount > 0 ? 1.f - totals.y / (float)pixelCount : 0.f;
+        stats.avgRelativeError = totals.w > 0.f ? totals.z / totals.w : 0.f;
+        stats.avgSamplesPerPixel = pixelCount > 0 ? (float)totalSamples / (float)pixelCount : 0.f;
+        return stats;
+    }
+
+    FALCOR_SCRIPT_BINDING(AdaptiveSampling)
+    {
+        pybind11::class_<AdaptiveSamplingParams> params(m, "AdaptiveSamplingParams");
+        params.def(pybind11::init<>());
+        params.def_readwrite("minFrameCount", &AdaptiveSamplingParams::minFrameCount);
+        params.def_readwrite("targetRelativeError", &AdaptiveSamplingParams::targetRelativeError);
+        params.def_readwrite("relativeErrorEpsilon", &AdaptiveSamplingParams::relativeErrorEpsilon);
+        params.def_readwrite("sampleBudget", &AdaptiveSamplingParams::sampleBudget);
+        params.def_readwrite("maxSamplesPerPixel", &AdaptiveSamplingParams::maxSamplesPerPixel);
+
+        pybind11::class_<AdaptiveSampling> adaptiveSampling(m, "AdaptiveSampling");
+        adaptiveSampling.def_property("enabled", &AdaptiveSampling::isEnabled, &AdaptiveSampling::setEnabled);
+        adaptiveSampling.def("reset", &AdaptiveSampling::reset);
+        adaptiveSampling.def_property_readonly("stats", [](AdaptiveSampling* pAdaptiveSampling) {
+            AdaptiveSampling::Stats stats;
+            pAdaptiveSampling->getStats(stats);
+            return toPython(stats);
+        });
+
+        adaptiveSampling.def_property("params", &AdaptiveSampling::getParams, &AdaptiveSampling::setParams);
+    }
+}
@@ -0,0 +1,171 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "AdaptiveSamplingShared.slang"
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/Texture.h"
+#include "Core/API/Fence.h"
+#include "Core/Pass/ComputePass.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/UI/Gui.h"
+#include "Utils/Algorithm/ParallelReduction.h"
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    /** Variance-driven adaptive sampling controller.
+
+        The controller tracks the per-pixel mean and variance of the luminance across frames and estimates
+        the relative error of the pixel mean. Based on the estimate it writes a sample count map (R8Uint)
+        that is used for rendering the next frame:
+        - Every pixel receives at least one sample, so that each frame is an unbiased estimate of the image
+          and can be accumulated with equal weights.
+        - Pixels with a relative error below the target are considered converged and receive one sample.
+        - The remaining sample budget is distributed over unconverged pixels proportionally to the number
+          of additional samples needed to reach the target error.
+
+        The statistics are kept as sample count weighted moments, which allows each frame to use a different
+        number of samples per pixel. Each pixel stores float4(sum(n * L), sum(n * L^2), sum(n), frames) where
+        L is the frame's pixel luminance estimated with n samples.
+
+        The first frames after a reset are rendered with a uniform sample count to bootstrap the estimates.
+        A CPU reference implementation of the estimator and allocation is provided for validation.
+    */
+    class FALCOR_API AdaptiveSampling
+    {
+    public:
+        struct Stats
+        {
+            uint32_t frameCount = 0;                ///< Number of frames accumulated since the last reset.
+            float    convergedFraction = 0.f;       ///< Fraction of converged pixels.
+            float    avgRelativeError = 0.f;        ///< Average estimated relative error over pixels with a valid estimate.
+            float    avgSamplesPerPixel = 0.f;      ///< Average number of samples per pixel allocated for the next frame.
+        };
+
+        /// Value returned by the relative error estimator if there are too few observations.
+        static constexpr float kUnknownError = 1e30f;
+
+        AdaptiveSampling(ref<Device> pDevice);
+
+        void setEnabled(bool enabled);
+        bool isEnabled() const { return mEnabled; }
+
+        void setParams(const AdaptiveSamplingParams& params);
+        const AdaptiveSamplingParams& getParams() const { return mParams; }
+
+        /** Reset the accumulated statistics. The next frames are rendered with uniform sampling.
+        */
+        void reset();
+
+        /** Prepare the sample count map for the current frame.
+            Must be called before rendering, the map is (re)initialized if the frame dimension has changed.
+            \param[in] pRenderContext The render context.
+            \param[in] frameDim Frame dimension in pixels.
+        */
+        void beginFrame(RenderContext* pRenderContext, const uint2& frameDim);
+
+        /** Update the statistics with the rendered frame and write the sample count map for the next frame.
+            \param[in] pRenderContext The render context.
+            \param[in] pColor Color rendered with the current sample count map (averaged over the samples of each pixel).
+        */
+        void endFrame(RenderContext* pRenderContext, const ref<Texture>& pColor);
+
+        /** Returns the sample count map (R8Uint) to use for rendering the current frame, or nullptr if disabled.
+        */
+        const ref<Texture>& getSampleCountTexture() const { return mpSampleCount; }
+
+        /** Returns the per-pixel moments (RGBA32Float) or nullptr if disabled.
+        */
+        const ref<Texture>& getMomentsTexture() const { return mpMoments; }
+
+        /** Fetches the latest stats.
+            \param[out] stats The stats are copied here.
+            \return True if stats are available, false otherwise.
+        */
+        bool getStats(Stats& stats);
+
+        void renderUI(Gui::Widgets& widget);
+
+        // CPU reference implementation
+
+        /** Estimate the relative error of a pixel mean from its moments.
+            \param[in] moments Moments float4(sum(n * L), sum(n * L^2), sum(n), frames).
+            \param[in] epsilon Value added to the mean luminance.
+            \return Relative error, or kUnknownError if there are fewer than two frames with samples.
+        */
+        static float computeRelativeError(const float4& moments, float epsilon);
+
+        /** Compute the number of additional samples a pixel needs in the next frame.
+            \param[in] params Adaptive sampling parameters.
+            \param[in] moments Moments of the pixel.
+            \return Demand in samples (0 if converged), limited to the maximum number of samples per pixel minus one.
+        */
+        static float computeDemand(const AdaptiveSamplingParams& params, const float4& moments);
+
+        /** Returns the uniform sample count used while bootstrapping the estimates.
+        */
+        static uint32_t getUniformSampleCount(const AdaptiveSamplingParams& params);
+
+        /** CPU reference of one frame update. This matches the GPU implementation up to floating-point precision.
+            \param[in] params Adaptive sampling parameters. The frame count includes the current frame.
+            \param[in] color Per-pixel color rendered with the sample counts in 'sampleCount'.
+            \param[in,out] moments Per-pixel moments. Updated with the current frame.
+            \param[in,out] sampleCount Per-pixel sample counts used for the current frame. Overwritten with the counts for the next frame.
+            \return Stats after the update.
+        */
+        static Stats updateReference(const AdaptiveSamplingParams& params, const std::vector<float4>& color, std::vector<float4>& moments, std::vector<uint8_t>& sampleCount);
+
+    protected:
+        void copyStatsToCPU();
+
+        ref<Device>                         mpDevice;
+
+        // Configuration
+        bool                                mEnabled = false;               ///< Enable adaptive sampling.
+        AdaptiveSamplingParams              mParams;                        ///< Parameters. The frame dimension and count are set internally.
+
+        // Internal state
+        ref<ComputePass>                    mpUpdatePass;                   ///< Pass updating the moments and computing the per-pixel demand.
+        ref<ComputePass>                    mpAllocatePass;                 ///< Pass writing the sample count map.
+        std::unique_ptr<ParallelReduction>  mpParallelReduction;            ///< Helper for parallel reduction on the GPU.
+        ref<Buffer>                         mpTotals;                       ///< Reduction results used by the allocation pass (GPU only).
+        ref<Buffer>                         mpReductionResult;              ///< Results buffer for stats readback (CPU mappable).
+        ref<Fence>                          mpFence;                        ///< GPU fence for sychronizing readback.
+
+        ref<Texture>                        mpMoments;                      ///< Per-pixel moments.
+        ref<Texture>                        mpDemand;                       ///< Per-pixel float4(demand, unconverged, relative error, has estimate).
+        ref<Texture>                        mpSampleCount;                  ///< Per-pixel sample count map for the current frame.
+
+        bool                                mResetPending = true;           ///< True if the statistics should be cleared at the next beginFrame().
+        bool                                mWaitingForData = false;        ///< True if we are waiting for data to become available on the GPU.
+        bool                                mStatsValid = false;            ///< True if stats have been read back and are valid.
+        Stats                               mStats;                         ///< Latest stats.
+    };
+}
@@ -0,0 +1,259 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AutoExposure.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Timing/Profiler.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFilename[] = "Rendering/Utils/AutoExposure.cs.slang";
+    }
+
+    AutoExposure::AutoExposure(ref<Device> pDevice)
+        : mpDevice(pDevice)
+    {
+    }
+
+    void AutoExposure::setParams(const AutoExposureParams& params)
+    {
+        FALCOR_CHECK(params.minLogLuminance < params.maxLogLuminance, "'minLogLuminance' must be less than 'maxLogLuminance'.");
+        FALCOR_CHECK(params.lowPercentile >= 0.f && params.lowPercentile < params.highPercentile && params.highPercentile <= 1.f, "Percentiles must satisfy 0 <= 'lowPercentile' < 'highPercentile' <= 1.");
+        FALCOR_CHECK(params.exposureKey > 0.f, "'exposureKey' must be positive.");
+        FALCOR_CHECK(params.adaptationSpeedUp >= 0.f && params.adaptationSpeedDown >= 0.f, "Adaptation speeds must be non-negative.");
+        FALCOR_CHECK(params.centerWeightSigma > 0.f, "'centerWeightSigma' must be positive.");
+        FALCOR_CHECK(params.spotRadius > 0.f, "'spotRadius' must be positive.");
+        FALCOR_CHECK(all(params.luminanceWeights >= 0.f), "'luminanceWeights' must be non-negative.");
+
+        uint2 frameDim = mParams.frameDim;
+        mParams = params;
+        mParams.frameDim = frameDim;
+        mParams.deltaTime = 0.f;
+    }
+
+    void AutoExposure::reset()
+    {
+        mResetPending = true;
+    }
+
+    void AutoExposure::execute(RenderContext* pRenderContext, const ref<Texture>& pColor, float deltaTime)
+    {
+        FALCOR_PROFILE(pRenderContext, "AutoExposure");
+        FALCOR_ASSERT(pColor);
+
+        if (!mpHistogramPass)
+        {
+            mpHistogramPass = ComputePass::create(mpDevice, ProgramDesc().addShaderLibrary(kShaderFilename).csEntry("buildHistogram"));
+            mpExposurePass = ComputePass::create(mpDevice, ProgramDesc().addShaderLibrary(kShaderFilename).csEntry("computeExposure"));
+            mpHistogram = mpDevice->createBuffer(kAutoExposureBinCount * sizeof(uint32_t), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal);
+            const float2 initialExposure = { 1.f, std::log2(mParams.exposureKey) };
+            mpExposure = mpDevice->createBuffer(sizeof(float2), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal, &initialExposure);
+            mpReadbackRing = std::make_unique<GpuReadbackRing>(mpDevice, sizeof(float2));
+            mResetPending = true;
+        }
+
+        // Fetch the exposure of previous frames for the UI.
+        mpReadbackRing->poll();
+
+        const uint2 frameDim = { pColor->getWidth(), pColor->getHeight() };
+        if (any(frameDim != mParams.frameDim))
+        {
+            mParams.frameDim = frameDim;
+            mResetPending = true;
+        }
+        mParams.deltaTime = std::max(deltaTime, 0.f);
+
+        pRenderContext->clearUAV(mpHistogram->getUAV().get(), uint4(0));
+
+        {
+            auto var = mpHistogramPass->getRootVar();
+            var["CB"]["gParams"].setBlob(mParams);
+            var["gColor"] = pColor;
+            var["gHistogram"] = mpHistogram;
+            mpHistogramPass->execute(pRenderContext, frameDim.x, frameDim.y);
+        }
+
+        {
+            auto var = mpExposurePass->getRootVar();
+            var["CB"]["gParams"].setBlob(mParams);
+            var["CB"]["gReset"] = mResetPending;
+            var["gHistogram"] = mpHistogram;
+            var["gExposure"] = mpExposure;
+            mpExposurePass->execute(pRenderContext, 1, 1);
+        }
+        mResetPending = false;
+
+        // Only read back the exposure if the UI is displayed. Reading back submits the command list.
+        if (mReadbackRequested)
+        {
+            mpReadbackRing->readBuffer(pRenderContext, mpExposure.get(), 0, sizeof(float2), 0, [this](uint64_t, const void* pData, size_t)
+            {
+                mLastExposure = *static_cast<const float2*>(pData);
+            });
+            mReadbackRequested = false;
+        }
+    }
+
+    bool AutoExposure::renderUI(Gui::Widgets& widget)
+    {
+        AutoExposureParams params = mParams;
+        bool dirty = false;
+        dirty |= widget.dropdown("Metering", params.metering);
+        if (params.metering == AutoExposureMetering::CenterWeighted)
+        {
+            dirty |= widget.var("Center weight sigma", params.centerWeightSigma, 0.01f, 4.f, 0.01f);
+            widget.tooltip("Standard deviation of the falloff, relative to half the frame height.");
+        }
+        else if (params.metering == AutoExposureMetering::Spot)
+        {
+            dirty |= widget.var("Spot radius", params.spotRadius, 0.01f, 1.f, 0.01f);
+            widget.tooltip("Radius of the metering disk, relative to half the frame height.");
+        }
+        dirty |= widget.var("Low percentile", params.lowPercentile, 0.f, 0.99f, 0.01f);
+        widget.tooltip("Fraction of the darkest pixels that is ignored.");
+        dirty |= widget.var("High percentile", params.highPercentile, 0.01f, 1.f, 0.01f);
+        widget.tooltip("Pixels above this fraction are ignored, i.e., 1 - highPercentile is the fraction of the brightest pixels that is ignored.");
+        dirty |= widget.var("Min log luminance", params.minLogLuminance, -32.f, 32.f, 0.5f);
+        dirty |= widget.var("Max log luminance", params.maxLogLuminance, -32.f, 32.f, 0.5f);
+        dirty |= widget.var("Adaptation speed up", params.adaptationSpeedUp, 0.f, 100.f, 0.1f);
+        widget.tooltip("Rate in 1/s at which the exposure adapts to brighter scenes. Zero adapts instantly.");
+        dirty |= widget.var("Adaptation speed down", params.adaptationSpeedDown, 0.f, 100.f, 0.1f);
+        widget.tooltip("Rate in 1/s at which the exposure adapts to darker scenes. Zero adapts instantly.");
+
+        if (dirty)
+        {
+            // Keep the percentile range non-empty while dragging the sliders.
+            params.highPercentile = std::max(params.highPercentile, params.lowPercentile + 0.01f);
+            params.maxLogLuminance = std::max(params.maxLogLuminance, params.minLogLuminance + 0.5f);
+            setParams(params);
+        }
+
+        mReadbackRequested = true;
+        if (mLastExposure.x > 0.f)
+        {
+            widget.text(fmt::format("Exposure: {:.4f} ({:+.2f} EV)\nAverage luminance: {:.4f}", mLastExposure.x, std::log2(mLastExposure.x), std::exp2(mLastExposure.y)));
+        }
+
+        return dirty;
+    }
+
+    float AutoExposure::computeMeteringWeight(const AutoExposureParams& params, const uint2& pixel)
+    {
+        // Offset from the frame center relative to half the frame height.
+        const float2 offset = (float2(pixel) + 0.5f - 0.5f * float2(params.frameDim)) / (0.5f * params.frameDim.y);
+        const float r2 = dot(offset, offset);
+
+        switch (params.metering)
+        {
+        case AutoExposureMetering::Average:
+            return 1.f;
+        case AutoExposureMetering::CenterWeighted:
+            return std::exp(-0.5f * r2 / (params.centerWeightSigma * params.centerWeightSigma));
+        case AutoExposureMetering::Spot:
+            return r2 <= params.spotRadius * params.spotRadius ? 1.f : 0.f;
+        default:
+            FALCOR_UNREACHABLE();
+            return 0.f;
+        }
+    }
+
+    uint32_t AutoExposure::computeBin(const AutoExposureParams& params, float luminance)
+    {
+        if (!(luminance > 0.f)) return 0;
+        const float t = (std::log2(luminance) - params.minLogLuminance) / (params.maxLogLuminance - params.minLogLuminance);
+        return (uint32_t)std::clamp(t * kAutoExposureBinCount, 0.f, (float)(kAutoExposureBinCount - 1));
+    }
+
+    std::vector<uint32_t> AutoExposure::computeHistogram(const AutoExposureParams& params, const std::vector<float4>& color)
+    {
+        FALCOR_CHECK(color.size() == (size_t)params.frameDim.x * params.frameDim.y, "Color doesn't match the frame dimension.");
+
+        std::vector<uint32_t> histogram(kAutoExposureBinCount, 0);
+        for (uint32_t y = 0; y < params.frameDim.y; y++)
+        {
+            for (uint32_t x = 0; x < params.frameDim.x; x++)
+            {
+                const float L = dot(color[y * params.frameDim.x + x].xyz(), params.luminanceWeights);
+                const uint32_t w = (uint32_t)(computeMeteringWeight(params, uint2(x, y)) * kAutoExposureWeightScale + 0.5f);
+                if (std::isnan(L) || w == 0) continue;
+                histogram[computeBin(params, L)] += w;
+            }
+        }
+        return histogram;
+    }
+
+    bool AutoExposure::computeAverageLogLuminance(const AutoExposureParams& params, const std::vector<uint32_t>& histogram, float& avgLogLuminance)
+    {
+        FALCOR_CHECK(histogram.size() == kAutoExposureBinCount, "Histogram must have {} bins.", kAutoExposureBinCount);
+
+        float total = 0.f;
+        for (uint32_t count : histogram) total += (float)count;
+
+        // Only the weight between the low and high percentiles contributes to the average.
+        const float low = params.lowPercentile * total;
+        const float high = params.highPercentile * total;
+        const float binWidth = (params.maxLogLuminance - params.minLogLuminance) / kAutoExposureBinCount;
+
+        float cumulative = 0.f;
+        float weightedSum = 0.f;
+        float weight = 0.f;
+        for (uint32_t i = 0; i < kAutoExposureBinCount; i++)
+        {
+            const float begin = cumulative;
+            cumulative += (float)histogram[i];
+            const float w = std::max(0.f, std::min(cumulative, high) - std::max(begin, low));
+            weightedSum += w * (params.minLogLuminance + (i + 0.5f) * binWidth);
+            weight += w;
+        }
+
+        if (!(weight > 0.f)) return false;
+        avgLogLuminance = weightedSum / weight;
+        return true;
+    }
+
+    float AutoExposure::computeTargetExposure(const AutoExposureParams& params, float avgLogLuminance)
+    {
+        return params.exposureKey / std::exp2(avgLogLuminance);
+    }
+
+    float AutoExposure::adaptExposure(const AutoExposureParams& params, float exposure, float targetExposure)
+    {
+        if (!(exposure > 0.f)) return targetExposure;
+
+        // A brighter scene lowers the target exposure.
+        const float speed = targetExposure < exposure ? params.adaptationSpeedUp : params.adaptationSpeedDown;
+        if (speed <= 0.f) return targetExposure;
+
+        const float alpha = 1.f - std::exp(-params.deltaTime * speed);
+        return std::exp2(std::log2(exposure) + alpha * (std::log2(targetExposure) - std::log2(exposure)));
+    }
+}
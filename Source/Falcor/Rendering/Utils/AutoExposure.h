@@ -0,0 +1,143 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "AutoExposureShared.slang"
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/Texture.h"
+#include "Core/Pass/ComputePass.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/UI/Gui.h"
+#include "Utils/GpuReadbackRing.h"
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    /** Histogram-based auto exposure.
+
+        Each frame, a histogram of the log2 luminance is built in a compute pass. Pixels are weighted
+        according to the metering mode. A second pass computes the weighted average log luminance over
+        the histogram, ignoring the darkest and brightest pixels as given by the low and high percentiles.
+        The target exposure scale is the exposure key divided by the average luminance. The exposure
+        adapts exponentially towards the target in log space, with separate rates for brighter and darker scenes.
+
+        The exposure scale is kept on the GPU in a buffer, so the tone mapper doesn't wait for the result.
+        The values shown in the UI are read back asynchronously.
+
+        A CPU reference implementation of the histogram and exposure math is provided for validation.
+    */
+    class FALCOR_API AutoExposure
+    {
+    public:
+        AutoExposure(ref<Device> pDevice);
+
+        void setParams(const AutoExposureParams& params);
+        const AutoExposureParams& getParams() const { return mParams; }
+
+        /** Reset the adaptation. The next update sets the exposure to the target directly.
+        */
+        void reset();
+
+        /** Update the exposure from a rendered frame.
+            \param[in] pRenderContext The render context.
+            \param[in] pColor Color in linear RGB.
+            \param[in] deltaTime Time since the last update in seconds.
+        */
+        void execute(RenderContext* pRenderContext, const ref<Texture>& pColor, float deltaTime);
+
+        /** Returns the buffer holding float2(exposure scale, average log2 luminance).
+            The exposure scale is multiplied with the color before tone mapping.
+        */
+        const ref<Buffer>& getExposureBuffer() const { return mpExposure; }
+
+        /** Returns the histogram buffer (kAutoExposureBinCount uints) of the last update.
+        */
+        const ref<Buffer>& getHistogramBuffer() const { return mpHistogram; }
+
+        /** Renders the UI.
+            \return True if the parameters were changed.
+        */
+        bool renderUI(Gui::Widgets& widget);
+
+        // CPU reference implementation
+
+        /** Compute the metering weight of a pixel.
+            \param[in] params Auto exposure parameters.
+            \param[in] pixel Pixel coordinates.
+            \return Weight in [0, 1].
+        */
+        static float computeMeteringWeight(const AutoExposureParams& params, const uint2& pixel);
+
+        /** Compute the histogram bin of a luminance value.
+        */
+        static uint32_t computeBin(const AutoExposureParams& params, float luminance);
+
+        /** Build the weighted log2 luminance histogram of a frame. This matches the GPU implementation exactly.
+            \param[in] params Auto exposure parameters.
+            \param[in] color Per-pixel color in linear RGB, in row-major order.
+            \return Histogram with kAutoExposureBinCount bins holding fixed-point weights.
+        */
+        static std::vector<uint32_t> computeHistogram(const AutoExposureParams& params, const std::vector<float4>& color);
+
+        /** Compute the weighted average log2 luminance over the histogram, ignoring pixels outside the percentile range.
+            \param[in] params Auto exposure parameters.
+            \param[in] histogram Histogram with kAutoExposureBinCount bins.
+            \param[out] avgLogLuminance Average log2 luminance.
+            \return False if the histogram holds no weight within the percentile range.
+        */
+        static bool computeAverageLogLuminance(const AutoExposureParams& params, const std::vector<uint32_t>& histogram, float& avgLogLuminance);
+
+        /** Compute the target exposure scale for an average log2 luminance.
+        */
+        static float computeTargetExposure(const AutoExposureParams& params, float avgLogLuminance);
+
+        /** Adapt the exposure towards the target.
+            \param[in] params Auto exposure parameters, including the time since the last update.
+            \param[in] exposure Current exposure scale. Non-positive values are treated as unknown.
+            \param[in] targetExposure Target exposure scale.
+            \return New exposure scale.
+        */
+        static float adaptExposure(const AutoExposureParams& params, float exposure, float targetExposure);
+
+    protected:
+        ref<Device>                         mpDevice;
+
+        AutoExposureParams                  mParams;                        ///< Parameters. The frame dimension and delta time are set internally.
+
+        ref<ComputePass>                    mpHistogramPass;                ///< Pass building the luminance histogram.
+        ref<ComputePass>                    mpExposurePass;                 ///< Pass computing and adapting the exposure.
+        ref<Buffer>                         mpHistogram;                    ///< Luminance histogram.
+        ref<Buffer>                         mpExposure;                     ///< float2(exposure scale, average log2 luminance).
+        std::unique_ptr<GpuReadbackRing>    mpReadbackRing;                 ///< Readback of the exposure for the UI.
+
+        bool                                mResetPending = true;           ///< True if the next update should not be smoothed.
+        bool                                mReadbackRequested = false;     ///< True if the exposure should be read back for the UI.
+        float2                              mLastExposure = { 0.f, 0.f };   ///< Last exposure read back to the CPU.
+    };
+}
@@ -37,6 +37,7 @@ namespace Falcor
     namespace
     {
         const char kComputeRayCountFilename[] = "Rendering/Utils/PixelStats.cs.slang";
+        const uint32_t kReadbackSlotCount = 3;
 
         pybind11::dict toPython(const PixelStats::Stats& stats)
         {
@@ -67,22 +68,27 @@ namespace Falcor
         // Prepare state.
         FALCOR_ASSERT(!mRunning);
         mRunning = true;
-        mWaitingForData = false;
         mFrameDim = frameDim;
 
-        // Mark previously stored data as invalid. The config may have changed, so this is the safe bet.
-        mStats = Stats();
-        mStatsValid = false;
+        // Per-pixel data is about to be overwritten. Summarized stats from earlier frames stay valid
+        // until they are replaced by newer readbacks.
         mStatsBuffersValid = false;
         mRayCountTextureValid = false;
 
-        if (mEnabled)
+        if (!mEnabled)
+        {
+            // Mark previously stored data as invalid and drop readbacks in flight.
+            if (mpReadbackRing) mpReadbackRing->discard();
+            mStats = Stats();
+            mStatsValid = false;
+        }
+        else
         {
             // Create parallel reduction helper.
             if (!mpParallelReduction)
             {
                 mpParallelReduction = std::make_unique<ParallelReduction>(mpDevice);
-                mpReductionResult = mpDevice->createBuffer((kRayTypeCount + 3) * sizeof(uint4), ResourceBindFlags::None, MemoryType::ReadBack);
+                mpReadbackRing = std::make_unique<GpuReadbackRing>(mpDevice, (kRayTypeCount + 3) * sizeof(uint4), kReadbackSlotCount);
             }
 
             // Prepare stats buffers.
@@ -114,24 +120,25 @@ namespace Falcor
 
         if (mEnabled)
         {
-            // Create fence first time we need it.
-            if (!mpFence) mpFence = mpDevice->createFence();
-
-            // Sum of the per-pixel counters. The results are copied to a GPU buffer.
+            // Sum of the per-pixel counters. The results are copied to a readback buffer from the ring.
+            const uint32_t slot = mpReadbackRing->acquire();
+            const ref<Buffer>& pResult = mpReadbackRing->getBuffer(slot);
             for (uint32_t i = 0; i < kRayTypeCount; i++)
             {
-                mpParallelReduction->execute<uint4>(pRenderContext, mpStatsRayCount[i], ParallelReduction::Type::Sum, nullptr, mpReductionResult, i * sizeof(uint4));
+                mpParallelReduction->execute<uint4>(pRenderContext, mpStatsRayCount[i], ParallelReduction::Type::Sum, nullptr, pResult, i * sizeof(uint4));
             }
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathLength, ParallelReduction::Type::Sum, nullptr, mpReductionResult, kRayTypeCount * sizeof(uint4));
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathVertexCount, ParallelReduction::Type::Sum, nullptr, mpReductionResult, (kRayTypeCount + 1) * sizeof(uint4));
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsVolumeLookupCount, ParallelReduction::Type::Sum, nullptr, mpReductionResult, (kRayTypeCount + 2) * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathLength, ParallelReduction::Type::Sum, nullptr, pResult, kRayTypeCount * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathVertexCount, ParallelReduction::Type::Sum, nullptr, pResult, (kRayTypeCount + 1) * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsVolumeLookupCount, ParallelReduction::Type::Sum, nullptr, pResult, (kRayTypeCount + 2) * sizeof(uint4));
 
-            // Submit command list and insert signal.
-            pRenderContext->submit(false);
-            pRenderContext->signal(mpFence.get());
+            // Submit command list and insert signal. The stats are updated once the data is available.
+            const uint2 frameDim = mFrameDim;
+            mpReadbackRing->submit(slot, mFrameCount++, pResult->getSize(), [this, frameDim](uint64_t, const void* pData, size_t)
+            {
+                updateStats(static_cast<const uint4*>(pData), frameDim);
+            });
 
             mStatsBuffersValid = true;
-            mWaitingForData = true;
         }
     }
 
@@ -162,8 +169,8 @@ namespace Falcor
         widget.checkbox("Ray stats", mEnabled);
         widget.tooltip("Collects ray tracing traversal stats on the GPU.\nNote that this option slows down the performance.");
 
-        // Fetch data and show stats if available.
-        copyStatsToCPU();
+        // Fetch data and show stats if available. Don't wait for the GPU, the stats may lag a few frames behind.
+        copyStatsToCPU(false);
         if (mStatsValid)
         {
             widget.text("Stats:");
@@ -198,7 +205,7 @@ namespace Falcor
 
     bool PixelStats::getStats(PixelStats::Stats& stats)
     {
-        copyStatsToCPU();
+        copyStatsToCPU(true);
         if (!mStatsValid)
         {
             logWarning("PixelStats::getStats() - Stats are not valid. Ignoring.");
@@ -260,43 +267,37 @@ namespace Falcor
         return mStatsBuffersValid ? mpStatsVolumeLookupCount : nullptr;
     }
 
-    void PixelStats::copyStatsToCPU()
+    void PixelStats::copyStatsToCPU(bool waitForLatest)
     {
         FALCOR_ASSERT(!mRunning);
-        if (mWaitingForData)
-        {
-            // Wait for signal.
-            mpFence->wait();
-            mWaitingForData = false;
+        if (!mpReadbackRing) return;
 
-            if (mEnabled)
-            {
-                // Map the stats buffer.
-                const uint4* result = static_cast<const uint4*>(mpReductionResult->map());
-                FALCOR_ASSERT(result);
-
-                const uint32_t totalPathLength = result[kRayTypeCount].x;
-                const uint32_t totalPathVertices = result[kRayTypeCount + 1].x;
-                const uint32_t totalVolumeLookups = result[kRayTypeCount + 2].x;
-                const uint32_t numPixels = mFrameDim.x * mFrameDim.y;
-                FALCOR_ASSERT(numPixels > 0);
-
-                mStats.visibilityRays = result[(uint32_t)PixelStatsRayType::Visibility].x;
-                mStats.closestHitRays = result[(uint32_t)PixelStatsRayType::ClosestHit].x;
-                mStats.totalRays = mStats.visibilityRays + mStats.closestHitRays;
-                mStats.pathVertices = totalPathVertices;
-                mStats.volumeLookups = totalVolumeLookups;
-                mStats.avgVisibilityRays = (float)mStats.visibilityRays / numPixels;
-                mStats.avgClosestHitRays = (float)mStats.closestHitRays / numPixels;
-                mStats.avgTotalRays = (float)mStats.totalRays / numPixels;
-                mStats.avgPathLength = (float)totalPathLength / numPixels;
-                mStats.avgPathVertices = (float)totalPathVertices / numPixels;
-                mStats.avgVolumeLookups = (float)totalVolumeLookups / numPixels;
-
-                mpReductionResult->unmap();
-                mStatsValid = true;
-            }
-        }
+        if (waitForLatest) mpReadbackRing->flush();
+        else mpReadbackRing->poll();
+    }
+
+    void PixelStats::updateStats(const uint4* result, const uint2& frameDim)
+    {
+        FALCOR_ASSERT(result);
+
+        const uint32_t totalPathLength = result[kRayTypeCount].x;
+        const uint32_t totalPathVertices = result[kRayTypeCount + 1].x;
+        const uint32_t totalVolumeLookups = result[kRayTypeCount + 2].x;
+        const uint32_t numPixels = frameDim.x * frameDim.y;
+        FALCOR_ASSERT(numPixels > 0);
+
+        mStats.visibilityRays = result[(uint32_t)PixelStatsRayType::Visibility].x;
+        mStats.closestHitRays = result[(uint32_t)PixelStatsRayType::ClosestHit].x;
+        mStats.totalRays = mStats.visibilityRays + mStats.closestHitRays;
+        mStats.pathVertices = totalPathVertices;
+        mStats.volumeLookups = totalVolumeLookups;
+        mStats.avgVisibilityRays = (float)mStats.visibilityRays / numPixels;
+        mStats.avgClosestHitRays = (float)mStats.closestHitRays / numPixels;
+        mStats.avgTotalRays = (float)mStats.totalRays / numPixels;
+        mStats.avgPathLength = (float)totalPathLength / numPixels;
+        mStats.avgPathVertices = (float)totalPathVertices / numPixels;
+        mStats.avgVolumeLookups = (float)totalVolumeLookups / numPixels;
+        mStatsValid = true;
     }
 
     FALCOR_SCRIPT_BINDING(PixelStats)
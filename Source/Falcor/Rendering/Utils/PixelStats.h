@@ -30,10 +30,10 @@
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 #include "Core/API/Texture.h"
-#include "Core/API/Fence.h"
 #include "Core/Pass/ComputePass.h"
 #include "Utils/UI/Gui.h"
 #include "Utils/Algorithm/ParallelReduction.h"
+#include "Utils/GpuReadbackRing.h"
 #include <memory>
 
 namespace Falcor
@@ -43,6 +43,9 @@ namespace Falcor
         Per-pixel stats are logged in buffers on the GPU, which are immediately ready for consumption
         after end() is called. These stats are summarized in a reduction pass, which are
         available in getStats() or printStats() after async readback to the CPU.
+
+        The readback goes through a ring of staging buffers, so the UI shows stats that lag a
+        few frames behind without stalling the GPU. getStats() waits for the latest frame.
     */
     class FALCOR_API PixelStats
     {
@@ -78,6 +81,7 @@ namespace Falcor
         void renderUI(Gui::Widgets& widget);
 
         /** Fetches the latest stats generated by begin()/end().
+            This waits for the readback of the last frame to complete.
             \param[out] stats The stats are copied here.
             \return True if stats are available, false otherwise.
         */
@@ -105,7 +109,8 @@ namespace Falcor
         const ref<Texture> getVolumeLookupCountTexture() const;
 
     protected:
-        void copyStatsToCPU();
+        void copyStatsToCPU(bool waitForLatest);
+        void updateStats(const uint4* result, const uint2& frameDim);
         void computeRayCountTexture(RenderContext* pRenderContext);
 
         static const uint32_t kRayTypeCount = (uint32_t)PixelStatsRayType::Count;
@@ -114,8 +119,7 @@ namespace Falcor
 
         // Internal state
         std::unique_ptr<ParallelReduction>  mpParallelReduction;            ///< Helper for parallel reduction on the GPU.
-        ref<Buffer>                         mpReductionResult;              ///< Results buffer for stats readback (CPU mappable).
-        ref<Fence>                          mpFence;                        ///< GPU fence for sychronizing readback.
+        std::unique_ptr<GpuReadbackRing>    mpReadbackRing;                 ///< Ring of results buffers for async stats readback.
 
         // Configuration
         bool                                mEnabled = false;               ///< Enable pixel statistics.
@@ -123,8 +127,8 @@ namespace Falcor
 
         // Runtime data
         bool                                mRunning = false;               ///< True inbetween begin() / end() calls.
-        bool                                mWaitingForData = false;        ///< True if we are waiting for data to become available on the GPU.
         uint2                               mFrameDim = { 0, 0 };           ///< Frame dimensions at last call to begin().
+        uint64_t                            mFrameCount = 0;                ///< Number of frames with stats enabled. Used for tagging readbacks.
 
         bool                                mStatsValid = false;            ///< True if stats have been read back and are valid.
         bool                                mRayCountTextureValid = false;  ///< True if total ray count texture is valid.
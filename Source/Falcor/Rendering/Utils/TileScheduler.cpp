@@ -0,0 +1,197 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TileScheduler.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Falcor
+{
+
+TileScheduler::TileScheduler(uint2 frameDim, uint2 tileSize, const RenderTile& region) : mFrameDim(frameDim), mTileSize(tileSize)
+{
+    FALCOR_CHECK(all(frameDim > uint2(0)), "Frame dimension must be larger than zero.");
+    FALCOR_CHECK(all(tileSize > uint2(0)), "Tile size must be larger than zero.");
+
+    // Clip the region to the frame.
+    if (region.isEmpty())
+    {
+        mRegion.extent = frameDim;
+    }
+    else
+    {
+        const uint2 end = min(region.getEnd(), frameDim);
+        FALCOR_CHECK(all(region.offset < end), "Region ({}, {}) - ({}, {}) doesn't overlap the frame.", region.offset.x, region.offset.y, region.getEnd().x, region.getEnd().y);
+        mRegion.offset = region.offset;
+        mRegion.extent = end - region.offset;
+    }
+
+    // Build the frame-aligned grid of tiles overlapping the region.
+    mFirstTile = mRegion.offset / tileSize;
+    mGridDim = div_round_up(mRegion.getEnd(), tileSize) - mFirstTile;
+    mTiles.reserve(mGridDim.x * mGridDim.y);
+    for (uint32_t y = 0; y < mGridDim.y; y++)
+    {
+        for (uint32_t x = 0; x < mGridDim.x; x++)
+        {
+            const uint2 begin = max((mFirstTile + uint2(x, y)) * tileSize, mRegion.offset);
+            const uint2 end = min((mFirstTile + uint2(x + 1, y + 1)) * tileSize, mRegion.getEnd());
+            mTiles.push_back({begin, end - begin});
+        }
+    }
+}
+
+std::vector<float> TileScheduler::computeTileErrors(const float* pPixelErrors) const
+{
+    FALCOR_CHECK(pPixelErrors, "'pPixelErrors' must not be nullptr.");
+
+    std::vector<float> tileErrors(mTiles.size());
+    for (size_t i = 0; i < mTiles.size(); i++)
+    {
+        const RenderTile& tile = mTiles[i];
+        double sum = 0.0;
+        for (uint32_t y = tile.offset.y; y < tile.getEnd().y; y++)
+        {
+            const float* pRow = pPixelErrors + (size_t)y * mFrameDim.x;
+            for (uint32_t x = tile.offset.x; x < tile.getEnd().x; x++)
+                sum += std::isfinite(pRow[x]) ? pRow[x] : std::numeric_limits<double>::infinity();
+        }
+        tileErrors[i] = (float)(sum / tile.getPixelCount());
+    }
+    return tileErrors;
+}
+
+std::vector<uint32_t> TileScheduler::getSchedule(Order order, const std::vector<float>& tileErrors) const
+{
+    switch (order)
+    {
+    case Order::Scanline:
+    {
+        std::vector<uint32_t> schedule(mTiles.size());
+        for (uint32_t i = 0; i < schedule.size(); i++)
+            schedule[i] = i;
+        return schedule;
+    }
+    case Order::Spiral:
+        return getSpiralSchedule();
+    case Order::ErrorPriority:
+    {
+        std::vector<uint32_t> schedule = getSpiralSchedule();
+        if (tileErrors.empty())
+            return schedule;
+        FALCOR_CHECK(tileErrors.size() == mTiles.size(), "Expected {} tile errors, got {}.", mTiles.size(), tileErrors.size());
+
+        // NaN errors are treated as infinite to get a strict weak ordering.
+        auto getError = [&](uint32_t index) { return std::isnan(tileErrors[index]) ? std::numeric_limits<float>::infinity() : tileErrors[index]; };
+        std::stable_sort(schedule.begin(), schedule.end(), [&](uint32_t a, uint32_t b) { return getError(a) > getError(b); });
+        return schedule;
+    }
+    default:
+        FALCOR_UNREACHABLE();
+    }
+}
+
+std::vector<uint32_t> TileScheduler::getSpiralSchedule() const
+{
+    std::vector<uint32_t> schedule;
+    schedule.reserve(mTiles.size());
+
+    // Start at the tile containing the center of the region.
+    const uint2 center = mRegion.offset + mRegion.extent / 2u;
+    int2 pos = int2(center / mTileSize - mFirstTile);
+
+    auto visit = [&](int2 p)
+    {
+        if (p.x >= 0 && p.y >= 0 && p.x < (int)mGridDim.x && p.y < (int)mGridDim.y)
+            schedule.push_back(p.y * mGridDim.x + p.x);
+    };
+
+    // Walk a square spiral (right, down, left, up) with leg lengths 1, 1, 2, 2, 3, 3, ...
+    // and keep the positions inside the grid until all tiles have been visited.
+    const int2 kDirections[4] = {int2(1, 0), int2(0, 1), int2(-1, 0), int2(0, -1)};
+    visit(pos);
+    for (uint32_t leg = 0; schedule.size() < mTiles.size(); leg++)
+    {
+        const int2 dir = kDirections[leg % 4];
+        const uint32_t length = leg / 2 + 1;
+        for (uint32_t i = 0; i < length; i++)
+        {
+            pos += dir;
+            visit(pos);
+        }
+    }
+
+    FALCOR_ASSERT(schedule.size() == mTiles.size());
+    return schedule;
+}
+
+TileStitcher::TileStitcher(const RenderTile& region, size_t bytesPerPixel) : mRegion(region), mBytesPerPixel(bytesPerPixel)
+{
+    FALCOR_CHECK(!region.isEmpty(), "Region must not be empty.");
+    FALCOR_CHECK(bytesPerPixel > 0, "Pixel size must be larger than zero.");
+    mData.resize((size_t)region.getPixelCount() * bytesPerPixel);
+}
+
+void TileStitcher::addTile(const RenderTile& tile, const void* pData, size_t rowPitch)
+{
+    FALCOR_CHECK(pData, "'pData' must not be nullptr.");
+    FALCOR_CHECK(
+        all(tile.offset >= mRegion.offset) && all(tile.getEnd() <= mRegion.getEnd()),
+        "Tile ({}, {}) - ({}, {}) doesn't lie within the region.",
+        tile.offset.x,
+        tile.offset.y,
+        tile.getEnd().x,
+        tile.getEnd().y
+    );
+
+    const size_t rowSize = tile.extent.x * mBytesPerPixel;
+    if (rowPitch == 0)
+        rowPitch = rowSize;
+    FALCOR_CHECK(rowPitch >= rowSize, "Row pitch must not be smaller than the tile row size.");
+
+    const uint2 dst = tile.offset - mRegion.offset;
+    const uint8_t* pSrc = static_cast<const uint8_t*>(pData);
+    for (uint32_t y = 0; y < tile.extent.y; y++)
+    {
+        uint8_t* pDst = mData.data() + ((size_t)(dst.y + y) * mRegion.extent.x + dst.x) * mBytesPerPixel;
+        std::memcpy(pDst, pSrc + y * rowPitch, rowSize);
+    }
+    mCoveredPixels += tile.getPixelCount();
+}
+
+void TileStitcher::clear()
+{
+    std::fill(mData.begin(), mData.end(), uint8_t(0));
+    mCoveredPixels = 0;
+}
+
+} // namespace Falcor
@@ -0,0 +1,163 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
+#include "Utils/Math/Vector.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Host-side scheduler for tiled and region-of-interest rendering.
+ *
+ * The region of interest is divided into a grid of tiles. The grid is aligned to multiples of the
+ * tile size in the frame, so the same pixels always map to the same tiles independent of the region,
+ * and tiles at the border of the region are clipped to it. Tiles are indexed in scanline order.
+ *
+ * The scheduler computes the order in which the tiles are rendered. Each tile is rendered by passing
+ * it to the render graph through the dictionary (see kRenderPassTileKey), and the rendered tiles are
+ * assembled into the final image with TileStitcher.
+ */
+class FALCOR_API TileScheduler
+{
+public:
+    enum class Order
+    {
+        Scanline,      ///< Rows of tiles from top to bottom, left to right.
+        Spiral,        ///< Square spiral starting at the tile in the center of the region.
+        ErrorPriority, ///< Decreasing tile error, ties are broken by spiral order.
+    };
+
+    FALCOR_ENUM_INFO(
+        Order,
+        {
+            {Order::Scanline, "Scanline"},
+            {Order::Spiral, "Spiral"},
+            {Order::ErrorPriority, "ErrorPriority"},
+        }
+    );
+
+    /**
+     * Constructor. Throws if the region doesn't overlap the frame.
+     * @param frameDim Frame dimension in pixels.
+     * @param tileSize Tile size in pixels.
+     * @param region Region of interest. It is clipped to the frame, an empty region covers the whole frame.
+     */
+    TileScheduler(uint2 frameDim, uint2 tileSize, const RenderTile& region = {});
+
+    uint2 getFrameDim() const { return mFrameDim; }
+    uint2 getTileSize() const { return mTileSize; }
+
+    /// Return the region of interest clipped to the frame.
+    const RenderTile& getRegion() const { return mRegion; }
+
+    /// Return the number of tiles along x and y.
+    uint2 getGridDim() const { return mGridDim; }
+
+    uint32_t getTileCount() const { return (uint32_t)mTiles.size(); }
+    const RenderTile& getTile(uint32_t index) const { return mTiles[index]; }
+    const std::vector<RenderTile>& getTiles() const { return mTiles; }
+
+    /**
+     * Compute the error of each tile from a per-pixel error estimate, such as the relative error
+     * estimated by adaptive sampling. The tile error is the mean over the pixels in the tile.
+     * Tiles containing non-finite errors get an infinite error, so fireflies are rendered first.
+     * @param pPixelErrors Per-pixel errors of the whole frame in scanline order.
+     * @return Error per tile.
+     */
+    std::vector<float> computeTileErrors(const float* pPixelErrors) const;
+
+    /**
+     * Compute the order in which to render the tiles.
+     * @param order Ordering strategy.
+     * @param tileErrors Error per tile used for Order::ErrorPriority. If empty, the spiral order is used.
+     * @return Tile indices in render order.
+     */
+    std::vector<uint32_t> getSchedule(Order order, const std::vector<float>& tileErrors = {}) const;
+
+private:
+    std::vector<uint32_t> getSpiralSchedule() const;
+
+    uint2 mFrameDim;
+    uint2 mTileSize;
+    RenderTile mRegion;
+    uint2 mFirstTile; ///< Grid coordinates of the first tile in the frame-aligned grid.
+    uint2 mGridDim;
+    std::vector<RenderTile> mTiles;
+};
+
+FALCOR_ENUM_REGISTER(TileScheduler::Order);
+
+/**
+ * Host-side image assembled from rendered tiles.
+ *
+ * The image covers the region of interest of a TileScheduler, pixels are stored in scanline order
+ * without padding. Pixels that are not covered by any tile are zero.
+ */
+class FALCOR_API TileStitcher
+{
+public:
+    /**
+     * Constructor.
+     * @param region Region covered by the image in frame coordinates.
+     * @param bytesPerPixel Size of a pixel in bytes.
+     */
+    TileStitcher(const RenderTile& region, size_t bytesPerPixel);
+
+    /**
+     * Copy the pixels of a tile into the image. Tiles must not overlap.
+     * @param tile Tile in frame coordinates. Throws if it doesn't lie within the region.
+     * @param pData Pixels of the tile in scanline order.
+     * @param rowPitch Number of bytes between rows in pData, zero for tightly packed rows.
+     */
+    void addTile(const RenderTile& tile, const void* pData, size_t rowPitch = 0);
+
+    const RenderTile& getRegion() const { return mRegion; }
+    size_t getBytesPerPixel() const { return mBytesPerPixel; }
+
+    /// Return true if all pixels of the region have been covered by tiles.
+    bool isComplete() const { return mCoveredPixels == mRegion.getPixelCount(); }
+
+    const std::vector<uint8_t>& getData() const { return mData; }
+
+    /// Reset the image to zero to assemble another frame.
+    void clear();
+
+private:
+    RenderTile mRegion;
+    size_t mBytesPerPixel;
+    uint64_t mCoveredPixels = 0;
+    std::vector<uint8_t> mData;
+};
+
+} // namespace Falcor
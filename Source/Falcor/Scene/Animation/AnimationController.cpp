@@ -27,8 +27,10 @@
  **************************************************************************/
 #include "AnimationController.h"
 #include "Core/API/RenderContext.h"
+#include "Utils/Algorithm/IndexRanges.h"
 #include "Utils/Timing/Profiler.h"
 #include "Scene/Scene.h"
+#include <algorithm>
 #include <fstream>
 
 namespace Falcor
@@ -39,6 +41,10 @@ namespace Falcor
         const std::string kInverseTransposeWorldMatrices = "inverseTransposeWorldMatrices";
         const std::string kPrevWorldMatrices = "prevWorldMatrices";
         const std::string kPrevInverseTransposeWorldMatrices = "prevInverseTransposeWorldMatrices";
+
+        // Maximum number of unchanged matrices to include in a single upload range.
+        // Uploading a few redundant matrices is cheaper than issuing many small uploads.
+        const uint32_t kMaxUploadGap = 16;
     }
 
     AnimationController::AnimationController(ref<Device> pDevice, Scene* pScene, const StaticVertexVector& staticVertexData, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<ref<Animation>>& animations)
@@ -53,6 +59,7 @@ namespace Falcor
     {
         // Create GPU resources.
         FALCOR_ASSERT(mLocalMatrices.size() <= std::numeric_limits<uint32_t>::max());
+        initNodeChildren();
 
         if (!mLocalMatrices.empty())
         {
@@ -190,25 +197,66 @@ namespace Falcor
         }
     }
 
+    void AnimationController::initNodeChildren()
+    {
+        // Build a compact list of children per scene node to propagate changes to descendants without visiting all nodes.
+        const auto& sceneGraph = mpScene->mSceneGraph;
+        mNodeChildOffsets.assign(sceneGraph.size() + 1, 0);
+        for (const auto& node : sceneGraph)
+        {
+            if (node.parent != NodeID::Invalid()) mNodeChildOffsets[node.parent.get() + 1]++;
+        }
+        for (size_t i = 0; i < sceneGraph.size(); i++) mNodeChildOffsets[i + 1] += mNodeChildOffsets[i];
+
+        mNodeChildren.resize(mNodeChildOffsets.back());
+        std::vector<uint32_t> childCount(sceneGraph.size(), 0);
+        for (size_t i = 0; i < sceneGraph.size(); i++)
+        {
+            NodeID parent = sceneGraph[i].parent;
+            if (parent == NodeID::Invalid()) continue;
+            // Global matrices are computed in node order, which requires parents to precede their children.
+            FALCOR_ASSERT(parent.get() < i);
+            mNodeChildren[mNodeChildOffsets[parent.get()] + childCount[parent.get()]++] = (uint32_t)i;
+        }
+    }
+
+    void AnimationController::markMatrixChanged(uint32_t matrixID)
+    {
+        if (mMatricesChanged[matrixID]) return;
+        mMatricesChanged[matrixID] = true;
+        mChangedMatrixIDs.push_back(matrixID);
+    }
+
+    void AnimationController::markAllMatricesChanged()
+    {
+        std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), true);
+        mChangedMatrixIDs.resize(mMatricesChanged.size());
+        for (size_t i = 0; i < mChangedMatrixIDs.size(); i++) mChangedMatrixIDs[i] = (uint32_t)i;
+    }
+
+    void AnimationController::clearChangedMatrices()
+    {
+        for (uint32_t matrixID : mChangedMatrixIDs) mMatricesChanged[matrixID] = false;
+        mChangedMatrixIDs.clear();
+    }
+
     bool AnimationController::animate(RenderContext* pRenderContext, double currentTime)
     {
         FALCOR_PROFILE(pRenderContext, "animate");
 
-        std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), false);
+        clearChangedMatrices();
+        mUploadedByteSize = 0;
 
         // Check for edited scene nodes and update local matrices.
         const auto& sceneGraph = mpScene->mSceneGraph;
-        bool edited = false;
-        for (size_t i = 0; i < sceneGraph.size(); ++i)
+        bool edited = !mEditedNodeIDs.empty();
+        for (uint32_t nodeID : mEditedNodeIDs)
         {
-            if (mNodesEdited[i])
-            {
-                mLocalMatrices[i] = sceneGraph[i].transform;
-                mNodesEdited[i] = false;
-                mMatricesChanged[i] = true;
-                edited = true;
-            }
+            mLocalMatrices[nodeID] = sceneGraph[nodeID].transform;
+            mNodesEdited[nodeID] = false;
+            markMatrixChanged(nodeID);
         }
+        mEditedNodeIDs.clear();
 
         bool changed = false;
         double time = mLoopAnimations ? std::fmod(currentTime, mGlobalAnimationLength) : currentTime;
@@ -218,7 +266,7 @@ namespace Falcor
         // including transformation matrices, dynamic vertex data etc.
         if (mFirstUpdate || mEnabled != mPrevEnabled)
         {
-            std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), true);
+            markAllMatricesChanged();
             initLocalMatrices();
             if (mEnabled)
             {
@@ -227,6 +275,7 @@ namespace Falcor
             }
             updateWorldMatrices(true);
             uploadWorldMatrices(true);
+            mPrevUploadMatrixIDs.clear();
 
             if (!sceneGraph.empty())
             {
@@ -294,7 +343,7 @@ namespace Falcor
             NodeID nodeID = pAnimation->getNodeID();
             FALCOR_ASSERT(nodeID.get() < mLocalMatrices.size());
             mLocalMatrices[nodeID.get()] = pAnimation->animate(time);
-            mMatricesChanged[nodeID.get()] = true;
+            markMatrixChanged(nodeID.get());
         }
     }
 
@@ -302,16 +351,26 @@ namespace Falcor
     {
         const auto& sceneGraph = mpScene->mSceneGraph;
 
-        for (size_t i = 0; i < mGlobalMatrices.size(); i++)
+        if (updateAll)
+        {
+            markAllMatricesChanged();
+        }
+        else
         {
-            // Propagate matrix change flag to children.
-            if (sceneGraph[i].parent != NodeID::Invalid())
+            // Propagate matrix changes to all descendants.
+            // Note that the list grows while iterating, so descendants of descendants are visited as well.
+            for (size_t j = 0; j < mChangedMatrixIDs.size(); j++)
             {
-                mMatricesChanged[i] = mMatricesChanged[i] || mMatricesChanged[sceneGraph[i].parent.get()];
+                uint32_t matrixID = mChangedMatrixIDs[j];
+                for (uint32_t k = mNodeChildOffsets[matrixID]; k < mNodeChildOffsets[matrixID + 1]; k++) markMatrixChanged(mNodeChildren[k]);
             }
 
-            if (!mMatricesChanged[i] && !updateAll) continue;
+            // Parents precede their children, so updating in ascending order uses up-to-date parent matrices.
+            std::sort(mChangedMatrixIDs.begin(), mChangedMatrixIDs.end());
+        }
 
+        for (uint32_t i : mChangedMatrixIDs)
+        {
             mGlobalMatrices[i] = mLocalMatrices[i];
 
             if (mpScene->mSceneGraph[i].parent != NodeID::Invalid())
@@ -341,25 +400,23 @@ namespace Falcor
             // Upload all matrices.
             mpWorldMatricesBuffer->setBlob(mGlobalMatrices.data(), 0, mpWorldMatricesBuffer->getSize());
             mpInvTransposeWorldMatricesBuffer->setBlob(mInvTransposeGlobalMatrices.data(), 0, mpInvTransposeWorldMatricesBuffer->getSize());
+            mUploadedByteSize += mpWorldMatricesBuffer->getSize() + mpInvTransposeWorldMatricesBuffer->getSize();
         }
         else
         {
             // Upload changed matrices only.
-            for (size_t i = 0; i < mGlobalMatrices.size();)
-            {
-                // Detect ranges of consecutive matrices that have all changed or not.
-                size_t offset = i;
-                bool changed = mMatricesChanged[i];
-                while (i < mGlobalMatrices.size() && mMatricesChanged[i] == changed) ++i;
+            // The buffers are double buffered and swapped every incremental update, so the current buffers also
+            // lack the matrices that changed in the previous update.
+            mUploadMatrixIDs.clear();
+            std::set_union(mChangedMatrixIDs.begin(), mChangedMatrixIDs.end(), mPrevUploadMatrixIDs.begin(), mPrevUploadMatrixIDs.end(), std::back_inserter(mUploadMatrixIDs));
+            mPrevUploadMatrixIDs = mChangedMatrixIDs;
 
-                // Upload range of changed matrices.
-                if (changed)
-                {
-                    size_t count = i - offset;
-                    mpWorldMatricesBuffer->setBlob(&mGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
-                    mpInvTransposeWorldMatricesBuffer->setBlob(&mInvTransposeGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
-                }
-            }
+            forEachIndexRange(mUploadMatrixIDs, kMaxUploadGap, [&](uint32_t offset, uint32_t count)
+            {
+                mpWorldMatricesBuffer->setBlob(&mGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
+                mpInvTransposeWorldMatricesBuffer->setBlob(&mInvTransposeGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
+                mUploadedByteSize += 2 * count * sizeof(float4x4);
+            });
         }
     }
 
@@ -454,10 +511,21 @@ namespace Falcor
     {
         if (!mpSkinningPass) return;
 
-        // Update matrices.
+        // Update matrices. After initialization, only changed matrices are uploaded.
         FALCOR_ASSERT(mpSkinningMatricesBuffer && mpInvTransposeSkinningMatricesBuffer);
-        mpSkinningMatricesBuffer->setBlob(mSkinningMatrices.data(), 0, mpSkinningMatricesBuffer->getSize());
-        mpInvTransposeSkinningMatricesBuffer->setBlob(mInvTransposeSkinningMatrices.data(), 0, mpInvTransposeSkinningMatricesBuffer->getSize());
+        if (initPrev)
+        {
+            mpSkinningMatricesBuffer->setBlob(mSkinningMatrices.data(), 0, mpSkinningMatricesBuffer->getSize());
+            mpInvTransposeSkinningMatricesBuffer->setBlob(mInvTransposeSkinningMatrices.data(), 0, mpInvTransposeSkinningMatricesBuffer->getSize());
+        }
+        else
+        {
+            forEachIndexRange(mChangedMatrixIDs, kMaxUploadGap, [&](uint32_t offset, uint32_t count)
+            {
+                mpSkinningMatricesBuffer->setBlob(&mSkinningMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
+                mpInvTransposeSkinningMatricesBuffer->setBlob(&mInvTransposeSkinningMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
+            });
+        }
 
         // Execute skinning pass.
         auto vars = mpSkinningPass->getRootVar()["gData"];
@@ -99,7 +99,12 @@ namespace Falcor
         /** Mark a scene node as being edited externally.
             Ensures that all global matrices depending on this scene node are updated.
         */
-        void setNodeEdited(size_t nodeID) { mNodesEdited[nodeID] = true; }
+        void setNodeEdited(size_t nodeID)
+        {
+            if (mNodesEdited[nodeID]) return;
+            mNodesEdited[nodeID] = true;
+            mEditedNodeIDs.push_back((uint32_t)nodeID);
+        }
 
         /** Run the animation system.
             \return true if a change occurred, otherwise false.
@@ -110,6 +115,15 @@ namespace Falcor
         */
         bool isMatrixChanged(NodeID matrixID) const { return mMatricesChanged[matrixID.get()]; }
 
+        /** Get the list of matrices that changed since last frame.
+            The list is sorted in ascending order and includes all descendants of changed scene nodes.
+        */
+        const std::vector<uint32_t>& getChangedMatrixIDs() const { return mChangedMatrixIDs; }
+
+        /** Get the number of bytes of matrix data uploaded to the GPU by the last call to animate().
+        */
+        uint64_t getUploadedByteSize() const { return mUploadedByteSize; }
+
         /** Get the local matrices.
             These represent the current local transform for each scene graph node.
         */
@@ -147,6 +161,10 @@ namespace Falcor
         friend class Scene;
 
         void initLocalMatrices();
+        void initNodeChildren();
+        void markMatrixChanged(uint32_t matrixID);
+        void markAllMatricesChanged();
+        void clearChangedMatrices();
         void updateLocalMatrices(double time);
         void updateWorldMatrices(bool updateAll = false);
         void uploadWorldMatrices(bool uploadAll = false);
@@ -165,8 +183,15 @@ namespace Falcor
         std::vector<float4x4> mGlobalMatrices;
         std::vector<float4x4> mInvTransposeGlobalMatrices;
         std::vector<bool> mMatricesChanged;         ///< Flag per matrix, true if matrix changed since last frame.
+        std::vector<uint32_t> mEditedNodeIDs;       ///< List of scene nodes edited since last frame.
+        std::vector<uint32_t> mChangedMatrixIDs;    ///< List of matrices changed since last frame (sorted after updateWorldMatrices()).
+        std::vector<uint32_t> mPrevUploadMatrixIDs; ///< List of matrices uploaded in the previous incremental update. These are stale in the buffers swapped in next.
+        std::vector<uint32_t> mUploadMatrixIDs;     ///< Scratch list of matrices to upload.
+        std::vector<uint32_t> mNodeChildOffsets;    ///< Offsets into mNodeChildren per scene node (size is node count + 1).
+        std::vector<uint32_t> mNodeChildren;        ///< Children of all scene nodes, grouped by parent.
 
         bool mFirstUpdate = true;       ///< True if this is the first update.
+        uint64_t mUploadedByteSize = 0; ///< Bytes of matrix data uploaded in the last call to animate().
         bool mEnabled = true;           ///< True if animations are enabled.
         bool mPrevEnabled = false;      ///< True if animations were enabled in previous frame.
         double mTime = 0.0;             ///< Global time of current frame.
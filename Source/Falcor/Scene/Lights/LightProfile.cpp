@@ -28,20 +28,52 @@
 #include "LightProfile.h"
 #include "Core/Platform/OS.h"
 #include "Core/API/RenderContext.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/DiskCache.h"
 #include "Utils/Logger.h"
-#include "Utils/Algorithm/ParallelReduction.h"
-#include "Core/Pass/ComputePass.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Math/MathConstants.slangh"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <numeric>
 
 namespace Falcor
 {
     namespace
     {
-        const uint32_t kBakeResolution = 256;
+        /** Specifies the current bake cache entry version.
+            This needs to be incremented every time the baking or the entry format changes!
+        */
+        const uint32_t kBakeCacheVersion = 1;
+
+        /** Bake cache directory (subdirectory in the application data directory).
+        */
+        const std::string kBakeCacheDirectory = "NVIDIA/Falcor/LightProfileCache";
+
+        /** Default size budget of the bake cache directory.
+        */
+        const uint64_t kBakeCacheSizeBudget = 1ull * 1024 * 1024 * 1024;
 
-        const char kBakeIesProfileFile[] = "Scene/Lights/BakeIesProfile.cs.slang";
+        const uint32_t kMaxBakeResolution = 8192;
+
+        std::unique_ptr<DiskCache> spBakeCache;
+
+        struct BakeCacheHeader
+        {
+            char magic[8] = {'F', 'a', 'l', 'c', 'o', 'r', 'L', 'P'};
+            uint32_t version = kBakeCacheVersion;
+            uint32_t resolution = 0;
+            float fluxFactor = 0.f;
+            uint32_t reserved = 0;
+
+            bool isValid() const { return std::memcmp(magic, BakeCacheHeader().magic, sizeof(magic)) == 0 && version == kBakeCacheVersion; }
+        };
 
         const char* kSupportedProfiles[] = {
             "IESNA:LM-63-1986",
@@ -179,18 +211,105 @@ namespace Falcor
 
             return IesStatus::Success;
         }
+
+        /** Find the fractional index of an angle in a sorted list of angles. Matches findAngleIndex() in BakeIesProfile.cs.slang.
+        */
+        float findAngleIndex(const float* angles, float angle, int count)
+        {
+            if (count == 1) return 0.f;
+
+            float left;
+            float right = angles[0];
+
+            if (angle <= right) return 0.f;
+
+            for (int i = 1; i < count; i++)
+            {
+                left = right;
+                right = angles[i];
+
+                if (angle >= left && angle <= right)
+                {
+                    return float(i - 1) + ((right > left) ? (angle - left) / (right - left) : 0.f);
+                }
+            }
+
+            return float(count - 1);
+        }
+
+        /** Compute the bake cache key of an IES file.
+        */
+        std::string computeBakeCacheKey(const std::string& fileData, bool normalize, uint32_t bakeResolution)
+        {
+            SHA1 sha1;
+            sha1.update(kBakeCacheVersion);
+            sha1.update(bakeResolution);
+            sha1.update(normalize);
+            sha1.update(std::string_view(fileData));
+            return SHA1::toString(sha1.finalize());
+        }
+
+        bool readBakeCache(const std::string& key, uint32_t bakeResolution, LightProfile::BakedData& bakedData)
+        {
+            DiskCache& cache = LightProfile::getBakeCache();
+            try
+            {
+                return cache.read(key, [&](std::istream& stream)
+                {
+                    BakeCacheHeader header;
+                    stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+                    if (!stream || !header.isValid() || header.resolution != bakeResolution)
+                        FALCOR_THROW("Invalid light profile cache entry.");
+
+                    bakedData.resolution = header.resolution;
+                    bakedData.fluxFactor = header.fluxFactor;
+                    bakedData.texels.resize((size_t)bakeResolution * bakeResolution);
+                    stream.read(reinterpret_cast<char*>(bakedData.texels.data()), bakedData.texels.size() * sizeof(math::float16_t));
+                    if (!stream)
+                        FALCOR_THROW("Truncated light profile cache entry.");
+                });
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Failed to read light profile cache entry '{}': {}", key, e.what());
+                cache.remove(key);
+                return false;
+            }
+        }
+
+        void writeBakeCache(const std::string& key, const LightProfile::BakedData& bakedData)
+        {
+            try
+            {
+                LightProfile::getBakeCache().write(key, [&](std::ostream& stream)
+                {
+                    BakeCacheHeader header;
+                    header.resolution = bakedData.resolution;
+                    header.fluxFactor = bakedData.fluxFactor;
+                    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    stream.write(reinterpret_cast<const char*>(bakedData.texels.data()), bakedData.texels.size() * sizeof(math::float16_t));
+                });
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Failed to write light profile cache entry '{}': {}", key, e.what());
+            }
+        }
     }
 
 
-    LightProfile::LightProfile(ref<Device> pDevice, const std::string& name, const std::vector<float>& rawData)
+    LightProfile::LightProfile(ref<Device> pDevice, const std::string& name, BakedData bakedData, bool fromBakeCache)
         : mpDevice(pDevice)
         , mName(name)
-        , mRawData(rawData)
+        , mBakedData(std::move(bakedData))
+        , mFromBakeCache(fromBakeCache)
     {}
 
-    ref<LightProfile> LightProfile::createFromIesProfile(ref<Device> pDevice, const std::filesystem::path& path, bool normalize)
+    ref<LightProfile> LightProfile::createFromIesProfile(ref<Device> pDevice, const std::filesystem::path& path, bool normalize, uint32_t bakeResolution)
     {
-        std::ifstream ifs(path);
+        FALCOR_CHECK(bakeResolution > 0 && bakeResolution <= kMaxBakeResolution, "Invalid light profile bake resolution {}.", bakeResolution);
+
+        std::ifstream ifs(path, std::ios::binary);
         if (!ifs.good())
         {
             logWarning("Error when loading light profile. Can't open file '{}'", path);
@@ -203,6 +322,17 @@ namespace Falcor
         ifs.seekg(0, std::ios::beg);
         str.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
 
+        std::string name = path.filename().string();
+
+        // Skip parsing and baking if the profile is in the bake cache.
+        const std::string cacheKey = computeBakeCacheKey(str, normalize, bakeResolution);
+        BakedData bakedData;
+        if (readBakeCache(cacheKey, bakeResolution, bakedData))
+        {
+            logDebug("Loaded light profile '{}' from bake cache.", path);
+            return ref<LightProfile>(new LightProfile(pDevice, name, std::move(bakedData), true));
+        }
+
         std::vector<float> numericData;
         float maxCandelas;
         IesStatus status = parseIesFile(str.data(), numericData, maxCandelas);
@@ -219,29 +349,110 @@ namespace Falcor
         // Stash the normalization factor in data[0], we don't use that anyway
         numericData[0] = normalize ? (1.f / maxCandelas) : 1.f;
 
-        std::string name = path.filename().string();
+        bakedData = bakeIesProfile(numericData, bakeResolution);
+        writeBakeCache(cacheKey, bakedData);
+
+        return ref<LightProfile>(new LightProfile(pDevice, name, std::move(bakedData), false));
+    }
+
+    LightProfile::BakedData LightProfile::bakeIesProfile(const std::vector<float>& iesData, uint32_t resolution)
+    {
+        const int headerSize = 13;
+        FALCOR_CHECK(iesData.size() >= headerSize, "Invalid IES data.");
+        const int numVerticalAngles = int(iesData[3]);
+        const int numHorizontalAngles = int(iesData[4]);
+        FALCOR_CHECK(numVerticalAngles > 0 && numHorizontalAngles > 0, "Invalid IES data.");
+        FALCOR_CHECK(iesData.size() == size_t(headerSize + numVerticalAngles + numHorizontalAngles + numVerticalAngles * numHorizontalAngles), "Invalid IES data.");
+
+        const float* verticalAngles = iesData.data() + headerSize;
+        const float* horizontalAngles = verticalAngles + numVerticalAngles;
+        const float* candelaValues = horizontalAngles + numHorizontalAngles;
+        const float lastVerticalAngle = verticalAngles[numVerticalAngles - 1];
+        const float lastHorizontalAngle = horizontalAngles[numHorizontalAngles - 1];
+        const float normalization = iesData[0];
+        const float fluxScale = 2.f * float(M_PI) * float(M_PI) / float(resolution * resolution);
+
+        BakedData bakedData;
+        bakedData.resolution = resolution;
+        bakedData.texels.resize((size_t)resolution * resolution);
+
+        // Each row is a horizontal angle. Rows are baked in parallel, the per-row flux sums are reduced in order for determinism.
+        std::vector<double> rowFlux(resolution, 0.0);
+        NumericRange<uint32_t> rows(0, resolution);
+        std::for_each(std::execution::par, rows.begin(), rows.end(), [&](uint32_t y)
+        {
+            const float rowHorizontalAngle = float(y) * (360.f / float(resolution)) - 180.f;
+            float horizontalAngle = rowHorizontalAngle;
+            if (lastHorizontalAngle <= 180.f)
+            {
+                // Apply symmetry
+                horizontalAngle = std::abs(horizontalAngle);
+                if (lastHorizontalAngle == 90.f && horizontalAngle > 90.f)
+                {
+                    horizontalAngle = 180.f - horizontalAngle;
+                }
+            }
+            else
+            {
+                // No symmetry, but the profile has data in 0..360 degree range, convert our -180..180 range to that
+                if (horizontalAngle < 0.f) horizontalAngle += 360.f;
+            }
+
+            const float horizontalAngleIndex = findAngleIndex(horizontalAngles, horizontalAngle, numHorizontalAngles);
+            const float* h0 = candelaValues + int(std::floor(horizontalAngleIndex)) * numVerticalAngles;
+            const float* h1 = candelaValues + int(std::ceil(horizontalAngleIndex)) * numVerticalAngles;
+            const float hFrac = horizontalAngleIndex - std::floor(horizontalAngleIndex);
+
+            math::float16_t* texels = bakedData.texels.data() + (size_t)y * resolution;
+            double flux = 0.0;
+            for (uint32_t x = 0; x < resolution; x++)
+            {
+                const float verticalAngle = float(x) * (180.f / float(resolution));
+                if (verticalAngle > lastVerticalAngle)
+                {
+                    texels[x] = math::float16_t(0.f);
+                    continue;
+                }
+
+                const float verticalAngleIndex = findAngleIndex(verticalAngles, verticalAngle, numVerticalAngles);
+                const int v0 = int(std::floor(verticalAngleIndex));
+                const int v1 = int(std::ceil(verticalAngleIndex));
+                const float vFrac = verticalAngleIndex - std::floor(verticalAngleIndex);
+
+                const float c0 = h0[v0] + (h0[v1] - h0[v0]) * vFrac;
+                const float c1 = h1[v0] + (h1[v1] - h1[v0]) * vFrac;
+                const float result = (c0 + (c1 - c0) * hFrac) * normalization;
 
-        return ref<LightProfile>(new LightProfile(pDevice, name, numericData));
+                texels[x] = math::float16_t(result);
+
+                // Compute the flux factor for this profile.
+                // The flux factor is the integral of the profile over the directions of the sphere.
+                const float theta = verticalAngle / 180.f * float(M_PI);
+                flux += result * std::sin(theta) * fluxScale;
+            }
+            rowFlux[y] = flux;
+        });
+
+        bakedData.fluxFactor = (float)std::accumulate(rowFlux.begin(), rowFlux.end(), 0.0);
+        return bakedData;
+    }
+
+    DiskCache& LightProfile::getBakeCache()
+    {
+        if (!spBakeCache) setBakeCacheDirectory({});
+        return *spBakeCache;
+    }
+
+    void LightProfile::setBakeCacheDirectory(const std::filesystem::path& directory)
+    {
+        const std::filesystem::path cacheDirectory = directory.empty() ? getAppDataDirectory() / kBakeCacheDirectory : directory;
+        spBakeCache = std::make_unique<DiskCache>(cacheDirectory, kBakeCacheSizeBudget);
     }
 
     void LightProfile::bake(RenderContext* pRenderContext)
     {
-        auto pBakePass = ComputePass::create(mpDevice, kBakeIesProfileFile, "main");
-        auto pBuffer = mpDevice->createTypedBuffer<float>((uint32_t)mRawData.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, mRawData.data());
-        mpTexture = mpDevice->createTexture2D(kBakeResolution, kBakeResolution, ResourceFormat::R16Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
-        auto pFluxTexture = mpDevice->createTexture2D(kBakeResolution, kBakeResolution, ResourceFormat::R32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
-
-        auto var = pBakePass->getRootVar();
-        var["gIesData"] = pBuffer;
-        var["gTexture"] = mpTexture;
-        var["gFluxTexture"] = pFluxTexture;
-        var["CB"]["gBakeResolution"] = kBakeResolution;
-        pBakePass->execute(pRenderContext, kBakeResolution, kBakeResolution);
-
-        float4 fluxFactor;
-        ParallelReduction reduction(mpDevice);
-        reduction.execute<float4>(pRenderContext, pFluxTexture, ParallelReduction::Type::Sum, &fluxFactor);
-        mFluxFactor = fluxFactor.x;
+        const uint32_t resolution = mBakedData.resolution;
+        mpTexture = mpDevice->createTexture2D(resolution, resolution, ResourceFormat::R16Float, 1, 1, mBakedData.texels.data(), ResourceBindFlags::ShaderResource);
 
         Sampler::Desc desc;
         desc.setFilterMode(TextureFilteringMode::Linear, TextureFilteringMode::Linear, TextureFilteringMode::Linear);
@@ -250,7 +461,7 @@ namespace Falcor
 
     void LightProfile::bindShaderData(const ShaderVar& var) const
     {
-        var["fluxFactor"] = mFluxFactor;
+        var["fluxFactor"] = mBakedData.fluxFactor;
         var["texture"] = mpTexture;
         var["sampler"] = mpSampler;
     }
@@ -263,6 +474,7 @@ namespace Falcor
             widget.text("Texture info: " + std::to_string(mpTexture->getWidth()) + "x" + std::to_string(mpTexture->getHeight()) + " (" + to_string(mpTexture->getFormat()) + ")");
             widget.image("Texture", mpTexture.get(), float2(100.f));
         }
-        widget.text("Flux factor: " + std::to_string(mFluxFactor));
+        widget.text("Flux factor: " + std::to_string(mBakedData.fluxFactor));
+        widget.text(mFromBakeCache ? "Loaded from bake cache" : "Baked on load");
     }
 }
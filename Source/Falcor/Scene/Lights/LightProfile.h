@@ -32,6 +32,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Sampler.h"
 #include "Utils/UI/Gui.h"
+#include "Utils/Math/Float16.h"
 
 #include <filesystem>
 #include <string>
@@ -40,15 +41,62 @@
 namespace Falcor
 {
     struct ShaderVar;
+    class DiskCache;
 
     class FALCOR_API LightProfile : public Object
     {
         FALCOR_OBJECT(LightProfile)
     public:
-        static ref<LightProfile> createFromIesProfile(ref<Device> pDevice, const std::filesystem::path& path, bool normalize);
+        static constexpr uint32_t kDefaultBakeResolution = 256;
 
+        /** Light profile baked into a 2D table over (vertical angle, horizontal angle).
+        */
+        struct BakedData
+        {
+            uint32_t resolution = 0;                ///< Width and height of the table.
+            std::vector<math::float16_t> texels;    ///< Normalized candela values in row-major order (rows are horizontal angles).
+            float fluxFactor = 0.f;                 ///< Integral of the profile over the sphere of directions.
+        };
+
+        /** Create a light profile from an IES file.
+            The profile is parsed and baked on the CPU. Baked profiles are stored in an on-disk cache keyed
+            by the content hash of the file, so loading the same profile again skips parsing and baking.
+            \param[in] pDevice GPU device.
+            \param[in] path IES file path.
+            \param[in] normalize Normalize the profile to a maximum value of 1.
+            \param[in] bakeResolution Resolution of the baked profile texture.
+            \return The light profile, or nullptr if loading failed.
+        */
+        static ref<LightProfile> createFromIesProfile(ref<Device> pDevice, const std::filesystem::path& path, bool normalize, uint32_t bakeResolution = kDefaultBakeResolution);
+
+        /** Bake parsed IES data on the CPU. The result matches BakeIesProfile.cs.slang.
+            \param[in] iesData Parsed IES data, with the normalization factor stored in the first element.
+            \param[in] resolution Resolution of the baked table.
+            \return The baked profile.
+        */
+        static BakedData bakeIesProfile(const std::vector<float>& iesData, uint32_t resolution);
+
+        /** Get the on-disk cache of baked light profiles.
+        */
+        static DiskCache& getBakeCache();
+
+        /** Set the directory of the bake cache, e.g. to isolate tests from the user's cache.
+            Must not be called while light profiles are loaded on other threads.
+            \param[in] directory Cache directory. An empty path restores the default directory in the application data directory.
+        */
+        static void setBakeCacheDirectory(const std::filesystem::path& directory);
+
+        /** Create the GPU resources for the baked profile.
+        */
         void bake(RenderContext* pRenderContext);
 
+        const BakedData& getBakedData() const { return mBakedData; }
+        float getFluxFactor() const { return mBakedData.fluxFactor; }
+
+        /** Returns true if the baked profile was loaded from the bake cache.
+        */
+        bool isFromBakeCache() const { return mFromBakeCache; }
+
         /** Set the light profile into a shader var.
         */
         void bindShaderData(const ShaderVar& var) const;
@@ -58,13 +106,13 @@ namespace Falcor
         void renderUI(Gui::Widgets& widget);
 
     private:
-        LightProfile(ref<Device> pDevice, const std::string& name, const std::vector<float>& rawData);
+        LightProfile(ref<Device> pDevice, const std::string& name, BakedData bakedData, bool fromBakeCache);
 
         ref<Device> mpDevice;
         std::string mName;
-        std::vector<float> mRawData;
+        BakedData mBakedData;
+        bool mFromBakeCache = false;
         ref<Texture> mpTexture;
         ref<Sampler> mpSampler;
-        float mFluxFactor = 0.f;
     };
 }
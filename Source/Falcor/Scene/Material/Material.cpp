@@ -168,7 +168,7 @@ namespace Falcor
     bool Material::hasTextureSlotData(const TextureSlot slot) const
     {
         FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
-        return mTextureSlotData[(size_t)slot].pTexture != nullptr;
+        return mTextureSlotData[(size_t)slot].hasData();
     }
 
     bool Material::setTexture(const TextureSlot slot, const ref<Texture>& pTexture)
@@ -179,10 +179,10 @@ namespace Falcor
             return false;
         }
 
-        if (pTexture == getTexture(slot)) return false;
+        if (pTexture == getTexture(slot) && !getUdimTexture(slot)) return false;
 
         FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
-        mTextureSlotData[(size_t)slot].pTexture = pTexture;
+        mTextureSlotData[(size_t)slot] = { pTexture, {} };
 
         markUpdates(UpdateFlags::ResourcesChanged);
         if (slot == TextureSlot::Emissive)
@@ -199,6 +199,35 @@ namespace Falcor
         return mTextureSlotData[(size_t)slot].pTexture;
     }
 
+    bool Material::setUdimTexture(const TextureSlot slot, const TextureManager::CpuTextureHandle& handle)
+    {
+        if (!hasTextureSlot(slot))
+        {
+            logWarning("Material '{}' does not have texture slot '{}'. Ignoring call to setUdimTexture().", getName(), to_string(slot));
+            return false;
+        }
+
+        FALCOR_CHECK(!handle || handle.isUdim(), "Texture handle does not refer to a UDIM texture.");
+        if (handle == getUdimTexture(slot) && !getTexture(slot)) return false;
+
+        FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
+        mTextureSlotData[(size_t)slot] = { nullptr, handle };
+
+        markUpdates(UpdateFlags::ResourcesChanged);
+        if (slot == TextureSlot::Emissive)
+            markUpdates(UpdateFlags::EmissiveChanged);
+
+        return true;
+    }
+
+    TextureManager::CpuTextureHandle Material::getUdimTexture(const TextureSlot slot) const
+    {
+        if (!hasTextureSlot(slot)) return {};
+
+        FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
+        return mTextureSlotData[(size_t)slot].udimHandle;
+    }
+
     bool Material::loadTexture(TextureSlot slot, const std::filesystem::path& path, bool useSrgb)
     {
         if (!hasTextureSlot(slot))
@@ -279,8 +308,18 @@ namespace Falcor
 
     void Material::updateTextureHandle(MaterialSystem* pOwner, const TextureSlot slot, TextureHandle& handle)
     {
-        auto pTexture = getTexture(slot);
-        updateTextureHandle(pOwner, pTexture, handle);
+        // UDIM textures are already managed by the texture manager and bound by handle.
+        if (auto udimHandle = getUdimTexture(slot))
+        {
+            TextureHandle prevHandle = handle;
+            handle = udimHandle.toGpuHandle();
+            if (handle != prevHandle) mUpdates |= Material::UpdateFlags::DataChanged;
+        }
+        else
+        {
+            auto pTexture = getTexture(slot);
+            updateTextureHandle(pOwner, pTexture, handle);
+        }
 
         // The base color texture potentially contains the alpha mask in it's alpha channel.
         // Set it as the alpha texture handle in the material header.
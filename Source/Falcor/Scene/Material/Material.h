@@ -38,6 +38,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Sampler.h"
 #include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Image/TextureManager.h"
 #include "Utils/UI/Gui.h"
 #include "Scene/Transform.h"
 #include "MaterialTypeRegistry.h"
@@ -101,9 +102,10 @@ namespace Falcor
         struct TextureSlotData
         {
             ref<Texture>  pTexture;                           ///< Texture bound to texture slot.
+            TextureManager::CpuTextureHandle udimHandle;      ///< UDIM texture bound to texture slot. Only valid if no texture is bound.
 
-            bool hasData() const { return pTexture != nullptr; }
-            bool operator==(const TextureSlotData& rhs) const { return pTexture == rhs.pTexture; }
+            bool hasData() const { return pTexture != nullptr || udimHandle.isValid(); }
+            bool operator==(const TextureSlotData& rhs) const { return pTexture == rhs.pTexture && udimHandle == rhs.udimHandle; }
             bool operator!=(const TextureSlotData& rhs) const { return !((*this) == rhs); }
         };
 
@@ -257,6 +259,21 @@ namespace Falcor
         */
         virtual ref<Texture> getTexture(const TextureSlot slot) const;
 
+        /** Set a UDIM texture to one of the available texture slots.
+            UDIM textures are owned by the texture manager of the material system and are referenced by handle.
+            This replaces any texture bound with setTexture(). The call is ignored with a warning if the slot doesn't exist.
+            \param[in] slot The texture slot.
+            \param[in] handle Handle to a UDIM texture, or an invalid handle to clear the slot.
+            \return True if the texture slot was changed, false otherwise.
+        */
+        bool setUdimTexture(const TextureSlot slot, const TextureManager::CpuTextureHandle& handle);
+
+        /** Get the UDIM texture of one of the available texture slots.
+            \param[in] The texture slot.
+            \return Handle to the UDIM texture if bound, or an invalid handle if unbound or slot doesn't exist.
+        */
+        TextureManager::CpuTextureHandle getUdimTexture(const TextureSlot slot) const;
+
         /** Optimize texture usage for the given texture slot.
             This function may replace constant textures by uniform material parameters etc.
             \param[in] slot The texture slot.
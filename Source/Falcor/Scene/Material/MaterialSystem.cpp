@@ -483,6 +483,14 @@ namespace Falcor
         updateFlags |= mMaterialUpdates;
         mMaterialUpdates = Material::UpdateFlags::None;
 
+        // Lazily loaded UDIM tiles finish loading and get evicted asynchronously. Rebind the textures if they changed.
+        const uint64_t udimTileChangeCount = mpTextureManager->getUdimTileChangeCount();
+        if (udimTileChangeCount != mUdimTileChangeCount)
+        {
+            updateFlags |= Material::UpdateFlags::ResourcesChanged;
+            mUdimTileChangeCount = udimTileChangeCount;
+        }
+
         // Create parameter block if needed.
         if (!mpMaterialsBlock)
         {
@@ -610,6 +618,9 @@ namespace Falcor
             if (isSpecGloss(pMaterial)) mHasSpecGlossStandardMaterial = true;
         }
 
+        // UDIM tiles are not counted by the materials. The size of the UDIM indirection is an upper bound of their number.
+        mTextureDescCount += mpTextureManager->getUdimIndirectionCount();
+
         FALCOR_CHECK(mMaterialTypes.find(MaterialType::Unknown) == mMaterialTypes.end(), "Unknown material type found. Make sure all material types are registered.");
     }
 
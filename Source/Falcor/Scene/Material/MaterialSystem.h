@@ -282,6 +282,7 @@ namespace Falcor
         bool mBuffersChanged = false;                               ///< Flag indicating if buffers were added/removed since last update.
         bool mTextures3DChanged = false;                            ///< Flag indicating if 3D textures were added/removed since last update.
         bool mMaterialsChanged = false;                             ///< Flag indicating if materials were added/removed since last update. Per-material updates are tracked by each material's update flags.
+        uint64_t mUdimTileChangeCount = 0;                          ///< Number of UDIM tile changes of the texture manager at the last update.
 
         Material::UpdateFlags mMaterialUpdates = Material::UpdateFlags::None; ///< Material updates across all materials since last update.
 
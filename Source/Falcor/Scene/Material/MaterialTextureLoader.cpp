@@ -76,6 +76,12 @@ namespace Falcor
         // Assign textures to materials.
         for (const auto& assignment : mTextureAssignments)
         {
+            // UDIM textures stay with the texture manager and are assigned by handle.
+            if (assignment.handle.isUdim())
+            {
+                assignment.pMaterial->setUdimTexture(assignment.textureSlot, assignment.handle);
+                continue;
+            }
             auto pTexture = mTextureManager.getTexture(assignment.handle);
             assignment.pMaterial->setTexture(assignment.textureSlot, pTexture);
         }
@@ -0,0 +1,278 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RGLBRDFCache.h"
+#include "RGLMaterialData.slang"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    RGLBRDFCache::RGLBRDFCache(uint64_t memoryBudget)
+        : mMemoryBudget(memoryBudget)
+    {}
+
+    RGLBRDFCache& RGLBRDFCache::get()
+    {
+        static RGLBRDFCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const RGLBRDFCache::BRDF> RGLBRDFCache::load(const std::filesystem::path& path)
+    {
+        // Identify the file by path, size and modification time to avoid hashing unchanged files.
+        std::error_code ec;
+        uint64_t fileSize = std::filesystem::file_size(path, ec);
+        if (ec) FALCOR_THROW("Failed to open file");
+        int64_t writeTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        FileKey fileKey{std::filesystem::weakly_canonical(path, ec).string(), fileSize, writeTime};
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (auto digestIt = mFileDigests.find(fileKey); digestIt != mFileDigests.end())
+            {
+                if (auto it = mEntries.find(digestIt->second); it != mEntries.end())
+                {
+                    it->second.lastUse = ++mUseCounter;
+                    mStats.hitCount++;
+                    return it->second.pBRDF;
+                }
+            }
+        }
+
+        // Map and parse the file, then hash the mapped contents. Identical files at different paths share an entry.
+        RGLFile file(path);
+        std::string digest = SHA1::toString(SHA1::compute(file.getFileData(), file.getFileSize()));
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            // Forget digests of previous versions of the file.
+            auto first = mFileDigests.lower_bound(FileKey{fileKey.path, 0, std::numeric_limits<int64_t>::min()});
+            auto last = first;
+            while (last != mFileDigests.end() && last->first.path == fileKey.path) ++last;
+            mFileDigests.erase(first, last);
+            mFileDigests[fileKey] = digest;
+
+            if (auto it = mEntries.find(digest); it != mEntries.end())
+            {
+                it->second.lastUse = ++mUseCounter;
+                mStats.hitCount++;
+                return it->second.pBRDF;
+            }
+        }
+
+        // Build the sampling tables outside of the critical section. The file mapping is released afterwards.
+        std::shared_ptr<const BRDF> pBRDF = preprocess(file, digest);
+        file = RGLFile();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats.missCount++;
+
+        // Another thread may have loaded the same file in the meantime. Keep the existing entry.
+        auto [it, inserted] = mEntries.try_emplace(digest);
+        if (inserted)
+        {
+            it->second.pBRDF = pBRDF;
+            mStats.entryCount++;
+            mStats.sizeInBytes += pBRDF->sizeInBytes;
+        }
+        it->second.lastUse = ++mUseCounter;
+        pBRDF = it->second.pBRDF;
+
+        enforceMemoryBudget(digest);
+
+        return pBRDF;
+    }
+
+    std::shared_ptr<RGLBRDFCache::BRDF> RGLBRDFCache::parse(const std::filesystem::path& path)
+    {
+        RGLFile file(path);
+        std::string digest = SHA1::toString(SHA1::compute(file.getFileData(), file.getFileSize()));
+        return preprocess(file, std::move(digest));
+    }
+
+    std::shared_ptr<RGLBRDFCache::BRDF> RGLBRDFCache::preprocess(const RGLFile& file, std::string digest)
+    {
+        const auto& data = file.data();
+        auto theta = data.thetaI;
+        auto phi   = data.phiI;
+        auto sigma = data.sigma;
+        auto ndf   = data.ndf;
+        auto vndf  = data.vndf;
+        auto lumi  = data.luminance;
+
+        const uint64_t kMaxResolution = RGLMaterialData::kMaxResolution;
+        if (phi->shape[0] > kMaxResolution || theta->shape[0] > kMaxResolution || std::max(sigma->shape[0], sigma->shape[1]) > kMaxResolution
+            || std::max(ndf->shape[0], ndf->shape[1]) > kMaxResolution || std::max(vndf->shape[2], vndf->shape[3]) > kMaxResolution
+            || std::max(lumi->shape[2], lumi->shape[3]) > kMaxResolution)
+        {
+            FALCOR_THROW("Measurement resolution too large");
+        }
+
+        uint4 vndfSize = uint4(uint(phi->shape[0]), uint(theta->shape[0]), uint(vndf->shape[3]), uint(vndf->shape[2]));
+        uint4 lumiSize = uint4(uint(phi->shape[0]), uint(theta->shape[0]), uint(lumi->shape[3]), uint(lumi->shape[2]));
+
+        auto copyField = [](const RGLFile::Field* pField)
+        {
+            const float* pData = reinterpret_cast<const float*>(pField->data);
+            return std::vector<float>(pData, pData + pField->numElems);
+        };
+
+        auto pBRDF = std::make_shared<BRDF>();
+        pBRDF->digest = std::move(digest);
+        pBRDF->description = data.description;
+        pBRDF->phiSize = uint(phi->shape[0]);
+        pBRDF->thetaSize = uint(theta->shape[0]);
+        pBRDF->sigmaSize = uint2(sigma->shape[1], sigma->shape[0]);
+        pBRDF->ndfSize = uint2(ndf->shape[1], ndf->shape[0]);
+        pBRDF->theta = copyField(theta);
+        pBRDF->phi = copyField(phi);
+        pBRDF->sigma = copyField(sigma);
+        pBRDF->ndf = copyField(ndf);
+        pBRDF->rgb = copyField(data.rgb);
+        pBRDF->pVNDFDist = std::make_unique<SamplableDistribution4D>(reinterpret_cast<const float*>(vndf->data), vndfSize);
+        pBRDF->pLumiDist = std::make_unique<SamplableDistribution4D>(reinterpret_cast<const float*>(lumi->data), lumiSize);
+
+        // PDF and conditional CDF have the size of the table, the marginal CDF is smaller by one dimension.
+        auto tableSize = [](uint4 size)
+        {
+            uint64_t sliceCount = uint64_t(size.x) * size.y;
+            return (2 * sliceCount * size.z * size.w + sliceCount * size.w) * sizeof(float);
+        };
+        const size_t fieldElemCount = pBRDF->theta.size() + pBRDF->phi.size() + pBRDF->sigma.size() + pBRDF->ndf.size() + pBRDF->rgb.size();
+        pBRDF->sizeInBytes = fieldElemCount * sizeof(float) + tableSize(vndfSize) + tableSize(lumiSize);
+
+        return pBRDF;
+    }
+
+    std::shared_ptr<const RGLBRDFCache::Buffers> RGLBRDFCache::getBuffers(const ref<Device>& pDevice, const std::shared_ptr<const BRDF>& pBRDF)
+    {
+        FALCOR_ASSERT(pDevice && pBRDF);
+
+        auto findBuffers = [&]() -> std::shared_ptr<const Buffers>
+        {
+            auto it = mEntries.find(pBRDF->digest);
+            if (it == mEntries.end() || it->second.pBRDF != pBRDF) return nullptr;
+            auto bufferIt = it->second.buffers.find(pDevice.get());
+            return bufferIt != it->second.buffers.end() ? bufferIt->second.lock() : nullptr;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (auto pBuffers = findBuffers()) return pBuffers;
+        }
+
+        // Create the buffers outside of the critical section.
+        auto createBuffer = [&](size_t elemCount, const void* pInitData)
+        {
+            return pDevice->createBuffer(elemCount * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, pInitData);
+        };
+        auto prod3 = [](uint4 v) { return size_t(v.x) * v.y * v.z; };
+        auto prod4 = [](uint4 v) { return size_t(v.x) * v.y * v.z * v.w; };
+        uint4 vndfSize = pBRDF->pVNDFDist->getSize();
+        uint4 lumiSize = pBRDF->pLumiDist->getSize();
+
+        auto pBuffers = std::make_shared<Buffers>();
+        pBuffers->pVNDFMarginal    = createBuffer(prod3(vndfSize), pBRDF->pVNDFDist->getMarginal());
+        pBuffers->pLumiMarginal    = createBuffer(prod3(lumiSize), pBRDF->pLumiDist->getMarginal());
+        pBuffers->pVNDFConditional = createBuffer(prod4(vndfSize), pBRDF->pVNDFDist->getConditional());
+        pBuffers->pLumiConditional = createBuffer(prod4(lumiSize), pBRDF->pLumiDist->getConditional());
+
+        pBuffers->pTheta = createBuffer(pBRDF->theta.size(), pBRDF->theta.data());
+        pBuffers->pPhi   = createBuffer(pBRDF->phi  .size(), pBRDF->phi  .data());
+        pBuffers->pSigma = createBuffer(pBRDF->sigma.size(), pBRDF->sigma.data());
+        pBuffers->pNDF   = createBuffer(pBRDF->ndf  .size(), pBRDF->ndf  .data());
+        pBuffers->pVNDF  = createBuffer(prod4(vndfSize), pBRDF->pVNDFDist->getPDF());
+        pBuffers->pLumi  = createBuffer(prod4(lumiSize), pBRDF->pLumiDist->getPDF());
+        pBuffers->pRGB   = createBuffer(pBRDF->rgb  .size(), pBRDF->rgb  .data());
+
+        // Another thread may have created buffers in the meantime. Keep the existing ones so they stay shared.
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (auto pExisting = findBuffers()) return pExisting;
+        auto it = mEntries.find(pBRDF->digest);
+        if (it != mEntries.end() && it->second.pBRDF == pBRDF) it->second.buffers[pDevice.get()] = pBuffers;
+
+        return pBuffers;
+    }
+
+    uint64_t RGLBRDFCache::getMemoryBudget() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMemoryBudget;
+    }
+
+    void RGLBRDFCache::setMemoryBudget(uint64_t memoryBudget)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMemoryBudget = memoryBudget;
+        enforceMemoryBudget({});
+    }
+
+    void RGLBRDFCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries.clear();
+        mFileDigests.clear();
+        mStats.entryCount = 0;
+        mStats.sizeInBytes = 0;
+    }
+
+    RGLBRDFCache::Stats RGLBRDFCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+    void RGLBRDFCache::enforceMemoryBudget(const std::string& keepDigest)
+    {
+        if (mMemoryBudget == 0 || mStats.sizeInBytes <= mMemoryBudget) return;
+
+        // Evict least recently used entries first.
+        std::vector<std::pair<uint64_t, std::string>> candidates;
+        for (const auto& [digest, entry] : mEntries)
+        {
+            if (digest != keepDigest) candidates.emplace_back(entry.lastUse, digest);
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (const auto& [lastUse, digest] : candidates)
+        {
+            if (mStats.sizeInBytes <= mMemoryBudget) break;
+            auto it = mEntries.find(digest);
+            mStats.sizeInBytes -= it->second.pBRDF->sizeInBytes;
+            mStats.entryCount--;
+            mEntries.erase(it);
+            logDebug("RGLBRDFCache: Evicted BRDF {} to fit the memory budget.", digest);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "RGLFile.h"
+#include "RGLCommon.h"
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/API/fwd.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+    /** Process-wide cache of parsed and preprocessed RGL BRDFs.
+
+        Entries are keyed by the SHA-1 digest of the file contents, so all materials referencing the same
+        measurement share a single copy of the parsed fields and sampling tables, even if the files are
+        located at different paths. Entries outlive the materials using them, so reloading a scene doesn't
+        parse the files again. The least recently used entries are evicted once the memory budget is exceeded.
+
+        GPU buffers are shared by all materials on the same device for as long as one of them holds on to them.
+        Sharing buffers also lets the material system deduplicate the buffer slots.
+
+        All operations are thread-safe.
+    */
+    class FALCOR_API RGLBRDFCache
+    {
+    public:
+        /** Parsed and preprocessed BRDF. Immutable once created.
+            The fields needed for rendering are copied out of the file, so the file is not kept open.
+        */
+        struct BRDF
+        {
+            std::string digest;                 ///< SHA-1 digest of the file contents.
+            std::string description;            ///< Description of the measurement.
+            uint32_t phiSize = 0;
+            uint32_t thetaSize = 0;
+            uint2 sigmaSize = uint2(0);
+            uint2 ndfSize = uint2(0);
+            std::vector<float> theta;
+            std::vector<float> phi;
+            std::vector<float> sigma;
+            std::vector<float> ndf;
+            std::vector<float> rgb;
+            std::unique_ptr<SamplableDistribution4D> pVNDFDist;
+            std::unique_ptr<SamplableDistribution4D> pLumiDist;
+            uint64_t sizeInBytes = 0;           ///< Memory footprint of the fields and sampling tables in bytes.
+        };
+
+        /** GPU buffers of a BRDF.
+        */
+        struct Buffers
+        {
+            ref<Buffer> pTheta;
+            ref<Buffer> pPhi;
+            ref<Buffer> pSigma;
+            ref<Buffer> pNDF;
+            ref<Buffer> pVNDF;
+            ref<Buffer> pLumi;
+            ref<Buffer> pRGB;
+            ref<Buffer> pVNDFMarginal;
+            ref<Buffer> pLumiMarginal;
+            ref<Buffer> pVNDFConditional;
+            ref<Buffer> pLumiConditional;
+        };
+
+        struct Stats
+        {
+            uint64_t hitCount = 0;              ///< Number of loads served from the cache.
+            uint64_t missCount = 0;             ///< Number of loads that parsed a file.
+            uint64_t entryCount = 0;            ///< Number of cached BRDFs.
+            uint64_t sizeInBytes = 0;           ///< Total memory footprint of the cached BRDFs in bytes.
+        };
+
+        static constexpr uint64_t kDefaultMemoryBudget = 1ull << 30;
+
+        /** Constructor. Use get() to access the process-wide cache.
+            \param[in] memoryBudget Maximum memory footprint of the cached BRDFs in bytes (0 to disable eviction).
+        */
+        RGLBRDFCache(uint64_t memoryBudget = kDefaultMemoryBudget);
+
+        /** Returns the process-wide cache.
+        */
+        static RGLBRDFCache& get();
+
+        /** Load a BRDF from file.
+            Files are identified by their contents. Unchanged files (same path, size and modification time) are
+            not hashed again. Throws if the file cannot be opened or is not a valid RGL file.
+            \param[in] path Path of the RGL file.
+            \return The parsed and preprocessed BRDF.
+        */
+        std::shared_ptr<const BRDF> load(const std::filesystem::path& path);
+
+        /** Get the GPU buffers of a BRDF, creating them if no material on the given device holds them.
+            The buffers are created outside of the cache lock, so loads on other threads don't wait for the upload.
+            \param[in] pDevice GPU device.
+            \param[in] pBRDF BRDF returned by load().
+            \return The GPU buffers.
+        */
+        std::shared_ptr<const Buffers> getBuffers(const ref<Device>& pDevice, const std::shared_ptr<const BRDF>& pBRDF);
+
+        uint64_t getMemoryBudget() const;
+        void setMemoryBudget(uint64_t memoryBudget);
+
+        /** Remove all entries. BRDFs in use by materials stay alive until released.
+        */
+        void clear();
+
+        Stats getStats() const;
+
+        /** Parse and preprocess a BRDF without caching it.
+            \param[in] path Path of the RGL file.
+            \return The parsed and preprocessed BRDF.
+        */
+        static std::shared_ptr<BRDF> parse(const std::filesystem::path& path);
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<const BRDF> pBRDF;
+            uint64_t lastUse = 0;
+            std::map<const Device*, std::weak_ptr<const Buffers>> buffers;
+        };
+
+        struct FileKey
+        {
+            std::string path;
+            uint64_t size;
+            int64_t writeTime;
+
+            bool operator<(const FileKey& other) const
+            {
+                return std::tie(path, size, writeTime) < std::tie(other.path, other.size, other.writeTime);
+            }
+        };
+
+        static std::shared_ptr<BRDF> preprocess(const RGLFile& file, std::string digest);
+        void enforceMemoryBudget(const std::string& keepDigest);
+
+        mutable std::mutex mMutex;
+        std::unordered_map<std::string, Entry> mEntries;    ///< Cached BRDFs indexed by digest.
+        std::map<FileKey, std::string> mFileDigests;        ///< Digests of previously loaded files.
+        uint64_t mMemoryBudget;
+        uint64_t mUseCounter = 0;
+        Stats mStats;
+    };
+}
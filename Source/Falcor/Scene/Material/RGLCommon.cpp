@@ -27,6 +27,9 @@
  **************************************************************************/
 #include "RGLCommon.h"
 #include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
 
 namespace Falcor
 {
@@ -42,10 +45,17 @@ namespace Falcor
         std::memcpy(mPDF.get(), pdf, N * sizeof(float));
 
         uint32_t sliceStride = size.z * size.w;
-        for (uint32_t i = 0; i < N; i += sliceStride)
-        {
-            build2DSlice(int2(size.z, size.w), mPDF.get() + i, mMarginal.get() + i / size.z, mConditional.get() + i);
-        }
+        NumericRange<uint32_t> sliceRange(0, size.x * size.y);
+        std::for_each(
+            std::execution::par,
+            sliceRange.begin(),
+            sliceRange.end(),
+            [&](uint32_t slice)
+            {
+                uint32_t i = slice * sliceStride;
+                build2DSlice(int2(size.z, size.w), mPDF.get() + i, mMarginal.get() + i / size.z, mConditional.get() + i);
+            }
+        );
     }
 
     void SamplableDistribution4D::build2DSlice(int2 size, float* pdf, float* marginalCDF, float* conditionalCDF)
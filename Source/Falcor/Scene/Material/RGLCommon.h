@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Core/Macros.h"
 #include "Utils/Math/Vector.h"
 #include <memory>
 
@@ -45,20 +46,23 @@ namespace Falcor
         Pharr et al., with the only twist is that the PDF is linearly
         interpolated, i.e. the CDFs store the integral of a linearly
         interpolated PDF instead of the straight sum of the PDF.
+        The 2D slices are independent and built in parallel.
 
         The actual interpolation/sampling at runtime happens on the GPU
         (see RGLCommon.slang)
     */
-    class SamplableDistribution4D
+    class FALCOR_API SamplableDistribution4D
     {
     public:
         SamplableDistribution4D(const float* pdf, uint4 size);
 
-        const float* getPDF()         { return mPDF.get();         }
+        const float* getPDF()         const { return mPDF.get();         }
 
-        const float* getMarginal()    { return mMarginal.get();    }
+        const float* getMarginal()    const { return mMarginal.get();    }
 
-        const float* getConditional() { return mConditional.get(); }
+        const float* getConditional() const { return mConditional.get(); }
+
+        uint4 getSize() const { return mSize; }
 
     private:
         uint4 mSize;
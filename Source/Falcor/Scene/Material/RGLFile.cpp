@@ -27,6 +27,8 @@
  **************************************************************************/
 #include "RGLFile.h"
 #include "Core/Error.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include <cstring>
 
 namespace Falcor
 {
@@ -63,8 +65,9 @@ namespace Falcor
         size_t N = fieldSize(type);
         if (N == 0) FALCOR_THROW("RGLFile::fieldSize: Invalid field type");
 
-        field.data.reset(new uint8_t[N * field.numElems]);
-        std::memcpy(field.data.get(), data, N * field.numElems);
+        field.storage.reset(new uint8_t[N * field.numElems]);
+        std::memcpy(field.storage.get(), data, N * field.numElems);
+        field.data = field.storage.get();
 
         mFieldMap[name] = int(mFields.size());
         mFields.emplace_back(std::move(field));
@@ -128,19 +131,56 @@ namespace Falcor
         }
 
         bool isotropic = phiI->shape[0] <= 2;
-        std::string descString(reinterpret_cast<const char*>(description->data.get()), description->numElems);
+        std::string descString(reinterpret_cast<const char*>(description->data), description->numElems);
 
         mMeasurement = MeasurementData{thetaI, phiI, sigma, ndf, vndf, rgb, luminance, isotropic, std::move(descString)};
     }
 
+    RGLFile::RGLFile() = default;
+    RGLFile::RGLFile(RGLFile&&) = default;
+    RGLFile& RGLFile::operator=(RGLFile&&) = default;
+    RGLFile::~RGLFile() = default;
+
     RGLFile::RGLFile(std::ifstream& in)
     {
+        in.seekg(0, std::ios_base::end);
+        std::streamoff size = in.tellg();
+        in.seekg(0, std::ios_base::beg);
+        if (!in.good() || size < 0) FALCOR_THROW("Error reading RGL file");
+
+        mFileSize = size_t(size);
+        mpStreamData.reset(new uint8_t[mFileSize]);
+        in.read(reinterpret_cast<char*>(mpStreamData.get()), mFileSize);
+        if (!in.good()) FALCOR_THROW("Error reading RGL file: File truncated");
+        mpFileData = mpStreamData.get();
+
+        parse();
+        validate();
+    }
+
+    RGLFile::RGLFile(const std::filesystem::path& path)
+    {
+        mpMappedFile = std::make_unique<MemoryMappedFile>(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+        if (!mpMappedFile->isOpen()) FALCOR_THROW("Failed to open file");
+
+        mpFileData = reinterpret_cast<const uint8_t*>(mpMappedFile->getData());
+        mFileSize = mpMappedFile->getMappedSize();
+
+        parse();
+        validate();
+    }
+
+    void RGLFile::parse()
+    {
+        size_t pos = 0;
         auto readBytes = [&](void* dst, size_t size)
         {
-            in.read(reinterpret_cast<char*>(dst), size);
+            if (size > mFileSize - pos) FALCOR_THROW("Error parsing RGL file: File truncated");
+            std::memcpy(dst, mpFileData + pos, size);
+            pos += size;
         };
 
-        uint8_t header[12];
+        char header[12];
         readBytes(header, 12);
 
         uint8_t version[2];
@@ -149,7 +189,7 @@ namespace Falcor
         uint32_t fieldCount;
         readBytes(&fieldCount, 4);
 
-        if (strcmp(reinterpret_cast<const char*>(header), "tensor_file"))
+        if (std::memcmp(header, "tensor_file", 12))
         {
             FALCOR_THROW("Invalid file header");
         }
@@ -164,7 +204,7 @@ namespace Falcor
             readBytes(&nameLength, 2);
 
             std::string fieldName(nameLength, '\0');
-            readBytes(&fieldName[0], nameLength);
+            readBytes(fieldName.data(), nameLength);
 
             uint16_t fieldDim;
             readBytes(&fieldDim, 2);
@@ -180,9 +220,7 @@ namespace Falcor
             field.type = FieldType(fieldType);
             field.dim = fieldDim;
             field.shape.reset(new uint64_t[fieldDim]);
-            readBytes(field.shape.get(), 8 * fieldDim);
-
-            if (!in.good()) FALCOR_THROW("Error parsing RGL field: File truncated");
+            readBytes(field.shape.get(), 8 * size_t(fieldDim));
 
             size_t elemSize = fieldSize(FieldType(fieldType));
             if (elemSize == 0)
@@ -191,25 +229,31 @@ namespace Falcor
                 continue;
             }
 
+            // Validate the data block lies within the file. The element count is bounded by the file size to avoid overflows.
             uint64_t N = 1;
             for (uint32_t j = 0; j < fieldDim; ++j)
             {
+                if (field.shape[j] != 0 && N > mFileSize / field.shape[j]) FALCOR_THROW("Error parsing RGL field '{}': Invalid shape", fieldName);
                 N *= field.shape[j];
             }
+            if (offset > mFileSize || N > (mFileSize - offset) / elemSize)
+            {
+                FALCOR_THROW("Error parsing RGL field '{}': Data out of bounds", fieldName);
+            }
             field.numElems = N;
 
-            field.data.reset(new uint8_t[N * elemSize]);
-
-            uint64_t pos = in.tellg();
-            in.seekg(offset);
-            readBytes(field.data.get(), N * elemSize);
-            in.seekg(pos);
+            // Reference the data in place. Misaligned data is copied, as it's accessed through typed pointers.
+            field.data = mpFileData + offset;
+            if (reinterpret_cast<uintptr_t>(field.data) % elemSize != 0)
+            {
+                field.storage.reset(new uint8_t[N * elemSize]);
+                std::memcpy(field.storage.get(), field.data, N * elemSize);
+                field.data = field.storage.get();
+            }
 
             mFieldMap.insert(std::make_pair(std::string(fieldName), int(mFields.size())));
             mFields.emplace_back(std::move(field));
         }
-
-        validate();
     }
 
     template<typename T>
@@ -263,7 +307,7 @@ namespace Falcor
         for (size_t i = 0; i < mFields.size(); ++i)
         {
             size_t length = mFields[i].numElems * fieldSize(mFields[i].type);
-            write(out, mFields[i].data.get(), length);
+            write(out, mFields[i].data, length);
             write(out, zeros, alignAddress(length) - length);
         }
     }
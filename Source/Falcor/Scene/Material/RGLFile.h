@@ -26,6 +26,9 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
 #include <memory>
 #include <string>
@@ -34,9 +37,14 @@
 
 namespace Falcor
 {
+    class MemoryMappedFile;
+
     /** Class representing a measured material file from the RGL BRDF database.
+
+        Files loaded from disk are memory mapped and the field data is referenced in place,
+        so parsing doesn't copy any of the (potentially large) measurement tables.
     */
-    class RGLFile
+    class FALCOR_API RGLFile
     {
     public:
         /** There are many more field types, but none that we need. Ignore all other types.
@@ -55,7 +63,8 @@ namespace Falcor
             uint32_t dim;
             int64_t numElems;
             std::unique_ptr<uint64_t[]> shape;
-            std::unique_ptr<uint8_t[]> data;
+            const uint8_t* data = nullptr;          ///< Field data. Points into the file contents or into 'storage'.
+            std::unique_ptr<uint8_t[]> storage;     ///< Owned copy of the field data, if it can't be referenced in place.
         };
 
         /** Collected set of fields necessary to render the BRDF.
@@ -73,12 +82,21 @@ namespace Falcor
             std::string description;
         };
 
-        RGLFile() = default;
+        RGLFile();
+        RGLFile(RGLFile&&);
+        RGLFile& operator=(RGLFile&&);
+        ~RGLFile();
 
-        /** Loads RGL measured BRDF file and validates contents. Throws Falcor::Exception on failure.
+        /** Loads RGL measured BRDF file from a stream and validates contents. Throws Falcor::Exception on failure.
+            The stream is read to the end into memory owned by this object.
         */
         RGLFile(std::ifstream& in);
 
+        /** Loads RGL measured BRDF file through a memory mapping and validates contents. Throws Falcor::Exception on failure.
+            The mapping is kept open for the lifetime of this object and field data is referenced in place.
+        */
+        RGLFile(const std::filesystem::path& path);
+
         void saveFile(std::ofstream& out) const;
 
         const MeasurementData& data() const
@@ -86,6 +104,11 @@ namespace Falcor
             return mMeasurement;
         }
 
+        /** Returns the raw file contents the fields were parsed from, or nullptr if the file was built with addField().
+        */
+        const uint8_t* getFileData() const { return mpFileData; }
+        size_t getFileSize() const { return mFileSize; }
+
         void addField(const std::string& name, FieldType type, const std::vector<uint32_t>& shape, const void* data);
 
     private:
@@ -93,6 +116,16 @@ namespace Falcor
         std::vector<Field> mFields;
         MeasurementData mMeasurement;
 
+        std::unique_ptr<MemoryMappedFile> mpMappedFile; ///< Mapped file contents, if loaded from a path.
+        std::unique_ptr<uint8_t[]> mpStreamData;        ///< File contents, if loaded from a stream.
+        const uint8_t* mpFileData = nullptr;
+        size_t mFileSize = 0;
+
+        /** Parses the field descriptors of the file contents in mpFileData.
+            All reads are bounds checked. Throws Falcor::Exception on malformed or truncated files.
+        */
+        void parse();
+
         /** Make sure all required fields are present and have correct shape and dimensions,
             then populates mMeasurement field if all fields are correct.
             Throws Falcor::Exception on validation error.
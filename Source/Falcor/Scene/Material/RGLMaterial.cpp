@@ -26,15 +26,12 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "RGLMaterial.h"
-#include "RGLFile.h"
-#include "RGLCommon.h"
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/Image/ImageIO.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "GlobalState.h"
 #include "Rendering/Materials/BSDFIntegrator.h"
-#include <fstream>
 
 namespace Falcor
 {
@@ -147,78 +144,46 @@ namespace Falcor
 
     bool RGLMaterial::loadBRDF(const std::filesystem::path& path)
     {
-        std::ifstream ifs(path, std::ios_base::in | std::ios_base::binary);
-        if (!ifs.good())
-        {
-            logWarning("RGLMaterial::loadBRDF() - Failed to open file '{}'.", path);
-            return false;
-        }
-
-        std::unique_ptr<RGLFile> file;
+        // Parsed files and their sampling tables are shared through the cache.
+        std::shared_ptr<const RGLBRDFCache::BRDF> pBRDF;
         try
         {
-            file.reset(new RGLFile(ifs));
-        }
-        catch(const RuntimeError& e)
-        {
-            logWarning("RGLMaterial::loadBRDF() - Failed to parse RGL file '{}': {}.", path, e.what());
-            return false;
-        }
-
-        if (!ifs.good())
-        {
-            logWarning("RGLMaterial::loadBRDF() - Failed to load BRDF data from file '{}': Read error.", path);
-            return false;
+            pBRDF = RGLBRDFCache::get().load(path);
         }
-
-        auto theta = file->data().thetaI;
-        auto phi   = file->data().phiI;
-        auto sigma = file->data().sigma;
-        auto ndf   = file->data().ndf;
-        auto vndf  = file->data().vndf;
-        auto lumi  = file->data().luminance;
-        auto rgb   = file->data().rgb;
-
-        const uint64_t kMaxResolution = RGLMaterialData::kMaxResolution;
-        if (phi->shape[0] > kMaxResolution || theta->shape[0] > kMaxResolution || std::max(sigma->shape[0], sigma->shape[1]) > kMaxResolution
-            || std::max(ndf->shape[0], ndf->shape[1]) > kMaxResolution || std::max(vndf->shape[2], vndf->shape[3]) > kMaxResolution
-            || std::max(lumi->shape[2], lumi->shape[3]) > kMaxResolution)
+        catch (const RuntimeError& e)
         {
-            logWarning("RGLMaterial::loadBRDF() - Failed to process BRDF data: Measurement resolution too large.", path);
+            logWarning("RGLMaterial::loadBRDF() - Failed to load RGL file '{}': {}.", path, e.what());
             return false;
         }
 
         mPath = path;
         mBRDFName = std::filesystem::path(path).stem().string();
-        mBRDFDescription = file->data().description;
-
-        mData.phiSize = uint(phi->shape[0]);
-        mData.thetaSize = uint(theta->shape[0]);
-        mData.sigmaSize = uint2(sigma->shape[1], sigma->shape[0]);
-        mData.  ndfSize = uint2(ndf  ->shape[1], ndf  ->shape[0]);
-        mData. vndfSize = uint2(vndf ->shape[3], vndf ->shape[2]);
-        mData. lumiSize = uint2(lumi ->shape[3], lumi ->shape[2]);
-
-        uint4 vndfSize = uint4(mData.phiSize, mData.thetaSize, mData.vndfSize.x, mData.vndfSize.y);
-        uint4 lumiSize = uint4(mData.phiSize, mData.thetaSize, mData.lumiSize.x, mData.lumiSize.y);
-        auto prod3 = [&](uint4 v) { return v.x * v.y * v.z; };
-        auto prod4 = [&](uint4 v) { return v.x * v.y * v.z * v.w; };
-
-        SamplableDistribution4D vndfDist(reinterpret_cast<float*>(vndf->data.get()), vndfSize);
-        SamplableDistribution4D lumiDist(reinterpret_cast<float*>(lumi->data.get()), lumiSize);
-
-        mpVNDFMarginalBuf    = mpDevice->createBuffer(prod3(vndfSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, vndfDist.getMarginal());
-        mpLumiMarginalBuf    = mpDevice->createBuffer(prod3(lumiSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, lumiDist.getMarginal());
-        mpVNDFConditionalBuf = mpDevice->createBuffer(prod4(vndfSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, vndfDist.getConditional());
-        mpLumiConditionalBuf = mpDevice->createBuffer(prod4(lumiSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, lumiDist.getConditional());
-
-        mpThetaBuf = mpDevice->createBuffer(theta->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, theta->data.get());
-        mpPhiBuf   = mpDevice->createBuffer(phi  ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, phi  ->data.get());
-        mpSigmaBuf = mpDevice->createBuffer(sigma->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, sigma->data.get());
-        mpNDFBuf   = mpDevice->createBuffer(ndf  ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, ndf  ->data.get());
-        mpVNDFBuf  = mpDevice->createBuffer(vndf ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, vndfDist.getPDF());
-        mpLumiBuf  = mpDevice->createBuffer(lumi ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, lumiDist.getPDF());
-        mpRGBBuf   = mpDevice->createBuffer(rgb  ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, rgb  ->data.get());
+        mBRDFDescription = pBRDF->description;
+
+        const uint4 vndfSize = pBRDF->pVNDFDist->getSize();
+        const uint4 lumiSize = pBRDF->pLumiDist->getSize();
+        mData.phiSize = pBRDF->phiSize;
+        mData.thetaSize = pBRDF->thetaSize;
+        mData.sigmaSize = pBRDF->sigmaSize;
+        mData.  ndfSize = pBRDF->ndfSize;
+        mData. vndfSize = uint2(vndfSize.z, vndfSize.w);
+        mData. lumiSize = uint2(lumiSize.z, lumiSize.w);
+
+        mpBRDF = pBRDF;
+        mpBuffers = RGLBRDFCache::get().getBuffers(mpDevice, pBRDF);
+
+        mpVNDFMarginalBuf    = mpBuffers->pVNDFMarginal;
+        mpLumiMarginalBuf    = mpBuffers->pLumiMarginal;
+        mpVNDFConditionalBuf = mpBuffers->pVNDFConditional;
+        mpLumiConditionalBuf = mpBuffers->pLumiConditional;
+
+        mpThetaBuf = mpBuffers->pTheta;
+        mpPhiBuf   = mpBuffers->pPhi;
+        mpSigmaBuf = mpBuffers->pSigma;
+        mpNDFBuf   = mpBuffers->pNDF;
+        mpVNDFBuf  = mpBuffers->pVNDF;
+        mpLumiBuf  = mpBuffers->pLumi;
+        mpRGBBuf   = mpBuffers->pRGB;
 
         markUpdates(Material::UpdateFlags::ResourcesChanged);
 
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Material.h"
+#include "RGLBRDFCache.h"
 #include "RGLMaterialData.slang"
 #include <filesystem>
 
@@ -68,6 +69,8 @@ namespace Falcor
         std::string mBRDFDescription;       ///< Description of the BRDF given in the BRDF file.
 
         bool mBRDFUploaded = false;         ///< True if BRDF data buffers have been uploaded to the material system.
+        std::shared_ptr<const RGLBRDFCache::BRDF> mpBRDF;       ///< Parsed BRDF, shared with all materials using the same file contents.
+        std::shared_ptr<const RGLBRDFCache::Buffers> mpBuffers; ///< BRDF buffers, shared with all materials using the same file contents.
         RGLMaterialData mData;              ///< Material parameters.
         ref<Buffer> mpThetaBuf;
         ref<Buffer> mpPhiBuf;
@@ -39,18 +39,22 @@
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Core/API/IndirectCommands.h"
+#include "Core/API/PythonHelpers.h"
 #include "Utils/StringUtils.h"
 #include "Utils/ObjectIDPython.h"
+#include "Utils/Algorithm/IndexRanges.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Timing/Profiler.h"
 #include "Utils/UI/InputTypes.h"
 #include "Utils/Scripting/ScriptWriter.h"
+#include "Utils/Scripting/ndarray.h"
 #include "Utils/NumericRange.h"
 
 #include <fstream>
 #include <numeric>
+#include <set>
 #include <sstream>
 #include <algorithm>
 #include <execution>
@@ -85,6 +89,8 @@ namespace Falcor
         const std::string kGridVolumesBufferName = "gridVolumes";
 
         const std::string kStats = "stats";
+        const std::string kUpdateStats = "updateStats";
+        const std::string kResetUpdateStats = "resetUpdateStats";
         const std::string kBounds = "bounds";
         const std::string kAnimations = "animations";
         const std::string kLoopAnimations = "loopAnimations";
@@ -145,6 +151,9 @@ namespace Falcor
         {
             return determinant(float3x3(m)) < 0.f;
         }
+
+        // Maximum number of unchanged geometry instances to include in a single upload range.
+        const uint32_t kMaxInstanceUploadGap = 32;
     }
 
     const FileDialogFilterVec& Scene::getFileExtensionFilters()
@@ -914,43 +923,97 @@ namespace Falcor
         }
     }
 
-    void Scene::updateGeometryInstances(bool forceUpdate)
+    void Scene::createMatrixInstanceMap()
     {
-        if (mGeometryInstanceData.empty()) return;
+        // Build a compact list of geometry instances per global matrix, used to find moved instances without visiting all instances.
+        size_t matrixCount = mpAnimationController->getGlobalMatrices().size();
+        mMatrixInstanceOffsets.assign(matrixCount + 1, 0);
+        for (const auto& inst : mGeometryInstanceData)
+        {
+            FALCOR_ASSERT(inst.globalMatrixID < matrixCount);
+            mMatrixInstanceOffsets[inst.globalMatrixID + 1]++;
+        }
+        for (size_t i = 0; i < matrixCount; i++) mMatrixInstanceOffsets[i + 1] += mMatrixInstanceOffsets[i];
 
-        bool dataChanged = false;
-        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+        mMatrixInstanceIDs.resize(mGeometryInstanceData.size());
+        std::vector<uint32_t> instanceCount(matrixCount, 0);
+        for (uint32_t instanceID = 0; instanceID < (uint32_t)mGeometryInstanceData.size(); instanceID++)
+        {
+            uint32_t matrixID = mGeometryInstanceData[instanceID].globalMatrixID;
+            mMatrixInstanceIDs[mMatrixInstanceOffsets[matrixID] + instanceCount[matrixID]++] = instanceID;
+        }
+    }
 
-        for (auto& inst : mGeometryInstanceData)
+    void Scene::updateMovedGeometryInstanceIDs()
+    {
+        mMovedGeometryInstanceIDs.clear();
+        for (uint32_t matrixID : mpAnimationController->getChangedMatrixIDs())
         {
-            if (inst.getType() == GeometryType::TriangleMesh || inst.getType() == GeometryType::DisplacedTriangleMesh)
+            for (uint32_t i = mMatrixInstanceOffsets[matrixID]; i < mMatrixInstanceOffsets[matrixID + 1]; i++)
             {
-                uint32_t prevFlags = inst.flags;
+                mMovedGeometryInstanceIDs.push_back(mMatrixInstanceIDs[i]);
+            }
+        }
+        std::sort(mMovedGeometryInstanceIDs.begin(), mMovedGeometryInstanceIDs.end());
+    }
 
-                FALCOR_ASSERT(inst.globalMatrixID < globalMatrices.size());
-                const float4x4& transform = globalMatrices[inst.globalMatrixID];
-                bool isTransformFlipped = doesTransformFlip(transform);
-                bool isObjectFrontFaceCW = getMesh(MeshID::fromSlang(inst.geometryID)).isFrontFaceCW();
-                bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
+    bool Scene::updateGeometryInstanceFlags(GeometryInstanceData& inst, const float4x4& transform) const
+    {
+        if (inst.getType() != GeometryType::TriangleMesh && inst.getType() != GeometryType::DisplacedTriangleMesh) return false;
 
-                if (isTransformFlipped) inst.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
+        uint32_t prevFlags = inst.flags;
 
-                if (isObjectFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+        bool isTransformFlipped = doesTransformFlip(transform);
+        bool isObjectFrontFaceCW = getMesh(MeshID::fromSlang(inst.geometryID)).isFrontFaceCW();
+        bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
 
-                if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
-                else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+        if (isTransformFlipped) inst.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
+        else inst.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
 
-                dataChanged |= (inst.flags != prevFlags);
-            }
-        }
+        if (isObjectFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+        else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
 
-        if (forceUpdate || dataChanged)
+        if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+        else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+
+        return inst.flags != prevFlags;
+    }
+
+    void Scene::updateGeometryInstances(bool forceUpdate)
+    {
+        if (mGeometryInstanceData.empty()) return;
+
+        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+
+        if (forceUpdate)
         {
+            for (auto& inst : mGeometryInstanceData)
+            {
+                FALCOR_ASSERT(inst.globalMatrixID < globalMatrices.size());
+                updateGeometryInstanceFlags(inst, globalMatrices[inst.globalMatrixID]);
+            }
+
             uint32_t byteSize = (uint32_t)(mGeometryInstanceData.size() * sizeof(GeometryInstanceData));
             mpGeometryInstancesBuffer->setBlob(mGeometryInstanceData.data(), 0, byteSize);
+            mUpdateStats.addObjects(SceneUpdateStats::Stage::GeometryInstances, mGeometryInstanceData.size());
+            mUpdateStats.addUpload(SceneUpdateStats::Stage::GeometryInstances, byteSize);
+            return;
+        }
+
+        // Only instances whose transform changed need to be updated. Upload the ones whose data changed.
+        mChangedGeometryInstanceIDs.clear();
+        for (uint32_t instanceID : mMovedGeometryInstanceIDs)
+        {
+            auto& inst = mGeometryInstanceData[instanceID];
+            if (updateGeometryInstanceFlags(inst, globalMatrices[inst.globalMatrixID])) mChangedGeometryInstanceIDs.push_back(instanceID);
         }
+
+        mUpdateStats.addObjects(SceneUpdateStats::Stage::GeometryInstances, mMovedGeometryInstanceIDs.size());
+        forEachIndexRange(mChangedGeometryInstanceIDs, kMaxInstanceUploadGap, [&](uint32_t offset, uint32_t count)
+        {
+            mpGeometryInstancesBuffer->setBlob(&mGeometryInstanceData[offset], offset * sizeof(GeometryInstanceData), count * sizeof(GeometryInstanceData));
+            mUpdateStats.addUpload(SceneUpdateStats::Stage::GeometryInstances, count * sizeof(GeometryInstanceData));
+        });
     }
 
     Scene::UpdateFlags Scene::updateRaytracingAABBData(bool forceUpdate)
@@ -1038,6 +1101,8 @@ namespace Falcor
         {
             mpRtAABBBuffer = mpDevice->createStructuredBuffer(sizeof(RtAABB), (uint32_t)mRtAABBRaw.size(), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal, mRtAABBRaw.data(), false);
             mpRtAABBBuffer->setName("Scene::mpRtAABBBuffer");
+            mUpdateStats.addBufferRecreated(SceneUpdateStats::Stage::Geometry);
+            mUpdateStats.addUpload(SceneUpdateStats::Stage::Geometry, mpRtAABBBuffer->getSize());
 
             // Bind the new buffer to the scene.
             FALCOR_ASSERT(mpSceneBlock);
@@ -1052,6 +1117,8 @@ namespace Falcor
             size_t offset = firstUpdated * sizeof(RtAABB);
             bytes = (lastUpdated - firstUpdated) * sizeof(RtAABB);
             mpRtAABBBuffer->setBlob(mRtAABBRaw.data() + firstUpdated, offset, bytes);
+            mUpdateStats.addObjects(SceneUpdateStats::Stage::Geometry, lastUpdated - firstUpdated);
+            mUpdateStats.addUpload(SceneUpdateStats::Stage::Geometry, bytes);
         }
 
         return flags;
@@ -1146,6 +1213,7 @@ namespace Falcor
             if (pSDFGrid->mpDevice != mpDevice)
                 FALCOR_THROW("SDFGrid '{}' was created with a different device than the Scene", pSDFGrid->getName());
             SDFGrid::UpdateFlags sdfGridUpdateFlags = pSDFGrid->update(pRenderContext);
+            if (sdfGridUpdateFlags != SDFGrid::UpdateFlags::None) mUpdateStats.addObjects(SceneUpdateStats::Stage::SDFGrids, 1);
 
             if (is_set(sdfGridUpdateFlags, SDFGrid::UpdateFlags::AABBsChanged))
             {
@@ -1159,6 +1227,7 @@ namespace Falcor
 
             if (is_set(sdfGridUpdateFlags, SDFGrid::UpdateFlags::BuffersReallocated))
             {
+                mUpdateStats.addBufferRecreated(SceneUpdateStats::Stage::SDFGrids);
                 updateGeometryStats();
                 pSDFGrid->bindShaderData(sdfGridsVar[sdfGridID]);
                 updateFlags |= Scene::UpdateFlags::SDFGeometryChanged;
@@ -1186,6 +1255,8 @@ namespace Falcor
                 {
                     mpCustomPrimitivesBuffer = mpDevice->createStructuredBuffer(var[kCustomPrimitiveBufferName], (uint32_t)mCustomPrimitiveDesc.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, mCustomPrimitiveDesc.data(), false);
                     mpCustomPrimitivesBuffer->setName("Scene::mpCustomPrimitivesBuffer");
+                    mUpdateStats.addBufferRecreated(SceneUpdateStats::Stage::Geometry);
+                    mUpdateStats.addUpload(SceneUpdateStats::Stage::Geometry, mpCustomPrimitivesBuffer->getSize());
 
                     // Bind the buffer to the scene.
                     FALCOR_ASSERT(mpSceneBlock);
@@ -1196,6 +1267,7 @@ namespace Falcor
                     size_t bytes = sizeof(CustomPrimitiveDesc) * mCustomPrimitiveDesc.size();
                     FALCOR_ASSERT(mpCustomPrimitivesBuffer && mpCustomPrimitivesBuffer->getSize() >= bytes);
                     mpCustomPrimitivesBuffer->setBlob(mCustomPrimitiveDesc.data(), 0, bytes);
+                    mUpdateStats.addUpload(SceneUpdateStats::Stage::Geometry, bytes);
                 }
             }
 
@@ -1273,6 +1345,7 @@ namespace Falcor
 
         mpAnimationController->animate(pRenderContext, 0); // Requires Scene block to exist
         updateGeometry(pRenderContext, true); // Requires scene defines
+        createMatrixInstanceMap();
         updateGeometryInstances(true);
 
         updateBounds();
@@ -1600,6 +1673,7 @@ namespace Falcor
         if (mCameraSwitched || cameraChanges != Camera::Changes::None)
         {
             bindSelectedCamera();
+            mUpdateStats.addObjects(SceneUpdateStats::Stage::Camera, 1);
             if (is_set(cameraChanges, Camera::Changes::Movement)) flags |= UpdateFlags::CameraMoved;
             if ((cameraChanges & (~Camera::Changes::Movement)) != Camera::Changes::None) flags |= UpdateFlags::CameraPropertiesChanged;
             if (mCameraSwitched) flags |= UpdateFlags::CameraSwitched;
@@ -1625,25 +1699,38 @@ namespace Falcor
         }
 
         // Update changed lights.
+        // The light data is gathered on the CPU and the range of changed lights is uploaded at once.
         uint32_t activeLightIndex = 0;
+        uint32_t firstChanged = std::numeric_limits<uint32_t>::max();
+        uint32_t lastChanged = 0;
         mActiveLights.clear();
+        mActiveLightData.clear();
 
         for (const auto& light : mLights)
         {
             if (!light->isActive()) continue;
 
             mActiveLights.push_back(light);
+            mActiveLightData.push_back(light->getData());
 
             auto changes = light->getChanges();
             if (changes != Light::Changes::None || is_set(combinedChanges, Light::Changes::Active) || forceUpdate)
             {
-                // TODO: This is slow since the buffer is not CPU writable. Copy into CPU buffer and upload once instead.
-                mpLightsBuffer->setElement(activeLightIndex, light->getData());
+                firstChanged = std::min(firstChanged, activeLightIndex);
+                lastChanged = activeLightIndex;
             }
 
             activeLightIndex++;
         }
 
+        if (firstChanged <= lastChanged)
+        {
+            const uint32_t count = lastChanged - firstChanged + 1;
+            mpLightsBuffer->setBlob(&mActiveLightData[firstChanged], firstChanged * sizeof(LightData), count * sizeof(LightData));
+            mUpdateStats.addObjects(SceneUpdateStats::Stage::Lights, count);
+            mUpdateStats.addUpload(SceneUpdateStats::Stage::Lights, count * sizeof(LightData));
+        }
+
         if (combinedChanges != Light::Changes::None || forceUpdate)
         {
             mpSceneBlock->getRootVar()["lightCount"] = (uint32_t)mActiveLights.size();
@@ -1717,6 +1804,8 @@ namespace Falcor
                     data.invTransform = mul(densityGrid->getInvTransform(), data.invTransform);
                 }
                 mpGridVolumesBuffer->setElement(volumeIndex, data);
+                mUpdateStats.addObjects(SceneUpdateStats::Stage::GridVolumes, 1);
+                mUpdateStats.addUpload(SceneUpdateStats::Stage::GridVolumes, sizeof(data));
             }
             pGridVolume->clearUpdates();
             volumeIndex++;
@@ -1757,6 +1846,7 @@ namespace Falcor
             {
                 if (envMapChanges != EnvMap::Changes::None) flags |= UpdateFlags::EnvMapPropertiesChanged;
                 mpEnvMap->bindShaderData(mpSceneBlock->getRootVar()[kEnvMap]);
+                mUpdateStats.addObjects(SceneUpdateStats::Stage::EnvMap, 1);
             }
         }
         mSceneStats.envMapMemoryInBytes = mpEnvMap ? mpEnvMap->getMemoryUsageInBytes() : 0;
@@ -1780,6 +1870,7 @@ namespace Falcor
         if (forceUpdate || materialUpdates != Material::UpdateFlags::None)
         {
             flags |= UpdateFlags::MaterialsChanged;
+            mUpdateStats.addObjects(SceneUpdateStats::Stage::Materials, mpMaterials->getMaterialCount());
 
             // Bind materials parameter block to scene.
             if (mpSceneBlock)
@@ -1821,6 +1912,92 @@ namespace Falcor
         return flags;
     }
 
+    void Scene::updateUdimTileRequests()
+    {
+        // Material changes include UDIM tiles finishing loading. Only the list of UDIM textures is refreshed,
+        // issuing requests again could keep reloading tiles that don't fit the memory budget.
+        if (is_set(mUpdates, UpdateFlags::MaterialsChanged)) mMaterialUdimTextures.clear();
+
+        if (mUdimTileRequestPolicy == UdimTileRequestPolicy::Visible)
+        {
+            const UpdateFlags visibilityChanges = UpdateFlags::CameraMoved | UpdateFlags::CameraPropertiesChanged | UpdateFlags::CameraSwitched | UpdateFlags::GeometryMoved;
+            if ((mUpdates & visibilityChanges) != UpdateFlags::None) mUdimTileRequestsDirty = true;
+        }
+        if (!mUdimTileRequestsDirty) return;
+        mUdimTileRequestsDirty = false;
+
+        TextureManager& textureManager = mpMaterials->getTextureManager();
+
+        // Collect the lazily loaded UDIM textures of all materials.
+        if (mMaterialUdimTextures.empty())
+        {
+            mMaterialUdimTextures.resize(mpMaterials->getMaterialCount());
+            for (uint32_t materialID = 0; materialID < mpMaterials->getMaterialCount(); ++materialID)
+            {
+                const auto& pMaterial = mpMaterials->getMaterial(MaterialID(materialID));
+                for (uint32_t slot = 0; slot < (uint32_t)Material::TextureSlot::Count; ++slot)
+                {
+                    auto handle = pMaterial->getUdimTexture((Material::TextureSlot)slot);
+                    if (handle && textureManager.getUdimTileResidency(handle) != nullptr)
+                        mMaterialUdimTextures[materialID].push_back(handle);
+                }
+            }
+        }
+        if (std::all_of(mMaterialUdimTextures.begin(), mMaterialUdimTextures.end(), [](const auto& handles) { return handles.empty(); })) return;
+
+        // Find the UDIM tiles covered by the UVs of each mesh.
+        if (mMeshUdimIDs.empty())
+        {
+            mMeshUdimIDs.resize(mMeshUVTiles.size());
+            for (size_t meshIdx = 0; meshIdx < mMeshUVTiles.size(); ++meshIdx)
+            {
+                std::set<uint32_t> udimIDs;
+                for (const Rectangle& tile : mMeshUVTiles[meshIdx])
+                {
+                    // UDIM tiles span the UV range [0,10) x [0,900).
+                    int2 minTile = max(int2(floor(tile.minPoint)), int2(0));
+                    int2 maxTile = min(max(int2(ceil(tile.maxPoint)) - 1, minTile), int2(9, 899));
+                    for (int v = minTile.y; v <= maxTile.y; ++v)
+                        for (int u = minTile.x; u <= maxTile.x; ++u)
+                            udimIDs.insert(1001 + u + 10 * v);
+                }
+                mMeshUdimIDs[meshIdx].assign(udimIDs.begin(), udimIDs.end());
+            }
+        }
+
+        // Request the tiles used by the geometry instances.
+        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+        const ref<Camera>& pCamera = getCamera();
+        std::set<std::pair<TextureManager::CpuTextureHandle, uint32_t>> requests;
+        for (const auto& instance : mGeometryInstanceData)
+        {
+            const GeometryType type = instance.getType();
+            if (type != GeometryType::TriangleMesh && type != GeometryType::DisplacedTriangleMesh) continue;
+
+            const auto& handles = mMaterialUdimTextures[instance.materialID];
+            if (handles.empty()) continue;
+
+            if (mUdimTileRequestPolicy == UdimTileRequestPolicy::Visible)
+            {
+                const AABB bounds = mMeshBBs[instance.geometryID].transform(globalMatrices[instance.globalMatrixID]);
+                if (pCamera->isObjectCulled(bounds)) continue;
+            }
+
+            for (const auto& handle : handles)
+                for (uint32_t udimID : mMeshUdimIDs[instance.geometryID])
+                    requests.insert({handle, udimID});
+        }
+
+        for (const auto& [handle, udimID] : requests)
+            textureManager.requestUdimTile(handle, udimID);
+    }
+
+    void Scene::setUdimTileRequestPolicy(UdimTileRequestPolicy policy)
+    {
+        if (policy != mUdimTileRequestPolicy) mUdimTileRequestsDirty = true;
+        mUdimTileRequestPolicy = policy;
+    }
+
     Scene::UpdateFlags Scene::updateGeometry(RenderContext* pRenderContext, bool forceUpdate)
     {
         UpdateFlags flags = updateProceduralPrimitives(forceUpdate);
@@ -1860,84 +2037,133 @@ namespace Falcor
 
     Scene::UpdateFlags Scene::update(RenderContext* pRenderContext, double currentTime)
     {
+        using Stage = SceneUpdateStats::Stage;
+        using ScopedTimer = SceneUpdateStats::ScopedTimer;
+
+        mUpdateStats.beginFrame();
+
         // Run scene update callback.
-        if (mUpdateCallback) mUpdateCallback(ref<Scene>(this), currentTime);
+        if (mUpdateCallback)
+        {
+            ScopedTimer timer(mUpdateStats, Stage::Callback);
+            mUpdateCallback(ref<Scene>(this), currentTime);
+        }
 
         mUpdates = UpdateFlags::None;
 
         // Perform updates that may affect the scene defines.
-        updateGeometryTypes();
-        mUpdates |= updateMaterials(false);
-
-        // Update scene defines.
-        // These are currently assumed not to change beyond this point.
-        updateSceneDefines();
-        if (mSceneDefines != mPrevSceneDefines)
         {
-            mUpdates |= UpdateFlags::SceneDefinesChanged;
-            mPrevSceneDefines = mSceneDefines;
-            mpSceneBlock = nullptr;
+            ScopedTimer timer(mUpdateStats, Stage::Materials);
+            updateGeometryTypes();
+            mUpdates |= updateMaterials(false);
         }
 
-        // Recreate scene parameter block if scene defines changed, as the defines may affect resource declarations.
-        // All access to the (new) scene parameter block should be placed after this point.
-        if (!mpSceneBlock)
         {
-            logDebug("Recreating scene parameter block");
-            createParameterBlock();
-            bindParameterBlock();
-        }
+            ScopedTimer timer(mUpdateStats, Stage::SceneDefines);
 
-        if (mpAnimationController->animate(pRenderContext, currentTime))
-        {
-            mUpdates |= UpdateFlags::SceneGraphChanged;
-            if (mpAnimationController->hasSkinnedMeshes()) mUpdates |= UpdateFlags::MeshesChanged;
+            // Update scene defines.
+            // These are currently assumed not to change beyond this point.
+            updateSceneDefines();
+            if (mSceneDefines != mPrevSceneDefines)
+            {
+                mUpdates |= UpdateFlags::SceneDefinesChanged;
+                mPrevSceneDefines = mSceneDefines;
+                mpSceneBlock = nullptr;
+            }
 
-            for (const auto& inst : mGeometryInstanceData)
+            // Recreate scene parameter block if scene defines changed, as the defines may affect resource declarations.
+            // All access to the (new) scene parameter block should be placed after this point.
+            if (!mpSceneBlock)
             {
-                if (mpAnimationController->isMatrixChanged(NodeID{ inst.globalMatrixID }))
-                {
-                    mUpdates |= UpdateFlags::GeometryMoved;
-                }
+                logDebug("Recreating scene parameter block");
+                createParameterBlock();
+                bindParameterBlock();
+                mUpdateStats.addBufferRecreated(Stage::SceneDefines);
             }
+        }
+
+        {
+            ScopedTimer timer(mUpdateStats, Stage::Animation);
+            if (mpAnimationController->animate(pRenderContext, currentTime))
+            {
+                mUpdates |= UpdateFlags::SceneGraphChanged;
+                if (mpAnimationController->hasSkinnedMeshes()) mUpdates |= UpdateFlags::MeshesChanged;
+
+                updateMovedGeometryInstanceIDs();
+                if (!mMovedGeometryInstanceIDs.empty()) mUpdates |= UpdateFlags::GeometryMoved;
 
-            // We might end up setting the flag even if curves haven't changed (if looping is disabled for example).
-            if (mpAnimationController->hasAnimatedCurveCaches()) mUpdates |= UpdateFlags::CurvesMoved;
-            if (mpAnimationController->hasAnimatedMeshCaches()) mUpdates |= UpdateFlags::MeshesChanged;
+                // We might end up setting the flag even if curves haven't changed (if looping is disabled for example).
+                if (mpAnimationController->hasAnimatedCurveCaches()) mUpdates |= UpdateFlags::CurvesMoved;
+                if (mpAnimationController->hasAnimatedMeshCaches()) mUpdates |= UpdateFlags::MeshesChanged;
+
+                mUpdateStats.addObjects(Stage::Animation, mpAnimationController->getChangedMatrixIDs().size());
+            }
+            mUpdateStats.addUpload(Stage::Animation, mpAnimationController->getUploadedByteSize());
         }
 
-        for (const auto& pGridVolume : mGridVolumes)
         {
-            pGridVolume->updatePlayback(currentTime);
+            ScopedTimer timer(mUpdateStats, Stage::GridVolumes);
+            for (const auto& pGridVolume : mGridVolumes)
+            {
+                pGridVolume->updatePlayback(currentTime);
+            }
         }
 
-        mUpdates |= updateSelectedCamera(false);
-        mUpdates |= updateLights(false);
-        mUpdates |= updateGridVolumes(false);
-        mUpdates |= updateEnvMap(false);
-        mUpdates |= updateGeometry(pRenderContext, false);
-        mUpdates |= updateSDFGrids(pRenderContext);
+        {
+            ScopedTimer timer(mUpdateStats, Stage::Camera);
+            mUpdates |= updateSelectedCamera(false);
+        }
+        {
+            ScopedTimer timer(mUpdateStats, Stage::Lights);
+            mUpdates |= updateLights(false);
+        }
+        {
+            ScopedTimer timer(mUpdateStats, Stage::GridVolumes);
+            mUpdates |= updateGridVolumes(false);
+        }
+        {
+            ScopedTimer timer(mUpdateStats, Stage::EnvMap);
+            mUpdates |= updateEnvMap(false);
+        }
+        {
+            ScopedTimer timer(mUpdateStats, Stage::Geometry);
+            mUpdates |= updateGeometry(pRenderContext, false);
+        }
+        {
+            ScopedTimer timer(mUpdateStats, Stage::SDFGrids);
+            mUpdates |= updateSDFGrids(pRenderContext);
+        }
         pRenderContext->submit();
 
         if (is_set(mUpdates, UpdateFlags::GeometryMoved))
         {
+            ScopedTimer timer(mUpdateStats, Stage::GeometryInstances);
             invalidateTlasCache();
             updateGeometryInstances(false);
         }
 
+        {
+            ScopedTimer timer(mUpdateStats, Stage::Materials);
+            updateUdimTileRequests();
+        }
+
         // Update existing BLASes if skinned animation and/or procedural primitives moved.
         bool updateProcedural = is_set(mUpdates, UpdateFlags::CurvesMoved) || is_set(mUpdates, UpdateFlags::CustomPrimitivesMoved);
         bool blasUpdateRequired = is_set(mUpdates, UpdateFlags::MeshesChanged) || updateProcedural;
 
         if (mBlasDataValid && blasUpdateRequired)
         {
+            ScopedTimer timer(mUpdateStats, Stage::BLAS);
             invalidateTlasCache();
             buildBlas(pRenderContext);
+            mUpdateStats.addObjects(Stage::BLAS, mBlasData.size());
         }
 
         // Update light collection
         if (mpLightCollection)
         {
+            ScopedTimer timer(mUpdateStats, Stage::LightCollection);
+
             // If emissive material properties changed we recreate the light collection.
             // This can be expensive and should be optimized by letting the light collection internally update its data structures.
             if (is_set(mUpdates, UpdateFlags::EmissiveMaterialsChanged))
@@ -1945,11 +2171,15 @@ namespace Falcor
                 mpLightCollection = nullptr;
                 getLightCollection(pRenderContext);
                 mUpdates |= UpdateFlags::LightCollectionChanged;
+                mUpdateStats.addBufferRecreated(Stage::LightCollection);
             }
             else
             {
                 if (mpLightCollection->update(pRenderContext))
+                {
                     mUpdates |= UpdateFlags::LightCollectionChanged;
+                    mUpdateStats.addObjects(Stage::LightCollection, mpLightCollection->getTotalLightCount());
+                }
                 mSceneStats.emissiveMemoryInBytes = mpLightCollection->getMemoryUsageInBytes();
             }
         }
@@ -1974,6 +2204,8 @@ namespace Falcor
         updateSceneDefines();
         FALCOR_CHECK(mSceneDefines == mPrevSceneDefines, "Scene defines changed unexpectedly");
 
+        mUpdateStats.endFrame();
+
         return mUpdates;
     }
 
@@ -4064,6 +4296,51 @@ namespace Falcor
         mpAnimationController->setNodeEdited(nodeID);
     }
 
+    void Scene::updateNodeTransforms(const std::vector<uint32_t>& nodeIDs, const std::vector<float4x4>& transforms)
+    {
+        FALCOR_CHECK(nodeIDs.size() == transforms.size(), "'nodeIDs' and 'transforms' must have the same size.");
+
+        for (size_t i = 0; i < nodeIDs.size(); ++i)
+        {
+            FALCOR_CHECK(nodeIDs[i] < mSceneGraph.size(), "Node ID {} is out of range.", nodeIDs[i]);
+            mSceneGraph[nodeIDs[i]].transform = validateTransformMatrix(transforms[i]);
+            mpAnimationController->setNodeEdited(nodeIDs[i]);
+        }
+    }
+
+    void Scene::updateGeometryInstanceTransforms(const std::vector<uint32_t>& instanceIDs, const std::vector<float4x4>& transforms)
+    {
+        std::vector<uint32_t> nodeIDs(instanceIDs.size());
+        for (size_t i = 0; i < instanceIDs.size(); ++i)
+        {
+            FALCOR_CHECK(instanceIDs[i] < mGeometryInstanceData.size(), "Geometry instance ID {} is out of range.", instanceIDs[i]);
+            nodeIDs[i] = mGeometryInstanceData[instanceIDs[i]].globalMatrixID;
+        }
+        updateNodeTransforms(nodeIDs, transforms);
+    }
+
+    void Scene::setMaterialParams(const std::vector<MaterialID>& materialIDs, const std::vector<SerializedMaterialParams>& params)
+    {
+        FALCOR_CHECK(materialIDs.size() == params.size(), "'materialIDs' and 'params' must have the same size.");
+
+        for (size_t i = 0; i < materialIDs.size(); ++i)
+        {
+            FALCOR_CHECK(materialIDs[i].get() < getMaterialCount(), "Material ID {} is out of range.", materialIDs[i].get());
+            getMaterial(materialIDs[i])->deserializeParams(params[i]);
+        }
+    }
+
+    void Scene::setLightIntensities(const std::vector<uint32_t>& lightIDs, const std::vector<float3>& intensities)
+    {
+        FALCOR_CHECK(lightIDs.size() == intensities.size(), "'lightIDs' and 'intensities' must have the same size.");
+
+        for (size_t i = 0; i < lightIDs.size(); ++i)
+        {
+            FALCOR_CHECK(lightIDs[i] < mLights.size(), "Light ID {} is out of range.", lightIDs[i]);
+            mLights[lightIDs[i]]->setIntensity(intensities[i]);
+        }
+    }
+
     void Scene::getMeshVerticesAndIndices(MeshID meshID, const std::map<std::string, ref<Buffer>>& buffers)
     {
         if (!mpLoadMeshPass)
@@ -4195,6 +4472,89 @@ namespace Falcor
         return d;
     }
 
+    inline pybind11::dict toPython(const SceneUpdateStats::StageStats& stats)
+    {
+        pybind11::dict d;
+        d["cpuTimeMs"] = stats.cpuTimeMs;
+        d["objectCount"] = stats.objectCount;
+        d["bytesUploaded"] = stats.bytesUploaded;
+        d["buffersRecreated"] = stats.buffersRecreated;
+        return d;
+    }
+
+    inline pybind11::dict toPython(const SceneUpdateStats& stats)
+    {
+        pybind11::dict stages;
+        pybind11::dict accumulatedStages;
+        for (size_t i = 0; i < SceneUpdateStats::kStageCount; ++i)
+        {
+            auto stage = (SceneUpdateStats::Stage)i;
+            stages[SceneUpdateStats::getStageName(stage)] = toPython(stats.getStage(stage));
+            accumulatedStages[SceneUpdateStats::getStageName(stage)] = toPython(stats.getAccumulatedStage(stage));
+        }
+
+        pybind11::dict d;
+        d["frameCount"] = stats.getFrameCount();
+        d["stages"] = stages;
+        d["total"] = toPython(stats.getFrameTotal());
+        d["accumulatedStages"] = accumulatedStages;
+        d["accumulatedTotal"] = toPython(stats.getAccumulatedTotal());
+        return d;
+    }
+
+    using IDArray = pybind11::ndarray<uint32_t, pybind11::shape<pybind11::any>, pybind11::c_contig>;
+
+    /** Copy a contiguous CPU ndarray into a vector with one element of type T per entry of the outermost dimension.
+    */
+    template<typename T, typename... Args>
+    std::vector<T> ndarrayToVector(const pybind11::ndarray<Args...>& array, const char* name)
+    {
+        FALCOR_CHECK(array.device_type() == pybind11::device::cpu::value, "'{}' must be a CPU array.", name);
+        size_t count = array.ndim() > 0 ? array.shape(0) : 0;
+        FALCOR_CHECK(getNdarrayByteSize(array) == count * sizeof(T), "'{}' has an unexpected shape.", name);
+        std::vector<T> result(count);
+        std::memcpy(result.data(), array.data(), count * sizeof(T));
+        return result;
+    }
+
+    /** Update the transforms of a list of nodes.
+    *   \param nodeIDs Array of node IDs with shape [N].
+    *   \param transforms Array of row-major local transforms with shape [N, 4, 4].
+    */
+    inline void updateNodeTransformsPython(Scene& scene, const IDArray& nodeIDs, const pybind11::ndarray<float, pybind11::shape<pybind11::any, 4, 4>, pybind11::c_contig>& transforms)
+    {
+        scene.updateNodeTransforms(ndarrayToVector<uint32_t>(nodeIDs, "node_ids"), ndarrayToVector<float4x4>(transforms, "transforms"));
+    }
+
+    /** Update the node transforms of a list of geometry instances.
+    *   \param instanceIDs Array of geometry instance IDs with shape [N].
+    *   \param transforms Array of row-major local transforms with shape [N, 4, 4].
+    */
+    inline void updateGeometryInstanceTransformsPython(Scene& scene, const IDArray& instanceIDs, const pybind11::ndarray<float, pybind11::shape<pybind11::any, 4, 4>, pybind11::c_contig>& transforms)
+    {
+        scene.updateGeometryInstanceTransforms(ndarrayToVector<uint32_t>(instanceIDs, "instance_ids"), ndarrayToVector<float4x4>(transforms, "transforms"));
+    }
+
+    /** Set the serialized parameters of a list of materials from host arrays.
+    *   \param materialIDs Array of material IDs with shape [N].
+    *   \param params Array of serialized material parameters with shape [N, SerializedMaterialParams::kParamCount].
+    */
+    inline void updateMaterialParamsPython(Scene& scene, const IDArray& materialIDs, const pybind11::ndarray<float, pybind11::shape<pybind11::any, SerializedMaterialParams::kParamCount>, pybind11::c_contig>& params)
+    {
+        std::vector<uint32_t> ids = ndarrayToVector<uint32_t>(materialIDs, "material_ids");
+        std::vector<MaterialID> typedIDs(ids.begin(), ids.end());
+        scene.setMaterialParams(typedIDs, ndarrayToVector<SerializedMaterialParams>(params, "params"));
+    }
+
+    /** Set the intensities of a list of lights.
+    *   \param lightIDs Array of light IDs with shape [N].
+    *   \param intensities Array of intensities with shape [N, 3].
+    */
+    inline void setLightIntensitiesPython(Scene& scene, const IDArray& lightIDs, const pybind11::ndarray<float, pybind11::shape<pybind11::any, 3>, pybind11::c_contig>& intensities)
+    {
+        scene.setLightIntensities(ndarrayToVector<uint32_t>(lightIDs, "light_ids"), ndarrayToVector<float3>(intensities, "intensities"));
+    }
+
     /** Get serialized material parameters for a list of materials.
     *   \param materialIDsBuffer Buffer containing material IDs
     *   \param paramsBuffer Buffer to write material parameters to
@@ -4327,6 +4687,8 @@ namespace Falcor
         pybind11::class_<Scene, ref<Scene>> scene(m, "Scene");
 
         scene.def_property_readonly(kStats.c_str(), [](const Scene* pScene) { return toPython(pScene->getSceneStats()); });
+        scene.def_property_readonly(kUpdateStats.c_str(), [](const Scene* pScene) { return toPython(pScene->getUpdateStats()); });
+        scene.def(kResetUpdateStats.c_str(), &Scene::resetUpdateStats);
         scene.def_property_readonly(kBounds.c_str(), &Scene::getSceneBounds, pybind11::return_value_policy::copy);
         scene.def_property(kCamera.c_str(), &Scene::getCamera, &Scene::setCamera);
         scene.def_property(kEnvMap.c_str(), &Scene::getEnvMap, &Scene::setEnvMap);
@@ -4371,6 +4733,12 @@ namespace Falcor
         scene.def("get_material_params", getMaterialParamsPython);
         scene.def("set_material_params", setMaterialParamsPython);
 
+        // Batched updates from host arrays. Changes are applied in a single pass on the next scene update.
+        scene.def("update_node_transforms", updateNodeTransformsPython, "node_ids"_a, "transforms"_a);
+        scene.def("update_instance_transforms", updateGeometryInstanceTransformsPython, "instance_ids"_a, "transforms"_a);
+        scene.def("update_material_params", updateMaterialParamsPython, "material_ids"_a, "params"_a);
+        scene.def("set_light_intensities", setLightIntensitiesPython, "light_ids"_a, "intensities"_a);
+
         // Viewpoints
         scene.def(kAddViewpoint.c_str(), pybind11::overload_cast<>(&Scene::addViewpoint)); // add current camera as viewpoint
         scene.def(kAddViewpoint.c_str(), pybind11::overload_cast<const float3&, const float3&, const float3&, uint32_t>(&Scene::addViewpoint), "position"_a, "target"_a, "up"_a, "cameraIndex"_a = 0); // add specified viewpoint
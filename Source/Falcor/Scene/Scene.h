@@ -29,6 +29,7 @@
 #include "SceneIDs.h"
 #include "SceneTypes.slang"
 #include "HitInfo.h"
+#include "SceneUpdateStats.h"
 #include "Animation/Animation.h"
 #include "Animation/AnimationController.h"
 #include "Displacement/DisplacementUpdateTask.slang"
@@ -178,6 +179,15 @@ namespace Falcor
             SixDOF
         };
 
+        /** Policy for requesting the tiles of lazily loaded UDIM textures (see SceneBuilder::Flags::LazyUdimTextures).
+            The tiles used by a geometry instance are the UDIM tiles covered by the UVs of its mesh.
+        */
+        enum class UdimTileRequestPolicy
+        {
+            Visible,    ///< Request the tiles used by geometry instances in the view frustum of the selected camera, whenever the camera or geometry moves.
+            All,        ///< Request the tiles used by all geometry instances once.
+        };
+
         enum class SDFGridIntersectionMethod : uint32_t
         {
             None = 0,
@@ -502,6 +512,15 @@ namespace Falcor
         */
         const SceneStats& getSceneStats() const { return mSceneStats; }
 
+        /** Get the CPU cost statistics of the scene update.
+            This holds the per-stage CPU time and counters of the last call to update() as well as accumulated values.
+        */
+        const SceneUpdateStats& getUpdateStats() const { return mUpdateStats; }
+
+        /** Reset the accumulated scene update statistics.
+        */
+        void resetUpdateStats() { mUpdateStats.reset(); }
+
         /** Get the render settings.
         */
         const RenderSettings& getRenderSettings() const { return mRenderSettings; }
@@ -636,6 +655,10 @@ namespace Falcor
         */
         bool hasSavedViewpoints() { return mViewpoints.size() > 1; }
 
+        /** Get the number of viewpoints, including the initial viewpoint.
+        */
+        uint32_t getViewpointCount() const { return (uint32_t)mViewpoints.size(); }
+
         /** Get the set of geometry types used in the scene.
             \return A bit field containing the set of geometry types.
         */
@@ -793,6 +816,20 @@ namespace Falcor
         */
         void updateNodeTransform(uint32_t nodeID, const float4x4& transform);
 
+        /** Updates multiple nodes in the graph.
+            The changes are propagated and uploaded in a single pass on the next call to update().
+            \param[in] nodeIDs Node IDs.
+            \param[in] transforms Local transforms, one per node.
+        */
+        void updateNodeTransforms(const std::vector<uint32_t>& nodeIDs, const std::vector<float4x4>& transforms);
+
+        /** Updates the nodes of multiple geometry instances.
+            Note that instances sharing a node are all affected by a change of its transform.
+            \param[in] instanceIDs Geometry instance IDs.
+            \param[in] transforms Local transforms of the instance nodes, one per instance.
+        */
+        void updateGeometryInstanceTransforms(const std::vector<uint32_t>& instanceIDs, const std::vector<float4x4>& transforms);
+
         /** Get the number of custom primitives.
         */
         uint32_t getCustomPrimitiveCount() const { return (uint32_t)mCustomPrimitiveDesc.size(); }
@@ -848,6 +885,16 @@ namespace Falcor
         */
         MaterialSystem& getMaterialSystem() const { return *mpMaterials; }
 
+        /** Set the policy for requesting the tiles of lazily loaded UDIM textures.
+            Requested tiles are loaded asynchronously and become visible to shaders on a later call to update().
+            The texture manager evicts the least recently requested tiles when a UDIM set exceeds its memory budget.
+        */
+        void setUdimTileRequestPolicy(UdimTileRequestPolicy policy);
+
+        /** Get the policy for requesting the tiles of lazily loaded UDIM textures.
+        */
+        UdimTileRequestPolicy getUdimTileRequestPolicy() const { return mUdimTileRequestPolicy; }
+
         /** Get a list of all materials in the scene.
         */
         const std::vector<ref<Material>>& getMaterials() const { return mpMaterials->getMaterials(); }
@@ -874,6 +921,13 @@ namespace Falcor
         */
         MaterialID addMaterial(const ref<Material>& pMaterial) { return mpMaterials->addMaterial(pMaterial); }
 
+        /** Set the serialized parameters of multiple materials.
+            The materials are updated and uploaded together on the next call to update().
+            \param[in] materialIDs Material IDs.
+            \param[in] params Serialized material parameters, one per material.
+        */
+        void setMaterialParams(const std::vector<MaterialID>& materialIDs, const std::vector<SerializedMaterialParams>& params);
+
         /** Get a list of all grid volumes in the scene.
         */
         const std::vector<ref<GridVolume>>& getGridVolumes() const { return mGridVolumes; }
@@ -918,6 +972,13 @@ namespace Falcor
         */
         ref<Light> getLightByName(const std::string& name) const;
 
+        /** Set the intensity of multiple lights.
+            The light data is uploaded in a single pass on the next call to update().
+            \param[in] lightIDs Light IDs.
+            \param[in] intensities Light intensities (radiance for area lights), one per light.
+        */
+        void setLightIntensities(const std::vector<uint32_t>& lightIDs, const std::vector<float3>& intensities);
+
         /** Get a list of all active lights in the scene.
         */
         const std::vector<ref<Light>>& getActiveLights() const { return mActiveLights; }
@@ -1156,7 +1217,21 @@ namespace Falcor
         */
         void updateBounds();
 
+        /** Create the mapping from global matrices to the geometry instances using them.
+        */
+        void createMatrixInstanceMap();
+
+        /** Update the list of geometry instances whose global matrix changed in the last animation update.
+        */
+        void updateMovedGeometryInstanceIDs();
+
+        /** Update the transform dependent flags of a geometry instance.
+            \return True if the flags changed.
+        */
+        bool updateGeometryInstanceFlags(GeometryInstanceData& inst, const float4x4& transform) const;
+
         /** Update geometry instances.
+            \param[in] forceUpdate If true, all instances are updated and uploaded. Otherwise only moved instances are updated.
         */
         void updateGeometryInstances(bool forceUpdate);
 
@@ -1228,6 +1303,7 @@ namespace Falcor
         UpdateFlags updateRaytracingAABBData(bool forceUpdate);
         UpdateFlags updateDisplacement(RenderContext* pRenderContext, bool forceUpdate);
         UpdateFlags updateSDFGrids(RenderContext* pRenderContext);
+        void updateUdimTileRequests();
 
         void updateGeometryStats();
         void updateMaterialStats();
@@ -1261,6 +1337,10 @@ namespace Falcor
         GeometryTypeFlags mGeometryTypes;                           ///< Set of geometry types that exist in the scene.
 
         std::vector<GeometryInstanceData> mGeometryInstanceData;    ///< Geometry instance data (for all types of geometry).
+        std::vector<uint32_t> mMatrixInstanceOffsets;              ///< Offsets into mMatrixInstanceIDs per global matrix (size is matrix count + 1).
+        std::vector<uint32_t> mMatrixInstanceIDs;                  ///< Geometry instance IDs grouped by global matrix.
+        std::vector<uint32_t> mMovedGeometryInstanceIDs;           ///< Sorted list of geometry instances whose global matrix changed in the last update.
+        std::vector<uint32_t> mChangedGeometryInstanceIDs;         ///< Scratch list of geometry instances whose data changed in the last update.
 
         bool mUseCompressedHitInfo = false;                         ///< True if scene should used compressed HitInfo (on scenes with triangles meshes only).
         bool mHas16BitIndices = false;                              ///< True if any meshes use 16-bit indices.
@@ -1274,6 +1354,7 @@ namespace Falcor
         // Triangle meshes
         std::vector<MeshDesc> mMeshDesc;                            ///< Copy of mesh data GPU buffer (mpMeshesBuffer).
         std::vector<std::vector<Rectangle>> mMeshUVTiles;           ///< Bounding tiles for the mesh UVs
+        std::vector<std::vector<uint32_t>> mMeshUdimIDs;            ///< UDIM IDs of the tiles covered by the mesh UVs. Computed on first use.
         std::vector<MeshGroup> mMeshGroups;                         ///< Groups of meshes. Each group maps to a BLAS for ray tracing.
         std::vector<std::string> mMeshNames;                        ///< Mesh names, indxed by mesh ID
         std::vector<Node> mSceneGraph;                              ///< For each index i, the array element indicates the parent node. Indices are in relation to mLocalToWorldMatrices.
@@ -1323,6 +1404,7 @@ namespace Falcor
         // Lights
         std::vector<ref<Light>> mLights;                            ///< All analytic lights. Note that not all may be active.
         std::vector<ref<Light>> mActiveLights;                      ///< All active analytic lights.
+        std::vector<LightData> mActiveLightData;                    ///< Staging copy of the data of all active analytic lights.
         std::vector<ref<GridVolume>> mGridVolumes;                  ///< All loaded grid volumes.
         std::vector<ref<Grid>> mGrids;                              ///< All loaded grids.
         std::unordered_map<ref<Grid>, SdfGridID> mGridIDs;          ///< Lookup table for grid IDs.
@@ -1339,6 +1421,7 @@ namespace Falcor
         HitInfo mHitInfo;                                           ///< Geometry hit info requirements.
         AABB mSceneBB;                                              ///< Bounding boxes of the entire scene in world space.
         SceneStats mSceneStats;                                     ///< Scene statistics.
+        SceneUpdateStats mUpdateStats;                              ///< Scene update CPU cost statistics.
         Metadata mMetadata;                                         ///< Importer-provided metadata.
         RenderSettings mRenderSettings;                             ///< Render settings.
         RenderSettings mPrevRenderSettings;
@@ -1391,6 +1474,11 @@ namespace Falcor
         UpdateMode mTlasUpdateMode = UpdateMode::Rebuild;   ///< How the TLAS should be updated when there are changes in the scene.
         UpdateMode mBlasUpdateMode = UpdateMode::Refit;     ///< How the BLAS should be updated when there are changes to meshes.
 
+        // Lazily loaded UDIM textures
+        UdimTileRequestPolicy mUdimTileRequestPolicy = UdimTileRequestPolicy::Visible;
+        bool mUdimTileRequestsDirty = true;                 ///< True if the UDIM tile requests need to be issued again.
+        std::vector<std::vector<TextureManager::CpuTextureHandle>> mMaterialUdimTextures; ///< Lazily loaded UDIM textures of each material. Collected on first use.
+
         std::vector<RtInstanceDesc> mInstanceDescs;         ///< Shared between TLAS builds to avoid reallocating CPU memory.
 
         struct TlasData
@@ -34,7 +34,9 @@
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
+#include "Core/API/PythonHelpers.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/ObjectIDPython.h"
 #include "Utils/NumericRange.h"
@@ -210,6 +212,16 @@ namespace Falcor
     {
         mAssetResolver = AssetResolver::getDefaultResolver();
         mSceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
+
+        if (is_set(mFlags, Flags::LazyUdimTextures))
+        {
+            TextureManager::LazyUdimOptions options;
+            options.enabled = true;
+            if (auto budgetMB = mSettings.getOption<double>("SceneBuilder:udimMemoryBudgetMB"))
+                options.memoryBudgetPerSet = (uint64_t)(*budgetMB * 1024.0 * 1024.0);
+            options.placeholderSize = mSettings.getOption<uint32_t>("SceneBuilder:udimPlaceholderSize", options.placeholderSize);
+            mSceneData.pMaterials->getTextureManager().setLazyUdimOptions(options);
+        }
     }
 
     SceneBuilder::SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags)
@@ -229,9 +241,17 @@ namespace Falcor
         bool rebuildCache = is_set(flags, Flags::RebuildCache);
         mWriteSceneCache = useCache || rebuildCache;
 
+        // If the scene cache is missing, elect a single process to import the scene and write the cache.
+        // Processes loading the same scene concurrently block here until the cache is written.
+        if (mWriteSceneCache && (rebuildCache || !SceneCache::hasValidCache(mSceneCacheKey)))
+        {
+            mpSceneCacheLock = SceneCache::lockForWriting(mSceneCacheKey);
+        }
+
         // Try to load scene cache if supported, available and requested.
         if (useCache && !rebuildCache && SceneCache::hasValidCache(mSceneCacheKey))
         {
+            mpSceneCacheLock.reset();
             try
             {
                 mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, mSceneCacheKey));
@@ -239,7 +259,8 @@ namespace Falcor
             }
             catch (const std::exception& e)
             {
-                throw ImporterError(resolvedPath, "Failed to load scene cache: {}", e.what());
+                logWarning("Failed to load scene cache, rebuilding it: {}", e.what());
+                mpSceneCacheLock = SceneCache::lockForWriting(mSceneCacheKey);
             }
         }
 
@@ -390,7 +411,8 @@ namespace Falcor
         // Write scene cache if requested.
         if (mWriteSceneCache)
         {
-            SceneCache::writeCache(mSceneData, mSceneCacheKey);
+            SceneCache::writeCache(mSceneData, mSceneCacheKey, mpSceneCacheLock.get());
+            mpSceneCacheLock.reset();
             timeReport.measure("Writing cache");
         }
 
@@ -940,7 +962,12 @@ namespace Falcor
         {
             mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
         }
-        std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
+        // UDIM texture paths are file name patterns, only their directory can be resolved.
+        std::filesystem::path resolvedPath;
+        if (path.filename().string().find("<UDIM>") != std::string::npos)
+            resolvedPath = mAssetResolver.resolvePath(path.parent_path()) / path.filename();
+        else
+            resolvedPath = mAssetResolver.resolvePath(path);
         mpMaterialTextureLoader->loadTexture(pMaterial, slot, resolvedPath);
     }
 
@@ -2939,6 +2966,7 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("LazyUdimTextures", SceneBuilder::Flags::LazyUdimTextures);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
@@ -2981,6 +3009,26 @@ namespace Falcor
             node.parent = parent;
             return pSceneBuilder->addNode(node);
         }, "name"_a, "transform"_a = Transform(), "parent"_a = NodeID::kInvalidID);
+        // Bulk version of addNode() taking an ndarray of row-major float4x4 transforms with shape [N, 4, 4].
+        // The array is read in-place (strided arrays are supported). Nodes are named '<name>_<index>'.
+        sceneBuilder.def("addNodes", [] (SceneBuilder* pSceneBuilder, const std::string& name, pybind11::ndarray<float, pybind11::shape<pybind11::any, 4, 4>> transforms, NodeID parent) {
+            FALCOR_CHECK(pSceneBuilder, "'pSceneBuilder' is missing");
+            FALCOR_CHECK(transforms.device_type() == pybind11::device::cpu::value, "'transforms' must be a CPU array.");
+            std::vector<NodeID> nodeIDs(transforms.shape(0));
+            for (size_t i = 0; i < nodeIDs.size(); ++i)
+            {
+                SceneBuilder::Node node;
+                node.name = fmt::format("{}_{}", name, i);
+                for (uint32_t r = 0; r < 4; ++r)
+                {
+                    for (uint32_t c = 0; c < 4; ++c)
+                        node.transform[r][c] = *getNdarrayElement<float>(transforms, i, r, c);
+                }
+                node.parent = parent;
+                nodeIDs[i] = pSceneBuilder->addNode(node);
+            }
+            return nodeIDs;
+        }, "name"_a, "transforms"_a, "parent"_a = NodeID::kInvalidID);
         sceneBuilder.def("addMeshInstance", &SceneBuilder::addMeshInstance);
         sceneBuilder.def("addSDFGridInstance", &SceneBuilder::addSDFGridInstance);
         sceneBuilder.def("addCustomPrimitive", &SceneBuilder::addCustomPrimitive);
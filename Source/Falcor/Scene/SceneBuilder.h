@@ -77,6 +77,7 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            LazyUdimTextures                = 0x20000,  ///< Load the tiles of UDIM textures on demand, as requested by the scene (see Scene::UdimTileRequestPolicy). Low-resolution placeholders are bound until then. The options 'SceneBuilder:udimMemoryBudgetMB' and 'SceneBuilder:udimPlaceholderSize' configure the memory budget per UDIM set and the placeholder size.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -773,6 +774,7 @@ namespace Falcor
         ref<Scene> mpScene;
         SceneCache::Key mSceneCacheKey;
         bool mWriteSceneCache = false;  ///< True if scene cache should be written after import.
+        std::unique_ptr<LockFile> mpSceneCacheLock; ///< Scene cache writer lock held during import.
 
         SceneGraph mSceneGraph;
 
@@ -30,12 +30,11 @@
 #include "Material/HairMaterial.h"
 #include "Material/ClothMaterial.h"
 #include "Material/MaterialTextureLoader.h"
+#include "Utils/DiskCache.h"
 #include "Utils/Logger.h"
 
 #include <lz4_stream/lz4_stream.h>
 
-#include <fstream>
-
 namespace Falcor
 {
     namespace
@@ -43,12 +42,16 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 26;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
         const std::string kDirectory = "NVIDIA/Falcor/SceneCache";
 
+        /** Default size budget of the scene cache directory.
+        */
+        const uint64_t kDefaultSizeBudget = 64ull * 1024 * 1024 * 1024;
+
         const size_t kBlockSize = 1 * 1024 * 1024;
 
         const char* kMagic = "FalcorS$";
@@ -194,43 +197,44 @@ namespace Falcor
 
     bool SceneCache::hasValidCache(const Key& key)
     {
-        auto cachePath = getCachePath(key);
-        if (!std::filesystem::exists(cachePath)) return false;
-
-        // Open file.
-        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) return false;
-
-        // Verify header.
+        // Verify header. The checksum is verified when reading the cache.
         Header header;
-        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        return !fs.eof() && header.isValid();
+        return getStore().peek(SHA1::toString(key), &header, sizeof(header)) && header.isValid();
     }
 
-    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    std::unique_ptr<LockFile> SceneCache::lockForWriting(const Key& key)
+    {
+        return getStore().lockForWriting(SHA1::toString(key));
+    }
+
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key, LockFile* pWriterLock)
     {
         auto cachePath = getCachePath(key);
 
         logInfo("Writing scene cache to '{}'.", cachePath);
 
-        // Create directories if not existing.
-        std::filesystem::create_directories(cachePath.parent_path());
-
-        // Open file.
-        std::ofstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) FALCOR_THROW("Failed to create scene cache file '{}'.", cachePath);
+        auto writeFunc = [&](std::ostream& fs)
+        {
+            // Write header (uncompressed).
+            Header header;
+            std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+            header.version = kVersion;
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
-        // Write header (uncompressed).
-        Header header;
-        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
-        header.version = kVersion;
-        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            // Write cache (compressed).
+            lz4_stream::basic_ostream<kBlockSize> zs(fs);
+            OutputStream stream(zs);
+            writeSceneData(stream, sceneData);
+        };
 
-        // Write cache (compressed).
-        lz4_stream::basic_ostream<kBlockSize> zs(fs);
-        OutputStream stream(zs);
-        writeSceneData(stream, sceneData);
-        if (fs.bad()) FALCOR_THROW("Failed to write scene cache file to '{}'.", cachePath);
+        try
+        {
+            getStore().write(SHA1::toString(key), writeFunc, pWriterLock);
+        }
+        catch (const std::exception& e)
+        {
+            FALCOR_THROW("Failed to write scene cache file to '{}': {}", cachePath, e.what());
+        }
     }
 
     Scene::SceneData SceneCache::readCache(ref<Device> pDevice, const Key& key)
@@ -239,26 +243,44 @@ namespace Falcor
 
         logInfo("Loading scene cache from '{}'.", cachePath);
 
-        // Open file.
-        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) FALCOR_THROW("Failed to open scene cache file '{}'.", cachePath);
+        Scene::SceneData sceneData;
+        auto readFunc = [&](std::istream& fs)
+        {
+            // Read header (uncompressed).
+            Header header;
+            fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!header.isValid()) FALCOR_THROW("Invalid header in scene cache file '{}'.", cachePath);
+
+            // Read cache (compressed).
+            lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
+            InputStream stream(zs);
+            sceneData = readSceneData(stream, pDevice);
+            if (fs.bad()) FALCOR_THROW("Failed to read scene cache file from '{}'.", cachePath);
+        };
 
-        // Read header (uncompressed).
-        Header header;
-        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        if (!header.isValid()) FALCOR_THROW("Invalid header in scene cache file '{}'.", cachePath);
-
-        // Read cache (compressed).
-        lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
-        InputStream stream(zs);
-        auto sceneData = readSceneData(stream, pDevice);
-        if (fs.bad()) FALCOR_THROW("Failed to read scene cache file from '{}'.", cachePath);
+        if (!getStore().read(SHA1::toString(key), readFunc)) FALCOR_THROW("Failed to open scene cache file '{}'.", cachePath);
         return sceneData;
     }
 
+    void SceneCache::setSizeBudget(uint64_t sizeBudget)
+    {
+        getStore().setSizeBudget(sizeBudget);
+    }
+
+    uint64_t SceneCache::getSizeBudget()
+    {
+        return getStore().getSizeBudget();
+    }
+
+    DiskCache& SceneCache::getStore()
+    {
+        static DiskCache store(getAppDataDirectory() / kDirectory, kDefaultSizeBudget);
+        return store;
+    }
+
     std::filesystem::path SceneCache::getCachePath(const Key& key)
     {
-        return getAppDataDirectory() / kDirectory / SHA1::toString(key);
+        return getStore().getEntryPath(SHA1::toString(key));
     }
 
     // SceneData
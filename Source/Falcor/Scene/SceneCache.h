@@ -39,17 +39,23 @@
 
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
+#include "Core/Platform/LockFile.h"
 #include "Utils/CryptoUtils.h"
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace Falcor
 {
+    class DiskCache;
+
     /** Helper class for reading and writing scene cache files.
         The scene cache is used to heavily reduce load times of more complex assets.
         The cache stores a binary representation of `Scene::SceneData` which contains everything to re-create a `Scene`.
+        Cache files are managed by a `DiskCache` store, which makes concurrent access from multiple processes safe
+        and evicts least recently used caches when the cache directory exceeds its size budget.
     */
     class FALCOR_API SceneCache
     {
@@ -62,11 +68,22 @@ namespace Falcor
         */
         static bool hasValidCache(const Key& key);
 
+        /** Acquire the writer lock for a scene cache.
+            Only a single process can hold the lock at any time. This is used to elect a single process to import
+            a scene and write its cache, while other processes loading the same scene wait and then read the cache.
+            \param[in] key Cache key.
+            \return Returns the held lock, or nullptr if the lock could not be created.
+        */
+        static std::unique_ptr<LockFile> lockForWriting(const Key& key);
+
         /** Write a scene cache.
+            The cache is written to a temporary file and atomically moved into place once complete.
             \param[in] sceneData Scene data.
             \param[in] key Cache key.
+            \param[in] pWriterLock Writer lock acquired with lockForWriting(). If nullptr, the lock is acquired
+                        in non-blocking mode and the cache is not written if another process is writing it.
         */
-        static void writeCache(const Scene::SceneData& sceneData, const Key& key);
+        static void writeCache(const Scene::SceneData& sceneData, const Key& key, LockFile* pWriterLock = nullptr);
 
         /** Read a scene cache.
             \param[in] pDevice GPU device.
@@ -75,10 +92,21 @@ namespace Falcor
         */
         static Scene::SceneData readCache(ref<Device> pDevice, const Key& key);
 
+        /** Set the size budget of the scene cache directory.
+            Least recently used caches are evicted when writing a cache exceeds the budget.
+            \param[in] sizeBudget Size budget in bytes (0 to disable eviction).
+        */
+        static void setSizeBudget(uint64_t sizeBudget);
+
+        /** Get the size budget of the scene cache directory in bytes.
+        */
+        static uint64_t getSizeBudget();
+
     private:
         class OutputStream;
         class InputStream;
 
+        static DiskCache& getStore();
         static std::filesystem::path getCachePath(const Key& key);
 
         static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
@@ -0,0 +1,112 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SceneUpdateStats.h"
+#include "Core/Error.h"
+
+namespace Falcor
+{
+SceneUpdateStats::StageStats& SceneUpdateStats::StageStats::operator+=(const StageStats& other)
+{
+    cpuTimeMs += other.cpuTimeMs;
+    objectCount += other.objectCount;
+    bytesUploaded += other.bytesUploaded;
+    buffersRecreated += other.buffersRecreated;
+    return *this;
+}
+
+const char* SceneUpdateStats::getStageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::Callback:
+        return "callback";
+    case Stage::Materials:
+        return "materials";
+    case Stage::SceneDefines:
+        return "sceneDefines";
+    case Stage::Animation:
+        return "animation";
+    case Stage::Camera:
+        return "camera";
+    case Stage::Lights:
+        return "lights";
+    case Stage::GridVolumes:
+        return "gridVolumes";
+    case Stage::EnvMap:
+        return "envMap";
+    case Stage::Geometry:
+        return "geometry";
+    case Stage::SDFGrids:
+        return "sdfGrids";
+    case Stage::GeometryInstances:
+        return "geometryInstances";
+    case Stage::BLAS:
+        return "blas";
+    case Stage::LightCollection:
+        return "lightCollection";
+    default:
+        FALCOR_UNREACHABLE();
+        return "";
+    }
+}
+
+void SceneUpdateStats::beginFrame()
+{
+    mFrame.fill({});
+}
+
+void SceneUpdateStats::endFrame()
+{
+    for (size_t i = 0; i < kStageCount; ++i)
+        mAccumulated[i] += mFrame[i];
+    mFrameCount++;
+}
+
+void SceneUpdateStats::reset()
+{
+    mFrame.fill({});
+    mAccumulated.fill({});
+    mFrameCount = 0;
+}
+
+SceneUpdateStats::StageStats SceneUpdateStats::getFrameTotal() const
+{
+    StageStats total;
+    for (const auto& stage : mFrame)
+        total += stage;
+    return total;
+}
+
+SceneUpdateStats::StageStats SceneUpdateStats::getAccumulatedTotal() const
+{
+    StageStats total;
+    for (const auto& stage : mAccumulated)
+        total += stage;
+    return total;
+}
+} // namespace Falcor
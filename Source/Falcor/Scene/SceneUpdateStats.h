@@ -0,0 +1,136 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <array>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * CPU cost instrumentation of Scene::update().
+ *
+ * The scene update is split into stages (animation, lights, geometry instances etc.).
+ * For each stage the CPU time and a set of counters are recorded every frame:
+ * - Number of objects touched (lights, instances, volumes etc. that were updated).
+ * - Number of bytes uploaded to the GPU.
+ * - Number of buffers (re)created.
+ *
+ * Stats are kept for the last frame as well as accumulated over all frames since the last reset.
+ */
+class FALCOR_API SceneUpdateStats
+{
+public:
+    enum class Stage : uint32_t
+    {
+        Callback,
+        Materials,
+        SceneDefines,
+        Animation,
+        Camera,
+        Lights,
+        GridVolumes,
+        EnvMap,
+        Geometry,
+        SDFGrids,
+        GeometryInstances,
+        BLAS,
+        LightCollection,
+
+        Count
+    };
+
+    static constexpr size_t kStageCount = (size_t)Stage::Count;
+
+    struct StageStats
+    {
+        double cpuTimeMs = 0.0;        ///< CPU time in milliseconds.
+        uint64_t objectCount = 0;      ///< Number of objects touched.
+        uint64_t bytesUploaded = 0;    ///< Number of bytes uploaded to the GPU.
+        uint64_t buffersRecreated = 0; ///< Number of buffers (re)created.
+
+        StageStats& operator+=(const StageStats& other);
+    };
+
+    /**
+     * Scoped CPU timer adding the elapsed time to a stage on destruction.
+     */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(SceneUpdateStats& stats, Stage stage) : mStats(stats), mStage(stage), mStart(CpuTimer::getCurrentTimePoint()) {}
+        ~ScopedTimer() { mStats.addTime(mStage, CpuTimer::calcDuration(mStart, CpuTimer::getCurrentTimePoint())); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        SceneUpdateStats& mStats;
+        Stage mStage;
+        CpuTimer::TimePoint mStart;
+    };
+
+    /// Get the name of a stage.
+    static const char* getStageName(Stage stage);
+
+    /// Begin recording a new frame. Clears the stats of the last frame.
+    void beginFrame();
+
+    /// End recording of a frame. Adds the stats of the frame to the accumulated stats.
+    void endFrame();
+
+    /// Reset all stats, including the accumulated ones.
+    void reset();
+
+    void addTime(Stage stage, double cpuTimeMs) { mFrame[(size_t)stage].cpuTimeMs += cpuTimeMs; }
+    void addObjects(Stage stage, uint64_t count) { mFrame[(size_t)stage].objectCount += count; }
+    void addUpload(Stage stage, uint64_t byteSize) { mFrame[(size_t)stage].bytesUploaded += byteSize; }
+    void addBufferRecreated(Stage stage, uint64_t count = 1) { mFrame[(size_t)stage].buffersRecreated += count; }
+
+    /// Get the stats of a stage in the last (or currently recorded) frame.
+    const StageStats& getStage(Stage stage) const { return mFrame[(size_t)stage]; }
+
+    /// Get the stats of a stage accumulated over all frames since the last reset.
+    const StageStats& getAccumulatedStage(Stage stage) const { return mAccumulated[(size_t)stage]; }
+
+    /// Get the sum over all stages in the last frame.
+    StageStats getFrameTotal() const;
+
+    /// Get the sum over all stages accumulated over all frames since the last reset.
+    StageStats getAccumulatedTotal() const;
+
+    /// Get the number of frames recorded since the last reset.
+    uint64_t getFrameCount() const { return mFrameCount; }
+
+private:
+    std::array<StageStats, kStageCount> mFrame;
+    std::array<StageStats, kStageCount> mAccumulated;
+    uint64_t mFrameCount = 0;
+};
+} // namespace Falcor
@@ -29,12 +29,15 @@
 #include "GlobalState.h"
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
+#include "Core/API/PythonHelpers.h"
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <cmath>
+#include <cstring>
 
 namespace Falcor
 {
@@ -322,6 +325,98 @@ namespace Falcor
         , mFrontFaceCW(frontFaceCW)
     {}
 
+    namespace
+    {
+        using FloatArray = pybind11::ndarray<float, pybind11::shape<pybind11::any, pybind11::any>>;
+        using IndexArray = pybind11::ndarray<uint32_t, pybind11::c_contig>;
+
+        /** Create a view of one vertex attribute as a numpy array of shape [vertexCount, N] without copying.
+            The view holds a reference to the mesh and is invalidated if vertices are added or replaced.
+        */
+        template<size_t N>
+        pybind11::ndarray<pybind11::numpy> createVertexAttributeView(const ref<TriangleMesh>& pMesh, size_t attributeOffset)
+        {
+            static_assert(sizeof(TriangleMesh::Vertex) % sizeof(float) == 0);
+            const auto& vertices = pMesh->getVertices();
+            size_t shape[2] = { vertices.size(), N };
+            int64_t strides[2] = { sizeof(TriangleMesh::Vertex) / sizeof(float), 1 };
+            auto pData = reinterpret_cast<const uint8_t*>(vertices.data()) + attributeOffset;
+            return pybind11::ndarray<pybind11::numpy>(
+                const_cast<uint8_t*>(pData), 2, shape, pybind11::cast(pMesh), strides, pybind11::dtype<float>(), pybind11::device::cpu::value);
+        }
+
+        /** Create a view of the index list as a numpy array of shape [triangleCount, 3] without copying.
+            The view holds a reference to the mesh and is invalidated if triangles are added or replaced.
+        */
+        pybind11::ndarray<pybind11::numpy> createIndexView(const ref<TriangleMesh>& pMesh)
+        {
+            const auto& indices = pMesh->getIndices();
+            size_t shape[2] = { indices.size() / 3, 3 };
+            return pybind11::ndarray<pybind11::numpy>(
+                const_cast<uint32_t*>(indices.data()), 2, shape, pybind11::cast(pMesh), nullptr, pybind11::dtype<uint32_t>(), pybind11::device::cpu::value);
+        }
+
+        /** Copy one vertex attribute of shape [vertexCount, N] from an ndarray into the interleaved vertex list.
+            Rows of contiguous arrays are copied with memcpy, other arrays are read element-wise taking their strides into account.
+        */
+        template<size_t N>
+        void copyVertexAttribute(const FloatArray& array, TriangleMesh::VertexList& vertices, size_t attributeOffset)
+        {
+            FALCOR_CHECK(array.dtype() == pybind11::dtype<float>(), "Vertex attributes must be float32 arrays.");
+            FALCOR_ASSERT(array.shape(0) == vertices.size() && array.shape(1) == N);
+
+            uint8_t* pDst = reinterpret_cast<uint8_t*>(vertices.data()) + attributeOffset;
+            if (isNdarrayContiguous(array))
+            {
+                const float* pSrc = static_cast<const float*>(array.data());
+                for (size_t i = 0; i < vertices.size(); ++i, pDst += sizeof(TriangleMesh::Vertex))
+                    std::memcpy(pDst, pSrc + i * N, N * sizeof(float));
+            }
+            else
+            {
+                for (size_t i = 0; i < vertices.size(); ++i, pDst += sizeof(TriangleMesh::Vertex))
+                {
+                    float* pValues = reinterpret_cast<float*>(pDst);
+                    for (size_t j = 0; j < N; ++j)
+                        pValues[j] = *getNdarrayElement<float>(array, i, j);
+                }
+            }
+        }
+
+        /** Create a triangle mesh from ndarrays (numpy, torch etc.).
+            The data is copied into the mesh, as the mesh stores interleaved vertices. The arrays are read in-place,
+            so non-contiguous views (e.g. slices) don't need to be made contiguous first.
+        */
+        ref<TriangleMesh> createFromArrays(const FloatArray& positions, const FloatArray& normals, const IndexArray& indices, std::optional<FloatArray> texCoords, bool frontFaceCW)
+        {
+            FALCOR_CHECK(positions.device_type() == pybind11::device::cpu::value, "'positions' must be a CPU array.");
+            FALCOR_CHECK(positions.shape(1) == 3, "'positions' must have shape [N, 3].");
+            FALCOR_CHECK(normals.device_type() == pybind11::device::cpu::value, "'normals' must be a CPU array.");
+            FALCOR_CHECK(normals.shape(0) == positions.shape(0) && normals.shape(1) == 3, "'normals' must have shape [N, 3].");
+            if (texCoords)
+            {
+                FALCOR_CHECK(texCoords->device_type() == pybind11::device::cpu::value, "'texCoords' must be a CPU array.");
+                FALCOR_CHECK(texCoords->shape(0) == positions.shape(0) && texCoords->shape(1) == 2, "'texCoords' must have shape [N, 2].");
+            }
+            FALCOR_CHECK(indices.device_type() == pybind11::device::cpu::value, "'indices' must be a CPU array.");
+            FALCOR_CHECK(getNdarraySize(indices) % 3 == 0, "'indices' must contain a multiple of 3 indices.");
+
+            const size_t vertexCount = positions.shape(0);
+            TriangleMesh::VertexList vertices(vertexCount, TriangleMesh::Vertex{ float3(0.f), float3(0.f), float2(0.f) });
+            copyVertexAttribute<3>(positions, vertices, offsetof(TriangleMesh::Vertex, position));
+            copyVertexAttribute<3>(normals, vertices, offsetof(TriangleMesh::Vertex, normal));
+            if (texCoords)
+                copyVertexAttribute<2>(*texCoords, vertices, offsetof(TriangleMesh::Vertex, texCoord));
+
+            const uint32_t* pIndices = indices.data();
+            TriangleMesh::IndexList indexList(pIndices, pIndices + getNdarraySize(indices));
+            for (uint32_t index : indexList)
+                FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range (vertex count is {}).", index, vertexCount);
+
+            return TriangleMesh::create(vertices, indexList, frontFaceCW);
+        }
+    }
+
     FALCOR_SCRIPT_BINDING(TriangleMesh)
     {
         using namespace pybind11::literals;
@@ -346,6 +441,22 @@ namespace Falcor
         triangleMesh.def(pybind11::init(pybind11::overload_cast<>(&TriangleMesh::create)));
         triangleMesh.def("addVertex", &TriangleMesh::addVertex, "position"_a, "normal"_a, "texCoord"_a);
         triangleMesh.def("addTriangle", &TriangleMesh::addTriangle, "i0"_a, "i1"_a, "i2"_a);
+
+        // Zero-copy numpy views of the vertex and index data.
+        triangleMesh.def_property_readonly("positionArray",
+            [](const ref<TriangleMesh>& self) { return createVertexAttributeView<3>(self, offsetof(TriangleMesh::Vertex, position)); },
+            pybind11::return_value_policy::reference);
+        triangleMesh.def_property_readonly("normalArray",
+            [](const ref<TriangleMesh>& self) { return createVertexAttributeView<3>(self, offsetof(TriangleMesh::Vertex, normal)); },
+            pybind11::return_value_policy::reference);
+        triangleMesh.def_property_readonly("texCoordArray",
+            [](const ref<TriangleMesh>& self) { return createVertexAttributeView<2>(self, offsetof(TriangleMesh::Vertex, texCoord)); },
+            pybind11::return_value_policy::reference);
+        triangleMesh.def_property_readonly("indexArray", createIndexView, pybind11::return_value_policy::reference);
+        triangleMesh.def_static("createFromArrays", createFromArrays,
+            "positions"_a, "normals"_a, "indices"_a, "texCoords"_a = std::nullopt, "frontFaceCW"_a = false,
+            "Create a triangle mesh from float32 arrays of shape [N, 3] (positions, normals) and [N, 2] (texCoords) and a uint32 index array. "
+            "The data is copied into the mesh's interleaved vertex and index lists.");
         triangleMesh.def_static("createQuad", &TriangleMesh::createQuad, "size"_a = float2(1.f));
         triangleMesh.def_static("createDisk", &TriangleMesh::createDisk, "radius"_a = 1.f, "segments"_a = 32);
         triangleMesh.def_static("createCube", &TriangleMesh::createCube, "size"_a = float3(1.f));
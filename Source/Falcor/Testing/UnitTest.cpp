@@ -554,6 +554,13 @@ std::vector<Test> enumerateTests()
                 tests.push_back(test);
             }
 #endif
+            // The CPU device only supports a subset of shader features, so tests need to opt in explicitly.
+            if (desc.options.deviceTypes.count(Device::Type::CPU))
+            {
+                test.deviceType = Device::Type::CPU;
+                test.name = fmt::format("{} (CPU)", desc.name);
+                tests.push_back(test);
+            }
         }
     }
 
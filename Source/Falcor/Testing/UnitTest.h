@@ -592,6 +592,12 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
  *
  * GPU_TEST(Test6, Device::Type::D3D12) {} // Test is only run on D3D12 (same as above)
  *
+ * The CPU device (Device::Type::CPU) is never selected implicitly. Tests whose kernels
+ * only use features supported by the host target (no raster, ray tracing, wave ops or
+ * group barriers) need to list it explicitly:
+ *
+ * GPU_TEST(Test7, DEVICE_TYPES(Device::Type::D3D12, Device::Type::Vulkan, Device::Type::CPU)) {} // Test is also run on the CPU
+ *
  * Note: All GPU tests are implicitly tagged with "gpu".
  */
 #define GPU_TEST(name, ...)                                                     \
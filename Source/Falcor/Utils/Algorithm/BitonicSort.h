@@ -43,7 +43,7 @@ class RenderContext;
  * The time complexity is O(N*log^2(N)), but it parallelizes very well and has practically no branching.
  * The sort is implemented using horizontal operations within warps, and shared memory across warps.
  *
- * This code requires an NVIDIA GPU and NVAPI.
+ * This code requires an NVIDIA GPU and NVAPI, or the CPU device.
  */
 class FALCOR_API BitonicSort
 {
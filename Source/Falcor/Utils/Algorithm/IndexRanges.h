@@ -0,0 +1,64 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Error.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Iterate over ranges of consecutive indices in a sorted list of unique indices.
+ * Indices that are separated by at most maxGap missing indices are coalesced into a single range.
+ * This is used to turn sparse sets of dirty elements into a small number of buffer uploads,
+ * trading a few redundant bytes for fewer upload calls.
+ * @param indices Sorted list of unique indices.
+ * @param maxGap Maximum number of missing indices to include in a range.
+ * @param func Function called as func(offset, count) for each range.
+ */
+template<typename T, typename Func>
+void forEachIndexRange(const std::vector<T>& indices, T maxGap, Func func)
+{
+    size_t i = 0;
+    while (i < indices.size())
+    {
+        T first = indices[i];
+        T last = first;
+        for (++i; i < indices.size(); ++i)
+        {
+            FALCOR_ASSERT(indices[i] > last);
+            if (indices[i] - last - 1 > maxGap)
+                break;
+            last = indices[i];
+        }
+        func(first, last - first + 1);
+    }
+}
+
+} // namespace Falcor
@@ -0,0 +1,604 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BatchJobs.h"
+#include "Core/Error.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Timing/CpuTimer.h"
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <optional>
+#include <set>
+#include <sstream>
+
+namespace Falcor
+{
+
+namespace
+{
+using json = nlohmann::ordered_json;
+
+const std::set<std::string> kJobKeys = {
+    "name", "scene", "graph", "passProperties", "camera", "frames", "subframes", "resolution", "region", "tileSize", "tileOrder", "outputs", "output",
+};
+
+float3 parseFloat3(const json& j, std::string_view key)
+{
+    FALCOR_CHECK(j.is_array() && j.size() == 3, "'{}' must be an array of 3 numbers.", key);
+    return float3(j[0].get<float>(), j[1].get<float>(), j[2].get<float>());
+}
+
+std::filesystem::path resolvePath(const std::filesystem::path& path, const std::filesystem::path& baseDirectory)
+{
+    return path.is_relative() ? baseDirectory / path : path;
+}
+
+/// Escape braces so that a string is printed verbatim by fmt.
+std::string escapeFormat(std::string str)
+{
+    str = replaceSubstring(str, "{", "{{");
+    return replaceSubstring(str, "}", "}}");
+}
+
+BatchJob::Camera parseCamera(const json& j)
+{
+    BatchJob::Camera camera;
+    if (j.is_string())
+    {
+        camera.type = BatchJob::Camera::Type::Name;
+        camera.name = j.get<std::string>();
+    }
+    else if (j.is_object() && j.contains("viewpoint"))
+    {
+        camera.type = BatchJob::Camera::Type::Viewpoint;
+        camera.viewpoint = j["viewpoint"].get<uint32_t>();
+    }
+    else if (j.is_object() && j.contains("position"))
+    {
+        FALCOR_CHECK(j.contains("target"), "'camera' requires a 'target' if 'position' is given.");
+        camera.type = BatchJob::Camera::Type::LookAt;
+        camera.position = parseFloat3(j["position"], "position");
+        camera.target = parseFloat3(j["target"], "target");
+        if (j.contains("up"))
+            camera.up = parseFloat3(j["up"], "up");
+    }
+    else
+    {
+        FALCOR_THROW("'camera' must be a camera name, a viewpoint or a position and target.");
+    }
+    return camera;
+}
+
+BatchJob::FrameRange parseFrames(const json& j)
+{
+    BatchJob::FrameRange frames;
+    if (j.is_number())
+    {
+        frames.start = frames.end = j.get<uint32_t>();
+    }
+    else
+    {
+        FALCOR_CHECK(j.is_array() && (j.size() == 2 || j.size() == 3), "'frames' must be a frame index or an array [start, end(, step)].");
+        frames.start = j[0].get<uint32_t>();
+        frames.end = j[1].get<uint32_t>();
+        if (j.size() == 3)
+            frames.step = j[2].get<uint32_t>();
+    }
+    FALCOR_CHECK(frames.end >= frames.start, "'frames' end must not be smaller than start.");
+    FALCOR_CHECK(frames.step >= 1, "'frames' step must be at least 1.");
+    return frames;
+}
+
+BatchJob parseJob(const json& j, const std::filesystem::path& baseDirectory)
+{
+    BatchJob job;
+    job.name = j["name"].get<std::string>();
+
+    for (const auto& [key, value] : j.items())
+        FALCOR_CHECK(kJobKeys.count(key) > 0, "Unknown key '{}'.", key);
+
+    FALCOR_CHECK(j.contains("scene"), "'scene' is missing.");
+    job.scene = resolvePath(j["scene"].get<std::string>(), baseDirectory);
+    FALCOR_CHECK(j.contains("graph"), "'graph' is missing.");
+    job.graph = resolvePath(j["graph"].get<std::string>(), baseDirectory);
+
+    if (j.contains("passProperties"))
+    {
+        const json& passProperties = j["passProperties"];
+        FALCOR_CHECK(passProperties.is_object(), "'passProperties' must be an object.");
+        for (const auto& [passName, props] : passProperties.items())
+        {
+            FALCOR_CHECK(props.is_object(), "Properties of pass '{}' must be an object.", passName);
+            job.passProperties.emplace(passName, Properties(props));
+        }
+    }
+
+    if (j.contains("camera"))
+        job.camera = parseCamera(j["camera"]);
+    if (j.contains("frames"))
+        job.frames = parseFrames(j["frames"]);
+    if (j.contains("subframes"))
+        job.subframes = j["subframes"].get<uint32_t>();
+    FALCOR_CHECK(job.subframes >= 1, "'subframes' must be at least 1.");
+
+    if (j.contains("resolution"))
+    {
+        const json& resolution = j["resolution"];
+        FALCOR_CHECK(resolution.is_array() && resolution.size() == 2, "'resolution' must be an array [width, height].");
+        job.resolution = uint2(resolution[0].get<uint32_t>(), resolution[1].get<uint32_t>());
+        FALCOR_CHECK(job.resolution.x > 0 && job.resolution.y > 0, "'resolution' must not be zero.");
+    }
+
+    if (j.contains("region"))
+    {
+        const json& region = j["region"];
+        FALCOR_CHECK(region.is_array() && region.size() == 4, "'region' must be an array [x, y, width, height].");
+        job.region.offset = uint2(region[0].get<uint32_t>(), region[1].get<uint32_t>());
+        job.region.extent = uint2(region[2].get<uint32_t>(), region[3].get<uint32_t>());
+        FALCOR_CHECK(!job.region.isEmpty(), "'region' must not be empty.");
+    }
+
+    if (j.contains("tileSize"))
+    {
+        const json& tileSize = j["tileSize"];
+        if (tileSize.is_number())
+        {
+            job.tileSize = uint2(tileSize.get<uint32_t>());
+        }
+        else
+        {
+            FALCOR_CHECK(tileSize.is_array() && tileSize.size() == 2, "'tileSize' must be a number or an array [width, height].");
+            job.tileSize = uint2(tileSize[0].get<uint32_t>(), tileSize[1].get<uint32_t>());
+        }
+        FALCOR_CHECK(job.tileSize.x > 0 && job.tileSize.y > 0, "'tileSize' must not be zero.");
+    }
+
+    if (j.contains("tileOrder"))
+    {
+        // Error priority needs error estimates of a previous render, which batch jobs don't have.
+        job.tileOrder = stringToEnum<TileScheduler::Order>(j["tileOrder"].get<std::string>());
+        FALCOR_CHECK(job.tileOrder != TileScheduler::Order::ErrorPriority, "'tileOrder' must be 'Scanline' or 'Spiral'.");
+    }
+
+    if (job.isTiled())
+    {
+        FALCOR_CHECK(job.resolution.x > 0, "'region' and 'tileSize' require a 'resolution'.");
+        FALCOR_CHECK(
+            job.region.isEmpty() || all(job.region.offset < job.resolution), "'region' must overlap the frame of size {}x{}.", job.resolution.x, job.resolution.y
+        );
+    }
+
+    if (j.contains("outputs"))
+        job.outputs = j["outputs"].get<std::vector<std::string>>();
+
+    FALCOR_CHECK(j.contains("output"), "'output' is missing.");
+    const std::string pattern = j["output"].get<std::string>();
+    FALCOR_CHECK(!pattern.empty(), "'output' must not be empty.");
+    job.outputPattern = std::filesystem::path(pattern).is_relative() ? escapeFormat(baseDirectory.string()) + "/" + pattern : pattern;
+
+    // Validate the pattern. Frames and outputs must map to distinct files.
+    try
+    {
+        if (job.frames.end >= job.frames.start + job.frames.step)
+            FALCOR_CHECK(
+                job.getOutputPath("output", job.frames.start) != job.getOutputPath("output", job.frames.start + job.frames.step),
+                "'output' must contain {frame} if multiple frames are rendered."
+            );
+        if (job.outputs.size() != 1)
+            FALCOR_CHECK(job.getOutputPath("a", 0) != job.getOutputPath("b", 0), "'output' must contain {output} unless exactly one output is listed.");
+    }
+    catch (const fmt::format_error& e)
+    {
+        FALCOR_THROW("Invalid 'output' pattern '{}': {}", pattern, e.what());
+    }
+
+    return job;
+}
+} // namespace
+
+std::string BatchJob::Camera::getDescription() const
+{
+    switch (type)
+    {
+    case Type::Default:
+        return "default";
+    case Type::Name:
+        return name;
+    case Type::Viewpoint:
+        return fmt::format("viewpoint{}", viewpoint);
+    case Type::LookAt:
+        return "lookat";
+    }
+    FALCOR_UNREACHABLE();
+}
+
+std::vector<uint32_t> BatchJob::FrameRange::getFrames() const
+{
+    std::vector<uint32_t> result;
+    for (uint64_t frame = start; frame <= end; frame += step)
+        result.push_back((uint32_t)frame);
+    return result;
+}
+
+std::string BatchJob::getGraphKey() const
+{
+    std::string key = graph.string();
+    for (const auto& [passName, props] : passProperties)
+        key += "\n" + passName + "=" + props.toJson().dump();
+    return key;
+}
+
+std::filesystem::path BatchJob::getOutputPath(std::string_view output, uint32_t frame) const
+{
+    return fmt::format(
+        fmt::runtime(outputPattern),
+        fmt::arg("job", name),
+        fmt::arg("scene", scene.stem().string()),
+        fmt::arg("graph", graph.stem().string()),
+        fmt::arg("camera", camera.getDescription()),
+        fmt::arg("output", output),
+        fmt::arg("frame", frame)
+    );
+}
+
+std::vector<BatchJob> BatchJob::parse(std::string_view text, const std::filesystem::path& baseDirectory)
+{
+    json root;
+    try
+    {
+        root = json::parse(text);
+    }
+    catch (const json::exception& e)
+    {
+        FALCOR_THROW("Invalid batch job file: {}", e.what());
+    }
+
+    FALCOR_CHECK(root.is_object(), "Batch job file must contain a JSON object.");
+    for (const auto& [key, value] : root.items())
+        FALCOR_CHECK(key == "defaults" || key == "jobs", "Unknown key '{}' in batch job file.", key);
+
+    const json defaults = root.value("defaults", json::object());
+    FALCOR_CHECK(defaults.is_object(), "'defaults' must be an object.");
+    FALCOR_CHECK(!defaults.contains("name"), "'defaults' must not contain a job name.");
+    FALCOR_CHECK(root.contains("jobs") && root["jobs"].is_array(), "Batch job file must contain a 'jobs' array.");
+
+    std::vector<BatchJob> jobs;
+    std::set<std::string> names;
+    for (const json& jobJson : root["jobs"])
+    {
+        FALCOR_CHECK(jobJson.is_object(), "Jobs must be objects.");
+        json merged = defaults;
+        merged.update(jobJson);
+        if (!merged.contains("name"))
+            merged["name"] = fmt::format("job{}", jobs.size());
+
+        std::string name = merged["name"].is_string() ? merged["name"].get<std::string>() : std::string();
+        FALCOR_CHECK(!name.empty(), "Job {} has an invalid name.", jobs.size());
+        FALCOR_CHECK(names.insert(name).second, "Job name '{}' is not unique.", name);
+
+        try
+        {
+            jobs.push_back(parseJob(merged, baseDirectory));
+        }
+        catch (const std::exception& e)
+        {
+            FALCOR_THROW("Invalid batch job '{}': {}", name, e.what());
+        }
+    }
+
+    return jobs;
+}
+
+std::vector<BatchJob> BatchJob::parseFile(const std::filesystem::path& path)
+{
+    std::ifstream stream(path);
+    FALCOR_CHECK(stream, "Failed to open batch job file '{}'.", path);
+    std::stringstream text;
+    text << stream.rdbuf();
+    return parse(text.str(), std::filesystem::absolute(path).parent_path());
+}
+
+uint32_t BatchReport::getFailedCount() const
+{
+    return (uint32_t)std::count_if(jobs.begin(), jobs.end(), [](const Job& job) { return !job.succeeded; });
+}
+
+std::string BatchReport::toJsonString() const
+{
+    json j;
+    j["totalTime"] = totalTime;
+    j["failedCount"] = getFailedCount();
+    j["jobs"] = json::array();
+    for (const Job& job : jobs)
+    {
+        json jobJson;
+        jobJson["name"] = job.name;
+        jobJson["succeeded"] = job.succeeded;
+        if (!job.succeeded)
+            jobJson["error"] = job.error;
+        jobJson["sceneLoadTime"] = job.sceneLoadTime;
+        jobJson["graphLoadTime"] = job.graphLoadTime;
+        jobJson["renderTime"] = job.renderTime;
+        jobJson["framesRendered"] = job.framesRendered;
+        jobJson["files"] = json::array();
+        for (const auto& file : job.files)
+            jobJson["files"].push_back(file.string());
+        jobJson["memory"]["processBytes"] = job.memory.processBytes;
+        jobJson["memory"]["peakProcessBytes"] = job.memory.peakProcessBytes;
+        jobJson["memory"]["sceneBytes"] = job.memory.sceneBytes;
+        j["jobs"].push_back(jobJson);
+    }
+    return j.dump(4);
+}
+
+std::string BatchReport::getSummary() const
+{
+    std::string summary;
+    for (const Job& job : jobs)
+    {
+        if (job.succeeded)
+        {
+            summary += fmt::format(
+                "{}: succeeded, {} frames, scene load {:.2f} s, graph load {:.2f} s, render {:.2f} s, memory {}\n",
+                job.name,
+                job.framesRendered,
+                job.sceneLoadTime,
+                job.graphLoadTime,
+                job.renderTime,
+                formatByteSize(job.memory.processBytes)
+            );
+        }
+        else
+        {
+            summary += fmt::format("{}: failed: {}\n", job.name, job.error);
+        }
+    }
+    summary += fmt::format("{} of {} jobs succeeded in {:.2f} s.", jobs.size() - getFailedCount(), jobs.size(), totalTime);
+    return summary;
+}
+
+std::vector<size_t> BatchRunner::schedule(const std::vector<BatchJob>& jobs)
+{
+    // Group jobs by scene, in order of first appearance.
+    std::vector<std::vector<size_t>> sceneGroups;
+    std::map<std::filesystem::path, size_t> sceneIndices;
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        auto [it, inserted] = sceneIndices.emplace(jobs[i].scene, sceneGroups.size());
+        if (inserted)
+            sceneGroups.emplace_back();
+        sceneGroups[it->second].push_back(i);
+    }
+
+    std::vector<size_t> order;
+    std::optional<std::string> lastGraphKey;
+    for (const auto& sceneGroup : sceneGroups)
+    {
+        // Group by graph variant and then by resolution, in order of first appearance.
+        std::vector<std::string> graphKeys;
+        std::map<size_t, std::pair<size_t, size_t>> ranks;
+        std::map<size_t, std::vector<uint2>> resolutions;
+        for (size_t i : sceneGroup)
+        {
+            const std::string key = jobs[i].getGraphKey();
+            size_t graphRank = std::find(graphKeys.begin(), graphKeys.end(), key) - graphKeys.begin();
+            if (graphRank == graphKeys.size())
+                graphKeys.push_back(key);
+            auto& graphResolutions = resolutions[graphRank];
+            size_t resolutionRank = std::find_if(
+                                        graphResolutions.begin(),
+                                        graphResolutions.end(),
+                                        [&](uint2 r) { return all(r == jobs[i].resolution); }
+                                    ) -
+                                    graphResolutions.begin();
+            if (resolutionRank == graphResolutions.size())
+                graphResolutions.push_back(jobs[i].resolution);
+            ranks[i] = {graphRank, resolutionRank};
+        }
+
+        // The graph variant loaded last for the previous scene is scheduled first.
+        size_t firstGraph = lastGraphKey ? std::find(graphKeys.begin(), graphKeys.end(), *lastGraphKey) - graphKeys.begin() : 0;
+        if (firstGraph < graphKeys.size())
+        {
+            for (auto& [i, rank] : ranks)
+            {
+                if (rank.first == firstGraph)
+                    rank.first = 0;
+                else if (rank.first < firstGraph)
+                    rank.first++;
+            }
+        }
+
+        std::vector<size_t> sorted = sceneGroup;
+        std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+        order.insert(order.end(), sorted.begin(), sorted.end());
+        lastGraphKey = jobs[sorted.back()].getGraphKey();
+    }
+
+    return order;
+}
+
+BatchReport BatchRunner::run(const std::vector<BatchJob>& jobs, Executor& executor)
+{
+    const auto startTime = CpuTimer::getCurrentTimePoint();
+    auto getSecondsSince = [](CpuTimer::TimePoint t) { return CpuTimer::calcDuration(t, CpuTimer::getCurrentTimePoint()) * 1e-3; };
+
+    BatchReport report;
+
+    // Currently loaded state. Reset whenever the state is unknown after a failure.
+    std::optional<std::filesystem::path> currentScene;
+    std::optional<std::string> currentGraphKey;
+    const uint2 defaultResolution = executor.getResolution();
+    uint2 currentResolution = defaultResolution;
+
+    // Errors of scenes and graphs that failed to load. These are not attempted again.
+    std::map<std::filesystem::path, std::string> failedScenes;
+    std::map<std::string, std::string> failedGraphs;
+
+    for (size_t index : schedule(jobs))
+    {
+        const BatchJob& job = jobs[index];
+        BatchReport::Job& result = report.jobs.emplace_back();
+        result.name = job.name;
+
+        bool rendering = false;
+        try
+        {
+            if (auto it = failedScenes.find(job.scene); it != failedScenes.end())
+                FALCOR_THROW("Failed to load scene '{}': {}", job.scene, it->second);
+            if (currentScene != job.scene)
+            {
+                currentScene.reset();
+                const auto t = CpuTimer::getCurrentTimePoint();
+                try
+                {
+                    executor.loadScene(job.scene);
+                }
+                catch (const std::exception& e)
+                {
+                    failedScenes[job.scene] = e.what();
+                    throw;
+                }
+                currentScene = job.scene;
+                result.sceneLoadTime = getSecondsSince(t);
+            }
+
+            const std::string graphKey = job.getGraphKey();
+            if (auto it = failedGraphs.find(graphKey); it != failedGraphs.end())
+                FALCOR_THROW("Failed to load graph '{}': {}", job.graph, it->second);
+            if (currentGraphKey != graphKey)
+            {
+                currentGraphKey.reset();
+                const auto t = CpuTimer::getCurrentTimePoint();
+                try
+                {
+                    executor.loadGraph(job.graph, job.passProperties);
+                }
+                catch (const std::exception& e)
+                {
+                    failedGraphs[graphKey] = e.what();
+                    throw;
+                }
+                currentGraphKey = graphKey;
+                result.graphLoadTime = getSecondsSince(t);
+            }
+
+            rendering = true;
+            const auto t = CpuTimer::getCurrentTimePoint();
+
+            const uint2 resolution = job.resolution.x > 0 ? job.resolution : defaultResolution;
+            if (any(resolution != currentResolution))
+            {
+                currentResolution = uint2(0);
+                executor.setResolution(resolution);
+                currentResolution = resolution;
+            }
+
+            executor.setCamera(job.camera);
+            executor.resetTemporalState();
+
+            const std::vector<std::string> outputs = job.outputs.empty() ? executor.getOutputs() : job.outputs;
+            FALCOR_CHECK(!outputs.empty(), "Graph '{}' has no outputs to capture.", job.graph);
+            if (!job.outputs.empty())
+                executor.markOutputs(job.outputs);
+            FALCOR_CHECK(outputs.size() == 1 || job.getOutputPath("a", 0) != job.getOutputPath("b", 0), "'output' must contain {output}.");
+
+            std::optional<TileScheduler> scheduler;
+            std::vector<uint32_t> schedule;
+            if (job.isTiled())
+            {
+                // Without a tile size, the region is rendered as a single tile.
+                const uint2 tileSize = job.tileSize.x > 0 ? job.tileSize : job.resolution;
+                scheduler.emplace(job.resolution, tileSize, job.region);
+                schedule = scheduler->getSchedule(job.tileOrder);
+            }
+
+            for (uint32_t frame : job.frames.getFrames())
+            {
+                if (scheduler)
+                {
+                    for (uint32_t index : schedule)
+                    {
+                        const RenderTile& tile = scheduler->getTile(index);
+                        executor.setRenderTile(tile);
+                        for (uint32_t subframe = 0; subframe < job.subframes; subframe++)
+                        {
+                            executor.renderFrame(frame);
+                            result.framesRendered++;
+                        }
+                        for (const auto& output : outputs)
+                            executor.captureTile(output, scheduler->getRegion(), tile);
+                    }
+                    executor.setRenderTile(RenderTile());
+
+                    for (const auto& output : outputs)
+                    {
+                        const std::filesystem::path path = job.getOutputPath(output, frame);
+                        executor.writeStitchedOutput(output, path);
+                        result.files.push_back(path);
+                    }
+                    continue;
+                }
+
+                for (uint32_t subframe = 0; subframe < job.subframes; subframe++)
+                {
+                    executor.renderFrame(frame);
+                    result.framesRendered++;
+                }
+                for (const auto& output : outputs)
+                {
+                    const std::filesystem::path path = job.getOutputPath(output, frame);
+                    executor.captureOutput(output, path);
+                    result.files.push_back(path);
+                }
+            }
+
+            result.renderTime = getSecondsSince(t);
+            result.succeeded = true;
+        }
+        catch (const std::exception& e)
+        {
+            result.error = e.what();
+            // The graph state is unknown after a failure while rendering, reload it for the next job.
+            if (rendering)
+                currentGraphKey.reset();
+        }
+
+        result.memory = executor.getMemoryUsage();
+    }
+
+    report.totalTime = getSecondsSince(startTime);
+    return report;
+}
+
+} // namespace Falcor
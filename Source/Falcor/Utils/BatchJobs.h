@@ -0,0 +1,261 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "Core/Macros.h"
+#include "Rendering/Utils/TileScheduler.h"
+#include "Utils/Math/VectorTypes.h"
+#include "Utils/Properties.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Description of a batch render job.
+ *
+ * A job renders a range of frames of a scene from a single camera with a single render graph
+ * variant and writes the graph outputs of every frame to files. Jobs are typically loaded
+ * from a JSON job file, see parse() for the format.
+ */
+struct FALCOR_API BatchJob
+{
+    struct Camera
+    {
+        enum class Type
+        {
+            Default,   ///< Keep the scene's active camera.
+            Name,      ///< Select a scene camera by name.
+            Viewpoint, ///< Select a scene viewpoint by index.
+            LookAt,    ///< Explicit camera position and target.
+        };
+
+        Type type = Type::Default;
+        std::string name;
+        uint32_t viewpoint = 0;
+        float3 position = float3(0.f);
+        float3 target = float3(0.f, 0.f, -1.f);
+        float3 up = float3(0.f, 1.f, 0.f);
+
+        /// Return a short description used in reports and output file names.
+        std::string getDescription() const;
+    };
+
+    /// Inclusive range of frames.
+    struct FrameRange
+    {
+        uint32_t start = 0;
+        uint32_t end = 0;
+        uint32_t step = 1;
+
+        std::vector<uint32_t> getFrames() const;
+    };
+
+    std::string name;
+    std::filesystem::path scene;
+    std::filesystem::path graph;
+    /// Render pass property overrides (pass name to properties), selecting a variant of the graph.
+    std::map<std::string, Properties> passProperties;
+    Camera camera;
+    FrameRange frames;
+    /// Number of times each frame is rendered before its outputs are captured (e.g. for accumulation).
+    uint32_t subframes = 1;
+    /// Frame buffer resolution. Zero uses the resolution the batch was started with.
+    uint2 resolution = uint2(0);
+    /// Region of the frame to render. Outputs are cropped to the region. An empty region renders the whole frame.
+    RenderTile region;
+    /// Tile size for tiled rendering. Zero renders the region at once.
+    uint2 tileSize = uint2(0);
+    /// Order in which the tiles are rendered.
+    TileScheduler::Order tileOrder = TileScheduler::Order::Spiral;
+    /// Graph outputs to capture. Empty captures all marked outputs.
+    std::vector<std::string> outputs;
+    /// Output file pattern, see getOutputPath().
+    std::string outputPattern;
+
+    /// Return a key identifying the graph variant. Jobs with equal keys can share a loaded graph.
+    std::string getGraphKey() const;
+
+    /// Return true if the job renders tiles or a region of the frame, which are stitched into the outputs.
+    bool isTiled() const { return !region.isEmpty() || tileSize.x > 0; }
+
+    /**
+     * Return the path of a captured output file.
+     * The output pattern is formatted with the named arguments {job}, {scene}, {graph}, {camera}, {output} and {frame}.
+     * Format specifications are supported, for example "{frame:04}".
+     * @param output Graph output name.
+     * @param frame Frame index.
+     * @return Output file path.
+     */
+    std::filesystem::path getOutputPath(std::string_view output, uint32_t frame) const;
+
+    /**
+     * Parse a batch job file.
+     *
+     * The job file is a JSON object with an optional "defaults" object and a "jobs" array.
+     * Each job is an object with the following keys; missing keys are taken from the defaults:
+     * - "name": Unique job name (default: "job<index>").
+     * - "scene": Scene file (required).
+     * - "graph": Render graph file, a Python script or JSON graph (required).
+     * - "passProperties": Object mapping pass names to property overrides.
+     * - "camera": Camera name (string), {"viewpoint": index} or {"position": [x,y,z], "target": [x,y,z], "up": [x,y,z]}.
+     * - "frames": Frame index, or inclusive range [start, end] or [start, end, step] (default: 0).
+     * - "subframes": Number of times each frame is rendered before capturing (default: 1).
+     * - "resolution": Frame buffer resolution [width, height].
+     * - "region": Region of the frame to render [x, y, width, height]. Requires a resolution.
+     * - "tileSize": Render the region in tiles of the given size, [width, height] or a single number. Requires a resolution.
+     * - "tileOrder": Order in which tiles are rendered, "Scanline" or "Spiral" (default: "Spiral").
+     * - "outputs": Graph outputs to capture (default: all marked outputs).
+     * - "output": Output file pattern (required). Must contain {frame} if the job renders multiple frames
+     *   and {output} unless exactly one output is listed.
+     *
+     * Relative paths are resolved against the given base directory.
+     * Throws if the file is invalid.
+     * @param text JSON text.
+     * @param baseDirectory Base directory for relative paths.
+     * @return List of jobs in file order.
+     */
+    static std::vector<BatchJob> parse(std::string_view text, const std::filesystem::path& baseDirectory);
+
+    /// Parse a batch job file from disk. Relative paths are resolved against the file's directory.
+    static std::vector<BatchJob> parseFile(const std::filesystem::path& path);
+};
+
+/// Memory usage reported after each job.
+struct BatchMemoryUsage
+{
+    uint64_t processBytes = 0;     ///< Resident memory of the process.
+    uint64_t peakProcessBytes = 0; ///< Peak resident memory of the process.
+    uint64_t sceneBytes = 0;       ///< GPU memory used by the scene.
+};
+
+/// Results of a batch run.
+struct FALCOR_API BatchReport
+{
+    struct Job
+    {
+        std::string name;
+        bool succeeded = false;
+        std::string error;
+        double sceneLoadTime = 0.0; ///< Time spent loading the scene in seconds (zero if the scene was reused).
+        double graphLoadTime = 0.0; ///< Time spent loading the graph in seconds (zero if the graph was reused).
+        double renderTime = 0.0;    ///< Time spent rendering and capturing in seconds.
+        uint32_t framesRendered = 0;
+        std::vector<std::filesystem::path> files;
+        BatchMemoryUsage memory;
+    };
+
+    std::vector<Job> jobs; ///< Results in execution order.
+    double totalTime = 0.0;
+
+    uint32_t getFailedCount() const;
+
+    /// Return the report as a JSON string.
+    std::string toJsonString() const;
+
+    /// Return a human readable summary.
+    std::string getSummary() const;
+};
+
+/**
+ * Schedules and runs batch jobs.
+ *
+ * Jobs are reordered to minimize expensive state changes: jobs are grouped by scene, then by
+ * graph variant and resolution, keeping the file order otherwise. The graph variant loaded
+ * last for a scene is scheduled first for the next scene, so that it is reused across scenes.
+ *
+ * Failures are isolated per job. If a scene or graph fails to load, only the jobs using it fail,
+ * and it is not attempted again. If rendering fails, the job fails and the graph is reloaded for
+ * the next job.
+ *
+ * Every job starts from the same state: temporal state of the graph is reset before its first frame,
+ * and jobs without a resolution render at the resolution the batch was started with.
+ *
+ * Tiled jobs render each frame tile by tile, in the order given by a TileScheduler. All subframes
+ * of a tile are rendered before the next tile, and the tiles are stitched into the outputs.
+ *
+ * The actual work is delegated to an Executor, which makes the scheduling logic testable
+ * without a GPU.
+ */
+class FALCOR_API BatchRunner
+{
+public:
+    /// Interface performing the work of the jobs, implemented by the application.
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+        virtual void loadScene(const std::filesystem::path& path) = 0;
+        virtual void loadGraph(const std::filesystem::path& path, const std::map<std::string, Properties>& passProperties) = 0;
+        /// Return the current frame buffer resolution. Called once at the start of the batch.
+        virtual uint2 getResolution() = 0;
+        virtual void setResolution(uint2 resolution) = 0;
+        virtual void setCamera(const BatchJob::Camera& camera) = 0;
+        /// Render a frame. The frame index is the index of the frame in the animation, not the subframe.
+        virtual void renderFrame(uint32_t frame) = 0;
+        /// Reset temporal state (e.g. accumulation) of the loaded graph. Called before the first frame of every job.
+        virtual void resetTemporalState() = 0;
+        /// Return the marked outputs of the loaded graph.
+        virtual std::vector<std::string> getOutputs() = 0;
+        /// Mark outputs of the loaded graph before rendering. Called if a job explicitly lists its outputs.
+        virtual void markOutputs(const std::vector<std::string>& outputs) {}
+        virtual void captureOutput(const std::string& output, const std::filesystem::path& path) = 0;
+        /// Restrict rendering to a tile of the frame. An empty tile renders the whole frame.
+        virtual void setRenderTile(const RenderTile& tile) = 0;
+        /// Copy a rendered tile of an output into the stitched image of the output, which covers the given region.
+        virtual void captureTile(const std::string& output, const RenderTile& region, const RenderTile& tile) = 0;
+        /// Write the stitched image of an output to a file.
+        virtual void writeStitchedOutput(const std::string& output, const std::filesystem::path& path) = 0;
+        virtual BatchMemoryUsage getMemoryUsage() { return {}; }
+    };
+
+    /**
+     * Compute the execution order of a list of jobs.
+     * @param jobs Jobs in file order.
+     * @return Job indices in execution order.
+     */
+    static std::vector<size_t> schedule(const std::vector<BatchJob>& jobs);
+
+    /**
+     * Run a list of jobs.
+     * Errors are reported in the returned report, this function only throws if the executor throws
+     * from getMemoryUsage().
+     * @param jobs Jobs in file order.
+     * @param executor Executor performing the work.
+     * @return Report with the job results in execution order.
+     */
+    static BatchReport run(const std::vector<BatchJob>& jobs, Executor& executor);
+};
+
+} // namespace Falcor
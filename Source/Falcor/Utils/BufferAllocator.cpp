@@ -29,6 +29,8 @@
 #include "Core/API/Device.h"
 #include "Utils/Math/Common.h"
 
+#include <algorithm>
+
 namespace Falcor
 {
 BufferAllocator::BufferAllocator(size_t alignment, size_t elementSize, size_t cacheLineSize, ResourceBindFlags bindFlags)
@@ -52,8 +54,101 @@ BufferAllocator::BufferAllocator(size_t alignment, size_t elementSize, size_t ca
 
 size_t BufferAllocator::allocate(size_t byteSize)
 {
-    computeAndAllocatePadding(byteSize);
-    return allocInternal(byteSize);
+    size_t byteOffset;
+    if (allocFromFreeList(byteSize, byteOffset))
+    {
+        // Reused memory is zero initialized like newly allocated memory.
+        std::memset(mBuffer.data() + byteOffset, 0, byteSize);
+        markAsDirty(byteOffset, byteSize);
+    }
+    else
+    {
+        computeAndAllocatePadding(byteSize);
+        byteOffset = allocInternal(byteSize);
+    }
+
+    // Zero-sized allocations share their offset with the next allocation and are not tracked.
+    if (byteSize > 0)
+    {
+        mAllocations.emplace_hint(mAllocations.end(), byteOffset, byteSize);
+        mAllocatedSize += byteSize;
+    }
+    return byteOffset;
+}
+
+void BufferAllocator::free(size_t byteOffset)
+{
+    auto it = mAllocations.find(byteOffset);
+    FALCOR_CHECK(it != mAllocations.end(), "No allocation at offset {}.", byteOffset);
+    size_t start = byteOffset;
+    size_t end = byteOffset + it->second;
+    mAllocatedSize -= it->second;
+    mAllocations.erase(it);
+
+    // Coalesce with adjacent free blocks.
+    auto next = mFreeBlocks.lower_bound(start);
+    if (next != mFreeBlocks.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == start)
+        {
+            start = prev->first;
+            removeFreeBlock(prev->first, prev->second);
+        }
+    }
+    if (next != mFreeBlocks.end() && next->first == end)
+    {
+        end += next->second;
+        removeFreeBlock(next->first, next->second);
+    }
+
+    // Shrink the buffer if the block is at the end, otherwise keep it for reuse.
+    // Shrinking also releases the padding and free blocks after the last remaining allocation.
+    if (end == mBuffer.size())
+    {
+        size_t size = mAllocations.empty() ? 0 : mAllocations.rbegin()->first + mAllocations.rbegin()->second;
+        while (!mFreeBlocks.empty() && mFreeBlocks.rbegin()->first >= size)
+            removeFreeBlock(mFreeBlocks.rbegin()->first, mFreeBlocks.rbegin()->second);
+        mBuffer.resize(size);
+    }
+    else
+    {
+        insertFreeBlock(start, end - start);
+    }
+}
+
+std::vector<BufferAllocator::Relocation> BufferAllocator::compact()
+{
+    std::vector<Relocation> relocations;
+    std::map<size_t, size_t> allocations;
+
+    // Move allocations towards the start in order. The aligned offset is monotonic and each allocation
+    // already satisfies the alignment requirements at its old offset, so allocations only ever move down.
+    size_t end = 0;
+    for (const auto& [oldOffset, byteSize] : mAllocations)
+    {
+        size_t newOffset = computeAlignedOffset(end, byteSize);
+        FALCOR_ASSERT(newOffset <= oldOffset);
+        if (newOffset != oldOffset)
+        {
+            std::memmove(mBuffer.data() + newOffset, mBuffer.data() + oldOffset, byteSize);
+            relocations.push_back({oldOffset, newOffset, byteSize});
+        }
+        allocations.emplace_hint(allocations.end(), newOffset, byteSize);
+        end = newOffset + byteSize;
+    }
+
+    mAllocations = std::move(allocations);
+    mFreeBlocks.clear();
+    for (auto& freeList : mFreeLists)
+        freeList.clear();
+    mFreeSize = 0;
+    mBuffer.resize(end);
+
+    if (!relocations.empty())
+        markAsDirty(relocations.front().newOffset, end - relocations.front().newOffset);
+
+    return relocations;
 }
 
 void BufferAllocator::setBlob(const void* pData, size_t byteOffset, size_t byteSize)
@@ -73,7 +168,26 @@ void BufferAllocator::modified(size_t byteOffset, size_t byteSize)
 void BufferAllocator::clear()
 {
     mBuffer.clear();
-    mDirty = {};
+    mDirtyRanges.clear();
+    mAllocations.clear();
+    mFreeBlocks.clear();
+    for (auto& freeList : mFreeLists)
+        freeList.clear();
+    mAllocatedSize = 0;
+    mFreeSize = 0;
+}
+
+std::vector<BufferAllocator::Range> BufferAllocator::getDirtyRanges() const
+{
+    std::vector<Range> ranges = mDirtyRanges;
+    coalesceRanges(ranges, kDirtyRangeMergeDistance);
+
+    // Ranges may extend past the end of the buffer if it was shrunk.
+    while (!ranges.empty() && ranges.back().start >= mBuffer.size())
+        ranges.pop_back();
+    if (!ranges.empty())
+        ranges.back().end = std::min(ranges.back().end, mBuffer.size());
+    return ranges;
 }
 
 ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
@@ -104,29 +218,26 @@ ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
             mpGpuBuffer = pDevice->createBuffer(bufSize, mBindFlags, MemoryType::DeviceLocal, nullptr);
         }
 
-        mDirty = Range(0, mBuffer.size()); // Mark entire buffer as dirty so the data gets uploaded.
+        mDirtyRanges = {Range(0, mBuffer.size())}; // Mark entire buffer as dirty so the data gets uploaded.
     }
 
-    // If any range is dirty, upload the data from the CPU to the GPU.
-    if (mDirty.start < mDirty.end)
+    // Upload the coalesced dirty ranges from the CPU to the GPU.
+    FALCOR_ASSERT(mBuffer.size() <= mpGpuBuffer->getSize());
+    for (const auto& range : getDirtyRanges())
     {
-        size_t byteSize = mDirty.end - mDirty.start;
-        size_t byteOffset = mDirty.start;
-        FALCOR_ASSERT(byteOffset + byteSize <= mBuffer.size());
-        FALCOR_ASSERT(mBuffer.size() <= mpGpuBuffer->getSize());
-        mpGpuBuffer->setBlob(mBuffer.data() + byteOffset, byteOffset, byteSize);
-
-        mDirty = {mBuffer.size(), 0}; // Reset dirty range to inverted range. Any min/max operation on it will work.
+        FALCOR_ASSERT(range.start < range.end && range.end <= mBuffer.size());
+        mpGpuBuffer->setBlob(mBuffer.data() + range.start, range.start, range.end - range.start);
     }
+    mDirtyRanges.clear();
 
     return mpGpuBuffer;
 }
 
 // Private
 
-void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
+size_t BufferAllocator::computeAlignedOffset(size_t byteOffset, size_t byteSize) const
 {
-    size_t currentOffset = mBuffer.size();
+    size_t currentOffset = byteOffset;
 
     if (mAlignment > 0 && currentOffset % mAlignment > 0)
     {
@@ -145,6 +256,12 @@ void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
         }
     }
 
+    return currentOffset;
+}
+
+void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
+{
+    size_t currentOffset = computeAlignedOffset(mBuffer.size(), byteSize);
     size_t pad = currentOffset - mBuffer.size();
     if (pad > 0)
     {
@@ -157,13 +274,117 @@ size_t BufferAllocator::allocInternal(size_t byteSize)
 {
     size_t byteOffset = mBuffer.size();
     mBuffer.insert(mBuffer.end(), byteSize, {});
+    // The buffer may have shrunk, in which case the GPU buffer is not recreated and the new memory needs to be uploaded.
+    if (byteSize > 0)
+        markAsDirty(byteOffset, byteSize);
     return byteOffset;
 }
 
+bool BufferAllocator::allocFromFreeList(size_t byteSize, size_t& byteOffset)
+{
+    if (mFreeSize < byteSize || byteSize == 0)
+        return false;
+
+    // Search the size classes that can hold the allocation, starting with the smallest blocks (best fit).
+    // Blocks may still be too small if the allocation needs to be moved to avoid spanning cache lines,
+    // so only a few candidates are tried per size class to bound the search time.
+    for (size_t sizeClass = getSizeClass(byteSize); sizeClass < kSizeClassCount; ++sizeClass)
+    {
+        const auto& freeList = mFreeLists[sizeClass];
+        size_t candidates = 0;
+        for (auto it = freeList.lower_bound({byteSize, 0}); it != freeList.end() && candidates < kMaxFreeListCandidates; ++it, ++candidates)
+        {
+            const size_t blockOffset = it->second;
+            const size_t blockSize = mFreeBlocks[blockOffset];
+            const size_t offset = computeAlignedOffset(blockOffset, byteSize);
+            if (offset + byteSize > blockOffset + blockSize)
+                continue;
+
+            // Return the unused memory before and after the allocation to the free lists.
+            removeFreeBlock(blockOffset, blockSize);
+            if (offset > blockOffset)
+                insertFreeBlock(blockOffset, offset - blockOffset);
+            if (offset + byteSize < blockOffset + blockSize)
+                insertFreeBlock(offset + byteSize, blockOffset + blockSize - offset - byteSize);
+
+            byteOffset = offset;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void BufferAllocator::insertFreeBlock(size_t byteOffset, size_t byteSize)
+{
+    FALCOR_ASSERT(byteSize > 0);
+    mFreeBlocks.emplace(byteOffset, byteSize);
+    mFreeSize += byteSize;
+
+    // Blocks that are too small to hold any aligned allocation are only kept for coalescing.
+    if (size_t usableSize = getUsableSize(byteOffset, byteSize); usableSize > 0)
+        mFreeLists[getSizeClass(usableSize)].emplace(usableSize, byteOffset);
+}
+
+void BufferAllocator::removeFreeBlock(size_t byteOffset, size_t byteSize)
+{
+    mFreeBlocks.erase(byteOffset);
+    mFreeSize -= byteSize;
+
+    if (size_t usableSize = getUsableSize(byteOffset, byteSize); usableSize > 0)
+        mFreeLists[getSizeClass(usableSize)].erase({usableSize, byteOffset});
+}
+
+size_t BufferAllocator::getUsableSize(size_t byteOffset, size_t byteSize) const
+{
+    size_t alignedOffset = mAlignment > 0 ? align_to(mAlignment, byteOffset) : byteOffset;
+    return alignedOffset < byteOffset + byteSize ? byteOffset + byteSize - alignedOffset : 0;
+}
+
+size_t BufferAllocator::getSizeClass(size_t byteSize)
+{
+    size_t sizeClass = 0;
+    while (byteSize >>= 1)
+        sizeClass++;
+    return sizeClass;
+}
+
+void BufferAllocator::coalesceRanges(std::vector<Range>& ranges, size_t mergeDistance)
+{
+    if (ranges.empty())
+        return;
+
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.start < b.start; });
+    size_t count = 0;
+    for (size_t i = 1; i < ranges.size(); ++i)
+    {
+        if (ranges[i].start <= ranges[count].end + mergeDistance)
+            ranges[count].end = std::max(ranges[count].end, ranges[i].end);
+        else
+            ranges[++count] = ranges[i];
+    }
+    ranges.resize(count + 1);
+}
+
 void BufferAllocator::markAsDirty(const Range& range)
 {
     FALCOR_ASSERT(range.start < range.end);
-    mDirty.start = std::min(mDirty.start, range.start);
-    mDirty.end = std::max(mDirty.end, range.end);
+
+    // Extend the last range for sequential updates, which is the common case when filling the buffer.
+    if (!mDirtyRanges.empty() && range.start >= mDirtyRanges.back().start && range.start <= mDirtyRanges.back().end)
+    {
+        mDirtyRanges.back().end = std::max(mDirtyRanges.back().end, range.end);
+        return;
+    }
+
+    mDirtyRanges.push_back(range);
+
+    // Bound the number of tracked ranges. If coalescing is not enough, fall back to a single range covering all of them.
+    if (mDirtyRanges.size() > kMaxDirtyRanges)
+    {
+        coalesceRanges(mDirtyRanges, kDirtyRangeMergeDistance);
+        if (mDirtyRanges.size() > kMaxDirtyRanges / 2)
+            mDirtyRanges = {Range(mDirtyRanges.front().start, mDirtyRanges.back().end)};
+    }
 }
 } // namespace Falcor
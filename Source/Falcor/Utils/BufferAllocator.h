@@ -30,6 +30,10 @@
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 
+#include <array>
+#include <map>
+#include <set>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -49,6 +53,14 @@ namespace Falcor
  * It is assumed that the base pointer of the GPU buffer starts at a
  * cache line. The implementation doesn't provide any alignment
  * guarantees for the CPU side buffer (where it doesn't matter anyway).
+ *
+ * Allocations can be freed. Freed memory is coalesced with adjacent free
+ * blocks and kept in size-class free lists, from which later allocations are
+ * served before the buffer is grown. Fragmented buffers can be compacted,
+ * which relocates the live allocations and reports the new offsets.
+ *
+ * Modified memory regions are tracked as a list of dirty ranges, which are
+ * coalesced and uploaded individually when the GPU buffer is accessed.
  */
 class FALCOR_API BufferAllocator
 {
@@ -67,13 +79,50 @@ public:
         ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
     );
 
+    /// Memory range [start, end) in bytes.
+    struct Range
+    {
+        size_t start = 0;
+        size_t end = 0;
+        Range(){};
+        Range(size_t s, size_t e) : start(s), end(e) {}
+    };
+
+    /// Allocation moved by compact().
+    struct Relocation
+    {
+        size_t oldOffset; ///< Offset in bytes before compaction.
+        size_t newOffset; ///< Offset in bytes after compaction.
+        size_t byteSize;  ///< Size of the allocation in bytes.
+    };
+
+    /// Dirty ranges closer than this distance in bytes are uploaded as one range.
+    static constexpr size_t kDirtyRangeMergeDistance = 256;
+
     /**
-     * Allocates a memory region.
+     * Allocates a memory region. The memory is zero initialized.
+     * Freed memory is reused if possible, otherwise the buffer is grown.
      * @param[in] byteSize Amount of memory in bytes to allocate.
      * @return Offset in bytes to the allocated memory.
      */
     size_t allocate(size_t byteSize);
 
+    /**
+     * Frees a memory region previously allocated with allocate(), pushBack() or emplaceBack().
+     * The memory is made available to later allocations. Freeing the allocations at the end of the buffer shrinks it.
+     * Zero-sized allocations don't need to be freed.
+     * @param[in] byteOffset Offset in bytes to the allocated memory.
+     */
+    void free(size_t byteOffset);
+
+    /**
+     * Compacts the buffer by moving all allocations towards the start of the buffer.
+     * The order of allocations and the alignment requirements are preserved. Afterwards there is no free memory left
+     * in the buffer. All offsets of relocated allocations are invalidated and must be updated by the caller.
+     * @return List of relocated allocations, ordered by offset.
+     */
+    std::vector<Relocation> compact();
+
     /**
      * Allocates memory to hold an array of the given type.
      * @param[in] count Number of array elements.
@@ -94,8 +143,7 @@ public:
     size_t pushBack(const T& obj)
     {
         const size_t byteSize = sizeof(T);
-        computeAndAllocatePadding(byteSize);
-        size_t byteOffset = allocInternal(byteSize);
+        size_t byteOffset = allocate(byteSize);
         T* ptr = reinterpret_cast<T*>(mBuffer.data() + byteOffset);
         *ptr = obj;
         markAsDirty(byteOffset, byteSize);
@@ -111,8 +159,7 @@ public:
     size_t emplaceBack(Args&&... args)
     {
         const size_t byteSize = sizeof(T);
-        computeAndAllocatePadding(byteSize);
-        size_t byteOffset = allocInternal(byteSize);
+        size_t byteOffset = allocate(byteSize);
         void* ptr = mBuffer.data() + byteOffset;
         new (ptr) T(std::forward<Args>(args)...);
         markAsDirty(byteOffset, byteSize);
@@ -186,6 +233,30 @@ public:
      */
     size_t getSize() const { return mBuffer.size(); }
 
+    /**
+     * Get the total size of all live allocations in bytes.
+     * The difference to getSize() is lost to padding and free memory.
+     * @return Size in bytes.
+     */
+    size_t getAllocatedSize() const { return mAllocatedSize; }
+
+    /**
+     * Get the size of the free memory available for reuse in bytes.
+     * @return Size in bytes.
+     */
+    size_t getFreeSize() const { return mFreeSize; }
+
+    /**
+     * Get the number of live allocations.
+     */
+    size_t getAllocationCount() const { return mAllocations.size(); }
+
+    /**
+     * Get the coalesced list of dirty ranges that are uploaded on the next call to getGPUBuffer().
+     * @return List of non-overlapping ranges, ordered by offset.
+     */
+    std::vector<Range> getDirtyRanges() const;
+
     /**
      * Clear buffer. This removes all allocations.
      */
@@ -198,16 +269,23 @@ public:
     ref<Buffer> getGPUBuffer(ref<Device> pDevice);
 
 private:
+    /// Free lists by size class. Size class i holds free blocks of sizes [2^i, 2^(i+1)).
+    static constexpr size_t kSizeClassCount = 64;
+    /// Maximum number of free blocks tried per size class when allocating.
+    static constexpr size_t kMaxFreeListCandidates = 8;
+    /// Maximum number of dirty ranges tracked before they are coalesced.
+    static constexpr size_t kMaxDirtyRanges = 1024;
+
+    size_t computeAlignedOffset(size_t byteOffset, size_t byteSize) const;
     void computeAndAllocatePadding(size_t byteSize);
     size_t allocInternal(size_t byteSize);
+    bool allocFromFreeList(size_t byteSize, size_t& byteOffset);
+    void insertFreeBlock(size_t byteOffset, size_t byteSize);
+    void removeFreeBlock(size_t byteOffset, size_t byteSize);
+    size_t getUsableSize(size_t byteOffset, size_t byteSize) const;
 
-    struct Range
-    {
-        size_t start = 0;
-        size_t end = 0;
-        Range(){};
-        Range(size_t s, size_t e) : start(s), end(e) {}
-    };
+    static size_t getSizeClass(size_t byteSize);
+    static void coalesceRanges(std::vector<Range>& ranges, size_t mergeDistance);
 
     void markAsDirty(const Range& range);
     void markAsDirty(size_t byteOffset, size_t byteSize) { markAsDirty(Range(byteOffset, byteOffset + byteSize)); }
@@ -224,9 +302,15 @@ private:
     /// Bind flags for the GPU buffer.
     const ResourceBindFlags mBindFlags;
 
-    /// Range of buffer that is dirty and needs to be updatd on the GPU. We track a single dirty range for now to minimize the number of
-    /// uploads, but this could be changed.
-    Range mDirty;
+    /// Ranges of the buffer that are dirty and need to be updated on the GPU. Ranges may overlap until they are coalesced.
+    std::vector<Range> mDirtyRanges;
+
+    std::map<size_t, size_t> mAllocations; ///< Live allocations (offset to size in bytes).
+    std::map<size_t, size_t> mFreeBlocks;  ///< Coalesced free blocks (offset to size in bytes).
+    /// Free blocks (usable size after alignment, offset) per size class.
+    std::array<std::set<std::pair<size_t, size_t>>, kSizeClassCount> mFreeLists;
+    size_t mAllocatedSize = 0;
+    size_t mFreeSize = 0;
 
     std::vector<uint8_t> mBuffer; ///< CPU buffer holding a copy of the data.
     ref<Buffer> mpGpuBuffer;      ///< GPU buffer holding the data.
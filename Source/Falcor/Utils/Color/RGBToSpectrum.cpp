@@ -0,0 +1,368 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RGBToSpectrum.h"
+#include "SpectrumUtils.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Utils/Color/ColorUtils.h"
+
+#include <BS_thread_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace Falcor
+{
+namespace
+{
+// The fit follows rgb2spec_opt.cpp from the reference implementation of Jakob and Hanika 2019.
+// The polynomial is fitted in normalized wavelengths t = (lambda - kLambdaMin) / (kLambdaMax - kLambdaMin)
+// and converted to wavelengths in nm when stored in the table.
+constexpr double kLambdaMin = 360.0;
+constexpr double kLambdaMax = 830.0;
+constexpr uint32_t kFitSampleCount = 95; // 5 nm spacing.
+constexpr uint32_t kMaxIterations = 15;
+constexpr double kFiniteDifferenceEpsilon = 1e-4;
+constexpr double kMaxCoefficient = 200.0;
+constexpr double kConvergenceThreshold = 1e-6;
+constexpr uint32_t kSubstepCount = 8;
+
+using double3 = math::vector<double, 3>;
+
+/// Per-wavelength tables used to evaluate the color of a sigmoid polynomial spectrum under D65.
+struct FitTables
+{
+    double t[kFitSampleCount];    ///< Normalized wavelength.
+    double3 rgb[kFitSampleCount]; ///< Integration weight times D65 times the RGB matching functions.
+    double3 whitepointXYZ;        ///< XYZ of the D65 white point.
+
+    FitTables()
+    {
+        const double h = (kLambdaMax - kLambdaMin) / (kFitSampleCount - 1);
+        double3 xyz[kFitSampleCount];
+        double illuminant[kFitSampleCount];
+        double weight[kFitSampleCount];
+        double normalization = 0.0;
+
+        for (uint32_t i = 0; i < kFitSampleCount; i++)
+        {
+            double lambda = kLambdaMin + i * h;
+            t[i] = (lambda - kLambdaMin) / (kLambdaMax - kLambdaMin);
+            xyz[i] = double3(SpectrumUtils::wavelengthToXYZ_CIE1931((float)lambda));
+            illuminant[i] = SpectrumUtils::wavelengthToD65((float)lambda);
+            weight[i] = h * ((i == 0 || i == kFitSampleCount - 1) ? 0.5 : 1.0);
+            normalization += xyz[i].y * illuminant[i] * weight[i];
+        }
+
+        // Normalize so that the white point has luminance 1.
+        whitepointXYZ = double3(0.0);
+        for (uint32_t i = 0; i < kFitSampleCount; i++)
+        {
+            double3 w = xyz[i] * illuminant[i] * weight[i] / normalization;
+            rgb[i] = double3(XYZtoRGB_Rec709(float3(w)));
+            whitepointXYZ += w;
+        }
+    }
+
+    double3 spectrumToRGB(const double3& c) const
+    {
+        double3 result(0.0);
+        for (uint32_t i = 0; i < kFitSampleCount; i++)
+        {
+            double x = (c[0] * t[i] + c[1]) * t[i] + c[2];
+            double s = 0.5 + x / (2.0 * std::sqrt(1.0 + x * x));
+            result += rgb[i] * s;
+        }
+        return result;
+    }
+
+    double3 rgbToLab(const double3& rgb) const
+    {
+        auto f = [](double v)
+        {
+            const double delta = 6.0 / 29.0;
+            return v > delta * delta * delta ? std::cbrt(v) : v / (3.0 * delta * delta) + 4.0 / 29.0;
+        };
+        double3 xyz = double3(RGBtoXYZ_Rec709(float3(rgb)));
+        double fx = f(xyz.x / whitepointXYZ.x);
+        double fy = f(xyz.y / whitepointXYZ.y);
+        double fz = f(xyz.z / whitepointXYZ.z);
+        return double3(116.0 * fy - 16.0, 500.0 * (fx - fy), 200.0 * (fy - fz));
+    }
+
+    /// Difference between the target color and the color of the spectrum in CIELAB.
+    double3 residual(const double3& c, const double3& targetLab) const { return targetLab - rgbToLab(spectrumToRGB(c)); }
+
+    /// Gauss-Newton iteration on the residual, starting from the given coefficients.
+    /// Colors at the boundary of the gamut may not be reachable, in which case the best coefficients found are kept.
+    /// Returns true if the fit converged.
+    bool fit(const double3& targetRGB, double3& c) const
+    {
+        const double3 targetLab = rgbToLab(targetRGB);
+        double3 bestC = c;
+        double bestError = std::numeric_limits<double>::infinity();
+        auto update = [&](const double3& r)
+        {
+            double error = math::dot(r, r);
+            if (error < bestError)
+            {
+                bestError = error;
+                bestC = c;
+            }
+            return error < kConvergenceThreshold;
+        };
+
+        for (uint32_t iteration = 0; iteration < kMaxIterations; iteration++)
+        {
+            double3 r = residual(c, targetLab);
+            if (update(r))
+                break;
+
+            double J[3][3];
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                double3 c0 = c;
+                double3 c1 = c;
+                c0[j] -= kFiniteDifferenceEpsilon;
+                c1[j] += kFiniteDifferenceEpsilon;
+                double3 d = (residual(c1, targetLab) - residual(c0, targetLab)) / (2.0 * kFiniteDifferenceEpsilon);
+                for (uint32_t k = 0; k < 3; k++)
+                    J[k][j] = d[k];
+            }
+
+            // Solve J * x = r with Cramer's rule.
+            double det = J[0][0] * (J[1][1] * J[2][2] - J[1][2] * J[2][1]) - J[0][1] * (J[1][0] * J[2][2] - J[1][2] * J[2][0]) +
+                         J[0][2] * (J[1][0] * J[2][1] - J[1][1] * J[2][0]);
+            if (std::abs(det) < 1e-15)
+                break;
+            double3 x;
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                double M[3][3];
+                for (uint32_t k = 0; k < 3; k++)
+                    for (uint32_t l = 0; l < 3; l++)
+                        M[k][l] = l == j ? r[k] : J[k][l];
+                x[j] = (M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1]) - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0]) +
+                        M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0])) /
+                       det;
+            }
+
+            c -= x;
+
+            // Keep the coefficients bounded when fitting very bright colors.
+            double maxCoefficient = std::max({c[0], c[1], c[2]});
+            if (maxCoefficient > kMaxCoefficient)
+                c *= kMaxCoefficient / maxCoefficient;
+
+            if (iteration + 1 == kMaxIterations)
+                update(residual(c, targetLab));
+        }
+
+        c = bestC;
+        return bestError < kConvergenceThreshold;
+    }
+};
+
+float smoothstep(float x)
+{
+    return x * x * (3.f - 2.f * x);
+}
+
+/// Convert coefficients of the polynomial in normalized wavelengths to coefficients of the polynomial in nm.
+float3 toWavelengthCoefficients(const double3& c)
+{
+    const double c0 = kLambdaMin;
+    const double c1 = 1.0 / (kLambdaMax - kLambdaMin);
+    return float3(
+        float(c[0] * c1 * c1), float(c[1] * c1 - 2.0 * c[0] * c0 * c1 * c1), float(c[2] - c[1] * c0 * c1 + c[0] * c0 * c0 * c1 * c1)
+    );
+}
+} // namespace
+
+const RGBToSpectrumTable& RGBToSpectrumTable::get(uint32_t resolution)
+{
+    static std::mutex mutex;
+    static std::map<uint32_t, std::unique_ptr<RGBToSpectrumTable>> tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& pTable = tables[resolution];
+    if (!pTable)
+        pTable = std::make_unique<RGBToSpectrumTable>(resolution);
+    return *pTable;
+}
+
+RGBToSpectrumTable::RGBToSpectrumTable(uint32_t resolution) : mResolution(resolution)
+{
+    FALCOR_CHECK(resolution >= 2, "'resolution' ({}) must be at least 2.", resolution);
+
+    const uint32_t res = resolution;
+    mScale.resize(res);
+    for (uint32_t k = 0; k < res; k++)
+        mScale[k] = smoothstep(smoothstep(k / float(res - 1)));
+    mCoefficients.resize(3 * res * res * res);
+
+    const FitTables fitTables;
+
+    // Each (largest component, y, x) line along z is fitted independently. Starting from a moderately bright color,
+    // each fit is initialized with the result of the previous one, walking towards brighter and darker colors.
+    // If a step between grid points is too large for the fit to converge, it is retried in smaller steps.
+    auto fitLine = [&](uint32_t l, uint32_t j, uint32_t i)
+    {
+        const double x = i / double(res - 1);
+        const double y = j / double(res - 1);
+        const uint32_t start = res / 5;
+
+        auto fitColor = [&](double z, double3& c)
+        {
+            double3 rgb;
+            rgb[l] = z;
+            rgb[(l + 1) % 3] = x * z;
+            rgb[(l + 2) % 3] = y * z;
+            return fitTables.fit(rgb, c);
+        };
+
+        auto fitAt = [&](uint32_t k, uint32_t prevK, double3& c)
+        {
+            double3 initial = c;
+            if (!fitColor(mScale[k], c) && k != prevK)
+            {
+                c = initial;
+                for (uint32_t s = 1; s <= kSubstepCount; s++)
+                    fitColor(mScale[prevK] + (mScale[k] - mScale[prevK]) * s / kSubstepCount, c);
+            }
+            mCoefficients[((l * res + k) * res + j) * res + i] = toWavelengthCoefficients(c);
+        };
+
+        double3 c(0.0);
+        for (uint32_t k = start; k < res; k++)
+            fitAt(k, std::max(k, start + 1) - 1, c);
+        c = double3(0.0);
+        for (int k = int(start); k >= 0; k--)
+            fitAt(uint32_t(k), std::min(uint32_t(k) + 1, start), c);
+    };
+
+    BS::thread_pool threadPool;
+    for (uint32_t l = 0; l < 3; l++)
+        for (uint32_t j = 0; j < res; j++)
+            threadPool.push_task(
+                [&, l, j]
+                {
+                    for (uint32_t i = 0; i < res; i++)
+                        fitLine(l, j, i);
+                }
+            );
+    threadPool.wait_for_tasks();
+}
+
+float3 RGBToSpectrumTable::getCoefficients(float3 rgb) const
+{
+    rgb = clamp(rgb, float3(0.f), float3(1.f));
+
+    // Grays map to constant spectra.
+    if (rgb.x == rgb.y && rgb.y == rgb.z)
+        return float3(0.f, 0.f, (rgb.x - 0.5f) / std::sqrt(rgb.x * (1.f - rgb.x)));
+
+    const uint32_t res = mResolution;
+    uint32_t l = rgb.x > rgb.y ? (rgb.x > rgb.z ? 0 : 2) : (rgb.y > rgb.z ? 1 : 2);
+    float z = rgb[l];
+    float x = rgb[(l + 1) % 3] * (res - 1) / z;
+    float y = rgb[(l + 2) % 3] * (res - 1) / z;
+
+    uint32_t xi = std::min(uint32_t(x), res - 2);
+    uint32_t yi = std::min(uint32_t(y), res - 2);
+    uint32_t zi = uint32_t(std::upper_bound(mScale.begin(), mScale.end(), z) - mScale.begin());
+    zi = std::clamp(zi, 1u, res - 1) - 1;
+
+    float dx = x - xi;
+    float dy = y - yi;
+    float dz = (z - mScale[zi]) / (mScale[zi + 1] - mScale[zi]);
+
+    auto co = [&](uint32_t dk, uint32_t dj, uint32_t di) { return mCoefficients[((l * res + zi + dk) * res + yi + dj) * res + xi + di]; };
+    auto lerp = [](const float3& a, const float3& b, float t) { return a + (b - a) * t; };
+    return lerp(
+        lerp(lerp(co(0, 0, 0), co(0, 0, 1), dx), lerp(co(0, 1, 0), co(0, 1, 1), dx), dy),
+        lerp(lerp(co(1, 0, 0), co(1, 0, 1), dx), lerp(co(1, 1, 0), co(1, 1, 1), dx), dy),
+        dz
+    );
+}
+
+std::vector<float3> RGBToSpectrumTable::getCoefficients(fstd::span<const float3> rgb) const
+{
+    std::vector<float3> result(rgb.size());
+    for (size_t i = 0; i < rgb.size(); i++)
+        result[i] = getCoefficients(rgb[i]);
+    return result;
+}
+
+float RGBToSpectrumTable::evalSigmoidPolynomial(float3 coefficients, float lambda)
+{
+    float x = (coefficients.x * lambda + coefficients.y) * lambda + coefficients.z;
+    if (std::isinf(x))
+        return x > 0.f ? 1.f : 0.f;
+    return 0.5f + x / (2.f * std::sqrt(1.f + x * x));
+}
+
+ref<Buffer> RGBToSpectrumTable::createBuffer(ref<Device> pDevice) const
+{
+    // The grid point positions are stored in the first entries, followed by the coefficients.
+    std::vector<float4> data(mResolution + mCoefficients.size(), float4(0.f));
+    for (uint32_t k = 0; k < mResolution; k++)
+        data[k].x = mScale[k];
+    for (size_t i = 0; i < mCoefficients.size(); i++)
+        data[mResolution + i] = float4(mCoefficients[i], 0.f);
+
+    return pDevice->createStructuredBuffer(
+        sizeof(float4), (uint32_t)data.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, data.data(), false
+    );
+}
+
+void RGBToSpectrumTable::bindShaderData(const ShaderVar& var, const ref<Buffer>& pBuffer) const
+{
+    FALCOR_CHECK(pBuffer && pBuffer->getElementCount() == mResolution + mCoefficients.size(), "'pBuffer' does not hold this table.");
+    var["data"] = pBuffer;
+    var["resolution"] = mResolution;
+}
+
+SigmoidPolynomialSpectrum::SigmoidPolynomialSpectrum(float3 rgb, const RGBToSpectrumTable& table)
+    : mCoefficients(table.getCoefficients(rgb))
+{
+    // The maximum is at one of the end points or at the extremum of the polynomial.
+    float2 range = getWavelengthRange();
+    mMaxValue = std::max(eval(range.x), eval(range.y));
+    if (mCoefficients.x != 0.f)
+    {
+        float lambda = -mCoefficients.y / (2.f * mCoefficients.x);
+        if (lambda >= range.x && lambda <= range.y)
+            mMaxValue = std::max(mMaxValue, eval(lambda));
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,156 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/Program/ShaderVar.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Table for upsampling linear sRGB colors (Rec.709 primaries, D65 white point) to smooth reflectance spectra.
+ *
+ * Each color maps to the spectrum s(lambda) = sigmoid(c0 * lambda^2 + c1 * lambda + c2), where the coefficients
+ * are found by fitting the spectrum's color under D65 to the input color. The table stores the fitted coefficients
+ * on a grid and colors are looked up with trilinear interpolation.
+ * See Jakob and Hanika, "A Low-Dimensional Function Space for Efficient Spectral Upsampling", EGSR 2019.
+ *
+ * Fitting a table takes a moment, so tables are computed on first use and cached for the lifetime of the process.
+ * The table can be uploaded to the GPU and used with the RGBToSpectrumTable struct in RGBToSpectrum.slang.
+ */
+class FALCOR_API RGBToSpectrumTable
+{
+public:
+    static constexpr uint32_t kDefaultResolution = 32;
+
+    /**
+     * Get the table with the given resolution, computing it on first use.
+     * @param[in] resolution Number of grid points along each axis of the table.
+     * @return The table. The reference stays valid for the lifetime of the process.
+     */
+    static const RGBToSpectrumTable& get(uint32_t resolution = kDefaultResolution);
+
+    /**
+     * Fit a new table.
+     * @param[in] resolution Number of grid points along each axis of the table.
+     */
+    explicit RGBToSpectrumTable(uint32_t resolution);
+
+    /**
+     * Get the sigmoid polynomial coefficients for a color.
+     * @param[in] rgb Linear sRGB color. Components are clamped to [0,1].
+     * @return Coefficients (c0, c1, c2) of the polynomial in lambda (nm).
+     */
+    float3 getCoefficients(float3 rgb) const;
+
+    /**
+     * Get the sigmoid polynomial coefficients for multiple colors.
+     * @param[in] rgb Linear sRGB colors. Components are clamped to [0,1].
+     * @return Coefficients (c0, c1, c2) per color.
+     */
+    std::vector<float3> getCoefficients(fstd::span<const float3> rgb) const;
+
+    /**
+     * Evaluate a sigmoid polynomial spectrum.
+     * @param[in] coefficients Coefficients (c0, c1, c2) of the polynomial.
+     * @param[in] lambda Wavelength in nm.
+     * @return Spectral value in [0,1].
+     */
+    static float evalSigmoidPolynomial(float3 coefficients, float lambda);
+
+    /**
+     * Get the number of grid points along each axis of the table.
+     */
+    uint32_t getResolution() const { return mResolution; }
+
+    /**
+     * Create a GPU buffer holding the table.
+     * @param[in] pDevice GPU device.
+     * @return Buffer to pass to bindShaderData().
+     */
+    ref<Buffer> createBuffer(ref<Device> pDevice) const;
+
+    /**
+     * Bind the table to a shader variable of type RGBToSpectrumTable.
+     * @param[in] var The shader variable to set the data into.
+     * @param[in] pBuffer Buffer created with createBuffer().
+     */
+    void bindShaderData(const ShaderVar& var, const ref<Buffer>& pBuffer) const;
+
+private:
+    uint32_t mResolution;
+    std::vector<float> mScale;         ///< Positions of the grid points along the axis of the largest component.
+    std::vector<float3> mCoefficients; ///< Coefficients indexed by [largest component][z][y][x].
+};
+
+/**
+ * Represents a smooth reflectance spectrum upsampled from an RGB color.
+ * Implements the same interface as the spectra in Spectrum.h, so it can be used with spectrumToXYZ() and friends.
+ */
+class FALCOR_API SigmoidPolynomialSpectrum
+{
+public:
+    /**
+     * Create a spectrum from an RGB color.
+     * @param[in] rgb Linear sRGB color. Components are clamped to [0,1].
+     * @param[in] table Table to look up the coefficients in.
+     */
+    SigmoidPolynomialSpectrum(float3 rgb, const RGBToSpectrumTable& table = RGBToSpectrumTable::get());
+
+    /**
+     * Evaluate the spectrum at the given wavelength.
+     * @param wavelength Wavelength in nm.
+     * @return Value.
+     */
+    float eval(float wavelength) const { return RGBToSpectrumTable::evalSigmoidPolynomial(mCoefficients, wavelength); }
+
+    /**
+     * Return the wavelength range.
+     * @return The wavelength range of the spectrum.
+     */
+    float2 getWavelengthRange() const { return {360.f, 830.f}; }
+
+    /**
+     * Get the maximum value in the spectrum.
+     * @return The maximum value.
+     */
+    float getMaxValue() const { return mMaxValue; }
+
+    /**
+     * Get the sigmoid polynomial coefficients.
+     */
+    float3 getCoefficients() const { return mCoefficients; }
+
+private:
+    float3 mCoefficients;
+    float mMaxValue;
+};
+} // namespace Falcor
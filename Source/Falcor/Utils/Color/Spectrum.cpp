@@ -82,6 +82,35 @@ void PiecewiseLinearSpectrum::scale(float factor)
     mMaxValue *= factor;
 }
 
+void PiecewiseLinearSpectrum::evalUniform(float minWavelength, float wavelengthStep, fstd::span<float> values) const
+{
+    FALCOR_CHECK(wavelengthStep > 0.f, "'wavelengthStep' ({}) must be positive.", wavelengthStep);
+
+    size_t upper = 0; // Index of the first stored wavelength >= the current wavelength.
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        float wavelength = minWavelength + (float)i * wavelengthStep;
+        if (mWavelengths.empty() || wavelength < mWavelengths.front() || wavelength > mWavelengths.back())
+        {
+            values[i] = 0.f;
+            continue;
+        }
+
+        while (mWavelengths[upper] < wavelength)
+            ++upper;
+
+        if (upper == 0)
+        {
+            values[i] = mValues.front();
+            continue;
+        }
+
+        size_t index = upper - 1;
+        float t = (wavelength - mWavelengths[index]) / (mWavelengths[index + 1] - mWavelengths[index]);
+        values[i] = math::lerp(mValues[index], mValues[index + 1], t);
+    }
+}
+
 // ------------------------------------------------------------------------
 // BlackbodySpectrum
 // ------------------------------------------------------------------------
@@ -233,6 +262,42 @@ const std::unordered_map<std::string, PiecewiseLinearSpectrum> kNamedSpectra{
     {"sony_ilce_9_b", PiecewiseLinearSpectrum::fromInterleaved(sony_ilce_9_b, false)}};
 }
 
+float3 Spectra::innerProductCIE_XYZ(float minWavelength, fstd::span<const float> values)
+{
+    float offset = minWavelength - kCIE_Y.getWavelengthRange().x;
+    float3 result(0.f);
+
+    if (offset >= 0.f && offset == std::floor(offset))
+    {
+        // Values line up with the table samples, compute plain dot products over the overlapping range.
+        size_t first = (size_t)offset;
+        size_t count = first < kCIESampleCount ? std::min(values.size(), kCIESampleCount - first) : 0;
+        const float* pX = CIE_X + first;
+        const float* pY = CIE_Y + first;
+        const float* pZ = CIE_Z + first;
+        constexpr size_t kLanes = 4;
+        float4 x(0.f), y(0.f), z(0.f);
+        size_t i = 0;
+        for (; i + kLanes <= count; i += kLanes)
+        {
+            float4 v(values[i], values[i + 1], values[i + 2], values[i + 3]);
+            x += v * float4(pX[i], pX[i + 1], pX[i + 2], pX[i + 3]);
+            y += v * float4(pY[i], pY[i + 1], pY[i + 2], pY[i + 3]);
+            z += v * float4(pZ[i], pZ[i + 1], pZ[i + 2], pZ[i + 3]);
+        }
+        for (; i < count; ++i)
+            result += values[i] * float3(pX[i], pY[i], pZ[i]);
+        return result + float3(x.x + x.y + x.z + x.w, y.x + y.y + y.z + y.w, z.x + z.y + z.z + z.w);
+    }
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        float wavelength = minWavelength + (float)i;
+        result += values[i] * float3(kCIE_X.eval(wavelength), kCIE_Y.eval(wavelength), kCIE_Z.eval(wavelength));
+    }
+    return result;
+}
+
 const PiecewiseLinearSpectrum* Spectra::getNamedSpectrum(const std::string& name)
 {
     auto it = kNamedSpectra.find(name);
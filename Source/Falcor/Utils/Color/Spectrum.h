@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 namespace Falcor
@@ -101,6 +102,15 @@ public:
         return math::lerp(a, b, t);
     }
 
+    /**
+     * Evaluate the spectrum at uniformly spaced wavelengths.
+     * Returns the same values as eval(), but walks the segments once instead of searching them for each wavelength.
+     * @param[in] minWavelength First wavelength in nm.
+     * @param[in] wavelengthStep Distance between wavelengths in nm. Must be positive.
+     * @param[out] values Interpolated values, one per wavelength.
+     */
+    void evalUniform(float minWavelength, float wavelengthStep, fstd::span<float> values) const;
+
     /**
      * Return the wavelength range.
      * @return The wavelength range of the spectrum.
@@ -241,6 +251,14 @@ struct FALCOR_API Spectra
     static const DenseleySampledSpectrum kCIE_Z;
     static constexpr float kCIE_Y_Integral = 106.856895f;
 
+    /**
+     * Compute the inner products of spectral values with the CIE 1931 matching functions.
+     * @param[in] minWavelength Wavelength of the first value in nm.
+     * @param[in] values Spectral values spaced 1nm apart. Values outside the range of the matching functions are ignored.
+     * @return Inner products with the X, Y and Z matching functions (not normalized).
+     */
+    static float3 innerProductCIE_XYZ(float minWavelength, fstd::span<const float> values);
+
     /**
      * Get a named spectrum.
      * @param[in] name Spectrum name.
@@ -269,12 +287,30 @@ float innerProduct(const A& a, const B& b)
 
 /**
  * Convert spectrum to CIE 1931 XYZ.
+ * The spectrum is evaluated once per wavelength and integrated against all three matching functions at once.
  */
 template<typename S>
 float3 spectrumToXYZ(const S& s)
 {
-    return float3(innerProduct(s, Spectra::kCIE_X), innerProduct(s, Spectra::kCIE_Y), innerProduct(s, Spectra::kCIE_Z)) /
-           Spectra::kCIE_Y_Integral;
+    auto range = s.getWavelengthRange();
+    auto rangeCIE = Spectra::kCIE_Y.getWavelengthRange();
+    float minWavelength = std::max(range.x, rangeCIE.x);
+    float maxWavelength = std::min(range.y, rangeCIE.y);
+    if (!(minWavelength <= maxWavelength))
+        return float3(0.f);
+
+    std::vector<float> values((size_t)(maxWavelength - minWavelength) + 1);
+    if constexpr (std::is_same_v<S, PiecewiseLinearSpectrum>)
+    {
+        s.evalUniform(minWavelength, 1.f, values);
+    }
+    else
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = s.eval(minWavelength + (float)i);
+    }
+
+    return Spectra::innerProductCIE_XYZ(minWavelength, values) / Spectra::kCIE_Y_Integral;
 }
 
 /**
@@ -285,4 +321,16 @@ float3 spectrumToRGB(const S& s)
 {
     return XYZtoRGB_Rec709(spectrumToXYZ(s));
 }
+
+/**
+ * Convert multiple spectra to RGB in Rec.709.
+ */
+template<typename S>
+std::vector<float3> spectrumToRGB(fstd::span<const S> spectra)
+{
+    std::vector<float3> result(spectra.size());
+    for (size_t i = 0; i < spectra.size(); ++i)
+        result[i] = spectrumToRGB(spectra[i]);
+    return result;
+}
 } // namespace Falcor
@@ -31,6 +31,11 @@
 #include <xyzcurves/ciexyzCurves1931_1nm.h>
 #include <illuminants/D65_5nm.h>
 
+#include <array>
+#include <map>
+#include <mutex>
+#include <tuple>
+
 namespace Falcor
 {
 // Initialize static data.
@@ -39,6 +44,41 @@ const SampledSpectrum<float3> SpectrumUtils::sCIE_XYZ_1931_1nm(360.0f, 830.0f, 4
 const SampledSpectrum<float> SpectrumUtils::sD65_5nm(300.0f, 830.0f, 107, reinterpret_cast<const float*>(D65_1nm));                 // 5 nm between samples.
 // clang-format on
 
+namespace
+{
+/// CIE 1931 XYZ times D65, resampled to the uniform 1nm grid of the table.
+struct UniformTables
+{
+    std::array<float3, SpectrumUtils::kTableSampleCount> XYZ_D65;
+
+    UniformTables()
+    {
+        for (uint32_t i = 0; i < SpectrumUtils::kTableSampleCount; i++)
+        {
+            float lambda = SpectrumUtils::kTableLambdaStart + (float)i;
+            XYZ_D65[i] = SpectrumUtils::sCIE_XYZ_1931_1nm.eval(lambda) * SpectrumUtils::sD65_5nm.eval(lambda);
+        }
+    }
+};
+
+const UniformTables& getUniformTables()
+{
+    static const UniformTables tables;
+    return tables;
+}
+
+template<size_t N>
+float3 evalUniformTable(const std::array<float3, N>& table, float lambda)
+{
+    float x = lambda - SpectrumUtils::kTableLambdaStart;
+    if (x < 0.f || x > float(N - 1))
+        return float3(0.f);
+    size_t i = std::min((size_t)x, N - 2);
+    float w = x - (float)i;
+    return math::lerp(table[i], table[i + 1], float3(w));
+}
+} // namespace
+
 float3 SpectrumUtils::wavelengthToXYZ_CIE1931(float lambda)
 {
     return sCIE_XYZ_1931_1nm.eval(lambda);
@@ -49,9 +89,92 @@ float SpectrumUtils::wavelengthToD65(float lambda)
     return sD65_5nm.eval(lambda);
 }
 
+float3 SpectrumUtils::wavelengthToXYZ_D65(float lambda)
+{
+    return evalUniformTable(getUniformTables().XYZ_D65, lambda);
+}
+
 float3 SpectrumUtils::wavelengthToRGB_Rec709(const float lambda)
 {
     float3 XYZ = wavelengthToXYZ_CIE1931(lambda);
     return XYZtoRGB_Rec709(XYZ);
 }
+
+const SpectrumUtils::IntegrationWeights& SpectrumUtils::getIntegrationWeights(
+    float2 wavelengthRange,
+    uint32_t evaluationCount,
+    Weighting weighting
+)
+{
+    using Key = std::tuple<float, float, uint32_t, Weighting>;
+    static std::mutex mutex;
+    static std::map<Key, IntegrationWeights> cache; // Node based, references stay valid on insertion.
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Key key{wavelengthRange.x, wavelengthRange.y, evaluationCount, weighting};
+    auto it = cache.find(key);
+    if (it != cache.end())
+        return it->second;
+
+    // Same Riemann sum as in integrate(), with the step width and end point halving folded into the weights.
+    IntegrationWeights weights;
+    weights.wavelengths.resize(evaluationCount);
+    weights.x.resize(evaluationCount);
+    weights.y.resize(evaluationCount);
+    weights.z.resize(evaluationCount);
+    float waveLengthDelta = (wavelengthRange.y - wavelengthRange.x) / (evaluationCount - 1.0f);
+    for (uint32_t q = 0; q < evaluationCount; q++)
+    {
+        float wavelength = std::min(wavelengthRange.x + waveLengthDelta * q, wavelengthRange.y);
+        float3 w = wavelengthToXYZ_CIE1931(wavelength);
+        if (weighting == Weighting::XYZ_D65)
+            w *= wavelengthToD65(wavelength);
+        w *= waveLengthDelta * ((q == 0 || q == evaluationCount - 1) ? 0.5f : 1.0f);
+        weights.wavelengths[q] = wavelength;
+        weights.x[q] = w.x;
+        weights.y[q] = w.y;
+        weights.z[q] = w.z;
+    }
+
+    return cache.emplace(key, std::move(weights)).first->second;
+}
+
+float3 SpectrumUtils::dot(const IntegrationWeights& weights, fstd::span<const float> values)
+{
+    FALCOR_ASSERT(values.size() == weights.wavelengths.size());
+    const float* x = weights.x.data();
+    const float* y = weights.y.data();
+    const float* z = weights.z.data();
+    const float* v = values.data();
+    const size_t count = values.size();
+
+    // Accumulate into independent lanes so that the loop maps to SIMD registers without reassociating floating-point sums.
+    constexpr size_t kLanes = 8;
+    float sx[kLanes] = {};
+    float sy[kLanes] = {};
+    float sz[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= count; i += kLanes)
+    {
+        for (size_t j = 0; j < kLanes; j++)
+        {
+            sx[j] += x[i + j] * v[i + j];
+            sy[j] += y[i + j] * v[i + j];
+            sz[j] += z[i + j] * v[i + j];
+        }
+    }
+    for (size_t j = 0; i < count; i++, j++)
+    {
+        sx[j] += x[i] * v[i];
+        sy[j] += y[i] * v[i];
+        sz[j] += z[i] * v[i];
+    }
+    for (size_t j = 1; j < kLanes; j++)
+    {
+        sx[0] += sx[j];
+        sy[0] += sy[j];
+        sz[0] += sz[j];
+    }
+    return float3(sx[0], sy[0], sz[0]);
+}
 } // namespace Falcor
@@ -31,9 +31,11 @@
 #include "Core/Error.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Color/ColorUtils.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
 #include <algorithm>
 #include <functional>
 #include <type_traits>
+#include <vector>
 
 namespace Falcor
 {
@@ -46,6 +48,31 @@ public:
     static const SampledSpectrum<float3> sCIE_XYZ_1931_1nm;
     static const SampledSpectrum<float> sD65_5nm;
 
+    /// Wavelength range and sample count of the precomputed uniform tables. Samples are spaced 1 nm apart.
+    static constexpr float kTableLambdaStart = 360.f;
+    static constexpr float kTableLambdaEnd = 830.f;
+    static constexpr uint32_t kTableSampleCount = 471;
+
+    /// Weighting functions that integration weights can be precomputed for.
+    enum class Weighting
+    {
+        XYZ,     ///< CIE 1931 XYZ color matching curves.
+        XYZ_D65, ///< CIE 1931 XYZ color matching curves times the D65 standard illuminant.
+    };
+
+    /**
+     * Integration weights of a spectrum layout.
+     * Holds the wavelength of each integration step and the weighting function times the step width for each step,
+     * stored as a structure of arrays so that integration is a vectorizable dot product.
+     */
+    struct IntegrationWeights
+    {
+        std::vector<float> wavelengths;
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+    };
+
     /**
      * Evaluates the 1931 CIE XYZ color matching curves.
      * This function uses curves sampled at 1nm and returns XYZ values linearly interpolated from the two nearest samples.
@@ -62,6 +89,14 @@ public:
      */
     static float wavelengthToD65(float lambda);
 
+    /**
+     * Evaluates the 1931 CIE XYZ color matching curves times the D65 standard illuminant.
+     * This function uses a precomputed table resampled to 1nm and returns values linearly interpolated from the two nearest samples.
+     * @param[in] lambda Wavelength in nm.
+     * @return XYZ tristimulus values times D65.
+     */
+    static float3 wavelengthToXYZ_D65(float lambda);
+
     /**
      * Converts from wavelength to XYZ_CIE1931 and then to RGB Rec709.
      * @param[in] lambda Wavelength in nm.
@@ -69,6 +104,25 @@ public:
      */
     static float3 wavelengthToRGB_Rec709(const float lambda);
 
+    /**
+     * Get the integration weights for a spectrum layout.
+     * The weights are computed on first use and cached, so converting many spectra with the same layout only
+     * evaluates the weighting function once.
+     * @param[in] wavelengthRange Wavelength range of the spectrum.
+     * @param[in] evaluationCount Number of integration steps over the range, including both end points.
+     * @param[in] weighting Weighting function.
+     * @return Integration weights. The reference stays valid for the lifetime of the process.
+     */
+    static const IntegrationWeights& getIntegrationWeights(float2 wavelengthRange, uint32_t evaluationCount, Weighting weighting);
+
+    /**
+     * Compute the dot product of spectral values with integration weights.
+     * @param[in] weights Integration weights.
+     * @param[in] values Spectral values at each of the weights' wavelengths.
+     * @return Weighted sum.
+     */
+    static float3 dot(const IntegrationWeights& weights, fstd::span<const float> values);
+
     /**
      * Integrate over entire spectrum and apply user-supplied function to each integration.
      * @param[in] spectrum The spectrum to be converted.
@@ -78,18 +132,18 @@ public:
      * @param[in] integrationSteps Number of integration steps per sample.
      * @return XYZ of the spectrum.
      */
-    template<typename T, typename ReturnType>
+    template<typename T, typename ReturnType, typename Func = std::function<ReturnType(float)>>
     static ReturnType integrate(
-        SampledSpectrum<T>& spectrum,
+        const SampledSpectrum<T>& spectrum,
         const SpectrumInterpolation interpolationType,
-        std::function<ReturnType(float)> func,
+        const Func& func,
         const uint32_t componentIndex = 0,
         const uint32_t integrationSteps = 1
     )
     {
         FALCOR_ASSERT(integrationSteps >= 1);
         float2 wavelengthRange = spectrum.getWavelengthRange();
-        uint32_t numEvaluations = uint32_t(spectrum.size() + (integrationSteps - 1) * (spectrum.size() - 1));
+        uint32_t numEvaluations = getEvaluationCount(spectrum, integrationSteps);
         float waveLengthDelta = (wavelengthRange.y - wavelengthRange.x) / (numEvaluations - 1.0f);
         ReturnType sum = ReturnType(0);
 
@@ -97,21 +151,43 @@ public:
         for (uint32_t q = 0; q < numEvaluations; q++)
         {
             float wavelength = std::min(wavelengthRange.x + waveLengthDelta * q, wavelengthRange.y);
-            T spectralIntensity = spectrum.eval(wavelength, interpolationType);
-            float s;
-            if constexpr (std::is_same_v<T, float>)
-            {
-                s = spectralIntensity;
-            }
-            else
-            {
-                s = spectralIntensity[componentIndex];
-            }
+            float s = getComponent(spectrum.eval(wavelength, interpolationType), componentIndex);
             sum += func(wavelength) * s * waveLengthDelta * ((q == 0 || q == numEvaluations - 1) ? 0.5f : 1.0f);
         }
         return sum;
     }
 
+    /**
+     * Integrate over entire spectrum using precomputed integration weights.
+     * This computes the same sum as integrate() with the weighting function as func, but evaluates the weighting
+     * function only once per spectrum layout.
+     * @param[in] spectrum The spectrum to be converted.
+     * @param[in] interpolationType Which type of interpolation that should be used.
+     * @param[in] weighting Weighting function.
+     * @param[in] componentIndex Which component to evaluate when T is a vector type.
+     * @param[in] integrationSteps Number of integration steps per sample.
+     * @return Weighted integral of the spectrum.
+     */
+    template<typename T>
+    static float3 integrate(
+        const SampledSpectrum<T>& spectrum,
+        const SpectrumInterpolation interpolationType,
+        const Weighting weighting,
+        const uint32_t componentIndex = 0,
+        const uint32_t integrationSteps = 1
+    )
+    {
+        FALCOR_ASSERT(integrationSteps >= 1);
+        uint32_t numEvaluations = getEvaluationCount(spectrum, integrationSteps);
+        const IntegrationWeights& weights = getIntegrationWeights(spectrum.getWavelengthRange(), numEvaluations, weighting);
+
+        std::vector<float> values(numEvaluations);
+        for (uint32_t q = 0; q < numEvaluations; q++)
+            values[q] = getComponent(spectrum.eval(weights.wavelengths[q], interpolationType), componentIndex);
+
+        return dot(weights, values);
+    }
+
     /**
      * Convert entire spectrum to XYZ.
      * @param[in] spectrum The spectrum to be converted.
@@ -122,19 +198,13 @@ public:
      */
     template<typename T>
     static float3 toXYZ(
-        SampledSpectrum<T>& spectrum,
+        const SampledSpectrum<T>& spectrum,
         const SpectrumInterpolation interpolationType = SpectrumInterpolation::Linear,
         const uint32_t componentIndex = 0,
         const uint32_t integrationSteps = 1
     )
     {
-        return integrate<T, float3>(
-            spectrum,
-            interpolationType,
-            [](float wavelength) -> float3 { return SpectrumUtils::wavelengthToXYZ_CIE1931(wavelength); },
-            componentIndex,
-            integrationSteps
-        );
+        return integrate(spectrum, interpolationType, Weighting::XYZ, componentIndex, integrationSteps);
     }
 
     /**
@@ -147,20 +217,13 @@ public:
      */
     template<typename T>
     static float3 toXYZ_D65(
-        SampledSpectrum<T>& spectrum,
+        const SampledSpectrum<T>& spectrum,
         const SpectrumInterpolation interpolationType = SpectrumInterpolation::Linear,
         const uint32_t componentIndex = 0,
         const uint32_t integrationSteps = 1
     )
     {
-        return integrate<T, float3>(
-            spectrum,
-            interpolationType,
-            [](float wavelength) -> float3
-            { return SpectrumUtils::wavelengthToXYZ_CIE1931(wavelength) * SpectrumUtils::wavelengthToD65(wavelength); },
-            componentIndex,
-            integrationSteps
-        );
+        return integrate(spectrum, interpolationType, Weighting::XYZ_D65, componentIndex, integrationSteps);
     }
 
     /**
@@ -173,7 +236,7 @@ public:
      */
     template<typename T>
     static float3 toRGB_D65(
-        SampledSpectrum<T>& spectrum,
+        const SampledSpectrum<T>& spectrum,
         const SpectrumInterpolation interpolationType,
         const uint32_t componentIndex = 0,
         const uint32_t integrationSteps = 1
@@ -186,5 +249,44 @@ public:
         const float Y_D65 = 10567.0762f; // Computed as Y_D65 = SpectrumUtils::sD65_5nm.toXYZ(1.0f).y; See Equation 8 in the paper above.
         return RGB * (1.0f / Y_D65);
     }
+
+    /**
+     * Convert multiple spectra to RGB under the assumption of using the D65 illuminant.
+     * Spectra sharing the same layout share the precomputed integration weights.
+     * @param[in] spectra The spectra to be converted.
+     * @param[in] interpolationType Which type of interpolation that should be used.
+     * @param[in] componentIndex Which component to evaluate when T is a vector type.
+     * @param[in] integrationSteps Number of integration steps per sample.
+     * @return An RGB color per spectrum.
+     */
+    template<typename T>
+    static std::vector<float3> toRGB_D65(
+        fstd::span<const SampledSpectrum<T>> spectra,
+        const SpectrumInterpolation interpolationType,
+        const uint32_t componentIndex = 0,
+        const uint32_t integrationSteps = 1
+    )
+    {
+        std::vector<float3> result(spectra.size());
+        for (size_t i = 0; i < spectra.size(); i++)
+            result[i] = toRGB_D65(spectra[i], interpolationType, componentIndex, integrationSteps);
+        return result;
+    }
+
+private:
+    template<typename T>
+    static uint32_t getEvaluationCount(const SampledSpectrum<T>& spectrum, const uint32_t integrationSteps)
+    {
+        return uint32_t(spectrum.size() + (integrationSteps - 1) * (spectrum.size() - 1));
+    }
+
+    template<typename T>
+    static float getComponent(const T& value, const uint32_t componentIndex)
+    {
+        if constexpr (std::is_same_v<T, float>)
+            return value;
+        else
+            return value[componentIndex];
+    }
 };
 } // namespace Falcor
@@ -32,20 +32,42 @@
 #include "Core/Program/ShaderVar.h"
 #include "Utils/Logger.h"
 #include "Utils/UI/InputTypes.h"
-#include <fstd/bit.h> // TODO: Replace with C++20 <bit> when available on all targets
+#include <algorithm>
 #include <sstream>
-#include <iomanip>
 
 namespace Falcor
 {
 namespace
 {
 static_assert(sizeof(PrintRecord) % 16 == 0, "PrintRecord size should be a multiple of 16B");
+static_assert(sizeof(AssertRecord) % 16 == 0, "AssertRecord size should be a multiple of 16B");
+
+const size_t kCounterSize = sizeof(uint32_t) * 2;
+
+// Maximum number of records written to the logger and shown in the UI per frame.
+const size_t kMaxDisplayedRecords = 100;
 } // namespace
 
 PixelDebug::PixelDebug(ref<Device> pDevice, uint32_t printCapacity, uint32_t assertCapacity)
-    : mpDevice(pDevice), mPrintCapacity(printCapacity), mAssertCapacity(assertCapacity)
-{}
+    : mpDevice(pDevice)
+{
+    setCapacity(printCapacity, assertCapacity);
+}
+
+void PixelDebug::setCapacity(uint32_t printCapacity, uint32_t assertCapacity)
+{
+    FALCOR_CHECK(printCapacity > 0 && assertCapacity > 0, "Print and assert capacities must be larger than zero.");
+    FALCOR_CHECK(printCapacity <= kMaxCapacity && assertCapacity <= kMaxCapacity, "Print and assert capacities must not exceed {}.", kMaxCapacity);
+    mPrintCapacity = printCapacity;
+    mAssertCapacity = assertCapacity;
+}
+
+void PixelDebug::setPrintsPerPixel(uint32_t printsPerPixel)
+{
+    FALCOR_CHECK(printsPerPixel > 0, "Prints per pixel must be larger than zero.");
+    mPrintsPerPixel = printsPerPixel;
+    reserveForSelection();
+}
 
 void PixelDebug::beginFrame(RenderContext* pRenderContext, const uint2& frameDim)
 {
@@ -53,33 +75,40 @@ void PixelDebug::beginFrame(RenderContext* pRenderContext, const uint2& frameDim
 
     mFrameDim = frameDim;
     mRunning = true;
+    mFrameIndex++;
 
-    // Reset previous data.
-    mPrintData.clear();
-    mAssertData.clear();
-    mDataValid = false;
-    mWaitingForData = false;
+    // Collect data of previous frames that are done on the GPU.
+    poll();
 
     if (mEnabled)
     {
+        // Reallocate the buffers if the capacities have changed.
+        if (mpPrintBuffer && (mpPrintBuffer->getElementCount() != mPrintCapacity || mpAssertBuffer->getElementCount() != mAssertCapacity))
+        {
+            // Collect the snapshots of the old buffers first. This only waits when the capacities change.
+            mpReadbackRing->flush();
+            mpCounterBuffer = nullptr;
+            mpPrintBuffer = nullptr;
+            mpAssertBuffer = nullptr;
+            mpReadbackRing = nullptr;
+        }
+
         // Prepare buffers.
         if (!mpPrintBuffer)
         {
-            // Allocate GPU buffers.
+            // Allocate GPU buffers. The write counters are only cleared here, the buffers are used as rings.
             const ref<Device>& pDevice = pRenderContext->getDevice();
-            mpCounterBuffer = pDevice->createBuffer(sizeof(uint32_t) * 2);
+            mpCounterBuffer = pDevice->createBuffer(kCounterSize);
             mpPrintBuffer = pDevice->createStructuredBuffer(sizeof(PrintRecord), mPrintCapacity);
             mpAssertBuffer = pDevice->createStructuredBuffer(sizeof(AssertRecord), mAssertCapacity);
+            pRenderContext->clearUAV(mpCounterBuffer->getUAV().get(), uint4(0));
+            mLog.resetCounters();
 
-            // Allocate readback buffer. This buffer is shared for copying all the above buffers to the CPU
-            mpReadbackBuffer = pDevice->createBuffer(
-                mpCounterBuffer->getSize() + mpPrintBuffer->getSize() + mpAssertBuffer->getSize(),
-                ResourceBindFlags::None,
-                MemoryType::ReadBack
+            // Allocate readback ring. Each slot holds a snapshot of all the above buffers.
+            mpReadbackRing = std::make_unique<GpuReadbackRing>(
+                mpDevice, mpCounterBuffer->getSize() + mpPrintBuffer->getSize() + mpAssertBuffer->getSize()
             );
         }
-
-        pRenderContext->clearUAV(mpCounterBuffer->getUAV().get(), uint4(0));
     }
 }
 
@@ -91,25 +120,21 @@ void PixelDebug::endFrame(RenderContext* pRenderContext)
 
     if (mEnabled)
     {
-        // Copy logged data to staging buffers.
-        uint32_t dst = 0;
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), dst, mpCounterBuffer.get(), 0, mpCounterBuffer->getSize());
+        // Copy a snapshot of the logged data to a readback slot.
+        const uint32_t slot = mpReadbackRing->acquire();
+        Buffer* pDst = mpReadbackRing->getBuffer(slot).get();
+        uint64_t dst = 0;
+        pRenderContext->copyBufferRegion(pDst, dst, mpCounterBuffer.get(), 0, mpCounterBuffer->getSize());
         dst += mpCounterBuffer->getSize();
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), dst, mpPrintBuffer.get(), 0, mpPrintBuffer->getSize());
+        pRenderContext->copyBufferRegion(pDst, dst, mpPrintBuffer.get(), 0, mpPrintBuffer->getSize());
         dst += mpPrintBuffer->getSize();
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), dst, mpAssertBuffer.get(), 0, mpAssertBuffer->getSize());
+        pRenderContext->copyBufferRegion(pDst, dst, mpAssertBuffer.get(), 0, mpAssertBuffer->getSize());
         dst += mpAssertBuffer->getSize();
-        FALCOR_ASSERT(dst == mpReadbackBuffer->getSize());
-
-        // Create fence first time we need it.
-        if (!mpFence)
-            mpFence = mpDevice->createFence();
+        FALCOR_ASSERT(dst == mpReadbackRing->getSlotSize());
 
-        // Submit command list and insert signal.
-        pRenderContext->submit(false);
-        pRenderContext->signal(mpFence.get());
-
-        mWaitingForData = true;
+        mpReadbackRing->submit(
+            slot, mFrameIndex, dst, [this](uint64_t frameIndex, const void* pData, size_t size) { onSnapshot(frameIndex, pData, size); }
+        );
     }
 }
 
@@ -125,14 +150,17 @@ void PixelDebug::prepareProgram(const ref<Program>& pProgram, const ShaderVar& v
         pixelDebug["counterBuffer"] = mpCounterBuffer;
         pixelDebug["printBuffer"] = mpPrintBuffer;
         pixelDebug["assertBuffer"] = mpAssertBuffer;
-        pixelDebug["printBufferCapacity"] = mPrintCapacity;
-        pixelDebug["assertBufferCapacity"] = mAssertCapacity;
-        pixelDebug["selectedPixel"] = mSelectedPixel;
+        pixelDebug["printBufferCapacity"] = mpPrintBuffer->getElementCount();
+        pixelDebug["assertBufferCapacity"] = mpAssertBuffer->getElementCount();
+        pixelDebug["frameIndex"] = (uint32_t)mFrameIndex;
+        pixelDebug["selectionCount"] = (uint32_t)mSelections.size();
+        if (!mSelections.empty())
+            pixelDebug["selections"].setBlob(mSelections.data(), mSelections.size() * sizeof(uint4));
 
         const auto& hashedStrings = pProgram->getReflector()->getHashedStrings();
         for (const auto& hashedString : hashedStrings)
         {
-            mHashToString.insert(std::make_pair(hashedString.hash, hashedString.string));
+            mLog.registerString(hashedString.hash, hashedString.string);
         }
     }
     else
@@ -151,84 +179,138 @@ void PixelDebug::renderUI(Gui::Widgets* widget)
         widget->checkbox("Pixel debug", mEnabled);
         widget->tooltip(
             "Enables shader debugging.\n\n"
-            "Left-mouse click on a pixel to select it.\n"
-            "Use print(value) or print(msg, value) in the shader to print values for the selected pixel.\n"
+            "Left-mouse click on a pixel to select it, shift-click to add pixels.\n"
+            "Use print(value) or print(msg, value) in the shader to print values for the selected pixels.\n"
             "All basic types such as int, float2, etc. are supported.\n"
             "Use assert(condition) or assert(condition, msg) in the shader to test a condition.",
             true
         );
         if (mEnabled)
         {
-            widget->var("Selected pixel", mSelectedPixel);
+            if (mSelections.size() == 1 && all(mSelections[0].zw() == mSelections[0].xy() + uint2(1)))
+            {
+                uint2 pixel = mSelections[0].xy();
+                if (widget->var("Selected pixel", pixel))
+                    selectPixel(pixel);
+            }
+            else
+            {
+                widget->text(fmt::format("Selected regions: {}", mSelections.size()));
+            }
+
+            if (auto group = widget->group("Region selection"))
+            {
+                group.var("Min", mRegionMin);
+                group.var("Max", mRegionMax);
+                group.tooltip("Region to select, the max pixel is exclusive.", true);
+                const bool isValidRegion = all(mRegionMin < mRegionMax);
+                if (group.button("Select") && isValidRegion)
+                    selectRegion(mRegionMin, mRegionMax);
+                if (group.button("Add", true) && isValidRegion && mSelections.size() < kPixelDebugMaxSelections)
+                    addRegion(mRegionMin, mRegionMax);
+                if (group.button("Clear", true))
+                    clearSelection();
+            }
+
+            if (auto group = widget->group("Log"))
+            {
+                group.checkbox("Log to console", mLogToConsole);
+
+                uint32_t printCapacity = mPrintCapacity;
+                uint32_t assertCapacity = mAssertCapacity;
+                bool capacityChanged = group.var("Print capacity", printCapacity, 1u, kMaxCapacity);
+                capacityChanged |= group.var("Assert capacity", assertCapacity, 1u, kMaxCapacity);
+                if (capacityChanged)
+                    setCapacity(printCapacity, assertCapacity);
+                group.tooltip("Number of records the GPU buffers hold per frame. Older records of a frame are overwritten.", true);
+                group.checkbox("Grow on overflow", mGrowOnOverflow);
+                group.tooltip("Grow the buffers when records of a frame were overwritten.", true);
+
+                if (group.textbox("Message filter", mMessageFilter))
+                {
+                    PixelDebugLog::Filter filter = mLog.getCaptureFilter();
+                    filter.message = mMessageFilter;
+                    mLog.setCaptureFilter(filter);
+                }
+                group.tooltip("Only records with messages containing this string are captured.", true);
+
+                group.textbox("Dump file", mDumpPath);
+                if (!mLog.isDumping())
+                {
+                    if (group.button("Start dump"))
+                        mLog.startDump(mDumpPath);
+                }
+                else if (group.button("Stop dump"))
+                {
+                    mLog.stopDump();
+                }
+                if (group.button("Clear log", true))
+                    mLog.clear();
+
+                const auto& stats = mLog.getStats();
+                group.text(fmt::format(
+                    "Frames: {}\nPrints: {} ({} overflowed)\nAsserts: {} ({} overflowed)\nFiltered: {}\nReadback stalls: {}",
+                    stats.frames,
+                    stats.prints,
+                    stats.printOverflow,
+                    stats.asserts,
+                    stats.assertOverflow,
+                    stats.filtered,
+                    getReadbackStats().stalls
+                ));
+
+                std::ostringstream oss;
+                oss << "Messages:\n";
+                for (const auto& msg : mLog.getMessageStats())
+                {
+                    oss << "  '" << msg.message << "' prints: " << msg.prints << " asserts: " << msg.asserts;
+                    if (msg.prints > 0)
+                        oss << " range: [" << msg.minValue << ", " << msg.maxValue << "] non-finite: " << msg.nonFinite;
+                    oss << "\n";
+                }
+                group.text(oss.str());
+            }
         }
     }
 
-    // Fetch stats and show log if available.
-    bool isNewData = copyDataToCPU();
-    if (mDataValid)
+    // Fetch data and show the log of the last frame if available.
+    bool isNewData = poll();
+    if (mLog.getStats().frames > 0)
     {
+        PixelDebugLog::Filter filter;
+        filter.firstFrame = mLog.getLastFrame();
+        auto prints = mLog.getPrints(filter);
+        auto asserts = mLog.getAsserts(filter);
+
         std::ostringstream oss;
+        const bool multiPixel = mSelections.size() != 1 || any(mSelections[0].zw() - mSelections[0].xy() > uint2(1));
 
         // Print list of printed values.
-        oss << "Pixel log:" << (mPrintData.empty() ? " <empty>\n" : "\n");
-        for (auto v : mPrintData)
+        oss << "Pixel log:" << (prints.empty() ? " <empty>\n" : "\n");
+        for (size_t i = 0; i < std::min(prints.size(), kMaxDisplayedRecords); i++)
         {
-            // Print message.
-            auto it = mHashToString.find(v.msgHash);
-            if (it != mHashToString.end() && !it->second.empty())
-                oss << it->second << " ";
-
-            // Parse value and convert to string.
-            if (v.count > 1)
-                oss << "(";
-            for (uint32_t i = 0; i < v.count; i++)
-            {
-                uint32_t bits = v.data[i];
-                switch ((PrintValueType)v.type)
-                {
-                case PrintValueType::Bool:
-                    oss << (bits != 0 ? "true" : "false");
-                    break;
-                case PrintValueType::Int:
-                    oss << (int32_t)bits;
-                    break;
-                case PrintValueType::Uint:
-                    oss << bits;
-                    break;
-                case PrintValueType::Float:
-                    oss << fstd::bit_cast<float>(bits);
-                    break;
-                default:
-                    oss << "INVALID VALUE";
-                    break;
-                }
-                if (i + 1 < v.count)
-                    oss << ", ";
-            }
-            if (v.count > 1)
-                oss << ")";
-            oss << "\n";
+            if (multiPixel)
+                oss << "(" << prints[i].pixel.x << ", " << prints[i].pixel.y << ") ";
+            oss << mLog.formatPrint(prints[i]) << "\n";
         }
+        if (prints.size() > kMaxDisplayedRecords)
+            oss << "... " << prints.size() - kMaxDisplayedRecords << " more\n";
 
         // Print list of asserts.
-        if (!mAssertData.empty())
+        if (!asserts.empty())
         {
             oss << "\n";
-            for (auto v : mAssertData)
-            {
-                oss << "Assert at (" << v.launchIndex.x << ", " << v.launchIndex.y << ", " << v.launchIndex.z << ")";
-                auto it = mHashToString.find(v.msgHash);
-                if (it != mHashToString.end() && !it->second.empty())
-                    oss << " " << it->second;
-                oss << "\n";
-            }
+            for (size_t i = 0; i < std::min(asserts.size(), kMaxDisplayedRecords); i++)
+                oss << mLog.formatAssert(asserts[i]) << "\n";
+            if (asserts.size() > kMaxDisplayedRecords)
+                oss << "... " << asserts.size() - kMaxDisplayedRecords << " more\n";
         }
 
         if (widget)
             widget->text(oss.str());
 
-        bool isEmpty = mPrintData.empty() && mAssertData.empty();
-        if (isNewData && !isEmpty)
+        bool isEmpty = prints.empty() && asserts.empty();
+        if (isNewData && !isEmpty && mLogToConsole)
             logInfo("\n" + oss.str());
     }
 }
@@ -239,45 +321,91 @@ bool PixelDebug::onMouseEvent(const MouseEvent& mouseEvent)
     {
         if (mouseEvent.type == MouseEvent::Type::ButtonDown && mouseEvent.button == Input::MouseButton::Left)
         {
-            mSelectedPixel = uint2(mouseEvent.pos * float2(mFrameDim));
+            uint2 pixel = uint2(mouseEvent.pos * float2(mFrameDim));
+            if (mouseEvent.hasModifier(Input::Modifier::Shift) && mSelections.size() < kPixelDebugMaxSelections)
+                addPixel(pixel);
+            else
+                selectPixel(pixel);
             return true;
         }
     }
     return false;
 }
 
-bool PixelDebug::copyDataToCPU()
+void PixelDebug::selectRegion(const uint2& minPixel, const uint2& maxPixel)
 {
-    FALCOR_ASSERT(!mRunning);
-    if (mWaitingForData)
-    {
-        // Wait for signal.
-        mpFence->wait();
-        mWaitingForData = false;
+    mSelections.clear();
+    addRegion(minPixel, maxPixel);
+}
 
-        if (mEnabled)
-        {
-            // Copy data from readback buffer to CPU buffers.
-            const uint8_t* data = reinterpret_cast<const uint8_t*>(mpReadbackBuffer->map());
-            const uint32_t* counterData = reinterpret_cast<const uint32_t*>(data);
-            data += mpCounterBuffer->getSize();
-            const PrintRecord* printData = reinterpret_cast<const PrintRecord*>(data);
-            data += mpPrintBuffer->getSize();
-            const AssertRecord* assertData = reinterpret_cast<const AssertRecord*>(data);
-
-            const uint32_t printCount = std::min(mpPrintBuffer->getElementCount(), counterData[0]);
-            const uint32_t assertCount = std::min(mpAssertBuffer->getElementCount(), counterData[1]);
-
-            mPrintData.assign(printData, printData + printCount);
-            mAssertData.assign(assertData, assertData + assertCount);
-
-            mpReadbackBuffer->unmap();
-            mDataValid = true;
-            return true;
-        }
-    }
+void PixelDebug::addRegion(const uint2& minPixel, const uint2& maxPixel)
+{
+    FALCOR_CHECK(mSelections.size() < kPixelDebugMaxSelections, "Can't select more than {} regions.", kPixelDebugMaxSelections);
+    FALCOR_CHECK(all(minPixel < maxPixel), "Region must not be empty.");
+    mSelections.push_back(uint4(minPixel, maxPixel));
+    reserveForSelection();
+}
 
-    return false;
+void PixelDebug::reserveForSelection()
+{
+    uint64_t pixelCount = 0;
+    for (const auto& selection : mSelections)
+        pixelCount += uint64_t(selection.z - selection.x) * (selection.w - selection.y);
+    const uint32_t required = (uint32_t)std::min<uint64_t>(pixelCount * mPrintsPerPixel, kMaxCapacity);
+    mPrintCapacity = std::max(mPrintCapacity, required);
+}
+
+bool PixelDebug::poll()
+{
+    uint64_t frames = mLog.getStats().frames;
+    if (mpReadbackRing)
+        mpReadbackRing->poll();
+    return mLog.getStats().frames != frames;
+}
+
+bool PixelDebug::flush()
+{
+    FALCOR_CHECK(!mRunning, "Logging is running, call endFrame() before flush().");
+    uint64_t frames = mLog.getStats().frames;
+    if (mpReadbackRing)
+        mpReadbackRing->flush();
+    return mLog.getStats().frames != frames;
+}
+
+void PixelDebug::onSnapshot(uint64_t frameIndex, const void* pData, size_t size)
+{
+    FALCOR_ASSERT(size == mpReadbackRing->getSlotSize());
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(pData);
+    const uint32_t* counterData = reinterpret_cast<const uint32_t*>(data);
+    data += mpCounterBuffer->getSize();
+    const PrintRecord* printData = reinterpret_cast<const PrintRecord*>(data);
+    data += mpPrintBuffer->getSize();
+    const AssertRecord* assertData = reinterpret_cast<const AssertRecord*>(data);
+
+    PixelDebugLog::Snapshot snapshot;
+    snapshot.frameIndex = frameIndex;
+    snapshot.printCount = counterData[0];
+    snapshot.assertCount = counterData[1];
+    snapshot.pPrintRing = printData;
+    snapshot.printCapacity = mpPrintBuffer->getElementCount();
+    snapshot.pAssertRing = assertData;
+    snapshot.assertCapacity = mpAssertBuffer->getElementCount();
+
+    const PixelDebugLog::Stats prevStats = mLog.getStats();
+    mLog.ingest(snapshot);
+
+    // Grow the buffers to hold the records of the largest frame. They are reallocated in the next beginFrame().
+    if (mGrowOnOverflow)
+    {
+        auto grow = [](uint32_t capacity, uint32_t records)
+        { return std::min(std::max(capacity * 2, records), kMaxCapacity); };
+        const PixelDebugLog::Stats& stats = mLog.getStats();
+        if (stats.printOverflow > prevStats.printOverflow)
+            mPrintCapacity = std::max(mPrintCapacity, grow(snapshot.printCapacity, stats.maxFramePrints));
+        if (stats.assertOverflow > prevStats.assertOverflow)
+            mAssertCapacity = std::max(mAssertCapacity, grow(snapshot.assertCapacity, stats.maxFrameAsserts));
+    }
 }
 
 } // namespace Falcor
@@ -27,13 +27,14 @@
  **************************************************************************/
 #pragma once
 #include "PixelDebugTypes.slang"
+#include "PixelDebugLog.h"
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
-#include "Core/API/Fence.h"
 #include "Core/Program/Program.h"
+#include "Utils/GpuReadbackRing.h"
 #include "Utils/UI/Gui.h"
+#include <filesystem>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 namespace Falcor
@@ -52,24 +53,34 @@ class RenderContext;
  * Runtime usage:
  * - Import PixelDebug.slang in your shader.
  * - Use printSetPixel() in the shader to set the current pixel.
- * - Use print() in the shader to output values for the selected pixel.
+ * - Use print() in the shader to output values for the selected pixels.
  * All basic types (e.g. bool, int3, float2, uint4) are supported.
  * - Click the left mouse button (or edit the coords) to select a pixel.
+ * Shift-click adds pixels, and regions can be selected in the UI or with selectRegion().
  * - Use assert() in the shader to test a condition for being true.
  * All pixels are tested, and failed asserts logged. The coordinates
  * of asserts that trigger can be used with print() to debug further.
  *
+ * Records are appended to GPU ring buffers and read back asynchronously, so frames never wait
+ * for the log. Records are collected in a PixelDebugLog every frame, which counts records that
+ * were overwritten before readback, filters and aggregates them, and can stream them to a file.
+ * This allows capturing rare events (e.g. fireflies) over many frames. The print buffer is sized
+ * for the selected pixels (see setPrintsPerPixel()), and both buffers grow when records overflow.
+ *
  * The shader code is disabled (using macros) when debugging is off.
- * When enabled, async readback is used but expect a minor perf loss.
+ * When enabled, expect a minor perf loss.
  */
 class FALCOR_API PixelDebug
 {
 public:
+    /// Maximum capacity of the ring buffers in records.
+    static constexpr uint32_t kMaxCapacity = 1u << 20;
+
     /**
      * Constructor. Throws an exception on error.
      * @param[in] pDevice GPU device.
-     * @param[in] printCapacity Maximum number of shader print() statements per frame.
-     * @param[in] assertCapacity Maximum number of shader assert() statements per frame.
+     * @param[in] printCapacity Initial capacity of the print ring buffer. Older records are overwritten when more print() statements are logged per frame.
+     * @param[in] assertCapacity Initial capacity of the assert ring buffer. Older records are overwritten when more assert() statements are logged per frame.
      */
     PixelDebug(ref<Device> pDevice, uint32_t printCapacity = 100, uint32_t assertCapacity = 100);
 
@@ -88,35 +99,99 @@ public:
 
     void enable() { mEnabled = true; }
 
+    /// Select a single pixel, replacing the current selection.
+    void selectPixel(const uint2& pixel) { selectRegion(pixel, pixel + uint2(1)); }
+
+    /// Add a pixel to the selection.
+    void addPixel(const uint2& pixel) { addRegion(pixel, pixel + uint2(1)); }
+
+    /**
+     * Select a region, replacing the current selection.
+     * @param[in] minPixel First pixel of the region.
+     * @param[in] maxPixel Pixel after the last pixel of the region (exclusive).
+     */
+    void selectRegion(const uint2& minPixel, const uint2& maxPixel);
+
+    /// Add a region to the selection. Adding more than kPixelDebugMaxSelections regions throws.
+    void addRegion(const uint2& minPixel, const uint2& maxPixel);
+
+    /// Clear the selection. Only asserts are logged while nothing is selected.
+    void clearSelection() { mSelections.clear(); }
+
+    /// Return the selected regions as (min.x, min.y, max.x, max.y), max is exclusive.
+    const std::vector<uint4>& getSelections() const { return mSelections; }
+
+    /**
+     * Set the capacities of the ring buffers. The buffers are reallocated in the next beginFrame().
+     * @param[in] printCapacity Capacity of the print ring buffer, at most kMaxCapacity.
+     * @param[in] assertCapacity Capacity of the assert ring buffer, at most kMaxCapacity.
+     */
+    void setCapacity(uint32_t printCapacity, uint32_t assertCapacity);
+
+    uint32_t getPrintCapacity() const { return mPrintCapacity; }
+    uint32_t getAssertCapacity() const { return mAssertCapacity; }
+
+    /**
+     * Set the number of print() statements executed per pixel and frame. The print capacity is raised
+     * to hold the prints of all selected pixels whenever the selection changes.
+     */
+    void setPrintsPerPixel(uint32_t printsPerPixel);
+
+    /// Enable growing the ring buffers to the number of records of a frame when they overflow. Enabled by default.
+    void setGrowOnOverflow(bool enabled) { mGrowOnOverflow = enabled; }
+    bool isGrowOnOverflow() const { return mGrowOnOverflow; }
+
+    /// Return the log collecting the records read back from the GPU.
+    PixelDebugLog& getLog() { return mLog; }
+    const PixelDebugLog& getLog() const { return mLog; }
+
+    /**
+     * Collect the data of all frames that have finished on the GPU. This call never blocks.
+     * It is called by beginFrame() and renderUI().
+     * @return True if new data was collected.
+     */
+    bool poll();
+
+    /**
+     * Wait for the data of all submitted frames and collect it.
+     * @return True if new data was collected.
+     */
+    bool flush();
+
+    /// Return the readback statistics. Stalls indicate that frames waited for the log.
+    ReadbackRing::Stats getReadbackStats() const { return mpReadbackRing ? mpReadbackRing->getStats() : ReadbackRing::Stats(); }
+
 protected:
-    bool copyDataToCPU();
+    void onSnapshot(uint64_t frameIndex, const void* pData, size_t size);
+    void reserveForSelection();
 
     // Internal state
     ref<Device> mpDevice;
-    ref<Program> mpReflectProgram; ///< Program for reflection of types.
-    ref<Buffer> mpCounterBuffer;   ///< Counter buffer (print, assert) on the GPU.
-    ref<Buffer> mpPrintBuffer;     ///< Print buffer on the GPU.
-    ref<Buffer> mpAssertBuffer;    ///< Assert buffer on the GPU.
-    ref<Buffer> mpReadbackBuffer;  ///< Staging buffer for async readback of all data.
-    ref<Fence> mpFence;            ///< GPU fence for sychronizing readback.
+    ref<Program> mpReflectProgram;                   ///< Program for reflection of types.
+    ref<Buffer> mpCounterBuffer;                     ///< Counter buffer (print, assert) on the GPU.
+    ref<Buffer> mpPrintBuffer;                       ///< Print ring buffer on the GPU.
+    ref<Buffer> mpAssertBuffer;                      ///< Assert ring buffer on the GPU.
+    PixelDebugLog mLog;                              ///< Log of records read back from the GPU.
+    std::unique_ptr<GpuReadbackRing> mpReadbackRing; ///< Readback ring for async readback of all data. Declared after the log it refers to.
 
     // Configuration
-    bool mEnabled = false;         ///< Enable debugging features.
-    uint2 mSelectedPixel = {0, 0}; ///< Currently selected pixel.
+    bool mEnabled = false;                                ///< Enable debugging features.
+    bool mLogToConsole = true;                            ///< Write the records of new frames to the logger.
+    bool mGrowOnOverflow = true;                          ///< Grow the ring buffers when records are overwritten before readback.
+    uint32_t mPrintsPerPixel = 1;                         ///< Number of print() statements per pixel and frame, used to size the print buffer.
+    std::vector<uint4> mSelections = {uint4(0, 0, 1, 1)}; ///< Selected regions as (min.x, min.y, max.x, max.y), max is exclusive.
+    uint2 mRegionMin = {0, 0};                            ///< First pixel of the region edited in the UI.
+    uint2 mRegionMax = {16, 16};                          ///< Pixel after the last pixel of the region edited in the UI.
+    std::string mDumpPath = "PixelDebug.log";             ///< Path of the dump file.
+    std::string mMessageFilter;                           ///< Message filter of the log.
 
     // Runtime data
     uint2 mFrameDim = {0, 0};
+    uint64_t mFrameIndex = 0; ///< Frame index, incremented in beginFrame().
 
-    bool mRunning = false;        ///< True when data collection is running (inbetween begin()/end() calls).
-    bool mWaitingForData = false; ///< True if we are waiting for data to become available on the GPU.
-    bool mDataValid = false;      ///< True if data has been read back and is valid.
-
-    std::unordered_map<uint32_t, std::string> mHashToString; ///< Map of string hashes to string values.
-
-    std::vector<PrintRecord> mPrintData;   ///< Print data read back from the GPU.
-    std::vector<AssertRecord> mAssertData; ///< Assert log data read back from the GPU.
+    bool mRunning = false; ///< True when data collection is running (inbetween begin()/end() calls).
 
-    const uint32_t mPrintCapacity = 0;  ///< Capacity of the print buffer in elements.
-    const uint32_t mAssertCapacity = 0; ///< Capacity of the assert buffer in elements.
+    uint32_t mPrintCapacity = 0;  ///< Capacity of the print buffer in elements. Applied to the buffers in beginFrame().
+    uint32_t mAssertCapacity = 0; ///< Capacity of the assert buffer in elements. Applied to the buffers in beginFrame().
 };
 } // namespace Falcor
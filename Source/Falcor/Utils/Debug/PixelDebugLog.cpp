@@ -0,0 +1,361 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PixelDebugLog.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+#include <fstd/bit.h> // TODO: Replace with C++20 <bit> when available on all targets
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace Falcor
+{
+namespace
+{
+double getPrintValue(PrintValueType type, uint32_t bits)
+{
+    switch (type)
+    {
+    case PrintValueType::Bool:
+        return bits != 0 ? 1.0 : 0.0;
+    case PrintValueType::Int:
+        return (int32_t)bits;
+    case PrintValueType::Uint:
+        return bits;
+    case PrintValueType::Float:
+        return fstd::bit_cast<float>(bits);
+    default:
+        return 0.0;
+    }
+}
+} // namespace
+
+PixelDebugLog::PixelDebugLog(size_t historyCapacity) : mHistoryCapacity(historyCapacity) {}
+
+PixelDebugLog::~PixelDebugLog()
+{
+    stopDump();
+}
+
+const std::string& PixelDebugLog::getString(uint32_t hash) const
+{
+    static const std::string kEmpty;
+    auto it = mHashToString.find(hash);
+    return it != mHashToString.end() ? it->second : kEmpty;
+}
+
+void PixelDebugLog::ingest(const Snapshot& snapshot)
+{
+    FALCOR_CHECK(snapshot.printCapacity > 0 && snapshot.assertCapacity > 0, "Snapshot ring capacities must be larger than zero.");
+    FALCOR_CHECK(mStats.frames == 0 || snapshot.frameIndex >= mLastFrame, "Snapshots must be ingested in frame order.");
+
+    // The counters wrap around at 2^32. Unsigned arithmetic gives the correct number of new records,
+    // and the ring slots match the GPU, which computes the slot from the wrapped counter as well.
+    const uint32_t newPrints = snapshot.printCount - mPrintCounter;
+    const uint32_t availablePrints = std::min(newPrints, snapshot.printCapacity);
+    mStats.prints += newPrints;
+    mStats.printOverflow += newPrints - availablePrints;
+    mStats.maxFramePrints = std::max(mStats.maxFramePrints, newPrints);
+    for (uint32_t i = snapshot.printCount - availablePrints; i != snapshot.printCount; i++)
+        capturePrint(snapshot.pPrintRing[i % snapshot.printCapacity]);
+
+    const uint32_t newAsserts = snapshot.assertCount - mAssertCounter;
+    const uint32_t availableAsserts = std::min(newAsserts, snapshot.assertCapacity);
+    mStats.asserts += newAsserts;
+    mStats.assertOverflow += newAsserts - availableAsserts;
+    mStats.maxFrameAsserts = std::max(mStats.maxFrameAsserts, newAsserts);
+    for (uint32_t i = snapshot.assertCount - availableAsserts; i != snapshot.assertCount; i++)
+        captureAssert(snapshot.pAssertRing[i % snapshot.assertCapacity]);
+
+    mPrintCounter = snapshot.printCount;
+    mAssertCounter = snapshot.assertCount;
+    mLastFrame = snapshot.frameIndex;
+    mStats.frames++;
+
+    evict();
+    if (mDumpStream.is_open())
+        mDumpStream.flush();
+}
+
+void PixelDebugLog::clear()
+{
+    mMessageStats.clear();
+    mPrints.clear();
+    mAsserts.clear();
+    mStats = {};
+    mLastFrame = 0;
+}
+
+void PixelDebugLog::reset()
+{
+    clear();
+    resetCounters();
+}
+
+void PixelDebugLog::resetCounters()
+{
+    mPrintCounter = 0;
+    mAssertCounter = 0;
+}
+
+void PixelDebugLog::setHistoryCapacity(size_t capacity)
+{
+    mHistoryCapacity = capacity;
+    evict();
+}
+
+std::vector<PrintRecord> PixelDebugLog::getPrints(const Filter& filter) const
+{
+    std::vector<PrintRecord> result;
+    if (filter.prints)
+    {
+        for (const auto& rec : mPrints)
+            if (matches(filter, rec.msgHash, rec.frameIndex, rec.pixel))
+                result.push_back(rec);
+    }
+    return result;
+}
+
+std::vector<AssertRecord> PixelDebugLog::getAsserts(const Filter& filter) const
+{
+    std::vector<AssertRecord> result;
+    if (filter.asserts)
+    {
+        for (const auto& rec : mAsserts)
+            if (matches(filter, rec.msgHash, rec.frameIndex, rec.launchIndex.xy()))
+                result.push_back(rec);
+    }
+    return result;
+}
+
+std::vector<PixelDebugLog::MessageStats> PixelDebugLog::getMessageStats() const
+{
+    std::vector<MessageStats> result;
+    result.reserve(mMessageStats.size());
+    for (const auto& [hash, stats] : mMessageStats)
+        result.push_back(stats);
+    std::sort(
+        result.begin(),
+        result.end(),
+        [](const MessageStats& a, const MessageStats& b)
+        {
+            uint64_t countA = a.prints + a.asserts;
+            uint64_t countB = b.prints + b.asserts;
+            return countA != countB ? countA > countB : a.message < b.message;
+        }
+    );
+    return result;
+}
+
+std::string PixelDebugLog::formatPrint(const PrintRecord& rec) const
+{
+    std::ostringstream oss;
+
+    // Print message.
+    const std::string& msg = getString(rec.msgHash);
+    if (!msg.empty())
+        oss << msg << " ";
+
+    // Parse value and convert to string.
+    if (rec.count > 1)
+        oss << "(";
+    for (uint32_t i = 0; i < rec.count; i++)
+    {
+        uint32_t bits = rec.data[i];
+        switch ((PrintValueType)rec.type)
+        {
+        case PrintValueType::Bool:
+            oss << (bits != 0 ? "true" : "false");
+            break;
+        case PrintValueType::Int:
+            oss << (int32_t)bits;
+            break;
+        case PrintValueType::Uint:
+            oss << bits;
+            break;
+        case PrintValueType::Float:
+            oss << fstd::bit_cast<float>(bits);
+            break;
+        default:
+            oss << "INVALID VALUE";
+            break;
+        }
+        if (i + 1 < rec.count)
+            oss << ", ";
+    }
+    if (rec.count > 1)
+        oss << ")";
+    return oss.str();
+}
+
+std::string PixelDebugLog::formatAssert(const AssertRecord& rec) const
+{
+    std::ostringstream oss;
+    oss << "Assert at (" << rec.launchIndex.x << ", " << rec.launchIndex.y << ", " << rec.launchIndex.z << ")";
+    const std::string& msg = getString(rec.msgHash);
+    if (!msg.empty())
+        oss << " " << msg;
+    return oss.str();
+}
+
+bool PixelDebugLog::startDump(const std::filesystem::path& path)
+{
+    stopDump();
+    mDumpStream.open(path, std::ios::out | std::ios::trunc);
+    if (!mDumpStream.is_open())
+    {
+        logWarning("PixelDebugLog: Failed to open dump file '{}'.", path);
+        return false;
+    }
+    return true;
+}
+
+void PixelDebugLog::stopDump()
+{
+    if (mDumpStream.is_open())
+        mDumpStream.close();
+}
+
+bool PixelDebugLog::writeToFile(const std::filesystem::path& path, const Filter& filter) const
+{
+    std::ofstream stream(path, std::ios::out | std::ios::trunc);
+    if (!stream.is_open())
+    {
+        logWarning("PixelDebugLog: Failed to open file '{}' for writing.", path);
+        return false;
+    }
+
+    // Merge prints and asserts by frame to keep the output in capture order.
+    auto prints = getPrints(filter);
+    auto asserts = getAsserts(filter);
+    size_t p = 0;
+    size_t a = 0;
+    while (p < prints.size() || a < asserts.size())
+    {
+        if (a == asserts.size() || (p < prints.size() && prints[p].frameIndex <= asserts[a].frameIndex))
+            stream << formatDumpLine(prints[p++]) << "\n";
+        else
+            stream << formatDumpLine(asserts[a++]) << "\n";
+    }
+    return stream.good();
+}
+
+void PixelDebugLog::capturePrint(const PrintRecord& rec)
+{
+    if (!mCaptureFilter.prints || !matches(mCaptureFilter, rec.msgHash, rec.frameIndex, rec.pixel))
+    {
+        mStats.filtered++;
+        return;
+    }
+
+    auto [it, inserted] = mMessageStats.try_emplace(rec.msgHash);
+    MessageStats& stats = it->second;
+    if (inserted)
+    {
+        stats.message = getString(rec.msgHash);
+        stats.firstFrame = rec.frameIndex;
+    }
+    stats.prints++;
+    stats.lastFrame = rec.frameIndex;
+    stats.lastPixel = rec.pixel;
+    for (uint32_t i = 0; i < std::min(rec.count, 4u); i++)
+    {
+        double value = getPrintValue((PrintValueType)rec.type, rec.data[i]);
+        if (!std::isfinite(value))
+        {
+            stats.nonFinite++;
+            continue;
+        }
+        stats.minValue = std::min(stats.minValue, value);
+        stats.maxValue = std::max(stats.maxValue, value);
+    }
+
+    mPrints.push_back(rec);
+    if (mDumpStream.is_open())
+        mDumpStream << formatDumpLine(rec) << "\n";
+}
+
+void PixelDebugLog::captureAssert(const AssertRecord& rec)
+{
+    if (!mCaptureFilter.asserts || !matches(mCaptureFilter, rec.msgHash, rec.frameIndex, rec.launchIndex.xy()))
+    {
+        mStats.filtered++;
+        return;
+    }
+
+    auto [it, inserted] = mMessageStats.try_emplace(rec.msgHash);
+    MessageStats& stats = it->second;
+    if (inserted)
+    {
+        stats.message = getString(rec.msgHash);
+        stats.firstFrame = rec.frameIndex;
+    }
+    stats.asserts++;
+    stats.lastFrame = rec.frameIndex;
+    stats.lastPixel = rec.launchIndex.xy();
+
+    mAsserts.push_back(rec);
+    if (mDumpStream.is_open())
+        mDumpStream << formatDumpLine(rec) << "\n";
+}
+
+void PixelDebugLog::evict()
+{
+    // Evict the oldest records first. Records of the same frame are evicted prints first.
+    while (mPrints.size() + mAsserts.size() > mHistoryCapacity)
+    {
+        if (mAsserts.empty() || (!mPrints.empty() && mPrints.front().frameIndex <= mAsserts.front().frameIndex))
+            mPrints.pop_front();
+        else
+            mAsserts.pop_front();
+        mStats.evicted++;
+    }
+}
+
+bool PixelDebugLog::matches(const Filter& filter, uint32_t msgHash, uint64_t frameIndex, uint2 pixel) const
+{
+    if (frameIndex < filter.firstFrame || frameIndex > filter.lastFrame)
+        return false;
+    if (any(pixel < filter.region.xy()) || any(pixel >= filter.region.zw()))
+        return false;
+    if (!filter.message.empty() && getString(msgHash).find(filter.message) == std::string::npos)
+        return false;
+    return true;
+}
+
+std::string PixelDebugLog::formatDumpLine(const PrintRecord& rec) const
+{
+    return fmt::format("{}\t{}\t{}\tprint\t{}", rec.frameIndex, rec.pixel.x, rec.pixel.y, formatPrint(rec));
+}
+
+std::string PixelDebugLog::formatDumpLine(const AssertRecord& rec) const
+{
+    return fmt::format("{}\t{}\t{}\tassert\t{}", rec.frameIndex, rec.launchIndex.x, rec.launchIndex.y, formatAssert(rec));
+}
+
+} // namespace Falcor
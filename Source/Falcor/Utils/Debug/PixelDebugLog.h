@@ -0,0 +1,208 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "PixelDebugTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Host-side log of the records captured by PixelDebug.
+ *
+ * On the GPU, records are appended to ring buffers and counted by write counters that are never
+ * reset. Snapshots of the counters and rings are read back asynchronously and passed to ingest()
+ * in frame order. The counter delta between consecutive snapshots determines the new records.
+ * Records that were overwritten on the GPU before they were read back are counted as overflow.
+ *
+ * Ingested records go through a capture filter. Matching records are aggregated by message,
+ * kept in a bounded history and optionally streamed to a dump file. The dump file allows
+ * capturing many frames without holding all records in memory.
+ *
+ * Shader prints don't carry source locations, so the message string identifies the call site.
+ */
+class FALCOR_API PixelDebugLog
+{
+public:
+    static constexpr size_t kDefaultHistoryCapacity = 10000;
+
+    /// Snapshot of the GPU write counters and ring buffers at the end of a frame.
+    struct Snapshot
+    {
+        uint64_t frameIndex = 0;
+        uint32_t printCount = 0;  ///< Value of the print write counter.
+        uint32_t assertCount = 0; ///< Value of the assert write counter.
+        const PrintRecord* pPrintRing = nullptr;
+        uint32_t printCapacity = 0;
+        const AssertRecord* pAssertRing = nullptr;
+        uint32_t assertCapacity = 0;
+    };
+
+    struct Filter
+    {
+        std::string message;                                       ///< Substring the message must contain (empty matches all).
+        uint4 region = uint4(0, 0, UINT32_MAX, UINT32_MAX);        ///< Pixel region as (min.x, min.y, max.x, max.y), max is exclusive.
+        uint64_t firstFrame = 0;                                   ///< First frame to include.
+        uint64_t lastFrame = std::numeric_limits<uint64_t>::max(); ///< Last frame to include.
+        bool prints = true;                                        ///< Include print records.
+        bool asserts = true;                                       ///< Include assert records.
+    };
+
+    struct Stats
+    {
+        uint64_t frames = 0;         ///< Number of ingested snapshots.
+        uint64_t prints = 0;         ///< Number of print records logged on the GPU.
+        uint64_t asserts = 0;        ///< Number of assert records logged on the GPU.
+        uint64_t printOverflow = 0;  ///< Number of print records overwritten before readback.
+        uint64_t assertOverflow = 0; ///< Number of assert records overwritten before readback.
+        uint64_t filtered = 0;       ///< Number of records rejected by the capture filter.
+        uint64_t evicted = 0;        ///< Number of records evicted from the history.
+        uint32_t maxFramePrints = 0;  ///< Largest number of print records logged between two snapshots.
+        uint32_t maxFrameAsserts = 0; ///< Largest number of assert records logged between two snapshots.
+    };
+
+    /// Aggregated statistics of all captured records with the same message.
+    struct MessageStats
+    {
+        std::string message;
+        uint64_t prints = 0;                                        ///< Number of print records.
+        uint64_t asserts = 0;                                       ///< Number of assert records.
+        uint64_t nonFinite = 0;                                     ///< Number of printed float components that are NaN or Inf.
+        double minValue = std::numeric_limits<double>::infinity();  ///< Smallest finite printed component.
+        double maxValue = -std::numeric_limits<double>::infinity(); ///< Largest finite printed component.
+        uint64_t firstFrame = 0;                                    ///< First frame the message was logged in.
+        uint64_t lastFrame = 0;                                     ///< Last frame the message was logged in.
+        uint2 lastPixel = {0, 0};                                   ///< Pixel of the last record.
+    };
+
+    PixelDebugLog(size_t historyCapacity = kDefaultHistoryCapacity);
+    ~PixelDebugLog();
+
+    /// Register the string of a message hash, typically from the hashed strings of a program.
+    void registerString(uint32_t hash, const std::string& str) { mHashToString.emplace(hash, str); }
+
+    /// Return the string of a message hash, or an empty string if unknown.
+    const std::string& getString(uint32_t hash) const;
+
+    /**
+     * Ingest a snapshot. Snapshots must be ingested in frame order.
+     * @param[in] snapshot Snapshot read back from the GPU.
+     */
+    void ingest(const Snapshot& snapshot);
+
+    /// Clear history, statistics and aggregates. The GPU counters are still tracked.
+    void clear();
+
+    /// Clear all state including the tracked GPU counters.
+    void reset();
+
+    /// Reset the tracked GPU counters, keeping history and statistics. Call when the GPU counters are reset.
+    void resetCounters();
+
+    void setCaptureFilter(const Filter& filter) { mCaptureFilter = filter; }
+    const Filter& getCaptureFilter() const { return mCaptureFilter; }
+
+    void setHistoryCapacity(size_t capacity);
+    size_t getHistoryCapacity() const { return mHistoryCapacity; }
+
+    const Stats& getStats() const { return mStats; }
+
+    /// Return the frame index of the last ingested snapshot.
+    uint64_t getLastFrame() const { return mLastFrame; }
+
+    /// Return the print records in the history that match a filter, oldest first.
+    std::vector<PrintRecord> getPrints(const Filter& filter) const;
+    std::vector<PrintRecord> getPrints() const { return getPrints(Filter()); }
+
+    /// Return the assert records in the history that match a filter, oldest first.
+    std::vector<AssertRecord> getAsserts(const Filter& filter) const;
+    std::vector<AssertRecord> getAsserts() const { return getAsserts(Filter()); }
+
+    /// Return the aggregated statistics per message, sorted by decreasing record count.
+    std::vector<MessageStats> getMessageStats() const;
+
+    /// Format a print record as "msg value", as displayed in the UI.
+    std::string formatPrint(const PrintRecord& rec) const;
+
+    /// Format an assert record as "Assert at (x, y, z) msg", as displayed in the UI.
+    std::string formatAssert(const AssertRecord& rec) const;
+
+    /**
+     * Start streaming all captured records to a text file.
+     * Each record is written on a separate line prefixed by its frame index and pixel.
+     * @param[in] path File path. An existing file is overwritten.
+     * @return True if the file was opened.
+     */
+    bool startDump(const std::filesystem::path& path);
+
+    /// Stop streaming to the dump file.
+    void stopDump();
+
+    bool isDumping() const { return mDumpStream.is_open(); }
+
+    /**
+     * Write the records in the history that match a filter to a text file, using the dump file format.
+     * @param[in] path File path. An existing file is overwritten.
+     * @param[in] filter Filter selecting the records.
+     * @return True if the file was written.
+     */
+    bool writeToFile(const std::filesystem::path& path, const Filter& filter) const;
+    bool writeToFile(const std::filesystem::path& path) const { return writeToFile(path, Filter()); }
+
+private:
+    void capturePrint(const PrintRecord& rec);
+    void captureAssert(const AssertRecord& rec);
+    void evict();
+    bool matches(const Filter& filter, uint32_t msgHash, uint64_t frameIndex, uint2 pixel) const;
+    std::string formatDumpLine(const PrintRecord& rec) const;
+    std::string formatDumpLine(const AssertRecord& rec) const;
+
+    std::unordered_map<uint32_t, std::string> mHashToString;  ///< Map of string hashes to string values.
+    std::unordered_map<uint32_t, MessageStats> mMessageStats; ///< Aggregated statistics by message hash.
+
+    std::deque<PrintRecord> mPrints;   ///< History of captured print records.
+    std::deque<AssertRecord> mAsserts; ///< History of captured assert records.
+    size_t mHistoryCapacity;           ///< Maximum total number of records in the history.
+
+    Filter mCaptureFilter;
+    Stats mStats;
+    uint64_t mLastFrame = 0;
+    uint32_t mPrintCounter = 0;  ///< Print write counter of the last snapshot.
+    uint32_t mAssertCounter = 0; ///< Assert write counter of the last snapshot.
+
+    std::ofstream mDumpStream;
+};
+} // namespace Falcor
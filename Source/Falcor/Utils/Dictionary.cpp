@@ -25,18 +25,19 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
-SamplerState gColorSampler;
+#include "Dictionary.h"
+#include <mutex>
 
-Texture2D gColorTex;
-
-float luminance(float3 color)
+namespace Falcor
 {
-    return dot(color, float3(0.299, 0.587, 0.114));
-}
-
-float4 main(float2 texC: TEXCOORD) : SV_TARGET0
+uint32_t Dictionary::internKey(const std::string& name)
 {
-    float4 color = gColorTex.Sample(gColorSampler, texC);
-    float logLuminance = log2(max(0.0001, luminance(color.xyz)));
-    return float4(logLuminance, 0, 0, 1);
+    // The key table is shared by all modules (including plugins), so IDs are consistent across module boundaries.
+    static std::mutex mutex;
+    static std::unordered_map<std::string, uint32_t> keys;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = keys.try_emplace(name, (uint32_t)keys.size());
+    return it->second;
 }
+} // namespace Falcor
@@ -26,15 +26,18 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "Core/Macros.h"
 #include "Core/Error.h"
 #include <unordered_map>
 #include <any>
 #include <memory>
 #include <string>
+#include <typeinfo>
+#include <vector>
 
 namespace Falcor
 {
-class Dictionary
+class FALCOR_API Dictionary
 {
 public:
     class Value
@@ -47,6 +50,7 @@ public:
         void operator=(const T& t)
         {
             mValue = t;
+            mVersion++;
         }
 
         template<typename T>
@@ -56,13 +60,43 @@ public:
         }
 
     private:
+        friend class Dictionary;
+
         std::any mValue;
+        uint32_t mVersion = 0; ///< Incremented whenever the value is replaced. Used to invalidate typed key lookups.
+    };
+
+    /**
+     * Typed dictionary key.
+     * Key names are interned into a process-wide table when the key is created. Accessing a dictionary through a typed key
+     * resolves the key name once per dictionary and then uses an indexed lookup, avoiding string hashing and `std::any_cast`
+     * on hot paths. Typed keys and string keys with the same name refer to the same value.
+     * Keys are meant to be created once, e.g., as global constants.
+     */
+    template<typename T>
+    class Key
+    {
+    public:
+        explicit Key(std::string name) : mName(std::move(name)), mID(internKey(mName)) {}
+
+        const std::string& getName() const { return mName; }
+        uint32_t getID() const { return mID; }
+
+    private:
+        std::string mName;
+        uint32_t mID;
     };
 
     using Container = std::unordered_map<std::string, Value>;
 
     Dictionary() = default;
     Dictionary(const Dictionary& d) : mContainer(d.mContainer) {}
+    Dictionary& operator=(const Dictionary& d)
+    {
+        mContainer = d.mContainer;
+        mSlots.clear();
+        return *this;
+    }
 
     Value& operator[](const std::string& key) { return mContainer[key]; }
     const Value& operator[](const std::string& key) const { return mContainer.at(key); }
@@ -95,7 +129,99 @@ public:
         return it != mContainer.end() ? it->second : defaultValue;
     }
 
+    /// Check if a typed key exists.
+    template<typename T>
+    bool keyExists(const Key<T>& key) const
+    {
+        return getSlot(key) != nullptr;
+    }
+
+    /// Get a pointer to the value of a typed key. Returns nullptr if the key does not exist or holds a value of a different type.
+    template<typename T>
+    const T* tryGetValue(const Key<T>& key) const
+    {
+        return resolve(key);
+    }
+
+    /// Get value by typed key. Throws an exception if key does not exist or holds a value of a different type.
+    template<typename T>
+    const T& getValue(const Key<T>& key) const
+    {
+        const T* pValue = resolve(key);
+        FALCOR_CHECK(pValue, "Key '{}' does not exist or has a different type", key.getName());
+        return *pValue;
+    }
+
+    /// Get value by typed key. Returns the specified default value if key does not exist.
+    /// Throws an exception if the key holds a value of a different type, as the string key lookup does.
+    template<typename T>
+    T getValue(const Key<T>& key, const T& defaultValue) const
+    {
+        if (const T* pValue = resolve(key))
+            return *pValue;
+        FALCOR_CHECK(!keyExists(key), "Key '{}' has a different type", key.getName());
+        return defaultValue;
+    }
+
+    /// Set value by typed key. Creates the key if it does not exist.
+    template<typename T>
+    void setValue(const Key<T>& key, const T& value)
+    {
+        if (T* pValue = const_cast<T*>(resolve(key)))
+        {
+            // Assign in place, which keeps previously resolved pointers valid.
+            *pValue = value;
+            return;
+        }
+        mContainer[key.getName()] = value;
+    }
+
 private:
+    /// Cached resolution of a typed key.
+    struct Slot
+    {
+        Value* pValue = nullptr;               ///< Value in the container. Stable as values are never erased.
+        void* pData = nullptr;                 ///< Pointer to the value's data, or nullptr if it holds a different type.
+        const std::type_info* pType = nullptr; ///< Type pData was resolved for.
+        uint32_t version = ~0u;                ///< Value version pData was resolved for.
+    };
+
+    /// Intern a key name into the process-wide key table and return its ID.
+    static uint32_t internKey(const std::string& name);
+
+    template<typename T>
+    Slot* getSlot(const Key<T>& key) const
+    {
+        uint32_t id = key.getID();
+        if (id < mSlots.size() && mSlots[id].pValue)
+            return &mSlots[id];
+
+        auto it = mContainer.find(key.getName());
+        if (it == mContainer.end())
+            return nullptr;
+        if (id >= mSlots.size())
+            mSlots.resize(id + 1);
+        mSlots[id].pValue = const_cast<Value*>(&it->second);
+        return &mSlots[id];
+    }
+
+    template<typename T>
+    const T* resolve(const Key<T>& key) const
+    {
+        Slot* pSlot = getSlot(key);
+        if (!pSlot)
+            return nullptr;
+        // Keys of different types may share the same name, so the slot is re-resolved on type changes.
+        if (pSlot->version != pSlot->pValue->mVersion || pSlot->pType != &typeid(T))
+        {
+            pSlot->pData = std::any_cast<T>(&pSlot->pValue->mValue);
+            pSlot->pType = &typeid(T);
+            pSlot->version = pSlot->pValue->mVersion;
+        }
+        return static_cast<const T*>(pSlot->pData);
+    }
+
     Container mContainer;
+    mutable std::vector<Slot> mSlots; ///< Resolved typed keys, indexed by key ID.
 };
 } // namespace Falcor
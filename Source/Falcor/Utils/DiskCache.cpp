@@ -0,0 +1,551 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "DiskCache.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <streambuf>
+#include <vector>
+
+namespace Falcor
+{
+
+namespace
+{
+const char kTrailerMagic[8] = {'F', 'a', 'l', 'c', 'o', 'r', 'D', 'C'};
+
+/// Trailer appended to each entry.
+struct Trailer
+{
+    uint64_t payloadSize = 0;
+    uint64_t checksum = 0;
+    char magic[8] = {};
+
+    bool isValid(uint64_t fileSize) const
+    {
+        return std::memcmp(magic, kTrailerMagic, sizeof(magic)) == 0 && payloadSize + sizeof(Trailer) == fileSize;
+    }
+};
+static_assert(sizeof(Trailer) == 24);
+
+/**
+ * Name of the lock file used to serialize eviction between processes.
+ * Entry lock files are only opened while holding it in shared mode and only deleted while holding it
+ * exclusively, so no process can lock a lock file that is being deleted.
+ */
+const char kEvictionLockName[] = "#eviction.lock";
+
+/// Temporary files older than this are considered left over from crashed writers.
+const auto kStaleTempFileAge = std::chrono::hours(24);
+
+const size_t kStreamBufferSize = 64 * 1024;
+
+/**
+ * Fast non-cryptographic 64-bit checksum.
+ * Processes four independent 64-bit lanes (same round function as xxHash64) to allow streaming
+ * multi-GB files at memory bandwidth.
+ */
+class Checksum
+{
+public:
+    void update(const void* data, size_t len)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+        mTotalSize += len;
+
+        // Complete a partially filled stripe.
+        if (mPendingSize > 0)
+        {
+            size_t n = std::min(len, kStripeSize - mPendingSize);
+            std::memcpy(mPending.data() + mPendingSize, p, n);
+            mPendingSize += n;
+            p += n;
+            len -= n;
+            if (mPendingSize < kStripeSize)
+                return;
+            consumeStripe(mPending.data());
+            mPendingSize = 0;
+        }
+
+        while (len >= kStripeSize)
+        {
+            consumeStripe(p);
+            p += kStripeSize;
+            len -= kStripeSize;
+        }
+
+        std::memcpy(mPending.data(), p, len);
+        mPendingSize = len;
+    }
+
+    uint64_t finalize() const
+    {
+        uint64_t h = rotl(mLanes[0], 1) + rotl(mLanes[1], 7) + rotl(mLanes[2], 12) + rotl(mLanes[3], 18);
+        h ^= mTotalSize;
+        for (size_t i = 0; i < mPendingSize; ++i)
+            h = rotl(h ^ (mPending[i] * kPrime5), 11) * kPrime1;
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    static constexpr size_t kStripeSize = 32;
+    static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+    static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    void consumeStripe(const uint8_t* p)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            uint64_t v;
+            std::memcpy(&v, p + i * 8, 8);
+            mLanes[i] = rotl(mLanes[i] + v * kPrime2, 31) * kPrime1;
+        }
+    }
+
+    uint64_t mLanes[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+    std::array<uint8_t, kStripeSize> mPending;
+    size_t mPendingSize = 0;
+    uint64_t mTotalSize = 0;
+};
+
+/// Output stream buffer forwarding to another stream while computing the checksum.
+class ChecksumOutputBuffer : public std::streambuf
+{
+public:
+    ChecksumOutputBuffer(std::ostream& stream) : mStream(stream) {}
+
+    uint64_t getSize() const { return mSize; }
+    uint64_t getChecksum() const { return mChecksum.finalize(); }
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        mStream.write(s, n);
+        if (!mStream)
+            return 0;
+        mChecksum.update(s, (size_t)n);
+        mSize += n;
+        return n;
+    }
+
+    int_type overflow(int_type ch) override
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+            return traits_type::not_eof(ch);
+        char c = traits_type::to_char_type(ch);
+        return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+    }
+
+private:
+    std::ostream& mStream;
+    Checksum mChecksum;
+    uint64_t mSize = 0;
+};
+
+/// Input stream buffer reading a fixed number of bytes from another stream while computing the checksum.
+class ChecksumInputBuffer : public std::streambuf
+{
+public:
+    ChecksumInputBuffer(std::istream& stream, uint64_t size) : mStream(stream), mRemaining(size), mBuffer(kStreamBufferSize) {}
+
+    /// Consume all remaining bytes. Returns true if the expected number of bytes was available.
+    bool drain()
+    {
+        while (!traits_type::eq_int_type(underflow(), traits_type::eof()))
+            setg(egptr(), egptr(), egptr());
+        return mRemaining == 0;
+    }
+
+    uint64_t getChecksum() const { return mChecksum.finalize(); }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (mRemaining == 0)
+            return traits_type::eof();
+
+        size_t n = (size_t)std::min<uint64_t>(mRemaining, mBuffer.size());
+        mStream.read(mBuffer.data(), n);
+        n = (size_t)mStream.gcount();
+        if (n == 0)
+            return traits_type::eof();
+
+        mChecksum.update(mBuffer.data(), n);
+        mRemaining -= n;
+        setg(mBuffer.data(), mBuffer.data(), mBuffer.data() + n);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    std::istream& mStream;
+    uint64_t mRemaining;
+    std::vector<char> mBuffer;
+    Checksum mChecksum;
+};
+
+bool readTrailer(const std::filesystem::path& path, Trailer& trailer)
+{
+    std::error_code ec;
+    uint64_t fileSize = std::filesystem::file_size(path, ec);
+    if (ec || fileSize < sizeof(Trailer))
+        return false;
+
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs)
+        return false;
+    fs.seekg(fileSize - sizeof(Trailer));
+    fs.read(reinterpret_cast<char*>(&trailer), sizeof(Trailer));
+    return fs.good() && trailer.isValid(fileSize);
+}
+
+bool isValidKey(const std::string& key)
+{
+    return !key.empty() &&
+           std::all_of(key.begin(), key.end(), [](char c) { return std::isalnum((unsigned char)c) || c == '_' || c == '-'; });
+}
+} // namespace
+
+DiskCache::DiskCache(const std::filesystem::path& directory, uint64_t sizeBudget) : mDirectory(directory), mSizeBudget(sizeBudget) {}
+
+std::filesystem::path DiskCache::getEntryPath(const std::string& key) const
+{
+    FALCOR_CHECK(isValidKey(key), "Invalid cache key '{}'.", key);
+    return mDirectory / key;
+}
+
+bool DiskCache::hasEntry(const std::string& key) const
+{
+    Trailer trailer;
+    return readTrailer(getEntryPath(key), trailer);
+}
+
+std::unique_ptr<LockFile> DiskCache::lockForWriting(const std::string& key, bool wait) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(mDirectory, ec);
+
+    return lockEntry(key, LockFile::LockType::Exclusive, wait);
+}
+
+bool DiskCache::write(const std::string& key, const WriteFunc& func, LockFile* pWriterLock)
+{
+    const auto entryPath = getEntryPath(key);
+
+    std::unique_ptr<LockFile> pOwnedLock;
+    if (!pWriterLock)
+    {
+        pOwnedLock = lockForWriting(key, false);
+        if (!pOwnedLock)
+        {
+            logInfo("Skipping write of cache entry '{}' which is being written by another process.", entryPath);
+            return false;
+        }
+    }
+
+    // Write to a uniquely named temporary file next to the entry.
+    std::random_device rd;
+    const auto tempPath = mDirectory / fmt::format("{}.{:08x}{:08x}.tmp", key, rd(), rd());
+    try
+    {
+        std::ofstream fs(tempPath, std::ios_base::binary);
+        if (!fs)
+            FALCOR_THROW("Failed to create cache file '{}'.", tempPath);
+
+        ChecksumOutputBuffer buffer(fs);
+        {
+            std::ostream stream(&buffer);
+            func(stream);
+            stream.flush();
+            if (!stream)
+                FALCOR_THROW("Failed to write cache file '{}'.", tempPath);
+        }
+
+        Trailer trailer;
+        trailer.payloadSize = buffer.getSize();
+        trailer.checksum = buffer.getChecksum();
+        std::memcpy(trailer.magic, kTrailerMagic, sizeof(trailer.magic));
+        fs.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+        fs.close();
+        if (fs.fail())
+            FALCOR_THROW("Failed to write cache file '{}'.", tempPath);
+    }
+    catch (...)
+    {
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        throw;
+    }
+
+    // Atomically move the complete file into place.
+    std::error_code ec;
+    std::filesystem::rename(tempPath, entryPath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        FALCOR_THROW("Failed to move cache file to '{}'.", entryPath);
+    }
+
+    enforceSizeBudget(key);
+    return true;
+}
+
+bool DiskCache::read(const std::string& key, const ReadFunc& func)
+{
+    const auto entryPath = getEntryPath(key);
+    if (!hasEntry(key))
+        return false;
+
+    bool checksumValid = false;
+    {
+        // Hold a shared lock to prevent the entry from being replaced or evicted while reading.
+        auto pLock = lockEntry(key, LockFile::LockType::Shared, true);
+        if (!pLock)
+            FALCOR_THROW("Failed to lock cache file '{}'.", entryPath);
+
+        Trailer trailer;
+        if (!readTrailer(entryPath, trailer))
+            return false;
+
+        std::ifstream fs(entryPath, std::ios_base::binary);
+        if (!fs)
+            FALCOR_THROW("Failed to open cache file '{}'.", entryPath);
+
+        ChecksumInputBuffer buffer(fs, trailer.payloadSize);
+        auto verify = [&]() { return buffer.drain() && buffer.getChecksum() == trailer.checksum; };
+        try
+        {
+            std::istream stream(&buffer);
+            func(stream);
+        }
+        catch (...)
+        {
+            // Errors caused by corrupt data are reported as such.
+            if (verify())
+                throw;
+        }
+        checksumValid = verify();
+
+        if (checksumValid)
+            touch(entryPath);
+    }
+
+    if (!checksumValid)
+    {
+        remove(key);
+        FALCOR_THROW("Checksum mismatch in cache file '{}'.", entryPath);
+    }
+
+    return true;
+}
+
+bool DiskCache::peek(const std::string& key, void* data, size_t size) const
+{
+    const auto entryPath = getEntryPath(key);
+    Trailer trailer;
+    if (!readTrailer(entryPath, trailer) || trailer.payloadSize < size)
+        return false;
+
+    std::ifstream fs(entryPath, std::ios_base::binary);
+    fs.read(reinterpret_cast<char*>(data), size);
+    return fs.good();
+}
+
+bool DiskCache::remove(const std::string& key)
+{
+    const auto entryPath = getEntryPath(key);
+
+    // Don't block, processes waiting for entry locks hold the eviction lock in shared mode.
+    LockFile evictionLock(mDirectory / kEvictionLockName);
+    if (!evictionLock.tryLock(LockFile::LockType::Exclusive))
+        return false;
+
+    return removeEntry(key);
+}
+
+uint64_t DiskCache::getTotalSize() const
+{
+    uint64_t totalSize = 0;
+    std::error_code ec;
+    for (const auto& it : std::filesystem::directory_iterator(mDirectory, ec))
+    {
+        if (it.is_regular_file(ec) && isValidKey(it.path().filename().string()))
+            totalSize += it.file_size(ec);
+    }
+    return totalSize;
+}
+
+void DiskCache::enforceSizeBudget(const std::string& keep)
+{
+    if (mSizeBudget == kUnlimited)
+        return;
+
+    // Only one process evicts at a time. If another process is already evicting, it will enforce the budget.
+    LockFile evictionLock(mDirectory / kEvictionLockName);
+    if (!evictionLock.tryLock(LockFile::LockType::Exclusive))
+        return;
+
+    struct Entry
+    {
+        std::string key;
+        uint64_t size;
+        std::filesystem::file_time_type accessTime;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t totalSize = 0;
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::error_code ec;
+    for (const auto& it : std::filesystem::directory_iterator(mDirectory, ec))
+    {
+        if (!it.is_regular_file(ec))
+            continue;
+
+        const auto& path = it.path();
+        auto accessTime = it.last_write_time(ec);
+        if (ec)
+            continue;
+
+        // Remove temporary files left over from crashed writers.
+        if (path.extension() == ".tmp")
+        {
+            if (now - accessTime > kStaleTempFileAge)
+                std::filesystem::remove(path, ec);
+            continue;
+        }
+
+        // Remove lock files of entries that don't exist and are not being written.
+        if (path.extension() == ".lock")
+        {
+            const std::string lockKey = path.stem().string();
+            if (isValidKey(lockKey) && !std::filesystem::exists(getEntryPath(lockKey), ec))
+                removeEntry(lockKey);
+            continue;
+        }
+
+        std::string key = path.filename().string();
+        if (!isValidKey(key))
+            continue;
+
+        uint64_t size = it.file_size(ec);
+        if (ec)
+            continue;
+        entries.push_back({std::move(key), size, accessTime});
+        totalSize += size;
+    }
+
+    if (totalSize <= mSizeBudget)
+        return;
+
+    // Evict least recently used entries first.
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.accessTime < b.accessTime; });
+
+    size_t evictedCount = 0;
+    uint64_t evictedSize = 0;
+    for (const auto& entry : entries)
+    {
+        if (totalSize <= mSizeBudget)
+            break;
+        if (entry.key == keep)
+            continue;
+        if (removeEntry(entry.key))
+        {
+            totalSize -= entry.size;
+            evictedSize += entry.size;
+            evictedCount++;
+        }
+    }
+
+    if (evictedCount > 0)
+        logInfo("Evicted {} entries ({}) from cache directory '{}'.", evictedCount, formatByteSize(evictedSize), mDirectory);
+}
+
+std::unique_ptr<LockFile> DiskCache::lockEntry(const std::string& key, LockFile::LockType lockType, bool wait) const
+{
+    // The lock file must not be deleted between opening and locking it.
+    LockFile evictionLock(mDirectory / kEvictionLockName);
+    if (!evictionLock.lock(LockFile::LockType::Shared))
+        return nullptr;
+
+    auto pLock = std::make_unique<LockFile>(getLockPath(key));
+    if (!pLock->isOpen())
+        return nullptr;
+    bool locked = wait ? pLock->lock(lockType) : pLock->tryLock(lockType);
+    return locked ? std::move(pLock) : nullptr;
+}
+
+bool DiskCache::removeEntry(const std::string& key)
+{
+    const auto entryPath = getEntryPath(key);
+    const auto lockPath = getLockPath(key);
+
+    LockFile lock(lockPath);
+    if (!lock.tryLock(LockFile::LockType::Exclusive))
+        return false;
+
+    std::error_code ec;
+    bool removed = std::filesystem::remove(entryPath, ec);
+
+    // Nobody else can open the lock file while the eviction lock is held. Close it first, Windows doesn't delete open files.
+    lock.close();
+    std::filesystem::remove(lockPath, ec);
+    return removed;
+}
+
+std::filesystem::path DiskCache::getLockPath(const std::string& key) const
+{
+    return mDirectory / (key + ".lock");
+}
+
+void DiskCache::touch(const std::filesystem::path& path) const
+{
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+}
+
+} // namespace Falcor
@@ -0,0 +1,167 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "Core/Macros.h"
+#include "Core/Platform/LockFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace Falcor
+{
+
+/**
+ * Multi-process safe, size-bounded store of binary cache files.
+ *
+ * Each entry is a single file in the cache directory, named after its key. Entries are
+ * written to a temporary file first and atomically renamed into place once complete, so
+ * readers never observe partially written files. A trailer containing the payload size and
+ * a checksum is appended to each entry and verified while reading.
+ *
+ * Concurrent access from multiple processes is coordinated with per-entry lock files:
+ * - Writers hold an exclusive lock, which elects a single writer per entry.
+ * - Readers hold a shared lock while streaming an entry.
+ *
+ * The store is bounded by a size budget. Whenever an entry is written, the least recently
+ * used entries are evicted until the total size fits the budget. The access time of an entry
+ * is tracked through its file modification time, which is refreshed on every read.
+ */
+class FALCOR_API DiskCache
+{
+public:
+    using WriteFunc = std::function<void(std::ostream&)>;
+    using ReadFunc = std::function<void(std::istream&)>;
+
+    /// Size budget that disables eviction.
+    static constexpr uint64_t kUnlimited = 0;
+
+    /**
+     * Constructor.
+     * @param directory Cache directory. Created on first write if it doesn't exist.
+     * @param sizeBudget Maximum total size of all entries in bytes (kUnlimited to disable eviction).
+     */
+    DiskCache(const std::filesystem::path& directory, uint64_t sizeBudget = kUnlimited);
+
+    const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+    uint64_t getSizeBudget() const { return mSizeBudget; }
+    void setSizeBudget(uint64_t sizeBudget) { mSizeBudget = sizeBudget; }
+
+    /// Return the path of the entry file for a given key.
+    std::filesystem::path getEntryPath(const std::string& key) const;
+
+    /**
+     * Check if a complete entry exists for a given key.
+     * This only validates the entry trailer, the checksum is verified when reading.
+     * @param key Entry key.
+     * @return True if a complete entry exists.
+     */
+    bool hasEntry(const std::string& key) const;
+
+    /**
+     * Acquire the writer lock of an entry.
+     * Only a single process can hold the writer lock of an entry at any time. Callers that
+     * want to avoid duplicate work (e.g. multiple processes importing the same scene) should
+     * acquire the lock, check hasEntry() and only produce the data if the entry is still missing.
+     * @param key Entry key.
+     * @param wait If true, block until the lock is released by other processes.
+     * @return Returns the held lock, or nullptr if the lock could not be acquired.
+     */
+    std::unique_ptr<LockFile> lockForWriting(const std::string& key, bool wait = true) const;
+
+    /**
+     * Write an entry.
+     * The data is written to a temporary file and moved into place once complete.
+     * Afterwards, least recently used entries are evicted to enforce the size budget.
+     * Throws if writing fails.
+     * @param key Entry key.
+     * @param func Function writing the payload to the given stream.
+     * @param pWriterLock Writer lock previously acquired with lockForWriting(). If nullptr, the
+     *                    lock is acquired in non-blocking mode and nothing is written if another
+     *                    process currently holds it.
+     * @return True if the entry was written.
+     */
+    bool write(const std::string& key, const WriteFunc& func, LockFile* pWriterLock = nullptr);
+
+    /**
+     * Read an entry.
+     * The checksum is verified after the read function returns. Corrupt entries are removed.
+     * Throws if the entry is corrupt or the read function throws.
+     * @param key Entry key.
+     * @param func Function reading the payload from the given stream.
+     * @return False if no entry exists for the given key.
+     */
+    bool read(const std::string& key, const ReadFunc& func);
+
+    /**
+     * Read the first bytes of an entry without verifying the checksum.
+     * This is useful for validating file headers without streaming the entire entry.
+     * @param key Entry key.
+     * @param data Destination buffer.
+     * @param size Number of bytes to read.
+     * @return True if successful.
+     */
+    bool peek(const std::string& key, void* data, size_t size) const;
+
+    /**
+     * Remove an entry and its lock file.
+     * Entries that are currently locked by other processes, or while another process evicts entries, are not removed.
+     * @param key Entry key.
+     * @return True if the entry was removed.
+     */
+    bool remove(const std::string& key);
+
+    /// Return the total size of all entries in bytes.
+    uint64_t getTotalSize() const;
+
+    /**
+     * Evict least recently used entries until the total size fits the size budget.
+     * Entries that are locked by other processes are skipped.
+     * @param keep Key of an entry that is never evicted (typically the entry just written).
+     */
+    void enforceSizeBudget(const std::string& keep = {});
+
+private:
+    /// Open and acquire the lock file of an entry while holding the eviction lock in shared mode.
+    std::unique_ptr<LockFile> lockEntry(const std::string& key, LockFile::LockType lockType, bool wait) const;
+    /// Remove an entry and its lock file. The caller must hold the eviction lock exclusively.
+    bool removeEntry(const std::string& key);
+    std::filesystem::path getLockPath(const std::string& key) const;
+    void touch(const std::filesystem::path& path) const;
+
+    std::filesystem::path mDirectory;
+    uint64_t mSizeBudget;
+};
+
+} // namespace Falcor
@@ -0,0 +1,90 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GpuReadbackRing.h"
+#include "Core/API/Fence.h"
+#include "Core/API/RenderContext.h"
+
+namespace Falcor
+{
+
+class GpuReadbackRing::FenceBackend : public ReadbackRing::Backend
+{
+public:
+    FenceBackend(ref<Device> pDevice, size_t slotSize, uint32_t slotCount) : mpDevice(pDevice)
+    {
+        mpFence = mpDevice->createFence();
+        mBuffers.resize(slotCount);
+        for (auto& pBuffer : mBuffers)
+            pBuffer = mpDevice->createBuffer(slotSize, ResourceBindFlags::None, MemoryType::ReadBack);
+    }
+
+    uint64_t signal() override
+    {
+        RenderContext* pRenderContext = mpDevice->getRenderContext();
+        pRenderContext->submit(false);
+        return pRenderContext->signal(mpFence.get());
+    }
+
+    uint64_t getCompletedValue() override { return mpFence->getCurrentValue(); }
+    void wait(uint64_t value) override { mpFence->wait(value); }
+    const void* map(uint32_t slot) override { return mBuffers[slot]->map(); }
+    void unmap(uint32_t slot) override { mBuffers[slot]->unmap(); }
+
+    ref<Device> mpDevice;
+    ref<Fence> mpFence;
+    std::vector<ref<Buffer>> mBuffers;
+};
+
+GpuReadbackRing::GpuReadbackRing(ref<Device> pDevice, size_t slotSize, uint32_t slotCount)
+    : ReadbackRing(std::make_unique<FenceBackend>(pDevice, slotSize, slotCount), slotSize, slotCount)
+{
+    mpFenceBackend = static_cast<FenceBackend*>(&getBackend());
+}
+
+const ref<Buffer>& GpuReadbackRing::getBuffer(uint32_t slot) const
+{
+    FALCOR_CHECK(slot < mpFenceBackend->mBuffers.size(), "Slot {} is out of range.", slot);
+    return mpFenceBackend->mBuffers[slot];
+}
+
+void GpuReadbackRing::readBuffer(
+    RenderContext* pRenderContext,
+    const Buffer* pSrc,
+    uint64_t srcOffset,
+    size_t size,
+    uint64_t tag,
+    Callback callback
+)
+{
+    FALCOR_CHECK(pSrc != nullptr, "Source buffer is null.");
+    const uint32_t slot = acquire();
+    pRenderContext->copyBufferRegion(getBuffer(slot).get(), 0, pSrc, srcOffset, size);
+    submit(slot, tag, size, std::move(callback));
+}
+
+} // namespace Falcor
@@ -0,0 +1,83 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "ReadbackRing.h"
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/Device.h"
+
+namespace Falcor
+{
+
+/**
+ * Readback ring using GPU readback buffers and a fence on the device render context.
+ *
+ * Usage:
+ * @code
+ * uint32_t slot = ring.acquire();
+ * // Record work writing to ring.getBuffer(slot), e.g., a copy or a parallel reduction.
+ * ring.submit(slot, frameIndex, size, [](uint64_t frameIndex, const void* pData, size_t size) { ... });
+ * ...
+ * ring.poll(); // Once per frame.
+ * @endcode
+ *
+ * Submitting a slot submits the command list of the render context.
+ */
+class FALCOR_API GpuReadbackRing : public ReadbackRing
+{
+public:
+    /**
+     * Constructor.
+     * @param pDevice GPU device.
+     * @param slotSize Size of each readback buffer in bytes.
+     * @param slotCount Number of readback buffers, i.e., the maximum number of readbacks in flight.
+     */
+    GpuReadbackRing(ref<Device> pDevice, size_t slotSize, uint32_t slotCount = kDefaultSlotCount);
+
+    /// Return the readback buffer of a slot.
+    const ref<Buffer>& getBuffer(uint32_t slot) const;
+
+    /**
+     * Copy a buffer region to a new slot and submit it.
+     * @param pRenderContext Render context used for the copy.
+     * @param pSrc Source buffer.
+     * @param srcOffset Offset in the source buffer in bytes.
+     * @param size Number of bytes to copy.
+     * @param tag User tag passed to the callback.
+     * @param callback Callback invoked once the data is available.
+     */
+    void readBuffer(RenderContext* pRenderContext, const Buffer* pSrc, uint64_t srcOffset, size_t size, uint64_t tag, Callback callback);
+
+private:
+    class FenceBackend;
+
+    FenceBackend* mpFenceBackend; ///< Backend owned by the base class.
+};
+
+} // namespace Falcor
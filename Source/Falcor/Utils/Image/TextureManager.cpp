@@ -28,6 +28,7 @@
 #include "TextureManager.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
 #include "Utils/Logger.h"
 #include "Utils/NumericRange.h"
 
@@ -153,6 +154,8 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
     if (loadedTextureCount)
         *loadedTextureCount = texturePaths.size();
 
+    const bool lazy = getLazyUdimOptions().enabled;
+
     std::vector<size_t> udimIndices;
     std::vector<CpuTextureHandle> handles;
     size_t maxIndex = 0;
@@ -167,12 +170,17 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
         size_t udim = std::stol(udimStr);
         maxIndex = std::max<size_t>(maxIndex, udim);
         udimIndices.push_back(udim);
-        // Do not pass on assetResolver as paths are already resolved, nor loadedTextureCount as we've already set it above.
-        handles.push_back(loadTexture(it, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags));
 
         FALCOR_CHECK(udim >= 1001, "Texture {} is not a valid UDIM texture, as it violates the valid UDIM range of 1001-9999", it);
+
+        // Do not pass on assetResolver as paths are already resolved, nor loadedTextureCount as we've already set it above.
+        if (!lazy)
+            handles.push_back(loadTexture(it, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags));
     }
 
+    if (lazy)
+        return registerLazyUdimTiles(texturePaths, udimIndices, maxIndex, generateMipLevels, loadAsSRGB, bindFlags, async, importFlags);
+
     // UDIM range needs to cover all numbers from 1001 to maxIndex inclusive, so 1001, 1002, 1003 needs 3 indices
     size_t rangeStart = getUdimRange(maxIndex - 1001 + 1);
 
@@ -185,6 +193,87 @@ TextureManager::CpuTextureHandle TextureManager::loadUdimTexture(
     return TextureManager::CpuTextureHandle(rangeStart, true);
 }
 
+TextureManager::CpuTextureHandle TextureManager::registerLazyUdimTiles(
+    const std::vector<std::filesystem::path>& texturePaths,
+    const std::vector<size_t>& udimIndices,
+    size_t maxIndex,
+    bool generateMipLevels,
+    bool loadAsSRGB,
+    ResourceBindFlags bindFlags,
+    bool async,
+    Bitmap::ImportFlags importFlags
+)
+{
+    const LazyUdimOptions options = getLazyUdimOptions();
+
+    LazyUdimSet set{
+        generateMipLevels, loadAsSRGB, bindFlags, importFlags, options.placeholderSize, {}, UdimTileResidency(options.memoryBudgetPerSet)};
+
+    // Resolve the tile paths. Tiles given as a <MIP> chain use their smallest mip file as placeholder,
+    // which is cheap enough to load right away. All other tiles are downsampled in the background below.
+    for (size_t i = 0; i < texturePaths.size(); ++i)
+    {
+        LazyUdimTile tile;
+        tile.paths = resolveTexturePaths(texturePaths[i], nullptr);
+        if (tile.paths.empty())
+        {
+            logWarning("Can't find UDIM tile '{}'.", texturePaths[i]);
+            continue;
+        }
+        if (tile.paths.size() > 1)
+            tile.pPlaceholder = Texture::createFromFile(mpDevice, tile.paths.back(), false, loadAsSRGB, bindFlags, importFlags);
+
+        set.tiles[(uint32_t)udimIndices[i]] = std::move(tile);
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    // UDIM range needs to cover all numbers from 1001 to maxIndex inclusive, so 1001, 1002, 1003 needs 3 indices
+    size_t rangeStart = getUdimRange(maxIndex - 1001 + 1);
+
+    // Register the tiles without loading them. Tiles without placeholder are reported as missing until loaded.
+    for (auto& [udimID, tile] : set.tiles)
+    {
+        tile.handle = addDesc({TextureState::Referenced, nullptr});
+        setUdimTileTexture(rangeStart, udimID, tile, TextureState::Referenced, tile.pPlaceholder);
+        set.residency.addTile(udimID);
+    }
+
+    // Issue loads of the tiles without placeholder. Each tile is loaded once to create its placeholder,
+    // the full resolution data is released again afterwards.
+    for (const auto& [udimID, tile] : set.tiles)
+    {
+        if (tile.pPlaceholder)
+            continue;
+
+        set.pendingPlaceholderCount++;
+        mLoadRequestsInProgress++;
+
+        // Function called by the async texture loader when loading finishes.
+        const uint32_t placeholderSize = set.placeholderSize;
+        auto callback = [this, rangeStart, udimID = udimID, placeholderSize](ref<Texture> pTexture)
+        { onUdimPlaceholderLoaded(rangeStart, udimID, placeholderSize, pTexture); };
+
+        mAsyncTextureLoader.loadFromFile(tile.paths[0], true /* generateMipLevels */, loadAsSRGB, bindFlags, importFlags, callback);
+    }
+
+    mLazyUdimSets[rangeStart] = std::move(set);
+
+#ifdef DISABLE_ASYNC_TEXTURE_LOADER
+    // See requestUdimTile().
+    async = false;
+#endif
+
+    if (!async)
+    {
+        mCondition.wait(lock, [&]() { return mLazyUdimSets.at(rangeStart).pendingPlaceholderCount == 0; });
+        lock.unlock();
+        mpDevice->wait();
+    }
+
+    return TextureManager::CpuTextureHandle(rangeStart, true);
+}
+
 TextureManager::CpuTextureHandle TextureManager::loadTexture(
     const std::filesystem::path& path,
     bool generateMipLevels,
@@ -208,46 +297,7 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
         return handle;
     }
 
-    std::vector<std::filesystem::path> paths;
-    auto addPath = [&](const std::filesystem::path& p)
-    {
-        // Find the full path to the texture.
-        std::filesystem::path fullPath;
-        bool found = false;
-        if (assetResolver)
-        {
-            fullPath = assetResolver->resolvePath(p);
-            found = !fullPath.empty();
-        }
-        else
-        {
-            fullPath = p;
-            found = std::filesystem::exists(fullPath);
-        }
-
-        if (found)
-            paths.emplace_back(std::move(fullPath));
-
-        return found;
-    };
-
-    // If we find <MIP> in the filename, locate all mip levels
-    std::string filename = path.filename().string();
-    auto mipPos = filename.find("<MIP>");
-    if (mipPos != std::string::npos)
-    {
-        while (true)
-        {
-            std::string basename = std::string(filename).replace(mipPos, 5, "mip" + std::to_string(paths.size()));
-            std::filesystem::path mip = path.parent_path() / basename;
-            if (!addPath(mip))
-                break;
-        }
-    }
-    else
-    {
-        addPath(path);
-    }
+    std::vector<std::filesystem::path> paths = resolveTexturePaths(path, assetResolver);
 
     if (loadedTextureCount)
         *loadedTextureCount = paths.empty() ? 0 : 1;
@@ -564,6 +614,11 @@ std::vector<uint32_t> TextureManager::getUdimIDs(const CpuTextureHandle& handle)
     std::lock_guard<std::mutex> lock(mMutex);
     size_t rangeStart = handle.getID();
     FALCOR_CHECK(rangeStart < mUdimIndirectionSize.size(), "Handle is out of range.");
+
+    // Tiles of lazily loaded UDIM textures are registered even if they are not resident.
+    if (auto it = mLazyUdimSets.find(rangeStart); it != mLazyUdimSets.end())
+        return it->second.residency.getUdimIDs();
+
     size_t rangeSize = mUdimIndirectionSize[rangeStart];
 
     std::vector<uint32_t> udimIDs;
@@ -578,6 +633,89 @@ std::vector<uint32_t> TextureManager::getUdimIDs(const CpuTextureHandle& handle)
     return udimIDs;
 }
 
+void TextureManager::setLazyUdimOptions(const LazyUdimOptions& options)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mLazyUdimOptions = options;
+}
+
+TextureManager::LazyUdimOptions TextureManager::getLazyUdimOptions() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mLazyUdimOptions;
+}
+
+TextureManager::CpuTextureHandle TextureManager::requestUdimTile(const CpuTextureHandle& handle, uint32_t udimID, bool async)
+{
+    FALCOR_CHECK(handle.isUdim(), "Texture handle does not refer to a UDIM texture.");
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    const size_t rangeStart = handle.getID();
+    auto setIt = mLazyUdimSets.find(rangeStart);
+    if (setIt == mLazyUdimSets.end())
+        return resolveUdimTexture(handle, udimID);
+
+    LazyUdimSet& set = setIt->second;
+    auto tileIt = set.tiles.find(udimID);
+    if (tileIt == set.tiles.end())
+        return CpuTextureHandle();
+
+    const LazyUdimTile& tile = tileIt->second;
+    if (set.residency.request(udimID))
+    {
+        mLoadRequestsInProgress++;
+
+        // Function called by the async texture loader when loading finishes.
+        auto callback = [this, rangeStart, udimID](ref<Texture> pTexture) { onUdimTileLoaded(rangeStart, udimID, pTexture); };
+
+        // Issue load request to texture loader.
+        if (tile.paths.size() > 1)
+        {
+            mAsyncTextureLoader.loadMippedFromFiles(tile.paths, set.loadAsSRGB, set.bindFlags, set.importFlags, callback);
+        }
+        else
+        {
+            mAsyncTextureLoader.loadFromFile(
+                tile.paths[0], set.generateMipLevels, set.loadAsSRGB, set.bindFlags, set.importFlags, callback
+            );
+        }
+    }
+
+#ifdef DISABLE_ASYNC_TEXTURE_LOADER
+    // The loader threads upload tiles while holding the global gfx mutex, which is only safe if the main thread
+    // doesn't submit GPU work at the same time. Block until the tile is loaded.
+    async = false;
+#endif
+
+    const CpuTextureHandle tileHandle = tile.handle;
+    if (!async)
+    {
+        mCondition.wait(
+            lock, [&]() { return mLazyUdimSets.at(rangeStart).residency.getTileState(udimID) != UdimTileResidency::TileState::Loading; }
+        );
+        lock.unlock();
+        mpDevice->wait();
+    }
+
+    return tileHandle;
+}
+
+uint64_t TextureManager::getUdimTileChangeCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mUdimTileChangeCount;
+}
+
+const UdimTileResidency* TextureManager::getUdimTileResidency(const CpuTextureHandle& handle) const
+{
+    if (!handle || !handle.isUdim())
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mLazyUdimSets.find(handle.getID());
+    return it != mLazyUdimSets.end() ? &it->second.residency : nullptr;
+}
+
 void TextureManager::bindShaderData(const ShaderVar& texturesVar, const size_t descCount, const ShaderVar& udimsVar) const
 {
     std::lock_guard<std::mutex> lock(mMutex);
@@ -734,6 +872,25 @@ void TextureManager::freeUdimRange(size_t rangeStart)
 void TextureManager::removeUdimTexture(const CpuTextureHandle& handle)
 {
     size_t rangeStart = handle.getID();
+
+    if (auto it = mLazyUdimSets.find(rangeStart); it != mLazyUdimSets.end())
+    {
+        // It is assumed that all tile loads have finished before we proceed to modify the data structures.
+        FALCOR_CHECK(it->second.pendingPlaceholderCount == 0, "UDIM placeholders are not yet loaded. Invalid operation.");
+        for (const auto& [udimID, tile] : it->second.tiles)
+        {
+            FALCOR_CHECK(
+                it->second.residency.getTileState(udimID) != UdimTileResidency::TileState::Loading,
+                "UDIM tile is not yet loaded. Invalid operation."
+            );
+            setUdimTileTexture(rangeStart, udimID, tile, TextureState::Invalid, nullptr);
+            mFreeList.push_back(tile.handle);
+        }
+        mLazyUdimSets.erase(it);
+        freeUdimRange(rangeStart);
+        return;
+    }
+
     size_t rangeSize = mUdimIndirectionSize[rangeStart];
     for (size_t i = rangeStart; i < rangeStart + rangeSize; ++i)
     {
@@ -747,6 +904,150 @@ void TextureManager::removeUdimTexture(const CpuTextureHandle& handle)
     freeUdimRange(rangeStart);
 }
 
+void TextureManager::onUdimTileLoaded(size_t rangeStart, uint32_t udimID, ref<Texture> pTexture)
+{
+    // This function is called by a worker thread of the async texture loader.
+    std::lock_guard<std::mutex> lock(mMutex);
+    LazyUdimSet& set = mLazyUdimSets.at(rangeStart);
+    const LazyUdimTile& tile = set.tiles.at(udimID);
+
+    // Mark tile as loaded. Failed tiles keep their placeholder.
+    uint64_t sizeInBytes = pTexture ? pTexture->getTextureSizeInBytes() : 0;
+    auto evicted = set.residency.finishLoading(udimID, sizeInBytes, pTexture != nullptr);
+    setUdimTileTexture(rangeStart, udimID, tile, TextureState::Loaded, pTexture ? pTexture : tile.pPlaceholder);
+
+    // Fall back to the placeholders of evicted tiles.
+    for (uint32_t evictedID : evicted)
+    {
+        const LazyUdimTile& evictedTile = set.tiles.at(evictedID);
+        setUdimTileTexture(rangeStart, evictedID, evictedTile, TextureState::Referenced, evictedTile.pPlaceholder);
+    }
+    if (!evicted.empty())
+        logDebug("Texture manager: Evicted {} UDIM tiles to fit the memory budget.", evicted.size());
+
+    mLoadRequestsInProgress--;
+    mCondition.notify_all();
+}
+
+void TextureManager::onUdimPlaceholderLoaded(size_t rangeStart, uint32_t udimID, uint32_t placeholderSize, ref<Texture> pTexture)
+{
+    // This function is called by a worker thread of the async texture loader.
+    // Create the placeholder before entering the critical section, as it issues GPU work.
+    ref<Texture> pPlaceholder = pTexture ? createUdimPlaceholder(pTexture, placeholderSize) : nullptr;
+    if (!pPlaceholder)
+        logWarning("Can't create placeholder for UDIM tile {}. The tile is reported as missing until loaded.", udimID);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    LazyUdimSet& set = mLazyUdimSets.at(rangeStart);
+    LazyUdimTile& tile = set.tiles.at(udimID);
+
+    // Bind the placeholder, unless the tile was requested and loaded in the meantime.
+    const TextureDesc desc = getDesc(tile.handle);
+    tile.pPlaceholder = pPlaceholder;
+    if (!desc.pTexture)
+        setUdimTileTexture(rangeStart, udimID, tile, desc.state, pPlaceholder);
+
+    set.pendingPlaceholderCount--;
+    mLoadRequestsInProgress--;
+    mCondition.notify_all();
+}
+
+ref<Texture> TextureManager::createUdimPlaceholder(const ref<Texture>& pTexture, uint32_t placeholderSize) const
+{
+    // Find the first mip level that fits the placeholder size. The placeholder is a copy of it and all lower mips.
+    uint32_t firstMip = 0;
+    while (firstMip < pTexture->getMipCount() && std::max(pTexture->getWidth(firstMip), pTexture->getHeight(firstMip)) > placeholderSize)
+        firstMip++;
+    if (firstMip == pTexture->getMipCount())
+        return nullptr;
+
+    uint32_t mipCount = pTexture->getMipCount() - firstMip;
+    ref<Texture> pPlaceholder = mpDevice->createTexture2D(
+        pTexture->getWidth(firstMip), pTexture->getHeight(firstMip), pTexture->getFormat(), 1, mipCount, nullptr, pTexture->getBindFlags()
+    );
+
+    // WARNING: Same hack as in the texture creation to allow copying from the texture loader threads.
+    std::lock_guard<std::mutex> lock(mpDevice->getGlobalGfxMutex());
+    RenderContext* pRenderContext = mpDevice->getRenderContext();
+    for (uint32_t mip = 0; mip < mipCount; ++mip)
+    {
+        pRenderContext->copySubresource(
+            pPlaceholder.get(), pPlaceholder->getSubresourceIndex(0, mip), pTexture.get(), pTexture->getSubresourceIndex(0, firstMip + mip)
+        );
+    }
+
+    return pPlaceholder;
+}
+
+void TextureManager::setUdimTileTexture(
+    size_t rangeStart,
+    uint32_t udimID,
+    const LazyUdimTile& tile,
+    TextureState state,
+    const ref<Texture>& pTexture
+)
+{
+    // Placeholders are not added to the texture-to-handle map, as they are never shared with other textures.
+    auto& desc = getDesc(tile.handle);
+    if (desc.pTexture && desc.pTexture != tile.pPlaceholder)
+        mTextureToHandle.erase(desc.pTexture.get());
+    if (pTexture && pTexture != tile.pPlaceholder)
+        mTextureToHandle[pTexture.get()] = tile.handle;
+    desc = {state, pTexture};
+
+    // Tiles without any texture are reported as missing to shaders.
+    mUdimIndirection[rangeStart + udimID - 1001] = pTexture ? (int32_t)tile.handle.getID() : -1;
+    mUdimIndirectionDirty = true;
+    mUdimTileChangeCount++;
+}
+
+std::vector<std::filesystem::path> TextureManager::resolveTexturePaths(const std::filesystem::path& path, const AssetResolver* assetResolver)
+    const
+{
+    std::vector<std::filesystem::path> paths;
+    auto addPath = [&](const std::filesystem::path& p)
+    {
+        // Find the full path to the texture.
+        std::filesystem::path fullPath;
+        bool found = false;
+        if (assetResolver)
+        {
+            fullPath = assetResolver->resolvePath(p);
+            found = !fullPath.empty();
+        }
+        else
+        {
+            fullPath = p;
+            found = std::filesystem::exists(fullPath);
+        }
+
+        if (found)
+            paths.emplace_back(std::move(fullPath));
+
+        return found;
+    };
+
+    // If we find <MIP> in the filename, locate all mip levels
+    std::string filename = path.filename().string();
+    auto mipPos = filename.find("<MIP>");
+    if (mipPos != std::string::npos)
+    {
+        while (true)
+        {
+            std::string basename = std::string(filename).replace(mipPos, 5, "mip" + std::to_string(paths.size()));
+            std::filesystem::path mip = path.parent_path() / basename;
+            if (!addPath(mip))
+                break;
+        }
+    }
+    else
+    {
+        addPath(path);
+    }
+
+    return paths;
+}
+
 TextureManager::CpuTextureHandle TextureManager::resolveUdimTexture(const CpuTextureHandle& handle, const float2& uv) const
 {
     if (!handle.isUdim())
@@ -771,6 +1072,13 @@ TextureManager::CpuTextureHandle TextureManager::resolveUdimTexture(const CpuTex
     size_t udim = udimID - 1001;
     FALCOR_CHECK(udim < mUdimIndirectionSize[rangeStart], "UDIM ID ({}) is out of range.", udimID);
 
+    // Tiles of lazily loaded UDIM textures have a handle even if nothing is bound for them yet.
+    if (auto it = mLazyUdimSets.find(rangeStart); it != mLazyUdimSets.end())
+    {
+        auto tileIt = it->second.tiles.find(udimID);
+        return tileIt != it->second.tiles.end() ? tileIt->second.handle : CpuTextureHandle();
+    }
+
     if (mUdimIndirection[rangeStart + udim] >= 0)
         return CpuTextureHandle(mUdimIndirection[rangeStart + udim]);
     return CpuTextureHandle();
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "AsyncTextureLoader.h"
+#include "UdimTileResidency.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
@@ -62,7 +63,7 @@ public:
     enum class TextureState
     {
         Invalid,    ///< Invalid/unknown texture.
-        Referenced, ///< Texture is referenced, but not yet loaded.
+        Referenced, ///< Texture is referenced, but not yet loaded. Lazily loaded UDIM tiles may hold a low-resolution placeholder.
         Loaded,     ///< Texture has finished loading.
     };
 
@@ -75,6 +76,21 @@ public:
         uint64_t textureMemoryInBytes = 0;     ///< Total memory in bytes used by the textures.
     };
 
+    /**
+     * Options for lazy loading of UDIM texture sets.
+     * When enabled, loading a UDIM texture only registers the tiles. The pixel data of a tile is loaded
+     * when the tile is first requested with requestUdimTile(). Until then, a low-resolution placeholder is
+     * bound instead. The placeholder is the smallest mip file of the tile if the set is given as a <MIP> chain.
+     * Otherwise it is a downsampled copy of the tile, created in the background when the set is loaded.
+     * Tiles without a placeholder are reported as missing to shaders, which fall back to the uniform material value.
+     */
+    struct LazyUdimOptions
+    {
+        bool enabled = false;                                        ///< Enable lazy loading of UDIM tiles.
+        uint64_t memoryBudgetPerSet = UdimTileResidency::kUnlimited; ///< Maximum memory in bytes of resident tiles per UDIM set.
+        uint32_t placeholderSize = 32; ///< Maximum width/height of placeholders created by downsampling tiles.
+    };
+
     /**
      * Handle to a managed texture on the CPU side.
      */
@@ -183,6 +199,41 @@ public:
         const Object* owner = nullptr
     );
 
+    /**
+     * Set the options for lazy loading of UDIM texture sets.
+     * The options only affect UDIM textures loaded afterwards.
+     * @param[in] options Lazy UDIM loading options.
+     */
+    void setLazyUdimOptions(const LazyUdimOptions& options);
+    LazyUdimOptions getLazyUdimOptions() const;
+
+    /**
+     * Request residency of a tile of a UDIM texture.
+     * If the texture was loaded lazily and the tile is not resident, loading of the tile is issued.
+     * The tile is marked as most recently used, which may evict other tiles of the set once loading finishes.
+     * For UDIM textures that were loaded eagerly this is equivalent to resolving the tile.
+     * @param[in] handle Handle to a UDIM texture.
+     * @param[in] udimID UDIM ID of the tile.
+     * @param[in] async Load asynchronously, otherwise the function blocks until the tile is loaded.
+     * @return Handle to the tile texture, or an invalid handle if the tile doesn't exist.
+     * Call bindShaderData() afterwards to make residency changes visible to shaders.
+     */
+    CpuTextureHandle requestUdimTile(const CpuTextureHandle& handle, uint32_t udimID, bool async = true);
+
+    /**
+     * Get the number of changes to the textures bound to lazily loaded UDIM tiles.
+     * Tiles change when they finish loading or are evicted, which happens asynchronously. Compare against
+     * a previously returned value to find out if bindShaderData() needs to be called again.
+     */
+    uint64_t getUdimTileChangeCount() const;
+
+    /**
+     * Get the residency state of the tiles of a lazily loaded UDIM texture.
+     * @param[in] handle Handle to a UDIM texture.
+     * @return Residency state, or nullptr if the texture was not loaded lazily. Access must not overlap with pending tile loads.
+     */
+    const UdimTileResidency* getUdimTileResidency(const CpuTextureHandle& handle) const;
+
     /**
      * Wait for a requested texture to load.
      * If the handle is valid, the call blocks until the texture is loaded (or failed to load).
@@ -287,6 +338,20 @@ private:
     void removeNonUdimTexture(const CpuTextureHandle& handle);
     CpuTextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const float2& uv) const;
     CpuTextureHandle resolveUdimTexture(const CpuTextureHandle& handle, const uint32_t udimID) const;
+    std::vector<std::filesystem::path> resolveTexturePaths(const std::filesystem::path& path, const AssetResolver* assetResolver) const;
+    CpuTextureHandle registerLazyUdimTiles(
+        const std::vector<std::filesystem::path>& texturePaths,
+        const std::vector<size_t>& udimIndices,
+        size_t maxIndex,
+        bool generateMipLevels,
+        bool loadAsSRGB,
+        ResourceBindFlags bindFlags,
+        bool async,
+        Bitmap::ImportFlags importFlags
+    );
+    void onUdimTileLoaded(size_t rangeStart, uint32_t udimID, ref<Texture> pTexture);
+    void onUdimPlaceholderLoaded(size_t rangeStart, uint32_t udimID, uint32_t placeholderSize, ref<Texture> pTexture);
+    ref<Texture> createUdimPlaceholder(const ref<Texture>& pTexture, uint32_t placeholderSize) const;
 
     /**
      * Same as loadTexture, but explicitly handles Udim textures. If the texture isn't Udim, it falls back to loadTexture.
@@ -339,6 +404,29 @@ private:
         }
     };
 
+    /// Tile of a lazily loaded UDIM texture.
+    struct LazyUdimTile
+    {
+        std::vector<std::filesystem::path> paths; ///< Full paths of the tile, or of all its mips.
+        CpuTextureHandle handle;                  ///< Handle of the tile texture.
+        ref<Texture> pPlaceholder;                ///< Low-resolution placeholder bound while the tile is not resident.
+    };
+
+    /// Lazily loaded UDIM texture.
+    struct LazyUdimSet
+    {
+        bool generateMipLevels;
+        bool loadAsSRGB;
+        ResourceBindFlags bindFlags;
+        Bitmap::ImportFlags importFlags;
+        uint32_t placeholderSize;
+        std::map<uint32_t, LazyUdimTile> tiles; ///< Tiles indexed by UDIM ID.
+        UdimTileResidency residency;
+        uint32_t pendingPlaceholderCount = 0; ///< Number of tiles that are being loaded to create their placeholder.
+    };
+
+    void setUdimTileTexture(size_t rangeStart, uint32_t udimID, const LazyUdimTile& tile, TextureState state, const ref<Texture>& pTexture);
+
     CpuTextureHandle addDesc(const TextureDesc& desc);
     TextureDesc& getDesc(const CpuTextureHandle& handle);
     void registerOwner(const CpuTextureHandle& handle, const Object* owner);
@@ -360,6 +448,11 @@ private:
     /// Free ranges in the udimIndirection, when a UDIM texture is deleted (contains first position)
     std::vector<size_t> mFreeUdimRanges;
 
+    /// Lazily loaded UDIM textures, indexed by the start of their UDIM indirection range.
+    std::map<size_t, LazyUdimSet> mLazyUdimSets;
+    LazyUdimOptions mLazyUdimOptions;
+    uint64_t mUdimTileChangeCount = 0; ///< Number of changes to the textures bound to lazily loaded UDIM tiles.
+
     mutable bool mUdimIndirectionDirty = true;
     mutable ref<Buffer> mpUdimIndirection;
 
@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "UdimTileResidency.h"
+#include "Core/Error.h"
+#include <algorithm>
+
+namespace Falcor
+{
+namespace
+{
+constexpr uint32_t kNoTile = 0;
+}
+
+UdimTileResidency::UdimTileResidency(uint64_t memoryBudget) : mMemoryBudget(memoryBudget) {}
+
+void UdimTileResidency::addTile(uint32_t udimID)
+{
+    FALCOR_CHECK(udimID >= 1001 && udimID <= 9999, "Illegal UDIM ID ({}).", udimID);
+    FALCOR_CHECK(!hasTile(udimID), "UDIM tile {} is already registered.", udimID);
+    mTiles[udimID] = Tile{};
+}
+
+std::vector<uint32_t> UdimTileResidency::getUdimIDs() const
+{
+    std::vector<uint32_t> udimIDs;
+    udimIDs.reserve(mTiles.size());
+    for (const auto& [udimID, tile] : mTiles)
+        udimIDs.push_back(udimID);
+    return udimIDs;
+}
+
+bool UdimTileResidency::request(uint32_t udimID)
+{
+    Tile& tile = getTile(udimID);
+    tile.lastUse = ++mUseCounter;
+    if (tile.state != TileState::NonResident)
+        return false;
+    tile.state = TileState::Loading;
+    return true;
+}
+
+std::vector<uint32_t> UdimTileResidency::finishLoading(uint32_t udimID, uint64_t sizeInBytes, bool success)
+{
+    Tile& tile = getTile(udimID);
+    FALCOR_CHECK(tile.state == TileState::Loading, "UDIM tile {} is not loading.", udimID);
+
+    if (!success)
+    {
+        tile.state = TileState::Failed;
+        return {};
+    }
+
+    tile.state = TileState::Resident;
+    tile.sizeInBytes = sizeInBytes;
+    mResidentSize += sizeInBytes;
+    return enforceMemoryBudget(udimID);
+}
+
+bool UdimTileResidency::evict(uint32_t udimID)
+{
+    Tile& tile = getTile(udimID);
+    if (tile.state != TileState::Resident)
+        return false;
+
+    FALCOR_ASSERT(mResidentSize >= tile.sizeInBytes);
+    mResidentSize -= tile.sizeInBytes;
+    tile.state = TileState::NonResident;
+    tile.sizeInBytes = 0;
+    return true;
+}
+
+std::vector<uint32_t> UdimTileResidency::setMemoryBudget(uint64_t memoryBudget)
+{
+    mMemoryBudget = memoryBudget;
+    return enforceMemoryBudget(kNoTile);
+}
+
+size_t UdimTileResidency::getResidentCount() const
+{
+    return std::count_if(mTiles.begin(), mTiles.end(), [](const auto& it) { return it.second.state == TileState::Resident; });
+}
+
+const UdimTileResidency::Tile& UdimTileResidency::getTile(uint32_t udimID) const
+{
+    auto it = mTiles.find(udimID);
+    FALCOR_CHECK(it != mTiles.end(), "UDIM tile {} is not registered.", udimID);
+    return it->second;
+}
+
+UdimTileResidency::Tile& UdimTileResidency::getTile(uint32_t udimID)
+{
+    auto it = mTiles.find(udimID);
+    FALCOR_CHECK(it != mTiles.end(), "UDIM tile {} is not registered.", udimID);
+    return it->second;
+}
+
+std::vector<uint32_t> UdimTileResidency::enforceMemoryBudget(uint32_t keepID)
+{
+    if (mMemoryBudget == kUnlimited || mResidentSize <= mMemoryBudget)
+        return {};
+
+    // Collect eviction candidates, least recently used first.
+    std::vector<std::pair<uint64_t, uint32_t>> candidates;
+    for (const auto& [udimID, tile] : mTiles)
+    {
+        if (tile.state == TileState::Resident && udimID != keepID)
+            candidates.emplace_back(tile.lastUse, udimID);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<uint32_t> evicted;
+    for (const auto& [lastUse, udimID] : candidates)
+    {
+        if (mResidentSize <= mMemoryBudget)
+            break;
+        evict(udimID);
+        evicted.push_back(udimID);
+    }
+    return evicted;
+}
+} // namespace Falcor
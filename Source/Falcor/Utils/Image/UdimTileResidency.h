@@ -0,0 +1,142 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Residency bookkeeping for the tiles of a lazily loaded UDIM texture set.
+ *
+ * Tiles are registered upfront without any pixel data. A tile is loaded when it is first
+ * requested and stays resident until it is evicted to keep the total size of the resident
+ * tiles within the memory budget. Eviction picks the least recently requested tiles first.
+ *
+ * This class only tracks state, the actual loading is done by the caller (see TextureManager).
+ * It is not thread-safe, callers need to synchronize access.
+ */
+class FALCOR_API UdimTileResidency
+{
+public:
+    /// Residency state of a tile.
+    enum class TileState
+    {
+        NonResident, ///< Tile data is not loaded.
+        Loading,     ///< Tile data is being loaded.
+        Resident,    ///< Tile data is loaded.
+        Failed,      ///< Tile data failed to load. The tile is not requested again.
+    };
+
+    /// Memory budget that disables eviction.
+    static constexpr uint64_t kUnlimited = 0;
+
+    /**
+     * Constructor.
+     * @param[in] memoryBudget Maximum total size of all resident tiles in bytes (kUnlimited to disable eviction).
+     */
+    explicit UdimTileResidency(uint64_t memoryBudget = kUnlimited);
+
+    /**
+     * Register a tile. The tile is initially non-resident.
+     * @param[in] udimID UDIM ID of the tile (1001-9999).
+     */
+    void addTile(uint32_t udimID);
+
+    bool hasTile(uint32_t udimID) const { return mTiles.find(udimID) != mTiles.end(); }
+    size_t getTileCount() const { return mTiles.size(); }
+
+    /// Return the UDIM IDs of all registered tiles in increasing order.
+    std::vector<uint32_t> getUdimIDs() const;
+
+    TileState getTileState(uint32_t udimID) const { return getTile(udimID).state; }
+
+    /// Return the size of a resident tile in bytes, or 0 if the tile is not resident.
+    uint64_t getTileSize(uint32_t udimID) const { return getTile(udimID).sizeInBytes; }
+
+    /**
+     * Request a tile and mark it as the most recently used tile.
+     * @param[in] udimID UDIM ID of the tile.
+     * @return True if the tile was non-resident and the caller should start loading it. The tile is then in the 'Loading' state.
+     */
+    bool request(uint32_t udimID);
+
+    /**
+     * Report that loading of a tile has finished.
+     * On success, least recently used tiles are evicted until the resident tiles fit the memory budget.
+     * The tile that just finished loading is never evicted, even if it exceeds the budget on its own.
+     * @param[in] udimID UDIM ID of the tile.
+     * @param[in] sizeInBytes Size of the tile data in bytes.
+     * @param[in] success False if loading failed.
+     * @return UDIM IDs of the evicted tiles, least recently used first.
+     */
+    std::vector<uint32_t> finishLoading(uint32_t udimID, uint64_t sizeInBytes, bool success);
+
+    /**
+     * Evict a tile.
+     * @param[in] udimID UDIM ID of the tile.
+     * @return True if the tile was resident.
+     */
+    bool evict(uint32_t udimID);
+
+    uint64_t getMemoryBudget() const { return mMemoryBudget; }
+
+    /**
+     * Set the memory budget and evict tiles to fit it.
+     * @param[in] memoryBudget Maximum total size of all resident tiles in bytes (kUnlimited to disable eviction).
+     * @return UDIM IDs of the evicted tiles, least recently used first.
+     */
+    std::vector<uint32_t> setMemoryBudget(uint64_t memoryBudget);
+
+    /// Return the total size of all resident tiles in bytes.
+    uint64_t getResidentSize() const { return mResidentSize; }
+
+    /// Return the number of resident tiles.
+    size_t getResidentCount() const;
+
+private:
+    struct Tile
+    {
+        TileState state = TileState::NonResident;
+        uint64_t sizeInBytes = 0;
+        uint64_t lastUse = 0; ///< Value of the use counter when the tile was last requested.
+    };
+
+    const Tile& getTile(uint32_t udimID) const;
+    Tile& getTile(uint32_t udimID);
+    std::vector<uint32_t> enforceMemoryBudget(uint32_t keepID);
+
+    std::map<uint32_t, Tile> mTiles;
+    uint64_t mMemoryBudget;
+    uint64_t mResidentSize = 0;
+    uint64_t mUseCounter = 0;
+};
+} // namespace Falcor
@@ -0,0 +1,152 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ReadbackRing.h"
+#include "Core/Error.h"
+
+namespace Falcor
+{
+
+ReadbackRing::ReadbackRing(std::unique_ptr<Backend> pBackend, size_t slotSize, uint32_t slotCount)
+    : mpBackend(std::move(pBackend)), mSlotSize(slotSize)
+{
+    FALCOR_CHECK(mpBackend != nullptr, "Readback ring requires a backend.");
+    FALCOR_CHECK(slotSize > 0, "Slot size must be non-zero.");
+    FALCOR_CHECK(slotCount > 0, "Slot count must be non-zero.");
+    mSlots.resize(slotCount);
+}
+
+ReadbackRing::~ReadbackRing()
+{
+    // Pending callbacks may reference objects that are being destroyed, so they are dropped.
+    discard();
+}
+
+uint32_t ReadbackRing::acquire()
+{
+    FALCOR_CHECK(mSlots[mNextSlot].state != SlotState::Acquired, "Previously acquired slot has not been submitted.");
+
+    poll();
+
+    // All slots are in flight. Wait for the oldest one.
+    if (mInFlight.size() == mSlots.size())
+    {
+        const uint32_t slot = mInFlight.front();
+        mpBackend->wait(mSlots[slot].fenceValue);
+        mStats.stalls++;
+        complete(slot);
+    }
+
+    // Slots are used round-robin and complete in order, so the next slot is the least recently used one.
+    const uint32_t slot = mNextSlot;
+    FALCOR_ASSERT(mSlots[slot].state == SlotState::Free);
+    mSlots[slot].state = SlotState::Acquired;
+    return slot;
+}
+
+void ReadbackRing::submit(uint32_t slot, uint64_t tag, size_t size, Callback callback)
+{
+    FALCOR_CHECK(slot < mSlots.size() && mSlots[slot].state == SlotState::Acquired, "Slot {} has not been acquired.", slot);
+    FALCOR_CHECK(size <= mSlotSize, "Readback size ({} bytes) exceeds slot size ({} bytes).", size, mSlotSize);
+
+    Slot& s = mSlots[slot];
+    s.state = SlotState::InFlight;
+    s.fenceValue = mpBackend->signal();
+    s.tag = tag;
+    s.size = size;
+    s.callback = std::move(callback);
+
+    mInFlight.push_back(slot);
+    mNextSlot = (mNextSlot + 1) % (uint32_t)mSlots.size();
+    mStats.submitted++;
+}
+
+uint32_t ReadbackRing::poll()
+{
+    if (mInFlight.empty())
+        return 0;
+
+    uint32_t count = 0;
+    const uint64_t completedValue = mpBackend->getCompletedValue();
+    while (!mInFlight.empty() && mSlots[mInFlight.front()].fenceValue <= completedValue)
+    {
+        complete(mInFlight.front());
+        count++;
+    }
+    return count;
+}
+
+uint32_t ReadbackRing::flush()
+{
+    if (mInFlight.empty())
+        return 0;
+
+    mpBackend->wait(mSlots[mInFlight.back()].fenceValue);
+    uint32_t count = 0;
+    while (!mInFlight.empty())
+    {
+        complete(mInFlight.front());
+        count++;
+    }
+    return count;
+}
+
+void ReadbackRing::discard()
+{
+    for (uint32_t slot : mInFlight)
+    {
+        mSlots[slot] = Slot();
+        mStats.discarded++;
+    }
+    mInFlight.clear();
+}
+
+void ReadbackRing::complete(uint32_t slot)
+{
+    FALCOR_ASSERT(!mInFlight.empty() && mInFlight.front() == slot);
+    mInFlight.pop_front();
+
+    // Release the slot before invoking the callback so that exceptions leave the ring in a valid state.
+    Slot s = std::move(mSlots[slot]);
+    mSlots[slot] = Slot();
+    mStats.completed++;
+
+    const void* pData = mpBackend->map(slot);
+    try
+    {
+        if (s.callback)
+            s.callback(s.tag, pData, s.size);
+    }
+    catch (...)
+    {
+        mpBackend->unmap(slot);
+        throw;
+    }
+    mpBackend->unmap(slot);
+}
+
+} // namespace Falcor
@@ -0,0 +1,180 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "Core/Macros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Ring of staging slots for reading back GPU results with N frames of latency.
+ *
+ * Instead of waiting on a fence right after submitting a readback, results are written to one
+ * of several staging slots. Each submitted slot is tagged (typically with a frame index) and
+ * associated with a fence value. Calling poll() once per frame dispatches the callbacks of
+ * all slots whose fence values have been reached, in submission order, without blocking.
+ *
+ * The host only stalls if all slots are in flight when a new slot is acquired. In that case
+ * the oldest slot is waited on and its callback is dispatched first. Stalls are counted in
+ * the ring statistics, which is a hint that more slots are needed.
+ *
+ * The ring itself only deals with bookkeeping. Fences, submission and mapping of the staging
+ * memory are provided by a backend, which allows the core logic to be tested on the CPU.
+ * See GpuReadbackRing for the implementation using GPU readback buffers.
+ */
+class FALCOR_API ReadbackRing
+{
+public:
+    /**
+     * Callback invoked once the data of a slot is available on the host.
+     * The data pointer is only valid for the duration of the call.
+     * Callbacks must not acquire or submit slots of the ring invoking them.
+     */
+    using Callback = std::function<void(uint64_t tag, const void* pData, size_t size)>;
+
+    /// Interface to the queue, fence and staging memory used by the ring.
+    class Backend
+    {
+    public:
+        virtual ~Backend() = default;
+
+        /// Submit all recorded work and signal the fence. Returns the signaled fence value.
+        virtual uint64_t signal() = 0;
+        /// Return the last fence value reached by the queue.
+        virtual uint64_t getCompletedValue() = 0;
+        /// Block until the fence has reached the given value.
+        virtual void wait(uint64_t value) = 0;
+        /// Map the staging memory of a slot for reading.
+        virtual const void* map(uint32_t slot) = 0;
+        /// Unmap the staging memory of a slot.
+        virtual void unmap(uint32_t slot) = 0;
+    };
+
+    struct Stats
+    {
+        uint64_t submitted = 0; ///< Number of submitted slots.
+        uint64_t completed = 0; ///< Number of slots whose callbacks have been dispatched.
+        uint64_t discarded = 0; ///< Number of slots dropped by discard().
+        uint64_t stalls = 0;    ///< Number of times acquire() had to wait for the GPU.
+    };
+
+    static constexpr uint32_t kDefaultSlotCount = 3;
+
+    /**
+     * Constructor.
+     * @param pBackend Backend providing fences and staging memory for each slot.
+     * @param slotSize Size of the staging memory of each slot in bytes.
+     * @param slotCount Number of slots, i.e., the maximum number of readbacks in flight.
+     */
+    ReadbackRing(std::unique_ptr<Backend> pBackend, size_t slotSize, uint32_t slotCount = kDefaultSlotCount);
+    virtual ~ReadbackRing();
+
+    ReadbackRing(const ReadbackRing&) = delete;
+    ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+    size_t getSlotSize() const { return mSlotSize; }
+    uint32_t getSlotCount() const { return (uint32_t)mSlots.size(); }
+
+    /// Return the number of submitted slots whose callbacks have not been dispatched yet.
+    uint32_t getPendingCount() const { return (uint32_t)mInFlight.size(); }
+
+    const Stats& getStats() const { return mStats; }
+
+    /**
+     * Acquire a free slot for recording a readback.
+     * If all slots are in flight, this waits for the oldest one and dispatches its callback.
+     * The acquired slot must be passed to submit() before acquiring another one.
+     * @return Slot index.
+     */
+    uint32_t acquire();
+
+    /**
+     * Submit a previously acquired slot.
+     * This signals the backend fence after the work recorded for the slot.
+     * @param slot Slot index returned by acquire().
+     * @param tag User tag passed to the callback, e.g., the frame index.
+     * @param size Number of valid bytes in the slot.
+     * @param callback Callback invoked once the data is available.
+     */
+    void submit(uint32_t slot, uint64_t tag, size_t size, Callback callback);
+
+    /**
+     * Dispatch the callbacks of all slots whose data is available, in submission order.
+     * This call never blocks.
+     * @return Number of dispatched callbacks.
+     */
+    uint32_t poll();
+
+    /**
+     * Wait for all submitted slots and dispatch their callbacks.
+     * @return Number of dispatched callbacks.
+     */
+    uint32_t flush();
+
+    /// Drop all submitted slots without dispatching their callbacks.
+    void discard();
+
+protected:
+    Backend& getBackend() { return *mpBackend; }
+
+private:
+    enum class SlotState
+    {
+        Free,
+        Acquired,
+        InFlight,
+    };
+
+    struct Slot
+    {
+        SlotState state = SlotState::Free;
+        uint64_t fenceValue = 0;
+        uint64_t tag = 0;
+        size_t size = 0;
+        Callback callback;
+    };
+
+    void complete(uint32_t slot);
+
+    std::unique_ptr<Backend> mpBackend;
+    size_t mSlotSize;
+    std::vector<Slot> mSlots;
+    std::deque<uint32_t> mInFlight; ///< In-flight slots in submission order.
+    uint32_t mNextSlot = 0;         ///< Next slot to hand out, slots are used round-robin.
+    Stats mStats;
+};
+
+} // namespace Falcor
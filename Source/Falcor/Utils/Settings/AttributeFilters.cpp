@@ -27,23 +27,175 @@
  **************************************************************************/
 #include "AttributeFilters.h"
 
+#include <cctype>
 #include <set>
 
 namespace Falcor
 {
 namespace settings
 {
-Attributes AttributeFilter::getAttributes(std::string_view shapeName) const
+namespace
 {
-    Attributes result;
-    for (const Record& recordIt : mAttributes)
+/// Upper bound on the number of memoized shape names, to keep memory bounded on huge scenes.
+constexpr size_t kMaxCachedShapeNames = 1 << 20;
+
+/// Parses a regex that matches a single literal string, resolving escaped punctuation.
+/// Returns false if the regex contains any unescaped special character or a line terminator.
+bool parseLiteralRegex(std::string_view regexStr, std::string& literal)
+{
+    literal.clear();
+    for (size_t i = 0; i < regexStr.size(); ++i)
     {
-        if (!std::regex_match(shapeName.begin(), shapeName.end(), recordIt.regex))
+        char c = regexStr[i];
+        if (c == '\\')
+        {
+            // Only escaped punctuation is literal, escapes such as \d or \b are character classes or assertions.
+            if (i + 1 == regexStr.size() || std::isalnum(static_cast<unsigned char>(regexStr[i + 1])))
+                return false;
+            c = regexStr[++i];
+            if (c == '\n' || c == '\r')
+                return false;
+            literal.push_back(c);
             continue;
+        }
+        if (std::string_view(".[]{}()*+?^$|\n\r").find(c) != std::string_view::npos)
+            return false;
+        literal.push_back(c);
+    }
+    return true;
+}
+
+/// ECMAScript `.` does not match line terminators, so `.*` only matches spans without them.
+bool isWildcardSpan(std::string_view span)
+{
+    return span.find_first_of("\n\r") == std::string_view::npos;
+}
+
+bool startsWith(std::string_view str, std::string_view prefix)
+{
+    return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool endsWith(std::string_view str, std::string_view suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+} // namespace
+
+AttributeFilter::Matcher::Matcher(const std::string& regexStr)
+{
+    std::string_view str(regexStr);
+    const std::string_view wildcard(".*");
+
+    if (str == wildcard)
+    {
+        mKind = Kind::Any;
+        return;
+    }
+
+    bool leading = startsWith(str, wildcard);
+    bool trailing = endsWith(str, wildcard) && !endsWith(str, "\\.*");
+    if (leading)
+        str.remove_prefix(wildcard.size());
+    if (trailing)
+        str.remove_suffix(wildcard.size());
+
+    if (parseLiteralRegex(str, mLiteral))
+    {
+        if (leading && trailing)
+            mKind = Kind::Contains;
+        else if (leading)
+            mKind = Kind::Suffix;
+        else if (trailing)
+            mKind = Kind::Prefix;
+        else
+            mKind = Kind::Literal;
+        return;
+    }
+
+    // Every match has to start with the literal characters preceding the first special character,
+    // which rejects most names without running the regex.
+    mKind = Kind::Regex;
+    mLiteral.clear();
+    if (regexStr.find('|') == std::string::npos)
+    {
+        for (char c : regexStr)
+        {
+            if (std::string_view("\\.[]{}()*+?^$").find(c) != std::string_view::npos)
+            {
+                // The last character is optional if followed by a quantifier.
+                if ((c == '*' || c == '?' || c == '{') && !mLiteral.empty())
+                    mLiteral.pop_back();
+                break;
+            }
+            mLiteral.push_back(c);
+        }
+    }
+    mRegex = std::regex(regexStr, std::regex::ECMAScript | std::regex::optimize);
+}
+
+bool AttributeFilter::Matcher::match(std::string_view shapeName) const
+{
+    switch (mKind)
+    {
+    case Kind::Any:
+        return isWildcardSpan(shapeName);
+    case Kind::Literal:
+        return shapeName == mLiteral;
+    case Kind::Prefix:
+        return startsWith(shapeName, mLiteral) && isWildcardSpan(shapeName.substr(mLiteral.size()));
+    case Kind::Suffix:
+        return endsWith(shapeName, mLiteral) && isWildcardSpan(shapeName.substr(0, shapeName.size() - mLiteral.size()));
+    case Kind::Contains:
+    {
+        // Line terminators cannot be part of the literal, so any occurrence splits the name into wildcard spans.
+        if (!isWildcardSpan(shapeName))
+            return false;
+        return shapeName.find(mLiteral) != std::string_view::npos;
+    }
+    case Kind::Regex:
+        return startsWith(shapeName, mLiteral) && std::regex_match(shapeName.begin(), shapeName.end(), mRegex);
+    }
+    FALCOR_UNREACHABLE();
+}
+
+std::vector<uint32_t> AttributeFilter::getMatchingRecords(std::string_view shapeName) const
+{
+    std::lock_guard<std::mutex> lock(mMatchCache.mutex);
+
+    std::string key(shapeName);
+    auto it = mMatchCache.matches.find(key);
+    if (it != mMatchCache.matches.end())
+        return it->second;
 
-        result.addDict(recordIt.attributes);
+    if (mMatchCache.matches.size() >= kMaxCachedShapeNames)
+        mMatchCache.matches.clear();
+
+    std::vector<uint32_t> matches;
+    for (uint32_t i = 0; i < mAttributes.size(); ++i)
+    {
+        if (mAttributes[i].matcher.match(shapeName))
+            matches.push_back(i);
     }
 
+    mMatchCache.matches.emplace(std::move(key), matches);
+    return matches;
+}
+
+Attributes AttributeFilter::getAttributes(std::string_view shapeName) const
+{
+    Attributes result;
+    forEachMatchingRecord(shapeName, [&](const Record& recordIt) { result.addDict(recordIt.attributes); });
+
+    return result;
+}
+
+std::vector<Attributes> AttributeFilter::getAttributes(const std::vector<std::string>& shapeNames) const
+{
+    std::vector<Attributes> result;
+    result.reserve(shapeNames.size());
+    for (const std::string& shapeName : shapeNames)
+        result.push_back(getAttributes(shapeName));
     return result;
 }
 
@@ -86,7 +238,7 @@ void AttributeFilter::addDictionary(const nlohmann::json& dict)
     std::string regexStr = ".*";
     if (regexIt != dict.end())
         regexStr = regexIt.value().get<std::string>();
-    record.regex = std::regex(regexStr);
+    record.matcher = Matcher(regexStr);
 
     nlohmann::json allFlattened;
     if (attrIt != dict.end())
@@ -148,7 +300,7 @@ nlohmann::json AttributeFilter::processDeprecatedFilters(std::string_view name,
             {
                 Record filteredRecord;
                 filteredRecord.name = fmt::format("{}_{}", name, filterKey);
-                filteredRecord.regex = std::regex(filterRegexStr);
+                filteredRecord.matcher = Matcher(filterRegexStr);
                 filteredRecord.attributes = nlohmann::json::object();
                 filteredRecord.attributes[attrIT.key()] = attrIT.value();
                 mAttributes.push_back(std::move(filteredRecord));
@@ -157,13 +309,13 @@ nlohmann::json AttributeFilter::processDeprecatedFilters(std::string_view name,
             {
                 Record filteredRecord;
                 filteredRecord.name = fmt::format("{}_{}_apply", name, filterKey);
-                filteredRecord.regex = std::regex(".*");
+                filteredRecord.matcher = Matcher(".*");
                 filteredRecord.attributes = nlohmann::json::object();
                 filteredRecord.attributes[attrIT.key()] = attrIT.value();
                 mAttributes.push_back(std::move(filteredRecord));
 
                 filteredRecord.name = fmt::format("{}_{}_unapply", name, filterKey);
-                filteredRecord.regex = std::regex(filterRegexStr);
+                filteredRecord.matcher = Matcher(filterRegexStr);
                 filteredRecord.attributes = nlohmann::json::object();
                 filteredRecord.attributes[attrIT.key()] = nullptr;
                 mAttributes.push_back(std::move(filteredRecord));
@@ -32,11 +32,15 @@
 #include "Core/Error.h"
 #include "Utils/Logger.h"
 
+#include <algorithm>
 #include <type_traits>
+#include <mutex>
 #include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -54,36 +58,104 @@ namespace settings
 
 class AttributeFilter
 {
+    /// Shape name matcher compiled from a filter regex.
+    /// Regexes that reduce to a literal, prefix, suffix or substring test are matched without running std::regex.
+    class Matcher
+    {
+    public:
+        Matcher() = default;
+        explicit Matcher(const std::string& regexStr);
+
+        bool match(std::string_view shapeName) const;
+
+        /// True if matching has to fall back to std::regex.
+        bool isRegex() const { return mKind == Kind::Regex; }
+
+    private:
+        enum class Kind
+        {
+            Any,
+            Literal,
+            Prefix,
+            Suffix,
+            Contains,
+            Regex,
+        };
+
+        Kind mKind = Kind::Any;
+        std::string mLiteral;
+        std::regex mRegex;
+    };
+
     struct Record
     {
         std::string name;
-        std::regex regex;
+        Matcher matcher;
         nlohmann::json attributes;
     };
 
+    /// Indices of the records matching each queried shape name, used when some records need std::regex.
+    /// Importers query several attributes per shape, so the regexes only run once per distinct name.
+    /// The cache is not copied along with the filter, it is rebuilt on demand.
+    struct MatchCache
+    {
+        MatchCache() = default;
+        MatchCache(const MatchCache&) {}
+        MatchCache& operator=(const MatchCache&)
+        {
+            clear();
+            return *this;
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            matches.clear();
+        }
+
+        std::mutex mutex;
+        std::unordered_map<std::string, std::vector<uint32_t>> matches;
+    };
+
 public:
-    void add(const nlohmann::json& json) { addJson(json); }
-    void clear() { mAttributes.clear(); }
+    void add(const nlohmann::json& json)
+    {
+        addJson(json);
+        mHasRegexRecords = std::any_of(mAttributes.begin(), mAttributes.end(), [](const Record& r) { return r.matcher.isRegex(); });
+        mMatchCache.clear();
+    }
+    void clear()
+    {
+        mAttributes.clear();
+        mHasRegexRecords = false;
+        mMatchCache.clear();
+    }
 
     Attributes getAttributes(std::string_view shapeName_) const;
 
+    /// Returns the attributes of multiple shapes at once, in the order of the given names.
+    std::vector<Attributes> getAttributes(const std::vector<std::string>& shapeNames) const;
+
     template<typename T>
     std::optional<T> getAttribute(std::string_view shapeName, std::string_view attrName) const
     {
-        nlohmann::json attribute = nullptr;
-
-        for (const Record& recordIt : mAttributes)
-        {
-            if (!std::regex_match(shapeName.begin(), shapeName.end(), recordIt.regex))
-                continue;
-            auto attrIt = recordIt.attributes.find(attrName);
-            if (attrIt != recordIt.attributes.end())
-                attribute = attrIt.value();
-        }
-
-        if (attribute.is_null())
+        const nlohmann::json* attributePtr = nullptr;
+
+        forEachMatchingRecord(
+            shapeName,
+            [&](const Record& recordIt)
+            {
+                auto attrIt = recordIt.attributes.find(attrName);
+                if (attrIt != recordIt.attributes.end())
+                    attributePtr = &attrIt.value();
+            }
+        );
+
+        if (!attributePtr || attributePtr->is_null())
             return {};
 
+        const nlohmann::json& attribute = *attributePtr;
+
         if (!detail::TypeChecker<T>::validType(attribute))
             throw detail::TypeError("Attribute's type does not match the requested type.");
 
@@ -96,6 +168,17 @@ public:
         return attribute.get<T>();
     }
 
+    /// Returns a single attribute of multiple shapes at once, in the order of the given names.
+    template<typename T>
+    std::vector<std::optional<T>> getAttribute(const std::vector<std::string>& shapeNames, std::string_view attrName) const
+    {
+        std::vector<std::optional<T>> result;
+        result.reserve(shapeNames.size());
+        for (const std::string& shapeName : shapeNames)
+            result.push_back(getAttribute<T>(shapeName, attrName));
+        return result;
+    }
+
     template<typename T>
     T getAttribute(std::string_view shapeName, std::string_view attrName, const T& def) const
     {
@@ -108,6 +191,29 @@ private:
     void addArray(const nlohmann::json& array);
     void addDictionary(const nlohmann::json& dict);
 
+    /// Returns the indices of all records matching the shape name, in the order in which they were added.
+    /// Returned by copy, as other threads may modify the cache while the caller iterates.
+    std::vector<uint32_t> getMatchingRecords(std::string_view shapeName) const;
+
+    /// Calls func for all records matching the shape name, in the order in which they were added.
+    /// Fast path matchers are cheaper than a cache lookup, so the cache is only used if there are regex records.
+    template<typename Func>
+    void forEachMatchingRecord(std::string_view shapeName, Func func) const
+    {
+        if (!mHasRegexRecords)
+        {
+            for (const Record& recordIt : mAttributes)
+            {
+                if (recordIt.matcher.match(shapeName))
+                    func(recordIt);
+            }
+            return;
+        }
+
+        for (uint32_t recordIndex : getMatchingRecords(shapeName))
+            func(mAttributes[recordIndex]);
+    }
+
 private:
     /// Filters out all attributes using the deprecated `name.filter` syntax,
     /// processes into filters, and returns the remaining attributes
@@ -115,6 +221,8 @@ private:
 
 private:
     std::vector<Record> mAttributes;
+    bool mHasRegexRecords = false;
+    mutable MatchCache mMatchCache;
 };
 
 } // namespace settings
@@ -106,6 +106,13 @@ public:
         return getActive().mAttributeFilters.getAttribute<T>(shapeName, attributeName, def);
     }
 
+    /// Returns a single attribute of multiple shapes at once, in the order of the given names.
+    template<typename T>
+    std::vector<std::optional<T>> getAttribute(const std::vector<std::string>& shapeNames, std::string_view attributeName) const
+    {
+        return getActive().mAttributeFilters.getAttribute<T>(shapeNames, attributeName);
+    }
+
     /**
      * @brief Adds filtered attributes with the following syntax.
      *
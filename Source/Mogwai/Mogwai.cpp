@@ -135,6 +135,12 @@ namespace Mogwai
             // Add scene to recent files only if not in silent mode (which is used during image tests).
             if (!mOptions.silentMode) mAppData.addRecentScene(mOptions.sceneFile);
         }
+
+        // Run batch job file provided via command line and exit.
+        if (!mOptions.batchFile.empty())
+        {
+            shutdown(runBatch(mOptions.batchFile, mOptions.batchReportFile));
+        }
     }
 
     void Renderer::onOptionsChange()
@@ -307,6 +313,17 @@ namespace Mogwai
             loadScript(path);
             mAppData.addRecentScript(path);
         }
+        else if (ext == "json")
+        {
+            try
+            {
+                addGraph(RenderGraph::createFromFile(getDevice(), path));
+            }
+            catch (const std::exception& e)
+            {
+                reportErrorAndContinue(fmt::format("Error when loading render graph: {}\n{}", path, e.what()));
+            }
+        }
         else if (std::any_of(Scene::getFileExtensionFilters().begin(), Scene::getFileExtensionFilters().end(), [&ext](FileDialogFilter f) {return f.ext == ext; }))
         {
             loadScene(path);
@@ -653,7 +670,9 @@ namespace Mogwai
         }
 
         // Execute graph.
-        pGraph->getPassesDictionary()[kRenderPassRefreshFlags] = RenderPassRefreshFlags::None;
+        pGraph->getPassesDictionary().setValue(kRenderPassRefreshFlagsKey, mPendingRefreshFlags);
+        mPendingRefreshFlags = RenderPassRefreshFlags::None;
+        pGraph->getPassesDictionary().setValue(kRenderPassFrameTimeDeltaKey, (float)getGlobalClock().getDelta());
         pGraph->execute(pRenderContext);
     }
 
@@ -835,6 +854,8 @@ int runMain(int argc, char** argv)
     args::ValueFlag<std::string> scriptFlag(parser, "path", "Python script file to run.", {'s', "script"});
     args::Flag deferredFlag(parser, "deferred", "The script is loaded deferred.", {"deferred"});
     args::ValueFlag<std::string> sceneFlag(parser, "path", "Scene file (for example, a .pyscene file) to open.", { 'S', "scene" });
+    args::ValueFlag<std::string> batchFlag(parser, "path", "Batch job file (JSON) to render headless. Exits with a non-zero code if any job fails.", { "batch" });
+    args::ValueFlag<std::string> batchReportFlag(parser, "path", "File to write the batch report into.", { "batch-report" });
     args::ValueFlag<std::string> shaderCacheFlag(parser, "shadercache", "Path to the GFX shader cache.", { "shadercache" });
     args::ValueFlag<std::string> logfileFlag(parser, "path", "File to write log into.", {'l', "logfile"});
     args::ValueFlag<int32_t> verbosityFlag(parser, "verbosity", "Logging verbosity (0=disabled, 1=fatal errors, 2=errors, 3=warnings, 4=infos, 5=debugging)", { 'v', "verbosity" }, 4);
@@ -915,7 +936,7 @@ int runMain(int argc, char** argv)
     }
     if (gpuFlag)
         config.deviceDesc.gpu = args::get(gpuFlag);
-    if (headlessFlag)
+    if (headlessFlag || batchFlag)
         config.headless = true;
     if (shaderCacheFlag)
         config.deviceDesc.shaderCachePath = args::get(shaderCacheFlag);
@@ -946,6 +967,8 @@ int runMain(int argc, char** argv)
     if (silentFlag) options.silentMode = true;
     if (useSceneCacheFlag) options.useSceneCache = true;
     if (rebuildSceneCacheFlag) options.rebuildSceneCache = true;
+    if (batchFlag) options.batchFile = args::get(batchFlag);
+    if (batchReportFlag) options.batchReportFile = args::get(batchReportFlag);
 
     Mogwai::Renderer renderer(config, options);
     return renderer.run();
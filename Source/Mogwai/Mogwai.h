@@ -30,6 +30,7 @@
 #include "Core/SampleApp.h"
 #include "Scene/SceneBuilder.h"
 #include "RenderGraph/RenderGraph.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
 #include "AppData.h"
 
 namespace Falcor
@@ -87,6 +88,8 @@ namespace Mogwai
             bool silentMode = false;
             bool useSceneCache = false;
             bool rebuildSceneCache = false;
+            std::string batchFile;          ///< Batch job file to run. The application exits after the batch is done.
+            std::string batchReportFile;    ///< Batch report file (default: job file with ".report.json" extension).
         };
 
         using KeyCallback = std::function<bool(bool pressed, uint32_t key)>;
@@ -186,6 +189,7 @@ namespace Mogwai
 
         std::vector<GraphData> mGraphs;
         uint32_t mActiveGraph = 0;
+        RenderPassRefreshFlags mPendingRefreshFlags = RenderPassRefreshFlags::None; ///< Refresh flags passed to the active graph on its next execution.
         ref<Sampler> mpSampler = nullptr;
         std::filesystem::path mScriptPath;
 
@@ -207,6 +211,9 @@ namespace Mogwai
         // Scripting
         void registerScriptBindings(pybind11::module& m);
 
+        // Batch rendering
+        int runBatch(const std::filesystem::path& path, const std::filesystem::path& reportPath);
+
         void handleGamepadInput(float deltaTimeSeconds);
     };
 
@@ -0,0 +1,323 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Falcor.h"
+#include "Mogwai.h"
+#include "Core/Platform/OS.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
+#include "Rendering/Utils/TileScheduler.h"
+#include "Utils/BatchJobs.h"
+#include "Utils/Timing/TimeReport.h"
+
+#include <fstream>
+
+namespace Mogwai
+{
+    namespace
+    {
+        /** Executes batch jobs with the renderer.
+            The scene and render graph are kept loaded between jobs, so that jobs sharing them (and the
+            programs compiled for them) skip the load.
+        */
+        class RendererBatchExecutor : public BatchRunner::Executor
+        {
+        public:
+            RendererBatchExecutor(Renderer* pRenderer) : mpRenderer(pRenderer) {}
+
+            void loadScene(const std::filesystem::path& path) override
+            {
+                SceneBuilder::Flags buildFlags = SceneBuilder::Flags::Default;
+                if (mpRenderer->mOptions.useSceneCache) buildFlags |= SceneBuilder::Flags::UseCache;
+                if (mpRenderer->mOptions.rebuildSceneCache) buildFlags |= SceneBuilder::Flags::RebuildCache;
+
+                // Release the previous scene first to keep the peak memory usage down.
+                mpRenderer->setScene(nullptr);
+
+                TimeReport timeReport;
+                mpRenderer->setScene(SceneBuilder(mpRenderer->getDevice(), path, mpRenderer->getSettings(), buildFlags).getScene());
+                timeReport.measure("Loading scene (total)");
+                timeReport.printToLog();
+            }
+
+            void loadGraph(const std::filesystem::path& path, const std::map<std::string, Properties>& passProperties) override
+            {
+                if (mpGraph)
+                {
+                    mpRenderer->removeGraph(mpGraph);
+                    mpGraph = nullptr;
+                }
+                // Drop the tiles of a failed job.
+                mStitchers.clear();
+
+                ref<RenderGraph> pGraph = RenderGraph::createFromFile(mpRenderer->getDevice(), path);
+                FALCOR_CHECK(pGraph, "Failed to load render graph '{}'.", path);
+                for (const auto& [passName, props] : passProperties)
+                {
+                    FALCOR_CHECK(pGraph->doesPassExist(passName), "Render graph '{}' has no pass named '{}'.", path, passName);
+                    pGraph->updatePass(passName, props);
+                }
+
+                mpRenderer->addGraph(pGraph);
+                mpRenderer->setActiveGraph(pGraph);
+                mpGraph = pGraph;
+            }
+
+            uint2 getResolution() override
+            {
+                const ref<Fbo>& pFbo = mpRenderer->getTargetFbo();
+                return uint2(pFbo->getWidth(), pFbo->getHeight());
+            }
+
+            void setResolution(uint2 resolution) override
+            {
+                mpRenderer->resizeFrameBuffer(resolution.x, resolution.y);
+            }
+
+            void setCamera(const BatchJob::Camera& camera) override
+            {
+                const ref<Scene>& pScene = mpRenderer->getScene();
+                FALCOR_CHECK(pScene, "No scene is loaded.");
+
+                switch (camera.type)
+                {
+                case BatchJob::Camera::Type::Default:
+                    // Restore the initial viewpoint, previous jobs may have moved the camera.
+                    pScene->selectViewpoint(0);
+                    break;
+                case BatchJob::Camera::Type::Name:
+                {
+                    const auto& cameras = pScene->getCameras();
+                    auto it = std::find_if(cameras.begin(), cameras.end(), [&](const ref<Camera>& pCamera) { return pCamera->getName() == camera.name; });
+                    FALCOR_CHECK(it != cameras.end(), "Scene has no camera named '{}'.", camera.name);
+                    pScene->selectCamera((uint32_t)(it - cameras.begin()));
+                    break;
+                }
+                case BatchJob::Camera::Type::Viewpoint:
+                    FALCOR_CHECK(camera.viewpoint < pScene->getViewpointCount(), "Scene has no viewpoint {}.", camera.viewpoint);
+                    pScene->selectViewpoint(camera.viewpoint);
+                    break;
+                case BatchJob::Camera::Type::LookAt:
+                {
+                    const ref<Camera>& pCamera = pScene->getCamera();
+                    pCamera->setPosition(camera.position);
+                    pCamera->setTarget(camera.target);
+                    pCamera->setUpVector(camera.up);
+                    break;
+                }
+                }
+            }
+
+            void renderFrame(uint32_t frame) override
+            {
+                // The clock is paused, the frame is applied on the next tick.
+                mpRenderer->getGlobalClock().setFrame(frame, true);
+                mpRenderer->renderFrame();
+            }
+
+            void resetTemporalState() override
+            {
+                // Passes with temporal state (e.g. accumulation) reset when the render options change.
+                mpRenderer->mPendingRefreshFlags |= RenderPassRefreshFlags::RenderOptionsChanged;
+            }
+
+            std::vector<std::string> getOutputs() override
+            {
+                FALCOR_CHECK(mpGraph, "No render graph is loaded.");
+                return mpRenderer->getGraphOutputs(mpGraph);
+            }
+
+            void markOutputs(const std::vector<std::string>& outputs) override
+            {
+                FALCOR_CHECK(mpGraph, "No render graph is loaded.");
+                for (const auto& output : outputs)
+                {
+                    if (!mpGraph->isGraphOutput(output)) mpGraph->markOutput(output);
+                }
+            }
+
+            void captureOutput(const std::string& output, const std::filesystem::path& path) override
+            {
+                ref<Texture> pTexture = getOutputTexture(output);
+                Bitmap::FileFormat format = getFileFormat(path);
+
+                if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+                pTexture->captureToFile(0, 0, path, format, Bitmap::ExportFlags::None, false);
+            }
+
+            void setRenderTile(const RenderTile& tile) override
+            {
+                FALCOR_CHECK(mpGraph, "No render graph is loaded.");
+                mpGraph->getPassesDictionary().setValue(kRenderPassTileKey, tile);
+            }
+
+            void captureTile(const std::string& output, const RenderTile& region, const RenderTile& tile) override
+            {
+                ref<Texture> pTexture = getOutputTexture(output);
+                FALCOR_CHECK(pTexture->getType() == Texture::Type::Texture2D, "Graph output '{}' is not a 2D texture.", output);
+                RenderContext* pRenderContext = mpRenderer->getDevice()->getRenderContext();
+                const ref<Device>& pDevice = mpRenderer->getDevice();
+
+                // Read back only the pixels of the tile. HDR formats with less than 3 channels are
+                // expanded to RGBA, as done by Texture::captureToFile().
+                ResourceFormat format = pTexture->getFormat();
+                ref<Texture> pStaging;
+                if (getFormatType(format) == FormatType::Float && getFormatChannelCount(format) < 3)
+                {
+                    format = ResourceFormat::RGBA32Float;
+                    pStaging = pDevice->createTexture2D(
+                        tile.extent.x, tile.extent.y, format, 1, 1, nullptr, ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource
+                    );
+                    const uint2 end = tile.getEnd();
+                    pRenderContext->blit(
+                        pTexture->getSRV(0, 1, 0, 1),
+                        pStaging->getRTV(0, 0, 1),
+                        uint4(tile.offset, end),
+                        uint4(uint2(0), tile.extent),
+                        TextureFilteringMode::Point
+                    );
+                }
+                else
+                {
+                    pStaging = pDevice->createTexture2D(tile.extent.x, tile.extent.y, format, 1, 1, nullptr, ResourceBindFlags::None);
+                    pRenderContext->copySubresourceRegion(
+                        pStaging.get(), 0, pTexture.get(), 0, uint3(0), uint3(tile.offset, 0), uint3(tile.extent, 1)
+                    );
+                }
+                std::vector<uint8_t> data = pRenderContext->readTextureSubresource(pStaging.get(), 0);
+
+                auto& stitcher = mStitchers[output];
+                if (!stitcher.pStitcher || stitcher.pStitcher->getRegion() != region || stitcher.format != format)
+                {
+                    stitcher.pStitcher = std::make_unique<TileStitcher>(region, getFormatBytesPerBlock(format));
+                    stitcher.format = format;
+                }
+                stitcher.pStitcher->addTile(tile, data.data());
+            }
+
+            void writeStitchedOutput(const std::string& output, const std::filesystem::path& path) override
+            {
+                auto it = mStitchers.find(output);
+                FALCOR_CHECK(it != mStitchers.end(), "No tiles were captured for graph output '{}'.", output);
+                Stitcher stitcher = std::move(it->second);
+                mStitchers.erase(it);
+                FALCOR_CHECK(stitcher.pStitcher->isComplete(), "Tiles captured for graph output '{}' don't cover the region.", output);
+
+                Bitmap::FileFormat fileFormat = getFileFormat(path);
+                const RenderTile& region = stitcher.pStitcher->getRegion();
+                std::vector<uint8_t> data = stitcher.pStitcher->getData();
+
+                if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+                Bitmap::saveImage(
+                    path, region.extent.x, region.extent.y, fileFormat, Bitmap::ExportFlags::None, stitcher.format, true, data.data()
+                );
+            }
+
+            BatchMemoryUsage getMemoryUsage() override
+            {
+                BatchMemoryUsage usage;
+                usage.processBytes = getCurrentRSS();
+                usage.peakProcessBytes = getPeakRSS();
+                if (const ref<Scene>& pScene = mpRenderer->getScene()) usage.sceneBytes = pScene->getMemoryUsageInBytes();
+                return usage;
+            }
+
+        private:
+            ref<Texture> getOutputTexture(const std::string& output)
+            {
+                FALCOR_CHECK(mpGraph, "No render graph is loaded.");
+                ref<Resource> pResource = mpGraph->getOutput(output);
+                FALCOR_CHECK(pResource, "Render graph has no output named '{}'.", output);
+                ref<Texture> pTexture = pResource->asTexture();
+                FALCOR_CHECK(pTexture, "Graph output '{}' is not a texture.", output);
+                return pTexture;
+            }
+
+            Bitmap::FileFormat getFileFormat(const std::filesystem::path& path)
+            {
+                std::string ext = path.extension().string();
+                FALCOR_CHECK(!ext.empty(), "Output file '{}' has no extension.", path);
+                return Bitmap::getFormatFromFileExtension(ext.substr(1));
+            }
+
+            /// Tiles of a graph output captured for the current frame.
+            struct Stitcher
+            {
+                std::unique_ptr<TileStitcher> pStitcher;
+                ResourceFormat format = ResourceFormat::Unknown;
+            };
+
+            Renderer* mpRenderer;
+            ref<RenderGraph> mpGraph;
+            std::map<std::string, Stitcher> mStitchers;
+        };
+    }
+
+    int Renderer::runBatch(const std::filesystem::path& path, const std::filesystem::path& reportPath)
+    {
+        std::vector<BatchJob> jobs;
+        try
+        {
+            jobs = BatchJob::parseFile(path);
+        }
+        catch (const std::exception& e)
+        {
+            logError("Failed to load batch job file '{}':\n{}", path, e.what());
+            return 1;
+        }
+
+        logInfo("Running {} batch jobs from '{}'.", jobs.size(), path);
+
+        // Render frames at a fixed framerate and only advance the clock through the job frames.
+        Clock& clock = getGlobalClock();
+        if (!clock.isSimulatingFps()) clock.setFramerate(60);
+        clock.pause();
+        getProgressBar().close();
+
+        RendererBatchExecutor executor(this);
+        BatchReport report = BatchRunner::run(jobs, executor);
+
+        for (const auto& job : report.jobs)
+        {
+            if (!job.succeeded) logError("Batch job '{}' failed:\n{}", job.name, job.error);
+        }
+        logInfo("Batch report:\n{}", report.getSummary());
+
+        std::filesystem::path reportFile = reportPath.empty() ? std::filesystem::path(path).replace_extension(".report.json") : reportPath;
+        std::ofstream stream(reportFile);
+        if (stream)
+        {
+            stream << report.toJsonString();
+            logInfo("Wrote batch report to '{}'.", reportFile);
+        }
+        else
+        {
+            logError("Failed to write batch report to '{}'.", reportFile);
+        }
+
+        return report.getFailedCount() > 0 ? 1 : 0;
+    }
+}
@@ -28,11 +28,49 @@
 #include "AccumulatePass.h"
 #include "RenderGraph/RenderPassStandardFlags.h"
 
+static pybind11::dict toPython(const AccumulatePass::ConvergenceStats& stats)
+{
+    pybind11::dict d;
+    d["frameCount"] = stats.frameCount;
+    d["maxTileError"] = stats.maxTileError;
+    d["avgTileError"] = stats.avgTileError;
+    d["converged"] = stats.converged;
+    return d;
+}
+
 static void regAccumulatePass(pybind11::module& m)
 {
+    using namespace pybind11::literals;
+
     pybind11::class_<AccumulatePass, RenderPass, ref<AccumulatePass>> pass(m, "AccumulatePass");
     pass.def_property("enabled", &AccumulatePass::isEnabled, &AccumulatePass::setEnabled);
     pass.def("reset", &AccumulatePass::reset);
+
+    pass.def_property_readonly("converged", &AccumulatePass::isConverged);
+    pass.def_property_readonly("convergenceStats", [](const AccumulatePass& pass) { return toPython(pass.getConvergenceStats()); });
+    pass.def(
+        "addConvergenceCallback",
+        [](AccumulatePass& pass, std::function<void(pybind11::dict)> callback)
+        { pass.addConvergenceCallback([callback](const AccumulatePass::ConvergenceStats& stats) { callback(toPython(stats)); }); },
+        "callback"_a
+    );
+    pass.def(
+        "saveCheckpoint",
+        [](AccumulatePass& pass, const std::filesystem::path& path, const pybind11::dict& metadata)
+        { pass.saveCheckpoint(path, Properties(metadata)); },
+        "path"_a,
+        "metadata"_a = pybind11::dict()
+    );
+    pass.def_property(
+        "checkpointMetadata",
+        [](const AccumulatePass& pass) { return pass.getCheckpointMetadata().toPython(); },
+        [](AccumulatePass& pass, const pybind11::dict& metadata) { pass.setCheckpointMetadata(Properties(metadata)); }
+    );
+    pass.def(
+        "loadCheckpoint",
+        [](AccumulatePass& pass, const std::filesystem::path& path) { return pass.loadCheckpoint(path).toPython(); },
+        "path"_a
+    );
 }
 
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
@@ -48,6 +86,10 @@ const char kShaderFile[] = "RenderPasses/AccumulatePass/Accumulate.cs.slang";
 const char kInputChannel[] = "input";
 const char kOutputChannel[] = "output";
 
+// Interned IDs of the fields looked up every frame.
+const RenderData::ResourceID kInputChannelID{kInputChannel};
+const RenderData::ResourceID kOutputChannelID{kOutputChannel};
+
 // Serialized parameters
 const char kEnabled[] = "enabled";
 const char kOutputFormat[] = "outputFormat";
@@ -57,10 +99,33 @@ const char kAutoReset[] = "autoReset";
 const char kPrecisionMode[] = "precisionMode";
 const char kMaxFrameCount[] = "maxFrameCount";
 const char kOverflowMode[] = "overflowMode";
+const char kConvergenceThreshold[] = "convergenceThreshold";
+const char kConvergenceMinFrames[] = "convergenceMinFrames";
+const char kConvergenceMaxFrames[] = "convergenceMaxFrames";
+const char kConvergenceInterval[] = "convergenceInterval";
+const char kCheckpointPath[] = "checkpointPath";
+const char kCheckpointInterval[] = "checkpointInterval";
+const char kResumeFromCheckpoint[] = "resumeFromCheckpoint";
+
+// Convergence detection. The tile size must match Accumulate.cs.slang.
+const uint32_t kTileSize = 16;
+const uint32_t kTileSampleStride = 4;
+const float kRelativeErrorEpsilon = 1e-3f;
+
+// Names of the accumulation buffers in checkpoints.
+const char kCheckpointSum[] = "sum";
+const char kCheckpointCorr[] = "corr";
+const char kCheckpointSumLo[] = "sumLo";
+const char kCheckpointSumHi[] = "sumHi";
+const char kCheckpointSqrSum[] = "sqrSum";
+// Name of the renderer's sample index in the checkpoint metadata.
+const char kCheckpointSampleIndex[] = "sampleIndex";
 } // namespace
 
 AccumulatePass::AccumulatePass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
 {
+    std::filesystem::path resumePath;
+
     // Deserialize pass from dictionary.
     for (const auto& [key, value] : props)
     {
@@ -80,6 +145,20 @@ AccumulatePass::AccumulatePass(ref<Device> pDevice, const Properties& props) : R
             mMaxFrameCount = value;
         else if (key == kOverflowMode)
             mOverflowMode = value;
+        else if (key == kConvergenceThreshold)
+            mConvergenceThreshold = value;
+        else if (key == kConvergenceMinFrames)
+            mConvergenceMinFrames = value;
+        else if (key == kConvergenceMaxFrames)
+            mConvergenceMaxFrames = value;
+        else if (key == kConvergenceInterval)
+            mConvergenceInterval = value;
+        else if (key == kCheckpointPath)
+            mCheckpointPath = value.operator std::filesystem::path();
+        else if (key == kCheckpointInterval)
+            mCheckpointInterval = value;
+        else if (key == kResumeFromCheckpoint)
+            resumePath = value.operator std::filesystem::path();
         else
             logWarning("Unknown property '{}' in AccumulatePass properties.", key);
     }
@@ -91,7 +170,19 @@ AccumulatePass::AccumulatePass(ref<Device> pDevice, const Properties& props) : R
             mEnabled = props["enableAccumulation"];
     }
 
+    mConvergenceInterval = std::max(mConvergenceInterval, 1u);
+
     mpState = ComputeState::create(mpDevice);
+
+    // Resume from a checkpoint. A missing file is not an error, which allows the same configuration
+    // to be used for starting and resuming a render.
+    if (!resumePath.empty())
+    {
+        if (std::filesystem::exists(resumePath))
+            loadCheckpoint(resumePath);
+        else
+            logInfo("AccumulatePass: Checkpoint '{}' doesn't exist. Starting a new accumulation.", resumePath);
+    }
 }
 
 Properties AccumulatePass::getProperties() const
@@ -107,6 +198,13 @@ Properties AccumulatePass::getProperties() const
     props[kPrecisionMode] = mPrecisionMode;
     props[kMaxFrameCount] = mMaxFrameCount;
     props[kOverflowMode] = mOverflowMode;
+    props[kConvergenceThreshold] = mConvergenceThreshold;
+    props[kConvergenceMinFrames] = mConvergenceMinFrames;
+    props[kConvergenceMaxFrames] = mConvergenceMaxFrames;
+    props[kConvergenceInterval] = mConvergenceInterval;
+    if (!mCheckpointPath.empty())
+        props[kCheckpointPath] = mCheckpointPath;
+    props[kCheckpointInterval] = mCheckpointInterval;
     return props;
 }
 
@@ -126,11 +224,16 @@ RenderPassReflection AccumulatePass::reflect(const CompileData& compileData)
 
 void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& renderData)
 {
+    auto& dict = renderData.getDictionary();
+
+    // Track the sample index of the renderer for checkpoints.
+    const uint32_t* pSampleIndex = dict.tryGetValue(kRenderPassSampleIndexKey);
+    mSampleIndex = pSampleIndex ? std::optional<uint32_t>(*pSampleIndex) : std::nullopt;
+
     if (mAutoReset)
     {
         // Query refresh flags passed down from the application and other passes.
-        auto& dict = renderData.getDictionary();
-        auto refreshFlags = dict.getValue(kRenderPassRefreshFlags, RenderPassRefreshFlags::None);
+        auto refreshFlags = dict.getValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
 
         // If any refresh flag is set, we reset frame accumulation.
         if (refreshFlags != RenderPassRefreshFlags::None)
@@ -155,6 +258,11 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
         }
     }
 
+    // Stop accumulating once converged. The output retains the accumulated image.
+    updateConvergence();
+    if (mConvergenceStats.converged && !mpPendingCheckpoint)
+        return;
+
     // Check if we reached max number of frames to accumulate and handle overflow.
     if (mMaxFrameCount > 0 && mFrameCount == mMaxFrameCount)
     {
@@ -171,8 +279,8 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
     }
 
     // Grab our input/output buffers.
-    ref<Texture> pSrc = renderData.getTexture(kInputChannel);
-    ref<Texture> pDst = renderData.getTexture(kOutputChannel);
+    ref<Texture> pSrc = renderData.getTexture(kInputChannelID);
+    ref<Texture> pDst = renderData.getTexture(kOutputChannelID);
     FALCOR_ASSERT(pSrc && pDst);
 
     const uint2 resolution = uint2(pSrc->getWidth(), pSrc->getHeight());
@@ -206,6 +314,14 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
         // Only blit mip 0 and array slice 0, because that's what the accumulation uses otherwise.
         pRenderContext->blit(pSrc->getSRV(0, 1, 0, 1), pDst->getRTV(0, 0, 1));
     }
+    else if (resolutionMatch && mpPendingCheckpoint && !mSampleIndexRestored && mpPendingCheckpoint->metadata.has(kCheckpointSampleIndex))
+    {
+        // Hand the sample index of the checkpoint back to the renderer. The current frame was rendered before the
+        // renderer could pick it up, so it is discarded. The checkpoint is restored at the next frame.
+        dict.setValue(kRenderPassSampleIndexKey, mpPendingCheckpoint->metadata.get<uint32_t>(kCheckpointSampleIndex));
+        mSampleIndexRestored = true;
+        pRenderContext->clearUAV(pDst->getUAV().get(), float4(0.f));
+    }
     else if (resolutionMatch)
     {
         accumulate(pRenderContext, pSrc, pDst);
@@ -260,6 +376,8 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const ref<Texture
 
     // Setup accumulation.
     prepareAccumulation(pRenderContext, mFrameDim.x, mFrameDim.y);
+    if (mpPendingCheckpoint)
+        restoreCheckpoint(pRenderContext);
 
     // Set shader parameters.
     auto var = mpVars->getRootVar();
@@ -267,6 +385,7 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const ref<Texture
     var["PerFrameCB"]["gAccumCount"] = mFrameCount;
     var["PerFrameCB"]["gAccumulate"] = mEnabled;
     var["PerFrameCB"]["gMovingAverageMode"] = (mMaxFrameCount > 0);
+    var["PerFrameCB"]["gTrackVariance"] = mpLastFrameSqrSum != nullptr;
     var["gCurFrame"] = pSrc;
     var["gOutputFrame"] = pDst;
 
@@ -275,10 +394,12 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const ref<Texture
     var["gLastFrameCorr"] = mpLastFrameCorr;
     var["gLastFrameSumLo"] = mpLastFrameSumLo;
     var["gLastFrameSumHi"] = mpLastFrameSumHi;
+    var["gLastFrameSqrSum"] = mpLastFrameSqrSum;
 
     // Update the frame count.
     // The accumulation limit (mMaxFrameCount) has a special value of 0 (no limit) and is not supported in the SingleCompensated mode.
-    if (mMaxFrameCount == 0 || mPrecisionMode == Precision::SingleCompensated || mFrameCount < mMaxFrameCount)
+    const bool frameAdded = mMaxFrameCount == 0 || mPrecisionMode == Precision::SingleCompensated || mFrameCount < mMaxFrameCount;
+    if (frameAdded)
     {
         mFrameCount++;
     }
@@ -289,6 +410,202 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const ref<Texture
     uint3 numGroups = div_round_up(uint3(mFrameDim.x, mFrameDim.y, 1u), pProgram->getReflector()->getThreadGroupSize());
     mpState->setProgram(pProgram);
     pRenderContext->dispatch(mpState.get(), mpVars.get(), numGroups);
+
+    // Estimate the error for convergence detection. The result is read back at the next execute.
+    if (mpLastFrameSqrSum && mFrameCount >= std::max(mConvergenceMinFrames, 2u) && mFrameCount % mConvergenceInterval == 0)
+        estimateError(pRenderContext, pDst);
+
+    // Write checkpoint periodically.
+    if (mEnabled && frameAdded && mCheckpointInterval > 0 && !mCheckpointPath.empty() && mFrameCount % mCheckpointInterval == 0)
+        saveCheckpoint(mCheckpointPath, mCheckpointMetadata);
+}
+
+bool AccumulatePass::isConvergenceEnabled() const
+{
+    // Error estimation is only supported for standard averaging, not the moving average used with a frame limit.
+    return mEnabled && mConvergenceThreshold > 0.f && mMaxFrameCount == 0;
+}
+
+void AccumulatePass::estimateError(RenderContext* pRenderContext, const ref<Texture>& pDst)
+{
+    FALCOR_ASSERT(mpLastFrameSqrSum);
+
+    const uint2 tileCount = div_round_up(mFrameDim, uint2(kTileSize));
+    const uint32_t totalTileCount = tileCount.x * tileCount.y;
+
+    if (!mpErrorProgram)
+    {
+        DefineList defines;
+        defines.add("_INPUT_FORMAT", "INPUT_FORMAT_FLOAT");
+        mpErrorProgram =
+            Program::createCompute(mpDevice, kShaderFile, "estimateTileError", defines, SlangCompilerFlags::TreatWarningsAsErrors);
+        mpErrorVars = ProgramVars::create(mpDevice, mpErrorProgram->getReflector());
+    }
+    if (!mpTileError || mpTileError->getElementCount() != totalTileCount)
+    {
+        mpTileError = mpDevice->createStructuredBuffer(
+            sizeof(float), totalTileCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal, nullptr, false
+        );
+        mpTileErrorRing = std::make_unique<GpuReadbackRing>(mpDevice, totalTileCount * sizeof(float));
+    }
+
+    // Evaluate a different subset of pixels in each estimate.
+    const uint32_t estimateIndex = mFrameCount / mConvergenceInterval;
+    const uint2 sampleOffset = uint2(estimateIndex % kTileSampleStride, (estimateIndex / kTileSampleStride) % kTileSampleStride);
+
+    auto var = mpErrorVars->getRootVar();
+    var["PerFrameCB"]["gResolution"] = mFrameDim;
+    var["PerFrameCB"]["gAccumCount"] = mFrameCount;
+    var["ErrorCB"]["gTileCount"] = tileCount;
+    var["ErrorCB"]["gSampleOffset"] = sampleOffset;
+    var["ErrorCB"]["gRelativeErrorEpsilon"] = kRelativeErrorEpsilon;
+    var["gAccumulatedFrame"] = pDst;
+    var["gSqrSum"] = mpLastFrameSqrSum;
+    var["gTileError"] = mpTileError;
+
+    uint3 numGroups = div_round_up(uint3(totalTileCount, 1u, 1u), mpErrorProgram->getReflector()->getThreadGroupSize());
+    mpState->setProgram(mpErrorProgram);
+    pRenderContext->dispatch(mpState.get(), mpErrorVars.get(), numGroups);
+
+    mpTileErrorRing->readBuffer(
+        pRenderContext,
+        mpTileError.get(),
+        0,
+        totalTileCount * sizeof(float),
+        mFrameCount,
+        [this](uint64_t frameCount, const void* pData, size_t size)
+        { applyErrorEstimate((uint32_t)frameCount, static_cast<const float*>(pData), size / sizeof(float)); }
+    );
+}
+
+void AccumulatePass::updateConvergence()
+{
+    if (!isConvergenceEnabled() && mConvergenceMaxFrames == 0)
+        return;
+    if (mConvergenceStats.converged)
+        return;
+
+    // Pick up the error estimates that have been read back. This doesn't wait for the GPU,
+    // so accumulation may continue for a few frames after the estimate that converged.
+    if (mpTileErrorRing)
+        mpTileErrorRing->poll();
+
+    if (mConvergenceMaxFrames > 0 && mFrameCount >= mConvergenceMaxFrames)
+    {
+        mConvergenceStats.frameCount = mFrameCount;
+        mConvergenceStats.converged = true;
+    }
+
+    if (mConvergenceStats.converged)
+    {
+        logInfo(
+            "AccumulatePass: Converged after {} frames (max tile error {:.4f}, average {:.4f}).",
+            mConvergenceStats.frameCount,
+            mConvergenceStats.maxTileError,
+            mConvergenceStats.avgTileError
+        );
+        for (const auto& callback : mConvergenceCallbacks)
+            callback(mConvergenceStats);
+    }
+}
+
+void AccumulatePass::applyErrorEstimate(uint32_t frameCount, const float* pTileError, size_t tileCount)
+{
+    // Keep the estimate that converged if several estimates are picked up at once.
+    if (mConvergenceStats.converged)
+        return;
+
+    float maxError = 0.f;
+    double errorSum = 0.0;
+    for (size_t i = 0; i < tileCount; ++i)
+    {
+        maxError = std::max(maxError, pTileError[i]);
+        errorSum += pTileError[i];
+    }
+
+    mConvergenceStats.frameCount = frameCount;
+    mConvergenceStats.maxTileError = maxError;
+    mConvergenceStats.avgTileError = tileCount > 0 ? (float)(errorSum / tileCount) : 0.f;
+    mConvergenceStats.converged = isConvergenceEnabled() && maxError <= mConvergenceThreshold;
+}
+
+void AccumulatePass::saveCheckpoint(const std::filesystem::path& path, const Properties& metadata)
+{
+    if (mFrameCount == 0)
+        FALCOR_THROW("AccumulatePass: Cannot save a checkpoint before any frames have been accumulated.");
+
+    RenderContext* pRenderContext = mpDevice->getRenderContext();
+
+    AccumulationCheckpoint checkpoint;
+    checkpoint.frameCount = mFrameCount;
+    checkpoint.metadata["precisionMode"] = mPrecisionMode;
+    checkpoint.metadata["maxFrameCount"] = mMaxFrameCount;
+    checkpoint.metadata["user"] = metadata;
+    if (mSampleIndex)
+        checkpoint.metadata[kCheckpointSampleIndex] = *mSampleIndex;
+
+    auto capture = [&](const char* name, const ref<Texture>& pBuf)
+    {
+        if (pBuf)
+            checkpoint.captureTexture(pRenderContext, name, pBuf.get());
+    };
+    capture(kCheckpointSum, mpLastFrameSum);
+    capture(kCheckpointCorr, mpLastFrameCorr);
+    capture(kCheckpointSumLo, mpLastFrameSumLo);
+    capture(kCheckpointSumHi, mpLastFrameSumHi);
+    capture(kCheckpointSqrSum, mpLastFrameSqrSum);
+
+    checkpoint.write(path);
+    logInfo("AccumulatePass: Saved checkpoint with {} frames to '{}'.", mFrameCount, path);
+}
+
+Properties AccumulatePass::loadCheckpoint(const std::filesystem::path& path)
+{
+    auto pCheckpoint = std::make_unique<AccumulationCheckpoint>(AccumulationCheckpoint::read(path));
+
+    // Validate the configuration now to report errors early. The buffers are validated when restored.
+    const Precision precisionMode = pCheckpoint->metadata.get<Precision>("precisionMode", mPrecisionMode);
+    const uint32_t maxFrameCount = pCheckpoint->metadata.get<uint32_t>("maxFrameCount", mMaxFrameCount);
+    if (precisionMode != mPrecisionMode || maxFrameCount != mMaxFrameCount)
+    {
+        FALCOR_THROW(
+            "AccumulatePass: Checkpoint '{}' was saved with a different configuration (mode {}, max frames {}).",
+            path,
+            enumToString(precisionMode),
+            maxFrameCount
+        );
+    }
+    if (pCheckpoint->frameCount == 0)
+        FALCOR_THROW("AccumulatePass: Checkpoint '{}' doesn't contain any frames.", path);
+
+    Properties metadata = pCheckpoint->metadata.get<Properties>("user", Properties());
+    mpPendingCheckpoint = std::move(pCheckpoint);
+    mSampleIndexRestored = false;
+    mConvergenceStats = {};
+    if (mpTileErrorRing)
+        mpTileErrorRing->discard();
+    logInfo("AccumulatePass: Loaded checkpoint with {} frames from '{}'.", mpPendingCheckpoint->frameCount, path);
+    return metadata;
+}
+
+void AccumulatePass::restoreCheckpoint(RenderContext* pRenderContext)
+{
+    FALCOR_ASSERT(mpPendingCheckpoint);
+    auto pCheckpoint = std::move(mpPendingCheckpoint);
+
+    auto restore = [&](const char* name, const ref<Texture>& pBuf)
+    {
+        if (pBuf)
+            pCheckpoint->restoreTexture(pRenderContext, name, pBuf.get());
+    };
+    restore(kCheckpointSum, mpLastFrameSum);
+    restore(kCheckpointCorr, mpLastFrameCorr);
+    restore(kCheckpointSumLo, mpLastFrameSumLo);
+    restore(kCheckpointSumHi, mpLastFrameSumHi);
+    restore(kCheckpointSqrSum, mpLastFrameSqrSum);
+
+    mFrameCount = pCheckpoint->frameCount;
+    mSampleIndexRestored = false;
 }
 
 void AccumulatePass::renderUI(Gui::Widgets& widget)
@@ -343,8 +660,35 @@ void AccumulatePass::renderUI(Gui::Widgets& widget)
             );
         }
 
+        if (widget.var("Convergence threshold", mConvergenceThreshold, 0.f, 1.f, 0.001f))
+            reset();
+        widget.tooltip(
+            "Relative error of the pixel means below which accumulation is considered converged. 0 disables convergence detection.\n"
+            "Convergence detection requires 'Max Frames' to be 0."
+        );
+        if (mConvergenceThreshold > 0.f)
+        {
+            widget.var("Min frames", mConvergenceMinFrames, 2u);
+            widget.tooltip("Minimum number of frames to accumulate before checking for convergence.");
+            if (widget.var("Check interval", mConvergenceInterval, 1u))
+                reset();
+            widget.tooltip("Number of frames between error estimates.");
+        }
+        widget.var("Converge at frames", mConvergenceMaxFrames, 0u);
+        widget.tooltip("Number of frames after which accumulation is considered converged regardless of the error. 0 means no limit.");
+
         const std::string text = std::string("Frames accumulated ") + std::to_string(mFrameCount);
         widget.text(text);
+        if (mConvergenceStats.frameCount > 0)
+        {
+            widget.text(fmt::format(
+                "Error at frame {}: max {:.4f}, avg {:.4f}{}",
+                mConvergenceStats.frameCount,
+                mConvergenceStats.maxTileError,
+                mConvergenceStats.avgTileError,
+                mConvergenceStats.converged ? " (converged)" : ""
+            ));
+        }
     }
 }
 
@@ -375,6 +719,11 @@ void AccumulatePass::setEnabled(bool enabled)
 void AccumulatePass::reset()
 {
     mFrameCount = 0;
+    mConvergenceStats = {};
+
+    // Drop the error estimates from before the reset.
+    if (mpTileErrorRing)
+        mpTileErrorRing->discard();
 }
 
 void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height)
@@ -413,4 +762,5 @@ void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t
     prepareBuffer(mpLastFrameCorr, ResourceFormat::RGBA32Float, mPrecisionMode == Precision::SingleCompensated);
     prepareBuffer(mpLastFrameSumLo, ResourceFormat::RGBA32Uint, mPrecisionMode == Precision::Double);
     prepareBuffer(mpLastFrameSumHi, ResourceFormat::RGBA32Uint, mPrecisionMode == Precision::Double);
+    prepareBuffer(mpLastFrameSqrSum, ResourceFormat::R32Float, isConvergenceEnabled());
 }
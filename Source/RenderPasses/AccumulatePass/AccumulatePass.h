@@ -29,6 +29,12 @@
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
 #include "RenderGraph/RenderPassHelpers.h"
+#include "Rendering/Utils/AccumulationCheckpoint.h"
+#include "Utils/GpuReadbackRing.h"
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <vector>
 
 using namespace Falcor;
 
@@ -41,6 +47,18 @@ using namespace Falcor;
  * For accumulating many samples for ground truth rendering etc., fp32 precision
  * is not always sufficient. The pass supports higher precision modes using
  * either error compensation (Kahan summation) or double precision math.
+ *
+ * For offline rendering, the pass can detect convergence of the accumulated image.
+ * The relative error of the pixel means is estimated from the luminance variance on a
+ * sparse set of pixels in each tile, and the accumulation is considered converged once
+ * the largest tile error is below a threshold. Upon convergence accumulation stops and
+ * the registered callbacks are invoked.
+ *
+ * The accumulation state can be saved to checkpoint files periodically and restored
+ * in a later session. Resuming continues the accumulation with bit-identical results.
+ * Checkpoints store the sample index published by the renderer in the graph dictionary
+ * (kRenderPassSampleIndex). When resuming, the index is handed back to the renderer and
+ * the first frame is discarded, so that the renderer continues its pseudorandom sequence.
  */
 class AccumulatePass : public RenderPass
 {
@@ -67,6 +85,55 @@ public:
     // Scripting functions
     void reset();
 
+    struct ConvergenceStats
+    {
+        /// Number of accumulated frames at the time of the last estimate.
+        uint32_t frameCount = 0;
+        /// Largest estimated relative error over all tiles.
+        float maxTileError = 0.f;
+        /// Average estimated relative error over all tiles.
+        float avgTileError = 0.f;
+        /// True if accumulation has converged (or reached the maximum number of frames).
+        bool converged = false;
+    };
+
+    using ConvergenceCallback = std::function<void(const ConvergenceStats&)>;
+
+    bool isConverged() const { return mConvergenceStats.converged; }
+    const ConvergenceStats& getConvergenceStats() const { return mConvergenceStats; }
+
+    /**
+     * Register a callback that is invoked once whenever accumulation converges.
+     * @param callback Callback receiving the final convergence stats.
+     */
+    void addConvergenceCallback(ConvergenceCallback callback) { mConvergenceCallbacks.push_back(std::move(callback)); }
+
+    /**
+     * Set the application state stored with periodic checkpoints.
+     * @param metadata Application state, returned by loadCheckpoint().
+     */
+    void setCheckpointMetadata(const Properties& metadata) { mCheckpointMetadata = metadata; }
+    const Properties& getCheckpointMetadata() const { return mCheckpointMetadata; }
+
+    /**
+     * Save the accumulation state to a checkpoint file.
+     * This reads back the accumulation buffers and waits for the GPU.
+     * The renderer's sample index is stored with the checkpoint if it has been published in the graph dictionary.
+     * @param path Checkpoint file path.
+     * @param metadata Application state to store with the checkpoint.
+     */
+    void saveCheckpoint(const std::filesystem::path& path, const Properties& metadata = {});
+
+    /**
+     * Load the accumulation state from a checkpoint file.
+     * The state is applied when the pass executes next, accumulation then continues from the stored frame.
+     * If the checkpoint stores a sample index, the next frame is discarded and the state is applied the frame after.
+     * Throws if the file is invalid.
+     * @param path Checkpoint file path.
+     * @return The metadata stored with the checkpoint.
+     */
+    Properties loadCheckpoint(const std::filesystem::path& path);
+
     enum class Precision : uint32_t
     {
         Double,            ///< Standard summation in double precision.
@@ -102,6 +169,11 @@ public:
 protected:
     void prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height);
     void accumulate(RenderContext* pRenderContext, const ref<Texture>& pSrc, const ref<Texture>& pDst);
+    void restoreCheckpoint(RenderContext* pRenderContext);
+    bool isConvergenceEnabled() const;
+    void estimateError(RenderContext* pRenderContext, const ref<Texture>& pDst);
+    void updateConvergence();
+    void applyErrorEstimate(uint32_t frameCount, const float* pTileError, size_t tileCount);
 
     // Internal state
 
@@ -128,6 +200,29 @@ protected:
     ref<Texture> mpLastFrameSumLo;
     /// Last frame running sum (hi bits). Used in Double mode.
     ref<Texture> mpLastFrameSumHi;
+    /// Last frame running sum of squared luminance. Used for convergence detection.
+    ref<Texture> mpLastFrameSqrSum;
+
+    /// Program estimating the relative error per tile.
+    ref<Program> mpErrorProgram;
+    ref<ProgramVars> mpErrorVars;
+    /// Per-tile relative error estimates.
+    ref<Buffer> mpTileError;
+    /// Readback of the per-tile error estimates. Estimates are picked up without waiting for the GPU.
+    std::unique_ptr<GpuReadbackRing> mpTileErrorRing;
+    /// Latest convergence stats.
+    ConvergenceStats mConvergenceStats;
+    /// Callbacks invoked upon convergence.
+    std::vector<ConvergenceCallback> mConvergenceCallbacks;
+
+    /// Checkpoint to restore at the next execute, if any.
+    std::unique_ptr<AccumulationCheckpoint> mpPendingCheckpoint;
+    /// True if the sample index of the pending checkpoint has been handed to the renderer.
+    bool mSampleIndexRestored = false;
+    /// Sample index of the next frame published by the renderer, if any.
+    std::optional<uint32_t> mSampleIndex;
+    /// Application state stored with periodic checkpoints.
+    Properties mCheckpointMetadata;
 
     // UI variables
 
@@ -142,6 +237,20 @@ protected:
     /// What to do after maximum number of frames are accumulated.
     OverflowMode mOverflowMode = OverflowMode::Stop;
 
+    /// Relative error of the pixel means below which accumulation is considered converged. 0 disables error estimation.
+    float mConvergenceThreshold = 0.f;
+    /// Minimum number of frames to accumulate before checking for convergence.
+    uint32_t mConvergenceMinFrames = 16;
+    /// Number of frames after which accumulation is considered converged regardless of the error. 0 means no limit.
+    uint32_t mConvergenceMaxFrames = 0;
+    /// Number of frames between error estimates.
+    uint32_t mConvergenceInterval = 16;
+
+    /// Checkpoint file path. Empty disables periodic checkpointing.
+    std::filesystem::path mCheckpointPath;
+    /// Number of frames between checkpoints. 0 disables periodic checkpointing.
+    uint32_t mCheckpointInterval = 0;
+
     /// Output format (uses default when set to ResourceFormat::Unknown).
     ResourceFormat mOutputFormat = ResourceFormat::Unknown;
     /// Selected output size.
@@ -164,8 +164,8 @@ void BSDFViewer::execute(RenderContext* pRenderContext, const RenderData& render
     if (mOptionsChanged)
     {
         auto& dict = renderData.getDictionary();
-        auto flags = dict.getValue(kRenderPassRefreshFlags, RenderPassRefreshFlags::None);
-        dict[Falcor::kRenderPassRefreshFlags] = flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged);
         mOptionsChanged = false;
     }
 
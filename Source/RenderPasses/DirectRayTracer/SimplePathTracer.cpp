@@ -104,8 +104,8 @@ void SimplePathTracer::execute(RenderContext* pRenderContext, const RenderData&
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, RenderPassRefreshFlags::None);
-        dict[Falcor::kRenderPassRefreshFlags] = flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged);
         mOptionsChanged = false;
     }
 
@@ -163,7 +163,7 @@ void SimplePathTracer::execute(RenderContext* pRenderContext, const RenderData&
     // Set constants.
     auto var = mTracer.pVars->getRootVar();
     var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gPRNGDimension"] = dict.keyExists(kRenderPassPRNGDimension) ? dict[kRenderPassPRNGDimension] : 0u;
+    var["CB"]["gPRNGDimension"] = dict.getValue(kRenderPassPRNGDimensionKey, 0u);
 
     // Bind I/O buffers. These needs to be done per-frame as the buffers may change anytime.
     auto bind = [&](const ChannelDesc& desc)
@@ -99,9 +99,17 @@ ErrorMeasurePass::ErrorMeasurePass(ref<Device> pDevice, const Properties& props)
     loadMeasurementsFile();
 
     mpParallelReduction = std::make_unique<ParallelReduction>(mpDevice);
+    mpReadbackRing = std::make_unique<GpuReadbackRing>(mpDevice, sizeof(float4));
     mpErrorMeasurerPass = ComputePass::create(mpDevice, kErrorComputationShaderFile);
 }
 
+ErrorMeasurePass::~ErrorMeasurePass()
+{
+    // Wait for the measurements still in flight so that they are written to the measurements file.
+    if (mpReadbackRing)
+        mpReadbackRing->flush();
+}
+
 Properties ErrorMeasurePass::getProperties() const
 {
     Properties props;
@@ -150,11 +158,14 @@ void ErrorMeasurePass::execute(RenderContext* pRenderContext, const RenderData&
         FALCOR_ASSERT(mpDifferenceTexture);
     }
 
-    mMeasurements.valid = false;
+    // Process the measurements of previous frames that are available by now.
+    mpReadbackRing->poll();
 
     ref<Texture> pReference = getReference(renderData);
     if (!pReference)
     {
+        mpReadbackRing->discard();
+        mMeasurements.valid = false;
         // We don't have a reference image, so just copy the source image to the output.
         pRenderContext->blit(pSourceImageTexture->getSRV(), pOutputImageTexture->getRTV());
         return;
@@ -177,8 +188,6 @@ void ErrorMeasurePass::execute(RenderContext* pRenderContext, const RenderData&
     default:
         FALCOR_THROW("ErrorMeasurePass: Unhandled OutputId case");
     }
-
-    saveMeasurementsToFile();
 }
 
 void ErrorMeasurePass::runDifferencePass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -206,11 +215,24 @@ void ErrorMeasurePass::runDifferencePass(RenderContext* pRenderContext, const Re
 
 void ErrorMeasurePass::runReductionPasses(RenderContext* pRenderContext, const RenderData& renderData)
 {
-    float4 error;
-    mpParallelReduction->execute(pRenderContext, mpDifferenceTexture, ParallelReduction::Type::Sum, &error);
+    // Reduce into a readback buffer and process the result once it is available, instead of stalling on the GPU.
+    const uint32_t slot = mpReadbackRing->acquire();
+    mpParallelReduction->execute<float4>(
+        pRenderContext, mpDifferenceTexture, ParallelReduction::Type::Sum, nullptr, mpReadbackRing->getBuffer(slot)
+    );
 
     const float pixelCountf = static_cast<float>(mpDifferenceTexture->getWidth() * mpDifferenceTexture->getHeight());
-    mMeasurements.error = error.xyz() / pixelCountf;
+    mpReadbackRing->submit(
+        slot,
+        mFrameCount++,
+        sizeof(float4),
+        [this, pixelCountf](uint64_t, const void* pData, size_t) { updateMeasurements(*static_cast<const float4*>(pData), pixelCountf); }
+    );
+}
+
+void ErrorMeasurePass::updateMeasurements(const float4& errorSum, float pixelCountf)
+{
+    mMeasurements.error = errorSum.xyz() / pixelCountf;
     mMeasurements.avgError = (mMeasurements.error.x + mMeasurements.error.y + mMeasurements.error.z) / 3.f;
     mMeasurements.valid = true;
 
@@ -225,6 +247,8 @@ void ErrorMeasurePass::runReductionPasses(RenderContext* pRenderContext, const R
         mRunningError = mRunningErrorSigma * mRunningError + (1 - mRunningErrorSigma) * mMeasurements.error;
         mRunningAvgError = mRunningErrorSigma * mRunningAvgError + (1 - mRunningErrorSigma) * mMeasurements.avgError;
     }
+
+    saveMeasurementsToFile();
 }
 
 void ErrorMeasurePass::renderUI(Gui::Widgets& widget)
@@ -370,6 +394,8 @@ bool ErrorMeasurePass::loadReference()
 
     mUseLoadedReference = mpReferenceTexture != nullptr;
     mRunningAvgError = -1.f; // Mark running error values as invalid.
+    if (mpReadbackRing)
+        mpReadbackRing->discard(); // Drop measurements against the previous reference.
     return true;
 }
 
@@ -383,6 +409,10 @@ bool ErrorMeasurePass::loadMeasurementsFile()
     if (mMeasurementsFilePath.empty())
         return false;
 
+    // Measurements in flight belong to the previous file.
+    if (mpReadbackRing)
+        mpReadbackRing->flush();
+
     mMeasurementsFile = std::ofstream(mMeasurementsFilePath, std::ios::trunc);
     if (!mMeasurementsFile)
     {
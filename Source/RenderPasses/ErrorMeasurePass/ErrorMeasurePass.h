@@ -29,6 +29,7 @@
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
 #include "Utils/Algorithm/ParallelReduction.h"
+#include "Utils/GpuReadbackRing.h"
 #include <fstream>
 
 using namespace Falcor;
@@ -58,6 +59,7 @@ public:
     static ref<ErrorMeasurePass> create(ref<Device> pDevice, const Properties& props) { return make_ref<ErrorMeasurePass>(pDevice, props); }
 
     ErrorMeasurePass(ref<Device> pDevice, const Properties& props);
+    virtual ~ErrorMeasurePass() override;
 
     virtual Properties getProperties() const override;
     virtual RenderPassReflection reflect(const CompileData& compileData) override;
@@ -73,9 +75,12 @@ private:
 
     void runDifferencePass(RenderContext* pRenderContext, const RenderData& renderData);
     void runReductionPasses(RenderContext* pRenderContext, const RenderData& renderData);
+    void updateMeasurements(const float4& errorSum, float pixelCount);
 
     ref<ComputePass> mpErrorMeasurerPass;
     std::unique_ptr<ParallelReduction> mpParallelReduction;
+    /// Readback of the reduction results. Measurements lag a few frames behind the rendered frame.
+    std::unique_ptr<GpuReadbackRing> mpReadbackRing;
 
     struct
     {
@@ -86,6 +91,8 @@ private:
 
     // Internal state
 
+    /// Number of frames with error measurements. Used for tagging readbacks.
+    uint64_t mFrameCount = 0;
     float3 mRunningError = float3(0.f, 0.f, 0.f);
     /// A negative value indicates that both running error values are invalid.
     float mRunningAvgError = -1.f;
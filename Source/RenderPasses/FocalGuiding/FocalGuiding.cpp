@@ -36,6 +36,11 @@ const ChannelList kOutputChannels = {
 const char kMaxBounces[] = "maxBounces";
 const char kComputeDirect[] = "computeDirect";
 const char kUseImportanceSampling[] = "useImportanceSampling";
+const char kPixelDebugPrintCapacity[] = "pixelDebugPrintCapacity";
+const char kPixelDebugAssertCapacity[] = "pixelDebugAssertCapacity";
+
+// Number of print() statements per pixel in the shader, used to size the print buffer for the selected pixels.
+const uint32_t kPixelDebugPrintsPerPixel = 1;
 } // namespace
 
 FocalGuiding::FocalGuiding(ref<Device> pDevice, const Properties& props)
@@ -46,6 +51,9 @@ FocalGuiding::FocalGuiding(ref<Device> pDevice, const Properties& props)
     // Create a sample generator.
     mpSampleGenerator = SampleGenerator::create(mpDevice, SAMPLE_GENERATOR_UNIFORM);
     FALCOR_ASSERT(mpSampleGenerator);
+
+    mpPixelDebug = std::make_unique<PixelDebug>(mpDevice, mPixelDebugPrintCapacity, mPixelDebugAssertCapacity);
+    mpPixelDebug->setPrintsPerPixel(kPixelDebugPrintsPerPixel);
 }
 
 void FocalGuiding::parseProperties(const Properties& props)
@@ -58,6 +66,10 @@ void FocalGuiding::parseProperties(const Properties& props)
             mComputeDirect = value;
         else if (key == kUseImportanceSampling)
             mUseImportanceSampling = value;
+        else if (key == kPixelDebugPrintCapacity)
+            mPixelDebugPrintCapacity = value;
+        else if (key == kPixelDebugAssertCapacity)
+            mPixelDebugAssertCapacity = value;
         else
             logWarning("Unknown property '{}' in FocalGuiding properties.", key);
     }
@@ -69,6 +81,8 @@ Properties FocalGuiding::getProperties() const
     props[kMaxBounces] = mMaxBounces;
     props[kComputeDirect] = mComputeDirect;
     props[kUseImportanceSampling] = mUseImportanceSampling;
+    props[kPixelDebugPrintCapacity] = mpPixelDebug->getPrintCapacity();
+    props[kPixelDebugAssertCapacity] = mpPixelDebug->getAssertCapacity();
     return props;
 }
 
@@ -89,8 +103,8 @@ void FocalGuiding::execute(RenderContext* pRenderContext, const RenderData& rend
     Dictionary& dict = renderData.getDictionary();
     if (mOptionsChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, RenderPassRefreshFlags::None);
-        dict[Falcor::kRenderPassRefreshFlags] = flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged);
         mOptionsChanged = false;
     }
 
@@ -157,7 +171,7 @@ void FocalGuiding::execute(RenderContext* pRenderContext, const RenderData& rend
     var["CB"]["gSceneBoundsMin"] = mpScene->getSceneBounds().minPoint;
     var["CB"]["gSceneBoundsMax"] = mpScene->getSceneBounds().maxPoint;
     var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gPRNGDimension"] = dict.keyExists(kRenderPassPRNGDimension) ? dict[kRenderPassPRNGDimension] : 0u;
+    var["CB"]["gPRNGDimension"] = dict.getValue(kRenderPassPRNGDimensionKey, 0u);
     var["CB"]["gGuidedRayProb"] = mGuidedRayProb;
 
     // renderData holds the requested resources
@@ -185,9 +199,14 @@ void FocalGuiding::execute(RenderContext* pRenderContext, const RenderData& rend
     const uint2 targetDim = renderData.getDefaultTextureDims();
     FALCOR_ASSERT(targetDim.x > 0 && targetDim.y > 0);
 
+    mpPixelDebug->beginFrame(pRenderContext, targetDim);
+    mpPixelDebug->prepareProgram(mTracer.pProgram, var);
+
     // Spawn the rays.
     mpScene->raytrace(pRenderContext, mTracer.pProgram.get(), mTracer.pVars, uint3(targetDim, 1));
 
+    mpPixelDebug->endFrame(pRenderContext);
+
     mFrameCount++;
 }
 
@@ -207,6 +226,11 @@ void FocalGuiding::renderUI(Gui::Widgets& widget)
     dirty |= widget.checkbox("Use importance sampling", mUseImportanceSampling);
     widget.tooltip("Use importance sampling for materials", true);
 
+    if (auto group = widget.group("Debugging"))
+    {
+        mpPixelDebug->renderUI(group);
+    }
+
     // If rendering options that modify the output have changed, set flag to indicate that.
     // In execute() we will pass the flag to other passes for reset of temporal data etc.
     if (dirty)
@@ -215,6 +239,11 @@ void FocalGuiding::renderUI(Gui::Widgets& widget)
     }
 }
 
+bool FocalGuiding::onMouseEvent(const MouseEvent& mouseEvent)
+{
+    return mpPixelDebug->onMouseEvent(mouseEvent);
+}
+
 void FocalGuiding::setScene(RenderContext* pRenderContext, const ref<Scene>& pScene)
 {
     // Clear data for previous scene.
@@ -1,6 +1,7 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
+#include "Utils/Debug/PixelDebug.h"
 
 #include "DensityNode.h"
 
@@ -21,7 +22,7 @@ public:
     virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
     virtual void renderUI(Gui::Widgets& widget) override;
     virtual void setScene(RenderContext* pRenderContext, const ref<Scene>& pScene) override;
-    virtual bool onMouseEvent(const MouseEvent& mouseEvent) override { return false; }
+    virtual bool onMouseEvent(const MouseEvent& mouseEvent) override;
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
 private:
@@ -31,6 +32,7 @@ private:
     // Internal state
     ref<Scene> mpScene; ///< Current scene.
     ref<SampleGenerator> mpSampleGenerator; ///< GPU sample generator.
+    std::unique_ptr<PixelDebug> mpPixelDebug; ///< Utility class for pixel debugging (print in shaders).
     ref<Buffer> mNodes;
     ref<ParameterBlock> mpNodesBlock;
 
@@ -41,6 +43,8 @@ private:
     uint mMaxBounces = 3;               ///< Max number of indirect bounces (0 = none).
     bool mComputeDirect = true;         ///< Compute direct illumination (otherwise indirect only).
     bool mUseImportanceSampling = true; ///< Use importance sampling for materials.
+    uint mPixelDebugPrintCapacity = 256;  ///< Initial capacity of the PixelDebug print buffer (a 16x16 region).
+    uint mPixelDebugAssertCapacity = 256; ///< Initial capacity of the PixelDebug assert buffer.
 
     // Runtime data
     uint mFrameCount = 0; ///< Frame count since scene was loaded.
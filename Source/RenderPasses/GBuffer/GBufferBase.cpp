@@ -164,14 +164,14 @@ void GBufferBase::execute(RenderContext* pRenderContext, const RenderData& rende
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, RenderPassRefreshFlags::None);
-        dict[Falcor::kRenderPassRefreshFlags] = flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, RenderPassRefreshFlags::None);
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags | Falcor::RenderPassRefreshFlags::RenderOptionsChanged);
         mOptionsChanged = false;
     }
 
     // Pass flag for adjust shading normals to subsequent passes via the dictionary.
     // Adjusted shading normals cannot be passed via the VBuffer, so this flag allows consuming passes to compute them when enabled.
-    dict[Falcor::kRenderPassGBufferAdjustShadingNormals] = mAdjustShadingNormals;
+    dict.setValue(Falcor::kRenderPassGBufferAdjustShadingNormalsKey, mAdjustShadingNormals);
 }
 
 void GBufferBase::setScene(RenderContext* pRenderContext, const ref<Scene>& pScene)
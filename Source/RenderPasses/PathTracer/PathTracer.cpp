@@ -78,6 +78,38 @@ namespace
     const std::string kOutputNRDDeltaTransmissionPosW = "nrdDeltaTransmissionPosW";
     const std::string kOutputNRDResidualRadianceHitDist = "nrdResidualRadianceHitDist";
 
+    // Interned IDs of the fields looked up every frame.
+    const RenderData::ResourceID kInputVBufferID{kInputVBuffer};
+    const RenderData::ResourceID kInputMotionVectorsID{kInputMotionVectors};
+    const RenderData::ResourceID kInputViewDirID{kInputViewDir};
+    const RenderData::ResourceID kInputSampleCountID{kInputSampleCount};
+    const RenderData::ResourceID kOutputColorID{kOutputColor};
+    const RenderData::ResourceID kOutputAlbedoID{kOutputAlbedo};
+    const RenderData::ResourceID kOutputSpecularAlbedoID{kOutputSpecularAlbedo};
+    const RenderData::ResourceID kOutputIndirectAlbedoID{kOutputIndirectAlbedo};
+    const RenderData::ResourceID kOutputGuideNormalID{kOutputGuideNormal};
+    const RenderData::ResourceID kOutputReflectionPosWID{kOutputReflectionPosW};
+    const RenderData::ResourceID kOutputRayCountID{kOutputRayCount};
+    const RenderData::ResourceID kOutputPathLengthID{kOutputPathLength};
+    const RenderData::ResourceID kOutputNRDDiffuseRadianceHitDistID{kOutputNRDDiffuseRadianceHitDist};
+    const RenderData::ResourceID kOutputNRDSpecularRadianceHitDistID{kOutputNRDSpecularRadianceHitDist};
+    const RenderData::ResourceID kOutputNRDEmissionID{kOutputNRDEmission};
+    const RenderData::ResourceID kOutputNRDDiffuseReflectanceID{kOutputNRDDiffuseReflectance};
+    const RenderData::ResourceID kOutputNRDSpecularReflectanceID{kOutputNRDSpecularReflectance};
+    const RenderData::ResourceID kOutputNRDDeltaReflectionRadianceHitDistID{kOutputNRDDeltaReflectionRadianceHitDist};
+    const RenderData::ResourceID kOutputNRDDeltaReflectionReflectanceID{kOutputNRDDeltaReflectionReflectance};
+    const RenderData::ResourceID kOutputNRDDeltaReflectionEmissionID{kOutputNRDDeltaReflectionEmission};
+    const RenderData::ResourceID kOutputNRDDeltaReflectionNormWRoughMaterialIDID{kOutputNRDDeltaReflectionNormWRoughMaterialID};
+    const RenderData::ResourceID kOutputNRDDeltaReflectionPathLengthID{kOutputNRDDeltaReflectionPathLength};
+    const RenderData::ResourceID kOutputNRDDeltaReflectionHitDistID{kOutputNRDDeltaReflectionHitDist};
+    const RenderData::ResourceID kOutputNRDDeltaTransmissionRadianceHitDistID{kOutputNRDDeltaTransmissionRadianceHitDist};
+    const RenderData::ResourceID kOutputNRDDeltaTransmissionReflectanceID{kOutputNRDDeltaTransmissionReflectance};
+    const RenderData::ResourceID kOutputNRDDeltaTransmissionEmissionID{kOutputNRDDeltaTransmissionEmission};
+    const RenderData::ResourceID kOutputNRDDeltaTransmissionNormWRoughMaterialIDID{kOutputNRDDeltaTransmissionNormWRoughMaterialID};
+    const RenderData::ResourceID kOutputNRDDeltaTransmissionPathLengthID{kOutputNRDDeltaTransmissionPathLength};
+    const RenderData::ResourceID kOutputNRDDeltaTransmissionPosWID{kOutputNRDDeltaTransmissionPosW};
+    const RenderData::ResourceID kOutputNRDResidualRadianceHitDistID{kOutputNRDResidualRadianceHitDist};
+
     const Falcor::ChannelList kOutputChannels =
     {
         { kOutputColor,                                     "",     "Output color (linear)", true /* optional */, ResourceFormat::RGBA32Float },
@@ -111,6 +143,7 @@ namespace
 
     // Scripting options.
     const std::string kSamplesPerPixel = "samplesPerPixel";
+    const std::string kUseAdaptiveSampling = "useAdaptiveSampling";
     const std::string kMaxSurfaceBounces = "maxSurfaceBounces";
     const std::string kMaxDiffuseBounces = "maxDiffuseBounces";
     const std::string kMaxSpecularBounces = "maxSpecularBounces";
@@ -158,6 +191,7 @@ void PathTracer::registerBindings(pybind11::module& m)
     pybind11::class_<PathTracer, RenderPass, ref<PathTracer>> pass(m, "PathTracer");
     pass.def("reset", &PathTracer::reset);
     pass.def_property_readonly("pixelStats", &PathTracer::getPixelStats);
+    pass.def_property_readonly("adaptiveSampling", &PathTracer::getAdaptiveSampling);
 
     pass.def_property("useFixedSeed",
         [](const PathTracer* pt) { return pt->mParams.useFixedSeed ? true : false; },
@@ -192,6 +226,7 @@ PathTracer::PathTracer(ref<Device> pDevice, const Properties& props)
     // Note: The other programs are lazily created in updatePrograms() because a scene needs to be present when creating them.
 
     mpPixelStats = std::make_unique<PixelStats>(mpDevice);
+    mpAdaptiveSampling = std::make_unique<AdaptiveSampling>(mpDevice);
     mpPixelDebug = std::make_unique<PixelDebug>(mpDevice);
 }
 
@@ -213,6 +248,7 @@ void PathTracer::parseProperties(const Properties& props)
     {
         // Rendering parameters
         if (key == kSamplesPerPixel) mStaticParams.samplesPerPixel = value;
+        else if (key == kUseAdaptiveSampling) mUseAdaptiveSampling = value;
         else if (key == kMaxSurfaceBounces) mStaticParams.maxSurfaceBounces = value;
         else if (key == kMaxDiffuseBounces) mStaticParams.maxDiffuseBounces = value;
         else if (key == kMaxSpecularBounces) mStaticParams.maxSpecularBounces = value;
@@ -338,6 +374,7 @@ Properties PathTracer::getProperties() const
 
     // Rendering parameters
     props[kSamplesPerPixel] = mStaticParams.samplesPerPixel;
+    props[kUseAdaptiveSampling] = mUseAdaptiveSampling;
     props[kMaxSurfaceBounces] = mStaticParams.maxSurfaceBounces;
     props[kMaxDiffuseBounces] = mStaticParams.maxDiffuseBounces;
     props[kMaxSpecularBounces] = mStaticParams.maxSpecularBounces;
@@ -391,10 +428,11 @@ RenderPassReflection PathTracer::reflect(const CompileData& compileData)
     return reflector;
 }
 
-void PathTracer::setFrameDim(const uint2 frameDim)
+void PathTracer::setFrameDim(const uint2 frameDim, const RenderTile& renderTile)
 {
     auto prevFrameDim = mParams.frameDim;
-    auto prevScreenTiles = mParams.screenTiles;
+    auto prevRegionStart = mParams.renderRegionStart;
+    auto prevRegionEnd = mParams.renderRegionEnd;
 
     mParams.frameDim = frameDim;
     if (mParams.frameDim.x > kMaxFrameDimension || mParams.frameDim.y > kMaxFrameDimension)
@@ -402,15 +440,31 @@ void PathTracer::setFrameDim(const uint2 frameDim)
         FALCOR_THROW("Frame dimensions up to {} pixels width/height are supported.", kMaxFrameDimension);
     }
 
+    // Set the region to render, clipped to the frame. An empty tile renders the whole frame.
+    mParams.renderRegionStart = renderTile.isEmpty() ? uint2(0) : renderTile.offset;
+    mParams.renderRegionEnd = renderTile.isEmpty() ? mParams.frameDim : min(renderTile.getEnd(), mParams.frameDim);
+    if (any(mParams.renderRegionStart >= mParams.renderRegionEnd))
+    {
+        FALCOR_THROW("Render tile ({}, {}) - ({}, {}) doesn't overlap the frame.", renderTile.offset.x, renderTile.offset.y, renderTile.getEnd().x, renderTile.getEnd().y);
+    }
+
     // Tile dimensions have to be powers-of-two.
+    // The sample buffers only hold the screen-tiles overlapping the render region.
     FALCOR_ASSERT(isPowerOf2(kScreenTileDim.x) && isPowerOf2(kScreenTileDim.y));
     FALCOR_ASSERT(kScreenTileDim.x == (1 << kScreenTileBits.x) && kScreenTileDim.y == (1 << kScreenTileBits.y));
-    mParams.screenTiles = div_round_up(mParams.frameDim, kScreenTileDim);
+    mParams.screenTiles = div_round_up(mParams.renderRegionEnd, kScreenTileDim) - mParams.renderRegionStart / kScreenTileDim;
 
-    if (any(mParams.frameDim != prevFrameDim) || any(mParams.screenTiles != prevScreenTiles))
+    // Resources are sized for the frame, the sample buffers grow on demand if the render region changes.
+    if (any(mParams.frameDim != prevFrameDim))
     {
         mVarsChanged = true;
     }
+
+    // Pixels outside the render region are not updated. Notify other passes (e.g. accumulation) that the output changed.
+    if (any(mParams.renderRegionStart != prevRegionStart) || any(mParams.renderRegionEnd != prevRegionEnd))
+    {
+        mOptionsChanged = true;
+    }
 }
 
 void PathTracer::setScene(RenderContext* pRenderContext, const ref<Scene>& pScene)
@@ -419,6 +473,8 @@ void PathTracer::setScene(RenderContext* pRenderContext, const ref<Scene>& pScen
     mParams.frameCount = 0;
     mParams.frameDim = {};
     mParams.screenTiles = {};
+    mParams.renderRegionStart = {};
+    mParams.renderRegionEnd = {};
 
     // Need to recreate the RTXDI module when the scene changes.
     mpRTXDI = nullptr;
@@ -457,7 +513,7 @@ void PathTracer::execute(RenderContext* pRenderContext, const RenderData& render
     // Update RTXDI.
     if (mpRTXDI)
     {
-        const auto& pMotionVectors = renderData.getTexture(kInputMotionVectors);
+        const auto& pMotionVectors = renderData.getTexture(kInputMotionVectorsID);
         mpRTXDI->update(pRenderContext, pMotionVectors);
     }
 
@@ -510,6 +566,17 @@ bool PathTracer::renderRenderingUI(Gui::Widgets& widget)
     widget.tooltip("Number of samples per pixel. One path is traced for each sample.\n\n"
         "When the '" + kInputSampleCount + "' input is connected, the number of samples per pixel is loaded from the texture.");
 
+    dirty |= widget.checkbox("Adaptive sampling", mUseAdaptiveSampling);
+    widget.tooltip("Distributes samples based on the estimated relative error of each pixel. Converged pixels receive a single sample.\n\n"
+        "This option is ignored when the '" + kInputSampleCount + "' input is connected.");
+    if (mpAdaptiveSampling->isEnabled())
+    {
+        if (auto group = widget.group("Adaptive sampling options"))
+        {
+            mpAdaptiveSampling->renderUI(group);
+        }
+    }
+
     if (widget.var("Max surface bounces", mStaticParams.maxSurfaceBounces, 0u, kMaxBounces))
     {
         // Allow users to change the max surface bounce parameter in the UI to clamp all other surface bounce parameters.
@@ -686,6 +753,14 @@ bool PathTracer::onMouseEvent(const MouseEvent& mouseEvent)
 void PathTracer::reset()
 {
     mParams.frameCount = 0;
+    mpAdaptiveSampling->reset();
+}
+
+ref<Texture> PathTracer::getSampleCountTexture(const RenderData& renderData) const
+{
+    // The sample count input takes precedence over the adaptive sampling map.
+    if (auto pSampleCount = renderData.getTexture(kInputSampleCountID)) return pSampleCount;
+    return mpAdaptiveSampling->isEnabled() ? mpAdaptiveSampling->getSampleCountTexture() : nullptr;
 }
 
 PathTracer::TracePass::TracePass(ref<Device> pDevice, const std::string& name, const std::string& passDefine, const ref<Scene>& pScene, const DefineList& defines, const TypeConformanceList& globalTypeConformances)
@@ -846,11 +921,20 @@ void PathTracer::updatePrograms()
 void PathTracer::prepareResources(RenderContext* pRenderContext, const RenderData& renderData)
 {
     // Compute allocation requirements for paths and output samples.
-    // Note that the sample buffers are padded to whole tiles, while the max path count depends on actual frame dimension.
+    // Note that the sample buffers are padded to whole tiles covering the render region, while the max path count depends on actual frame dimension.
     // If we don't have a fixed sample count, assume the worst case.
     uint32_t spp = mFixedSampleCount ? mStaticParams.samplesPerPixel : kMaxSamplesPerPixel;
     uint32_t tileCount = mParams.screenTiles.x * mParams.screenTiles.y;
-    const uint32_t sampleCount = tileCount * kScreenTileDim.x * kScreenTileDim.y * spp;
+    // The sample count overflows 32 bits for large frames, so it's computed in 64 bits and checked.
+    const uint64_t sampleCount64 = uint64_t(tileCount) * kScreenTileDim.x * kScreenTileDim.y * spp;
+    FALCOR_CHECK(
+        sampleCount64 <= std::numeric_limits<uint32_t>::max(),
+        "Render region of {}x{} pixels at {} spp exceeds the sample buffer limit. Use a render tile to render the frame in parts.",
+        mParams.renderRegionEnd.x - mParams.renderRegionStart.x,
+        mParams.renderRegionEnd.y - mParams.renderRegionStart.y,
+        spp
+    );
+    const uint32_t sampleCount = (uint32_t)sampleCount64;
     const uint32_t screenPixelCount = mParams.frameDim.x * mParams.frameDim.y;
     const uint32_t pathCount = screenPixelCount * spp;
 
@@ -1063,19 +1147,19 @@ void PathTracer::setNRDData(const ShaderVar& var, const RenderData& renderData)
     var["samplePrimaryHitNEEOnDelta"] = mpSampleNRDPrimaryHitNeeOnDelta;
     var["sampleEmission"] = mpSampleNRDEmission;
     var["sampleReflectance"] = mpSampleNRDReflectance;
-    var["primaryHitEmission"] = renderData.getTexture(kOutputNRDEmission);
-    var["primaryHitDiffuseReflectance"] = renderData.getTexture(kOutputNRDDiffuseReflectance);
-    var["primaryHitSpecularReflectance"] = renderData.getTexture(kOutputNRDSpecularReflectance);
-    var["deltaReflectionReflectance"] = renderData.getTexture(kOutputNRDDeltaReflectionReflectance);
-    var["deltaReflectionEmission"] = renderData.getTexture(kOutputNRDDeltaReflectionEmission);
-    var["deltaReflectionNormWRoughMaterialID"] = renderData.getTexture(kOutputNRDDeltaReflectionNormWRoughMaterialID);
-    var["deltaReflectionPathLength"] = renderData.getTexture(kOutputNRDDeltaReflectionPathLength);
-    var["deltaReflectionHitDist"] = renderData.getTexture(kOutputNRDDeltaReflectionHitDist);
-    var["deltaTransmissionReflectance"] = renderData.getTexture(kOutputNRDDeltaTransmissionReflectance);
-    var["deltaTransmissionEmission"] = renderData.getTexture(kOutputNRDDeltaTransmissionEmission);
-    var["deltaTransmissionNormWRoughMaterialID"] = renderData.getTexture(kOutputNRDDeltaTransmissionNormWRoughMaterialID);
-    var["deltaTransmissionPathLength"] = renderData.getTexture(kOutputNRDDeltaTransmissionPathLength);
-    var["deltaTransmissionPosW"] = renderData.getTexture(kOutputNRDDeltaTransmissionPosW);
+    var["primaryHitEmission"] = renderData.getTexture(kOutputNRDEmissionID);
+    var["primaryHitDiffuseReflectance"] = renderData.getTexture(kOutputNRDDiffuseReflectanceID);
+    var["primaryHitSpecularReflectance"] = renderData.getTexture(kOutputNRDSpecularReflectanceID);
+    var["deltaReflectionReflectance"] = renderData.getTexture(kOutputNRDDeltaReflectionReflectanceID);
+    var["deltaReflectionEmission"] = renderData.getTexture(kOutputNRDDeltaReflectionEmissionID);
+    var["deltaReflectionNormWRoughMaterialID"] = renderData.getTexture(kOutputNRDDeltaReflectionNormWRoughMaterialIDID);
+    var["deltaReflectionPathLength"] = renderData.getTexture(kOutputNRDDeltaReflectionPathLengthID);
+    var["deltaReflectionHitDist"] = renderData.getTexture(kOutputNRDDeltaReflectionHitDistID);
+    var["deltaTransmissionReflectance"] = renderData.getTexture(kOutputNRDDeltaTransmissionReflectanceID);
+    var["deltaTransmissionEmission"] = renderData.getTexture(kOutputNRDDeltaTransmissionEmissionID);
+    var["deltaTransmissionNormWRoughMaterialID"] = renderData.getTexture(kOutputNRDDeltaTransmissionNormWRoughMaterialIDID);
+    var["deltaTransmissionPathLength"] = renderData.getTexture(kOutputNRDDeltaTransmissionPathLengthID);
+    var["deltaTransmissionPosW"] = renderData.getTexture(kOutputNRDDeltaTransmissionPosWID);
 }
 
 void PathTracer::bindShaderData(const ShaderVar& var, const RenderData& renderData, bool useLightSampling) const
@@ -1096,22 +1180,22 @@ void PathTracer::bindShaderData(const ShaderVar& var, const RenderData& renderDa
     ref<Texture> pViewDir;
     if (mpScene->getCamera()->getApertureRadius() > 0.f)
     {
-        pViewDir = renderData.getTexture(kInputViewDir);
+        pViewDir = renderData.getTexture(kInputViewDirID);
         if (!pViewDir) logWarning("Depth-of-field requires the '{}' input. Expect incorrect rendering.", kInputViewDir);
     }
 
     ref<Texture> pSampleCount;
     if (!mFixedSampleCount)
     {
-        pSampleCount = renderData.getTexture(kInputSampleCount);
+        pSampleCount = getSampleCountTexture(renderData);
         if (!pSampleCount) FALCOR_THROW("PathTracer: Missing sample count input texture");
     }
 
     var["params"].setBlob(mParams);
-    var["vbuffer"] = renderData.getTexture(kInputVBuffer);
+    var["vbuffer"] = renderData.getTexture(kInputVBufferID);
     var["viewDir"] = pViewDir; // Can be nullptr
     var["sampleCount"] = pSampleCount; // Can be nullptr
-    var["outputColor"] = renderData.getTexture(kOutputColor);
+    var["outputColor"] = renderData.getTexture(kOutputColorID);
 
     if (useLightSampling && mpEmissiveSampler)
     {
@@ -1122,11 +1206,12 @@ void PathTracer::bindShaderData(const ShaderVar& var, const RenderData& renderDa
 
 bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& renderData)
 {
-    const auto& pOutputColor = renderData.getTexture(kOutputColor);
+    const auto& pOutputColor = renderData.getTexture(kOutputColorID);
     FALCOR_ASSERT(pOutputColor);
 
-    // Set output frame dimension.
-    setFrameDim(uint2(pOutputColor->getWidth(), pOutputColor->getHeight()));
+    // Set output frame dimension and the region to render.
+    const RenderTile renderTile = renderData.getDictionary().getValue(kRenderPassTileKey, RenderTile());
+    setFrameDim(uint2(pOutputColor->getWidth(), pOutputColor->getHeight()), renderTile);
 
     // Validate all I/O sizes match the expected size.
     // If not, we'll disable the path tracer to give the user a chance to fix the configuration before re-enabling it.
@@ -1156,9 +1241,9 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
         if (mOptionsChanged)
         {
             auto& dict = renderData.getDictionary();
-            auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+            auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
             if (mOptionsChanged) flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
-            dict[Falcor::kRenderPassRefreshFlags] = flags;
+            dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         }
 
         return false;
@@ -1175,18 +1260,19 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
     if (mpRTXDI) mpRTXDI->beginFrame(pRenderContext, mParams.frameDim);
 
     // Update refresh flag if changes that affect the output have occured.
+    const bool optionsChanged = mOptionsChanged;
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged || lightingChanged)
     {
-        auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
+        auto flags = dict.getValue(kRenderPassRefreshFlagsKey, Falcor::RenderPassRefreshFlags::None);
         if (mOptionsChanged) flags |= Falcor::RenderPassRefreshFlags::RenderOptionsChanged;
         if (lightingChanged) flags |= Falcor::RenderPassRefreshFlags::LightingChanged;
-        dict[Falcor::kRenderPassRefreshFlags] = flags;
+        dict.setValue(Falcor::kRenderPassRefreshFlagsKey, flags);
         mOptionsChanged = false;
     }
 
     // Check if GBuffer has adjusted shading normals enabled.
-    bool gbufferAdjustShadingNormals = dict.getValue(Falcor::kRenderPassGBufferAdjustShadingNormals, false);
+    bool gbufferAdjustShadingNormals = dict.getValue(Falcor::kRenderPassGBufferAdjustShadingNormalsKey, false);
     if (gbufferAdjustShadingNormals != mGBufferAdjustShadingNormals)
     {
         mGBufferAdjustShadingNormals = gbufferAdjustShadingNormals;
@@ -1194,41 +1280,67 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
     }
 
     // Check if fixed sample count should be used. When the sample count input is connected we load the count from there instead.
-    mFixedSampleCount = renderData[kInputSampleCount] == nullptr;
+    // Otherwise, if adaptive sampling is enabled, the count is loaded from the adaptive sampling map.
+    const bool useAdaptiveSampling = mUseAdaptiveSampling && renderData[kInputSampleCountID] == nullptr;
+    const bool fixedSampleCount = renderData[kInputSampleCountID] == nullptr && !useAdaptiveSampling;
+    if (fixedSampleCount != mFixedSampleCount) mRecompile = true;
+    mFixedSampleCount = fixedSampleCount;
+
+    // Reset the adaptive sampling statistics upon changes that affect the output.
+    // Camera jitter and history changes are excluded as they are part of the integration.
+    mpAdaptiveSampling->setEnabled(useAdaptiveSampling);
+    if (useAdaptiveSampling)
+    {
+        // The path tracer supports at most kMaxSamplesPerPixel samples per pixel.
+        if (mpAdaptiveSampling->getParams().maxSamplesPerPixel > kMaxSamplesPerPixel)
+        {
+            auto params = mpAdaptiveSampling->getParams();
+            params.maxSamplesPerPixel = kMaxSamplesPerPixel;
+            mpAdaptiveSampling->setParams(params);
+        }
+
+        auto sceneUpdates = mpScene->getUpdates();
+        auto cameraChanges = mpScene->getCamera()->getChanges() & ~(Camera::Changes::Jitter | Camera::Changes::History);
+        if (optionsChanged || lightingChanged || (sceneUpdates & ~Scene::UpdateFlags::CameraPropertiesChanged) != Scene::UpdateFlags::None || cameraChanges != Camera::Changes::None)
+        {
+            mpAdaptiveSampling->reset();
+        }
+        mpAdaptiveSampling->beginFrame(pRenderContext, mParams.frameDim);
+    }
 
     // Check if guide data should be generated.
-    mOutputGuideData = renderData[kOutputAlbedo] != nullptr || renderData[kOutputSpecularAlbedo] != nullptr
-        || renderData[kOutputIndirectAlbedo] != nullptr || renderData[kOutputGuideNormal] != nullptr
-        || renderData[kOutputReflectionPosW] != nullptr;
+    mOutputGuideData = renderData[kOutputAlbedoID] != nullptr || renderData[kOutputSpecularAlbedoID] != nullptr
+        || renderData[kOutputIndirectAlbedoID] != nullptr || renderData[kOutputGuideNormalID] != nullptr
+        || renderData[kOutputReflectionPosWID] != nullptr;
 
     // Check if NRD data should be generated.
     mOutputNRDData =
-        renderData[kOutputNRDDiffuseRadianceHitDist] != nullptr
-        || renderData[kOutputNRDSpecularRadianceHitDist] != nullptr
-        || renderData[kOutputNRDResidualRadianceHitDist] != nullptr
-        || renderData[kOutputNRDEmission] != nullptr
-        || renderData[kOutputNRDDiffuseReflectance] != nullptr
-        || renderData[kOutputNRDSpecularReflectance] != nullptr;
+        renderData[kOutputNRDDiffuseRadianceHitDistID] != nullptr
+        || renderData[kOutputNRDSpecularRadianceHitDistID] != nullptr
+        || renderData[kOutputNRDResidualRadianceHitDistID] != nullptr
+        || renderData[kOutputNRDEmissionID] != nullptr
+        || renderData[kOutputNRDDiffuseReflectanceID] != nullptr
+        || renderData[kOutputNRDSpecularReflectanceID] != nullptr;
 
     // Check if additional NRD data should be generated.
     bool prevOutputNRDAdditionalData = mOutputNRDAdditionalData;
     mOutputNRDAdditionalData =
-        renderData[kOutputNRDDeltaReflectionRadianceHitDist] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionRadianceHitDist] != nullptr
-        || renderData[kOutputNRDDeltaReflectionReflectance] != nullptr
-        || renderData[kOutputNRDDeltaReflectionEmission] != nullptr
-        || renderData[kOutputNRDDeltaReflectionNormWRoughMaterialID] != nullptr
-        || renderData[kOutputNRDDeltaReflectionPathLength] != nullptr
-        || renderData[kOutputNRDDeltaReflectionHitDist] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionReflectance] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionEmission] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionNormWRoughMaterialID] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionPathLength] != nullptr
-        || renderData[kOutputNRDDeltaTransmissionPosW] != nullptr;
+        renderData[kOutputNRDDeltaReflectionRadianceHitDistID] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionRadianceHitDistID] != nullptr
+        || renderData[kOutputNRDDeltaReflectionReflectanceID] != nullptr
+        || renderData[kOutputNRDDeltaReflectionEmissionID] != nullptr
+        || renderData[kOutputNRDDeltaReflectionNormWRoughMaterialIDID] != nullptr
+        || renderData[kOutputNRDDeltaReflectionPathLengthID] != nullptr
+        || renderData[kOutputNRDDeltaReflectionHitDistID] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionReflectanceID] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionEmissionID] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionNormWRoughMaterialIDID] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionPathLengthID] != nullptr
+        || renderData[kOutputNRDDeltaTransmissionPosWID] != nullptr;
     if (mOutputNRDAdditionalData != prevOutputNRDAdditionalData) mRecompile = true;
 
     // Enable pixel stats if rayCount or pathLength outputs are connected.
-    if (renderData[kOutputRayCount] != nullptr || renderData[kOutputPathLength] != nullptr)
+    if (renderData[kOutputRayCountID] != nullptr || renderData[kOutputPathLengthID] != nullptr)
     {
         mpPixelStats->setEnabled(true);
     }
@@ -1236,6 +1348,12 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
     mpPixelStats->beginFrame(pRenderContext, mParams.frameDim);
     mpPixelDebug->beginFrame(pRenderContext, mParams.frameDim);
 
+    // Continue the pseudorandom sequence from a sample index set by another pass, e.g. when accumulation is resumed from a checkpoint.
+    if (const uint32_t* pSampleIndex = dict.tryGetValue(kRenderPassSampleIndexKey); pSampleIndex && *pSampleIndex != mPublishedSampleIndex)
+    {
+        mParams.frameCount = *pSampleIndex;
+    }
+
     // Update the random seed.
     mParams.seed = mParams.useFixedSeed ? mParams.fixedSeed : mParams.frameCount;
 
@@ -1245,6 +1363,7 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
 void PathTracer::endFrame(RenderContext* pRenderContext, const RenderData& renderData)
 {
     mpPixelStats->endFrame(pRenderContext);
+    mpAdaptiveSampling->endFrame(pRenderContext, renderData.getTexture(kOutputColorID));
     mpPixelDebug->endFrame(pRenderContext);
 
     auto copyTexture = [pRenderContext](Texture* pDst, const Texture* pSrc)
@@ -1263,13 +1382,17 @@ void PathTracer::endFrame(RenderContext* pRenderContext, const RenderData& rende
     };
 
     // Copy pixel stats to outputs if available.
-    copyTexture(renderData.getTexture(kOutputRayCount).get(), mpPixelStats->getRayCountTexture(pRenderContext).get());
-    copyTexture(renderData.getTexture(kOutputPathLength).get(), mpPixelStats->getPathLengthTexture().get());
+    copyTexture(renderData.getTexture(kOutputRayCountID).get(), mpPixelStats->getRayCountTexture(pRenderContext).get());
+    copyTexture(renderData.getTexture(kOutputPathLengthID).get(), mpPixelStats->getPathLengthTexture().get());
 
     if (mpRTXDI) mpRTXDI->endFrame(pRenderContext);
 
     mVarsChanged = false;
     mParams.frameCount++;
+
+    // Publish the sample index of the next frame, e.g. for storing it in accumulation checkpoints.
+    renderData.getDictionary().setValue(kRenderPassSampleIndexKey, mParams.frameCount);
+    mPublishedSampleIndex = mParams.frameCount;
 }
 
 void PathTracer::generatePaths(RenderContext* pRenderContext, const RenderData& renderData)
@@ -1285,7 +1408,7 @@ void PathTracer::generatePaths(RenderContext* pRenderContext, const RenderData&
     FALCOR_ASSERT(mpGeneratePaths->getThreadGroupSize().y == 1 && mpGeneratePaths->getThreadGroupSize().z == 1);
 
     // Additional specialization. This shouldn't change resource declarations.
-    mpGeneratePaths->addDefine("USE_VIEW_DIR", (mpScene->getCamera()->getApertureRadius() > 0 && renderData[kInputViewDir] != nullptr) ? "1" : "0");
+    mpGeneratePaths->addDefine("USE_VIEW_DIR", (mpScene->getCamera()->getApertureRadius() > 0 && renderData[kInputViewDirID] != nullptr) ? "1" : "0");
     mpGeneratePaths->addDefine("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
     mpGeneratePaths->addDefine("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
     mpGeneratePaths->addDefine("OUTPUT_NRD_ADDITIONAL_DATA", mOutputNRDAdditionalData ? "1" : "0");
@@ -1298,7 +1421,7 @@ void PathTracer::generatePaths(RenderContext* pRenderContext, const RenderData&
 
     if (mpRTXDI) mpRTXDI->bindShaderData(mpGeneratePaths->getRootVar());
 
-    // Launch one thread per pixel.
+    // Launch one thread per pixel in the render region.
     // The dimensions are padded to whole tiles to allow re-indexing the threads in the shader.
     mpGeneratePaths->execute(pRenderContext, { mParams.screenTiles.x * tileSize, mParams.screenTiles.y, 1u });
 }
@@ -1310,7 +1433,7 @@ void PathTracer::tracePass(RenderContext* pRenderContext, const RenderData& rend
     FALCOR_ASSERT(tracePass.pProgram != nullptr && tracePass.pBindingTable != nullptr && tracePass.pVars != nullptr);
 
     // Additional specialization. This shouldn't change resource declarations.
-    tracePass.pProgram->addDefine("USE_VIEW_DIR", (mpScene->getCamera()->getApertureRadius() > 0 && renderData[kInputViewDir] != nullptr) ? "1" : "0");
+    tracePass.pProgram->addDefine("USE_VIEW_DIR", (mpScene->getCamera()->getApertureRadius() > 0 && renderData[kInputViewDirID] != nullptr) ? "1" : "0");
     tracePass.pProgram->addDefine("OUTPUT_GUIDE_DATA", mOutputGuideData ? "1" : "0");
     tracePass.pProgram->addDefine("OUTPUT_NRD_DATA", mOutputNRDData ? "1" : "0");
     tracePass.pProgram->addDefine("OUTPUT_NRD_ADDITIONAL_DATA", mOutputNRDAdditionalData ? "1" : "0");
@@ -1328,8 +1451,8 @@ void PathTracer::tracePass(RenderContext* pRenderContext, const RenderData& rend
     // Bind the path tracer.
     var["gPathTracer"] = mpPathTracerBlock;
 
-    // Full screen dispatch.
-    mpScene->raytrace(pRenderContext, tracePass.pProgram.get(), tracePass.pVars, uint3(mParams.frameDim, 1));
+    // Dispatch over the render region.
+    mpScene->raytrace(pRenderContext, tracePass.pProgram.get(), tracePass.pVars, uint3(mParams.renderRegionEnd - mParams.renderRegionStart, 1));
 }
 
 void PathTracer::resolvePass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -1351,18 +1474,18 @@ void PathTracer::resolvePass(RenderContext* pRenderContext, const RenderData& re
     // Bind resources.
     auto var = mpResolvePass->getRootVar()["CB"]["gResolvePass"];
     var["params"].setBlob(mParams);
-    var["sampleCount"] = renderData.getTexture(kInputSampleCount); // Can be nullptr
-    var["outputColor"] = renderData.getTexture(kOutputColor);
-    var["outputAlbedo"] = renderData.getTexture(kOutputAlbedo);
-    var["outputSpecularAlbedo"] = renderData.getTexture(kOutputSpecularAlbedo);
-    var["outputIndirectAlbedo"] = renderData.getTexture(kOutputIndirectAlbedo);
-    var["outputGuideNormal"] = renderData.getTexture(kOutputGuideNormal);
-    var["outputReflectionPosW"] = renderData.getTexture(kOutputReflectionPosW);
-    var["outputNRDDiffuseRadianceHitDist"] = renderData.getTexture(kOutputNRDDiffuseRadianceHitDist);
-    var["outputNRDSpecularRadianceHitDist"] = renderData.getTexture(kOutputNRDSpecularRadianceHitDist);
-    var["outputNRDDeltaReflectionRadianceHitDist"] = renderData.getTexture(kOutputNRDDeltaReflectionRadianceHitDist);
-    var["outputNRDDeltaTransmissionRadianceHitDist"] = renderData.getTexture(kOutputNRDDeltaTransmissionRadianceHitDist);
-    var["outputNRDResidualRadianceHitDist"] = renderData.getTexture(kOutputNRDResidualRadianceHitDist);
+    var["sampleCount"] = getSampleCountTexture(renderData); // Can be nullptr
+    var["outputColor"] = renderData.getTexture(kOutputColorID);
+    var["outputAlbedo"] = renderData.getTexture(kOutputAlbedoID);
+    var["outputSpecularAlbedo"] = renderData.getTexture(kOutputSpecularAlbedoID);
+    var["outputIndirectAlbedo"] = renderData.getTexture(kOutputIndirectAlbedoID);
+    var["outputGuideNormal"] = renderData.getTexture(kOutputGuideNormalID);
+    var["outputReflectionPosW"] = renderData.getTexture(kOutputReflectionPosWID);
+    var["outputNRDDiffuseRadianceHitDist"] = renderData.getTexture(kOutputNRDDiffuseRadianceHitDistID);
+    var["outputNRDSpecularRadianceHitDist"] = renderData.getTexture(kOutputNRDSpecularRadianceHitDistID);
+    var["outputNRDDeltaReflectionRadianceHitDist"] = renderData.getTexture(kOutputNRDDeltaReflectionRadianceHitDistID);
+    var["outputNRDDeltaTransmissionRadianceHitDist"] = renderData.getTexture(kOutputNRDDeltaTransmissionRadianceHitDistID);
+    var["outputNRDResidualRadianceHitDist"] = renderData.getTexture(kOutputNRDResidualRadianceHitDistID);
 
     if (mVarsChanged)
     {
@@ -1375,11 +1498,11 @@ void PathTracer::resolvePass(RenderContext* pRenderContext, const RenderData& re
         var["sampleNRDReflectance"] = mpSampleNRDReflectance;
 
         var["sampleNRDPrimaryHitNeeOnDelta"] = mpSampleNRDPrimaryHitNeeOnDelta;
-        var["primaryHitDiffuseReflectance"] = renderData.getTexture(kOutputNRDDiffuseReflectance);
+        var["primaryHitDiffuseReflectance"] = renderData.getTexture(kOutputNRDDiffuseReflectanceID);
     }
 
-    // Launch one thread per pixel.
-    mpResolvePass->execute(pRenderContext, { mParams.frameDim, 1u });
+    // Launch one thread per pixel in the render region.
+    mpResolvePass->execute(pRenderContext, { mParams.renderRegionEnd - mParams.renderRegionStart, 1u });
 }
 
 DefineList PathTracer::StaticParams::getDefines(const PathTracer& owner) const
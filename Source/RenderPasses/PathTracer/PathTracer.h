@@ -35,6 +35,7 @@
 #include "Rendering/Lights/EmissivePowerSampler.h"
 #include "Rendering/Lights/EnvMapSampler.h"
 #include "Rendering/Materials/TexLODTypes.slang"
+#include "Rendering/Utils/AdaptiveSampling.h"
 #include "Rendering/Utils/PixelStats.h"
 #include "Rendering/RTXDI/RTXDI.h"
 
@@ -63,6 +64,7 @@ public:
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
     PixelStats& getPixelStats() { return *mpPixelStats; }
+    AdaptiveSampling& getAdaptiveSampling() { return *mpAdaptiveSampling; }
 
     void reset();
 
@@ -85,7 +87,7 @@ private:
     void validateOptions();
     void resetPrograms();
     void updatePrograms();
-    void setFrameDim(const uint2 frameDim);
+    void setFrameDim(const uint2 frameDim, const RenderTile& renderTile);
     void prepareResources(RenderContext* pRenderContext, const RenderData& renderData);
     void preparePathTracer(const RenderData& renderData);
     void resetLighting();
@@ -102,6 +104,7 @@ private:
     void generatePaths(RenderContext* pRenderContext, const RenderData& renderData);
     void tracePass(RenderContext* pRenderContext, const RenderData& renderData, TracePass& tracePass);
     void resolvePass(RenderContext* pRenderContext, const RenderData& renderData);
+    ref<Texture> getSampleCountTexture(const RenderData& renderData) const;
 
     /** Static configuration. Changing any of these options require shader recompilation.
     */
@@ -164,6 +167,7 @@ private:
     std::unique_ptr<EmissiveLightSampler> mpEmissiveSampler;    ///< Emissive light sampler or nullptr if not used.
     std::unique_ptr<RTXDI>          mpRTXDI;                    ///< RTXDI sampler for direct illumination or nullptr if not used.
     std::unique_ptr<PixelStats>     mpPixelStats;               ///< Utility class for collecting pixel stats.
+    std::unique_ptr<AdaptiveSampling> mpAdaptiveSampling;       ///< Utility class for variance-driven adaptive sampling.
     std::unique_ptr<PixelDebug>     mpPixelDebug;               ///< Utility class for pixel debugging (print in shaders).
 
     ref<ParameterBlock>             mpPathTracerBlock;          ///< Parameter block for the path tracer.
@@ -172,10 +176,12 @@ private:
     bool                            mVarsChanged = true;        ///< This is set to true whenever the program vars have changed and resources need to be rebound.
     bool                            mOptionsChanged = false;    ///< True if the config has changed since last frame.
     bool                            mGBufferAdjustShadingNormals = false; ///< True if GBuffer/VBuffer has adjusted shading normals enabled.
-    bool                            mFixedSampleCount = true;   ///< True if a fixed sample count per pixel is used. Otherwise load it from the pass sample count input.
+    bool                            mFixedSampleCount = true;   ///< True if a fixed sample count per pixel is used. Otherwise load it from the pass sample count input or the adaptive sampling map.
+    bool                            mUseAdaptiveSampling = false; ///< True if adaptive sampling should be used when the sample count input is not connected.
     bool                            mOutputGuideData = false;   ///< True if guide data should be generated as outputs.
     bool                            mOutputNRDData = false;     ///< True if NRD diffuse/specular data should be generated as outputs.
     bool                            mOutputNRDAdditionalData = false;   ///< True if NRD data from delta and residual paths should be generated as designated outputs rather than being included in specular NRD outputs.
+    uint32_t                        mPublishedSampleIndex = 0;  ///< Sample index last published in the dictionary. A different value in the dictionary was set by another pass.
 
     ref<ComputePass>                mpGeneratePaths;            ///< Fullscreen compute pass generating paths starting at primary hits.
     ref<ComputePass>                mpResolvePass;              ///< Sample resolve pass.
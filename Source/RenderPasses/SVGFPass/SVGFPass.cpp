@@ -41,11 +41,13 @@ namespace
 const char kPackLinearZAndNormalShader[] = "RenderPasses/SVGFPass/SVGFPackLinearZAndNormal.ps.slang";
 const char kReprojectShader[] = "RenderPasses/SVGFPass/SVGFReproject.ps.slang";
 const char kAtrousShader[] = "RenderPasses/SVGFPass/SVGFAtrous.ps.slang";
+const char kAtrousComputeShader[] = "RenderPasses/SVGFPass/SVGFAtrous.cs.slang";
 const char kFilterMomentShader[] = "RenderPasses/SVGFPass/SVGFFilterMoments.ps.slang";
 const char kFinalModulateShader[] = "RenderPasses/SVGFPass/SVGFFinalModulate.ps.slang";
 
 // Names of valid entries in the parameter dictionary.
 const char kEnabled[] = "Enabled";
+const char kComputeFilter[] = "ComputeFilter";
 const char kIterations[] = "Iterations";
 const char kFeedbackTap[] = "FeedbackTap";
 const char kVarianceEpsilon[] = "VarianceEpsilon";
@@ -84,6 +86,8 @@ SVGFPass::SVGFPass(ref<Device> pDevice, const Properties& props) : RenderPass(pD
     {
         if (key == kEnabled)
             mFilterEnabled = value;
+        else if (key == kComputeFilter)
+            mUseComputeFilter = value;
         else if (key == kIterations)
             mFilterIterations = value;
         else if (key == kFeedbackTap)
@@ -108,12 +112,16 @@ SVGFPass::SVGFPass(ref<Device> pDevice, const Properties& props) : RenderPass(pD
     mpFilterMoments = FullScreenPass::create(mpDevice, kFilterMomentShader);
     mpFinalModulate = FullScreenPass::create(mpDevice, kFinalModulateShader);
     FALCOR_ASSERT(mpPackLinearZAndNormal && mpReprojection && mpAtrous && mpFilterMoments && mpFinalModulate);
+
+    mpAtrousCompute = ComputePass::create(mpDevice, ProgramDesc().addShaderLibrary(kAtrousComputeShader).csEntry("atrous"));
+    mpAtrousFusedCompute = ComputePass::create(mpDevice, ProgramDesc().addShaderLibrary(kAtrousComputeShader).csEntry("atrousFused"));
 }
 
 Properties SVGFPass::getProperties() const
 {
     Properties props;
     props[kEnabled] = mFilterEnabled;
+    props[kComputeFilter] = mUseComputeFilter;
     props[kIterations] = mFilterIterations;
     props[kFeedbackTap] = mFeedbackTap;
     props[kVarianceEpsilon] = mVarainceEpsilon;
@@ -224,7 +232,10 @@ void SVGFPass::execute(RenderContext* pRenderContext, const RenderData& renderDa
         // in mpPingPongFbo[0].  Along the way (or at the end, depending on
         // the value of mFeedbackTap), save the filtered illumination for
         // next time into mpFilteredPastFbo.
-        computeAtrousDecomposition(pRenderContext, pAlbedoTexture);
+        if (mUseComputeFilter)
+            computeAtrousDecompositionCompute(pRenderContext);
+        else
+            computeAtrousDecomposition(pRenderContext, pAlbedoTexture);
 
         // Compute albedo * filtered illumination and add emission back in.
         auto perImageCB = mpFinalModulate->getRootVar()["PerImageCB"];
@@ -268,9 +279,9 @@ void SVGFPass::allocateFbos(uint2 dim, RenderContext* pRenderContext)
     }
 
     {
-        // Screen-size FBOs with 1 RGBA32F buffer
+        // Screen-size FBOs with 1 RGBA32F buffer. These are also written by the compute filter.
         Fbo::Desc desc;
-        desc.setColorTarget(0, Falcor::ResourceFormat::RGBA32Float);
+        desc.setColorTarget(0, Falcor::ResourceFormat::RGBA32Float, true);
         mpPingPongFbo[0] = Fbo::create2D(mpDevice, dim.x, dim.y, desc);
         mpPingPongFbo[1] = Fbo::create2D(mpDevice, dim.x, dim.y, desc);
         mpFilteredPastFbo = Fbo::create2D(mpDevice, dim.x, dim.y, desc);
@@ -361,7 +372,6 @@ void SVGFPass::computeAtrousDecomposition(RenderContext* pRenderContext, ref<Tex
     auto perImageCB = mpAtrous->getRootVar()["PerImageCB"];
 
     perImageCB["gAlbedo"] = pAlbedoTexture;
-    perImageCB["gHistoryLength"] = mpCurReprojFbo->getColorTexture(2);
     perImageCB["gLinearZAndNormal"] = mpLinearZAndNormalFbo->getColorTexture(0);
 
     perImageCB["gPhiColor"] = mPhiColor;
@@ -391,10 +401,75 @@ void SVGFPass::computeAtrousDecomposition(RenderContext* pRenderContext, ref<Tex
     }
 }
 
+// Same as computeAtrousDecomposition(), but runs the filter in compute.
+// The first two iterations are fused into a single dispatch that keeps
+// the intermediate result in shared memory.
+void SVGFPass::computeAtrousDecompositionCompute(RenderContext* pRenderContext)
+{
+    const uint2 dim = {mpPingPongFbo[0]->getWidth(), mpPingPongFbo[0]->getHeight()};
+    const int feedbackIteration = std::min(mFeedbackTap, mFilterIterations - 1);
+
+    auto setCommonVars = [&](const ShaderVar& perImageCB)
+    {
+        perImageCB["gLinearZAndNormal"] = mpLinearZAndNormalFbo->getColorTexture(0);
+        perImageCB["gScreenSize"] = int2(dim);
+        perImageCB["gPhiColor"] = mPhiColor;
+        perImageCB["gPhiNormal"] = mPhiNormal;
+    };
+
+    int i = 0;
+    if (mFilterIterations >= 2)
+    {
+        auto perImageCB = mpAtrousFusedCompute->getRootVar()["PerImageCB"];
+        setCommonVars(perImageCB);
+        perImageCB["gIllumination"] = mpPingPongFbo[0]->getColorTexture(0);
+        perImageCB["gOutput"] = mpPingPongFbo[1]->getColorTexture(0);
+        perImageCB["gFeedback"] = mpFilteredPastFbo->getColorTexture(0);
+        perImageCB["gWriteFeedback"] = feedbackIteration == 0;
+
+        mpAtrousFusedCompute->execute(pRenderContext, dim.x, dim.y);
+
+        if (feedbackIteration == 1)
+        {
+            pRenderContext->blit(mpPingPongFbo[1]->getColorTexture(0)->getSRV(), mpFilteredPastFbo->getRenderTargetView(0));
+        }
+
+        std::swap(mpPingPongFbo[0], mpPingPongFbo[1]);
+        i = 2;
+    }
+
+    auto perImageCB = mpAtrousCompute->getRootVar()["PerImageCB"];
+    setCommonVars(perImageCB);
+
+    for (; i < mFilterIterations; i++)
+    {
+        perImageCB["gIllumination"] = mpPingPongFbo[0]->getColorTexture(0);
+        perImageCB["gOutput"] = mpPingPongFbo[1]->getColorTexture(0);
+        perImageCB["gStepSize"] = 1 << i;
+
+        mpAtrousCompute->execute(pRenderContext, dim.x, dim.y);
+
+        // store the filtered color for the feedback path
+        if (i == feedbackIteration)
+        {
+            pRenderContext->blit(mpPingPongFbo[1]->getColorTexture(0)->getSRV(), mpFilteredPastFbo->getRenderTargetView(0));
+        }
+
+        std::swap(mpPingPongFbo[0], mpPingPongFbo[1]);
+    }
+
+    if (mFeedbackTap < 0)
+    {
+        pRenderContext->blit(mpCurReprojFbo->getColorTexture(0)->getSRV(), mpFilteredPastFbo->getRenderTargetView(0));
+    }
+}
+
 void SVGFPass::renderUI(Gui::Widgets& widget)
 {
     int dirty = 0;
     dirty |= (int)widget.checkbox("Enable SVGF", mFilterEnabled);
+    widget.checkbox("Compute filter", mUseComputeFilter);
+    widget.tooltip("Run the a-trous filter in compute, fusing the first two iterations in shared memory.\nThe result is identical to the pixel shader filter.");
 
     widget.text("");
     widget.text("Number of filter iterations.  Which");
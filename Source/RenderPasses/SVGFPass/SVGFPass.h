@@ -29,6 +29,7 @@
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
 #include "Core/Pass/FullScreenPass.h"
+#include "Core/Pass/ComputePass.h"
 
 using namespace Falcor;
 
@@ -63,11 +64,13 @@ private:
     );
     void computeFilteredMoments(RenderContext* pRenderContext);
     void computeAtrousDecomposition(RenderContext* pRenderContext, ref<Texture> pAlbedoTexture);
+    void computeAtrousDecompositionCompute(RenderContext* pRenderContext);
 
     bool mBuffersNeedClear = false;
 
     // SVGF parameters
     bool mFilterEnabled = true;
+    bool mUseComputeFilter = true;
     int32_t mFilterIterations = 4;
     int32_t mFeedbackTap = 1;
     float mVarainceEpsilon = 1e-4f;
@@ -82,6 +85,8 @@ private:
     ref<FullScreenPass> mpFilterMoments;
     ref<FullScreenPass> mpAtrous;
     ref<FullScreenPass> mpFinalModulate;
+    ref<ComputePass> mpAtrousCompute;
+    ref<ComputePass> mpAtrousFusedCompute;
 
     // Intermediate framebuffers
     ref<Fbo> mpPingPongFbo[2];
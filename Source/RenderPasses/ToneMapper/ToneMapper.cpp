@@ -26,14 +26,18 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "ToneMapper.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
 #include "Utils/Color/ColorUtils.h"
-#include <fstd/bit.h> // TODO C++20: Replace with <bit>
 
 namespace
 {
 const char kSrc[] = "src";
 const char kDst[] = "dst";
 
+// Interned IDs of the fields looked up every frame.
+const RenderData::ResourceID kSrcID{kSrc};
+const RenderData::ResourceID kDstID{kDst};
+
 // Scripting options.
 const char kOutputSize[] = "outputSize";
 const char kOutputFormat[] = "outputFormat";
@@ -48,6 +52,17 @@ const char kFNumber[] = "fNumber";
 const char kShutter[] = "shutter";
 const char kExposureMode[] = "exposureMode";
 
+const char kMetering[] = "metering";
+const char kLowPercentile[] = "lowPercentile";
+const char kHighPercentile[] = "highPercentile";
+const char kMinLogLuminance[] = "minLogLuminance";
+const char kMaxLogLuminance[] = "maxLogLuminance";
+const char kAdaptationSpeedUp[] = "adaptationSpeedUp";
+const char kAdaptationSpeedDown[] = "adaptationSpeedDown";
+const char kCenterWeightSigma[] = "centerWeightSigma";
+const char kSpotRadius[] = "spotRadius";
+const char kLuminanceWeights[] = "luminanceWeights";
+
 const char kWhiteBalance[] = "whiteBalance";
 const char kWhitePoint[] = "whitePoint";
 
@@ -56,7 +71,6 @@ const char kClamp[] = "clamp";
 const char kWhiteMaxLuminance[] = "whiteMaxLuminance";
 const char kWhiteScale[] = "whiteScale";
 
-const char kLuminanceFile[] = "RenderPasses/ToneMapper/Luminance.ps.slang";
 const char kToneMappingFile[] = "RenderPasses/ToneMapper/ToneMapping.ps.slang";
 
 const float kExposureCompensationMin = -12.f;
@@ -104,6 +118,49 @@ static void regToneMapper(pybind11::module& m)
         [](const ToneMapper& self) { return enumToString(self.getExposureMode()); },
         [](ToneMapper& self, const std::string& value) { self.setExposureMode(stringToEnum<ToneMapper::ExposureMode>(value)); }
     );
+
+    // Auto exposure parameters.
+    auto addAutoExposureParam = [&pass](const char* name, auto member)
+    {
+        pass.def_property(
+            name,
+            [member](const ToneMapper& self) { return self.getAutoExposureParams().*member; },
+            [member](ToneMapper& self, float value)
+            {
+                AutoExposureParams params = self.getAutoExposureParams();
+                params.*member = value;
+                self.setAutoExposureParams(params);
+            }
+        );
+    };
+    pass.def_property(
+        kMetering,
+        [](const ToneMapper& self) { return enumToString(self.getAutoExposureParams().metering); },
+        [](ToneMapper& self, const std::string& value)
+        {
+            AutoExposureParams params = self.getAutoExposureParams();
+            params.metering = stringToEnum<AutoExposureMetering>(value);
+            self.setAutoExposureParams(params);
+        }
+    );
+    addAutoExposureParam(kLowPercentile, &AutoExposureParams::lowPercentile);
+    addAutoExposureParam(kHighPercentile, &AutoExposureParams::highPercentile);
+    addAutoExposureParam(kMinLogLuminance, &AutoExposureParams::minLogLuminance);
+    addAutoExposureParam(kMaxLogLuminance, &AutoExposureParams::maxLogLuminance);
+    addAutoExposureParam(kAdaptationSpeedUp, &AutoExposureParams::adaptationSpeedUp);
+    addAutoExposureParam(kAdaptationSpeedDown, &AutoExposureParams::adaptationSpeedDown);
+    addAutoExposureParam(kCenterWeightSigma, &AutoExposureParams::centerWeightSigma);
+    addAutoExposureParam(kSpotRadius, &AutoExposureParams::spotRadius);
+    pass.def_property(
+        kLuminanceWeights,
+        [](const ToneMapper& self) { return self.getAutoExposureParams().luminanceWeights; },
+        [](ToneMapper& self, float3 value)
+        {
+            AutoExposureParams params = self.getAutoExposureParams();
+            params.luminanceWeights = value;
+            self.setAutoExposureParams(params);
+        }
+    );
 }
 
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
@@ -114,9 +171,10 @@ extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registr
 
 ToneMapper::ToneMapper(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
 {
+    mpAutoExposure = std::make_unique<AutoExposure>(mpDevice);
+
     parseProperties(props);
 
-    createLuminancePass();
     createToneMapPass();
 
     updateWhiteBalanceTransform();
@@ -124,12 +182,12 @@ ToneMapper::ToneMapper(ref<Device> pDevice, const Properties& props) : RenderPas
     Sampler::Desc samplerDesc;
     samplerDesc.setFilterMode(TextureFilteringMode::Point, TextureFilteringMode::Point, TextureFilteringMode::Point);
     mpPointSampler = mpDevice->createSampler(samplerDesc);
-    samplerDesc.setFilterMode(TextureFilteringMode::Linear, TextureFilteringMode::Linear, TextureFilteringMode::Point);
-    mpLinearSampler = mpDevice->createSampler(samplerDesc);
 }
 
 void ToneMapper::parseProperties(const Properties& props)
 {
+    AutoExposureParams autoExposureParams = mpAutoExposure->getParams();
+
     for (const auto& [key, value] : props)
     {
         if (key == kOutputSize)
@@ -164,9 +222,31 @@ void ToneMapper::parseProperties(const Properties& props)
             setShutter(value);
         else if (key == kExposureMode)
             setExposureMode(value);
+        else if (key == kMetering)
+            autoExposureParams.metering = value;
+        else if (key == kLowPercentile)
+            autoExposureParams.lowPercentile = value;
+        else if (key == kHighPercentile)
+            autoExposureParams.highPercentile = value;
+        else if (key == kMinLogLuminance)
+            autoExposureParams.minLogLuminance = value;
+        else if (key == kMaxLogLuminance)
+            autoExposureParams.maxLogLuminance = value;
+        else if (key == kAdaptationSpeedUp)
+            autoExposureParams.adaptationSpeedUp = value;
+        else if (key == kAdaptationSpeedDown)
+            autoExposureParams.adaptationSpeedDown = value;
+        else if (key == kCenterWeightSigma)
+            autoExposureParams.centerWeightSigma = value;
+        else if (key == kSpotRadius)
+            autoExposureParams.spotRadius = value;
+        else if (key == kLuminanceWeights)
+            autoExposureParams.luminanceWeights = value;
         else
             logWarning("Unknown property '{}' in a ToneMapping properties.", key);
     }
+
+    mpAutoExposure->setParams(autoExposureParams);
 }
 
 Properties ToneMapper::getProperties() const
@@ -190,6 +270,18 @@ Properties ToneMapper::getProperties() const
     props[kFNumber] = mFNumber;
     props[kShutter] = mShutter;
     props[kExposureMode] = mExposureMode;
+
+    const AutoExposureParams& autoExposureParams = mpAutoExposure->getParams();
+    props[kMetering] = autoExposureParams.metering;
+    props[kLowPercentile] = autoExposureParams.lowPercentile;
+    props[kHighPercentile] = autoExposureParams.highPercentile;
+    props[kMinLogLuminance] = autoExposureParams.minLogLuminance;
+    props[kMaxLogLuminance] = autoExposureParams.maxLogLuminance;
+    props[kAdaptationSpeedUp] = autoExposureParams.adaptationSpeedUp;
+    props[kAdaptationSpeedDown] = autoExposureParams.adaptationSpeedDown;
+    props[kCenterWeightSigma] = autoExposureParams.centerWeightSigma;
+    props[kSpotRadius] = autoExposureParams.spotRadius;
+    props[kLuminanceWeights] = autoExposureParams.luminanceWeights;
     return props;
 }
 
@@ -210,8 +302,8 @@ RenderPassReflection ToneMapper::reflect(const CompileData& compileData)
 
 void ToneMapper::execute(RenderContext* pRenderContext, const RenderData& renderData)
 {
-    auto pSrc = renderData.getTexture(kSrc);
-    auto pDst = renderData.getTexture(kDst);
+    auto pSrc = renderData.getTexture(kSrcID);
+    auto pDst = renderData.getTexture(kDstID);
     FALCOR_ASSERT(pSrc && pDst);
 
     // Issue warning if image will be resampled. The render pass supports this but image quality may suffer.
@@ -223,17 +315,23 @@ void ToneMapper::execute(RenderContext* pRenderContext, const RenderData& render
     ref<Fbo> pFbo = Fbo::create(mpDevice);
     pFbo->attachColorTarget(pDst, 0);
 
-    // Run luminance pass if auto exposure is enabled
+    // Update the exposure from the luminance histogram if auto exposure is enabled
     if (mAutoExposure)
     {
-        createLuminanceFbo(pSrc);
-
-        auto var = mpLuminancePass->getRootVar();
-        var["gColorTex"] = pSrc;
-        var["gColorSampler"] = mpLinearSampler;
-
-        mpLuminancePass->execute(pRenderContext, mpLuminanceFbo);
-        mpLuminanceFbo->getColorTexture(0)->generateMips(pRenderContext);
+        // Adapt with the frame clock of the application, so that renders with a fixed time step are reproducible.
+        // Hosts not providing the frame time fall back to wall-clock time.
+        double deltaTime = 0.0;
+        if (const float* pDeltaTime = renderData.getDictionary().tryGetValue(kRenderPassFrameTimeDeltaKey))
+        {
+            deltaTime = *pDeltaTime;
+        }
+        else
+        {
+            mAdaptationTimer.update();
+            deltaTime = mAdaptationTimer.delta();
+        }
+        // The clock delta is negative when the time is reset.
+        mpAutoExposure->execute(pRenderContext, pSrc, (float)std::clamp(deltaTime, 0.0, 1.0));
     }
 
     // Run main pass
@@ -263,38 +361,12 @@ void ToneMapper::execute(RenderContext* pRenderContext, const RenderData& render
 
     if (mAutoExposure)
     {
-        var["gLuminanceTexSampler"] = mpLinearSampler;
-        var["gLuminanceTex"] = mpLuminanceFbo->getColorTexture(0);
+        var["gExposure"] = mpAutoExposure->getExposureBuffer();
     }
 
     mpToneMapPass->execute(pRenderContext, pFbo);
 }
 
-void ToneMapper::createLuminanceFbo(const ref<Texture>& pSrc)
-{
-    bool createFbo = mpLuminanceFbo == nullptr;
-    ResourceFormat srcFormat = pSrc->getFormat();
-    uint32_t bytesPerChannel = getFormatBytesPerBlock(srcFormat) / getFormatChannelCount(srcFormat);
-
-    // Find the required texture size and format
-    ResourceFormat luminanceFormat = (bytesPerChannel == 4) ? ResourceFormat::R32Float : ResourceFormat::R16Float;
-    uint32_t requiredHeight = fstd::bit_floor(pSrc->getHeight());
-    uint32_t requiredWidth = fstd::bit_floor(pSrc->getWidth());
-
-    if (createFbo == false)
-    {
-        createFbo = (requiredWidth != mpLuminanceFbo->getWidth()) || (requiredHeight != mpLuminanceFbo->getHeight()) ||
-                    (luminanceFormat != mpLuminanceFbo->getColorTexture(0)->getFormat());
-    }
-
-    if (createFbo)
-    {
-        Fbo::Desc desc;
-        desc.setColorTarget(0, luminanceFormat);
-        mpLuminanceFbo = Fbo::create2D(mpDevice, requiredWidth, requiredHeight, desc, 1, Fbo::kAttachEntireMipLevel);
-    }
-}
-
 // Set EV based on fNumber and shutter
 void ToneMapper::updateExposureValue()
 {
@@ -319,9 +391,14 @@ void ToneMapper::renderUI(Gui::Widgets& widget)
             "Exposure Compensation", mExposureCompensation, kExposureCompensationMin, kExposureCompensationMax, 0.1f, false, "%.1f"
         );
 
-        mRecreateToneMapPass |= exposureGroup.checkbox("Auto Exposure", mAutoExposure);
+        if (exposureGroup.checkbox("Auto Exposure", mAutoExposure))
+            setAutoExposure(mAutoExposure);
 
-        if (!mAutoExposure)
+        if (mAutoExposure)
+        {
+            mpAutoExposure->renderUI(exposureGroup);
+        }
+        else
         {
             if (auto exposureMode = mExposureMode; exposureGroup.dropdown("Exposure mode", exposureMode))
             {
@@ -413,6 +490,9 @@ void ToneMapper::setAutoExposure(bool autoExposure)
 {
     mAutoExposure = autoExposure;
     mRecreateToneMapPass = true;
+
+    // Don't adapt from a stale exposure when auto exposure is re-enabled.
+    mpAutoExposure->reset();
 }
 
 void ToneMapper::setExposureValue(float exposureValue)
@@ -507,12 +587,12 @@ void ToneMapper::setExposureMode(ExposureMode mode)
     mExposureMode = mode;
 }
 
-
-void ToneMapper::createLuminancePass()
+void ToneMapper::setAutoExposureParams(const AutoExposureParams& params)
 {
-    mpLuminancePass = FullScreenPass::create(mpDevice, kLuminanceFile);
+    mpAutoExposure->setParams(params);
 }
 
+
 void ToneMapper::createToneMapPass()
 {
     DefineList defines;
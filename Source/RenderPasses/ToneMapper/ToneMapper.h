@@ -32,6 +32,8 @@
 #include "RenderGraph/RenderPass.h"
 #include "RenderGraph/RenderPassHelpers.h"
 #include "Core/Pass/FullScreenPass.h"
+#include "Rendering/Utils/AutoExposure.h"
+#include "Utils/Timing/CpuTimer.h"
 
 using namespace Falcor;
 
@@ -84,6 +86,7 @@ public:
     void setFNumber(float fNumber);
     void setShutter(float shutter);
     void setExposureMode(ExposureMode mode);
+    void setAutoExposureParams(const AutoExposureParams& params);
 
     float getExposureCompensation() const { return mExposureCompensation; }
     bool getAutoExposure() const { return mAutoExposure; }
@@ -98,13 +101,12 @@ public:
     float getFNumber() const { return mFNumber; }
     float getShutter() const { return mShutter; }
     ExposureMode getExposureMode() const { return mExposureMode; }
+    const AutoExposureParams& getAutoExposureParams() const { return mpAutoExposure->getParams(); }
 
 private:
     void parseProperties(const Properties& props);
 
     void createToneMapPass();
-    void createLuminancePass();
-    void createLuminanceFbo(const ref<Texture>& pSrc);
 
     void updateWhiteBalanceTransform();
     void updateColorTransform();
@@ -112,10 +114,10 @@ private:
     void updateExposureValue();
 
     ref<FullScreenPass> mpToneMapPass;
-    ref<FullScreenPass> mpLuminancePass;
-    ref<Fbo> mpLuminanceFbo;
+    std::unique_ptr<AutoExposure> mpAutoExposure;
+    /// Timer for the exposure adaptation, used if the application doesn't provide the frame time.
+    CpuTimer mAdaptationTimer;
     ref<Sampler> mpPointSampler;
-    ref<Sampler> mpLinearSampler;
 
     /// Selected output size.
     RenderPassHelpers::IOSize mOutputSizeSelection = RenderPassHelpers::IOSize::Default;
@@ -0,0 +1,241 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Core/Plugin.h"
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraph.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
+#include "Rendering/Utils/AccumulationCheckpoint.h"
+
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint2 kFrameDim = {67, 45};
+
+/// Create an input frame with constant luminance plus noise. Frames are deterministic given the frame index.
+ref<Texture> createInputFrame(ref<Device> pDevice, uint32_t frameIndex, float value, float noise)
+{
+    std::mt19937 rng(frameIndex);
+    std::normal_distribution<float> dist;
+    std::vector<float4> data(kFrameDim.x * kFrameDim.y);
+    for (auto& c : data)
+    {
+        float L = value + noise * dist(rng);
+        c = float4(L, L, L, 1.f);
+    }
+    return pDevice->createTexture2D(kFrameDim.x, kFrameDim.y, ResourceFormat::RGBA32Float, 1, 1, data.data());
+}
+
+class AccumulationRunner
+{
+public:
+    AccumulationRunner(GPUUnitTestContext& ctx, const Properties& props) : mCtx(ctx)
+    {
+        PluginManager::instance().loadPluginByName("AccumulatePass");
+
+        ref<Device> pDevice = ctx.getDevice();
+        mpGraph = RenderGraph::create(pDevice, "Accumulation");
+        ref<RenderPass> pPass = RenderPass::create("AccumulatePass", pDevice, props);
+        if (!pPass)
+            FALCOR_THROW("Could not create render pass 'AccumulatePass'");
+        mpGraph->addPass(pPass, "AccumulatePass");
+        mpGraph->markOutput("AccumulatePass.output");
+        ref<Fbo> pTargetFbo = Fbo::create2D(pDevice, kFrameDim.x, kFrameDim.y, ResourceFormat::RGBA32Float);
+        mpGraph->onResize(pTargetFbo.get());
+    }
+
+    /// Accumulate a frame and return the output.
+    std::vector<uint8_t> run(const ref<Texture>& pInput)
+    {
+        mpGraph->setInput("AccumulatePass.input", pInput);
+        mpGraph->execute(mCtx.getRenderContext());
+        ref<Resource> pOutput = mpGraph->getOutput("AccumulatePass.output");
+        return mCtx.getRenderContext()->readTextureSubresource(pOutput->asTexture().get(), 0);
+    }
+
+    /// Dictionary shared by the passes of the graph.
+    Dictionary& getDictionary() { return mpGraph->getPassesDictionary(); }
+
+private:
+    GPUUnitTestContext& mCtx;
+    ref<RenderGraph> mpGraph;
+};
+
+float getFirstPixel(const std::vector<uint8_t>& data)
+{
+    return reinterpret_cast<const float*>(data.data())[0];
+}
+} // namespace
+
+GPU_TEST(AccumulatePass_CheckpointResume)
+{
+    const std::filesystem::path path = "test_accumulate_pass_checkpoint.bin";
+    const uint32_t totalFrames = 8;
+    const uint32_t checkpointFrame = 5;
+
+    for (const char* mode : {"Single", "SingleCompensated", "Double"})
+    {
+        std::filesystem::remove(path);
+
+        // Uninterrupted accumulation, writing a checkpoint after 'checkpointFrame' frames.
+        std::vector<uint8_t> reference;
+        {
+            Properties props;
+            props["precisionMode"] = std::string(mode);
+            props["convergenceThreshold"] = 0.001f;
+            props["checkpointPath"] = path;
+            props["checkpointInterval"] = checkpointFrame;
+            AccumulationRunner runner(ctx, props);
+            for (uint32_t i = 0; i < totalFrames; ++i)
+                reference = runner.run(createInputFrame(ctx.getDevice(), i, 10.f, 5.f));
+        }
+        ASSERT(std::filesystem::exists(path));
+
+        // Resumed accumulation produces bit-identical results.
+        {
+            Properties props;
+            props["precisionMode"] = std::string(mode);
+            props["convergenceThreshold"] = 0.001f;
+            props["resumeFromCheckpoint"] = path;
+            AccumulationRunner runner(ctx, props);
+            std::vector<uint8_t> result;
+            for (uint32_t i = checkpointFrame; i < totalFrames; ++i)
+                result = runner.run(createInputFrame(ctx.getDevice(), i, 10.f, 5.f));
+            EXPECT(result == reference) << "mode " << mode;
+        }
+
+        // Resuming with a different configuration fails.
+        {
+            Properties props;
+            props["precisionMode"] = std::string(mode == std::string("Double") ? "Single" : "Double");
+            props["resumeFromCheckpoint"] = path;
+            EXPECT_THROW(AccumulationRunner runner(ctx, props));
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(AccumulatePass_CheckpointSampleIndex)
+{
+    const std::filesystem::path path = "test_accumulate_pass_sample_index.bin";
+    const uint32_t totalFrames = 8;
+    const uint32_t checkpointFrame = 5;
+    std::filesystem::remove(path);
+
+    // The renderer publishes the sample index of the next frame before the accumulation executes.
+    std::vector<uint8_t> reference;
+    {
+        Properties props;
+        props["checkpointPath"] = path;
+        props["checkpointInterval"] = checkpointFrame;
+        AccumulationRunner runner(ctx, props);
+        for (uint32_t i = 0; i < totalFrames; ++i)
+        {
+            runner.getDictionary().setValue(kRenderPassSampleIndexKey, i + 1);
+            reference = runner.run(createInputFrame(ctx.getDevice(), i, 10.f, 5.f));
+        }
+    }
+    ASSERT(std::filesystem::exists(path));
+    EXPECT_EQ(AccumulationCheckpoint::read(path).metadata.get<uint32_t>("sampleIndex", 0), checkpointFrame);
+
+    // Resuming hands the sample index back to the renderer and discards the first frame.
+    // The renderer then continues its sequence and the result is bit-identical.
+    {
+        Properties props;
+        props["resumeFromCheckpoint"] = path;
+        AccumulationRunner runner(ctx, props);
+        Dictionary& dict = runner.getDictionary();
+        dict.setValue(kRenderPassSampleIndexKey, 1u);
+        runner.run(createInputFrame(ctx.getDevice(), 0, 10.f, 5.f));
+        const uint32_t sampleIndex = dict.getValue(kRenderPassSampleIndexKey);
+        EXPECT_EQ(sampleIndex, checkpointFrame);
+
+        std::vector<uint8_t> result;
+        for (uint32_t i = sampleIndex; i < totalFrames; ++i)
+        {
+            dict.setValue(kRenderPassSampleIndexKey, i + 1);
+            result = runner.run(createInputFrame(ctx.getDevice(), i, 10.f, 5.f));
+        }
+        EXPECT(result == reference);
+    }
+
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(AccumulatePass_Convergence)
+{
+    // A noise-free image converges at the first error estimate.
+    // Accumulation stops after that and the output retains the converged image.
+    // The estimate is read back without waiting for the GPU. Reading the output waits for the GPU,
+    // so here the estimate is available at the next frame.
+    {
+        Properties props;
+        props["convergenceThreshold"] = 0.01f;
+        props["convergenceMinFrames"] = 4u;
+        props["convergenceInterval"] = 4u;
+        AccumulationRunner runner(ctx, props);
+        for (uint32_t i = 0; i < 4; ++i)
+            runner.run(createInputFrame(ctx.getDevice(), i, 1.f, 0.f));
+        for (uint32_t i = 4; i < 8; ++i)
+            EXPECT_EQ(getFirstPixel(runner.run(createInputFrame(ctx.getDevice(), i, 2.f, 0.f))), 1.f) << "frame " << i;
+    }
+
+    // A noisy image doesn't converge to a tight threshold.
+    {
+        Properties props;
+        props["convergenceThreshold"] = 1e-4f;
+        props["convergenceMinFrames"] = 4u;
+        props["convergenceInterval"] = 4u;
+        AccumulationRunner runner(ctx, props);
+        std::vector<uint8_t> previous;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            auto output = runner.run(createInputFrame(ctx.getDevice(), i, 1.f, 0.5f));
+            EXPECT(output != previous) << "frame " << i;
+            previous = std::move(output);
+        }
+    }
+
+    // Accumulation stops at the frame limit regardless of the error.
+    {
+        Properties props;
+        props["convergenceThreshold"] = 1e-4f;
+        props["convergenceMaxFrames"] = 8u;
+        AccumulationRunner runner(ctx, props);
+        std::vector<uint8_t> converged;
+        for (uint32_t i = 0; i < 8; ++i)
+            converged = runner.run(createInputFrame(ctx.getDevice(), i, 1.f, 0.5f));
+        for (uint32_t i = 8; i < 12; ++i)
+            EXPECT(runner.run(createInputFrame(ctx.getDevice(), i, 1.f, 0.5f)) == converged) << "frame " << i;
+    }
+}
+} // namespace Falcor
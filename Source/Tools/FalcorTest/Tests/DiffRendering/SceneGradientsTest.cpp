@@ -27,6 +27,11 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "DiffRendering/SceneGradients.h"
+#include "DiffRendering/HostGradientAggregator.h"
+#include "Core/API/GpuTimer.h"
+
+#include <algorithm>
+#include <random>
 
 namespace Falcor
 {
@@ -34,6 +39,65 @@ namespace
 {
 const char kShaderFile[] = "Tests/DiffRendering/SceneGradientsTest.cs.slang";
 
+/// List of gradients accumulated into hash slots.
+struct GradEntries
+{
+    std::vector<uint2> indices; ///< Gradient index and hash index.
+    std::vector<float> values;
+};
+
+/**
+ * Create random gradient entries touching a fraction of the parameters.
+ * Touched parameters are spread uniformly, so that most touched blocks contain few parameters.
+ */
+GradEntries createGradEntries(uint32_t gradDim, uint32_t hashSize, float touchedFraction, uint32_t entryCount, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> params(gradDim);
+    for (uint32_t i = 0; i < gradDim; i++)
+        params[i] = i;
+    std::shuffle(params.begin(), params.end(), rng);
+    params.resize(std::max(1u, uint32_t(gradDim * touchedFraction)));
+
+    std::uniform_real_distribution<float> valueDist(-1.f, 1.f);
+    GradEntries entries;
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        entries.indices.push_back(uint2(params[rng() % params.size()], rng() % hashSize));
+        entries.values.push_back(valueDist(rng));
+    }
+    return entries;
+}
+
+/// Compare gradients summed in different orders.
+bool isClose(float value, float refValue)
+{
+    return std::abs(value - refValue) <= 1e-5f * std::max(1.f, std::abs(refValue));
+}
+
+void accumulate(HostGradientAggregator& aggregator, const GradEntries& entries)
+{
+    for (size_t i = 0; i < entries.indices.size(); i++)
+        aggregator.atomicAddGrad(entries.indices[i].x, entries.indices[i].y, entries.values[i]);
+}
+
+void accumulate(GPUUnitTestContext& ctx, SceneGradients& sceneGradients, const GradEntries& entries)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    uint32_t entryCount = (uint32_t)entries.indices.size();
+
+    ctx.createProgram(kShaderFile, "accumulateEntries");
+    ctx["CB"]["entryCount"] = entryCount;
+    ctx["entryIndices"] = pDevice->createStructuredBuffer(
+        sizeof(uint2), entryCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, entries.indices.data()
+    );
+    ctx["entryValues"] = pDevice->createStructuredBuffer(
+        sizeof(float), entryCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, entries.values.data()
+    );
+    sceneGradients.bindShaderData(ctx["gSceneGradients"]);
+    ctx.runProgram(entryCount, 1, 1);
+}
+
 void testAggregateGradients(GPUUnitTestContext& ctx, const uint32_t hashSize)
 {
     // We create a gradient vector with dimension = 3.
@@ -79,4 +143,182 @@ GPU_TEST(AggregateGradients, Device::Type::D3D12)
 {
     testAggregateGradients(ctx, 64);
 }
+
+CPU_TEST(HostGradientAggregator_SparseMatchesDense)
+{
+    const uint32_t gradDim = 1000; // Not a multiple of the block size.
+    const uint32_t hashSize = 16;
+
+    for (float touchedFraction : {0.001f, 0.05f, 1.f})
+    {
+        HostGradientAggregator direct(gradDim, hashSize, GradientAggregateMode::Direct);
+        HostGradientAggregator hashGrid(gradDim, hashSize, GradientAggregateMode::HashGrid);
+        HostGradientAggregator sparse(gradDim, hashSize, GradientAggregateMode::Sparse);
+
+        // Run a few iterations to check that clearing resets all state.
+        for (uint32_t iteration = 0; iteration < 3; iteration++)
+        {
+            GradEntries entries = createGradEntries(gradDim, hashSize, touchedFraction, 5000, iteration);
+            GradEntries directEntries = entries;
+            for (auto& index : directEntries.indices)
+                index.y = 0;
+
+            for (auto* pAggregator : {&direct, &hashGrid, &sparse})
+                pAggregator->clear();
+            accumulate(direct, directEntries);
+            accumulate(hashGrid, entries);
+            accumulate(sparse, entries);
+            for (auto* pAggregator : {&direct, &hashGrid, &sparse})
+                pAggregator->aggregate();
+
+            for (uint32_t i = 0; i < gradDim; i++)
+            {
+                EXPECT(isClose(hashGrid.getGrads()[i], direct.getGrads()[i])) << "i = " << i;
+                EXPECT_EQ(sparse.getGrads()[i], hashGrid.getGrads()[i]) << "i = " << i;
+            }
+
+            // Only touched blocks are reduced, and the slots and mask are consumed.
+            std::vector<bool> touched(HostGradientAggregator::getBlockCount(gradDim), false);
+            for (const auto& index : entries.indices)
+                touched[index.x / kGradientBlockSize] = true;
+            std::vector<uint32_t> touchedBlocks;
+            for (uint32_t block = 0; block < touched.size(); block++)
+                if (touched[block])
+                    touchedBlocks.push_back(block);
+            EXPECT(sparse.getTouchedBlocks() == touchedBlocks);
+            EXPECT_LE(sparse.getReducedEntryCount(), uint64_t(touchedBlocks.size()) * kGradientBlockSize * hashSize);
+            EXPECT_EQ(hashGrid.getReducedEntryCount(), uint64_t(gradDim) * hashSize);
+            for (float value : sparse.getTmpGrads())
+                EXPECT_EQ(value, 0.f);
+            for (uint32_t word : sparse.getTouchedBlockMask())
+                EXPECT_EQ(word, 0u);
+        }
+    }
+}
+
+CPU_TEST(HostGradientAggregator_Accumulate)
+{
+    HostGradientAggregator sparse(100, 4, GradientAggregateMode::Sparse);
+    sparse.atomicAddGrad(3, 0, 1.f);
+    sparse.atomicAddGrad(3, 2, 2.f);
+    sparse.atomicAddGrad(99, 1, 4.f);
+    sparse.atomicAddGrad(100, 1, 8.f); // Out of range, ignored.
+    EXPECT_EQ(sparse.getTouchedBlockMask()[0], 0b1001u);
+
+    // Gradients accumulate until cleared, aggregating twice doesn't count slots twice.
+    sparse.aggregate();
+    sparse.aggregate();
+    EXPECT_EQ(sparse.getGrads()[3], 3.f);
+    EXPECT_EQ(sparse.getGrads()[99], 4.f);
+    EXPECT_EQ(sparse.getReducedEntryCount(), 0);
+    sparse.atomicAddGrad(3, 1, 1.f);
+    sparse.aggregate();
+    EXPECT_EQ(sparse.getGrads()[3], 4.f);
+    EXPECT(sparse.getTouchedBlocks() == std::vector<uint32_t>({0}));
+
+    // Clearing resets gradients that were accumulated but not aggregated.
+    sparse.atomicAddGrad(50, 3, 1.f);
+    sparse.clear();
+    sparse.aggregate();
+    for (float value : sparse.getGrads())
+        EXPECT_EQ(value, 0.f);
+}
+
+// Disabled on Vulkan for now as the compiler generates invalid code.
+GPU_TEST(AggregateGradientsSparse, Device::Type::D3D12)
+{
+    const uint32_t gradDim = 100000;
+    const uint32_t hashSize = 8;
+
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+
+    ref<SceneGradients> pSceneGradients = SceneGradients::create(
+        pDevice, {{GradientType::Material, gradDim, hashSize}}, GradientAggregateMode::Sparse
+    );
+    HostGradientAggregator reference(gradDim, hashSize, GradientAggregateMode::Sparse);
+
+    for (uint32_t iteration = 0; iteration < 4; iteration++)
+    {
+        GradEntries entries = createGradEntries(gradDim, hashSize, iteration == 3 ? 1.f : 0.01f, 20000, iteration);
+
+        pSceneGradients->clearGrads(pRenderContext, GradientType::Material);
+        reference.clear();
+        accumulate(ctx, *pSceneGradients, entries);
+        accumulate(reference, entries);
+
+        // Gradients of the second iteration are discarded by clearing, without aggregating them first.
+        if (iteration == 1)
+            continue;
+
+        pSceneGradients->aggregateGrads(pRenderContext, GradientType::Material);
+        reference.aggregate();
+
+        std::vector<float> result = pSceneGradients->getGradsBuffer(GradientType::Material)->getElements<float>();
+        ASSERT_EQ(result.size(), gradDim);
+        for (uint32_t i = 0; i < gradDim; i++)
+            EXPECT(isClose(result[i], reference.getGrads()[i])) << "iteration = " << iteration << ", i = " << i;
+    }
+
+    // All slots are consumed.
+    std::vector<float> tmpGrads = pSceneGradients->getTmpGradsBuffer(GradientType::Material)->getElements<float>();
+    for (size_t i = 0; i < tmpGrads.size(); i++)
+        EXPECT_EQ(tmpGrads[i], 0.f) << "i = " << i;
+}
+
+GPU_TEST(AggregateGradients_Benchmark, Device::Type::D3D12, TAGS("benchmark"), "Disabled for performance reasons")
+{
+    const uint32_t hashSize = 64;
+    const uint32_t kIterations = 10;
+
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+    ref<GpuTimer> pTimer = GpuTimer::create(pDevice);
+
+    for (uint32_t gradDim : {10000u, 100000u, 1000000u})
+    {
+        for (float touchedFraction : {0.001f, 0.01f, 0.1f, 1.f})
+        {
+            // Roughly four gradients per touched parameter.
+            GradEntries entries = createGradEntries(gradDim, hashSize, touchedFraction, std::max(1000u, uint32_t(4 * gradDim * touchedFraction)), 0);
+
+            double times[2] = {};
+            for (auto mode : {GradientAggregateMode::HashGrid, GradientAggregateMode::Sparse})
+            {
+                ref<SceneGradients> pSceneGradients = SceneGradients::create(pDevice, {{GradientType::Material, gradDim, hashSize}}, mode);
+
+                // Time clearing and aggregation, which are the costs depending on the aggregate mode.
+                double time = 0.0;
+                for (uint32_t i = 0; i < kIterations; i++)
+                {
+                    pTimer->begin();
+                    pSceneGradients->clearGrads(pRenderContext, GradientType::Material);
+                    pTimer->end();
+                    pTimer->resolve();
+                    pRenderContext->submit(true);
+                    time += pTimer->getElapsedTime();
+
+                    accumulate(ctx, *pSceneGradients, entries);
+
+                    pTimer->begin();
+                    pSceneGradients->aggregateGrads(pRenderContext, GradientType::Material);
+                    pTimer->end();
+                    pTimer->resolve();
+                    pRenderContext->submit(true);
+                    time += pTimer->getElapsedTime();
+                }
+                times[mode == GradientAggregateMode::Sparse ? 1 : 0] = time / kIterations;
+            }
+
+            logInfo(
+                "AggregateGradients_Benchmark: dim {:>8} touched {:>6.1f}%: HashGrid {:.3f} ms, Sparse {:.3f} ms ({:.1f}x)",
+                gradDim,
+                touchedFraction * 100.f,
+                times[0],
+                times[1],
+                times[1] > 0.0 ? times[0] / times[1] : 0.0
+            );
+        }
+    }
+}
 } // namespace Falcor
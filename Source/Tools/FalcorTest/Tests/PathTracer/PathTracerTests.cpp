@@ -0,0 +1,124 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Plugin.h"
+#include "RenderGraph/RenderGraph.h"
+#include "Rendering/Utils/AdaptiveSampling.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <cmath>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint2 kFrameDim = {32, 32};
+const float3 kEmission = {1.f, 0.5f, 0.25f};
+
+/// Create a scene where every pixel sees an emissive, non-reflective plane. The radiance of all pixels is constant.
+ref<Scene> createEmissiveScene(ref<Device> pDevice)
+{
+    SceneBuilder builder(pDevice, {}, SceneBuilder::Flags::DontOptimizeGraph | SceneBuilder::Flags::DontMergeMeshes);
+
+    auto pMaterial = StandardMaterial::create(pDevice, "Emissive");
+    pMaterial->setBaseColor(float4(0.f, 0.f, 0.f, 1.f));
+    pMaterial->setEmissiveColor(kEmission);
+    MeshID meshID = builder.addTriangleMesh(TriangleMesh::createQuad(float2(100.f)), pMaterial);
+    NodeID nodeID = builder.addNode({"Plane", float4x4::identity()});
+    builder.addMeshInstance(nodeID, meshID);
+
+    auto pCamera = Camera::create("Camera");
+    pCamera->setPosition(float3(0.f, 1.f, 0.f));
+    pCamera->setTarget(float3(0.f, 0.f, 0.f));
+    pCamera->setUpVector(float3(0.f, 0.f, -1.f));
+    builder.addCamera(pCamera);
+
+    return builder.getScene();
+}
+
+/// Render frames with the path tracer and accumulate them. Returns the accumulated output.
+std::vector<float4> renderAccumulated(GPUUnitTestContext& ctx, const ref<Scene>& pScene, bool useAdaptiveSampling, uint32_t frameCount)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    for (const char* plugin : {"GBuffer", "PathTracer", "AccumulatePass"})
+        PluginManager::instance().loadPluginByName(plugin);
+
+    ref<RenderGraph> pGraph = RenderGraph::create(pDevice, "PathTracer");
+    Properties pathTracerProps;
+    pathTracerProps["useAdaptiveSampling"] = useAdaptiveSampling;
+    pGraph->createPass("VBuffer", "VBufferRT", {});
+    pGraph->createPass("PathTracer", "PathTracer", pathTracerProps);
+    pGraph->createPass("Accumulate", "AccumulatePass", {});
+    pGraph->addEdge("VBuffer.vbuffer", "PathTracer.vbuffer");
+    pGraph->addEdge("PathTracer.color", "Accumulate.input");
+    pGraph->markOutput("Accumulate.output");
+    pGraph->setScene(pScene);
+    ref<Fbo> pTargetFbo = Fbo::create2D(pDevice, kFrameDim.x, kFrameDim.y, ResourceFormat::RGBA32Float);
+    pGraph->onResize(pTargetFbo.get());
+
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        pScene->update(pRenderContext, 0.0);
+        pGraph->execute(pRenderContext);
+    }
+
+    ref<Resource> pOutput = pGraph->getOutput("Accumulate.output");
+    std::vector<uint8_t> data = pRenderContext->readTextureSubresource(pOutput->asTexture().get(), 0);
+    const float4* pData = reinterpret_cast<const float4*>(data.data());
+    return std::vector<float4>(pData, pData + kFrameDim.x * kFrameDim.y);
+}
+} // namespace
+
+GPU_TEST(PathTracer_AdaptiveSamplingUnbiased)
+{
+    if (!ctx.getDevice()->isFeatureSupported(Device::SupportedFeatures::Raytracing))
+        ctx.skip("Ray tracing is not supported");
+
+    ref<Scene> pScene = createEmissiveScene(ctx.getDevice());
+    ASSERT(pScene != nullptr);
+
+    // All pixels converge once adaptive sampling starts adapting (after 'minFrameCount' frames).
+    // Converged pixels must still be sampled, otherwise frames with black pixels are accumulated.
+    const uint32_t frameCount = 4 * AdaptiveSamplingParams().minFrameCount;
+    std::vector<float4> adaptive = renderAccumulated(ctx, pScene, true, frameCount);
+    std::vector<float4> uniform = renderAccumulated(ctx, pScene, false, frameCount);
+
+    // The per-sample colors are stored in a compressed format, so allow a small error.
+    for (size_t i = 0; i < adaptive.size(); ++i)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            EXPECT_LE(std::abs(uniform[i][c] - kEmission[c]), 0.01f * kEmission[c]) << "pixel " << i << " channel " << c;
+            EXPECT_LE(std::abs(adaptive[i][c] - kEmission[c]), 0.01f * kEmission[c]) << "pixel " << i << " channel " << c;
+        }
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,130 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/AsyncFileReader.h"
+
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<uint8_t> writeRandomFile(const std::filesystem::path& path, size_t size, uint32_t seed)
+{
+    std::vector<uint8_t> data(size);
+    std::mt19937 rng(seed);
+    for (auto& b : data)
+        b = rng() & 0xff;
+    std::ofstream ofs(path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return data;
+}
+
+void testReader(CPUUnitTestContext& ctx, AsyncFileReader& reader, const std::string& name)
+{
+    const std::filesystem::path pathA = std::filesystem::absolute(fmt::format("test_async_file_reader_{}_a.bin", name));
+    const std::filesystem::path pathB = std::filesystem::absolute(fmt::format("test_async_file_reader_{}_b.bin", name));
+    // Sizes not multiple of the chunk size.
+    auto dataA = writeRandomFile(pathA, 3 * AsyncFileReader::kChunkSize + 1234, 1);
+    auto dataB = writeRandomFile(pathB, 4567, 2);
+
+    std::vector<uint8_t> bufferA(dataA.size());
+    std::vector<uint8_t> bufferRange(AsyncFileReader::kChunkSize + 100);
+    std::vector<uint8_t> bufferB(dataB.size() + 100);
+    std::vector<uint8_t> bufferMissing(16);
+
+    std::vector<AsyncFileReader::Request> requests = {
+        {pathA, 0, bufferA.size(), bufferA.data()},
+        {pathA, AsyncFileReader::kChunkSize - 50, bufferRange.size(), bufferRange.data()},
+        {pathB, 0, bufferB.size(), bufferB.data()}, // Extends past the end of the file.
+        {"__file_that_does_not_exist__", 0, bufferMissing.size(), bufferMissing.data()},
+        {pathB, 0, 0, nullptr},
+    };
+    auto results = reader.read(requests);
+    ASSERT_EQ(results.size(), requests.size());
+
+    EXPECT(results[0].success);
+    EXPECT_EQ(results[0].bytesRead, dataA.size());
+    EXPECT(bufferA == dataA);
+
+    EXPECT(results[1].success);
+    EXPECT_EQ(results[1].bytesRead, bufferRange.size());
+    EXPECT(std::memcmp(bufferRange.data(), dataA.data() + AsyncFileReader::kChunkSize - 50, bufferRange.size()) == 0);
+
+    EXPECT(results[2].success);
+    EXPECT_EQ(results[2].bytesRead, dataB.size());
+    EXPECT(std::memcmp(bufferB.data(), dataB.data(), dataB.size()) == 0);
+
+    EXPECT(!results[3].success);
+    EXPECT_EQ(results[3].bytesRead, 0);
+
+    EXPECT(results[4].success);
+    EXPECT_EQ(results[4].bytesRead, 0);
+
+    EXPECT(reader.read({}).empty());
+
+    // Concurrent batches.
+    std::vector<std::vector<uint8_t>> buffers(8, std::vector<uint8_t>(dataA.size()));
+    std::vector<std::future<std::vector<AsyncFileReader::Result>>> futures;
+    for (auto& buffer : buffers)
+        futures.push_back(reader.submit({{pathA, 0, buffer.size(), buffer.data()}}));
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        auto batchResults = futures[i].get();
+        ASSERT_EQ(batchResults.size(), 1);
+        EXPECT(batchResults[0].success);
+        EXPECT(buffers[i] == dataA);
+    }
+
+    std::filesystem::remove(pathA);
+    std::filesystem::remove(pathB);
+}
+} // namespace
+
+CPU_TEST(AsyncFileReader_IoUring)
+{
+    // Falls back to the thread pool if io_uring is not available.
+    AsyncFileReader reader(AsyncFileReader::Backend::IoUring, 8);
+#if !FALCOR_LINUX
+    EXPECT(reader.getBackend() == AsyncFileReader::Backend::ThreadPool);
+#endif
+    EXPECT_LE(reader.getQueueDepth(), 8);
+    testReader(ctx, reader, "io_uring");
+}
+
+CPU_TEST(AsyncFileReader_ThreadPool)
+{
+    AsyncFileReader reader(AsyncFileReader::Backend::ThreadPool, 8);
+    EXPECT(reader.getBackend() == AsyncFileReader::Backend::ThreadPool);
+    EXPECT_EQ(reader.getQueueDepth(), 8);
+    testReader(ctx, reader, "thread_pool");
+}
+
+} // namespace Falcor
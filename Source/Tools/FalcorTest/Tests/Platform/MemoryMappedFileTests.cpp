@@ -28,13 +28,60 @@
 #include "Testing/UnitTest.h"
 #include "Core/Platform/OS.h"
 #include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/AsyncFileReader.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
 
 #include <vector>
 #include <fstream>
+#include <functional>
 #include <random>
 
+#if FALCOR_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace Falcor
 {
+namespace
+{
+/// Removes the file when going out of scope, so it is cleaned up even if an assertion fails.
+struct TempFileRemover
+{
+    std::filesystem::path path;
+    ~TempFileRemover()
+    {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+uint64_t computeChecksum(const void* data, size_t size)
+{
+    const uint64_t* words = static_cast<const uint64_t*>(data);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size / sizeof(uint64_t); ++i)
+        sum += words[i];
+    return sum;
+}
+
+/// Write back and drop the file from the page cache, so the next read is cold. Returns false if not supported.
+bool dropFromPageCache(const std::filesystem::path& path)
+{
+#if FALCOR_LINUX
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool result = ::fdatasync(fd) == 0 && ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return result;
+#else
+    return false;
+#endif
+}
+} // namespace
+
 CPU_TEST(MemoryMappedFile_Closed)
 {
     MemoryMappedFile file;
@@ -114,4 +161,154 @@ CPU_TEST(MemoryMappedFile_Read)
     std::filesystem::remove(tempPath);
 }
 
+CPU_TEST(MemoryMappedFile_Prefetch)
+{
+    std::vector<uint8_t> randomData(4 * 1024 * 1024 + 123);
+    std::mt19937 rng;
+    for (size_t i = 0; i < randomData.size(); ++i)
+        randomData[i] = rng() & 0xff;
+
+    const std::filesystem::path tempPath = std::filesystem::absolute("test_memory_mapped_prefetch.bin");
+
+    // Write file with random data.
+    std::ofstream ofs(tempPath, std::ios::binary);
+    ASSERT_TRUE(ofs.good());
+    ofs.write(reinterpret_cast<const char*>(randomData.data()), randomData.size());
+    ofs.close();
+
+    {
+        // Closed files can't be prefetched.
+        MemoryMappedFile file;
+        EXPECT_EQ(file.prefetch(), false);
+    }
+
+    {
+        // Prefetch ranges (unaligned, clamped and out of bounds).
+        MemoryMappedFile file(tempPath, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess);
+        ASSERT_TRUE(file.isOpen());
+        EXPECT_EQ(file.prefetch(), true);
+        EXPECT_EQ(file.prefetch(12345, 100000), true);
+        EXPECT_EQ(file.prefetch(randomData.size() - 10, MemoryMappedFile::kWholeFile), true);
+        EXPECT_EQ(file.prefetch(randomData.size()), false);
+        EXPECT(std::memcmp(file.getData(), randomData.data(), randomData.size()) == 0);
+    }
+
+    {
+        // Populate the mapping up front, with huge pages if supported.
+        MemoryMappedFile file(
+            tempPath,
+            MemoryMappedFile::kWholeFile,
+            MemoryMappedFile::AccessHint::SequentialScan,
+            MemoryMappedFile::MapFlags::Populate | MemoryMappedFile::MapFlags::HugePages
+        );
+        ASSERT_TRUE(file.isOpen());
+        EXPECT_EQ(file.getMappedSize(), randomData.size());
+        EXPECT(std::memcmp(file.getData(), randomData.data(), randomData.size()) == 0);
+    }
+
+    // Cleanup.
+    std::filesystem::remove(tempPath);
+}
+
+CPU_TEST(MemoryMappedFile_ReadBenchmark, TAGS("benchmark"), "Disabled for performance reasons")
+{
+    // File written in blocks of random data. Increase the size to benchmark larger files.
+    const size_t kBlockSize = 16 * 1024 * 1024;
+    const size_t kFileSize = size_t(256) * 1024 * 1024;
+    const std::filesystem::path tempPath = getTempFilePath();
+    TempFileRemover tempFileRemover{tempPath};
+
+    uint64_t referenceChecksum = 0;
+    {
+        std::vector<uint64_t> block(kBlockSize / sizeof(uint64_t));
+        std::mt19937_64 rng;
+        for (auto& word : block)
+            word = rng();
+        std::ofstream ofs(tempPath, std::ios::binary);
+        ASSERT_TRUE(ofs.good());
+        for (size_t i = 0; i < kFileSize / kBlockSize; ++i)
+        {
+            block[0] = i;
+            ofs.write(reinterpret_cast<const char*>(block.data()), kBlockSize);
+            referenceChecksum += computeChecksum(block.data(), kBlockSize);
+        }
+        ofs.close();
+        ASSERT_TRUE(ofs.good());
+    }
+
+    // Destination of the non-mapped reads, touched once so page faults are not part of the measurements.
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[kFileSize]);
+    std::memset(buffer.get(), 0, kFileSize);
+    AsyncFileReader reader;
+
+    struct Method
+    {
+        std::string name;
+        std::function<uint64_t()> read;
+    };
+    const std::vector<Method> methods = {
+        {"mmap",
+         [&]()
+         {
+             MemoryMappedFile file(tempPath, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+             return computeChecksum(file.getData(), file.getMappedSize());
+         }},
+        {"mmap + prefetch",
+         [&]()
+         {
+             MemoryMappedFile file(tempPath, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+             file.prefetch();
+             return computeChecksum(file.getData(), file.getMappedSize());
+         }},
+        {"mmap + populate",
+         [&]()
+         {
+             MemoryMappedFile file(
+                 tempPath,
+                 MemoryMappedFile::kWholeFile,
+                 MemoryMappedFile::AccessHint::SequentialScan,
+                 MemoryMappedFile::MapFlags::Populate | MemoryMappedFile::MapFlags::HugePages
+             );
+             return computeChecksum(file.getData(), file.getMappedSize());
+         }},
+        {reader.getBackend() == AsyncFileReader::Backend::IoUring ? "async (io_uring)" : "async (thread pool)",
+         [&]()
+         {
+             auto results = reader.read({{tempPath, 0, kFileSize, buffer.get()}});
+             return results[0].bytesRead == kFileSize ? computeChecksum(buffer.get(), kFileSize) : 0;
+         }},
+    };
+
+    // Cold reads need to drop the file from the page cache, which is not supported on all platforms.
+    const bool cold = dropFromPageCache(tempPath);
+    if (!cold)
+        logWarning("MemoryMappedFile_ReadBenchmark: Dropping the page cache is not supported, only warm reads are measured.");
+
+    CpuTimer timer;
+    for (const auto& method : methods)
+    {
+        double times[2] = {0.0, 0.0};
+        for (int pass = cold ? 0 : 1; pass < 2; ++pass)
+        {
+            if (pass == 0)
+                dropFromPageCache(tempPath);
+            timer.update();
+            uint64_t checksum = method.read();
+            timer.update();
+            times[pass] = timer.delta();
+            EXPECT_EQ(checksum, referenceChecksum);
+        }
+
+        auto throughput = [&](double time) { return time > 0.0 ? double(kFileSize) / (1024 * 1024) / time : 0.0; };
+        logInfo(
+            "MemoryMappedFile_ReadBenchmark: {:<20} cold {:.3f} s ({:.0f} MB/s), warm {:.3f} s ({:.0f} MB/s)",
+            method.name,
+            times[0],
+            throughput(times[0]),
+            times[1],
+            throughput(times[1])
+        );
+    }
+}
+
 } // namespace Falcor
@@ -0,0 +1,185 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "RenderGraph/RenderGraph.h"
+#include "RenderGraph/RenderGraphImportExport.h"
+#include <nlohmann/json.hpp>
+#include <regex>
+
+namespace Falcor
+{
+namespace
+{
+const char kValidGraph[] = R"({
+    "version": 1,
+    "name": "Test",
+    "passes": [
+        { "name": "A", "type": "TypeA", "properties": { "value": 1 } },
+        { "name": "B", "type": "TypeB" }
+    ],
+    "edges": [
+        { "src": "A.output", "dst": "B.input" },
+        { "src": "A", "dst": "B" }
+    ],
+    "outputs": [
+        { "name": "B.output" },
+        { "name": "B.output", "mask": "RGBA" }
+    ]
+})";
+
+void validate(const Properties::json& json)
+{
+    RenderGraphImporter::validateJson(json);
+}
+} // namespace
+
+CPU_TEST(RenderGraphJson_Validation)
+{
+    using json = Properties::json;
+    const json valid = json::parse(kValidGraph);
+    validate(valid);
+
+    auto modified = [&](auto func)
+    {
+        json j = valid;
+        func(j);
+        return j;
+    };
+
+    // Invalid documents.
+    EXPECT_THROW(validate(json::array()));
+    EXPECT_THROW(validate(modified([](json& j) { j.erase("version"); })));
+    EXPECT_THROW(validate(modified([](json& j) { j["version"] = 2; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["name"] = 1; })));
+    EXPECT_THROW(validate(modified([](json& j) { j.erase("passes"); })));
+    EXPECT_THROW(validate(modified([](json& j) { j["unknown"] = true; })));
+
+    // Invalid passes.
+    EXPECT_THROW(validate(modified([](json& j) { j["passes"][0]["name"] = "A.B"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["passes"][0]["name"] = ""; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["passes"][1]["name"] = "A"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["passes"][0]["type"] = ""; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["passes"][0].erase("type"); })));
+    EXPECT_THROW(validate(modified([](json& j) { j["passes"][0]["properties"] = json::array(); })));
+
+    // Invalid edges.
+    EXPECT_THROW(validate(modified([](json& j) { j["edges"][0]["src"] = "C.output"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["edges"][0]["dst"] = "B"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["edges"][0].erase("dst"); })));
+
+    // Invalid outputs.
+    EXPECT_THROW(validate(modified([](json& j) { j["outputs"][0]["name"] = "B"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["outputs"][0]["name"] = "C.output"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["outputs"][0]["mask"] = "RGBX"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["outputs"][0]["mask"] = "RR"; })));
+    EXPECT_THROW(validate(modified([](json& j) { j["outputs"][0]["mask"] = ""; })));
+
+    // Optional sections.
+    validate(modified([](json& j) { j.erase("edges"); j.erase("outputs"); }));
+}
+
+GPU_TEST(RenderGraphJson_UnknownPassType)
+{
+    // Pass types are resolved before any pass is created.
+    EXPECT_THROW(RenderGraphImporter::importJsonString(ctx.getDevice(), kValidGraph));
+}
+
+GPU_TEST(RenderGraphJson_Properties)
+{
+    auto makeGraph = [](const std::string& properties)
+    {
+        return R"({ "version": 1, "name": "Test", "passes": [{ "name": "ToneMapper", "type": "ToneMapper", "properties": )" + properties +
+               " }] }";
+    };
+
+    ref<RenderGraph> pGraph = RenderGraphImporter::importJsonString(ctx.getDevice(), makeGraph(R"({ "exposureCompensation": 1.5 })"));
+    ASSERT(pGraph != nullptr);
+    EXPECT_EQ(pGraph->getPass("ToneMapper")->getProperties().get<float>("exposureCompensation"), 1.5f);
+
+    // Properties of the wrong type and properties unknown to the pass type.
+    EXPECT_THROW(RenderGraphImporter::importJsonString(ctx.getDevice(), makeGraph(R"({ "exposureCompensation": "high" })")));
+    EXPECT_THROW(RenderGraphImporter::importJsonString(ctx.getDevice(), makeGraph(R"({ "exposureCompensatoin": 1.5 })")));
+}
+
+GPU_TEST(RenderGraphJson_RoundTrip)
+{
+    // Round-trip all Python render graphs shipped with Falcor through the JSON format.
+    PluginManager& pm = PluginManager::instance();
+    const std::regex createPassRegex(R"(createPass\(\s*["'](\w+)["'])");
+    size_t graphCount = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(getProjectDirectory() / "scripts"))
+    {
+        if (entry.path().extension() != ".py")
+            continue;
+
+        // Graphs using passes that are not built in this configuration (e.g. optional SDKs) are skipped.
+        // All other errors fail the test.
+        const std::string script = readFile(entry.path());
+        std::string missingType;
+        for (auto it = std::sregex_iterator(script.begin(), script.end(), createPassRegex); it != std::sregex_iterator(); ++it)
+        {
+            const std::string type = (*it)[1];
+            if (!pm.hasClass<RenderPass>(type))
+                pm.loadPluginByName(type);
+            if (!pm.hasClass<RenderPass>(type))
+                missingType = type;
+        }
+        if (!missingType.empty())
+        {
+            logWarning("Skipping render graph '{}': pass type '{}' is not available.", entry.path(), missingType);
+            continue;
+        }
+
+        ref<RenderGraph> pGraph;
+        try
+        {
+            pGraph = RenderGraph::createFromFile(ctx.getDevice(), entry.path());
+        }
+        catch (const std::exception& e)
+        {
+            EXPECT_MSG(false, fmt::format("Failed to load render graph '{}': {}", entry.path(), e.what()));
+            continue;
+        }
+        EXPECT(pGraph != nullptr) << entry.path();
+        if (!pGraph)
+            continue;
+
+        std::string jsonText = RenderGraphExporter::getJson(pGraph);
+        ref<RenderGraph> pImported = RenderGraphImporter::importJsonString(ctx.getDevice(), jsonText);
+        ASSERT(pImported != nullptr);
+
+        EXPECT_EQ(pImported->getName(), pGraph->getName());
+        EXPECT_EQ(pImported->getOutputCount(), pGraph->getOutputCount());
+        EXPECT_EQ(RenderGraphExporter::getJson(pImported), jsonText) << entry.path();
+        graphCount++;
+    }
+
+    EXPECT_GT(graphCount, 0);
+}
+} // namespace Falcor
@@ -0,0 +1,195 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Materials/BSDFFitter.h"
+
+namespace Falcor
+{
+namespace
+{
+const std::vector<BSDFFitter::Params> kSyntheticParams = {
+    {float3(0.8f, 0.2f, 0.1f), 0.7f, 0.f},
+    {float3(0.9f, 0.6f, 0.3f), 0.3f, 1.f},
+    {float3(0.2f, 0.5f, 0.7f), 0.45f, 0.35f},
+    {float3(0.05f, 0.05f, 0.05f), 0.15f, 0.f},
+};
+
+void expectParamsNear(CPUUnitTestContext& ctx, const BSDFFitter::Params& params, const BSDFFitter::Params& ref, float eps)
+{
+    for (int c = 0; c < 3; c++)
+        EXPECT_LE(std::abs(params.baseColor[c] - ref.baseColor[c]), eps) << "c=" << c;
+    EXPECT_LE(std::abs(params.roughness - ref.roughness), eps);
+    EXPECT_LE(std::abs(params.metallic - ref.metallic), eps);
+}
+} // namespace
+
+CPU_TEST(BSDFFitter_EvalBRDF)
+{
+    // At normal incidence, the Fresnel and masking terms are trivial.
+    const float3 n(0.f, 0.f, 1.f);
+    BSDFFitter::Params params = {float3(0.6f, 0.4f, 0.2f), 0.5f, 0.25f};
+    float alpha = params.roughness * params.roughness;
+    float energyFactor = 1.f + (1.f / 1.51f - 1.f) * params.roughness;
+    float f0 = 0.04f;
+
+    float3 f = BSDFFitter::evalBRDF(params, n, n, 1.5f);
+    for (int c = 0; c < 3; c++)
+    {
+        float diffuse = params.baseColor[c] * (1.f - params.metallic) * energyFactor / float(M_PI);
+        float F0 = f0 * (1.f - params.metallic) + params.baseColor[c] * params.metallic;
+        float specular = F0 / (4.f * float(M_PI) * alpha * alpha);
+        EXPECT_LE(std::abs(f[c] - (diffuse + specular)), 1e-5f * (diffuse + specular));
+    }
+
+    // Reciprocity.
+    const float3 wi = normalize(float3(0.3f, -0.5f, 0.8f));
+    const float3 wo = normalize(float3(-0.6f, 0.1f, 0.4f));
+    float3 f1 = BSDFFitter::evalBRDF(params, wi, wo);
+    float3 f2 = BSDFFitter::evalBRDF(params, wo, wi);
+    for (int c = 0; c < 3; c++)
+        EXPECT_LE(std::abs(f1[c] - f2[c]), 1e-5f * f1[c]);
+
+    // Directions below the horizon.
+    f = BSDFFitter::evalBRDF(params, wi, float3(wo.x, wo.y, -wo.z));
+    EXPECT(all(f == float3(0.f)));
+
+    // The specular lobe turns into a delta lobe at low roughness.
+    params = {float3(0.f), 0.05f, 1.f};
+    f = BSDFFitter::evalBRDF(params, n, n);
+    EXPECT(all(f == float3(0.f)));
+}
+
+CPU_TEST(BSDFFitter_SliceDirections)
+{
+    // The slice has theta_h along x and theta_d along y, with theta_d = 0 at the top.
+    float3 wi, wo;
+    BSDFFitter::getSliceDirections(float2(0.f, 1.f), wi, wo);
+    EXPECT_LE(length(wi - float3(0.f, 0.f, 1.f)), 1e-6f);
+    EXPECT_LE(length(wo - float3(0.f, 0.f, 1.f)), 1e-6f);
+
+    for (float2 uv : {float2(0.25f, 0.5f), float2(0.7f, 0.9f), float2(0.4f, 0.1f)})
+    {
+        BSDFFitter::getSliceDirections(uv, wi, wo);
+        float3 h = normalize(wi + wo);
+        EXPECT_LE(std::abs(std::acos(h.z) - uv.x * float(M_PI_2)), 1e-4f);
+        EXPECT_LE(std::abs(std::acos(dot(wi, h)) - (1.f - uv.y) * float(M_PI_2)), 1e-4f);
+        EXPECT_LE(std::abs(length(wi) - 1.f), 1e-6f);
+        EXPECT_LE(std::abs(length(wo) - 1.f), 1e-6f);
+    }
+}
+
+CPU_TEST(BSDFFitter_FitSynthetic)
+{
+    BSDFFitter fitter;
+
+    std::vector<BSDFFitter::Target> targets;
+    for (size_t i = 0; i < kSyntheticParams.size(); i++)
+    {
+        targets.push_back(fitter.createTarget(kSyntheticParams[i], "synthetic" + std::to_string(i)));
+        EXPECT_LE(fitter.evalLoss(targets.back(), kSyntheticParams[i]), 1e-10f);
+    }
+
+    auto results = fitter.fit(targets);
+    ASSERT_EQ(results.size(), targets.size());
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        EXPECT_EQ(results[i].name, targets[i].name);
+        EXPECT_LE(results[i].loss, 1e-8f) << "target=" << i;
+        expectParamsNear(ctx, results[i].params, kSyntheticParams[i], 1e-3f);
+    }
+}
+
+CPU_TEST(BSDFFitter_FitAdam)
+{
+    BSDFFitter::Options options;
+    options.optimizer = BSDFFitter::Optimizer::Adam;
+    options.maxIterations = 1000;
+    options.startCount = 4;
+    BSDFFitter fitter(options);
+
+    const BSDFFitter::Params& ref = kSyntheticParams[0];
+    auto result = fitter.fit(fitter.createTarget(ref));
+    EXPECT_LE(result.loss, 1e-4f);
+    expectParamsNear(ctx, result.params, ref, 2e-2f);
+}
+
+CPU_TEST(BSDFFitter_MultiStart)
+{
+    const BSDFFitter::Params ref = {float3(0.7f, 0.7f, 0.7f), 0.2f, 0.5f};
+
+    BSDFFitter::Options options;
+    options.startCount = 8;
+    BSDFFitter fitter(options);
+    auto target = fitter.createTarget(ref);
+    auto result = fitter.fit(target);
+
+    // The best start is no worse than any single start.
+    for (uint32_t s = 0; s < options.startCount; s++)
+    {
+        BSDFFitter::Options singleOptions = options;
+        singleOptions.startCount = 1;
+        singleOptions.seed = s;
+        auto singleResult = BSDFFitter(singleOptions).fit(target);
+        EXPECT_LE(result.loss, singleResult.loss) << "start=" << s;
+    }
+
+    // Results are deterministic and independent of the number of threads.
+    options.threadCount = 1;
+    auto serialResult = BSDFFitter(options).fit(target);
+    EXPECT_EQ(serialResult.loss, result.loss);
+    EXPECT_EQ(serialResult.startIndex, result.startIndex);
+    EXPECT(all(serialResult.params.baseColor == result.params.baseColor));
+    EXPECT_EQ(serialResult.params.roughness, result.params.roughness);
+    EXPECT_EQ(serialResult.params.metallic, result.params.metallic);
+}
+
+CPU_TEST(BSDFFitter_Export)
+{
+    BSDFFitter fitter;
+    BSDFFitter::Result result;
+    result.params = kSyntheticParams[2];
+    result.loss = 0.5f;
+
+    DiffuseSpecularData data = fitter.toDiffuseSpecularData(result);
+    EXPECT(all(data.baseColor == result.params.baseColor));
+    EXPECT_EQ(data.roughness, result.params.roughness);
+    EXPECT_EQ(data.metallic, result.params.metallic);
+    EXPECT_EQ(data.lossValue, result.loss);
+    // IoR 1.5 corresponds to the default specular value of 0.5.
+    EXPECT_LE(std::abs(data.specular - 0.5f), 1e-6f);
+
+    BSDFFitter::Options options;
+    options.startCount = 0;
+    EXPECT_THROW(BSDFFitter{options});
+
+    BSDFFitter::Target target;
+    target.values.resize(3);
+    EXPECT_THROW(fitter.fit(target));
+}
+
+} // namespace Falcor
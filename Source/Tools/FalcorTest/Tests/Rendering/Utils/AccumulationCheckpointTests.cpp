@@ -0,0 +1,196 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/AccumulationCheckpoint.h"
+#include "Utils/Math/Vector.h"
+
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kWidth = 37;
+const uint32_t kHeight = 19;
+const size_t kPixelCount = kWidth * kHeight;
+
+/// CPU version of the accumulation state in the compensated and double precision modes.
+struct AccumulationState
+{
+    uint32_t frameCount = 0;
+    std::vector<float4> sum = std::vector<float4>(kPixelCount, float4(0.f));
+    std::vector<float4> corr = std::vector<float4>(kPixelCount, float4(0.f));
+    std::vector<double> sumDouble = std::vector<double>(kPixelCount * 4, 0.0);
+
+    void accumulate(uint32_t frameIndex)
+    {
+        // Input frames are deterministic given the frame index, like a renderer with a fixed seed.
+        std::mt19937 rng(frameIndex);
+        std::uniform_real_distribution<float> u(0.f, 1000.f);
+        for (size_t i = 0; i < kPixelCount; ++i)
+        {
+            float4 color(u(rng), u(rng), u(rng), u(rng));
+
+            float4 y = color - corr[i];
+            float4 sumNext = sum[i] + y;
+            corr[i] = (sumNext - sum[i]) - y;
+            sum[i] = sumNext;
+
+            for (uint32_t c = 0; c < 4; ++c)
+                sumDouble[i * 4 + c] += (double)color[c];
+        }
+        frameCount++;
+    }
+
+    AccumulationCheckpoint save() const
+    {
+        AccumulationCheckpoint checkpoint;
+        checkpoint.frameCount = frameCount;
+        checkpoint.metadata["frameIndex"] = frameCount;
+        auto add = [&](const std::string& name, ResourceFormat format, const void* data, size_t size)
+        {
+            AccumulationCheckpoint::Buffer buffer{format, kWidth, kHeight, {}};
+            buffer.data.resize(size);
+            std::memcpy(buffer.data.data(), data, size);
+            checkpoint.buffers[name] = std::move(buffer);
+        };
+        add("sum", ResourceFormat::RGBA32Float, sum.data(), sum.size() * sizeof(float4));
+        add("corr", ResourceFormat::RGBA32Float, corr.data(), corr.size() * sizeof(float4));
+        add("sumDouble", ResourceFormat::RGBA32Uint, sumDouble.data(), kPixelCount * 16);
+        // The double sums need two RGBA32Uint texels per pixel, the halves are stored in separate buffers.
+        add("sumDouble2", ResourceFormat::RGBA32Uint, reinterpret_cast<const uint8_t*>(sumDouble.data()) + kPixelCount * 16, kPixelCount * 16);
+        return checkpoint;
+    }
+
+    void load(const AccumulationCheckpoint& checkpoint)
+    {
+        frameCount = checkpoint.frameCount;
+        std::memcpy(sum.data(), checkpoint.buffers.at("sum").data.data(), sum.size() * sizeof(float4));
+        std::memcpy(corr.data(), checkpoint.buffers.at("corr").data.data(), corr.size() * sizeof(float4));
+        std::memcpy(sumDouble.data(), checkpoint.buffers.at("sumDouble").data.data(), kPixelCount * 16);
+        std::memcpy(reinterpret_cast<uint8_t*>(sumDouble.data()) + kPixelCount * 16, checkpoint.buffers.at("sumDouble2").data.data(), kPixelCount * 16);
+    }
+
+    bool operator==(const AccumulationState& other) const
+    {
+        return frameCount == other.frameCount && std::memcmp(sum.data(), other.sum.data(), sum.size() * sizeof(float4)) == 0 &&
+               std::memcmp(corr.data(), other.corr.data(), corr.size() * sizeof(float4)) == 0 &&
+               std::memcmp(sumDouble.data(), other.sumDouble.data(), sumDouble.size() * sizeof(double)) == 0;
+    }
+};
+} // namespace
+
+CPU_TEST(AccumulationCheckpoint_ResumeBitExact)
+{
+    const std::filesystem::path path = "test_accumulation_checkpoint_1.bin";
+    const uint32_t totalFrames = 64;
+    const uint32_t checkpointFrame = 23;
+
+    // Uninterrupted accumulation.
+    AccumulationState reference;
+    for (uint32_t i = 0; i < totalFrames; ++i)
+        reference.accumulate(i);
+
+    // Accumulation interrupted by a checkpoint, resumed in a fresh state.
+    {
+        AccumulationState state;
+        for (uint32_t i = 0; i < checkpointFrame; ++i)
+            state.accumulate(i);
+        state.save().write(path);
+    }
+
+    AccumulationCheckpoint checkpoint = AccumulationCheckpoint::read(path);
+    EXPECT_EQ(checkpoint.frameCount, checkpointFrame);
+    EXPECT_EQ(checkpoint.metadata.get<uint32_t>("frameIndex"), checkpointFrame);
+    EXPECT_EQ(checkpoint.buffers.size(), 4);
+    EXPECT(checkpoint.hasBuffer("sum"));
+    EXPECT(checkpoint.buffers.at("sum").format == ResourceFormat::RGBA32Float);
+    EXPECT_EQ(checkpoint.buffers.at("sum").width, kWidth);
+    EXPECT_EQ(checkpoint.buffers.at("sum").height, kHeight);
+
+    AccumulationState resumed;
+    resumed.load(checkpoint);
+    for (uint32_t i = checkpoint.metadata.get<uint32_t>("frameIndex"); i < totalFrames; ++i)
+        resumed.accumulate(i);
+
+    EXPECT(resumed == reference);
+
+    // No temporary files are left behind.
+    for (const auto& it : std::filesystem::directory_iterator("."))
+        EXPECT_NE(it.path().extension(), ".tmp");
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(AccumulationCheckpoint_Corruption)
+{
+    const std::filesystem::path path = "test_accumulation_checkpoint_2.bin";
+
+    AccumulationState state;
+    state.accumulate(0);
+    state.save().write(path);
+    const auto fileSize = std::filesystem::file_size(path);
+
+    // Flip a byte in the buffer data.
+    {
+        std::fstream fs(path, std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+        fs.seekg(fileSize / 2);
+        char c = (char)fs.get();
+        fs.seekp(fileSize / 2);
+        fs.put(~c);
+    }
+    EXPECT_THROW(AccumulationCheckpoint::read(path));
+
+    // Truncated file.
+    state.save().write(path);
+    std::filesystem::resize_file(path, fileSize - 100);
+    EXPECT_THROW(AccumulationCheckpoint::read(path));
+
+    // Not a checkpoint file.
+    {
+        std::ofstream fs(path, std::ios_base::binary | std::ios_base::trunc);
+        fs << "This is not a checkpoint file.";
+    }
+    EXPECT_THROW(AccumulationCheckpoint::read(path));
+
+    // Missing file.
+    std::filesystem::remove(path);
+    EXPECT_THROW(AccumulationCheckpoint::read(path));
+
+    // Overwriting replaces the previous checkpoint.
+    state.save().write(path);
+    state.accumulate(1);
+    state.save().write(path);
+    EXPECT_EQ(AccumulationCheckpoint::read(path).frameCount, 2);
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
@@ -0,0 +1,272 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/AdaptiveSampling.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Synthetic pixel with a known mean and per-sample standard deviation.
+struct SyntheticPixel
+{
+    float mean;
+    float sigma;
+};
+
+/// Render a frame of synthetic pixels. Each pixel is the average of n samples.
+std::vector<float4> renderFrame(const std::vector<SyntheticPixel>& pixels, const std::vector<uint8_t>& sampleCount, std::mt19937& rng)
+{
+    std::normal_distribution<float> dist;
+    std::vector<float4> color(pixels.size(), float4(0.f));
+    for (size_t i = 0; i < pixels.size(); ++i)
+    {
+        if (sampleCount[i] == 0)
+            continue;
+        float L = pixels[i].mean + pixels[i].sigma / std::sqrt((float)sampleCount[i]) * dist(rng);
+        color[i] = float4(L, L, L, 1.f);
+    }
+    return color;
+}
+
+/// Return the given percentile of the true relative error of the accumulated pixel means.
+float computeErrorPercentile(const std::vector<SyntheticPixel>& pixels, const std::vector<float4>& moments, float percentile)
+{
+    std::vector<float> errors(pixels.size());
+    for (size_t i = 0; i < pixels.size(); ++i)
+    {
+        float estimate = moments[i].z > 0.f ? moments[i].x / moments[i].z : 0.f;
+        errors[i] = std::abs(estimate - pixels[i].mean) / pixels[i].mean;
+    }
+    std::sort(errors.begin(), errors.end());
+    return errors[std::min(errors.size() - 1, (size_t)(percentile * errors.size()))];
+}
+
+std::vector<SyntheticPixel> createNoisyImage(size_t pixelCount, std::mt19937& rng)
+{
+    // Mostly easy pixels with a few hard ones, similar to a rendering with caustics or glossy highlights.
+    std::uniform_real_distribution<float> u;
+    std::vector<SyntheticPixel> pixels(pixelCount);
+    for (auto& p : pixels)
+        p = {0.5f + u(rng), u(rng) < 0.1f ? 2.f : 0.05f};
+    return pixels;
+}
+} // namespace
+
+CPU_TEST(AdaptiveSampling_RelativeError)
+{
+    // Too few observations.
+    EXPECT_EQ(AdaptiveSampling::computeRelativeError(float4(0.f), 0.f), AdaptiveSampling::kUnknownError);
+    EXPECT_EQ(AdaptiveSampling::computeRelativeError(float4(1.f, 1.f, 1.f, 1.f), 0.f), AdaptiveSampling::kUnknownError);
+
+    // Four frames with one sample each: L = 1, 2, 3, 4.
+    {
+        float4 moments(10.f, 30.f, 4.f, 4.f);
+        float expected = std::sqrt(5.f / 3.f / 4.f) / 2.5f;
+        EXPECT_LE(std::abs(AdaptiveSampling::computeRelativeError(moments, 0.f) - expected), 1e-6f);
+    }
+
+    // Constant signal has zero error.
+    EXPECT_EQ(AdaptiveSampling::computeRelativeError(float4(8.f, 8.f, 8.f, 4.f), 0.f), 0.f);
+
+    // The estimate converges to sigma / (mean * sqrt(N)) with varying sample counts per frame.
+    {
+        std::mt19937 rng(1);
+        std::normal_distribution<float> dist;
+        const float mean = 2.f;
+        const float sigma = 0.5f;
+        float4 moments(0.f);
+        for (uint32_t frame = 0; frame < 4096; ++frame)
+        {
+            uint32_t n = 1 + frame % 8;
+            float L = mean + sigma / std::sqrt((float)n) * dist(rng);
+            moments += float4(n * L, n * L * L, (float)n, 1.f);
+        }
+        float expected = sigma / (mean * std::sqrt(moments.z));
+        float relativeError = AdaptiveSampling::computeRelativeError(moments, 0.f);
+        EXPECT_LE(std::abs(relativeError - expected), 0.05f * expected);
+    }
+}
+
+CPU_TEST(AdaptiveSampling_Allocation)
+{
+    AdaptiveSamplingParams params;
+    params.frameDim = {64, 64};
+    params.sampleBudget = 4.f;
+    params.targetRelativeError = 0.01f;
+    const size_t pixelCount = 64 * 64;
+
+    // Left half is constant, right half is noisy.
+    std::vector<SyntheticPixel> pixels(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i)
+        pixels[i] = {1.f, i % 64 < 32 ? 0.f : 1.f};
+
+    std::mt19937 rng(2);
+    std::vector<float4> moments(pixelCount, float4(0.f));
+    std::vector<uint8_t> sampleCount(pixelCount, (uint8_t)AdaptiveSampling::getUniformSampleCount(params));
+
+    for (uint32_t frame = 1; frame <= 16; ++frame)
+    {
+        params.frameCount = frame;
+        auto color = renderFrame(pixels, sampleCount, rng);
+        auto stats = AdaptiveSampling::updateReference(params, color, moments, sampleCount);
+
+        if (frame < params.minFrameCount)
+        {
+            // Uniform sampling while bootstrapping.
+            EXPECT(std::all_of(sampleCount.begin(), sampleCount.end(), [](uint8_t n) { return n == 4; })) << "frame " << frame;
+            continue;
+        }
+
+        // Constant pixels are converged and keep a single sample, noisy pixels get the rest of the budget.
+        uint64_t totalSamples = 0;
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            if (i % 64 < 32)
+                EXPECT_EQ(sampleCount[i], 1) << "frame " << frame << " pixel " << i;
+            else
+                EXPECT_GE(sampleCount[i], 1) << "frame " << frame << " pixel " << i;
+            EXPECT_LE(sampleCount[i], params.maxSamplesPerPixel);
+            totalSamples += sampleCount[i];
+        }
+
+        // The budget is respected up to the dithering of fractional samples.
+        EXPECT_LE((float)totalSamples, 1.02f * params.sampleBudget * pixelCount) << "frame " << frame;
+        EXPECT_GE(stats.convergedFraction, 0.5f);
+        EXPECT_EQ(stats.avgSamplesPerPixel, (float)totalSamples / pixelCount);
+    }
+}
+
+CPU_TEST(AdaptiveSampling_TimeToQuality)
+{
+    AdaptiveSamplingParams params;
+    params.frameDim = {128, 128};
+    params.sampleBudget = 2.f;
+    params.targetRelativeError = 0.02f;
+    const size_t pixelCount = 128 * 128;
+
+    std::mt19937 rng(3);
+    auto pixels = createNoisyImage(pixelCount, rng);
+
+    // Render the same number of total samples with uniform and adaptive sampling.
+    const uint32_t frameCount = 64;
+
+    std::vector<float4> uniformMoments(pixelCount, float4(0.f));
+    {
+        std::vector<uint8_t> sampleCount(pixelCount, (uint8_t)params.sampleBudget);
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            auto color = renderFrame(pixels, sampleCount, rng);
+            for (size_t i = 0; i < pixelCount; ++i)
+                uniformMoments[i] += float4(sampleCount[i] * color[i].x, 0.f, (float)sampleCount[i], 1.f);
+        }
+    }
+
+    std::vector<float4> adaptiveMoments(pixelCount, float4(0.f));
+    uint64_t adaptiveSamples = 0;
+    {
+        std::vector<uint8_t> sampleCount(pixelCount, (uint8_t)AdaptiveSampling::getUniformSampleCount(params));
+        for (uint32_t frame = 1; frame <= frameCount; ++frame)
+        {
+            for (uint8_t n : sampleCount)
+                adaptiveSamples += n;
+            params.frameCount = frame;
+            auto color = renderFrame(pixels, sampleCount, rng);
+            AdaptiveSampling::updateReference(params, color, adaptiveMoments, sampleCount);
+        }
+    }
+
+    // Adaptive sampling must not use more samples than uniform sampling.
+    EXPECT_LE((float)adaptiveSamples, 1.02f * params.sampleBudget * frameCount * pixelCount);
+
+    // The worst pixels are considerably better with adaptive sampling.
+    float uniformError = computeErrorPercentile(pixels, uniformMoments, 0.99f);
+    float adaptiveError = computeErrorPercentile(pixels, adaptiveMoments, 0.99f);
+    EXPECT_LT(adaptiveError, 0.5f * uniformError) << "uniform " << uniformError << " adaptive " << adaptiveError;
+}
+
+GPU_TEST(AdaptiveSampling_MatchesReference)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+
+    const uint2 frameDim = {100, 60};
+    const size_t pixelCount = frameDim.x * frameDim.y;
+
+    AdaptiveSampling adaptiveSampling(pDevice);
+    AdaptiveSamplingParams params = adaptiveSampling.getParams();
+    params.sampleBudget = 3.f;
+    params.targetRelativeError = 0.01f;
+    adaptiveSampling.setParams(params);
+    adaptiveSampling.setEnabled(true);
+
+    std::mt19937 rng(4);
+    auto pixels = createNoisyImage(pixelCount, rng);
+    std::vector<float4> moments(pixelCount, float4(0.f));
+
+    for (uint32_t frame = 1; frame <= 12; ++frame)
+    {
+        adaptiveSampling.beginFrame(pRenderContext, frameDim);
+        ASSERT(adaptiveSampling.getSampleCountTexture() != nullptr);
+
+        // Render with the GPU sample count map and run the reference on the same input.
+        std::vector<uint8_t> sampleCount = pRenderContext->readTextureSubresource(adaptiveSampling.getSampleCountTexture().get(), 0);
+        ASSERT_EQ(sampleCount.size(), pixelCount);
+        auto color = renderFrame(pixels, sampleCount, rng);
+        ref<Texture> pColor = pDevice->createTexture2D(frameDim.x, frameDim.y, ResourceFormat::RGBA32Float, 1, 1, color.data());
+
+        adaptiveSampling.endFrame(pRenderContext, pColor);
+
+        params.frameDim = frameDim;
+        params.frameCount = frame;
+        auto stats = AdaptiveSampling::updateReference(params, color, moments, sampleCount);
+
+        // Dithering may round differently in a few pixels due to floating-point differences.
+        std::vector<uint8_t> result = pRenderContext->readTextureSubresource(adaptiveSampling.getSampleCountTexture().get(), 0);
+        ASSERT_EQ(result.size(), pixelCount);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            EXPECT_LE(std::abs((int)result[i] - (int)sampleCount[i]), 1) << "frame " << frame << " pixel " << i;
+            if (result[i] != sampleCount[i])
+                mismatches++;
+        }
+        EXPECT_LE(mismatches, pixelCount / 100) << "frame " << frame;
+
+        AdaptiveSampling::Stats gpuStats;
+        ASSERT(adaptiveSampling.getStats(gpuStats));
+        EXPECT_EQ(gpuStats.frameCount, stats.frameCount);
+        EXPECT_LE(std::abs(gpuStats.convergedFraction - stats.convergedFraction), 0.01f);
+        EXPECT_LE(std::abs(gpuStats.avgSamplesPerPixel - stats.avgSamplesPerPixel), 0.05f);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,261 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/AutoExposure.h"
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Gray color with the given luminance.
+float4 gray(float L)
+{
+    return float4(L, L, L, 1.f);
+}
+
+AutoExposureParams createParams(uint2 frameDim)
+{
+    AutoExposureParams params;
+    params.frameDim = frameDim;
+    return params;
+}
+
+/// Image with a dark background and a bright disk in the center.
+std::vector<float4> createDiskImage(uint2 frameDim, float radius, float background, float disk)
+{
+    std::vector<float4> color(frameDim.x * frameDim.y);
+    for (uint32_t y = 0; y < frameDim.y; y++)
+    {
+        for (uint32_t x = 0; x < frameDim.x; x++)
+        {
+            const float2 offset = (float2(x, y) + 0.5f - 0.5f * float2(frameDim)) / (0.5f * frameDim.y);
+            color[y * frameDim.x + x] = gray(length(offset) <= radius ? disk : background);
+        }
+    }
+    return color;
+}
+
+float getAverageLogLuminance(const AutoExposureParams& params, const std::vector<float4>& color)
+{
+    float avgLogLuminance = 0.f;
+    auto histogram = AutoExposure::computeHistogram(params, color);
+    if (!AutoExposure::computeAverageLogLuminance(params, histogram, avgLogLuminance))
+        return std::numeric_limits<float>::quiet_NaN();
+    return avgLogLuminance;
+}
+} // namespace
+
+CPU_TEST(AutoExposure_Histogram)
+{
+    AutoExposureParams params = createParams({32, 16});
+    const float binWidth = (params.maxLogLuminance - params.minLogLuminance) / kAutoExposureBinCount;
+
+    // Bin mapping. Values outside the range are clamped to the first and last bin.
+    EXPECT_EQ(AutoExposure::computeBin(params, 0.f), 0);
+    EXPECT_EQ(AutoExposure::computeBin(params, -1.f), 0);
+    EXPECT_EQ(AutoExposure::computeBin(params, std::exp2(params.minLogLuminance - 1.f)), 0);
+    EXPECT_EQ(AutoExposure::computeBin(params, std::exp2(params.maxLogLuminance + 1.f)), kAutoExposureBinCount - 1);
+    EXPECT_EQ(AutoExposure::computeBin(params, std::numeric_limits<float>::infinity()), kAutoExposureBinCount - 1);
+    EXPECT_EQ(AutoExposure::computeBin(params, std::exp2(params.minLogLuminance + 10.5f * binWidth)), 10);
+
+    // A uniform image ends up in a single bin with the total weight.
+    std::vector<float4> color(32 * 16, gray(0.25f));
+    auto histogram = AutoExposure::computeHistogram(params, color);
+    const uint32_t bin = AutoExposure::computeBin(params, 0.25f);
+    EXPECT_EQ(histogram[bin], 32 * 16 * kAutoExposureWeightScale);
+    EXPECT_EQ(std::accumulate(histogram.begin(), histogram.end(), 0u), histogram[bin]);
+
+    // NaNs are ignored.
+    color[0] = gray(std::numeric_limits<float>::quiet_NaN());
+    histogram = AutoExposure::computeHistogram(params, color);
+    EXPECT_EQ(histogram[bin], (32 * 16 - 1) * kAutoExposureWeightScale);
+
+    // The average of a uniform image is the bin center.
+    float avgLogLuminance = 0.f;
+    EXPECT(AutoExposure::computeAverageLogLuminance(params, histogram, avgLogLuminance));
+    EXPECT_LE(std::abs(avgLogLuminance - std::log2(0.25f)), 0.5f * binWidth);
+
+    // An empty histogram has no average.
+    EXPECT_FALSE(AutoExposure::computeAverageLogLuminance(params, std::vector<uint32_t>(kAutoExposureBinCount, 0), avgLogLuminance));
+}
+
+CPU_TEST(AutoExposure_PercentileClipping)
+{
+    const uint2 frameDim = {64, 64};
+    AutoExposureParams params = createParams(frameDim);
+    const float binWidth = (params.maxLogLuminance - params.minLogLuminance) / kAutoExposureBinCount;
+
+    // A small, very bright area (~3% of the pixels) skews the plain geometric mean.
+    auto color = createDiskImage(frameDim, 0.2f, 0.1f, 1000.f);
+
+    params.lowPercentile = 0.f;
+    params.highPercentile = 1.f;
+    const float unclipped = getAverageLogLuminance(params, color);
+    EXPECT_GT(unclipped - std::log2(0.1f), 0.3f);
+
+    // Ignoring the brightest 5% recovers the background luminance.
+    params.highPercentile = 0.95f;
+    const float clipped = getAverageLogLuminance(params, color);
+    EXPECT_LE(std::abs(clipped - std::log2(0.1f)), binWidth);
+
+    // Clipping splits bins proportionally: 25% at L=1 and 75% at L=4 clipped to [0.5, 1] leaves only L=4.
+    std::vector<float4> split(frameDim.x * frameDim.y, gray(4.f));
+    std::fill(split.begin(), split.begin() + split.size() / 4, gray(1.f));
+    params.lowPercentile = 0.5f;
+    params.highPercentile = 1.f;
+    EXPECT_LE(std::abs(getAverageLogLuminance(params, split) - 2.f), binWidth);
+    params.lowPercentile = 0.f;
+    EXPECT_LE(std::abs(getAverageLogLuminance(params, split) - 1.5f), binWidth);
+}
+
+CPU_TEST(AutoExposure_Metering)
+{
+    const uint2 frameDim = {96, 64};
+    AutoExposureParams params = createParams(frameDim);
+    params.lowPercentile = 0.f;
+    params.highPercentile = 1.f;
+
+    // Weights.
+    const uint2 center = frameDim / 2u;
+    const uint2 corner = {0, 0};
+    params.metering = AutoExposureMetering::Average;
+    EXPECT_EQ(AutoExposure::computeMeteringWeight(params, center), 1.f);
+    EXPECT_EQ(AutoExposure::computeMeteringWeight(params, corner), 1.f);
+    params.metering = AutoExposureMetering::CenterWeighted;
+    EXPECT_GT(AutoExposure::computeMeteringWeight(params, center), 0.99f);
+    EXPECT_LT(AutoExposure::computeMeteringWeight(params, corner), 0.01f);
+    params.metering = AutoExposureMetering::Spot;
+    EXPECT_EQ(AutoExposure::computeMeteringWeight(params, center), 1.f);
+    EXPECT_EQ(AutoExposure::computeMeteringWeight(params, corner), 0.f);
+
+    // Bright subject in the center of a dark frame.
+    auto color = createDiskImage(frameDim, 0.3f, 0.01f, 10.f);
+    params.metering = AutoExposureMetering::Average;
+    const float average = getAverageLogLuminance(params, color);
+    params.metering = AutoExposureMetering::CenterWeighted;
+    const float centerWeighted = getAverageLogLuminance(params, color);
+    params.metering = AutoExposureMetering::Spot;
+    const float spot = getAverageLogLuminance(params, color);
+
+    EXPECT_LT(average, centerWeighted);
+    EXPECT_LT(centerWeighted, spot);
+    EXPECT_LE(std::abs(spot - std::log2(10.f)), 0.1f);
+
+    // The target exposure maps the average luminance to the exposure key.
+    EXPECT_LE(std::abs(AutoExposure::computeTargetExposure(params, spot) * std::exp2(spot) - params.exposureKey), 1e-6f);
+}
+
+CPU_TEST(AutoExposure_Adaptation)
+{
+    AutoExposureParams params;
+
+    // Without adaptation the target is used directly, also for unknown previous exposures.
+    EXPECT_EQ(AutoExposure::adaptExposure(params, 2.f, 0.5f), 0.5f);
+    params.adaptationSpeedUp = 2.f;
+    params.adaptationSpeedDown = 1.f;
+    params.deltaTime = 0.1f;
+    EXPECT_EQ(AutoExposure::adaptExposure(params, 0.f, 0.5f), 0.5f);
+
+    // Adaptation is exponential in log space, with separate rates for brighter and darker scenes.
+    const float brighter = AutoExposure::adaptExposure(params, 2.f, 0.5f);
+    EXPECT_LT(brighter, 2.f);
+    EXPECT_GT(brighter, 0.5f);
+    EXPECT_LE(std::abs(std::log2(brighter) - (1.f - 2.f * (1.f - std::exp(-0.2f)))), 1e-5f);
+    const float darker = AutoExposure::adaptExposure(params, 0.5f, 2.f);
+    EXPECT_LE(std::abs(std::log2(darker) - (-1.f + 2.f * (1.f - std::exp(-0.1f)))), 1e-5f);
+
+    // The result doesn't depend on the frame rate.
+    float exposure = 2.f;
+    params.deltaTime = 0.01f;
+    for (int i = 0; i < 10; i++)
+        exposure = AutoExposure::adaptExposure(params, exposure, 0.5f);
+    EXPECT_LE(std::abs(exposure - brighter), 1e-4f);
+
+    // Converges to the target.
+    params.deltaTime = 0.1f;
+    for (int i = 0; i < 200; i++)
+        exposure = AutoExposure::adaptExposure(params, exposure, 0.5f);
+    EXPECT_LE(std::abs(exposure - 0.5f), 1e-4f);
+}
+
+GPU_TEST(AutoExposure_MatchesReference)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+
+    const uint2 frameDim = {100, 60};
+    const size_t pixelCount = frameDim.x * frameDim.y;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> logLuminance(-14.f, 10.f);
+    std::vector<float4> color(pixelCount);
+    for (auto& c : color)
+        c = float4(std::exp2(logLuminance(rng)), std::exp2(logLuminance(rng)), std::exp2(logLuminance(rng)), 1.f);
+    ref<Texture> pColor = pDevice->createTexture2D(frameDim.x, frameDim.y, ResourceFormat::RGBA32Float, 1, 1, color.data());
+
+    AutoExposure autoExposure(pDevice);
+    AutoExposureParams params = autoExposure.getParams();
+    params.adaptationSpeedUp = 1.f;
+    params.adaptationSpeedDown = 1.f;
+
+    for (auto metering : {AutoExposureMetering::Average, AutoExposureMetering::CenterWeighted, AutoExposureMetering::Spot})
+    {
+        params.metering = metering;
+        autoExposure.setParams(params);
+        autoExposure.reset();
+
+        params.frameDim = frameDim;
+        float exposure = 0.f;
+        for (uint32_t frame = 0; frame < 3; ++frame)
+        {
+            params.deltaTime = 0.1f;
+            autoExposure.execute(pRenderContext, pColor, params.deltaTime);
+
+            // The log2 implementations may differ in the last bit, moving a few pixels to neighboring bins.
+            auto reference = AutoExposure::computeHistogram(params, color);
+            auto histogram = autoExposure.getHistogramBuffer()->getElements<uint32_t>(0, kAutoExposureBinCount);
+            uint32_t difference = 0;
+            for (uint32_t i = 0; i < kAutoExposureBinCount; ++i)
+                difference += (uint32_t)std::abs((int64_t)histogram[i] - (int64_t)reference[i]);
+            EXPECT_LE(difference, 4 * kAutoExposureWeightScale) << enumToString(metering);
+
+            float avgLogLuminance = 0.f;
+            ASSERT(AutoExposure::computeAverageLogLuminance(params, reference, avgLogLuminance));
+            exposure = AutoExposure::adaptExposure(params, frame == 0 ? 0.f : exposure, AutoExposure::computeTargetExposure(params, avgLogLuminance));
+
+            float2 result = autoExposure.getExposureBuffer()->getElement<float2>(0);
+            EXPECT_LE(std::abs(result.x / exposure - 1.f), 1e-3f) << enumToString(metering) << " frame " << frame;
+            EXPECT_LE(std::abs(result.y - avgLogLuminance), 1e-2f) << enumToString(metering) << " frame " << frame;
+        }
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,232 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/TileScheduler.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+bool isPermutation(std::vector<uint32_t> schedule, uint32_t count)
+{
+    std::sort(schedule.begin(), schedule.end());
+    for (uint32_t i = 0; i < schedule.size(); i++)
+        if (schedule[i] != i)
+            return false;
+    return schedule.size() == count;
+}
+
+/// Pixel value identifying the pixel's position in the frame.
+uint32_t pixelValue(uint32_t x, uint32_t y)
+{
+    return (y << 16) | x;
+}
+} // namespace
+
+CPU_TEST(TileScheduler_Grid)
+{
+    // Whole frame, tiles at the right and bottom border are clipped.
+    {
+        TileScheduler scheduler(uint2(100, 70), uint2(32, 32));
+        EXPECT(scheduler.getRegion() == RenderTile({uint2(0, 0), uint2(100, 70)}));
+        EXPECT_EQ(scheduler.getGridDim().x, 4);
+        EXPECT_EQ(scheduler.getGridDim().y, 3);
+        ASSERT_EQ(scheduler.getTileCount(), 12);
+        EXPECT(scheduler.getTile(0) == RenderTile({uint2(0, 0), uint2(32, 32)}));
+        EXPECT(scheduler.getTile(3) == RenderTile({uint2(96, 0), uint2(4, 32)}));
+        EXPECT(scheduler.getTile(11) == RenderTile({uint2(96, 64), uint2(4, 6)}));
+
+        uint32_t pixelCount = 0;
+        for (const auto& tile : scheduler.getTiles())
+            pixelCount += tile.getPixelCount();
+        EXPECT_EQ(pixelCount, 100 * 70);
+    }
+
+    // Region of interest. The grid stays aligned to the frame.
+    {
+        TileScheduler scheduler(uint2(100, 70), uint2(32, 32), {uint2(40, 10), uint2(50, 40)});
+        EXPECT_EQ(scheduler.getGridDim().x, 2);
+        EXPECT_EQ(scheduler.getGridDim().y, 2);
+        ASSERT_EQ(scheduler.getTileCount(), 4);
+        EXPECT(scheduler.getTile(0) == RenderTile({uint2(40, 10), uint2(24, 22)}));
+        EXPECT(scheduler.getTile(1) == RenderTile({uint2(64, 10), uint2(26, 22)}));
+        EXPECT(scheduler.getTile(2) == RenderTile({uint2(40, 32), uint2(24, 18)}));
+        EXPECT(scheduler.getTile(3) == RenderTile({uint2(64, 32), uint2(26, 18)}));
+    }
+
+    // Regions are clipped to the frame.
+    {
+        TileScheduler scheduler(uint2(100, 70), uint2(32, 32), {uint2(80, 60), uint2(100, 100)});
+        EXPECT(scheduler.getRegion() == RenderTile({uint2(80, 60), uint2(20, 10)}));
+        ASSERT_EQ(scheduler.getTileCount(), 4);
+        EXPECT(scheduler.getTile(0) == RenderTile({uint2(80, 60), uint2(16, 4)}));
+        EXPECT(scheduler.getTile(3) == RenderTile({uint2(96, 64), uint2(4, 6)}));
+    }
+
+    EXPECT_THROW(TileScheduler(uint2(100, 70), uint2(32, 32), {uint2(100, 0), uint2(10, 10)}));
+    EXPECT_THROW(TileScheduler(uint2(100, 70), uint2(0, 32)));
+    EXPECT_THROW(TileScheduler(uint2(0, 70), uint2(32, 32)));
+}
+
+CPU_TEST(TileScheduler_Schedule)
+{
+    // Scanline order.
+    {
+        TileScheduler scheduler(uint2(100, 70), uint2(32, 32));
+        auto schedule = scheduler.getSchedule(TileScheduler::Order::Scanline);
+        ASSERT_EQ(schedule.size(), 12);
+        for (uint32_t i = 0; i < schedule.size(); i++)
+            EXPECT_EQ(schedule[i], i);
+    }
+
+    // Spiral order on a square grid starts in the center and moves outwards ring by ring.
+    {
+        TileScheduler scheduler(uint2(50, 50), uint2(10, 10));
+        auto schedule = scheduler.getSchedule(TileScheduler::Order::Spiral);
+        EXPECT(isPermutation(schedule, 25));
+        const std::vector<uint32_t> expected = {12, 13, 18, 17, 16, 11, 6, 7, 8, 9, 14, 19, 24};
+        for (uint32_t i = 0; i < expected.size(); i++)
+            EXPECT_EQ(schedule[i], expected[i]);
+        for (uint32_t i = 9; i < schedule.size(); i++)
+        {
+            uint2 tile = uint2(schedule[i] % 5, schedule[i] / 5);
+            EXPECT(tile.x == 0 || tile.x == 4 || tile.y == 0 || tile.y == 4);
+        }
+    }
+
+    // Spiral order skips positions outside of non-square grids.
+    {
+        TileScheduler scheduler(uint2(40, 10), uint2(10, 10));
+        auto schedule = scheduler.getSchedule(TileScheduler::Order::Spiral);
+        EXPECT(schedule == std::vector<uint32_t>({2, 3, 1, 0}));
+    }
+
+    // Error priority order, ties are broken by the spiral order.
+    {
+        TileScheduler scheduler(uint2(30, 30), uint2(10, 10));
+        auto spiral = scheduler.getSchedule(TileScheduler::Order::Spiral);
+        EXPECT(scheduler.getSchedule(TileScheduler::Order::ErrorPriority) == spiral);
+
+        std::vector<float> errors(9, 0.f);
+        errors[0] = 0.5f;
+        errors[8] = std::numeric_limits<float>::quiet_NaN();
+        errors[2] = 2.f;
+        auto schedule = scheduler.getSchedule(TileScheduler::Order::ErrorPriority, errors);
+        EXPECT(isPermutation(schedule, 9));
+        EXPECT_EQ(schedule[0], 8);
+        EXPECT_EQ(schedule[1], 2);
+        EXPECT_EQ(schedule[2], 0);
+        std::vector<uint32_t> rest;
+        for (uint32_t index : spiral)
+            if (index != 0 && index != 2 && index != 8)
+                rest.push_back(index);
+        EXPECT(std::equal(rest.begin(), rest.end(), schedule.begin() + 3));
+
+        EXPECT_THROW(scheduler.getSchedule(TileScheduler::Order::ErrorPriority, std::vector<float>(4)));
+    }
+}
+
+CPU_TEST(TileScheduler_TileErrors)
+{
+    const uint2 frameDim(20, 10);
+    TileScheduler scheduler(frameDim, uint2(8, 8), {uint2(4, 0), uint2(12, 10)});
+    ASSERT_EQ(scheduler.getTileCount(), 4);
+
+    // Errors outside of the region are ignored.
+    std::vector<float> pixelErrors(frameDim.x * frameDim.y, 100.f);
+    for (uint32_t y = 0; y < frameDim.y; y++)
+        for (uint32_t x = 4; x < 16; x++)
+            pixelErrors[y * frameDim.x + x] = x < 8 ? 1.f : (y < 8 ? 2.f : 3.f);
+    pixelErrors[9 * frameDim.x + 5] = std::numeric_limits<float>::infinity();
+
+    auto errors = scheduler.computeTileErrors(pixelErrors.data());
+    ASSERT_EQ(errors.size(), 4);
+    EXPECT_EQ(errors[0], 1.f);
+    EXPECT_EQ(errors[1], 2.f);
+    EXPECT_EQ(errors[2], std::numeric_limits<float>::infinity());
+    EXPECT_EQ(errors[3], 3.f);
+
+    auto schedule = scheduler.getSchedule(TileScheduler::Order::ErrorPriority, errors);
+    EXPECT(schedule == std::vector<uint32_t>({2, 3, 1, 0}));
+}
+
+CPU_TEST(TileScheduler_Stitch)
+{
+    const uint2 frameDim(100, 70);
+
+    // Reference frame with each pixel storing its position.
+    std::vector<uint32_t> frame(frameDim.x * frameDim.y);
+    for (uint32_t y = 0; y < frameDim.y; y++)
+        for (uint32_t x = 0; x < frameDim.x; x++)
+            frame[y * frameDim.x + x] = pixelValue(x, y);
+
+    // Stitch a region from tightly packed tiles in spiral order.
+    TileScheduler scheduler(frameDim, uint2(16, 16), {uint2(5, 7), uint2(77, 50)});
+    TileStitcher stitcher(scheduler.getRegion(), sizeof(uint32_t));
+    for (uint32_t index : scheduler.getSchedule(TileScheduler::Order::Spiral))
+    {
+        EXPECT(!stitcher.isComplete());
+        const RenderTile& tile = scheduler.getTile(index);
+        std::vector<uint32_t> data;
+        for (uint32_t y = tile.offset.y; y < tile.getEnd().y; y++)
+            for (uint32_t x = tile.offset.x; x < tile.getEnd().x; x++)
+                data.push_back(pixelValue(x, y));
+        stitcher.addTile(tile, data.data());
+    }
+    EXPECT(stitcher.isComplete());
+
+    const RenderTile& region = scheduler.getRegion();
+    const uint32_t* pImage = reinterpret_cast<const uint32_t*>(stitcher.getData().data());
+    ASSERT_EQ(stitcher.getData().size(), region.getPixelCount() * sizeof(uint32_t));
+    for (uint32_t y = 0; y < region.extent.y; y++)
+        for (uint32_t x = 0; x < region.extent.x; x++)
+            EXPECT_EQ(pImage[y * region.extent.x + x], pixelValue(region.offset.x + x, region.offset.y + y));
+
+    // Stitch the whole frame from tiles read directly from the reference frame.
+    TileScheduler frameScheduler(frameDim, uint2(32, 32));
+    TileStitcher frameStitcher(frameScheduler.getRegion(), sizeof(uint32_t));
+    for (const auto& tile : frameScheduler.getTiles())
+        frameStitcher.addTile(tile, frame.data() + tile.offset.y * frameDim.x + tile.offset.x, frameDim.x * sizeof(uint32_t));
+    EXPECT(frameStitcher.isComplete());
+    EXPECT(std::memcmp(frameStitcher.getData().data(), frame.data(), frame.size() * sizeof(uint32_t)) == 0);
+
+    frameStitcher.clear();
+    EXPECT(!frameStitcher.isComplete());
+    EXPECT(std::all_of(frameStitcher.getData().begin(), frameStitcher.getData().end(), [](uint8_t v) { return v == 0; }));
+
+    // Invalid tiles.
+    EXPECT_THROW(stitcher.addTile({uint2(0, 0), uint2(8, 8)}, frame.data()));
+    EXPECT_THROW(stitcher.addTile({uint2(70, 40), uint2(16, 16)}, frame.data()));
+    EXPECT_THROW(stitcher.addTile({uint2(8, 8), uint2(8, 8)}, frame.data(), 4));
+}
+
+} // namespace Falcor
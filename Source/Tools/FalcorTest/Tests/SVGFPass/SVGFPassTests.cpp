@@ -0,0 +1,708 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Core/Plugin.h"
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraph.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Math/PackedFormats.h"
+#include "Utils/Color/ColorHelpers.slang"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Image with texture load semantics, i.e. loads outside of the image return zero.
+template<typename T>
+struct Image
+{
+    int2 dim = {};
+    std::vector<T> data;
+
+    Image() = default;
+    Image(uint2 dim_) : dim(dim_), data(dim_.x * dim_.y, T(0)) {}
+
+    bool isInside(int2 p) const { return p.x >= 0 && p.y >= 0 && p.x < dim.x && p.y < dim.y; }
+    T load(int2 p) const { return isInside(p) ? data[p.y * dim.x + p.x] : T(0); }
+    T& operator[](int2 p) { return data[p.y * dim.x + p.x]; }
+    const T& operator[](int2 p) const { return data[p.y * dim.x + p.x]; }
+};
+
+struct SVGFParams
+{
+    int iterations = 4;
+    int feedbackTap = 1;
+    float phiColor = 10.f;
+    float phiNormal = 128.f;
+    float alpha = 0.05f;
+    float momentsAlpha = 0.2f;
+};
+
+/// Inputs of the SVGF pass for one frame.
+struct SVGFFrame
+{
+    Image<float4> albedo;
+    Image<float4> color;
+    Image<float4> emission;
+    Image<float4> worldNormal;
+    Image<float2> linearZ;
+    Image<float2> motion;
+    Image<float2> posNormalFwidth;
+
+    SVGFFrame(uint2 dim)
+        : albedo(dim), color(dim), emission(dim), worldNormal(dim), linearZ(dim), motion(dim), posNormalFwidth(dim)
+    {}
+};
+
+/**
+ * CPU reference of the SVGF pipeline implemented by SVGFPass.
+ * This follows the shaders step by step, including the handling of texture loads outside of the screen,
+ * so that the results match the GPU implementation up to floating-point precision.
+ */
+class SVGFReference
+{
+public:
+    SVGFReference(uint2 dim, const SVGFParams& params)
+        : mDim(dim)
+        , mParams(params)
+        , mPrevLinearZAndNormal(dim)
+        , mFilteredPast(dim)
+        , mPrevMoments(dim)
+        , mPrevHistoryLength(dim)
+    {}
+
+    /// Filter a frame and return the output image.
+    Image<float4> execute(const SVGFFrame& frame)
+    {
+        // Pack linear z and normal.
+        Image<float4> linearZAndNormal(mDim);
+        for (int2 p : pixels())
+        {
+            const float2 n = ndir_to_oct_snorm(frame.worldNormal[p].xyz());
+            linearZAndNormal[p] = float4(frame.linearZ[p], n.x, n.y);
+        }
+
+        // Temporal accumulation.
+        Image<float4> illumination(mDim);
+        Image<float2> moments(mDim);
+        Image<float> historyLength(mDim);
+        for (int2 p : pixels())
+            reproject(frame, linearZAndNormal, p, illumination[p], moments[p], historyLength[p]);
+
+        // Spatial variance estimate for pixels with short history.
+        Image<float4> filtered(mDim);
+        for (int2 p : pixels())
+            filtered[p] = filterMoments(illumination, moments, historyLength, linearZAndNormal, p);
+
+        // Wavelet filter.
+        const int feedbackIteration = std::min(mParams.feedbackTap, mParams.iterations - 1);
+        for (int i = 0; i < mParams.iterations; i++)
+        {
+            filtered = filterAtrous(filtered, linearZAndNormal, 1 << i, mParams.phiColor, mParams.phiNormal);
+            if (i == feedbackIteration)
+                mFilteredPast = filtered;
+        }
+        if (mParams.feedbackTap < 0)
+            mFilteredPast = illumination;
+
+        // Remodulate.
+        Image<float4> output(mDim);
+        for (int2 p : pixels())
+            output[p] = frame.albedo[p] * filtered[p] + frame.emission[p];
+
+        mPrevLinearZAndNormal = linearZAndNormal;
+        mPrevMoments = moments;
+        mPrevHistoryLength = historyLength;
+
+        return output;
+    }
+
+    /// Return the history length of the last frame.
+    const Image<float>& getHistoryLength() const { return mPrevHistoryLength; }
+
+    /// Run one iteration of the a-trous filter (SVGFAtrousFilter.slang).
+    static Image<float4> filterAtrous(
+        const Image<float4>& illumination,
+        const Image<float4>& linearZAndNormal,
+        int stepSize,
+        float phiColor,
+        float phiNormal
+    )
+    {
+        const float epsVariance = 1e-10f;
+        const float kernelWeights[3] = {1.f, 2.f / 3.f, 1.f / 6.f};
+        const float varianceKernel[2][2] = {{1.f / 4.f, 1.f / 8.f}, {1.f / 8.f, 1.f / 16.f}};
+
+        Image<float4> output(uint2(illumination.dim));
+        for (int y = 0; y < illumination.dim.y; y++)
+        {
+            for (int x = 0; x < illumination.dim.x; x++)
+            {
+                const int2 ipos = {x, y};
+                const float4 illuminationCenter = illumination[ipos];
+                const float lIlluminationCenter = luminance(illuminationCenter.xyz());
+
+                float var = 0.f;
+                for (int yy = -1; yy <= 1; yy++)
+                    for (int xx = -1; xx <= 1; xx++)
+                        var += illumination.load(ipos + int2(xx, yy)).w * varianceKernel[std::abs(xx)][std::abs(yy)];
+
+                const float2 zCenter = linearZAndNormal[ipos].xy();
+                if (zCenter.x < 0.f)
+                {
+                    output[ipos] = illuminationCenter;
+                    continue;
+                }
+                const float3 nCenter = oct_to_ndir_snorm(linearZAndNormal[ipos].zw());
+
+                const float phiLIllumination = phiColor * std::sqrt(std::max(0.f, epsVariance + var));
+                const float phiDepth = std::max(zCenter.y, 1e-8f) * stepSize;
+
+                float sumWIllumination = 1.f;
+                float4 sumIllumination = illuminationCenter;
+                for (int yy = -2; yy <= 2; yy++)
+                {
+                    for (int xx = -2; xx <= 2; xx++)
+                    {
+                        const int2 p = ipos + int2(xx, yy) * stepSize;
+                        if (!illumination.isInside(p) || (xx == 0 && yy == 0))
+                            continue;
+
+                        const float kernel = kernelWeights[std::abs(xx)] * kernelWeights[std::abs(yy)];
+                        const float4 illuminationP = illumination[p];
+                        const float w = computeWeight(
+                            zCenter.x,
+                            linearZAndNormal[p].x,
+                            phiDepth * length(float2(int2(xx, yy))),
+                            nCenter,
+                            oct_to_ndir_snorm(linearZAndNormal[p].zw()),
+                            phiNormal,
+                            lIlluminationCenter,
+                            luminance(illuminationP.xyz()),
+                            phiLIllumination
+                        );
+
+                        const float wIllumination = w * kernel;
+                        sumWIllumination += wIllumination;
+                        sumIllumination += float4(float3(wIllumination), wIllumination * wIllumination) * illuminationP;
+                    }
+                }
+
+                output[ipos] =
+                    sumIllumination / float4(float3(sumWIllumination), sumWIllumination * sumWIllumination);
+            }
+        }
+        return output;
+    }
+
+private:
+    std::vector<int2> pixels() const
+    {
+        std::vector<int2> result;
+        for (int y = 0; y < (int)mDim.y; y++)
+            for (int x = 0; x < (int)mDim.x; x++)
+                result.push_back({x, y});
+        return result;
+    }
+
+    static float computeWeight(
+        float depthCenter,
+        float depthP,
+        float phiDepth,
+        float3 normalCenter,
+        float3 normalP,
+        float phiNormal,
+        float luminanceIllumCenter,
+        float luminanceIllumP,
+        float phiIllum
+    )
+    {
+        const float weightNormal = std::pow(math::saturate(dot(normalCenter, normalP)), phiNormal);
+        const float weightZ = (phiDepth == 0.f) ? 0.f : std::abs(depthCenter - depthP) / phiDepth;
+        const float weightLillum = std::abs(luminanceIllumCenter - luminanceIllumP) / phiIllum;
+        return std::exp(0.f - std::max(weightLillum, 0.f) - std::max(weightZ, 0.f)) * weightNormal;
+    }
+
+    bool isReprjValid(int2 coord, float Z, float Zprev, float fwidthZ, float3 normal, float3 normalPrev, float fwidthNormal) const
+    {
+        const int2 imageDim = int2(mDim);
+        if (coord.x < 1 || coord.y < 1 || coord.x > imageDim.x - 1 || coord.y > imageDim.y - 1)
+            return false;
+        if (std::abs(Zprev - Z) / (fwidthZ + 1e-2f) > 10.f)
+            return false;
+        if (length(normal - normalPrev) / (fwidthNormal + 1e-2f) > 16.f)
+            return false;
+        return true;
+    }
+
+    bool loadPrevData(const SVGFFrame& frame, const Image<float4>& linearZAndNormal, int2 ipos, float4& prevIllum, float2& prevMoments, float& historyLength)
+        const
+    {
+        const float2 imageDim = float2(mDim);
+        const float2 motion = frame.motion[ipos];
+        const float normalFwidth = frame.posNormalFwidth[ipos].y;
+
+        const int2 iposPrev = int2(float2(ipos) + motion * imageDim + float2(0.5f));
+
+        const float2 depth = linearZAndNormal[ipos].xy();
+        const float3 normal = oct_to_ndir_snorm(linearZAndNormal[ipos].zw());
+
+        prevIllum = float4(0.f);
+        prevMoments = float2(0.f);
+
+        bool v[4];
+        const float2 posPrev = float2(ipos) + motion * imageDim;
+        const int2 offset[4] = {int2(0, 0), int2(1, 0), int2(0, 1), int2(1, 1)};
+
+        bool valid = false;
+        for (int sampleIdx = 0; sampleIdx < 4; sampleIdx++)
+        {
+            const int2 loc = int2(posPrev) + offset[sampleIdx];
+            const float4 prev = mPrevLinearZAndNormal.load(loc);
+            v[sampleIdx] = isReprjValid(iposPrev, depth.x, prev.x, depth.y, normal, oct_to_ndir_snorm(prev.zw()), normalFwidth);
+            valid = valid || v[sampleIdx];
+        }
+
+        if (valid)
+        {
+            float sumw = 0.f;
+            const float x = posPrev.x - std::floor(posPrev.x);
+            const float y = posPrev.y - std::floor(posPrev.y);
+            const float w[4] = {(1 - x) * (1 - y), x * (1 - y), (1 - x) * y, x * y};
+
+            for (int sampleIdx = 0; sampleIdx < 4; sampleIdx++)
+            {
+                const int2 loc = int2(posPrev) + offset[sampleIdx];
+                if (v[sampleIdx])
+                {
+                    prevIllum += w[sampleIdx] * mFilteredPast.load(loc);
+                    prevMoments += w[sampleIdx] * mPrevMoments.load(loc);
+                    sumw += w[sampleIdx];
+                }
+            }
+
+            valid = (sumw >= 0.01f);
+            prevIllum = valid ? prevIllum / sumw : float4(0.f);
+            prevMoments = valid ? prevMoments / sumw : float2(0.f);
+        }
+
+        if (!valid)
+        {
+            float nValid = 0.f;
+            for (int yy = -1; yy <= 1; yy++)
+            {
+                for (int xx = -1; xx <= 1; xx++)
+                {
+                    const int2 p = iposPrev + int2(xx, yy);
+                    const float4 prev = mPrevLinearZAndNormal.load(p);
+                    if (isReprjValid(iposPrev, depth.x, prev.x, depth.y, normal, oct_to_ndir_snorm(prev.zw()), normalFwidth))
+                    {
+                        prevIllum += mFilteredPast.load(p);
+                        prevMoments += mPrevMoments.load(p);
+                        nValid += 1.f;
+                    }
+                }
+            }
+            if (nValid > 0.f)
+            {
+                valid = true;
+                prevIllum /= nValid;
+                prevMoments /= nValid;
+            }
+        }
+
+        if (valid)
+        {
+            historyLength = mPrevHistoryLength.load(iposPrev);
+        }
+        else
+        {
+            prevIllum = float4(0.f);
+            prevMoments = float2(0.f);
+            historyLength = 0.f;
+        }
+
+        return valid;
+    }
+
+    void reproject(const SVGFFrame& frame, const Image<float4>& linearZAndNormal, int2 ipos, float4& outIllumination, float2& outMoments, float& outHistoryLength)
+        const
+    {
+        const float3 color = frame.color[ipos].xyz() - frame.emission[ipos].xyz();
+        float3 illumination = color / max(frame.albedo[ipos].xyz(), float3(0.001f));
+        if (std::isnan(illumination.x) || std::isnan(illumination.y) || std::isnan(illumination.z))
+            illumination = float3(0.f);
+
+        float historyLength;
+        float4 prevIllumination;
+        float2 prevMoments;
+        const bool success = loadPrevData(frame, linearZAndNormal, ipos, prevIllumination, prevMoments, historyLength);
+        historyLength = std::min(32.f, success ? historyLength + 1.f : 1.f);
+
+        const float alpha = success ? std::max(mParams.alpha, 1.f / historyLength) : 1.f;
+        const float alphaMoments = success ? std::max(mParams.momentsAlpha, 1.f / historyLength) : 1.f;
+
+        float2 moments;
+        moments.x = luminance(illumination);
+        moments.y = moments.x * moments.x;
+        moments = lerp(prevMoments, moments, alphaMoments);
+
+        outIllumination = lerp(prevIllumination, float4(illumination, 0.f), alpha);
+        outIllumination.w = std::max(0.f, moments.y - moments.x * moments.x);
+        outMoments = moments;
+        outHistoryLength = historyLength;
+    }
+
+    float4 filterMoments(
+        const Image<float4>& illumination,
+        const Image<float2>& moments,
+        const Image<float>& historyLength,
+        const Image<float4>& linearZAndNormal,
+        int2 ipos
+    ) const
+    {
+        const float h = historyLength[ipos];
+        if (h >= 4.f)
+            return illumination[ipos];
+
+        const float4 illuminationCenter = illumination[ipos];
+        const float lIlluminationCenter = luminance(illuminationCenter.xyz());
+
+        const float2 zCenter = linearZAndNormal[ipos].xy();
+        if (zCenter.x < 0.f)
+            return illuminationCenter;
+        const float3 nCenter = oct_to_ndir_snorm(linearZAndNormal[ipos].zw());
+        const float phiDepth = std::max(zCenter.y, 1e-8f) * 3.f;
+
+        float sumWIllumination = 0.f;
+        float3 sumIllumination = float3(0.f);
+        float2 sumMoments = float2(0.f);
+
+        const int radius = 3;
+        for (int yy = -radius; yy <= radius; yy++)
+        {
+            for (int xx = -radius; xx <= radius; xx++)
+            {
+                const int2 p = ipos + int2(xx, yy);
+                if (!illumination.isInside(p))
+                    continue;
+
+                const float3 illuminationP = illumination[p].xyz();
+                const float w = computeWeight(
+                    zCenter.x,
+                    linearZAndNormal[p].x,
+                    phiDepth * length(float2(int2(xx, yy))),
+                    nCenter,
+                    oct_to_ndir_snorm(linearZAndNormal[p].zw()),
+                    mParams.phiNormal,
+                    lIlluminationCenter,
+                    luminance(illuminationP),
+                    mParams.phiColor
+                );
+
+                sumWIllumination += w;
+                sumIllumination += illuminationP * w;
+                sumMoments += moments[p] * w;
+            }
+        }
+
+        sumWIllumination = std::max(sumWIllumination, 1e-6f);
+        sumIllumination /= sumWIllumination;
+        sumMoments /= sumWIllumination;
+
+        float variance = sumMoments.y - sumMoments.x * sumMoments.x;
+        variance *= 4.f / h;
+
+        return float4(sumIllumination, variance);
+    }
+
+    uint2 mDim;
+    SVGFParams mParams;
+
+    Image<float4> mPrevLinearZAndNormal;
+    Image<float4> mFilteredPast;
+    Image<float2> mPrevMoments;
+    Image<float> mPrevHistoryLength;
+};
+
+const uint2 kFrameDim = {37, 29};
+
+/**
+ * Create a test scene: two planes facing the camera at different depths, split at a vertical edge.
+ * The camera moves one pixel to the left every frame. The color is noisy, with a different mean per plane.
+ * Pixels in the top rows are background (negative linear z).
+ */
+SVGFFrame createFrame(uint2 dim, uint32_t frameIndex, float noise, int motionPixels)
+{
+    std::mt19937 rng(frameIndex);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+
+    SVGFFrame frame(dim);
+    for (int y = 0; y < (int)dim.y; y++)
+    {
+        for (int x = 0; x < (int)dim.x; x++)
+        {
+            const int2 p = {x, y};
+            const int sceneX = x + (int)frameIndex * motionPixels;
+            const bool front = sceneX < (int)dim.x / 2;
+            const bool background = y < 2;
+
+            const float value = front ? 0.8f : 0.2f;
+            frame.albedo[p] = float4(0.5f, 0.6f, 0.7f, 1.f);
+            frame.color[p] = float4(frame.albedo[p].xyz() * (value * (1.f + noise * dist(rng))), 1.f);
+            frame.emission[p] = background ? frame.color[p] : float4(0.f);
+            frame.worldNormal[p] = front ? float4(0.f, 0.f, 1.f, 0.f) : float4(0.f, 0.6f, 0.8f, 0.f);
+            frame.linearZ[p] = background ? float2(-1.f, 0.f) : float2(front ? 2.f : 5.f, 0.01f);
+            // Motion vectors point from the current to the previous frame in screen space.
+            frame.motion[p] = float2((float)motionPixels / dim.x, 0.f);
+            frame.posNormalFwidth[p] = float2(0.f);
+        }
+    }
+    return frame;
+}
+
+float computeMean(const Image<float4>& image, int2 begin, int2 end)
+{
+    float sum = 0.f;
+    for (int y = begin.y; y < end.y; y++)
+        for (int x = begin.x; x < end.x; x++)
+            sum += image[int2(x, y)].x;
+    return sum / ((end.x - begin.x) * (end.y - begin.y));
+}
+
+float computeVariance(const Image<float4>& image, int2 begin, int2 end)
+{
+    const float mean = computeMean(image, begin, end);
+    float sum = 0.f;
+    for (int y = begin.y; y < end.y; y++)
+        for (int x = begin.x; x < end.x; x++)
+            sum += (image[int2(x, y)].x - mean) * (image[int2(x, y)].x - mean);
+    return sum / ((end.x - begin.x) * (end.y - begin.y));
+}
+
+class SVGFRunner
+{
+public:
+    SVGFRunner(GPUUnitTestContext& ctx, const Properties& props) : mCtx(ctx)
+    {
+        PluginManager::instance().loadPluginByName("SVGFPass");
+
+        ref<Device> pDevice = ctx.getDevice();
+        mpGraph = RenderGraph::create(pDevice, "SVGF");
+        ref<RenderPass> pPass = RenderPass::create("SVGFPass", pDevice, props);
+        if (!pPass)
+            FALCOR_THROW("Could not create render pass 'SVGFPass'");
+        mpGraph->addPass(pPass, "SVGFPass");
+        mpGraph->markOutput("SVGFPass.Filtered image");
+        ref<Fbo> pTargetFbo = Fbo::create2D(pDevice, kFrameDim.x, kFrameDim.y, ResourceFormat::RGBA32Float);
+        mpGraph->onResize(pTargetFbo.get());
+    }
+
+    /// Filter a frame and return the output.
+    Image<float4> run(const SVGFFrame& frame)
+    {
+        setInput("Albedo", frame.albedo);
+        setInput("Color", frame.color);
+        setInput("Emission", frame.emission);
+        setInput("WorldPosition", frame.color);
+        setInput("WorldNormal", frame.worldNormal);
+        setInput("PositionNormalFwidth", frame.posNormalFwidth);
+        setInput("LinearZ", frame.linearZ);
+        setInput("MotionVec", frame.motion);
+        mpGraph->execute(mCtx.getRenderContext());
+
+        ref<Resource> pOutput = mpGraph->getOutput("SVGFPass.Filtered image");
+        std::vector<uint8_t> data = mCtx.getRenderContext()->readTextureSubresource(pOutput->asTexture().get(), 0);
+        const float16_t* pData = reinterpret_cast<const float16_t*>(data.data());
+
+        Image<float4> output(kFrameDim);
+        for (size_t i = 0; i < output.data.size(); i++)
+            output.data[i] = float4(pData[4 * i], pData[4 * i + 1], pData[4 * i + 2], pData[4 * i + 3]);
+        return output;
+    }
+
+private:
+    void setInput(const std::string& name, const Image<float4>& image)
+    {
+        mpGraph->setInput(
+            "SVGFPass." + name,
+            mCtx.getDevice()->createTexture2D(image.dim.x, image.dim.y, ResourceFormat::RGBA32Float, 1, 1, image.data.data())
+        );
+    }
+
+    void setInput(const std::string& name, const Image<float2>& image)
+    {
+        mpGraph->setInput(
+            "SVGFPass." + name,
+            mCtx.getDevice()->createTexture2D(image.dim.x, image.dim.y, ResourceFormat::RG32Float, 1, 1, image.data.data())
+        );
+    }
+
+    GPUUnitTestContext& mCtx;
+    ref<RenderGraph> mpGraph;
+};
+} // namespace
+
+CPU_TEST(SVGFReference_LowNoise)
+{
+    // With little noise, the output stays close to the noise-free image, also at the depth edge and under motion.
+    SVGFReference svgf(kFrameDim, SVGFParams());
+    for (uint32_t frameIndex = 0; frameIndex < 3; frameIndex++)
+    {
+        SVGFFrame frame = createFrame(kFrameDim, frameIndex, 0.01f, 1);
+        SVGFFrame expected = createFrame(kFrameDim, frameIndex, 0.f, 1);
+        Image<float4> output = svgf.execute(frame);
+        for (size_t i = 0; i < output.data.size(); i++)
+        {
+            for (int c = 0; c < 3; c++)
+                EXPECT_LE(std::abs(output.data[i][c] - expected.color.data[i][c]), 0.01f * expected.color.data[i][c])
+                    << "i=" << i << " frame=" << frameIndex;
+        }
+    }
+}
+
+CPU_TEST(SVGFReference_Denoise)
+{
+    const float kNoise = 0.5f;
+    const int2 frontBegin = {0, 2};
+    const int2 frontEnd = {(int)kFrameDim.x / 2 - 2, (int)kFrameDim.y};
+    const int2 backBegin = {(int)kFrameDim.x / 2 + 2, 2};
+    const int2 backEnd = int2(kFrameDim);
+
+    // Static camera: the history length grows, noise is reduced and the planes don't bleed into each other.
+    SVGFReference svgf(kFrameDim, SVGFParams());
+    for (uint32_t frameIndex = 0; frameIndex < 8; frameIndex++)
+    {
+        SVGFFrame frame = createFrame(kFrameDim, frameIndex, kNoise, 0);
+        Image<float4> output = svgf.execute(frame);
+
+        // Background pixels are passed through.
+        for (int x = 0; x < (int)kFrameDim.x; x++)
+        {
+            for (int c = 0; c < 3; c++)
+                EXPECT_LE(std::abs(output[int2(x, 0)][c] - frame.color[int2(x, 0)][c]), 1e-5f);
+        }
+
+        EXPECT_EQ(svgf.getHistoryLength()[int2(kFrameDim / 2u)], (float)(frameIndex + 1));
+
+        EXPECT_LT(computeVariance(output, frontBegin, frontEnd), 0.1f * computeVariance(frame.color, frontBegin, frontEnd));
+        EXPECT_LT(computeVariance(output, backBegin, backEnd), 0.1f * computeVariance(frame.color, backBegin, backEnd));
+        EXPECT_LE(std::abs(computeMean(output, frontBegin, frontEnd) - 0.4f), 0.02f);
+        EXPECT_LE(std::abs(computeMean(output, backBegin, backEnd) - 0.1f), 0.005f);
+    }
+}
+
+CPU_TEST(SVGFReference_Reprojection)
+{
+    // Moving camera: the history follows the motion vectors, except for disoccluded pixels at the border.
+    SVGFReference svgf(kFrameDim, SVGFParams());
+    for (uint32_t frameIndex = 0; frameIndex < 4; frameIndex++)
+        svgf.execute(createFrame(kFrameDim, frameIndex, 0.5f, 1));
+
+    const Image<float>& historyLength = svgf.getHistoryLength();
+    EXPECT_EQ(historyLength[int2(4, 10)], 4.f);
+    EXPECT_EQ(historyLength[int2(kFrameDim.x - 4, 10)], 4.f);
+    EXPECT_EQ(historyLength[int2(kFrameDim.x - 1, 10)], 1.f);
+}
+
+CPU_TEST(SVGFReference_AtrousEdgeStopping)
+{
+    // A single bright pixel on a plane with high variance is spread out, but not across a depth edge.
+    const uint2 dim = {16, 16};
+    Image<float4> illumination(dim);
+    Image<float4> linearZAndNormal(dim);
+    for (int y = 0; y < (int)dim.y; y++)
+    {
+        for (int x = 0; x < (int)dim.x; x++)
+        {
+            illumination[int2(x, y)] = float4(0.f, 0.f, 0.f, 1.f);
+            linearZAndNormal[int2(x, y)] = float4(x < 8 ? 1.f : 10.f, 0.01f, 0.f, 0.f);
+        }
+    }
+    illumination[int2(7, 8)] = float4(1.f, 1.f, 1.f, 1.f);
+
+    Image<float4> output = SVGFReference::filterAtrous(illumination, linearZAndNormal, 1, 10.f, 128.f);
+    EXPECT_LT(output[int2(7, 8)].x, 1.f);
+    EXPECT_GT(output[int2(6, 8)].x, 0.f);
+    EXPECT_GT(output[int2(5, 8)].x, 0.f);
+    EXPECT_EQ(output[int2(8, 8)].x, 0.f);
+    EXPECT_EQ(output[int2(4, 8)].x, 0.f);
+
+    // Energy is preserved on the plane (weights are normalized per pixel, so only approximately).
+    float sum = 0.f;
+    for (const float4& v : output.data)
+        sum += v.x;
+    EXPECT_GT(sum, 0.5f);
+    EXPECT_LT(sum, 2.f);
+}
+
+GPU_TEST(SVGFPass_MatchesReference)
+{
+    // Compare both the pixel shader and the fused compute filter against the reference.
+    // Different iteration counts and feedback taps exercise all paths through the fused filter.
+    const std::pair<int, int> configs[] = {{4, 1}, {4, 0}, {3, -1}, {1, 0}};
+    for (auto [iterations, feedbackTap] : configs)
+    {
+        SVGFParams params;
+        params.iterations = iterations;
+        params.feedbackTap = feedbackTap;
+        SVGFReference reference(kFrameDim, params);
+
+        Properties props;
+        props["Iterations"] = iterations;
+        props["FeedbackTap"] = feedbackTap;
+        props["ComputeFilter"] = false;
+        SVGFRunner pixelShaderRunner(ctx, props);
+        props["ComputeFilter"] = true;
+        SVGFRunner computeRunner(ctx, props);
+
+        for (uint32_t frameIndex = 0; frameIndex < 4; frameIndex++)
+        {
+            SVGFFrame frame = createFrame(kFrameDim, frameIndex, 0.5f, 1);
+            Image<float4> expected = reference.execute(frame);
+            Image<float4> pixelShaderOutput = pixelShaderRunner.run(frame);
+            Image<float4> computeOutput = computeRunner.run(frame);
+
+            for (size_t i = 0; i < expected.data.size(); i++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    const float tolerance = 1e-2f * std::abs(expected.data[i][c]) + 1e-3f;
+                    EXPECT_LE(std::abs(pixelShaderOutput.data[i][c] - expected.data[i][c]), tolerance)
+                        << "i=" << i << " frame=" << frameIndex << " iterations=" << iterations << " feedbackTap=" << feedbackTap;
+                    EXPECT_EQ(computeOutput.data[i][c], pixelShaderOutput.data[i][c])
+                        << "i=" << i << " frame=" << frameIndex << " iterations=" << iterations << " feedbackTap=" << feedbackTap;
+                }
+            }
+        }
+    }
+}
+} // namespace Falcor
@@ -139,7 +139,7 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
 }
 } // namespace
 
-GPU_TEST(AliasTable)
+GPU_TEST(AliasTable, DEVICE_TYPES(Device::Type::D3D12, Device::Type::Vulkan, Device::Type::CPU))
 {
     testAliasTable(ctx, 1, {1.f});
     testAliasTable(ctx, 2, {1.f, 2.f});
@@ -0,0 +1,193 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Math/MatrixMath.h"
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const std::filesystem::path kDirectory = "test_scene_lazy_udim";
+const uint32_t kTileSize = 64;
+const uint32_t kPlaceholderSize = 16;
+
+/// Write a synthetic UDIM set with tiles 1001 and 1002.
+void writeTiles()
+{
+    std::filesystem::remove_all(kDirectory);
+    std::filesystem::create_directories(kDirectory);
+    for (uint32_t udimID : {1001u, 1002u})
+    {
+        std::vector<uint8_t> data(kTileSize * kTileSize * 4, uint8_t(udimID - 1000));
+        Bitmap::saveImage(
+            kDirectory / fmt::format("tile.{}.png", udimID),
+            kTileSize,
+            kTileSize,
+            Bitmap::FileFormat::PngFile,
+            Bitmap::ExportFlags::ExportAlpha,
+            ResourceFormat::RGBA8Unorm,
+            true /* top-down */,
+            data.data()
+        );
+    }
+}
+
+/// Create a unit quad in the xy-plane with UVs in the unit square at the given offset.
+ref<TriangleMesh> createQuad(float2 uvOffset)
+{
+    ref<TriangleMesh> pMesh = TriangleMesh::create();
+    const float3 normal(0.f, 0.f, 1.f);
+    uint32_t i0 = pMesh->addVertex(float3(-0.5f, -0.5f, 0.f), normal, uvOffset + float2(0.f, 0.f));
+    uint32_t i1 = pMesh->addVertex(float3(0.5f, -0.5f, 0.f), normal, uvOffset + float2(1.f, 0.f));
+    uint32_t i2 = pMesh->addVertex(float3(0.5f, 0.5f, 0.f), normal, uvOffset + float2(1.f, 1.f));
+    uint32_t i3 = pMesh->addVertex(float3(-0.5f, 0.5f, 0.f), normal, uvOffset + float2(0.f, 1.f));
+    pMesh->addTriangle(i0, i1, i2);
+    pMesh->addTriangle(i0, i2, i3);
+    return pMesh;
+}
+
+/// Point the camera at one of the quads. Quad A at the origin uses UDIM tile 1001, quad B at x = 100 uses tile 1002.
+void lookAt(const ref<Camera>& pCamera, float x)
+{
+    pCamera->setPosition(float3(x, 0.f, 2.f));
+    pCamera->setTarget(float3(x, 0.f, 0.f));
+    pCamera->setUpVector(float3(0.f, 1.f, 0.f));
+}
+
+/// Create a scene with two quads textured with a lazily loaded UDIM texture. The camera looks at quad A.
+ref<Scene> createScene(ref<Device> pDevice, std::optional<double> memoryBudgetMB)
+{
+    nlohmann::json options = {{"udimPlaceholderSize", kPlaceholderSize}};
+    if (memoryBudgetMB)
+        options["udimMemoryBudgetMB"] = *memoryBudgetMB;
+    Settings settings;
+    settings.addOptions(nlohmann::json{{"SceneBuilder", options}});
+
+    SceneBuilder builder(
+        pDevice, settings, SceneBuilder::Flags::LazyUdimTextures | SceneBuilder::Flags::DontOptimizeGraph | SceneBuilder::Flags::DontMergeMeshes
+    );
+
+    auto pMaterial = StandardMaterial::create(pDevice, "Udim");
+    builder.loadMaterialTexture(pMaterial, Material::TextureSlot::BaseColor, std::filesystem::absolute(kDirectory) / "tile.<UDIM>.png");
+
+    MeshID meshA = builder.addTriangleMesh(createQuad(float2(0.f, 0.f)), pMaterial);
+    MeshID meshB = builder.addTriangleMesh(createQuad(float2(1.f, 0.f)), pMaterial);
+    builder.addMeshInstance(builder.addNode({"A", float4x4::identity()}), meshA);
+    builder.addMeshInstance(builder.addNode({"B", math::matrixFromTranslation(float3(100.f, 0.f, 0.f))}), meshB);
+
+    auto pCamera = Camera::create("Camera");
+    lookAt(pCamera, 0.f);
+    builder.addCamera(pCamera);
+
+    return builder.getScene();
+}
+
+TextureManager::CpuTextureHandle getUdimTexture(const ref<Scene>& pScene)
+{
+    return pScene->getMaterial(MaterialID(0))->getUdimTexture(Material::TextureSlot::BaseColor);
+}
+} // namespace
+
+GPU_TEST(Scene_LazyUdimTiles)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+    writeTiles();
+
+    {
+        ref<Scene> pScene = createScene(pDevice, {});
+        ASSERT(pScene != nullptr);
+        TextureManager& textureManager = pScene->getMaterialSystem().getTextureManager();
+
+        // The material references the UDIM set. No tile is loaded, placeholders are bound instead.
+        auto handle = getUdimTexture(pScene);
+        ASSERT(handle.isUdim());
+        const UdimTileResidency* pResidency = textureManager.getUdimTileResidency(handle);
+        ASSERT(pResidency != nullptr);
+        EXPECT_EQ(pResidency->getResidentCount(), 0);
+        for (uint32_t udimID : {1001u, 1002u})
+        {
+            auto desc = textureManager.getTextureDesc(handle, udimID);
+            EXPECT(desc.state == TextureManager::TextureState::Referenced);
+            ASSERT(desc.pTexture != nullptr);
+            EXPECT_EQ(desc.pTexture->getWidth(), kPlaceholderSize);
+        }
+
+        // The first update requests the tile used by the visible quad.
+        pScene->update(pRenderContext, 0.0);
+        textureManager.waitForAllTexturesLoading();
+        EXPECT(pResidency->getTileState(1001) == UdimTileResidency::TileState::Resident);
+        EXPECT(pResidency->getTileState(1002) == UdimTileResidency::TileState::NonResident);
+        EXPECT_EQ(textureManager.getTexture(handle, 1001u)->getWidth(), kTileSize);
+
+        // The loaded tile is bound on the next update.
+        EXPECT(is_set(pScene->update(pRenderContext, 0.0), Scene::UpdateFlags::MaterialsChanged));
+        EXPECT(!is_set(pScene->update(pRenderContext, 0.0), Scene::UpdateFlags::MaterialsChanged));
+        textureManager.waitForAllTexturesLoading();
+        EXPECT(pResidency->getTileState(1002) == UdimTileResidency::TileState::NonResident);
+
+        // Requesting all tiles loads the tile of the quad outside the view.
+        pScene->setUdimTileRequestPolicy(Scene::UdimTileRequestPolicy::All);
+        pScene->update(pRenderContext, 0.0);
+        textureManager.waitForAllTexturesLoading();
+        EXPECT(pResidency->getTileState(1001) == UdimTileResidency::TileState::Resident);
+        EXPECT(pResidency->getTileState(1002) == UdimTileResidency::TileState::Resident);
+    }
+
+    {
+        // The budget only fits a single tile.
+        ref<Scene> pScene = createScene(pDevice, 0.001);
+        ASSERT(pScene != nullptr);
+        TextureManager& textureManager = pScene->getMaterialSystem().getTextureManager();
+        auto handle = getUdimTexture(pScene);
+        const UdimTileResidency* pResidency = textureManager.getUdimTileResidency(handle);
+        ASSERT(pResidency != nullptr);
+
+        pScene->update(pRenderContext, 0.0);
+        textureManager.waitForAllTexturesLoading();
+        EXPECT(pResidency->getTileState(1001) == UdimTileResidency::TileState::Resident);
+
+        // Looking at the other quad loads its tile and evicts the first one, which falls back to its placeholder.
+        lookAt(pScene->getCamera(), 100.f);
+        pScene->update(pRenderContext, 0.0);
+        textureManager.waitForAllTexturesLoading();
+        EXPECT(pResidency->getTileState(1002) == UdimTileResidency::TileState::Resident);
+        EXPECT(pResidency->getTileState(1001) == UdimTileResidency::TileState::NonResident);
+        EXPECT_EQ(pResidency->getResidentCount(), 1);
+        auto desc = textureManager.getTextureDesc(handle, 1001u);
+        EXPECT(desc.state == TextureManager::TextureState::Referenced);
+        ASSERT(desc.pTexture != nullptr);
+        EXPECT_EQ(desc.pTexture->getWidth(), kPlaceholderSize);
+    }
+
+    std::filesystem::remove_all(kDirectory);
+}
+} // namespace Falcor
@@ -0,0 +1,219 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Lights/LightProfile.h"
+#include "Utils/Algorithm/ParallelReduction.h"
+#include "Utils/Math/MathConstants.slangh"
+
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+// Profile with a single horizontal angle, falling off linearly from 100 cd at the pole to 0 cd at the opposite pole.
+const char kIesFile[] = R"(IESNA:LM-63-2002
+[TEST] {}
+TILT=NONE
+1 1000 1 3 1 1 2 0 0 0
+1 1 100
+0 90 180
+0
+100 50 0
+)";
+
+std::vector<float> createIesData(
+    const std::vector<float>& verticalAngles,
+    const std::vector<float>& horizontalAngles,
+    const std::vector<float>& candelas
+)
+{
+    std::vector<float> data(13, 0.f);
+    data[0] = 1.f; // Normalization factor
+    data[3] = (float)verticalAngles.size();
+    data[4] = (float)horizontalAngles.size();
+    data.insert(data.end(), verticalAngles.begin(), verticalAngles.end());
+    data.insert(data.end(), horizontalAngles.begin(), horizontalAngles.end());
+    data.insert(data.end(), candelas.begin(), candelas.end());
+    return data;
+}
+
+std::vector<float> createRandomIesData(uint32_t numVerticalAngles, uint32_t numHorizontalAngles, float lastHorizontalAngle, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+
+    std::vector<float> verticalAngles(numVerticalAngles);
+    for (uint32_t i = 0; i < numVerticalAngles; i++)
+        verticalAngles[i] = 180.f * i / (numVerticalAngles - 1);
+    std::vector<float> horizontalAngles(numHorizontalAngles);
+    for (uint32_t i = 0; i < numHorizontalAngles; i++)
+        horizontalAngles[i] = numHorizontalAngles > 1 ? lastHorizontalAngle * i / (numHorizontalAngles - 1) : 0.f;
+    std::vector<float> candelas(numVerticalAngles * numHorizontalAngles);
+    for (auto& c : candelas)
+        c = dist(rng);
+
+    return createIesData(verticalAngles, horizontalAngles, candelas);
+}
+} // namespace
+
+CPU_TEST(LightProfile_BakeCPU)
+{
+    // Linear falloff over the vertical angles, texels at the data points are exact.
+    {
+        auto data = createIesData({0.f, 90.f, 180.f}, {0.f}, {1.f, 0.5f, 0.f});
+        auto baked = LightProfile::bakeIesProfile(data, 4);
+        EXPECT_EQ(baked.resolution, 4);
+        ASSERT_EQ(baked.texels.size(), 16);
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            EXPECT_EQ((float)baked.texels[y * 4 + 0], 1.f);
+            EXPECT_EQ((float)baked.texels[y * 4 + 1], 0.75f);
+            EXPECT_EQ((float)baked.texels[y * 4 + 2], 0.5f);
+            EXPECT_EQ((float)baked.texels[y * 4 + 3], 0.25f);
+        }
+    }
+
+    // The flux factor of an isotropic profile is the solid angle of the sphere.
+    {
+        auto data = createIesData({0.f, 180.f}, {0.f}, {1.f, 1.f});
+        auto baked = LightProfile::bakeIesProfile(data, 256);
+        EXPECT_LE(std::abs(baked.fluxFactor - 4.f * float(M_PI)), 1e-3f);
+    }
+
+    // Directions beyond the last vertical angle are zero.
+    {
+        auto data = createIesData({0.f, 90.f}, {0.f}, {1.f, 1.f});
+        auto baked = LightProfile::bakeIesProfile(data, 8);
+        for (uint32_t x = 0; x < 8; x++)
+            EXPECT_EQ((float)baked.texels[x], x <= 4 ? 1.f : 0.f);
+
+        // The flux factor of a hemispherical profile converges to the solid angle of the hemisphere.
+        baked = LightProfile::bakeIesProfile(data, 1024);
+        EXPECT_LE(std::abs(baked.fluxFactor - 2.f * float(M_PI)), 0.05f);
+    }
+
+    // Baking is deterministic.
+    {
+        auto data = createRandomIesData(37, 19, 360.f, 1);
+        auto a = LightProfile::bakeIesProfile(data, 128);
+        auto b = LightProfile::bakeIesProfile(data, 128);
+        EXPECT(a.texels == b.texels);
+        EXPECT_EQ(a.fluxFactor, b.fluxFactor);
+    }
+
+    // Invalid data.
+    EXPECT_THROW(LightProfile::bakeIesProfile({}, 16));
+    EXPECT_THROW(LightProfile::bakeIesProfile(createIesData({0.f, 90.f}, {0.f}, {1.f}), 16));
+}
+
+CPU_TEST(LightProfile_BakeCache)
+{
+    // Use a temporary cache directory to leave the user's cache untouched.
+    const std::filesystem::path cacheDirectory = "test_light_profile_cache";
+    std::filesystem::remove_all(cacheDirectory);
+    LightProfile::setBakeCacheDirectory(cacheDirectory);
+
+    // Use unique file contents to start with a cache miss.
+    std::random_device rd;
+    const std::filesystem::path path = "test_light_profile.ies";
+    {
+        std::ofstream ofs(path);
+        ofs << fmt::format(kIesFile, rd());
+    }
+
+    auto pProfile = LightProfile::createFromIesProfile(nullptr, path, true, 64);
+    ASSERT(pProfile != nullptr);
+    EXPECT_FALSE(pProfile->isFromBakeCache());
+    EXPECT_EQ(pProfile->getBakedData().resolution, 64);
+    EXPECT_EQ((float)pProfile->getBakedData().texels[0], 1.f);
+
+    // Loading the same profile again is served from the cache.
+    auto pCached = LightProfile::createFromIesProfile(nullptr, path, true, 64);
+    ASSERT(pCached != nullptr);
+    EXPECT_TRUE(pCached->isFromBakeCache());
+    EXPECT(pCached->getBakedData().texels == pProfile->getBakedData().texels);
+    EXPECT_EQ(pCached->getFluxFactor(), pProfile->getFluxFactor());
+
+    // A different bake resolution or normalization is a different cache entry.
+    auto pOther = LightProfile::createFromIesProfile(nullptr, path, true, 32);
+    ASSERT(pOther != nullptr);
+    EXPECT_FALSE(pOther->isFromBakeCache());
+    EXPECT_EQ(pOther->getBakedData().resolution, 32);
+    pOther = LightProfile::createFromIesProfile(nullptr, path, false, 64);
+    ASSERT(pOther != nullptr);
+    EXPECT_FALSE(pOther->isFromBakeCache());
+    EXPECT_EQ((float)pOther->getBakedData().texels[0], 100.f);
+
+    std::filesystem::remove(path);
+    LightProfile::setBakeCacheDirectory({});
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+GPU_TEST(LightProfile_BakeMatchesGPU)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+    ParallelReduction reduction(pDevice);
+
+    // Test symmetric and non-symmetric profiles.
+    for (float lastHorizontalAngle : {0.f, 90.f, 180.f, 360.f})
+    {
+        const uint32_t resolution = 128;
+        auto data = createRandomIesData(23, lastHorizontalAngle > 0.f ? 13 : 1, lastHorizontalAngle, (uint32_t)lastHorizontalAngle);
+        auto baked = LightProfile::bakeIesProfile(data, resolution);
+
+        auto pBuffer =
+            pDevice->createTypedBuffer<float>((uint32_t)data.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, data.data());
+        auto pTexture = pDevice->createTexture2D(
+            resolution, resolution, ResourceFormat::R16Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
+        );
+        auto pFluxTexture = pDevice->createTexture2D(
+            resolution, resolution, ResourceFormat::R32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
+        );
+
+        ctx.createProgram("Scene/Lights/BakeIesProfile.cs.slang", "main");
+        ctx["gIesData"] = pBuffer;
+        ctx["gTexture"] = pTexture;
+        ctx["gFluxTexture"] = pFluxTexture;
+        ctx["CB"]["gBakeResolution"] = resolution;
+        ctx.runProgram(resolution, resolution, 1);
+
+        auto texels = pRenderContext->readTextureSubresource(pTexture.get(), 0);
+        ASSERT_EQ(texels.size(), baked.texels.size() * sizeof(math::float16_t));
+        const math::float16_t* gpuTexels = reinterpret_cast<const math::float16_t*>(texels.data());
+        for (size_t i = 0; i < baked.texels.size(); i++)
+            EXPECT_LE(std::abs((float)gpuTexels[i] - (float)baked.texels[i]), 1e-3f) << "i = " << i;
+
+        float4 flux;
+        reduction.execute<float4>(pRenderContext, pFluxTexture, ParallelReduction::Type::Sum, &flux);
+        EXPECT_LE(std::abs(flux.x - baked.fluxFactor), 1e-4f * baked.fluxFactor);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,327 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Scene/Material/RGLBRDFCache.h"
+#include "Scene/Material/RGLFile.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Creates a unique temporary directory and removes it with its contents when going out of scope.
+struct TempDirectory
+{
+    std::filesystem::path path = getTempFilePath();
+    TempDirectory() { std::filesystem::create_directories(path); }
+    ~TempDirectory()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+/// Write a synthetic RGL file with the given resolution. Different seeds produce different contents.
+void writeSyntheticFile(const std::filesystem::path& path, uint32_t seed, uint32_t phiSize = 2, uint32_t thetaSize = 8, uint32_t tableSize = 32)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    auto table = [&](size_t size)
+    {
+        std::vector<float> data(size);
+        for (auto& v : data)
+            v = dist(rng);
+        return data;
+    };
+
+    const size_t sliceCount = size_t(phiSize) * thetaSize;
+    const size_t sliceSize = size_t(tableSize) * tableSize;
+    std::string description = "Synthetic BRDF " + std::to_string(seed);
+    auto phi = table(phiSize);
+    auto theta = table(thetaSize);
+    auto sigma = table(sliceSize);
+    auto ndf = table(sliceSize);
+    auto vndf = table(sliceCount * sliceSize);
+    auto lumi = table(sliceCount * sliceSize);
+    auto rgb = table(sliceCount * 3 * sliceSize);
+
+    RGLFile file;
+    file.addField("description", RGLFile::UInt8, {uint32_t(description.size())}, description.data());
+    file.addField("phi_i", RGLFile::Float32, {phiSize}, phi.data());
+    file.addField("theta_i", RGLFile::Float32, {thetaSize}, theta.data());
+    file.addField("sigma", RGLFile::Float32, {tableSize, tableSize}, sigma.data());
+    file.addField("ndf", RGLFile::Float32, {tableSize, tableSize}, ndf.data());
+    file.addField("vndf", RGLFile::Float32, {phiSize, thetaSize, tableSize, tableSize}, vndf.data());
+    file.addField("luminance", RGLFile::Float32, {phiSize, thetaSize, tableSize, tableSize}, lumi.data());
+    file.addField("rgb", RGLFile::Float32, {phiSize, thetaSize, 3, tableSize, tableSize}, rgb.data());
+
+    std::ofstream out(path, std::ios_base::binary);
+    file.saveFile(out);
+}
+
+void expectEqualFields(CPUUnitTestContext& ctx, const RGLFile::Field* a, const RGLFile::Field* b)
+{
+    ASSERT(a && b);
+    EXPECT_EQ(a->type, b->type);
+    EXPECT_EQ(a->dim, b->dim);
+    EXPECT_EQ(a->numElems, b->numElems);
+    for (uint32_t i = 0; i < std::min(a->dim, b->dim); ++i)
+        EXPECT_EQ(a->shape[i], b->shape[i]);
+    EXPECT(std::memcmp(a->data, b->data, a->numElems * (a->type == RGLFile::UInt8 ? 1 : 4)) == 0);
+}
+
+std::vector<uint8_t> readFile(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios_base::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::filesystem::path& path, const std::vector<uint8_t>& data)
+{
+    std::ofstream out(path, std::ios_base::binary);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+} // namespace
+
+CPU_TEST(RGLFile_Load)
+{
+    const std::filesystem::path path = "test_rgl_file.bsdf";
+    writeSyntheticFile(path, 1);
+
+    // Load through memory mapping and through a stream.
+    RGLFile mapped(path);
+    std::ifstream in(path, std::ios_base::binary);
+    RGLFile streamed(in);
+
+    const auto& a = mapped.data();
+    const auto& b = streamed.data();
+    EXPECT_EQ(a.description, "Synthetic BRDF 1");
+    EXPECT_EQ(a.description, b.description);
+    EXPECT(a.isotropic);
+    expectEqualFields(ctx, a.thetaI, b.thetaI);
+    expectEqualFields(ctx, a.phiI, b.phiI);
+    expectEqualFields(ctx, a.sigma, b.sigma);
+    expectEqualFields(ctx, a.ndf, b.ndf);
+    expectEqualFields(ctx, a.vndf, b.vndf);
+    expectEqualFields(ctx, a.luminance, b.luminance);
+    expectEqualFields(ctx, a.rgb, b.rgb);
+
+    // Field data of mapped files is referenced in place.
+    EXPECT_EQ(mapped.getFileSize(), std::filesystem::file_size(path));
+    EXPECT(a.vndf->data >= mapped.getFileData() && a.vndf->data < mapped.getFileData() + mapped.getFileSize());
+    EXPECT(a.vndf->storage == nullptr);
+
+    // Data survives moving the file.
+    RGLFile moved(std::move(mapped));
+    EXPECT_EQ(moved.data().vndf, a.vndf);
+    EXPECT_EQ(moved.data().description, "Synthetic BRDF 1");
+
+    in.close();
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(RGLFile_Validation)
+{
+    const std::filesystem::path path = "test_rgl_file_validation.bsdf";
+    writeSyntheticFile(path, 1);
+    const std::vector<uint8_t> valid = readFile(path);
+
+    // Truncated files.
+    for (size_t size : {size_t(0), size_t(10), size_t(40), valid.size() / 2, valid.size() - 1})
+    {
+        writeFile(path, std::vector<uint8_t>(valid.begin(), valid.begin() + size));
+        EXPECT_THROW(RGLFile file(path));
+    }
+
+    // Invalid header and version.
+    auto corrupt = valid;
+    corrupt[0] = 'x';
+    writeFile(path, corrupt);
+    EXPECT_THROW(RGLFile file(path));
+    corrupt = valid;
+    corrupt[12] = 2;
+    writeFile(path, corrupt);
+    EXPECT_THROW(RGLFile file(path));
+
+    // Data offset of the first field (description) out of bounds.
+    corrupt = valid;
+    uint16_t nameLength;
+    std::memcpy(&nameLength, &corrupt[18], 2);
+    const size_t offsetPos = 18 + 2 + nameLength + 2 + 1;
+    const uint64_t offset = valid.size();
+    std::memcpy(&corrupt[offsetPos], &offset, 8);
+    writeFile(path, corrupt);
+    EXPECT_THROW(RGLFile file(path));
+
+    // Huge shape overflowing the element count.
+    corrupt = valid;
+    const uint64_t shape = ~0ull;
+    std::memcpy(&corrupt[offsetPos + 8], &shape, 8);
+    writeFile(path, corrupt);
+    EXPECT_THROW(RGLFile file(path));
+
+    EXPECT_THROW(RGLFile file(std::filesystem::path("test_rgl_file_missing.bsdf")));
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(RGLBRDFCache_Sharing)
+{
+    const std::filesystem::path directory = "test_rgl_cache";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    writeSyntheticFile(directory / "a.bsdf", 1);
+    writeSyntheticFile(directory / "b.bsdf", 2);
+    std::filesystem::copy_file(directory / "a.bsdf", directory / "a_copy.bsdf");
+
+    RGLBRDFCache cache(0);
+    auto pA = cache.load(directory / "a.bsdf");
+    auto pB = cache.load(directory / "b.bsdf");
+    ASSERT(pA && pB);
+    EXPECT(pA != pB);
+    EXPECT_NE(pA->digest, pB->digest);
+
+    // Same path and identical contents at another path share the entry.
+    EXPECT(cache.load(directory / "a.bsdf") == pA);
+    EXPECT(cache.load(directory / "a_copy.bsdf") == pA);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.missCount, 2);
+    EXPECT_EQ(stats.hitCount, 2);
+    EXPECT_EQ(stats.entryCount, 2);
+    EXPECT_EQ(stats.sizeInBytes, pA->sizeInBytes + pB->sizeInBytes);
+
+    // Files are not kept open by the cache and can be replaced.
+    writeSyntheticFile(directory / "b.bsdf", 4);
+    std::filesystem::remove(directory / "b.bsdf");
+    EXPECT_EQ(pB->description, "Synthetic BRDF 2");
+    EXPECT_GT(pB->rgb.size(), 0);
+
+    // Sampling tables match a direct parse.
+    auto pReference = RGLBRDFCache::parse(directory / "a.bsdf");
+    uint4 size = pReference->pVNDFDist->getSize();
+    size_t count = size_t(size.x) * size.y * size.z * size.w;
+    EXPECT(std::memcmp(pA->pVNDFDist->getPDF(), pReference->pVNDFDist->getPDF(), count * sizeof(float)) == 0);
+    EXPECT(std::memcmp(pA->pVNDFDist->getConditional(), pReference->pVNDFDist->getConditional(), count * sizeof(float)) == 0);
+    EXPECT(std::memcmp(pA->pLumiDist->getMarginal(), pReference->pLumiDist->getMarginal(), count / size.z * sizeof(float)) == 0);
+
+    // Modified files are loaded again.
+    writeSyntheticFile(directory / "a_copy.bsdf", 3);
+    std::filesystem::last_write_time(directory / "a_copy.bsdf", std::filesystem::last_write_time(directory / "a.bsdf") + std::chrono::seconds(10));
+    auto pC = cache.load(directory / "a_copy.bsdf");
+    EXPECT(pC != pA);
+    EXPECT_EQ(pC->description, "Synthetic BRDF 3");
+
+    // Eviction only drops the cache's reference.
+    cache.setMemoryBudget(pC->sizeInBytes);
+    stats = cache.getStats();
+    EXPECT_EQ(stats.entryCount, 1);
+    EXPECT_LE(stats.sizeInBytes, cache.getMemoryBudget());
+    EXPECT_EQ(pA->description, "Synthetic BRDF 1");
+    EXPECT(cache.load(directory / "a.bsdf") != pA);
+
+    cache.clear();
+    EXPECT_EQ(cache.getStats().entryCount, 0);
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(RGLBRDFCache_Benchmark, TAGS("benchmark"), "Disabled for performance reasons")
+{
+    // Synthetic scene: a few measured BRDFs, each referenced by many materials.
+    const uint32_t kFileCount = 4;
+    const uint32_t kReferencesPerFile = 16;
+    TempDirectory tempDirectory;
+    const std::filesystem::path& directory = tempDirectory.path;
+    std::vector<std::filesystem::path> paths;
+    for (uint32_t i = 0; i < kFileCount; ++i)
+    {
+        paths.push_back(directory / fmt::format("brdf_{}.bsdf", i));
+        writeSyntheticFile(paths.back(), i, 2, 16, 64);
+    }
+
+    CpuTimer timer;
+
+    // Reference: every material reads the file through a stream and builds its own sampling tables.
+    timer.update();
+    size_t checksum = 0;
+    for (uint32_t r = 0; r < kReferencesPerFile; ++r)
+    {
+        for (const auto& path : paths)
+        {
+            std::ifstream in(path, std::ios_base::binary);
+            RGLFile file(in);
+            const auto& data = file.data();
+            uint4 size = uint4(uint(data.phiI->shape[0]), uint(data.thetaI->shape[0]), uint(data.vndf->shape[3]), uint(data.vndf->shape[2]));
+            SamplableDistribution4D vndfDist(reinterpret_cast<const float*>(data.vndf->data), size);
+            SamplableDistribution4D lumiDist(reinterpret_cast<const float*>(data.luminance->data), size);
+            checksum += vndfDist.getMarginal()[1] > 0.f ? 1 : 0;
+        }
+    }
+    timer.update();
+    double referenceTime = timer.delta();
+
+    // Cached: the first load per file maps, parses and preprocesses, all later loads are shared.
+    RGLBRDFCache cache(0);
+    timer.update();
+    size_t cachedChecksum = 0;
+    for (uint32_t r = 0; r < kReferencesPerFile; ++r)
+    {
+        for (const auto& path : paths)
+            cachedChecksum += cache.load(path)->pVNDFDist->getMarginal()[1] > 0.f ? 1 : 0;
+    }
+    timer.update();
+    double cachedTime = timer.delta();
+
+    // Scene reload with a warm cache.
+    timer.update();
+    for (const auto& path : paths)
+        cache.load(path);
+    timer.update();
+    double reloadTime = timer.delta();
+
+    EXPECT_EQ(checksum, cachedChecksum);
+    EXPECT_EQ(cache.getStats().missCount, kFileCount);
+    EXPECT_EQ(cache.getStats().hitCount, kFileCount * kReferencesPerFile);
+
+    logInfo(
+        "RGLBRDFCache: {} files x {} references, uncached {:.3f} s, cached {:.3f} s ({:.1f}x speedup), warm reload {:.4f} s.",
+        kFileCount,
+        kReferencesPerFile,
+        referenceTime,
+        cachedTime,
+        referenceTime / cachedTime,
+        reloadTime
+    );
+}
+} // namespace Falcor
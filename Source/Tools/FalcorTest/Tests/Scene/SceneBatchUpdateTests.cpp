@@ -0,0 +1,207 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFile[] = "Tests/Scene/SceneBatchUpdateTests.cs.slang";
+const uint32_t kInstanceCount = 3;
+const uint32_t kLightCount = 3;
+
+/// Create a scene with three mesh instances on separate nodes, two materials and three point lights.
+ref<Scene> createScene(ref<Device> pDevice)
+{
+    SceneBuilder builder(pDevice, {}, SceneBuilder::Flags::DontOptimizeGraph | SceneBuilder::Flags::DontMergeMeshes);
+
+    auto pMaterialA = StandardMaterial::create(pDevice, "MaterialA");
+    auto pMaterialB = StandardMaterial::create(pDevice, "MaterialB");
+    pMaterialA->setBaseColor(float4(0.1f, 0.2f, 0.3f, 1.f));
+    pMaterialB->setBaseColor(float4(0.4f, 0.5f, 0.6f, 1.f));
+    MeshID meshA = builder.addTriangleMesh(TriangleMesh::createCube(), pMaterialA);
+    MeshID meshB = builder.addTriangleMesh(TriangleMesh::createCube(), pMaterialB);
+
+    for (uint32_t i = 0; i < kInstanceCount; ++i)
+    {
+        NodeID nodeID = builder.addNode({"Node" + std::to_string(i), math::matrixFromTranslation(float3((float)i, 0.f, 0.f))});
+        builder.addMeshInstance(nodeID, i == 1 ? meshB : meshA);
+    }
+
+    for (uint32_t i = 0; i < kLightCount; ++i)
+    {
+        auto pLight = PointLight::create("Light" + std::to_string(i));
+        pLight->setIntensity(float3((float)i + 1.f));
+        builder.addLight(pLight);
+    }
+
+    return builder.getScene();
+}
+
+struct SceneReadback
+{
+    std::vector<float3> translations;
+    std::vector<float3> baseColors;
+    std::vector<float3> intensities;
+    uint32_t lightCount = 0;
+};
+
+/// Read the instance transforms, material base colors and light intensities from the scene's GPU buffers.
+SceneReadback readScene(GPUUnitTestContext& ctx, const ref<Scene>& pScene)
+{
+    const uint32_t materialCount = pScene->getMaterialCount();
+
+    ProgramDesc desc;
+    desc.addShaderModules(pScene->getShaderModules());
+    desc.addShaderLibrary(kShaderFile);
+    desc.addTypeConformances(pScene->getTypeConformances());
+    desc.csEntry("readSceneData");
+    ctx.createProgram(desc, pScene->getSceneDefines());
+
+    pScene->bindShaderData(ctx["gScene"]);
+    ctx["CB"]["gInstanceCount"] = kInstanceCount;
+    ctx["CB"]["gMaterialCount"] = materialCount;
+    ctx["CB"]["gLightCount"] = kLightCount;
+    ctx.allocateStructuredBuffer("translations", kInstanceCount);
+    ctx.allocateStructuredBuffer("baseColors", materialCount);
+    ctx.allocateStructuredBuffer("intensities", kLightCount);
+    ctx.allocateStructuredBuffer("lightCount", 1);
+    ctx.runProgram(32, 1, 1);
+
+    auto toFloat3 = [](const std::vector<float4>& v)
+    {
+        std::vector<float3> result;
+        for (const auto& x : v)
+            result.push_back(x.xyz());
+        return result;
+    };
+
+    SceneReadback result;
+    result.translations = toFloat3(ctx.readBuffer<float4>("translations"));
+    result.baseColors = toFloat3(ctx.readBuffer<float4>("baseColors"));
+    result.intensities = toFloat3(ctx.readBuffer<float4>("intensities"));
+    result.lightCount = ctx.readBuffer<uint32_t>("lightCount")[0];
+    return result;
+}
+
+void expectEqual(GPUUnitTestContext& ctx, const float3& actual, const float3& expected, const char* what, size_t index)
+{
+    for (uint32_t c = 0; c < 3; ++c)
+        EXPECT_LE(std::abs(actual[c] - expected[c]), 1e-3f) << what << " " << index << " component " << c;
+}
+} // namespace
+
+GPU_TEST(Scene_BatchUpdates)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    ref<Scene> pScene = createScene(pDevice);
+    ASSERT(pScene != nullptr);
+    ASSERT_EQ(pScene->getGeometryInstanceCount(), kInstanceCount);
+    pScene->update(pRenderContext, 0.0);
+
+    std::vector<uint32_t> nodeIDs(kInstanceCount);
+    std::vector<MaterialID> materialIDs(kInstanceCount);
+    for (uint32_t i = 0; i < kInstanceCount; ++i)
+    {
+        nodeIDs[i] = pScene->getGeometryInstance(i).globalMatrixID;
+        materialIDs[i] = MaterialID(pScene->getGeometryInstance(i).materialID);
+    }
+
+    const std::vector<float3> initialTranslations = {float3(0.f, 0.f, 0.f), float3(1.f, 0.f, 0.f), float3(2.f, 0.f, 0.f)};
+    const std::vector<float3> initialIntensities = {float3(1.f), float3(2.f), float3(3.f)};
+    const float3 initialBaseColorA = float3(0.1f, 0.2f, 0.3f);
+    const float3 initialBaseColorB = float3(0.4f, 0.5f, 0.6f);
+
+    // Batched edits of the first and last instance, material B and the first and last light.
+    auto params = pScene->getMaterial(materialIDs[1])->serializeParams();
+    const float3 newBaseColorB = float3(0.7f, 0.8f, 0.9f);
+    params.write(newBaseColorB, 0);
+
+    pScene->updateNodeTransforms(
+        {nodeIDs[0], nodeIDs[2]}, {math::matrixFromTranslation(float3(1.f, 2.f, 3.f)), math::matrixFromTranslation(float3(-4.f, 5.f, 6.f))}
+    );
+    pScene->setMaterialParams({materialIDs[1]}, {params});
+    pScene->setLightIntensities({0, 2}, {float3(10.f, 20.f, 30.f), float3(40.f, 50.f, 60.f)});
+
+    // The GPU data is only updated by the next scene update.
+    {
+        SceneReadback data = readScene(ctx, pScene);
+        for (uint32_t i = 0; i < kInstanceCount; ++i)
+            expectEqual(ctx, data.translations[i], initialTranslations[i], "instance", i);
+        expectEqual(ctx, data.baseColors[materialIDs[1].get()], initialBaseColorB, "material", materialIDs[1].get());
+        for (uint32_t i = 0; i < kLightCount; ++i)
+            expectEqual(ctx, data.intensities[i], initialIntensities[i], "light", i);
+    }
+
+    pScene->update(pRenderContext, 0.0);
+    {
+        SceneReadback data = readScene(ctx, pScene);
+        expectEqual(ctx, data.translations[0], float3(1.f, 2.f, 3.f), "instance", 0);
+        expectEqual(ctx, data.translations[1], initialTranslations[1], "instance", 1);
+        expectEqual(ctx, data.translations[2], float3(-4.f, 5.f, 6.f), "instance", 2);
+        expectEqual(ctx, data.baseColors[materialIDs[0].get()], initialBaseColorA, "material", materialIDs[0].get());
+        expectEqual(ctx, data.baseColors[materialIDs[1].get()], newBaseColorB, "material", materialIDs[1].get());
+
+        // The staged light upload covers the range of changed lights, including the unchanged light in between.
+        EXPECT_EQ(data.lightCount, kLightCount);
+        expectEqual(ctx, data.intensities[0], float3(10.f, 20.f, 30.f), "light", 0);
+        expectEqual(ctx, data.intensities[1], initialIntensities[1], "light", 1);
+        expectEqual(ctx, data.intensities[2], float3(40.f, 50.f, 60.f), "light", 2);
+    }
+
+    // Deactivating a light compacts the active lights. The staged data is uploaded for the new order.
+    pScene->getLight(0)->setActive(false);
+    pScene->setLightIntensities({2}, {float3(7.f, 8.f, 9.f)});
+    pScene->update(pRenderContext, 0.0);
+    {
+        SceneReadback data = readScene(ctx, pScene);
+        EXPECT_EQ(data.lightCount, kLightCount - 1);
+        expectEqual(ctx, data.intensities[0], initialIntensities[1], "active light", 0);
+        expectEqual(ctx, data.intensities[1], float3(7.f, 8.f, 9.f), "active light", 1);
+    }
+
+    // Transforms of geometry instances are applied to their nodes.
+    pScene->updateGeometryInstanceTransforms({1}, {math::matrixFromTranslation(float3(0.f, -1.f, 0.f))});
+    pScene->update(pRenderContext, 0.0);
+    {
+        SceneReadback data = readScene(ctx, pScene);
+        expectEqual(ctx, data.translations[0], float3(1.f, 2.f, 3.f), "instance", 0);
+        expectEqual(ctx, data.translations[1], float3(0.f, -1.f, 0.f), "instance", 1);
+    }
+
+    // Mismatched sizes and invalid IDs are rejected.
+    EXPECT_THROW(pScene->updateNodeTransforms({nodeIDs[0]}, {}));
+    EXPECT_THROW(pScene->setLightIntensities({kLightCount}, {float3(1.f)}));
+    EXPECT_THROW(pScene->setMaterialParams({MaterialID(pScene->getMaterialCount())}, {params}));
+}
+} // namespace Falcor
@@ -0,0 +1,173 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/SceneUpdateStats.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+using Stage = SceneUpdateStats::Stage;
+
+/// Create a scene with a static and an animated mesh instance and a point light.
+ref<Scene> createAnimatedScene(ref<Device> pDevice, ref<PointLight>& pLight)
+{
+    SceneBuilder builder(pDevice, {}, SceneBuilder::Flags::DontOptimizeGraph | SceneBuilder::Flags::DontMergeMeshes);
+
+    auto pMaterial = StandardMaterial::create(pDevice, "Material");
+    MeshID meshID = builder.addTriangleMesh(TriangleMesh::createCube(), pMaterial);
+
+    NodeID staticNodeID = builder.addNode({"Static", float4x4::identity()});
+    NodeID animatedNodeID = builder.addNode({"Animated", float4x4::identity()});
+    builder.addMeshInstance(staticNodeID, meshID);
+    builder.addMeshInstance(animatedNodeID, meshID);
+
+    auto pAnimation = Animation::create("Animation", animatedNodeID, 2.0);
+    pAnimation->addKeyframe({0.0, float3(0.f, 0.f, 0.f)});
+    pAnimation->addKeyframe({1.0, float3(1.f, 0.f, 0.f)});
+    pAnimation->addKeyframe({2.0, float3(0.f, 0.f, 0.f)});
+    builder.addAnimation(pAnimation);
+
+    pLight = PointLight::create("Light");
+    builder.addLight(pLight);
+
+    return builder.getScene();
+}
+} // namespace
+
+CPU_TEST(SceneUpdateStats_Accumulate)
+{
+    SceneUpdateStats stats;
+    EXPECT_EQ(stats.getFrameCount(), 0);
+
+    // Scripted frames: animate a number of objects per frame and upload their data.
+    const uint64_t kObjectCounts[] = {10, 0, 3};
+    for (uint64_t count : kObjectCounts)
+    {
+        stats.beginFrame();
+        {
+            SceneUpdateStats::ScopedTimer timer(stats, Stage::Animation);
+            stats.addObjects(Stage::Animation, count);
+            stats.addUpload(Stage::Animation, count * 64);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stats.addObjects(Stage::GeometryInstances, count);
+        stats.addUpload(Stage::GeometryInstances, count * 16);
+        stats.endFrame();
+
+        // Stats of the last frame.
+        EXPECT_EQ(stats.getStage(Stage::Animation).objectCount, count);
+        EXPECT_EQ(stats.getStage(Stage::Animation).bytesUploaded, count * 64);
+        EXPECT_GE(stats.getStage(Stage::Animation).cpuTimeMs, 1.0);
+        EXPECT_EQ(stats.getStage(Stage::GeometryInstances).cpuTimeMs, 0.0);
+        EXPECT_EQ(stats.getStage(Stage::Lights).objectCount, 0);
+
+        auto total = stats.getFrameTotal();
+        EXPECT_EQ(total.objectCount, 2 * count);
+        EXPECT_EQ(total.bytesUploaded, count * 80);
+        EXPECT_EQ(total.buffersRecreated, 0);
+    }
+
+    // Accumulated stats.
+    EXPECT_EQ(stats.getFrameCount(), 3);
+    EXPECT_EQ(stats.getAccumulatedStage(Stage::Animation).objectCount, 13);
+    EXPECT_EQ(stats.getAccumulatedStage(Stage::Animation).bytesUploaded, 13 * 64);
+    EXPECT_GE(stats.getAccumulatedStage(Stage::Animation).cpuTimeMs, 3.0);
+    EXPECT_EQ(stats.getAccumulatedTotal().objectCount, 26);
+
+    // Buffer recreation.
+    stats.beginFrame();
+    stats.addBufferRecreated(Stage::LightCollection);
+    stats.addBufferRecreated(Stage::SceneDefines, 2);
+    stats.endFrame();
+    EXPECT_EQ(stats.getFrameTotal().buffersRecreated, 3);
+    EXPECT_EQ(stats.getAccumulatedTotal().buffersRecreated, 3);
+
+    stats.reset();
+    EXPECT_EQ(stats.getFrameCount(), 0);
+    EXPECT_EQ(stats.getAccumulatedTotal().objectCount, 0);
+    EXPECT_EQ(stats.getFrameTotal().buffersRecreated, 0);
+
+    for (size_t i = 0; i < SceneUpdateStats::kStageCount; ++i)
+        EXPECT(SceneUpdateStats::getStageName((Stage)i)[0] != '\0');
+}
+
+GPU_TEST(SceneUpdateStats_Animation)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    ref<PointLight> pLight;
+    ref<Scene> pScene = createAnimatedScene(pDevice, pLight);
+    ASSERT(pScene != nullptr);
+
+    // First update initializes all animated data.
+    pScene->update(pRenderContext, 0.0);
+    pScene->resetUpdateStats();
+
+    // Animated frame: only the animated node is touched.
+    pScene->update(pRenderContext, 0.5);
+    {
+        const auto& stats = pScene->getUpdateStats();
+        EXPECT_EQ(stats.getFrameCount(), 1);
+        const auto& animation = stats.getStage(Stage::Animation);
+        EXPECT_EQ(animation.objectCount, 1);
+        EXPECT_EQ(animation.bytesUploaded, 2 * sizeof(float4x4));
+        EXPECT_EQ(stats.getStage(Stage::GeometryInstances).objectCount, 1);
+        EXPECT_EQ(stats.getStage(Stage::Lights).objectCount, 0);
+        EXPECT_EQ(stats.getFrameTotal().buffersRecreated, 0);
+    }
+
+    // Keep the time fixed until the animation system has settled.
+    pScene->update(pRenderContext, 0.5);
+    pScene->update(pRenderContext, 0.5);
+    {
+        const auto& stats = pScene->getUpdateStats();
+        EXPECT_EQ(stats.getFrameCount(), 3);
+        EXPECT_EQ(stats.getStage(Stage::Animation).objectCount, 0);
+        EXPECT_EQ(stats.getStage(Stage::Animation).bytesUploaded, 0);
+        EXPECT_EQ(stats.getStage(Stage::GeometryInstances).objectCount, 0);
+    }
+
+    // Changing the light uploads exactly one light.
+    pLight->setIntensity(float3(2.f));
+    pScene->update(pRenderContext, 0.5);
+    {
+        const auto& stats = pScene->getUpdateStats();
+        EXPECT_EQ(stats.getStage(Stage::Lights).objectCount, 1);
+        EXPECT_EQ(stats.getStage(Stage::Lights).bytesUploaded, sizeof(LightData));
+        EXPECT_EQ(stats.getStage(Stage::Animation).objectCount, 0);
+        EXPECT_GE(stats.getAccumulatedStage(Stage::Animation).objectCount, 1);
+        EXPECT_EQ(stats.getAccumulatedStage(Stage::Lights).objectCount, 1);
+        EXPECT_GT(stats.getAccumulatedTotal().cpuTimeMs, 0.0);
+    }
+}
+} // namespace Falcor
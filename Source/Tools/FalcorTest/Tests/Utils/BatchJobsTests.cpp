@@ -0,0 +1,372 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/BatchJobs.h"
+#include "Utils/Math/Vector.h"
+
+#include <algorithm>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+/// Executor recording all calls, with optional failures.
+class MockExecutor : public BatchRunner::Executor
+{
+public:
+    std::vector<std::string> calls;
+    std::set<std::string> failingScenes;
+    std::set<std::string> failingGraphs;
+    std::set<uint32_t> failingFrames;
+    std::vector<std::string> outputs = {"color"};
+    uint2 resolution = uint2(64, 64);
+
+    void loadScene(const std::filesystem::path& path) override
+    {
+        calls.push_back("scene " + path.filename().string());
+        if (failingScenes.count(path.filename().string()))
+            FALCOR_THROW("Scene load failed");
+    }
+
+    void loadGraph(const std::filesystem::path& path, const std::map<std::string, Properties>& passProperties) override
+    {
+        calls.push_back("graph " + path.filename().string());
+        if (failingGraphs.count(path.filename().string()))
+            FALCOR_THROW("Graph load failed");
+    }
+
+    uint2 getResolution() override { return resolution; }
+    void setResolution(uint2 resolution) override { calls.push_back(fmt::format("resolution {}x{}", resolution.x, resolution.y)); }
+    void setCamera(const BatchJob::Camera& camera) override { calls.push_back("camera " + camera.getDescription()); }
+
+    void renderFrame(uint32_t frame) override
+    {
+        calls.push_back(fmt::format("render {}", frame));
+        if (failingFrames.count(frame))
+            FALCOR_THROW("Render failed");
+    }
+
+    void resetTemporalState() override { calls.push_back("reset"); }
+
+    std::vector<std::string> getOutputs() override { return outputs; }
+
+    void captureOutput(const std::string& output, const std::filesystem::path& path) override
+    {
+        calls.push_back("capture " + path.filename().string());
+    }
+
+    void setRenderTile(const RenderTile& tile) override
+    {
+        calls.push_back(fmt::format("tile {},{} {}x{}", tile.offset.x, tile.offset.y, tile.extent.x, tile.extent.y));
+    }
+
+    void captureTile(const std::string& output, const RenderTile& region, const RenderTile& tile) override
+    {
+        calls.push_back(fmt::format("captureTile {} {},{}", output, tile.offset.x, tile.offset.y));
+    }
+
+    void writeStitchedOutput(const std::string& output, const std::filesystem::path& path) override
+    {
+        calls.push_back("stitch " + path.filename().string());
+    }
+
+    size_t count(std::string_view prefix) const
+    {
+        return std::count_if(calls.begin(), calls.end(), [&](const std::string& call) { return call.rfind(prefix, 0) == 0; });
+    }
+};
+
+std::vector<std::string> getNames(const std::vector<BatchJob>& jobs, const std::vector<size_t>& order)
+{
+    std::vector<std::string> names;
+    for (size_t i : order)
+        names.push_back(jobs[i].name);
+    return names;
+}
+
+BatchJob createJob(std::string name, std::string scene, std::string graph, uint2 resolution = uint2(0))
+{
+    BatchJob job;
+    job.name = name;
+    job.scene = scene;
+    job.graph = graph;
+    job.resolution = resolution;
+    job.outputPattern = name + "_{output}_{frame}.exr";
+    return job;
+}
+} // namespace
+
+CPU_TEST(BatchJobs_Parse)
+{
+    const std::string text = R"({
+        "defaults": { "scene": "scenes/a.pyscene", "graph": "graphs/pt.py", "output": "out/{job}_{output}_{frame:03}.exr" },
+        "jobs": [
+            { "name": "first", "frames": [0, 4, 2], "camera": "Camera1", "outputs": ["color", "albedo"] },
+            { "scene": "/abs/b.pyscene", "camera": { "viewpoint": 2 }, "resolution": [640, 480], "subframes": 16,
+              "passProperties": { "PathTracer": { "samplesPerPixel": 4 } } },
+            { "camera": { "position": [1, 2, 3], "target": [0, 0, 0] }, "frames": 7 }
+        ]
+    })";
+
+    auto jobs = BatchJob::parse(text, "/base");
+    ASSERT_EQ(jobs.size(), 3);
+
+    EXPECT_EQ(jobs[0].name, "first");
+    EXPECT(jobs[0].scene == std::filesystem::path("/base/scenes/a.pyscene"));
+    EXPECT(jobs[0].graph == std::filesystem::path("/base/graphs/pt.py"));
+    EXPECT(jobs[0].camera.type == BatchJob::Camera::Type::Name);
+    EXPECT_EQ(jobs[0].camera.name, "Camera1");
+    EXPECT(jobs[0].frames.getFrames() == std::vector<uint32_t>({0, 2, 4}));
+    EXPECT_EQ(jobs[0].outputs.size(), 2);
+    EXPECT(jobs[0].getOutputPath("albedo", 2) == std::filesystem::path("/base/out/first_albedo_002.exr"));
+
+    // Default name, absolute scene path and pass properties.
+    EXPECT_EQ(jobs[1].name, "job1");
+    EXPECT(jobs[1].scene == std::filesystem::path("/abs/b.pyscene"));
+    EXPECT(jobs[1].camera.type == BatchJob::Camera::Type::Viewpoint);
+    EXPECT_EQ(jobs[1].camera.viewpoint, 2);
+    EXPECT(all(jobs[1].resolution == uint2(640, 480)));
+    EXPECT_EQ(jobs[1].subframes, 16);
+    EXPECT_EQ(jobs[1].passProperties.count("PathTracer"), 1);
+    EXPECT_NE(jobs[0].getGraphKey(), jobs[1].getGraphKey());
+
+    EXPECT(jobs[2].camera.type == BatchJob::Camera::Type::LookAt);
+    EXPECT(all(jobs[2].camera.position == float3(1, 2, 3)));
+    EXPECT(all(jobs[2].camera.up == float3(0, 1, 0)));
+    EXPECT(jobs[2].frames.getFrames() == std::vector<uint32_t>({7}));
+    EXPECT_EQ(jobs[0].getGraphKey(), jobs[2].getGraphKey());
+
+    // Invalid files.
+    const std::string job = R"("scene": "a.pyscene", "graph": "pt.py")";
+    EXPECT_THROW(BatchJob::parse("{", "/base"));
+    EXPECT_THROW(BatchJob::parse(R"({ "jobs": {} })", "/base"));
+    EXPECT_THROW(BatchJob::parse(R"({ "jobs": [{ "graph": "pt.py", "output": "x.exr" }] })", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"output\": \"x.exr\", \"unknown\": 1 }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"output\": \"x.exr\", \"frames\": [4, 2] }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"output\": \"x.exr\", \"camera\": 1 }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"output\": \"x{unknown}.exr\" }] }", "/base"));
+    // Pattern must distinguish frames and outputs.
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"output\": \"{output}.exr\", \"frames\": [0, 1] }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"output\": \"{frame}.exr\" }] }", "/base"));
+    BatchJob::parse("{ \"jobs\": [{ " + job + ", \"output\": \"{frame}.exr\", \"outputs\": [\"color\"] }] }", "/base");
+    // Duplicate names.
+    EXPECT_THROW(BatchJob::parse(
+        "{ \"jobs\": [{ \"name\": \"a\", " + job + ", \"output\": \"a.exr\" }, { \"name\": \"a\", " + job + ", \"output\": \"b.exr\" }] }",
+        "/base"
+    ));
+}
+
+CPU_TEST(BatchJobs_Schedule)
+{
+    std::vector<BatchJob> jobs = {
+        createJob("a0", "a", "g0"),
+        createJob("b0", "b", "g0"),
+        createJob("a1", "a", "g1"),
+        createJob("b1", "b", "g1"),
+        createJob("a2", "a", "g0", uint2(64, 64)),
+        createJob("a3", "a", "g0"),
+    };
+
+    // Grouped by scene, graph and resolution. Graph g1 loaded last for scene a is kept for scene b.
+    auto order = BatchRunner::schedule(jobs);
+    EXPECT(getNames(jobs, order) == std::vector<std::string>({"a0", "a3", "a2", "a1", "b1", "b0"}));
+
+    // Pass properties select distinct graph variants.
+    jobs[3].passProperties["Pass"].set("value", 1);
+    order = BatchRunner::schedule(jobs);
+    EXPECT(getNames(jobs, order) == std::vector<std::string>({"a0", "a3", "a2", "a1", "b0", "b1"}));
+}
+
+CPU_TEST(BatchJobs_Run)
+{
+    std::vector<BatchJob> jobs = {
+        createJob("a0", "a", "g0"),
+        createJob("b0", "b", "g0"),
+        createJob("a1", "a", "g0", uint2(32, 16)),
+    };
+    jobs[0].frames = {2, 3, 1};
+    jobs[0].subframes = 2;
+    jobs[1].camera.type = BatchJob::Camera::Type::Viewpoint;
+    jobs[1].camera.viewpoint = 1;
+    jobs[2].outputs = {"albedo"};
+
+    MockExecutor executor;
+    executor.outputs = {"color", "depth"};
+    BatchReport report = BatchRunner::run(jobs, executor);
+
+    // Scenes and graphs are loaded once and reused. Temporal state is reset for every job, and jobs
+    // without a resolution render at the initial resolution.
+    const std::vector<std::string> expected = {
+        "scene a",
+        "graph g0",
+        "camera default",
+        "reset",
+        "render 2",
+        "render 2",
+        "capture a0_color_2.exr",
+        "capture a0_depth_2.exr",
+        "render 3",
+        "render 3",
+        "capture a0_color_3.exr",
+        "capture a0_depth_3.exr",
+        "resolution 32x16",
+        "camera default",
+        "reset",
+        "render 0",
+        "capture a1_albedo_0.exr",
+        "scene b",
+        "resolution 64x64",
+        "camera viewpoint1",
+        "reset",
+        "render 0",
+        "capture b0_color_0.exr",
+        "capture b0_depth_0.exr",
+    };
+    EXPECT(executor.calls == expected);
+
+    ASSERT_EQ(report.jobs.size(), 3);
+    EXPECT_EQ(report.getFailedCount(), 0);
+    EXPECT_EQ(report.jobs[0].name, "a0");
+    EXPECT_EQ(report.jobs[0].framesRendered, 4);
+    EXPECT_EQ(report.jobs[0].files.size(), 4);
+    EXPECT(report.jobs[0].files[1] == std::filesystem::path("a0_depth_2.exr"));
+    EXPECT_EQ(report.jobs[1].name, "a1");
+    EXPECT_EQ(report.jobs[1].files.size(), 1);
+    EXPECT_EQ(report.jobs[2].name, "b0");
+}
+
+CPU_TEST(BatchJobs_Tiled)
+{
+    const std::string job = R"("scene": "a.pyscene", "graph": "pt.py", "output": "{output}.exr", "outputs": ["color"])";
+    auto jobs = BatchJob::parse(
+        "{ \"jobs\": [{ " + job + R"(, "resolution": [64, 32], "region": [16, 0, 32, 16], "tileSize": 16, "tileOrder": "Scanline" },
+                       { )" + job + R"(, "resolution": [64, 32], "tileSize": [32, 16] }] })",
+        "/base"
+    );
+    ASSERT_EQ(jobs.size(), 2);
+    EXPECT_TRUE(jobs[0].isTiled());
+    EXPECT(jobs[0].region == RenderTile({uint2(16, 0), uint2(32, 16)}));
+    EXPECT(all(jobs[0].tileSize == uint2(16)));
+    EXPECT(jobs[0].tileOrder == TileScheduler::Order::Scanline);
+    EXPECT(jobs[1].region.isEmpty());
+    EXPECT(jobs[1].tileOrder == TileScheduler::Order::Spiral);
+
+    // Tiled jobs require a resolution and a region overlapping the frame.
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"tileSize\": 16 }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"resolution\": [64, 32], \"region\": [64, 0, 8, 8] }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"resolution\": [64, 32], \"region\": [0, 0, 0, 8] }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"resolution\": [64, 32], \"tileSize\": [16] }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"resolution\": [64, 32], \"tileOrder\": \"Random\" }] }", "/base"));
+    EXPECT_THROW(BatchJob::parse("{ \"jobs\": [{ " + job + ", \"resolution\": [64, 32], \"tileOrder\": \"ErrorPriority\" }] }", "/base"));
+
+    // All subframes of a tile are rendered before the next tile. The tile is reset before stitching.
+    jobs[0].subframes = 2;
+    MockExecutor executor;
+    BatchReport report = BatchRunner::run({jobs[0]}, executor);
+    const std::vector<std::string> expected = {
+        "scene a.pyscene",
+        "graph pt.py",
+        "resolution 64x32",
+        "camera default",
+        "reset",
+        "tile 16,0 16x16",
+        "render 0",
+        "render 0",
+        "captureTile color 16,0",
+        "tile 32,0 16x16",
+        "render 0",
+        "render 0",
+        "captureTile color 32,0",
+        "tile 0,0 0x0",
+        "stitch color.exr",
+    };
+    EXPECT(executor.calls == expected);
+    ASSERT_EQ(report.jobs.size(), 1);
+    EXPECT_TRUE(report.jobs[0].succeeded);
+    EXPECT_EQ(report.jobs[0].framesRendered, 4);
+    EXPECT_EQ(report.jobs[0].files.size(), 1);
+
+    // Without a tile size, the region is rendered as a single tile.
+    jobs[0].tileSize = uint2(0);
+    executor.calls.clear();
+    BatchRunner::run({jobs[0]}, executor);
+    EXPECT_EQ(executor.count("tile 16,0 32x16"), 1);
+    EXPECT_EQ(executor.count("captureTile"), 1);
+}
+
+CPU_TEST(BatchJobs_FailureIsolation)
+{
+    std::vector<BatchJob> jobs = {
+        createJob("a0", "a", "g0"),
+        createJob("a1", "a", "bad"),
+        createJob("a2", "a", "g0", uint2(32, 32)),
+        createJob("b0", "broken", "g0"),
+        createJob("b1", "broken", "g1"),
+        createJob("c0", "c", "g0"),
+        createJob("c1", "c", "g0", uint2(16, 16)),
+    };
+    jobs[5].frames = {0, 1, 1};
+
+    MockExecutor executor;
+    executor.failingScenes = {"broken"};
+    executor.failingGraphs = {"bad"};
+    executor.failingFrames = {1};
+    BatchReport report = BatchRunner::run(jobs, executor);
+
+    ASSERT_EQ(report.jobs.size(), 7);
+    std::map<std::string, const BatchReport::Job*> results;
+    for (const auto& job : report.jobs)
+        results[job.name] = &job;
+
+    EXPECT_TRUE(results["a0"]->succeeded);
+    EXPECT_FALSE(results["a1"]->succeeded);
+    EXPECT(results["a1"]->error.find("Graph load failed") != std::string::npos);
+    EXPECT_TRUE(results["a2"]->succeeded);
+    EXPECT_FALSE(results["b0"]->succeeded);
+    EXPECT_FALSE(results["b1"]->succeeded);
+    EXPECT(results["b1"]->error.find("Scene load failed") != std::string::npos);
+    // Rendering failed on the second frame, the outputs of the first frame were written.
+    EXPECT_FALSE(results["c0"]->succeeded);
+    EXPECT_EQ(results["c0"]->files.size(), 1);
+    EXPECT_TRUE(results["c1"]->succeeded);
+    EXPECT_EQ(report.getFailedCount(), 4);
+
+    // Failed scenes and graphs are not attempted again, the graph is reloaded after a render failure.
+    EXPECT_EQ(executor.count("scene broken"), 1);
+    EXPECT_EQ(executor.count("graph bad"), 1);
+    EXPECT_EQ(executor.count("scene "), 3);
+    EXPECT_EQ(executor.count("graph g0"), 3);
+
+    const std::string summary = report.getSummary();
+    EXPECT(summary.find("3 of 7 jobs succeeded") != std::string::npos) << summary;
+    const std::string json = report.toJsonString();
+    EXPECT(json.find("\"failedCount\": 4") != std::string::npos) << json;
+}
+
+} // namespace Falcor
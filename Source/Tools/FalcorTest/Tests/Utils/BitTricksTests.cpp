@@ -46,7 +46,7 @@ uint32_t referenceBitInterleave(uint32_t x, uint32_t y, uint32_t m)
 }
 } // namespace
 
-GPU_TEST(BitInterleave)
+GPU_TEST(BitInterleave, DEVICE_TYPES(Device::Type::D3D12, Device::Type::Vulkan, Device::Type::CPU))
 {
     ref<Device> pDevice = ctx.getDevice();
 
@@ -27,6 +27,10 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/BufferAllocator.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+
+#include <random>
 
 namespace Falcor
 {
@@ -313,4 +317,272 @@ GPU_TEST(BufferAllocatorStructAlign)
     }
 }
 
+GPU_TEST(BufferAllocatorDirtyRanges)
+{
+    BufferAllocator buf(16, 0, 128);
+    for (uint32_t i = 0; i < 256; i++)
+        buf.pushBack(i);
+
+    // Newly allocated memory is uploaded as a single range.
+    auto ranges = buf.getDirtyRanges();
+    ASSERT_EQ(ranges.size(), 1);
+    EXPECT_EQ(ranges[0].start, 0);
+    EXPECT_EQ(ranges[0].end, buf.getSize());
+
+    ref<Buffer> pBuffer = buf.getGPUBuffer(ctx.getDevice());
+    EXPECT(buf.getDirtyRanges().empty());
+
+    // Nearby updates are coalesced, distant updates are uploaded separately.
+    buf.set<uint32_t>(16, 1000);
+    buf.set<uint32_t>(64, 1001);
+    buf.set<uint32_t>(16 * 200, 1002);
+    buf.set<uint32_t>(16 * 10, 1003);
+    ranges = buf.getDirtyRanges();
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT_EQ(ranges[0].start, 16);
+    EXPECT_EQ(ranges[0].end, 16 * 10 + 4);
+    EXPECT_EQ(ranges[1].start, 16 * 200);
+    EXPECT_EQ(ranges[1].end, 16 * 200 + 4);
+
+    // Freeing and reallocating memory within the GPU buffer doesn't recreate it.
+    size_t offset = buf.pushBack<uint32_t>(2000);
+    buf.free(offset);
+    buf.free(16 * 100);
+    offset = buf.pushBack<uint32_t>(2001);
+    EXPECT_EQ(offset, 16 * 100);
+
+    EXPECT(buf.getGPUBuffer(ctx.getDevice()) == pBuffer);
+    std::vector<uint32_t> data = pBuffer->getElements<uint32_t>(0, buf.getSize() / 4);
+    const uint32_t* ref = reinterpret_cast<const uint32_t*>(buf.getStartPointer());
+    for (size_t i = 0; i < buf.getSize() / 4; i++)
+    {
+        EXPECT_EQ(data[i], ref[i]) << "i=" << i;
+    }
+}
+
+CPU_TEST(BufferAllocatorFree)
+{
+    // Raw buffer with alignment and cacheline alignment.
+    BufferAllocator buf(16, 0, 128);
+
+    size_t a = buf.allocate(32);
+    size_t b = buf.allocate(48);
+    size_t c = buf.allocate(16);
+    size_t d = buf.allocate(64);
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 32);
+    EXPECT_EQ(c, 80);
+    EXPECT_EQ(d, 128);
+    EXPECT_EQ(buf.getSize(), 192);
+    EXPECT_EQ(buf.getAllocatedSize(), 160);
+    EXPECT_EQ(buf.getAllocationCount(), 4);
+
+    // Freed memory is reused by allocations that fit.
+    buf.set<uint32_t>(b, 1234);
+    buf.free(b);
+    EXPECT_EQ(buf.getFreeSize(), 48);
+    EXPECT_EQ(buf.allocate(64), 192);
+    size_t e = buf.allocate(20);
+    EXPECT_EQ(e, 32);
+    EXPECT_EQ(*reinterpret_cast<const uint32_t*>(buf.getStartPointer() + e), 0); // Zero initialized.
+    EXPECT_EQ(buf.getFreeSize(), 28);
+
+    // Adjacent free blocks are coalesced.
+    buf.free(a);
+    buf.free(e);
+    buf.free(c);
+    EXPECT_EQ(buf.getFreeSize(), 96);
+    EXPECT_EQ(buf.allocate(96), 0);
+    EXPECT_EQ(buf.getFreeSize(), 0);
+
+    // Freeing allocations at the end shrinks the buffer.
+    buf.free(192);
+    EXPECT_EQ(buf.getSize(), 192);
+    buf.free(d);
+    EXPECT_EQ(buf.getSize(), 96);
+    buf.free(0);
+    EXPECT_EQ(buf.getSize(), 0);
+    EXPECT_EQ(buf.getAllocatedSize(), 0);
+    EXPECT_EQ(buf.getFreeSize(), 0);
+
+    // Invalid frees.
+    EXPECT_THROW(buf.free(0));
+    size_t f = buf.allocate(16);
+    EXPECT_THROW(buf.free(f + 4));
+    buf.free(f);
+    EXPECT_THROW(buf.free(f));
+}
+
+CPU_TEST(BufferAllocatorCompact)
+{
+    const size_t kCacheLineSize = 128;
+    BufferAllocator buf(16, 0, kCacheLineSize);
+    std::mt19937 rng(1);
+
+    // Allocations filled with a pattern derived from their ID.
+    std::map<size_t, std::pair<uint32_t, size_t>> allocations; // offset -> (id, size)
+    auto validate = [&]()
+    {
+        for (const auto& [offset, allocation] : allocations)
+        {
+            const auto [id, size] = allocation;
+            EXPECT_EQ(offset % 16, 0);
+            if (size <= kCacheLineSize)
+                EXPECT_LE(offset % kCacheLineSize + size, kCacheLineSize);
+            const uint8_t* ptr = buf.getStartPointer() + offset;
+            for (size_t i = 0; i < size; i++)
+                if (ptr[i] != uint8_t(id + i))
+                    return false;
+        }
+        return true;
+    };
+
+    for (uint32_t id = 0; id < 1000; id++)
+    {
+        size_t size = 4 + rng() % 300;
+        size_t offset = buf.allocate(size);
+        for (size_t i = 0; i < size; i++)
+            buf.getStartPointer()[offset + i] = uint8_t(id + i);
+        allocations[offset] = {id, size};
+
+        // Free every other allocation at random.
+        if (rng() % 2)
+        {
+            auto it = std::next(allocations.begin(), rng() % allocations.size());
+            buf.free(it->first);
+            allocations.erase(it);
+        }
+    }
+    EXPECT(validate());
+
+    const size_t oldSize = buf.getSize();
+    auto relocations = buf.compact();
+    EXPECT(!relocations.empty());
+    EXPECT_LE(buf.getSize(), oldSize);
+    EXPECT_EQ(buf.getFreeSize(), 0);
+    EXPECT_EQ(buf.getAllocationCount(), allocations.size());
+
+    // Apply the remapping.
+    std::map<size_t, std::pair<uint32_t, size_t>> relocated = allocations;
+    for (const auto& relocation : relocations)
+    {
+        EXPECT_LE(relocation.newOffset, relocation.oldOffset);
+        auto it = relocated.find(relocation.oldOffset);
+        ASSERT(it != relocated.end());
+        EXPECT_EQ(it->second.second, relocation.byteSize);
+    }
+    relocated.clear();
+    auto relocation = relocations.begin();
+    for (const auto& [offset, allocation] : allocations)
+    {
+        size_t newOffset = offset;
+        if (relocation != relocations.end() && relocation->oldOffset == offset)
+            newOffset = (relocation++)->newOffset;
+        relocated[newOffset] = allocation;
+    }
+    allocations = std::move(relocated);
+    EXPECT(validate());
+
+    // The compacted buffer is as small as placing the allocations from scratch.
+    BufferAllocator ref(16, 0, kCacheLineSize);
+    for (const auto& [offset, allocation] : allocations)
+        EXPECT_EQ(ref.allocate(allocation.second), offset);
+    EXPECT_EQ(ref.getSize(), buf.getSize());
+
+    // Compacting a compacted buffer does nothing.
+    EXPECT(buf.compact().empty());
+}
+
+CPU_TEST(BufferAllocatorFragmentation)
+{
+    // Dynamic content: a working set of allocations that is continuously replaced.
+    const size_t kWorkingSetSize = 2000;
+    const size_t kIterations = 50000;
+    BufferAllocator buf(16, 0, 128);
+    std::mt19937 rng(1);
+    std::vector<size_t> offsets;
+    size_t peakAllocatedSize = 0;
+    size_t totalAllocatedSize = 0;
+
+    for (size_t i = 0; i < kIterations; i++)
+    {
+        if (offsets.size() == kWorkingSetSize)
+        {
+            size_t index = rng() % offsets.size();
+            buf.free(offsets[index]);
+            offsets[index] = offsets.back();
+            offsets.pop_back();
+        }
+        size_t size = 16 << (rng() % 6); // 16 B to 512 B.
+        offsets.push_back(buf.allocate(size));
+        totalAllocatedSize += size;
+        peakAllocatedSize = std::max(peakAllocatedSize, buf.getAllocatedSize());
+    }
+
+    // Without freeing, the buffer would hold all allocations ever made. With free lists it stays close to the working set.
+    const double fragmentation = 1.0 - double(buf.getAllocatedSize()) / buf.getSize();
+    logInfo(
+        "BufferAllocatorFragmentation: size {} B, peak allocated {} B, total allocated {} B, fragmentation {:.1f}%.",
+        buf.getSize(),
+        peakAllocatedSize,
+        totalAllocatedSize,
+        fragmentation * 100.0
+    );
+    EXPECT_LE(buf.getSize(), 2 * peakAllocatedSize);
+    EXPECT_EQ(buf.getAllocationCount(), kWorkingSetSize);
+
+    // Compaction removes all free memory.
+    const size_t size = buf.getSize();
+    buf.compact();
+    EXPECT_EQ(buf.getFreeSize(), 0);
+    EXPECT_LE(buf.getSize(), size);
+}
+
+CPU_TEST(BufferAllocatorThroughput, TAGS("benchmark"), "Disabled for performance reasons")
+{
+    const size_t kCount = 200000;
+    std::mt19937 rng(1);
+    std::vector<size_t> sizes(kCount);
+    for (auto& size : sizes)
+        size = 4 + rng() % 256;
+
+    CpuTimer timer;
+
+    // Append only.
+    timer.update();
+    {
+        BufferAllocator buf(16, 0, 128);
+        for (size_t size : sizes)
+            buf.allocate(size);
+    }
+    timer.update();
+    const double appendTime = timer.delta();
+
+    // Interleaved allocations and frees, keeping half of the allocations alive.
+    std::vector<size_t> offsets;
+    offsets.reserve(kCount);
+    timer.update();
+    BufferAllocator buf(16, 0, 128);
+    for (size_t i = 0; i < kCount; i++)
+    {
+        offsets.push_back(buf.allocate(sizes[i]));
+        if (i % 2 == 1)
+        {
+            size_t index = rng() % offsets.size();
+            buf.free(offsets[index]);
+            offsets[index] = offsets.back();
+            offsets.pop_back();
+        }
+    }
+    timer.update();
+    const double churnTime = timer.delta();
+
+    EXPECT_EQ(buf.getAllocationCount(), kCount / 2);
+    logInfo(
+        "BufferAllocatorThroughput: append {:.1f} Mops/s, allocate/free {:.1f} Mops/s.",
+        kCount / appendTime * 1e-6,
+        (kCount + kCount / 2) / churnTime * 1e-6
+    );
+}
+
 } // namespace Falcor
@@ -0,0 +1,114 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Color/RGBToSpectrum.h"
+#include "Utils/Color/SpectrumUtils.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Color of a reflectance spectrum lit by D65, normalized such that a perfect white reflector has luminance 1.
+float3 reflectanceToRGB_D65(const SigmoidPolynomialSpectrum& spectrum)
+{
+    float3 xyz(0.f);
+    float Y = 0.f;
+    for (float lambda = 360.f; lambda <= 830.f; lambda += 1.f)
+    {
+        float3 w = SpectrumUtils::wavelengthToXYZ_CIE1931(lambda) * SpectrumUtils::wavelengthToD65(lambda);
+        xyz += w * spectrum.eval(lambda);
+        Y += w.y;
+    }
+    return XYZtoRGB_Rec709(xyz / Y);
+}
+
+std::vector<float3> generateColors(uint32_t count)
+{
+    std::mt19937 rng;
+    auto dist = std::uniform_real_distribution<float>();
+    std::vector<float3> colors = {float3(0.f), float3(1.f), float3(0.5f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f), float3(0.f, 0.f, 1.f)};
+    while (colors.size() < count)
+        colors.push_back(float3(dist(rng), dist(rng), dist(rng)));
+    return colors;
+}
+} // namespace
+
+CPU_TEST(RGBToSpectrum_RoundTrip)
+{
+    const RGBToSpectrumTable& table = RGBToSpectrumTable::get();
+    EXPECT_EQ(&table, &RGBToSpectrumTable::get());
+
+    std::vector<float3> colors = generateColors(1000);
+    std::vector<float3> coefficients = table.getCoefficients(colors);
+    ASSERT_EQ(coefficients.size(), colors.size());
+
+    for (size_t i = 0; i < colors.size(); i++)
+    {
+        EXPECT_EQ(coefficients[i], table.getCoefficients(colors[i]));
+
+        SigmoidPolynomialSpectrum spectrum(colors[i], table);
+        EXPECT_GE(spectrum.getMaxValue(), 0.f);
+        EXPECT_LE(spectrum.getMaxValue(), 1.f);
+
+        float3 rgb = reflectanceToRGB_D65(spectrum);
+        for (uint32_t c = 0; c < 3; c++)
+            EXPECT_LE(std::abs(rgb[c] - colors[i][c]), 0.01f) << "color = " << colors[i][0] << ", " << colors[i][1] << ", " << colors[i][2];
+    }
+}
+
+GPU_TEST(RGBToSpectrum_GPU)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    const RGBToSpectrumTable& table = RGBToSpectrumTable::get();
+    ref<Buffer> pTable = table.createBuffer(pDevice);
+
+    std::vector<float3> colors = generateColors(1000);
+    const uint32_t n = (uint32_t)colors.size();
+    const float lambda = 550.f;
+
+    ctx.createProgram("Tests/Utils/Color/RGBToSpectrumTests.cs.slang", "testRGBToSpectrum");
+    ctx.allocateStructuredBuffer("colors", n, colors.data());
+    ctx.allocateStructuredBuffer("coefficients", n);
+    ctx.allocateStructuredBuffer("values", n);
+    table.bindShaderData(ctx["table"], pTable);
+    ctx["CB"]["n"] = n;
+    ctx["CB"]["lambda"] = lambda;
+    ctx.runProgram(n, 1, 1);
+
+    std::vector<float3> coefficients = ctx.readBuffer<float3>("coefficients");
+    std::vector<float> values = ctx.readBuffer<float>("values");
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float3 ref = table.getCoefficients(colors[i]);
+        for (uint32_t c = 0; c < 3; c++)
+            EXPECT_LE(std::abs(coefficients[i][c] - ref[c]), 1e-4f * std::abs(ref[c]) + 1e-6f) << "i = " << i;
+        EXPECT_LE(std::abs(values[i] - RGBToSpectrumTable::evalSigmoidPolynomial(ref, lambda)), 1e-4f) << "i = " << i;
+    }
+}
+} // namespace Falcor
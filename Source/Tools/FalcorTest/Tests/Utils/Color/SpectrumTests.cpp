@@ -49,4 +49,53 @@ CPU_TEST(SpectrumXYZ)
     EXPECT_LT(std::abs(1.f - y), 0.005f);
     EXPECT_LT(std::abs(1.f - z), 0.005f);
 }
+
+CPU_TEST(SpectrumToXYZ)
+{
+    // Compare the single pass conversion to separate inner products with the matching functions.
+    auto reference = [](const auto& s)
+    {
+        return float3(innerProduct(s, Spectra::kCIE_X), innerProduct(s, Spectra::kCIE_Y), innerProduct(s, Spectra::kCIE_Z)) /
+               Spectra::kCIE_Y_Integral;
+    };
+    auto expectNear = [&](float3 res, float3 ref)
+    {
+        for (uint32_t c = 0; c < 3; c++)
+            EXPECT_LE(std::abs(res[c] - ref[c]), 1e-5f * std::abs(ref[c]) + 1e-6f);
+    };
+
+    for (const char* name : {"stdillum-D65", "stdillum-F5", "metal-Cu-eta", "metal-Au-k", "glass-BK7"})
+    {
+        const PiecewiseLinearSpectrum* pSpectrum = Spectra::getNamedSpectrum(name);
+        ASSERT(pSpectrum != nullptr);
+        expectNear(spectrumToXYZ(*pSpectrum), reference(*pSpectrum));
+    }
+
+    BlackbodySpectrum blackbody(4000.f);
+    expectNear(spectrumToXYZ(blackbody), reference(blackbody));
+
+    // Range starting at a fractional wavelength.
+    std::vector<float> wavelengths = {380.5f, 500.25f, 620.75f, 700.5f};
+    std::vector<float> values = {0.2f, 1.f, 0.5f, 0.1f};
+    PiecewiseLinearSpectrum spectrum(wavelengths, values);
+    expectNear(spectrumToXYZ(spectrum), reference(spectrum));
+
+    std::vector<PiecewiseLinearSpectrum> spectra = {spectrum, *Spectra::getNamedSpectrum("stdillum-A")};
+    std::vector<float3> rgb = spectrumToRGB<PiecewiseLinearSpectrum>(spectra);
+    ASSERT_EQ(rgb.size(), spectra.size());
+    for (size_t i = 0; i < spectra.size(); i++)
+        EXPECT_EQ(rgb[i], spectrumToRGB(spectra[i]));
+}
+
+CPU_TEST(PiecewiseLinearSpectrumEvalUniform)
+{
+    std::vector<float> wavelengths = {400.f, 450.f, 450.f, 600.f, 700.f};
+    std::vector<float> values = {0.f, 1.f, 0.5f, 0.25f, 1.f};
+    PiecewiseLinearSpectrum spectrum(wavelengths, values);
+
+    std::vector<float> result(500);
+    spectrum.evalUniform(350.f, 0.75f, result);
+    for (size_t i = 0; i < result.size(); i++)
+        EXPECT_EQ(result[i], spectrum.eval(350.f + (float)i * 0.75f)) << "i = " << i;
+}
 } // namespace Falcor
@@ -80,4 +80,58 @@ GPU_TEST(WavelengthToXYZ)
     EXPECT_LE(maxSqrError.y, 6.6e-5f);
     EXPECT_LE(maxSqrError.z, 5.2e-4f);
 }
+
+CPU_TEST(SpectrumUtils_PrecomputedIntegration)
+{
+    std::mt19937 rng;
+    auto dist = std::uniform_real_distribution<float>();
+
+    std::vector<SampledSpectrum<float>> spectra;
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        SampledSpectrum<float> spectrum(400.f, 700.f, 31);
+        for (size_t j = 0; j < spectrum.size(); j++)
+            spectrum.set(j, dist(rng));
+        spectra.push_back(spectrum);
+    }
+
+    for (uint32_t integrationSteps : {1u, 3u})
+    {
+        std::vector<float3> bulk = SpectrumUtils::toRGB_D65<float>(spectra, SpectrumInterpolation::Linear, 0, integrationSteps);
+        ASSERT_EQ(bulk.size(), spectra.size());
+
+        for (size_t i = 0; i < spectra.size(); i++)
+        {
+            // Reference integration evaluating the curves in each step.
+            float3 ref = SpectrumUtils::integrate<float, float3>(
+                spectra[i],
+                SpectrumInterpolation::Linear,
+                [](float wavelength) -> float3
+                { return SpectrumUtils::wavelengthToXYZ_CIE1931(wavelength) * SpectrumUtils::wavelengthToD65(wavelength); },
+                0,
+                integrationSteps
+            );
+            float3 xyz = SpectrumUtils::toXYZ_D65(spectra[i], SpectrumInterpolation::Linear, 0, integrationSteps);
+            for (uint32_t c = 0; c < 3; c++)
+                EXPECT_LE(std::abs(xyz[c] - ref[c]), 1e-5f * std::abs(ref[c]) + 1e-3f);
+
+            float3 rgb = SpectrumUtils::toRGB_D65(spectra[i], SpectrumInterpolation::Linear, 0, integrationSteps);
+            EXPECT_EQ(bulk[i], rgb);
+        }
+    }
+}
+
+CPU_TEST(SpectrumUtils_WavelengthToXYZ_D65)
+{
+    // The table is sampled at 1nm, so it matches the product of the curves exactly at integer wavelengths.
+    for (float lambda = SpectrumUtils::kTableLambdaStart; lambda <= SpectrumUtils::kTableLambdaEnd; lambda += 1.f)
+    {
+        float3 ref = SpectrumUtils::wavelengthToXYZ_CIE1931(lambda) * SpectrumUtils::wavelengthToD65(lambda);
+        float3 res = SpectrumUtils::wavelengthToXYZ_D65(lambda);
+        for (uint32_t c = 0; c < 3; c++)
+            EXPECT_LE(std::abs(res[c] - ref[c]), 1e-4f * ref[c] + 1e-6f);
+    }
+    EXPECT_EQ(SpectrumUtils::wavelengthToXYZ_D65(kTestMinWavelength), float3(0.f));
+    EXPECT_EQ(SpectrumUtils::wavelengthToXYZ_D65(kTestMaxWavelength), float3(0.f));
+}
 } // namespace Falcor
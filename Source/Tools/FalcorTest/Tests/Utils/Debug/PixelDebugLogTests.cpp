@@ -0,0 +1,385 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Debug/PixelDebugLog.h"
+#include <fstd/bit.h>
+#include <fstream>
+#include <limits>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kRadianceHash = 1;
+const uint32_t kDepthHash = 2;
+const uint32_t kAssertHash = 3;
+
+/// Emulates the GPU side of PixelDebug, which appends records to ring buffers.
+struct GpuRings
+{
+    std::vector<PrintRecord> prints;
+    std::vector<AssertRecord> asserts;
+    uint32_t printCount = 0;
+    uint32_t assertCount = 0;
+    uint32_t frameIndex = 0;
+
+    GpuRings(uint32_t printCapacity, uint32_t assertCapacity) : prints(printCapacity), asserts(assertCapacity) {}
+
+    void logPrint(uint32_t msgHash, uint2 pixel, float value)
+    {
+        PrintRecord rec = {};
+        rec.msgHash = msgHash;
+        rec.type = (uint32_t)PrintValueType::Float;
+        rec.count = 1;
+        rec.frameIndex = frameIndex;
+        rec.data = uint4(fstd::bit_cast<uint32_t>(value), 0, 0, 0);
+        rec.pixel = pixel;
+        prints[printCount++ % prints.size()] = rec;
+    }
+
+    void logAssert(uint32_t msgHash, uint2 pixel)
+    {
+        AssertRecord rec = {};
+        rec.launchIndex = uint3(pixel, 0);
+        rec.msgHash = msgHash;
+        rec.frameIndex = frameIndex;
+        asserts[assertCount++ % asserts.size()] = rec;
+    }
+
+    PixelDebugLog::Snapshot getSnapshot() const
+    {
+        PixelDebugLog::Snapshot snapshot;
+        snapshot.frameIndex = frameIndex;
+        snapshot.printCount = printCount;
+        snapshot.assertCount = assertCount;
+        snapshot.pPrintRing = prints.data();
+        snapshot.printCapacity = (uint32_t)prints.size();
+        snapshot.pAssertRing = asserts.data();
+        snapshot.assertCapacity = (uint32_t)asserts.size();
+        return snapshot;
+    }
+};
+
+void registerStrings(PixelDebugLog& log)
+{
+    log.registerString(kRadianceHash, "radiance");
+    log.registerString(kDepthHash, "depth");
+    log.registerString(kAssertHash, "finite");
+}
+
+float getValue(const PrintRecord& rec)
+{
+    return fstd::bit_cast<float>(rec.data.x);
+}
+} // namespace
+
+CPU_TEST(PixelDebugLog_Ingest)
+{
+    PixelDebugLog log;
+    registerStrings(log);
+    GpuRings gpu(16, 4);
+
+    for (uint32_t frame = 1; frame <= 3; frame++)
+    {
+        gpu.frameIndex = frame;
+        for (uint32_t x = 0; x < 4; x++)
+            gpu.logPrint(kRadianceHash, uint2(x, 7), float(frame * 10 + x));
+        gpu.logAssert(kAssertHash, uint2(frame, 0));
+        log.ingest(gpu.getSnapshot());
+    }
+
+    EXPECT_EQ(log.getStats().frames, 3);
+    EXPECT_EQ(log.getStats().prints, 12);
+    EXPECT_EQ(log.getStats().asserts, 3);
+    EXPECT_EQ(log.getStats().printOverflow, 0);
+    EXPECT_EQ(log.getStats().assertOverflow, 0);
+    EXPECT_EQ(log.getLastFrame(), 3);
+
+    // Records are returned in capture order.
+    auto prints = log.getPrints();
+    ASSERT_EQ(prints.size(), 12);
+    for (uint32_t i = 0; i < 12; i++)
+    {
+        EXPECT_EQ(prints[i].frameIndex, i / 4 + 1);
+        EXPECT_EQ(prints[i].pixel.x, i % 4);
+        EXPECT_EQ(getValue(prints[i]), float((i / 4 + 1) * 10 + i % 4));
+    }
+    auto asserts = log.getAsserts();
+    ASSERT_EQ(asserts.size(), 3);
+    EXPECT_EQ(asserts[2].launchIndex.x, 3);
+
+    EXPECT_EQ(log.formatPrint(prints[1]), "radiance 11");
+    EXPECT_EQ(log.formatAssert(asserts[0]), "Assert at (1, 0, 0) finite");
+
+    // Frames without new records.
+    gpu.frameIndex = 4;
+    log.ingest(gpu.getSnapshot());
+    EXPECT_EQ(log.getStats().frames, 4);
+    EXPECT_EQ(log.getPrints().size(), 12);
+
+    // Snapshots must arrive in order.
+    gpu.frameIndex = 2;
+    EXPECT_THROW(log.ingest(gpu.getSnapshot()));
+}
+
+CPU_TEST(PixelDebugLog_Overflow)
+{
+    PixelDebugLog log;
+    registerStrings(log);
+    GpuRings gpu(8, 2);
+
+    // More records than the ring capacity in a single frame. The oldest ones are lost.
+    gpu.frameIndex = 1;
+    for (uint32_t i = 0; i < 13; i++)
+        gpu.logPrint(kDepthHash, uint2(i, 0), float(i));
+    for (uint32_t i = 0; i < 5; i++)
+        gpu.logAssert(kAssertHash, uint2(i, 0));
+    log.ingest(gpu.getSnapshot());
+
+    EXPECT_EQ(log.getStats().prints, 13);
+    EXPECT_EQ(log.getStats().printOverflow, 5);
+    EXPECT_EQ(log.getStats().asserts, 5);
+    EXPECT_EQ(log.getStats().assertOverflow, 3);
+    EXPECT_EQ(log.getStats().maxFramePrints, 13);
+    EXPECT_EQ(log.getStats().maxFrameAsserts, 5);
+
+    auto prints = log.getPrints();
+    ASSERT_EQ(prints.size(), 8);
+    for (uint32_t i = 0; i < 8; i++)
+        EXPECT_EQ(getValue(prints[i]), float(i + 5));
+    auto asserts = log.getAsserts();
+    ASSERT_EQ(asserts.size(), 2);
+    EXPECT_EQ(asserts[0].launchIndex.x, 3);
+    EXPECT_EQ(asserts[1].launchIndex.x, 4);
+
+    // The next frame continues from the current write position.
+    gpu.frameIndex = 2;
+    gpu.logPrint(kDepthHash, uint2(0, 0), 100.f);
+    log.ingest(gpu.getSnapshot());
+    EXPECT_EQ(log.getStats().printOverflow, 5);
+    EXPECT_EQ(log.getStats().maxFramePrints, 13);
+    EXPECT_EQ(getValue(log.getPrints().back()), 100.f);
+
+    // Larger rings with reset counters, as after growing the GPU buffers. The history is kept.
+    GpuRings grown(16, 8);
+    log.resetCounters();
+    grown.frameIndex = 3;
+    for (uint32_t i = 0; i < 13; i++)
+        grown.logPrint(kDepthHash, uint2(i, 0), float(i));
+    log.ingest(grown.getSnapshot());
+    EXPECT_EQ(log.getStats().prints, 27);
+    EXPECT_EQ(log.getStats().printOverflow, 5);
+    EXPECT_EQ(log.getPrints().size(), 22);
+    EXPECT_EQ(getValue(log.getPrints().back()), 12.f);
+}
+
+CPU_TEST(PixelDebugLog_CounterWrap)
+{
+    PixelDebugLog log;
+    registerStrings(log);
+    GpuRings gpu(8, 2);
+
+    // Move the GPU counter close to wrapping around and sync the log to it.
+    gpu.printCount = std::numeric_limits<uint32_t>::max() - 2;
+    gpu.frameIndex = 1;
+    log.ingest(gpu.getSnapshot());
+    EXPECT_EQ(log.getStats().prints, (uint64_t)std::numeric_limits<uint32_t>::max() - 2);
+    log.clear();
+
+    gpu.frameIndex = 2;
+    for (uint32_t i = 0; i < 6; i++)
+        gpu.logPrint(kDepthHash, uint2(i, 0), float(i));
+    log.ingest(gpu.getSnapshot());
+
+    EXPECT_EQ(log.getStats().prints, 6);
+    EXPECT_EQ(log.getStats().printOverflow, 0);
+    auto prints = log.getPrints();
+    ASSERT_EQ(prints.size(), 6);
+    for (uint32_t i = 0; i < 6; i++)
+        EXPECT_EQ(getValue(prints[i]), float(i));
+}
+
+CPU_TEST(PixelDebugLog_Filter)
+{
+    PixelDebugLog log;
+    registerStrings(log);
+    GpuRings gpu(64, 8);
+
+    PixelDebugLog::Filter captureFilter;
+    captureFilter.region = uint4(2, 2, 6, 6);
+    log.setCaptureFilter(captureFilter);
+
+    for (uint32_t frame = 1; frame <= 4; frame++)
+    {
+        gpu.frameIndex = frame;
+        for (uint32_t x = 0; x < 8; x += 2)
+        {
+            gpu.logPrint(kRadianceHash, uint2(x, x), 1.f);
+            gpu.logPrint(kDepthHash, uint2(x, x), 2.f);
+        }
+        gpu.logAssert(kAssertHash, uint2(3, 3));
+        log.ingest(gpu.getSnapshot());
+    }
+
+    // Pixels (2,2) and (4,4) pass the capture filter.
+    EXPECT_EQ(log.getStats().prints, 32);
+    EXPECT_EQ(log.getStats().filtered, 16);
+    EXPECT_EQ(log.getPrints().size(), 16);
+    EXPECT_EQ(log.getAsserts().size(), 4);
+
+    // Query filters.
+    PixelDebugLog::Filter filter;
+    filter.message = "rad";
+    EXPECT_EQ(log.getPrints(filter).size(), 8);
+    filter.asserts = false;
+    EXPECT_EQ(log.getAsserts(filter).size(), 0);
+
+    filter = {};
+    filter.firstFrame = 2;
+    filter.lastFrame = 3;
+    filter.region = uint4(4, 4, 5, 5);
+    auto prints = log.getPrints(filter);
+    EXPECT_EQ(prints.size(), 4);
+    for (const auto& rec : prints)
+    {
+        EXPECT(rec.frameIndex >= 2 && rec.frameIndex <= 3);
+        EXPECT_EQ(rec.pixel.x, 4);
+    }
+    EXPECT_EQ(log.getAsserts(filter).size(), 0);
+
+    // Message capture filter.
+    captureFilter = {};
+    captureFilter.message = "depth";
+    log.setCaptureFilter(captureFilter);
+    log.clear();
+    gpu.frameIndex = 5;
+    gpu.logPrint(kRadianceHash, uint2(0, 0), 1.f);
+    gpu.logPrint(kDepthHash, uint2(0, 0), 2.f);
+    log.ingest(gpu.getSnapshot());
+    ASSERT_EQ(log.getPrints().size(), 1);
+    EXPECT_EQ(log.getPrints()[0].msgHash, kDepthHash);
+}
+
+CPU_TEST(PixelDebugLog_Aggregation)
+{
+    PixelDebugLog log(4);
+    registerStrings(log);
+    GpuRings gpu(16, 4);
+
+    const float kInf = std::numeric_limits<float>::infinity();
+    const float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+    gpu.frameIndex = 1;
+    gpu.logPrint(kRadianceHash, uint2(1, 1), 0.5f);
+    gpu.logPrint(kRadianceHash, uint2(2, 1), 2.5f);
+    gpu.logPrint(kDepthHash, uint2(1, 1), 3.f);
+    log.ingest(gpu.getSnapshot());
+
+    gpu.frameIndex = 2;
+    gpu.logPrint(kRadianceHash, uint2(3, 1), kInf);
+    gpu.logPrint(kRadianceHash, uint2(4, 1), kNaN);
+    gpu.logPrint(kRadianceHash, uint2(5, 1), -1.f);
+    gpu.logAssert(kAssertHash, uint2(4, 1));
+    log.ingest(gpu.getSnapshot());
+
+    // Aggregates cover all captured records, even those evicted from the history.
+    EXPECT_EQ(log.getStats().evicted, 3);
+    EXPECT_EQ(log.getPrints().size() + log.getAsserts().size(), 4);
+
+    auto stats = log.getMessageStats();
+    ASSERT_EQ(stats.size(), 3);
+    EXPECT_EQ(stats[0].message, "radiance");
+    EXPECT_EQ(stats[0].prints, 5);
+    EXPECT_EQ(stats[0].nonFinite, 2);
+    EXPECT_EQ(stats[0].minValue, -1.0);
+    EXPECT_EQ(stats[0].maxValue, 2.5);
+    EXPECT_EQ(stats[0].firstFrame, 1);
+    EXPECT_EQ(stats[0].lastFrame, 2);
+    EXPECT_EQ(stats[0].lastPixel.x, 5);
+    EXPECT_EQ(stats[1].message, "depth");
+    EXPECT_EQ(stats[2].message, "finite");
+    EXPECT_EQ(stats[2].asserts, 1);
+
+    log.clear();
+    EXPECT(log.getMessageStats().empty());
+    EXPECT_EQ(log.getStats().frames, 0);
+}
+
+CPU_TEST(PixelDebugLog_Dump)
+{
+    const std::filesystem::path dumpPath = "test_pixel_debug_dump.log";
+    const std::filesystem::path filePath = "test_pixel_debug_file.log";
+
+    auto readLines = [](const std::filesystem::path& path)
+    {
+        std::vector<std::string> lines;
+        std::ifstream stream(path);
+        for (std::string line; std::getline(stream, line);)
+            lines.push_back(line);
+        return lines;
+    };
+
+    {
+        PixelDebugLog log(2);
+        registerStrings(log);
+        GpuRings gpu(16, 4);
+
+        EXPECT(log.startDump(dumpPath));
+        EXPECT(log.isDumping());
+        for (uint32_t frame = 1; frame <= 3; frame++)
+        {
+            gpu.frameIndex = frame;
+            gpu.logPrint(kRadianceHash, uint2(frame, 2), float(frame));
+            if (frame == 2)
+                gpu.logAssert(kAssertHash, uint2(5, 6));
+            log.ingest(gpu.getSnapshot());
+        }
+        log.stopDump();
+        EXPECT(!log.isDumping());
+
+        // The dump contains all records, even those evicted from the history.
+        auto lines = readLines(dumpPath);
+        ASSERT_EQ(lines.size(), 4);
+        EXPECT_EQ(lines[0], "1\t1\t2\tprint\tradiance 1");
+        EXPECT_EQ(lines[1], "2\t2\t2\tprint\tradiance 2");
+        EXPECT_EQ(lines[2], "2\t5\t6\tassert\tAssert at (5, 6, 0) finite");
+        EXPECT_EQ(lines[3], "3\t3\t2\tprint\tradiance 3");
+
+        // Writing the history only contains the retained records.
+        EXPECT(log.writeToFile(filePath));
+        lines = readLines(filePath);
+        ASSERT_EQ(lines.size(), 2);
+        EXPECT_EQ(lines[0], "2\t5\t6\tassert\tAssert at (5, 6, 0) finite");
+        EXPECT_EQ(lines[1], "3\t3\t2\tprint\tradiance 3");
+    }
+
+    std::filesystem::remove(dumpPath);
+    std::filesystem::remove(filePath);
+}
+
+} // namespace Falcor
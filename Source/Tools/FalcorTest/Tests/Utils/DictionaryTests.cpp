@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Dictionary.h"
+
+namespace Falcor
+{
+CPU_TEST(Dictionary_TypedKeys)
+{
+    const Dictionary::Key<uint32_t> kIntKey("intValue");
+    const Dictionary::Key<float> kFloatKey("floatValue");
+
+    Dictionary dict;
+    EXPECT_FALSE(dict.keyExists(kIntKey));
+    EXPECT(dict.tryGetValue(kIntKey) == nullptr);
+    EXPECT_EQ(dict.getValue(kIntKey, 7u), 7u);
+    EXPECT_THROW(dict.getValue(kIntKey));
+
+    // Typed keys and string keys refer to the same values.
+    dict.setValue(kIntKey, 1u);
+    EXPECT_TRUE(dict.keyExists("intValue"));
+    EXPECT_EQ(dict.getValue<uint32_t>("intValue"), 1u);
+    dict["intValue"] = 2u;
+    EXPECT_EQ(dict.getValue(kIntKey), 2u);
+
+    dict["floatValue"] = 0.5f;
+    EXPECT_TRUE(dict.keyExists(kFloatKey));
+    EXPECT_EQ(dict.getValue(kFloatKey), 0.5f);
+
+    // Assigning through a typed key updates the value in place.
+    const uint32_t* pValue = dict.tryGetValue(kIntKey);
+    ASSERT(pValue != nullptr);
+    dict.setValue(kIntKey, 3u);
+    EXPECT_EQ(*pValue, 3u);
+    EXPECT_EQ(dict.getValue<uint32_t>("intValue"), 3u);
+}
+
+CPU_TEST(Dictionary_TypedKeyTypeMismatch)
+{
+    const Dictionary::Key<uint32_t> kIntKey("value");
+    const Dictionary::Key<bool> kBoolKey("value");
+
+    Dictionary dict;
+    dict.setValue(kIntKey, 1u);
+    EXPECT_TRUE(dict.keyExists(kBoolKey));
+    EXPECT(dict.tryGetValue(kBoolKey) == nullptr);
+    EXPECT_THROW(dict.getValue(kBoolKey, true));
+    EXPECT_THROW(dict.getValue(kBoolKey));
+    EXPECT_EQ(dict.getValue(kIntKey), 1u);
+
+    // Replacing the value with a different type invalidates the resolved key.
+    dict["value"] = false;
+    EXPECT(dict.tryGetValue(kIntKey) == nullptr);
+    EXPECT_EQ(dict.getValue(kBoolKey), false);
+
+    dict.setValue(kIntKey, 2u);
+    EXPECT_EQ(dict.getValue(kIntKey), 2u);
+    EXPECT(dict.tryGetValue(kBoolKey) == nullptr);
+}
+
+CPU_TEST(Dictionary_TypedKeyCopy)
+{
+    const Dictionary::Key<uint32_t> kKey("value");
+
+    Dictionary dict;
+    dict.setValue(kKey, 1u);
+    EXPECT_EQ(dict.getValue(kKey), 1u);
+
+    // Copies resolve keys against their own values.
+    Dictionary copy(dict);
+    copy.setValue(kKey, 2u);
+    EXPECT_EQ(dict.getValue(kKey), 1u);
+    EXPECT_EQ(copy.getValue(kKey), 2u);
+
+    dict = copy;
+    EXPECT_EQ(dict.getValue(kKey), 2u);
+    dict.setValue(kKey, 3u);
+    EXPECT_EQ(copy.getValue(kKey), 2u);
+}
+} // namespace Falcor
@@ -0,0 +1,267 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/DiskCache.h"
+
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<char> createPayload(size_t size, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<char> data(size);
+    for (auto& c : data)
+        c = (char)rng();
+    return data;
+}
+
+DiskCache::WriteFunc writePayload(const std::vector<char>& data)
+{
+    return [&data](std::ostream& stream) { stream.write(data.data(), data.size()); };
+}
+
+std::vector<char> readPayload(DiskCache& cache, const std::string& key)
+{
+    std::vector<char> data;
+    cache.read(
+        key,
+        [&](std::istream& stream)
+        {
+            data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+    );
+    return data;
+}
+} // namespace
+
+CPU_TEST(DiskCache_WriteRead)
+{
+    const std::filesystem::path directory = "test_disk_cache_1";
+    std::filesystem::remove_all(directory);
+
+    {
+        DiskCache cache(directory);
+        EXPECT_FALSE(cache.hasEntry("entry"));
+        EXPECT_FALSE(cache.read("entry", [](std::istream&) {}));
+
+        // Payload sizes not multiple of the checksum stripe size.
+        for (size_t size : {0, 1, 31, 33, 100000})
+        {
+            auto data = createPayload(size, (uint32_t)size);
+            EXPECT_TRUE(cache.write("entry", writePayload(data)));
+            EXPECT_TRUE(cache.hasEntry("entry"));
+            EXPECT(readPayload(cache, "entry") == data);
+            EXPECT_EQ(cache.getTotalSize(), std::filesystem::file_size(cache.getEntryPath("entry")));
+
+            char header[16];
+            EXPECT_EQ(cache.peek("entry", header, sizeof(header)), size >= sizeof(header));
+            if (size >= sizeof(header))
+                EXPECT(std::memcmp(header, data.data(), sizeof(header)) == 0);
+        }
+
+        // No temporary files are left behind.
+        for (const auto& it : std::filesystem::directory_iterator(directory))
+            EXPECT_NE(it.path().extension(), ".tmp");
+
+        EXPECT_TRUE(cache.remove("entry"));
+        EXPECT_FALSE(cache.hasEntry("entry"));
+        EXPECT_FALSE(std::filesystem::exists(directory / "entry.lock"));
+
+        // Invalid keys.
+        EXPECT_THROW(cache.getEntryPath("../entry"));
+        EXPECT_THROW(cache.getEntryPath("entry.tmp"));
+        EXPECT_THROW(cache.getEntryPath(""));
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(DiskCache_Corruption)
+{
+    const std::filesystem::path directory = "test_disk_cache_2";
+    std::filesystem::remove_all(directory);
+
+    {
+        DiskCache cache(directory);
+        auto data = createPayload(4096, 1);
+
+        // Flip a byte in the payload. The entry is still complete, but fails checksum verification.
+        EXPECT_TRUE(cache.write("entry", writePayload(data)));
+        {
+            std::fstream fs(cache.getEntryPath("entry"), std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+            fs.seekp(1000);
+            fs.put(~data[1000]);
+        }
+        EXPECT_TRUE(cache.hasEntry("entry"));
+        EXPECT_THROW(readPayload(cache, "entry"));
+        EXPECT_FALSE(cache.hasEntry("entry"));
+
+        // Checksum errors are reported even if the reader stops early.
+        EXPECT_TRUE(cache.write("entry", writePayload(data)));
+        {
+            std::fstream fs(cache.getEntryPath("entry"), std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+            fs.seekp(4000);
+            fs.put(~data[4000]);
+        }
+        EXPECT_THROW(cache.read("entry", [](std::istream& stream) { stream.get(); }));
+
+        // Truncated entries are detected without reading.
+        EXPECT_TRUE(cache.write("entry", writePayload(data)));
+        std::filesystem::resize_file(cache.getEntryPath("entry"), 2048);
+        EXPECT_FALSE(cache.hasEntry("entry"));
+        EXPECT_FALSE(cache.read("entry", [](std::istream&) {}));
+
+        // Errors while writing don't leave a partial entry.
+        EXPECT_THROW(cache.write("failed", [](std::ostream& stream) {
+            stream.write("partial", 7);
+            FALCOR_THROW("Failure");
+        }));
+        EXPECT_FALSE(cache.hasEntry("failed"));
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(DiskCache_WriterElection)
+{
+    const std::filesystem::path directory = "test_disk_cache_3";
+    std::filesystem::remove_all(directory);
+
+    {
+        DiskCache cache(directory);
+        auto data = createPayload(1024, 1);
+
+        // While a writer holds the lock, other writers skip writing.
+        auto pLock = cache.lockForWriting("entry");
+        ASSERT(pLock != nullptr);
+        EXPECT(cache.lockForWriting("entry", false) == nullptr);
+        EXPECT_FALSE(cache.write("entry", writePayload(data)));
+        EXPECT_TRUE(cache.write("entry", writePayload(data), pLock.get()));
+        pLock.reset();
+        EXPECT(readPayload(cache, "entry") == data);
+        EXPECT_TRUE(cache.remove("entry"));
+
+        // Concurrent producers: only the elected writer produces the entry, all others read it.
+        std::atomic<uint32_t> writeCount{0};
+        std::atomic<uint32_t> readCount{0};
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    DiskCache threadCache(directory);
+                    if (!threadCache.hasEntry("entry"))
+                    {
+                        auto pThreadLock = threadCache.lockForWriting("entry");
+                        if (!threadCache.hasEntry("entry"))
+                        {
+                            threadCache.write("entry", writePayload(data), pThreadLock.get());
+                            writeCount++;
+                        }
+                    }
+                    if (readPayload(threadCache, "entry") == data)
+                        readCount++;
+                }
+            );
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        EXPECT_EQ(writeCount.load(), 1);
+        EXPECT_EQ(readCount.load(), threads.size());
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(DiskCache_SizeBudget)
+{
+    const std::filesystem::path directory = "test_disk_cache_4";
+    std::filesystem::remove_all(directory);
+
+    {
+        const size_t kPayloadSize = 1000;
+        auto data = createPayload(kPayloadSize, 1);
+
+        DiskCache cache(directory);
+        const std::vector<std::string> keys = {"a", "b", "c", "d"};
+        for (const auto& key : keys)
+            EXPECT_TRUE(cache.write(key, writePayload(data)));
+        const uint64_t entrySize = std::filesystem::file_size(cache.getEntryPath("a"));
+        EXPECT_EQ(cache.getTotalSize(), 4 * entrySize);
+
+        // Assign distinct access times, oldest first.
+        auto baseTime = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+        for (size_t i = 0; i < keys.size(); ++i)
+            std::filesystem::last_write_time(cache.getEntryPath(keys[i]), baseTime + std::chrono::minutes(i));
+
+        // Reading refreshes the access time, making "a" the most recently used entry.
+        EXPECT(readPayload(cache, "a") == data);
+
+        // Writing a new entry evicts the least recently used entries to fit the budget.
+        cache.setSizeBudget(3 * entrySize);
+        EXPECT_TRUE(cache.write("e", writePayload(data)));
+        EXPECT_TRUE(cache.hasEntry("a"));
+        EXPECT_FALSE(cache.hasEntry("b"));
+        EXPECT_FALSE(cache.hasEntry("c"));
+        EXPECT_TRUE(cache.hasEntry("d"));
+        EXPECT_TRUE(cache.hasEntry("e"));
+        EXPECT_LE(cache.getTotalSize(), cache.getSizeBudget());
+
+        // Lock files of evicted entries are removed.
+        EXPECT_FALSE(std::filesystem::exists(directory / "b.lock"));
+        EXPECT_FALSE(std::filesystem::exists(directory / "c.lock"));
+
+        // Entries in use by readers or writers are not evicted.
+        auto pLock = cache.lockForWriting("d");
+        cache.setSizeBudget(entrySize);
+        cache.enforceSizeBudget("e");
+        EXPECT_FALSE(cache.hasEntry("a"));
+        EXPECT_TRUE(cache.hasEntry("d"));
+        EXPECT_TRUE(cache.hasEntry("e"));
+        pLock.reset();
+
+        // The entry just written is kept even if it exceeds the budget on its own.
+        cache.setSizeBudget(1);
+        EXPECT_TRUE(cache.write("f", writePayload(data)));
+        EXPECT_TRUE(cache.hasEntry("f"));
+        EXPECT_EQ(cache.getTotalSize(), entrySize);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace Falcor
@@ -51,7 +51,7 @@ uint32_t jenkinsHash(uint32_t a)
 }
 } // namespace
 
-GPU_TEST(JenkinsHash_CompareToCPU)
+GPU_TEST(JenkinsHash_CompareToCPU, DEVICE_TYPES(Device::Type::D3D12, Device::Type::Vulkan, Device::Type::CPU))
 {
     ref<Device> pDevice = ctx.getDevice();
 
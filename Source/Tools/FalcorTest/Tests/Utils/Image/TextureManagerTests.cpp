@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Image/TextureManager.h"
+#include <vector>
 
 namespace Falcor
 {
@@ -51,4 +52,99 @@ GPU_TEST(TextureManager_LoadMips)
     EXPECT_EQ(tex->getMipCount(), 3);
     EXPECT_EQ(tex->getArraySize(), 1);
 }
+
+GPU_TEST(TextureManager_LazyUdim)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Write a synthetic UDIM tile set.
+    const std::filesystem::path directory = "test_lazy_udim";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const uint32_t kTileSize = 64;
+    const std::vector<uint32_t> kUdimIDs = {1001, 1002, 1011};
+    for (uint32_t udimID : kUdimIDs)
+    {
+        std::vector<uint8_t> data(kTileSize * kTileSize * 4, uint8_t(udimID - 1000));
+        Bitmap::saveImage(
+            directory / fmt::format("tile.{}.png", udimID),
+            kTileSize,
+            kTileSize,
+            Bitmap::FileFormat::PngFile,
+            Bitmap::ExportFlags::ExportAlpha,
+            ResourceFormat::RGBA8Unorm,
+            true /* top-down */,
+            data.data()
+        );
+    }
+
+    {
+        TextureManager textureManager(pDevice, 10);
+
+        // Keep a single tile resident.
+        TextureManager::LazyUdimOptions options;
+        options.enabled = true;
+        options.memoryBudgetPerSet = 1;
+        options.placeholderSize = 16;
+        textureManager.setLazyUdimOptions(options);
+
+        size_t loadedTextureCount = 0;
+        auto handle = textureManager.loadTexture(
+            directory / "tile.<UDIM>.png",
+            true,
+            false,
+            ResourceBindFlags::ShaderResource,
+            false,
+            Bitmap::ImportFlags::None,
+            nullptr,
+            &loadedTextureCount
+        );
+        ASSERT(handle.isValid());
+        EXPECT(handle.isUdim());
+        EXPECT_EQ(loadedTextureCount, kUdimIDs.size());
+        EXPECT(textureManager.getUdimIDs(handle) == kUdimIDs);
+
+        // Tiles are registered but not loaded. Their low-resolution placeholders are bound instead.
+        const UdimTileResidency* pResidency = textureManager.getUdimTileResidency(handle);
+        ASSERT(pResidency != nullptr);
+        EXPECT_EQ(pResidency->getResidentCount(), 0);
+        for (uint32_t udimID : kUdimIDs)
+        {
+            auto desc = textureManager.getTextureDesc(handle, udimID);
+            EXPECT(desc.state == TextureManager::TextureState::Referenced);
+            ASSERT(desc.pTexture != nullptr);
+            EXPECT_EQ(desc.pTexture->getWidth(), options.placeholderSize);
+        }
+
+        // Requesting a tile loads it.
+        auto tileHandle = textureManager.requestUdimTile(handle, 1001, false);
+        ASSERT(tileHandle.isValid());
+        EXPECT(tileHandle == textureManager.requestUdimTile(handle, 1001, false));
+        auto desc = textureManager.getTextureDesc(tileHandle);
+        EXPECT(desc.state == TextureManager::TextureState::Loaded);
+        ASSERT(desc.pTexture != nullptr);
+        EXPECT_EQ(desc.pTexture->getWidth(), kTileSize);
+        EXPECT(pResidency->getTileState(1001) == UdimTileResidency::TileState::Resident);
+
+        // Loading another tile evicts the first one, which falls back to its low-resolution placeholder.
+        textureManager.requestUdimTile(handle, 1011, false);
+        EXPECT(pResidency->getTileState(1011) == UdimTileResidency::TileState::Resident);
+        EXPECT(pResidency->getTileState(1001) == UdimTileResidency::TileState::NonResident);
+        EXPECT_EQ(pResidency->getResidentCount(), 1);
+        desc = textureManager.getTextureDesc(handle, 1001);
+        EXPECT(desc.state == TextureManager::TextureState::Referenced);
+        ASSERT(desc.pTexture != nullptr);
+        EXPECT_EQ(desc.pTexture->getWidth(), options.placeholderSize);
+
+        // Tile 1002 was never requested.
+        EXPECT_EQ(textureManager.getTexture(handle, 1002u)->getWidth(), options.placeholderSize);
+        EXPECT(pResidency->getTileState(1002) == UdimTileResidency::TileState::NonResident);
+        EXPECT(!textureManager.requestUdimTile(handle, 1003, false).isValid());
+
+        textureManager.removeTexture(handle);
+        EXPECT(textureManager.getUdimTileResidency(handle) == nullptr);
+    }
+
+    std::filesystem::remove_all(directory);
+}
 } // namespace Falcor
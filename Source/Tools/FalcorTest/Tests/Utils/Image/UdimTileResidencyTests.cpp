@@ -0,0 +1,175 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/UdimTileResidency.h"
+
+namespace Falcor
+{
+namespace
+{
+using TileState = UdimTileResidency::TileState;
+
+/// Register a synthetic tile set covering the given UDIM rows.
+void addTiles(UdimTileResidency& residency, uint32_t rowCount)
+{
+    for (uint32_t v = 0; v < rowCount; ++v)
+        for (uint32_t u = 0; u < 10; ++u)
+            residency.addTile(1001 + u + 10 * v);
+}
+
+void load(UdimTileResidency& residency, uint32_t udimID, uint64_t sizeInBytes, std::vector<uint32_t>* pEvicted = nullptr)
+{
+    if (residency.request(udimID))
+    {
+        auto evicted = residency.finishLoading(udimID, sizeInBytes, true);
+        if (pEvicted)
+            *pEvicted = evicted;
+    }
+}
+} // namespace
+
+CPU_TEST(UdimTileResidency_Register)
+{
+    UdimTileResidency residency;
+    addTiles(residency, 2);
+
+    EXPECT_EQ(residency.getTileCount(), 20);
+    EXPECT_EQ(residency.getResidentCount(), 0);
+    EXPECT_EQ(residency.getResidentSize(), 0);
+
+    auto udimIDs = residency.getUdimIDs();
+    ASSERT_EQ(udimIDs.size(), 20);
+    EXPECT_EQ(udimIDs.front(), 1001);
+    EXPECT_EQ(udimIDs.back(), 1020);
+
+    for (uint32_t udimID : udimIDs)
+        EXPECT(residency.getTileState(udimID) == TileState::NonResident);
+
+    EXPECT(!residency.hasTile(1021));
+    EXPECT_THROW(residency.addTile(1001));
+    EXPECT_THROW(residency.addTile(1000));
+    EXPECT_THROW(residency.request(1021));
+}
+
+CPU_TEST(UdimTileResidency_Request)
+{
+    UdimTileResidency residency;
+    addTiles(residency, 1);
+
+    // First request issues a load, later requests don't.
+    EXPECT(residency.request(1003));
+    EXPECT(residency.getTileState(1003) == TileState::Loading);
+    EXPECT(!residency.request(1003));
+    EXPECT_EQ(residency.getResidentSize(), 0);
+
+    auto evicted = residency.finishLoading(1003, 1000, true);
+    EXPECT(evicted.empty());
+    EXPECT(residency.getTileState(1003) == TileState::Resident);
+    EXPECT_EQ(residency.getTileSize(1003), 1000);
+    EXPECT_EQ(residency.getResidentSize(), 1000);
+    EXPECT(!residency.request(1003));
+    EXPECT_THROW(residency.finishLoading(1003, 1000, true));
+
+    // Failed tiles are not requested again.
+    EXPECT(residency.request(1004));
+    residency.finishLoading(1004, 0, false);
+    EXPECT(residency.getTileState(1004) == TileState::Failed);
+    EXPECT(!residency.request(1004));
+    EXPECT_EQ(residency.getResidentSize(), 1000);
+
+    // Evicted tiles are loaded again on the next request.
+    EXPECT(residency.evict(1003));
+    EXPECT(!residency.evict(1003));
+    EXPECT(residency.getTileState(1003) == TileState::NonResident);
+    EXPECT_EQ(residency.getResidentSize(), 0);
+    EXPECT(residency.request(1003));
+}
+
+CPU_TEST(UdimTileResidency_Budget)
+{
+    const uint64_t kTileSize = 1 << 20;
+    UdimTileResidency residency(3 * kTileSize);
+    addTiles(residency, 10);
+
+    // Load tiles up to the budget.
+    std::vector<uint32_t> evicted;
+    for (uint32_t udimID : {1001, 1002, 1003})
+    {
+        load(residency, udimID, kTileSize, &evicted);
+        EXPECT(evicted.empty());
+    }
+    EXPECT_EQ(residency.getResidentSize(), 3 * kTileSize);
+
+    // Requesting a resident tile makes it the most recently used one.
+    EXPECT(!residency.request(1001));
+
+    // Loading another tile evicts the least recently used tile.
+    load(residency, 1004, kTileSize, &evicted);
+    ASSERT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0], 1002);
+    EXPECT(residency.getTileState(1002) == TileState::NonResident);
+    EXPECT_EQ(residency.getResidentSize(), 3 * kTileSize);
+
+    // A large tile evicts multiple tiles, least recently used first, but is kept even if it exceeds the budget on its own.
+    load(residency, 1100, 4 * kTileSize, &evicted);
+    ASSERT_EQ(evicted.size(), 3);
+    EXPECT_EQ(evicted[0], 1003);
+    EXPECT_EQ(evicted[1], 1001);
+    EXPECT_EQ(evicted[2], 1004);
+    EXPECT(residency.getTileState(1100) == TileState::Resident);
+    EXPECT_EQ(residency.getResidentCount(), 1);
+    EXPECT_EQ(residency.getResidentSize(), 4 * kTileSize);
+
+    // Tiles that are still loading are never evicted.
+    EXPECT(residency.request(1050));
+    evicted = residency.setMemoryBudget(kTileSize);
+    ASSERT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0], 1100);
+    EXPECT(residency.getTileState(1050) == TileState::Loading);
+    EXPECT_EQ(residency.getResidentSize(), 0);
+
+    // Streaming through all tiles keeps the resident size within the budget.
+    residency.setMemoryBudget(8 * kTileSize);
+    residency.finishLoading(1050, kTileSize, true);
+    for (uint32_t udimID : residency.getUdimIDs())
+    {
+        load(residency, udimID, kTileSize);
+        EXPECT_LE(residency.getResidentSize(), residency.getMemoryBudget());
+    }
+    EXPECT_EQ(residency.getResidentCount(), 8);
+    for (uint32_t udimID = 1093; udimID <= 1100; ++udimID)
+        EXPECT(residency.getTileState(udimID) == TileState::Resident);
+
+    // Disabling the budget never evicts.
+    residency.setMemoryBudget(UdimTileResidency::kUnlimited);
+    for (uint32_t udimID : residency.getUdimIDs())
+        load(residency, udimID, kTileSize);
+    EXPECT_EQ(residency.getResidentCount(), 100);
+    EXPECT_EQ(residency.getResidentSize(), 100 * kTileSize);
+}
+} // namespace Falcor
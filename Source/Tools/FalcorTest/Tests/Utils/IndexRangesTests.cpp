@@ -0,0 +1,100 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/IndexRanges.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+using Ranges = std::vector<std::pair<uint32_t, uint32_t>>;
+
+Ranges getRanges(const std::vector<uint32_t>& indices, uint32_t maxGap)
+{
+    Ranges ranges;
+    forEachIndexRange(indices, maxGap, [&](uint32_t offset, uint32_t count) { ranges.emplace_back(offset, count); });
+    return ranges;
+}
+} // namespace
+
+CPU_TEST(IndexRanges_Basic)
+{
+    EXPECT(getRanges({}, 0).empty());
+    EXPECT(getRanges({5}, 0) == Ranges({{5, 1}}));
+    EXPECT(getRanges({0, 1, 2, 5, 6, 9}, 0) == Ranges({{0, 3}, {5, 2}, {9, 1}}));
+    EXPECT(getRanges({0, 1, 2, 5, 6, 9}, 1) == Ranges({{0, 3}, {5, 2}, {9, 1}}));
+    EXPECT(getRanges({0, 1, 2, 5, 6, 9}, 2) == Ranges({{0, 10}}));
+    EXPECT(getRanges({3, 10, 11, 30}, 6) == Ranges({{3, 9}, {30, 1}}));
+}
+
+CPU_TEST(IndexRanges_Random)
+{
+    std::mt19937 rng(1);
+    for (uint32_t maxGap : {0u, 1u, 4u, 16u})
+    {
+        // Generate a random sparse set of indices.
+        std::vector<bool> isSet(10000);
+        std::vector<uint32_t> indices;
+        for (uint32_t i = 0; i < isSet.size(); i++)
+        {
+            if (rng() % 8 == 0)
+            {
+                isSet[i] = true;
+                indices.push_back(i);
+            }
+        }
+
+        // Ranges must be ordered, cover all indices, and only bridge gaps of at most maxGap unset indices.
+        std::vector<bool> covered(isSet.size());
+        uint32_t prevEnd = 0;
+        bool first = true;
+        for (const auto& [offset, count] : getRanges(indices, maxGap))
+        {
+            EXPECT(isSet[offset]);
+            EXPECT(isSet[offset + count - 1]);
+            if (!first)
+                EXPECT_GT(offset - prevEnd, maxGap);
+            uint32_t gap = 0;
+            for (uint32_t i = offset; i < offset + count; i++)
+            {
+                covered[i] = true;
+                gap = isSet[i] ? 0 : gap + 1;
+                EXPECT_LE(gap, maxGap);
+            }
+            prevEnd = offset + count;
+            first = false;
+        }
+        for (uint32_t i : indices)
+            EXPECT(covered[i]);
+    }
+}
+} // namespace Falcor
@@ -277,7 +277,7 @@ void testReduction(GPUUnitTestContext& ctx, ParallelReduction& reduction, Resour
 }
 } // namespace
 
-GPU_TEST(ParallelReduction)
+GPU_TEST(ParallelReduction, DEVICE_TYPES(Device::Type::D3D12, Device::Type::Vulkan, Device::Type::CPU))
 {
     // Quick test of the snorm/unorm data types we use.
     FALCOR_ASSERT((float)unorm8_t(163.499f / 255.f) == (163 / 255.f));
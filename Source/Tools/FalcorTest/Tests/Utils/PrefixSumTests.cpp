@@ -88,7 +88,7 @@ void testPrefixSum(GPUUnitTestContext& ctx, PrefixSum& prefixSum, uint32_t numEl
 }
 } // namespace
 
-GPU_TEST(PrefixSum)
+GPU_TEST(PrefixSum, DEVICE_TYPES(Device::Type::D3D12, Device::Type::Vulkan, Device::Type::CPU))
 {
     // Quick test of our reference function.
     std::vector<uint32_t> x({5, 17, 2, 9, 23});
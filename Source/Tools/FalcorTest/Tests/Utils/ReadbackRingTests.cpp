@@ -0,0 +1,242 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/ReadbackRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Mocked queue with a fence that completes only when told to, and host memory as staging slots.
+class MockBackend : public ReadbackRing::Backend
+{
+public:
+    MockBackend(size_t slotSize, uint32_t slotCount) : mMemory(slotCount, std::vector<uint8_t>(slotSize)) {}
+
+    uint64_t signal() override { return ++signaledValue; }
+    uint64_t getCompletedValue() override { return completedValue; }
+    void wait(uint64_t value) override
+    {
+        waitCount++;
+        completedValue = std::max(completedValue, value);
+    }
+    const void* map(uint32_t slot) override
+    {
+        mapped++;
+        return mMemory[slot].data();
+    }
+    void unmap(uint32_t slot) override { mapped--; }
+
+    /// Emulates the GPU writing to the staging memory of a slot.
+    void write(uint32_t slot, uint64_t value) { std::memcpy(mMemory[slot].data(), &value, sizeof(value)); }
+
+    uint64_t signaledValue = 0;
+    uint64_t completedValue = 0;
+    uint32_t waitCount = 0;
+    int mapped = 0;
+
+private:
+    std::vector<std::vector<uint8_t>> mMemory;
+};
+
+struct Readback
+{
+    uint64_t tag;
+    uint64_t value;
+};
+
+struct TestRing
+{
+    TestRing(uint32_t slotCount)
+    {
+        auto pBackend = std::make_unique<MockBackend>(sizeof(uint64_t), slotCount);
+        backend = pBackend.get();
+        ring = std::make_unique<ReadbackRing>(std::move(pBackend), sizeof(uint64_t), slotCount);
+    }
+
+    /// Records a readback of the given value, tagged with the value itself.
+    void submit(uint64_t value)
+    {
+        uint32_t slot = ring->acquire();
+        backend->write(slot, value);
+        ring->submit(
+            slot,
+            value,
+            sizeof(uint64_t),
+            [this](uint64_t tag, const void* pData, size_t size)
+            {
+                uint64_t value = 0;
+                std::memcpy(&value, pData, size);
+                results.push_back({tag, value});
+            }
+        );
+    }
+
+    MockBackend* backend;
+    std::unique_ptr<ReadbackRing> ring;
+    std::vector<Readback> results;
+};
+} // namespace
+
+CPU_TEST(ReadbackRing_InOrderCompletion)
+{
+    TestRing t(3);
+
+    for (uint64_t i = 0; i < 3; ++i)
+        t.submit(100 + i);
+    EXPECT_EQ(t.ring->getPendingCount(), 3);
+
+    // Nothing is dispatched before the fence is reached, and polling never waits.
+    EXPECT_EQ(t.ring->poll(), 0);
+    EXPECT_EQ(t.results.size(), 0);
+    EXPECT_EQ(t.backend->waitCount, 0);
+
+    // Completing the first two signals dispatches exactly those, in order.
+    t.backend->completedValue = 2;
+    EXPECT_EQ(t.ring->poll(), 2);
+    ASSERT_EQ(t.results.size(), 2);
+    EXPECT_EQ(t.results[0].tag, 100);
+    EXPECT_EQ(t.results[0].value, 100);
+    EXPECT_EQ(t.results[1].tag, 101);
+    EXPECT_EQ(t.results[1].value, 101);
+    EXPECT_EQ(t.ring->getPendingCount(), 1);
+
+    // Flush waits for the remaining slot.
+    EXPECT_EQ(t.ring->flush(), 1);
+    ASSERT_EQ(t.results.size(), 3);
+    EXPECT_EQ(t.results[2].value, 102);
+    EXPECT_EQ(t.backend->waitCount, 1);
+    EXPECT_EQ(t.backend->mapped, 0);
+
+    EXPECT_EQ(t.ring->getStats().submitted, 3);
+    EXPECT_EQ(t.ring->getStats().completed, 3);
+    EXPECT_EQ(t.ring->getStats().stalls, 0);
+}
+
+CPU_TEST(ReadbackRing_NoStallWithinLatency)
+{
+    // The GPU runs two frames behind the host. Three slots are enough to never wait.
+    const uint64_t kLatency = 2;
+    TestRing t(3);
+
+    for (uint64_t frame = 0; frame < 100; ++frame)
+    {
+        t.backend->completedValue = frame > kLatency ? frame - kLatency : 0;
+        t.ring->poll();
+        t.submit(frame);
+    }
+    t.ring->flush();
+
+    EXPECT_EQ(t.ring->getStats().stalls, 0);
+    EXPECT_EQ(t.backend->waitCount, 1);
+    ASSERT_EQ(t.results.size(), 100);
+    for (uint64_t frame = 0; frame < 100; ++frame)
+    {
+        EXPECT_EQ(t.results[frame].tag, frame);
+        EXPECT_EQ(t.results[frame].value, frame);
+    }
+}
+
+CPU_TEST(ReadbackRing_StallWhenFull)
+{
+    TestRing t(2);
+
+    t.submit(0);
+    t.submit(1);
+
+    // All slots are in flight, so acquiring waits for the oldest and dispatches it first.
+    t.submit(2);
+    EXPECT_EQ(t.ring->getStats().stalls, 1);
+    EXPECT_EQ(t.backend->waitCount, 1);
+    ASSERT_EQ(t.results.size(), 1);
+    EXPECT_EQ(t.results[0].value, 0);
+
+    // The slot reused for the third readback holds the new data.
+    t.ring->flush();
+    ASSERT_EQ(t.results.size(), 3);
+    EXPECT_EQ(t.results[1].value, 1);
+    EXPECT_EQ(t.results[2].value, 2);
+
+    // A slot that completed in the meantime is reused without stalling.
+    t.submit(3);
+    t.submit(4);
+    t.backend->completedValue = t.backend->signaledValue;
+    t.submit(5);
+    EXPECT_EQ(t.ring->getStats().stalls, 1);
+}
+
+CPU_TEST(ReadbackRing_Discard)
+{
+    TestRing t(3);
+
+    t.submit(0);
+    t.submit(1);
+    t.ring->discard();
+    EXPECT_EQ(t.ring->getPendingCount(), 0);
+    EXPECT_EQ(t.ring->getStats().discarded, 2);
+
+    t.backend->completedValue = t.backend->signaledValue;
+    EXPECT_EQ(t.ring->poll(), 0);
+    EXPECT_EQ(t.ring->flush(), 0);
+    EXPECT_EQ(t.results.size(), 0);
+
+    // Pending readbacks are dropped on destruction.
+    t.submit(2);
+    t.ring.reset();
+    EXPECT_EQ(t.results.size(), 0);
+}
+
+CPU_TEST(ReadbackRing_Errors)
+{
+    TestRing t(2);
+
+    EXPECT_THROW(t.ring->submit(0, 0, sizeof(uint64_t), {}));
+
+    uint32_t slot = t.ring->acquire();
+    EXPECT_THROW(t.ring->acquire());
+    EXPECT_THROW(t.ring->submit(slot, 0, 2 * sizeof(uint64_t), {}));
+    t.ring->submit(slot, 0, sizeof(uint64_t), {});
+    EXPECT_THROW(t.ring->submit(slot, 0, sizeof(uint64_t), {}));
+
+    // Exceptions thrown by callbacks leave the ring usable.
+    slot = t.ring->acquire();
+    t.ring->submit(slot, 1, sizeof(uint64_t), [](uint64_t, const void*, size_t) { FALCOR_THROW("Failure"); });
+    EXPECT_THROW(t.ring->flush());
+    EXPECT_EQ(t.ring->getPendingCount(), 0);
+    EXPECT_EQ(t.backend->mapped, 0);
+    t.submit(2);
+    t.ring->flush();
+    ASSERT_EQ(t.results.size(), 1);
+    EXPECT_EQ(t.results[0].value, 2);
+}
+
+} // namespace Falcor
@@ -29,10 +29,13 @@
 #include "Utils/Settings/Settings.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Scripting/Scripting.h"
+#include "Utils/Timing/CpuTimer.h"
 
 #include <pybind11/stl.h>
 #include <pybind11/pytypes.h>
 
+#include <regex>
+
 #if FALCOR_WINDOWS
 #define C_DRIVE "c:"
 #else
@@ -331,6 +334,116 @@ CPU_TEST(Settings_AttributeFilters)
     EXPECT_EQ(settings.getAttribute<float>("/World/Tiger_Fur/back", "curves:ShadingRate", 1.f), 0.1f);
 }
 
+CPU_TEST(Settings_AttributeFiltersMatching)
+{
+    // Regexes covering all the matcher fast paths as well as the std::regex fallback.
+    const std::vector<std::string> regexes = {
+        ".*",   "/World/Tiger_Fur.*", ".*_back", "/World/Ground", ".*Mane.*", "/World/[A-Z]+/x\\d+", "a\\.b", "\\..*",
+        "a.*",  "x\\.*",              "",        "ab*c",          "abc?d",    "ab{2}c",              "abc|x", "abc(d)?",
+    };
+    const std::vector<std::string> shapeNames = {
+        "/World/Tiger_Fur/back", "/World/Tiger_Mane/top", "/World/Ground", "a.b", "axb", "a",   "abc\nd", "x",    "x...",
+        "x.",                    "/World/AB/x12",         ".foo",          "Mane", "",   "ac",  "abd",    "abbc", "abcd",
+        "foo_back",              "/World/Tiger_Fur\n",
+    };
+
+    for (const std::string& regex : regexes)
+    {
+        settings::AttributeFilter filter;
+        nlohmann::json json;
+        json["regex"] = regex;
+        json["attributes"]["value"] = 1;
+        filter.add(json);
+
+        std::regex reference(regex);
+        for (const std::string& shapeName : shapeNames)
+        {
+            bool expected = std::regex_match(shapeName, reference);
+            EXPECT_EQ(filter.getAttribute<int>(shapeName, "value").has_value(), expected) << "regex: " << regex << ", shape: " << shapeName;
+        }
+
+        std::vector<std::optional<int>> bulk = filter.getAttribute<int>(shapeNames, "value");
+        ASSERT_EQ(bulk.size(), shapeNames.size());
+        for (size_t i = 0; i < shapeNames.size(); ++i)
+            EXPECT_EQ(bulk[i].has_value(), std::regex_match(shapeNames[i], reference));
+    }
+}
+
+CPU_TEST(Settings_AttributeFiltersBenchmark, TAGS("benchmark"), "Disabled for performance reasons")
+{
+    const size_t kShapeCount = 1000000;
+
+    nlohmann::json filters = nlohmann::json::array();
+    filters.push_back({{"regex", ".*"}, {"attributes", {{"curves:ShadingRate", 1.f}}}});
+    filters.push_back({{"regex", "/World/Fur_1.*"}, {"attributes", {{"curves:ShadingRate", 0.5f}}}});
+    filters.push_back({{"regex", ".*/tip"}, {"attributes", {{"curves:mode", "tube"}}}});
+    filters.push_back({{"regex", "/World/Fur_42/tip"}, {"attributes", {{"curves:ShadingRate", 0.25f}}}});
+    filters.push_back({{"regex", "/World/Fur_[0-9]*7/root"}, {"attributes", {{"curves:mode", "ribbon"}}}});
+
+    settings::AttributeFilter filter;
+    filter.add(filters);
+
+    std::vector<std::string> shapeNames(kShapeCount);
+    for (size_t i = 0; i < kShapeCount; ++i)
+        shapeNames[i] = fmt::format("/World/Fur_{}/{}", i / 2, (i % 2) ? "tip" : "root");
+
+    // Reference: match every record with std::regex for each queried attribute, as done before matchers were compiled.
+    std::vector<std::regex> regexes;
+    for (const auto& it : filters)
+        regexes.emplace_back(it["regex"].get<std::string>());
+
+    auto referenceAttribute = [&](const std::string& shapeName, const std::string& attrName)
+    {
+        nlohmann::json attribute = nullptr;
+        for (size_t i = 0; i < regexes.size(); ++i)
+        {
+            if (!std::regex_match(shapeName, regexes[i]))
+                continue;
+            auto attrIt = filters[i]["attributes"].find(attrName);
+            if (attrIt != filters[i]["attributes"].end())
+                attribute = attrIt.value();
+        }
+        return attribute;
+    };
+
+    CpuTimer timer;
+    timer.update();
+    size_t referenceChecksum = 0;
+    for (const std::string& shapeName : shapeNames)
+    {
+        referenceChecksum += referenceAttribute(shapeName, "curves:ShadingRate").get<float>() == 1.f ? 1 : 0;
+        referenceChecksum += referenceAttribute(shapeName, "curves:mode").is_null() ? 0 : 2;
+    }
+    timer.update();
+    double referenceTime = timer.delta();
+
+    timer.update();
+    std::vector<std::optional<float>> shadingRates = filter.getAttribute<float>(shapeNames, "curves:ShadingRate");
+    std::vector<std::optional<std::string>> modes = filter.getAttribute<std::string>(shapeNames, "curves:mode");
+    timer.update();
+    double compiledTime = timer.delta();
+
+    size_t checksum = 0;
+    for (size_t i = 0; i < kShapeCount; ++i)
+    {
+        ASSERT(shadingRates[i].has_value());
+        checksum += *shadingRates[i] == 1.f ? 1 : 0;
+        checksum += modes[i] ? 2 : 0;
+    }
+    EXPECT_EQ(checksum, referenceChecksum);
+
+    EXPECT_EQ(filter.getAttribute<float>("/World/Fur_42/tip", "curves:ShadingRate", 1.f), 0.25f);
+    EXPECT_EQ(filter.getAttribute<std::string>("/World/Fur_17/root", "curves:mode", ""), "ribbon");
+
+    logInfo(
+        "AttributeFilter: {} shapes, std::regex {:.3f} s, compiled {:.3f} s ({:.1f}x speedup).",
+        kShapeCount,
+        referenceTime,
+        compiledTime,
+        referenceTime / compiledTime
+    );
+}
+
 CPU_TEST(Settings_UpdatePathsColon)
 {
     Settings settings;
@@ -0,0 +1,54 @@
+import sys
+import os
+import gc
+import unittest
+import falcor
+import numpy as np
+
+sys.path.append(os.path.dirname(os.path.dirname(os.path.relpath(__file__))))
+from helpers import for_each_device_type
+
+
+class TestDLPack(unittest.TestCase):
+    @for_each_device_type
+    def test_upload_buffer_export(self, device: falcor.Device):
+        a = device.create_typed_buffer(
+            format=falcor.ResourceFormat.R32Float,
+            element_count=1024,
+            memory_type=falcor.MemoryType.Upload,
+        )
+        self.assertEqual(a.__dlpack_device__(), (1, 0))
+
+        # Writes through the exported array go directly to the mapped buffer memory.
+        view = np.from_dlpack(a)
+        self.assertEqual(view.shape, (1024,))
+        self.assertEqual(view.dtype, np.float32)
+        view[:] = np.linspace(0, 1, 1024, dtype=np.float32)
+
+        b = device.create_typed_buffer(
+            format=falcor.ResourceFormat.R32Float, element_count=1024
+        )
+        device.render_context.copy_resource(b, a)
+        self.assertTrue(np.all(b.to_numpy() == np.linspace(0, 1, 1024, dtype=np.float32)))
+
+    @for_each_device_type
+    def test_export_keeps_buffer_alive(self, device: falcor.Device):
+        a = device.create_buffer(256, memory_type=falcor.MemoryType.Upload)
+        view = np.from_dlpack(a)
+        del a
+        gc.collect()
+        view[:] = 7
+        self.assertTrue(np.all(view == 7))
+
+    @for_each_device_type
+    def test_device_local_buffer_export(self, device: falcor.Device):
+        a = device.create_buffer(256)
+        try:
+            dlpack_device = a.__dlpack_device__()
+        except Exception:
+            # Device-local buffers can only be exported with CUDA interop.
+            return
+        self.assertEqual(dlpack_device[0], 2)
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,77 @@
+import gc
+import unittest
+import falcor
+import numpy as np
+
+
+class TestTriangleMesh(unittest.TestCase):
+    def test_array_views(self):
+        mesh = falcor.TriangleMesh.createQuad()
+        positions = mesh.positionArray
+        normals = mesh.normalArray
+        tex_coords = mesh.texCoordArray
+        indices = mesh.indexArray
+
+        self.assertEqual(positions.shape, (len(mesh.vertices), 3))
+        self.assertEqual(normals.shape, (len(mesh.vertices), 3))
+        self.assertEqual(tex_coords.shape, (len(mesh.vertices), 2))
+        self.assertEqual(indices.shape, (len(mesh.indices) // 3, 3))
+        self.assertEqual(indices.dtype, np.uint32)
+
+        for i, v in enumerate(mesh.vertices):
+            self.assertEqual(tuple(positions[i]), (v.position.x, v.position.y, v.position.z))
+            self.assertEqual(tuple(normals[i]), (v.normal.x, v.normal.y, v.normal.z))
+            self.assertEqual(tuple(tex_coords[i]), (v.texCoord.x, v.texCoord.y))
+        self.assertEqual(list(indices.flatten()), list(mesh.indices))
+
+    def test_array_views_share_memory(self):
+        mesh = falcor.TriangleMesh.createQuad()
+        positions = mesh.positionArray
+        positions[0] = (1, 2, 3)
+        v = mesh.vertices[0]
+        self.assertEqual((v.position.x, v.position.y, v.position.z), (1, 2, 3))
+
+    def test_array_view_keeps_mesh_alive(self):
+        mesh = falcor.TriangleMesh.createCube()
+        expected = np.array(mesh.positionArray)
+        positions = mesh.positionArray
+        del mesh
+        gc.collect()
+        self.assertTrue(np.all(positions == expected))
+
+    def test_create_from_arrays(self):
+        positions = np.array([[0, 0, 0], [1, 0, 0], [0, 1, 0], [1, 1, 0]], dtype=np.float32)
+        normals = np.tile(np.array([0, 0, 1], dtype=np.float32), (4, 1))
+        indices = np.array([[0, 1, 2], [2, 1, 3]], dtype=np.uint32)
+        mesh = falcor.TriangleMesh.createFromArrays(positions, normals, indices)
+
+        self.assertTrue(np.all(mesh.positionArray == positions))
+        self.assertTrue(np.all(mesh.normalArray == normals))
+        self.assertTrue(np.all(mesh.texCoordArray == 0))
+        self.assertTrue(np.all(mesh.indexArray == indices))
+
+    def test_create_from_strided_arrays(self):
+        # Interleaved vertex data, positions and normals are non-contiguous views.
+        interleaved = np.arange(4 * 8, dtype=np.float32).reshape(4, 8)
+        positions = interleaved[:, 0:3]
+        normals = interleaved[:, 3:6]
+        tex_coords = interleaved[:, 6:8]
+        indices = np.array([0, 1, 2, 2, 1, 3], dtype=np.int64)
+        mesh = falcor.TriangleMesh.createFromArrays(positions, normals, indices, tex_coords)
+
+        self.assertTrue(np.all(mesh.positionArray == positions))
+        self.assertTrue(np.all(mesh.normalArray == normals))
+        self.assertTrue(np.all(mesh.texCoordArray == tex_coords))
+        self.assertEqual(list(mesh.indices), [0, 1, 2, 2, 1, 3])
+
+    def test_create_from_arrays_invalid(self):
+        positions = np.zeros((3, 3), dtype=np.float32)
+        normals = np.zeros((3, 3), dtype=np.float32)
+        with self.assertRaises(Exception):
+            falcor.TriangleMesh.createFromArrays(positions, normals, np.array([0, 1, 5], dtype=np.uint32))
+        with self.assertRaises(Exception):
+            falcor.TriangleMesh.createFromArrays(positions, normals, np.array([0, 1], dtype=np.uint32))
+
+
+if __name__ == "__main__":
+    unittest.main()